@@ -90,10 +90,10 @@ std::string CharStream::lineAtPosition(int _position) const
 		lineStart = 0;
 	else
 		lineStart++;
-	std::string line = m_source.substr(
+	std::string line{m_source.substr(
 		lineStart,
 		std::min(m_source.find('\n', lineStart), m_source.size()) - lineStart
-	);
+	)};
 	if (!line.empty() && line.back() == '\r')
 		line.pop_back();
 	return line;
@@ -104,7 +104,7 @@ LineColumn CharStream::translatePositionToLineColumn(int _position) const
 	using size_type = std::string::size_type;
 	using diff_type = std::string::difference_type;
 	size_type searchPosition = std::min<size_type>(m_source.size(), size_type(_position));
-	int lineNumber = static_cast<int>(count(m_source.begin(), m_source.begin() + diff_type(searchPosition), '\n'));
+	int lineNumber = static_cast<int>(std::count(m_source.begin(), m_source.begin() + diff_type(searchPosition), '\n'));
 	size_type lineStart;
 	if (searchPosition == 0)
 		lineStart = 0;
@@ -122,13 +122,13 @@ std::string_view CharStream::text(SourceLocation const& _location) const
 		return {};
 	solAssert(_location.sourceName && *_location.sourceName == m_name, "");
 	solAssert(static_cast<size_t>(_location.end) <= m_source.size(), "");
-	return std::string_view{m_source}.substr(
+	return m_source.substr(
 		static_cast<size_t>(_location.start),
 		static_cast<size_t>(_location.end - _location.start)
 	);
 }
 
-std::string CharStream::singleLineSnippet(std::string const& _sourceCode, SourceLocation const& _location)
+std::string CharStream::singleLineSnippet(std::string_view _sourceCode, SourceLocation const& _location)
 {
 	if (!_location.hasText())
 		return {};
@@ -136,7 +136,7 @@ std::string CharStream::singleLineSnippet(std::string const& _sourceCode, Source
 	if (static_cast<size_t>(_location.start) >= _sourceCode.size())
 		return {};
 
-	std::string cut = _sourceCode.substr(static_cast<size_t>(_location.start), static_cast<size_t>(_location.end - _location.start));
+	std::string cut{_sourceCode.substr(static_cast<size_t>(_location.start), static_cast<size_t>(_location.end - _location.start))};
 	auto newLinePos = cut.find_first_of("\n\r");
 	if (newLinePos != std::string::npos)
 		cut = cut.substr(0, newLinePos) + "...";
@@ -149,7 +149,7 @@ std::optional<int> CharStream::translateLineColumnToPosition(LineColumn const& _
 	return translateLineColumnToPosition(m_source, _lineColumn);
 }
 
-std::optional<int> CharStream::translateLineColumnToPosition(std::string const& _text, LineColumn const& _input)
+std::optional<int> CharStream::translateLineColumnToPosition(std::string_view _text, LineColumn const& _input)
 {
 	if (_input.line < 0)
 		return std::nullopt;
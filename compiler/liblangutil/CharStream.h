@@ -51,8 +51,10 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <utility>
 
@@ -72,18 +74,32 @@ class CharStream
 public:
 	CharStream() = default;
 	CharStream(std::string _source, std::string _name):
-		m_source(std::move(_source)), m_name(std::move(_name)) {}
+		CharStream(std::make_shared<std::string const>(std::move(_source)), std::move(_name)) {}
 	CharStream(std::string _source, std::string _name, bool _importedFromAST):
-		m_source(std::move(_source)),
-		m_name(std::move(_name)),
-		m_importedFromAST(_importedFromAST)
-	{ }
+		CharStream(std::make_shared<std::string const>(std::move(_source)), std::move(_name))
+	{
+		m_importedFromAST = _importedFromAST;
+	}
+	/// Creates a stream over @a _source without copying it. @a _owner keeps the memory
+	/// of @a _source alive and can be empty if that memory is static.
+	CharStream(std::string_view _source, std::shared_ptr<void const> _owner, std::string _name):
+		m_owner(std::move(_owner)), m_source(_source), m_name(std::move(_name)) {}
 
 	size_t position() const { return m_position; }
 	bool isPastEndOfInput(size_t _charsForward = 0) const { return (m_position + _charsForward) >= m_source.size(); }
 	bool isImportedFromAST() const { return m_importedFromAST; }
 
-	char get(size_t _charsForward = 0) const { return m_source[m_position + _charsForward]; }
+	/// @returns the character @a _charsForward characters after the current position
+	/// or zero if that is past the end of input.
+	char get(size_t _charsForward = 0) const
+	{
+		return isPastEndOfInput(_charsForward) ? 0 : m_source[m_position + _charsForward];
+	}
+	/// @returns the characters from the current position to the end of input.
+	std::string_view remaining() const
+	{
+		return isPastEndOfInput() ? std::string_view{} : m_source.substr(m_position);
+	}
 	char advanceAndGet(size_t _chars = 1);
 	/// Sets scanner position to @ _amount characters backwards in source text.
 	/// @returns The character of the current location after update is returned.
@@ -95,7 +111,7 @@ public:
 
 	void reset() { m_position = 0; }
 
-	std::string const& source() const noexcept { return m_source; }
+	std::string_view source() const noexcept { return m_source; }
 	std::string const& name() const noexcept { return m_name; }
 
 	size_t size() const { return m_source.size(); }
@@ -112,7 +128,7 @@ public:
 	std::optional<int> translateLineColumnToPosition(LineColumn const& _lineColumn) const;
 
 	/// Translates a line:column to the absolute position for the given input text.
-	static std::optional<int> translateLineColumnToPosition(std::string const& _text, LineColumn const& _input);
+	static std::optional<int> translateLineColumnToPosition(std::string_view _text, LineColumn const& _input);
 
 	/// Tests whether or not given octet sequence is present at the current position in stream.
 	/// @returns true if the sequence could be found, false otherwise.
@@ -139,10 +155,15 @@ public:
 		return singleLineSnippet(m_source, _location);
 	}
 
-	static std::string singleLineSnippet(std::string const& _sourceCode, SourceLocation const& _location);
+	static std::string singleLineSnippet(std::string_view _sourceCode, SourceLocation const& _location);
 
 private:
-	std::string m_source;
+	CharStream(std::shared_ptr<std::string const> _source, std::string _name):
+		CharStream(*_source, _source, std::move(_name)) {}
+
+	/// Keeps the memory that @a m_source refers to alive.
+	std::shared_ptr<void const> m_owner;
+	std::string_view m_source;
 	std::string m_name;
 	bool m_importedFromAST{false};
 	size_t m_position{0};
@@ -0,0 +1,207 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+// SPDX-License-Identifier: GPL-3.0
+
+#include <liblangutil/CharacterRuns.h>
+
+#include <liblangutil/Common.h>
+
+#include <cstdint>
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__AVX2__)
+#define LANGUTIL_RUNS_AVX2 1
+#include <immintrin.h>
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__SSE2__)
+#define LANGUTIL_RUNS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+using namespace solidity::langutil;
+
+namespace
+{
+
+#if defined(LANGUTIL_RUNS_AVX2)
+
+using Block = __m256i;
+size_t constexpr blockSize = 32;
+uint32_t constexpr fullMask = 0xffffffff;
+
+inline Block load(char const* _data) { return _mm256_loadu_si256(reinterpret_cast<Block const*>(_data)); }
+inline Block splat(char _c) { return _mm256_set1_epi8(_c); }
+inline Block equal(Block _block, char _c) { return _mm256_cmpeq_epi8(_block, splat(_c)); }
+inline Block greater(Block _block, char _c) { return _mm256_cmpgt_epi8(_block, splat(_c)); }
+inline Block less(Block _block, char _c) { return _mm256_cmpgt_epi8(splat(_c), _block); }
+inline Block either(Block _a, Block _b) { return _mm256_or_si256(_a, _b); }
+inline Block both(Block _a, Block _b) { return _mm256_and_si256(_a, _b); }
+inline Block except(Block _a, Block _b) { return _mm256_andnot_si256(_b, _a); }
+inline Block complement(Block _block) { return _mm256_xor_si256(_block, splat(-1)); }
+inline Block lowerCase(Block _block) { return _mm256_or_si256(_block, splat(0x20)); }
+inline uint32_t mask(Block _block) { return static_cast<uint32_t>(_mm256_movemask_epi8(_block)); }
+
+#elif defined(LANGUTIL_RUNS_SSE2)
+
+using Block = __m128i;
+size_t constexpr blockSize = 16;
+uint32_t constexpr fullMask = 0xffff;
+
+inline Block load(char const* _data) { return _mm_loadu_si128(reinterpret_cast<Block const*>(_data)); }
+inline Block splat(char _c) { return _mm_set1_epi8(_c); }
+inline Block equal(Block _block, char _c) { return _mm_cmpeq_epi8(_block, splat(_c)); }
+inline Block greater(Block _block, char _c) { return _mm_cmpgt_epi8(_block, splat(_c)); }
+inline Block less(Block _block, char _c) { return _mm_cmplt_epi8(_block, splat(_c)); }
+inline Block either(Block _a, Block _b) { return _mm_or_si128(_a, _b); }
+inline Block both(Block _a, Block _b) { return _mm_and_si128(_a, _b); }
+inline Block except(Block _a, Block _b) { return _mm_andnot_si128(_b, _a); }
+inline Block complement(Block _block) { return _mm_xor_si128(_block, splat(-1)); }
+inline Block lowerCase(Block _block) { return _mm_or_si128(_block, splat(0x20)); }
+inline uint32_t mask(Block _block) { return static_cast<uint32_t>(_mm_movemask_epi8(_block)); }
+
+#endif
+
+#if defined(LANGUTIL_RUNS_AVX2) || defined(LANGUTIL_RUNS_SSE2)
+
+/// Bytes are compared as signed values, so non-ASCII characters are never in an ASCII range.
+inline Block inRange(Block _block, char _first, char _last)
+{
+	return both(greater(_block, static_cast<char>(_first - 1)), less(_block, static_cast<char>(_last + 1)));
+}
+
+/// @returns the length of the longest prefix of @a _text whose characters are in the class
+/// described by @a _blockClass (a whole block at once) and @a _charClass (a single character).
+template <typename BlockClass, typename CharClass>
+size_t run(std::string_view _text, BlockClass _blockClass, CharClass _charClass)
+{
+	size_t position = 0;
+	for (; position + blockSize <= _text.size(); position += blockSize)
+	{
+		// Bit i is set if character i is not in the class.
+		uint32_t const outside = ~mask(_blockClass(load(_text.data() + position))) & fullMask;
+		if (outside != 0)
+			return position + static_cast<size_t>(__builtin_ctz(outside));
+	}
+	while (position < _text.size() && _charClass(_text[position]))
+		++position;
+	return position;
+}
+
+#else
+
+template <typename BlockClass, typename CharClass>
+size_t run(std::string_view _text, BlockClass, CharClass _charClass)
+{
+	size_t position = 0;
+	while (position < _text.size() && _charClass(_text[position]))
+		++position;
+	return position;
+}
+
+#endif
+
+bool isPlainStringChar(char _c, char _quote)
+{
+	auto const c = static_cast<unsigned char>(_c);
+	return 0x20 <= c && c <= 0x7e && _c != _quote && _c != '\\';
+}
+
+bool isAsciiLineChar(char _c)
+{
+	auto const c = static_cast<unsigned char>(_c);
+	return c < 0x80 && !(0x0a <= c && c <= 0x0d);
+}
+
+bool isCommentTextChar(char _c)
+{
+	return _c != '*' && _c != '\n' && _c != '\r';
+}
+
+}
+
+size_t solidity::langutil::whiteSpaceRun(std::string_view _text)
+{
+	return run(
+		_text,
+		[](auto _block) {
+			return either(
+				either(equal(_block, ' '), equal(_block, '\t')),
+				either(equal(_block, '\n'), equal(_block, '\r'))
+			);
+		},
+		isWhiteSpace
+	);
+}
+
+size_t solidity::langutil::identifierPartRun(std::string_view _text)
+{
+	return run(
+		_text,
+		[](auto _block) {
+			return either(
+				either(inRange(lowerCase(_block), 'a', 'z'), inRange(_block, '0', '9')),
+				either(equal(_block, '_'), equal(_block, '$'))
+			);
+		},
+		isIdentifierPart
+	);
+}
+
+size_t solidity::langutil::hexDigitRun(std::string_view _text)
+{
+	return run(
+		_text,
+		[](auto _block) {
+			return either(inRange(_block, '0', '9'), inRange(lowerCase(_block), 'a', 'f'));
+		},
+		isHexDigit
+	);
+}
+
+size_t solidity::langutil::plainStringRun(std::string_view _text, char _quote)
+{
+	return run(
+		_text,
+		[=](auto _block) {
+			return except(
+				inRange(_block, 0x20, 0x7e),
+				either(equal(_block, _quote), equal(_block, '\\'))
+			);
+		},
+		[=](char _c) { return isPlainStringChar(_c, _quote); }
+	);
+}
+
+size_t solidity::langutil::asciiLineRun(std::string_view _text)
+{
+	return run(
+		_text,
+		[](auto _block) {
+			return except(greater(_block, -1), inRange(_block, 0x0a, 0x0d));
+		},
+		isAsciiLineChar
+	);
+}
+
+size_t solidity::langutil::commentTextRun(std::string_view _text)
+{
+	return run(
+		_text,
+		[](auto _block) {
+			return complement(either(equal(_block, '*'), either(equal(_block, '\n'), equal(_block, '\r'))));
+		},
+		isCommentTextChar
+	);
+}
@@ -0,0 +1,58 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+// SPDX-License-Identifier: GPL-3.0
+/**
+ * Functions that measure runs of characters of one class, used by the scanner
+ * to skip or copy long runs at once. They process 32 (AVX2) or 16 (SSE2) characters
+ * per step if the compiler targets these instruction sets and one character otherwise.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace solidity::langutil
+{
+
+/// @returns the length of the longest prefix of @a _text that consists of characters
+/// for which isWhiteSpace() is true.
+size_t whiteSpaceRun(std::string_view _text);
+
+/// @returns the length of the longest prefix of @a _text that consists of characters
+/// for which isIdentifierPart() is true.
+size_t identifierPartRun(std::string_view _text);
+
+/// @returns the length of the longest prefix of @a _text that consists of characters
+/// for which isHexDigit() is true.
+size_t hexDigitRun(std::string_view _text);
+
+/// @returns the length of the longest prefix of @a _text that consists of printable ASCII
+/// characters other than @a _quote and the backslash, i.e. of characters that a string
+/// literal delimited by @a _quote contains verbatim.
+size_t plainStringRun(std::string_view _text, char _quote);
+
+/// @returns the length of the longest prefix of @a _text that consists of ASCII characters
+/// other than the line terminators '\n', '\v', '\f' and '\r'. Non-ASCII characters end the run,
+/// since they might start a Unicode line terminator.
+size_t asciiLineRun(std::string_view _text);
+
+/// @returns the length of the longest prefix of @a _text that contains neither '*'
+/// nor one of the line terminators '\n' and '\r'.
+size_t commentTextRun(std::string_view _text);
+
+}
@@ -50,6 +50,7 @@
  * Solidity scanner.
  */
 
+#include <liblangutil/CharacterRuns.h>
 #include <liblangutil/Common.h>
 #include <liblangutil/Exceptions.h>
 #include <liblangutil/Scanner.h>
@@ -248,8 +249,13 @@ Token Scanner::selectToken(char _next, Token _then, Token _else)
 bool Scanner::skipWhitespace()
 {
 	size_t const startPosition = sourcePos();
-	while (isWhiteSpace(m_char))
+	// The first character is checked through m_char, which is an artificial
+	// space after a multi-line comment.
+	if (isWhiteSpace(m_char))
+	{
 		advance();
+		advanceBy(whiteSpaceRun(m_source.remaining()));
+	}
 	// Return whether or not we skipped any characters.
 	return sourcePos() != startPosition;
 }
@@ -283,11 +289,16 @@ static ScannerError validateBiDiMarkup(CharStream& _stream, size_t _startPositio
 	};
 
 	size_t endPosition = _stream.position();
-	_stream.setPosition(_startPosition);
+	std::string_view const text = _stream.source().substr(0, endPosition);
 
 	int directionOverrideDepth = 0;
 
-	for (size_t currentPos = _startPosition; currentPos < endPosition; ++currentPos)
+	// All directional sequences start with the same byte, so only its occurrences need to be checked.
+	for (
+		size_t currentPos = text.find('\xE2', _startPosition);
+		currentPos != std::string_view::npos;
+		currentPos = text.find('\xE2', currentPos + 1)
+	)
 	{
 		_stream.setPosition(currentPos);
 
@@ -311,9 +322,12 @@ Token Scanner::skipSingleLineComment()
 	// Line terminator is not part of the comment. If it is a
 	// non-ascii line terminator, it will result in a parser error.
 	size_t startPosition = m_source.position();
-	while (!isUnicodeLinebreak())
-		if (!advance())
+	while (true)
+	{
+		advanceBy(asciiLineRun(m_source.remaining()));
+		if (isUnicodeLinebreak() || !advance())
 			break;
+	}
 
 	ScannerError unicodeDirectionError = validateBiDiMarkup(m_source, startPosition);
 	if (unicodeDirectionError != ScannerError::NoError)
@@ -383,6 +397,14 @@ size_t Scanner::scanSingleLineDocComment()
 			break;
 		addCommentLiteralChar(m_char);
 		advance();
+		std::string_view text = m_source.remaining().substr(0, asciiLineRun(m_source.remaining()));
+		if (!text.empty())
+		{
+			addCommentLiteral(text);
+			advanceBy(text.size());
+			// Same as if the loop above had visited the characters one by one.
+			endPosition = m_source.position() - 1;
+		}
 	}
 	literal.complete();
 	return endPosition;
@@ -393,6 +415,15 @@ Token Scanner::skipMultiLineComment()
 	size_t startPosition = m_source.position();
 	while (!isSourcePastEndOfInput())
 	{
+		// Only a '*' can start the end of the comment.
+		if (m_char != '*')
+		{
+			size_t const star = m_source.source().find('*', sourcePos());
+			advanceBy((star == std::string_view::npos ? m_source.size() : star) - sourcePos());
+			if (isSourcePastEndOfInput())
+				break;
+		}
+
 		char prevChar = m_char;
 		advance();
 
@@ -460,6 +491,9 @@ Token Scanner::scanMultiLineDocComment()
 		addCommentLiteralChar(m_char);
 		charsAdded = true;
 		advance();
+		std::string_view text = m_source.remaining().substr(0, commentTextRun(m_source.remaining()));
+		addCommentLiteral(text);
+		advanceBy(text.size());
 	}
 	literal.complete();
 	if (!endFound)
@@ -828,6 +862,13 @@ Token Scanner::scanString(bool const _isUnicode)
 	LiteralScope literal(this, LITERAL_TYPE_STRING);
 	while (m_char != quote && !isSourcePastEndOfInput() && !isUnicodeLinebreak())
 	{
+		if (size_t const length = plainStringRun(m_source.remaining(), quote))
+		{
+			addLiteral(m_source.remaining().substr(0, length));
+			advanceBy(length);
+			continue;
+		}
+
 		char c = m_char;
 		advance();
 		if (c == '\\')
@@ -875,6 +916,18 @@ Token Scanner::scanHexString()
 	bool allowUnderscore = false;
 	while (m_char != quote && !isSourcePastEndOfInput())
 	{
+		// Decode all complete hex bytes up to the next separator at once.
+		std::string_view digits = m_source.remaining();
+		digits = digits.substr(0, hexDigitRun(digits) & ~size_t(1));
+		if (!digits.empty())
+		{
+			for (size_t i = 0; i < digits.size(); i += 2)
+				addLiteralChar(static_cast<char>(hexValue(digits[i]) * 16 + hexValue(digits[i + 1])));
+			advanceBy(digits.size());
+			allowUnderscore = true;
+			continue;
+		}
+
 		char c = m_char;
 
 		if (scanHexByte(c))
@@ -944,8 +997,16 @@ Token Scanner::scanNumber(char _charSeen)
 				if (!isHexDigit(m_char))
 					return setError(ScannerError::IllegalHexDigit); // we must have at least one hex digit after 'x'
 
-				while (isHexDigit(m_char) || m_char == '_') // We keep the underscores for later validation
-					addLiteralCharAndAdvance();
+				while (true)
+				{
+					std::string_view const digits = m_source.remaining();
+					size_t const length = hexDigitRun(digits);
+					addLiteral(digits.substr(0, length));
+					advanceBy(length);
+					if (m_char != '_')
+						break;
+					addLiteralCharAndAdvance(); // We keep the underscores for later validation
+				}
 			}
 			else if (isDecimalDigit(m_char))
 				// We do not allow octal numbers
@@ -1016,8 +1077,17 @@ std::tuple<Token, unsigned, unsigned> Scanner::scanIdentifierOrKeyword()
 	LiteralScope literal(this, LITERAL_TYPE_STRING);
 	addLiteralCharAndAdvance();
 	// Scan the rest of the identifier characters.
-	while (isIdentifierPart(m_char) || (m_char == '.' && m_kind == ScannerKind::Yul))
-		addLiteralCharAndAdvance();
+	while (true)
+	{
+		std::string_view part = m_source.remaining();
+		part = part.substr(0, identifierPartRun(part));
+		addLiteral(part);
+		advanceBy(part.size());
+		if (m_char == '.' && m_kind == ScannerKind::Yul)
+			addLiteralCharAndAdvance();
+		else
+			break;
+	}
 	literal.complete();
 
 	auto const token = TokenTraits::fromIdentifierOrKeyword(m_tokens[NextNext].literal);
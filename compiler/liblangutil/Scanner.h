@@ -200,10 +200,14 @@ private:
 	inline void addLiteralChar(char c) { m_tokens[NextNext].literal.push_back(c); }
 	inline void addCommentLiteralChar(char c) { m_skippedComments[NextNext].literal.push_back(c); }
 	inline void addLiteralCharAndAdvance() { addLiteralChar(m_char); advance(); }
+	inline void addLiteral(std::string_view _text) { m_tokens[NextNext].literal.append(_text); }
+	inline void addCommentLiteral(std::string_view _text) { m_skippedComments[NextNext].literal.append(_text); }
 	void addUnicodeAsUTF8(unsigned codepoint);
 	///@}
 
 	bool advance() { m_char = m_source.advanceAndGet(); return !m_source.isPastEndOfInput(); }
+	/// Advances over the next @a _chars characters at once, which must not exceed the remaining input.
+	void advanceBy(size_t _chars) { if (_chars > 0) m_char = m_source.advanceAndGet(_chars); }
 	void rollback(size_t _amount) { m_char = m_source.rollback(_amount); }
 	/// Rolls back to the start of the current token and re-runs the scanner.
 	void rescan();
@@ -28,6 +28,7 @@
 
 #include <cstdlib>
 #include <list>
+#include <mutex>
 #include <string>
 
 #include "license.h"
@@ -45,6 +46,15 @@ namespace
 // The std::strings in this list must not be resized after they have been added here (via solidity_alloc()), because
 // this may potentially change the pointer that was passed to the caller from solidity_alloc().
 static std::list<std::string> solidityAllocations;
+/// Guards solidityAllocations, so that compilations can be run from several threads at once.
+static std::mutex solidityAllocationsMutex;
+
+/// Moves @p _data to the list of allocations and returns the pointer that is passed to the caller.
+char* allocate(std::string _data)
+{
+	std::lock_guard<std::mutex> lock(solidityAllocationsMutex);
+	return solidityAllocations.emplace_back(std::move(_data)).data();
+}
 
 /// Find the equivalent to @p _data in the list of allocations of solidity_alloc(),
 /// removes it from the list and returns its value.
@@ -53,6 +63,7 @@ static std::list<std::string> solidityAllocations;
 /// on the caller-side and hence, will call abort() then.
 std::string takeOverAllocation(char const* _data)
 {
+	std::lock_guard<std::mutex> lock(solidityAllocationsMutex);
 	for (auto iter = begin(solidityAllocations); iter != end(solidityAllocations); ++iter)
 		if (iter->data() == _data)
 		{
@@ -106,9 +117,37 @@ ReadCallback::Callback wrapReadCallback(CStyleReadFileCallback _readCallback, vo
 	return readCallback;
 }
 
-std::string compile(std::string _input, CStyleReadFileCallback _readCallback, void* _readContext)
+std::string compile(
+	std::string _input,
+	CStyleReadFileCallback _readCallback,
+	void* _readContext,
+	CStyleASTCallback _astCallback = nullptr,
+	void* _astContext = nullptr,
+	CStyleArtifactCallback _artifactCallback = nullptr,
+	void* _artifactContext = nullptr
+)
 {
 	StandardCompiler compiler(wrapReadCallback(_readCallback, _readContext));
+	if (_astCallback)
+		compiler.setASTSink([=](std::string const& _sourceName, std::string_view _chunk) {
+			_astCallback(_astContext, _sourceName.c_str(), _chunk.data(), _chunk.size());
+		});
+	if (_artifactCallback)
+		compiler.setArtifactSink([=](
+			std::string const& _sourceName,
+			std::string const& _contractName,
+			std::string const& _artifact,
+			std::string_view _data
+		) {
+			_artifactCallback(
+				_artifactContext,
+				_sourceName.c_str(),
+				_contractName.c_str(),
+				_artifact.c_str(),
+				_data.data(),
+				_data.size()
+			);
+		});
 	return compiler.compile(std::move(_input));
 }
 
@@ -129,14 +168,36 @@ extern char const* solidity_version() noexcept
 
 extern char* solidity_compile(char const* _input, CStyleReadFileCallback _readCallback, void* _readContext) noexcept
 {
-	return solidityAllocations.emplace_back(compile(_input, _readCallback, _readContext)).data();
+	return allocate(compile(_input, _readCallback, _readContext));
+}
+
+extern char* solidity_compile_with_ast_callback(
+	char const* _input,
+	CStyleReadFileCallback _readCallback,
+	void* _readContext,
+	CStyleASTCallback _astCallback,
+	void* _astContext
+) noexcept
+{
+	return allocate(compile(_input, _readCallback, _readContext, _astCallback, _astContext));
+}
+
+extern char* solidity_compile_with_artifact_callback(
+	char const* _input,
+	CStyleReadFileCallback _readCallback,
+	void* _readContext,
+	CStyleArtifactCallback _artifactCallback,
+	void* _artifactContext
+) noexcept
+{
+	return allocate(compile(_input, _readCallback, _readContext, nullptr, nullptr, _artifactCallback, _artifactContext));
 }
 
 extern char* solidity_alloc(size_t _size) noexcept
 {
 	try
 	{
-		return solidityAllocations.emplace_back(_size, '\0').data();
+		return allocate(std::string(_size, '\0'));
 	}
 	catch (...)
 	{
@@ -154,6 +215,7 @@ extern void solidity_reset() noexcept
 {
 	// This is called right before each compilation, but not at the end, so additional memory
 	// can be freed here.
+	std::lock_guard<std::mutex> lock(solidityAllocationsMutex);
 	solidityAllocations.clear();
 }
 
@@ -205,7 +267,7 @@ extern char* file_reader_source_unit_name(void *p, const char* path) noexcept
 #ifdef FILE_READER_DEBUG
 	cout << "file_reader_source_unit_name " << path << " " << name << endl;
 #endif
-	return solidityAllocations.emplace_back(name).data();
+	return allocate(name);
 }
 extern char* file_reader_read(void *p, const char* name, int* success) noexcept
 {
@@ -213,19 +275,22 @@ extern char* file_reader_read(void *p, const char* name, int* success) noexcept
 	cout << "file_reader_read " << name << endl;
 #endif
 	FileReader *fileReader = (FileReader *)p;
-	auto map = fileReader->sourceUnits();
-	if (map.count(name)) {
+	auto const& buffers = fileReader->sourceBuffers();
+	if (auto it = buffers.find(name); it != buffers.end()) {
 #ifdef FILE_READER_DEBUG
 		cout << "cached" << endl;
 #endif
 		*success = true;
-		return solidityAllocations.emplace_back(map[name]).data();
+		// The caller owns the returned memory and may modify it, so it gets a copy of the shared buffer.
+		return allocate(std::string(it->second->text()));
 	}
 	ReadCallback::Result res = fileReader->readFile("source", name);
 	*success = res.success;
 #ifdef FILE_READER_DEBUG
 	cout << "success " << res.success << endl;
 #endif
-	return solidityAllocations.emplace_back(res.responseOrErrorMessage).data();
+	if (res.contents)
+		return allocate(std::string(res.contents->text()));
+	return allocate(res.responseOrErrorMessage);
 }
 }
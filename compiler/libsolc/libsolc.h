@@ -52,6 +52,37 @@ extern "C" {
 /// If the callback is not supported, *o_contents and *o_error must be set to NULL.
 typedef void (*CStyleReadFileCallback)(void* _context, char const* _kind, char const* _data, char** o_contents, char** o_error);
 
+/// Callback used to pass on the AST of a source file while it is being written.
+///
+/// @param _context The astContext passed to solidity_compile_with_ast_callback. Can be NULL.
+/// @param _sourceName The name of the source unit the AST belongs to.
+/// @param _data The next part of the AST of the source unit in the compact JSON format. It is not zero-terminated.
+/// @param _size The size of @p _data in bytes.
+///
+/// All parts of the AST of a source unit are passed one after another. The memory of @p _data
+/// is owned by the compiler and is only valid during the call.
+typedef void (*CStyleASTCallback)(void* _context, char const* _sourceName, char const* _data, size_t _size);
+
+/// Callback used to pass on an artifact of a contract or the AST of a source file.
+///
+/// @param _context The artifactContext passed to solidity_compile_with_artifact_callback. Can be NULL.
+/// @param _sourceName The name of the source unit the artifact belongs to.
+/// @param _contractName The name of the contract the artifact belongs to. Empty for the AST.
+/// @param _artifact The kind of the artifact: "assembly" (text), "abi", "functionIds",
+///                  "privateFunctionIds" or "ast" (compact JSON).
+/// @param _data The artifact or, for the AST, the next part of it. It is not zero-terminated.
+/// @param _size The size of @p _data in bytes.
+///
+/// The memory of @p _data is owned by the compiler and is only valid during the call.
+typedef void (*CStyleArtifactCallback)(
+	void* _context,
+	char const* _sourceName,
+	char const* _contractName,
+	char const* _artifact,
+	char const* _data,
+	size_t _size
+);
+
 /// Returns the complete license document.
 ///
 /// The pointer returned must NOT be freed by the caller.
@@ -88,12 +119,46 @@ void solidity_free(char* _data) SOLC_NOEXCEPT;
 /// @param _readContext An optional context pointer passed to _readCallback. Can be NULL.
 ///
 /// @returns A pointer to the result. The pointer returned must be freed by the caller using solidity_free() or solidity_reset().
+///
+/// Several compilations may run at the same time, each on its own thread. Every call uses its own
+/// compiler state, so the results do not depend on what other threads compile.
 char* solidity_compile(char const* _input, CStyleReadFileCallback _readCallback, void* _readContext) SOLC_NOEXCEPT;
 
+/// Same as solidity_compile(), but the ASTs requested in the output selection are passed to
+/// @p _astCallback while the syntax tree is walked instead of being included in the output.
+/// This avoids building the JSON of large syntax trees in memory.
+///
+/// @param _astCallback The callback that receives the ASTs. Can be NULL, in which case the ASTs
+///                     are included in the output like by solidity_compile().
+/// @param _astContext An optional context pointer passed to _astCallback. Can be NULL.
+char* solidity_compile_with_ast_callback(
+	char const* _input,
+	CStyleReadFileCallback _readCallback,
+	void* _readContext,
+	CStyleASTCallback _astCallback,
+	void* _astContext
+) SOLC_NOEXCEPT;
+
+/// Same as solidity_compile(), but the assembly, the ABI and the function ids of the contracts and
+/// the ASTs requested in the output selection are passed to @p _artifactCallback one by one instead
+/// of being included in the output. They are neither escaped nor copied into the output JSON,
+/// which still contains the errors and all other artifacts.
+///
+/// @param _artifactCallback The callback that receives the artifacts. Can be NULL, in which case
+///                          the result is the same as that of solidity_compile().
+/// @param _artifactContext An optional context pointer passed to _artifactCallback. Can be NULL.
+char* solidity_compile_with_artifact_callback(
+	char const* _input,
+	CStyleReadFileCallback _readCallback,
+	void* _readContext,
+	CStyleArtifactCallback _artifactCallback,
+	void* _artifactContext
+) SOLC_NOEXCEPT;
+
 /// Frees up any allocated memory.
 ///
 /// NOTE: the pointer returned by solidity_compile as well as any other pointer retrieved via solidity_alloc()
-/// is invalid after calling this!
+/// is invalid after calling this! Do not call it while other threads are still compiling.
 void solidity_reset() SOLC_NOEXCEPT;
 
 void* file_reader_new() SOLC_NOEXCEPT;
@@ -106,9 +106,7 @@ FunctionDefinition const* ASTNode::resolveFunctionCall(FunctionCall const& _func
 
 ASTAnnotation& ASTNode::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = std::make_unique<ASTAnnotation>();
-	return *m_annotation;
+	return initAnnotation<ASTAnnotation>();
 }
 
 SourceUnitAnnotation& SourceUnit::annotation() const
@@ -26,6 +26,7 @@
 #include <libsolidity/ast/ASTForward.h>
 #include <libsolidity/ast/Types.h>
 #include <libsolidity/ast/ASTAnnotations.h>
+#include <libsolidity/ast/ASTArena.h>
 #include <libsolidity/ast/ASTEnums.h>
 #include <libsolidity/parsing/Token.h>
 
@@ -126,6 +127,10 @@ public:
 
 	virtual bool experimentalSolidityOnly() const { return false; }
 
+	/// Makes the annotation of this node be created in @a _arena, which the node itself
+	/// was allocated from.
+	void allocateAnnotationIn(ASTArena& _arena) { m_annotation.get_deleter().arena = &_arena; }
+
 protected:
 	size_t const m_id = 0;
 
@@ -133,13 +138,18 @@ protected:
 	T& initAnnotation() const
 	{
 		if (!m_annotation)
-			m_annotation = std::make_unique<T>();
+		{
+			if (ASTArena* arena = m_annotation.get_deleter().arena)
+				m_annotation.reset(new (arena->allocateAnnotation(sizeof(T), alignof(T))) T());
+			else
+				m_annotation.reset(new T());
+		}
 		return dynamic_cast<T&>(*m_annotation);
 	}
 
 private:
 	/// Annotation - is specialised in derived classes, is created upon request (because of polymorphism).
-	mutable std::unique_ptr<ASTAnnotation> m_annotation;
+	mutable std::unique_ptr<ASTAnnotation, ASTArena::Deleter> m_annotation;
 	SourceLocation m_location;
 };
 
@@ -0,0 +1,40 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+// SPDX-License-Identifier: GPL-3.0
+
+#include <libsolidity/ast/ASTArena.h>
+
+using namespace solidity::frontend;
+
+void* ASTArena::allocateNode(std::size_t _bytes, std::size_t _alignment)
+{
+	m_nodeBytes += _bytes;
+	return m_nodes.allocate(_bytes, _alignment);
+}
+
+void* ASTArena::allocateAnnotation(std::size_t _bytes, std::size_t _alignment)
+{
+	std::lock_guard lock(m_annotationMutex);
+	m_annotationBytes += _bytes;
+	return m_annotations.allocate(_bytes, _alignment);
+}
+
+std::size_t ASTArena::allocatedBytes() const
+{
+	std::lock_guard lock(m_annotationMutex);
+	return m_nodeBytes + m_annotationBytes;
+}
@@ -0,0 +1,102 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+// SPDX-License-Identifier: GPL-3.0
+/**
+ * Memory arena for the nodes and annotations of a source unit.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+
+namespace solidity::frontend
+{
+
+/**
+ * Arena that hands out memory for the AST nodes of one source unit, their shared pointer
+ * control blocks and their annotations. Memory is never returned to the arena one object at a
+ * time, it is all released at once when the arena is destroyed. Nodes are allocated through
+ * @a Allocator, which keeps the arena alive as long as any node allocated from it exists.
+ */
+class ASTArena
+{
+public:
+	template <class T>
+	class Allocator
+	{
+	public:
+		using value_type = T;
+
+		explicit Allocator(std::shared_ptr<ASTArena> _arena): m_arena(std::move(_arena)) {}
+		template <class U>
+		Allocator(Allocator<U> const& _other): m_arena(_other.arena()) {}
+
+		T* allocate(std::size_t _count)
+		{
+			return static_cast<T*>(m_arena->allocateNode(_count * sizeof(T), alignof(T)));
+		}
+		void deallocate(T*, std::size_t) {}
+
+		std::shared_ptr<ASTArena> const& arena() const { return m_arena; }
+
+		template <class U>
+		bool operator==(Allocator<U> const& _other) const { return m_arena == _other.arena(); }
+		template <class U>
+		bool operator!=(Allocator<U> const& _other) const { return m_arena != _other.arena(); }
+
+	private:
+		std::shared_ptr<ASTArena> m_arena;
+	};
+
+	/// Deleter for objects constructed in the arena (if @a arena is set) or on the heap (otherwise).
+	/// The annotations are destroyed by their nodes, which keep the arena alive.
+	struct Deleter
+	{
+		ASTArena* arena = nullptr;
+
+		template <class T>
+		void operator()(T* _object) const
+		{
+			if (arena)
+				_object->~T();
+			else
+				delete _object;
+		}
+	};
+
+	/// @returns memory of @a _bytes bytes for a node, aligned to @a _alignment.
+	/// Nodes are only created by the parser of the source unit, so this does not lock.
+	void* allocateNode(std::size_t _bytes, std::size_t _alignment);
+	/// @returns memory of @a _bytes bytes for an annotation, aligned to @a _alignment.
+	/// Can be called concurrently, since annotations are created during analysis.
+	void* allocateAnnotation(std::size_t _bytes, std::size_t _alignment);
+
+	/// @returns the number of bytes handed out so far.
+	std::size_t allocatedBytes() const;
+
+private:
+	std::pmr::monotonic_buffer_resource m_nodes;
+	std::size_t m_nodeBytes = 0;
+	mutable std::mutex m_annotationMutex;
+	std::pmr::monotonic_buffer_resource m_annotations;
+	std::size_t m_annotationBytes = 0;
+};
+
+}
@@ -36,6 +36,7 @@
 #include <utility>
 #include <vector>
 #include <algorithm>
+#include <cstdint>
 #include <limits>
 #include <type_traits>
 #include <range/v3/view/map.hpp>
@@ -46,6 +47,10 @@ using namespace solidity::langutil;
 namespace
 {
 
+/// Members of the placeholders of child nodes while streaming. They cannot occur in the AST json.
+char const* const streamedNodeKey = "\x01node";
+char const* const streamedInEventKey = "\x01inEvent";
+
 template<typename V, template<typename> typename C>
 void addIfSet(std::vector<std::pair<std::string, Json::Value>>& _attributes, std::string const& _name, C<V> const& _value)
 {
@@ -180,11 +185,47 @@ void ASTJsonExporter::appendExpressionAttributes(
 
 void ASTJsonExporter::print(std::ostream& _stream, ASTNode const& _node, util::JsonFormat const& _format)
 {
-	_stream << util::jsonPrint(toJson(_node), _format);
+	if (_format.format == util::JsonFormat::Compact)
+		stream(_stream, _node);
+	else
+		_stream << util::jsonPrint(toJson(_node), _format);
+}
+
+void ASTJsonExporter::stream(std::ostream& _stream, ASTNode const& _node)
+{
+	solAssert(!m_streaming);
+	ScopedSaveAndRestore streaming(m_streaming, true);
+	ScopedSaveAndRestore inEvent(m_inEvent, bool(m_inEvent));
+	streamNode(_stream, _node);
+}
+
+void ASTJsonExporter::streamNode(std::ostream& _stream, ASTNode const& _node)
+{
+	// Only the json of the node itself is built. Its children are represented by placeholders,
+	// which are replaced by writing the children one after another.
+	_node.accept(*this);
+	Json::Value const value = util::removeNullMembers(std::move(m_currentValue));
+	util::jsonCompactPrint(_stream, value, [this](Json::Value const& _value, std::ostream& _out) {
+		if (!_value.isObject() || !_value.isMember(streamedNodeKey))
+			return false;
+		m_inEvent = _value[streamedInEventKey].asBool();
+		auto const address = static_cast<std::uintptr_t>(_value[streamedNodeKey].asUInt64());
+		streamNode(_out, *reinterpret_cast<ASTNode const*>(address));
+		return true;
+	});
 }
 
 Json::Value ASTJsonExporter::toJson(ASTNode const& _node)
 {
+	if (m_streaming)
+	{
+		// The node is visited when the placeholder is written, which might be after the visit of
+		// its parent has ended, so the state of the visit is stored with it.
+		Json::Value placeholder{Json::objectValue};
+		placeholder[streamedNodeKey] = Json::UInt64(reinterpret_cast<std::uintptr_t>(&_node));
+		placeholder[streamedInEventKey] = m_inEvent;
+		return placeholder;
+	}
 	_node.accept(*this);
 	return util::removeNullMembers(std::move(m_currentValue));
 }
@@ -60,6 +60,9 @@ public:
 	);
 	/// Output the json representation of the AST to _stream.
 	void print(std::ostream& _stream, ASTNode const& _node, util::JsonFormat const& _format);
+	/// Writes the compact json representation of the AST to @a _stream node by node, without
+	/// building the json representation of the whole tree first.
+	void stream(std::ostream& _stream, ASTNode const& _node);
 	Json::Value toJson(ASTNode const& _node);
 	template <class T>
 	Json::Value toJson(std::vector<ASTPointer<T>> const& _nodes)
@@ -165,6 +168,8 @@ private:
 	{
 		return _node ? toJson(*_node) : Json::nullValue;
 	}
+	/// Writes @a _node to @a _stream, with its children written in place of their placeholders.
+	void streamNode(std::ostream& _stream, ASTNode const& _node);
 	static std::string contractKind(ContractKind _kind);
 	static std::string functionCallKind(FunctionCallKind _kind);
 	static std::string literalTokenKind(Token _token);
@@ -207,6 +212,7 @@ private:
 
 	CompilerStack::State m_stackState = CompilerStack::State::Empty; ///< Used to only access information that already exists
 	bool m_inEvent = false; ///< whether we are currently inside an event or not
+	bool m_streaming = false; ///< whether toJson() returns placeholders that are written by streamNode()
 	Json::Value m_currentValue;
 	std::map<std::string, unsigned> m_sourceIndices;
 };
@@ -25,1123 +25,47 @@ using namespace solidity;
 using namespace solidity::frontend;
 using namespace solidity::util;
 
-BoolType const TypeProvider::m_boolean{};
-NullType const TypeProvider::m_nullType{};
-EmptyMapType const TypeProvider::m_emptyMapType{};
-TvmCellType const TypeProvider::m_tvmcell{};
-TvmSliceType const TypeProvider::m_tvmslice{};
-TvmBuilderType const TypeProvider::m_tvmbuilder{};
-StringBuilderType const TypeProvider::m_stringBuilder{};
-
-InaccessibleDynamicType const TypeProvider::m_inaccessibleDynamic{};
-
-/// The string and bytes unique_ptrs are initialized when they are first used because
-/// they rely on `byte` being available which we cannot guarantee in the static init context.
-std::unique_ptr<ArrayType> TypeProvider::m_bytesStorage;
-std::unique_ptr<ArrayType> TypeProvider::m_bytesMemory;
-std::unique_ptr<ArrayType> TypeProvider::m_bytesCalldata;
-std::unique_ptr<ArrayType> TypeProvider::m_stringStorage;
-std::unique_ptr<ArrayType> TypeProvider::m_stringMemory;
-std::unique_ptr<Variant> TypeProvider::m_variant;
-
-TupleType const TypeProvider::m_emptyTuple{};
-AddressType const TypeProvider::m_address{};
-InitializerListType const TypeProvider::m_initializerList{};
-CallListType const TypeProvider::m_callList{};
-
-//for i in range(1, 258):
-//	print("{{std::make_unique<IntegerType>({}, IntegerType::Modifier::Signed)}},".format(i))
-std::array<std::unique_ptr<IntegerType>, 257> const TypeProvider::m_intM{{
-	{std::make_unique<IntegerType>(1, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(2, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(3, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(4, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(5, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(6, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(7, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(8, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(9, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(10, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(11, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(12, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(13, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(14, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(15, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(16, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(17, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(18, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(19, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(20, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(21, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(22, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(23, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(24, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(25, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(26, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(27, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(28, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(29, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(30, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(31, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(32, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(33, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(34, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(35, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(36, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(37, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(38, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(39, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(40, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(41, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(42, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(43, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(44, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(45, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(46, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(47, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(48, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(49, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(50, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(51, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(52, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(53, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(54, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(55, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(56, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(57, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(58, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(59, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(60, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(61, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(62, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(63, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(64, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(65, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(66, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(67, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(68, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(69, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(70, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(71, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(72, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(73, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(74, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(75, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(76, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(77, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(78, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(79, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(80, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(81, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(82, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(83, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(84, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(85, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(86, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(87, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(88, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(89, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(90, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(91, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(92, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(93, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(94, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(95, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(96, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(97, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(98, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(99, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(100, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(101, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(102, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(103, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(104, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(105, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(106, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(107, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(108, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(109, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(110, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(111, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(112, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(113, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(114, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(115, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(116, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(117, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(118, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(119, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(120, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(121, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(122, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(123, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(124, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(125, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(126, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(127, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(128, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(129, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(130, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(131, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(132, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(133, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(134, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(135, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(136, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(137, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(138, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(139, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(140, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(141, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(142, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(143, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(144, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(145, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(146, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(147, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(148, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(149, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(150, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(151, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(152, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(153, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(154, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(155, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(156, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(157, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(158, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(159, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(160, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(161, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(162, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(163, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(164, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(165, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(166, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(167, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(168, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(169, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(170, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(171, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(172, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(173, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(174, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(175, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(176, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(177, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(178, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(179, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(180, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(181, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(182, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(183, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(184, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(185, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(186, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(187, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(188, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(189, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(190, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(191, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(192, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(193, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(194, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(195, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(196, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(197, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(198, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(199, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(200, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(201, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(202, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(203, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(204, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(205, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(206, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(207, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(208, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(209, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(210, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(211, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(212, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(213, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(214, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(215, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(216, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(217, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(218, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(219, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(220, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(221, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(222, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(223, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(224, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(225, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(226, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(227, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(228, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(229, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(230, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(231, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(232, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(233, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(234, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(235, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(236, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(237, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(238, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(239, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(240, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(241, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(242, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(243, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(244, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(245, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(246, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(247, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(248, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(249, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(250, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(251, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(252, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(253, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(254, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(255, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(256, IntegerType::Modifier::Signed)},
-	{std::make_unique<IntegerType>(257, IntegerType::Modifier::Signed)},
-}};
-
-//for i in range(1, 257):
-//	print("{{std::make_unique<IntegerType>({}, IntegerType::Modifier::Unsigned)}},".format(i))
-std::array<std::unique_ptr<IntegerType>, 256> const TypeProvider::m_uintM{{
-	{std::make_unique<IntegerType>(1, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(2, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(3, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(4, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(5, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(6, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(7, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(8, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(9, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(10, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(11, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(12, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(13, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(14, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(15, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(16, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(17, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(18, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(19, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(20, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(21, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(22, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(23, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(24, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(25, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(26, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(27, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(28, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(29, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(30, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(31, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(32, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(33, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(34, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(35, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(36, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(37, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(38, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(39, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(40, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(41, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(42, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(43, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(44, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(45, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(46, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(47, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(48, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(49, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(50, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(51, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(52, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(53, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(54, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(55, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(56, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(57, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(58, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(59, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(60, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(61, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(62, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(63, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(64, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(65, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(66, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(67, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(68, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(69, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(70, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(71, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(72, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(73, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(74, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(75, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(76, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(77, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(78, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(79, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(80, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(81, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(82, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(83, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(84, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(85, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(86, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(87, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(88, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(89, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(90, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(91, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(92, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(93, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(94, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(95, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(96, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(97, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(98, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(99, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(100, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(101, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(102, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(103, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(104, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(105, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(106, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(107, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(108, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(109, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(110, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(111, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(112, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(113, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(114, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(115, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(116, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(117, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(118, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(119, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(120, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(121, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(122, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(123, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(124, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(125, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(126, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(127, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(128, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(129, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(130, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(131, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(132, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(133, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(134, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(135, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(136, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(137, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(138, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(139, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(140, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(141, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(142, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(143, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(144, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(145, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(146, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(147, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(148, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(149, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(150, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(151, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(152, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(153, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(154, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(155, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(156, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(157, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(158, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(159, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(160, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(161, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(162, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(163, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(164, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(165, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(166, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(167, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(168, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(169, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(170, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(171, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(172, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(173, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(174, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(175, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(176, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(177, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(178, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(179, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(180, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(181, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(182, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(183, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(184, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(185, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(186, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(187, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(188, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(189, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(190, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(191, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(192, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(193, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(194, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(195, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(196, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(197, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(198, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(199, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(200, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(201, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(202, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(203, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(204, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(205, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(206, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(207, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(208, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(209, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(210, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(211, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(212, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(213, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(214, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(215, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(216, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(217, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(218, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(219, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(220, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(221, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(222, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(223, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(224, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(225, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(226, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(227, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(228, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(229, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(230, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(231, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(232, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(233, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(234, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(235, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(236, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(237, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(238, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(239, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(240, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(241, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(242, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(243, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(244, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(245, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(246, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(247, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(248, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(249, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(250, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(251, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(252, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(253, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(254, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(255, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<IntegerType>(256, IntegerType::Modifier::Unsigned)},
-}};
-
-std::unique_ptr<NanType> const TypeProvider::m_qintNAN = std::make_unique<NanType>();
-
-std::array<std::unique_ptr<QIntegerType>, 257> const TypeProvider::m_qintM{{
-	{std::make_unique<QIntegerType>(1, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(2, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(3, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(4, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(5, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(6, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(7, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(8, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(9, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(10, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(11, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(12, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(13, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(14, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(15, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(16, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(17, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(18, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(19, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(20, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(21, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(22, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(23, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(24, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(25, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(26, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(27, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(28, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(29, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(30, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(31, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(32, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(33, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(34, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(35, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(36, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(37, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(38, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(39, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(40, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(41, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(42, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(43, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(44, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(45, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(46, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(47, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(48, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(49, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(50, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(51, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(52, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(53, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(54, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(55, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(56, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(57, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(58, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(59, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(60, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(61, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(62, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(63, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(64, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(65, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(66, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(67, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(68, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(69, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(70, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(71, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(72, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(73, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(74, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(75, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(76, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(77, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(78, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(79, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(80, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(81, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(82, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(83, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(84, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(85, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(86, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(87, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(88, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(89, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(90, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(91, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(92, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(93, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(94, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(95, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(96, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(97, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(98, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(99, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(100, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(101, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(102, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(103, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(104, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(105, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(106, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(107, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(108, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(109, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(110, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(111, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(112, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(113, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(114, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(115, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(116, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(117, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(118, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(119, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(120, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(121, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(122, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(123, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(124, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(125, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(126, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(127, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(128, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(129, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(130, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(131, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(132, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(133, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(134, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(135, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(136, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(137, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(138, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(139, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(140, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(141, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(142, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(143, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(144, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(145, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(146, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(147, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(148, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(149, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(150, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(151, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(152, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(153, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(154, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(155, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(156, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(157, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(158, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(159, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(160, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(161, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(162, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(163, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(164, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(165, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(166, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(167, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(168, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(169, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(170, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(171, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(172, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(173, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(174, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(175, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(176, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(177, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(178, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(179, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(180, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(181, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(182, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(183, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(184, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(185, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(186, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(187, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(188, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(189, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(190, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(191, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(192, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(193, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(194, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(195, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(196, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(197, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(198, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(199, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(200, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(201, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(202, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(203, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(204, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(205, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(206, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(207, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(208, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(209, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(210, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(211, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(212, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(213, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(214, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(215, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(216, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(217, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(218, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(219, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(220, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(221, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(222, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(223, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(224, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(225, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(226, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(227, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(228, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(229, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(230, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(231, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(232, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(233, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(234, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(235, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(236, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(237, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(238, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(239, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(240, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(241, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(242, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(243, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(244, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(245, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(246, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(247, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(248, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(249, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(250, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(251, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(252, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(253, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(254, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(255, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(256, IntegerType::Modifier::Signed)},
-	{std::make_unique<QIntegerType>(257, IntegerType::Modifier::Signed)},
-}};
-
-std::array<std::unique_ptr<QIntegerType>, 256> const TypeProvider::m_quintM{{
-	{std::make_unique<QIntegerType>(1, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(2, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(3, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(4, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(5, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(6, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(7, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(8, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(9, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(10, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(11, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(12, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(13, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(14, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(15, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(16, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(17, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(18, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(19, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(20, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(21, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(22, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(23, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(24, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(25, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(26, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(27, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(28, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(29, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(30, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(31, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(32, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(33, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(34, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(35, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(36, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(37, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(38, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(39, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(40, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(41, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(42, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(43, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(44, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(45, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(46, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(47, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(48, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(49, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(50, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(51, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(52, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(53, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(54, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(55, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(56, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(57, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(58, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(59, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(60, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(61, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(62, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(63, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(64, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(65, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(66, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(67, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(68, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(69, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(70, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(71, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(72, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(73, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(74, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(75, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(76, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(77, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(78, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(79, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(80, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(81, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(82, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(83, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(84, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(85, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(86, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(87, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(88, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(89, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(90, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(91, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(92, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(93, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(94, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(95, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(96, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(97, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(98, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(99, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(100, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(101, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(102, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(103, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(104, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(105, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(106, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(107, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(108, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(109, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(110, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(111, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(112, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(113, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(114, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(115, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(116, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(117, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(118, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(119, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(120, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(121, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(122, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(123, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(124, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(125, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(126, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(127, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(128, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(129, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(130, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(131, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(132, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(133, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(134, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(135, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(136, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(137, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(138, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(139, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(140, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(141, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(142, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(143, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(144, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(145, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(146, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(147, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(148, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(149, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(150, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(151, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(152, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(153, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(154, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(155, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(156, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(157, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(158, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(159, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(160, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(161, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(162, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(163, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(164, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(165, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(166, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(167, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(168, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(169, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(170, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(171, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(172, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(173, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(174, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(175, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(176, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(177, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(178, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(179, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(180, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(181, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(182, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(183, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(184, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(185, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(186, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(187, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(188, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(189, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(190, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(191, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(192, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(193, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(194, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(195, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(196, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(197, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(198, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(199, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(200, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(201, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(202, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(203, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(204, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(205, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(206, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(207, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(208, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(209, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(210, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(211, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(212, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(213, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(214, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(215, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(216, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(217, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(218, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(219, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(220, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(221, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(222, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(223, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(224, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(225, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(226, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(227, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(228, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(229, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(230, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(231, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(232, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(233, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(234, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(235, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(236, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(237, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(238, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(239, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(240, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(241, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(242, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(243, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(244, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(245, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(246, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(247, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(248, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(249, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(250, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(251, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(252, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(253, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(254, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(255, IntegerType::Modifier::Unsigned)},
-	{std::make_unique<QIntegerType>(256, IntegerType::Modifier::Unsigned)},
-}};
-
-std::unique_ptr<QBoolType> const TypeProvider::m_qbool = std::make_unique<QBoolType>();
-
-std::array<std::unique_ptr<FixedBytesType>, 32> const TypeProvider::m_bytesM{{
-	{std::make_unique<FixedBytesType>(1)},
-	{std::make_unique<FixedBytesType>(2)},
-	{std::make_unique<FixedBytesType>(3)},
-	{std::make_unique<FixedBytesType>(4)},
-	{std::make_unique<FixedBytesType>(5)},
-	{std::make_unique<FixedBytesType>(6)},
-	{std::make_unique<FixedBytesType>(7)},
-	{std::make_unique<FixedBytesType>(8)},
-	{std::make_unique<FixedBytesType>(9)},
-	{std::make_unique<FixedBytesType>(10)},
-	{std::make_unique<FixedBytesType>(11)},
-	{std::make_unique<FixedBytesType>(12)},
-	{std::make_unique<FixedBytesType>(13)},
-	{std::make_unique<FixedBytesType>(14)},
-	{std::make_unique<FixedBytesType>(15)},
-	{std::make_unique<FixedBytesType>(16)},
-	{std::make_unique<FixedBytesType>(17)},
-	{std::make_unique<FixedBytesType>(18)},
-	{std::make_unique<FixedBytesType>(19)},
-	{std::make_unique<FixedBytesType>(20)},
-	{std::make_unique<FixedBytesType>(21)},
-	{std::make_unique<FixedBytesType>(22)},
-	{std::make_unique<FixedBytesType>(23)},
-	{std::make_unique<FixedBytesType>(24)},
-	{std::make_unique<FixedBytesType>(25)},
-	{std::make_unique<FixedBytesType>(26)},
-	{std::make_unique<FixedBytesType>(27)},
-	{std::make_unique<FixedBytesType>(28)},
-	{std::make_unique<FixedBytesType>(29)},
-	{std::make_unique<FixedBytesType>(30)},
-	{std::make_unique<FixedBytesType>(31)},
-	{std::make_unique<FixedBytesType>(32)}
-}};
-
-std::array<std::unique_ptr<MagicType>, 9> const TypeProvider::m_magics{{
-	{std::make_unique<MagicType>(MagicType::Kind::Block)},
-	{std::make_unique<MagicType>(MagicType::Kind::Message)},
-	{std::make_unique<MagicType>(MagicType::Kind::Transaction)},
-	{std::make_unique<MagicType>(MagicType::Kind::ABI)},
-	{std::make_unique<MagicType>(MagicType::Kind::TVM)},
-	{std::make_unique<MagicType>(MagicType::Kind::Math)},
-	{std::make_unique<MagicType>(MagicType::Kind::Rnd)},
-	{std::make_unique<MagicType>(MagicType::Kind::Gosh)},
-	{std::make_unique<MagicType>(MagicType::Kind::BLS)}
-	// MetaType is stored separately
-}};
+TypeProvider::TypeProvider():
+	m_qintNAN{std::make_unique<NanType>()},
+	m_qbool{std::make_unique<QBoolType>()}
+{
+	for (unsigned bits = 1; bits <= 257; ++bits)
+	{
+		m_intM.at(bits - 1) = std::make_unique<IntegerType>(bits, IntegerType::Modifier::Signed);
+		m_qintM.at(bits - 1) = std::make_unique<QIntegerType>(bits, IntegerType::Modifier::Signed);
+	}
+	for (unsigned bits = 1; bits <= 256; ++bits)
+	{
+		m_uintM.at(bits - 1) = std::make_unique<IntegerType>(bits, IntegerType::Modifier::Unsigned);
+		m_quintM.at(bits - 1) = std::make_unique<QIntegerType>(bits, IntegerType::Modifier::Unsigned);
+	}
+	for (unsigned bytes = 1; bytes <= 32; ++bytes)
+		m_bytesM.at(bytes - 1) = std::make_unique<FixedBytesType>(bytes);
+	m_magics = {{
+		{std::make_unique<MagicType>(MagicType::Kind::Block)},
+		{std::make_unique<MagicType>(MagicType::Kind::Message)},
+		{std::make_unique<MagicType>(MagicType::Kind::Transaction)},
+		{std::make_unique<MagicType>(MagicType::Kind::ABI)},
+		{std::make_unique<MagicType>(MagicType::Kind::TVM)},
+		{std::make_unique<MagicType>(MagicType::Kind::Math)},
+		{std::make_unique<MagicType>(MagicType::Kind::Rnd)},
+		{std::make_unique<MagicType>(MagicType::Kind::Gosh)},
+		{std::make_unique<MagicType>(MagicType::Kind::BLS)}
+		// MetaType is stored separately
+	}};
+}
+
+TypeProvider::~TypeProvider()
+{
+	if (isSelected(this))
+		select(nullptr);
+}
+
+TypeProvider& TypeProvider::defaultInstance()
+{
+	static thread_local TypeProvider provider;
+	return provider;
+}
 
 inline void clearCache(Type const& type)
 {
@@ -1163,35 +87,47 @@ inline void clearCaches(Container& container)
 		clearCache(e);
 }
 
+std::unique_lock<std::recursive_mutex> TypeProvider::lock()
+{
+	TypeProvider& provider = instance();
+	if (!provider.m_concurrent)
+		return {};
+	return std::unique_lock<std::recursive_mutex>(provider.m_mutex);
+}
+
 void TypeProvider::reset()
 {
-	clearCache(m_boolean);
-	clearCache(m_inaccessibleDynamic);
-	clearCache(m_bytesStorage);
-	clearCache(m_bytesMemory);
-	clearCache(m_bytesCalldata);
-	clearCache(m_stringStorage);
-	clearCache(m_variant);
-	clearCache(m_stringMemory);
-	clearCache(m_emptyTuple);
-	clearCache(m_address);
-	clearCaches(instance().m_intM);
-	clearCaches(instance().m_uintM);
-	clearCaches(instance().m_bytesM);
-	clearCaches(instance().m_magics);
-
-	instance().m_generalTypes.clear();
-	instance().m_stringLiteralTypes.clear();
-	instance().m_ufixedMxN.clear();
-	instance().m_fixedMxN.clear();
-	instance().m_varinterger.clear();
+	TypeProvider& provider = instance();
+	auto lock = TypeProvider::lock();
+	clearCache(provider.m_boolean);
+	clearCache(provider.m_inaccessibleDynamic);
+	clearCache(provider.m_bytesStorage);
+	clearCache(provider.m_bytesMemory);
+	clearCache(provider.m_bytesCalldata);
+	clearCache(provider.m_stringStorage);
+	clearCache(provider.m_variant);
+	clearCache(provider.m_stringMemory);
+	clearCache(provider.m_emptyTuple);
+	clearCache(provider.m_address);
+	clearCaches(provider.m_intM);
+	clearCaches(provider.m_uintM);
+	clearCaches(provider.m_bytesM);
+	clearCaches(provider.m_magics);
+
+	provider.m_generalTypes.clear();
+	provider.m_stringLiteralTypes.clear();
+	provider.m_ufixedMxN.clear();
+	provider.m_fixedMxN.clear();
+	provider.m_varinterger.clear();
 }
 
 template <typename T, typename... Args>
 inline T const* TypeProvider::createAndGet(Args&& ... _args)
 {
-	instance().m_generalTypes.emplace_back(std::make_unique<T>(std::forward<Args>(_args)...));
-	return static_cast<T const*>(instance().m_generalTypes.back().get());
+	TypeProvider& provider = instance();
+	auto lock = TypeProvider::lock();
+	provider.m_generalTypes.emplace_back(std::make_unique<T>(std::forward<Args>(_args)...));
+	return static_cast<T const*>(provider.m_generalTypes.back().get());
 }
 
 Type const* TypeProvider::fromElementaryTypeName(ElementaryTypeNameToken const& _type)
@@ -1311,44 +247,56 @@ Type const* TypeProvider::fromElementaryTypeName(std::string const& _name)
 
 ArrayType const* TypeProvider::bytesStorage()
 {
-	if (!m_bytesStorage)
-		m_bytesStorage = std::make_unique<ArrayType>(false);
-	return m_bytesStorage.get();
+	auto lock = TypeProvider::lock();
+	auto& type = instance().m_bytesStorage;
+	if (!type)
+		type = std::make_unique<ArrayType>(false);
+	return type.get();
 }
 
 ArrayType const* TypeProvider::bytesMemory()
 {
-	if (!m_bytesMemory)
-		m_bytesMemory = std::make_unique<ArrayType>(false);
-	return m_bytesMemory.get();
+	auto lock = TypeProvider::lock();
+	auto& type = instance().m_bytesMemory;
+	if (!type)
+		type = std::make_unique<ArrayType>(false);
+	return type.get();
 }
 
 ArrayType const* TypeProvider::bytesCalldata()
 {
-	if (!m_bytesCalldata)
-		m_bytesCalldata = std::make_unique<ArrayType>(false);
-	return m_bytesCalldata.get();
+	auto lock = TypeProvider::lock();
+	auto& type = instance().m_bytesCalldata;
+	if (!type)
+		type = std::make_unique<ArrayType>(false);
+	return type.get();
 }
 
 ArrayType const* TypeProvider::stringStorage()
 {
-	if (!m_stringStorage)
-		m_stringStorage = std::make_unique<ArrayType>(true);
-	return m_stringStorage.get();
+	auto lock = TypeProvider::lock();
+	auto& type = instance().m_stringStorage;
+	if (!type)
+		type = std::make_unique<ArrayType>(true);
+	return type.get();
 }
 
 Variant const* TypeProvider::variant()
 {
-    if (!m_variant)
-        m_variant = std::make_unique<Variant>();
-    return m_variant.get();
+	auto lock = TypeProvider::lock();
+	auto& type = instance().m_variant;
+	if (!type)
+		type = std::make_unique<Variant>();
+	return type.get();
 }
 
 ArrayType const* TypeProvider::stringMemory()
 {
-	if (!m_stringMemory)
-		m_stringMemory = std::make_unique<ArrayType>(true);
-	return m_stringMemory.get();
+	auto lock = TypeProvider::lock();
+	auto& type = instance().m_stringMemory;
+	if (!type)
+		type = std::make_unique<ArrayType>(true);
+	return type.get();
 }
 
 Type const* TypeProvider::forLiteral(Literal const& _literal)
@@ -1396,6 +344,7 @@ RationalNumberType const* TypeProvider::rationalNumber(Literal const& _literal)
 
 StringLiteralType const* TypeProvider::stringLiteral(std::string const& literal)
 {
+	auto lock = TypeProvider::lock();
 	auto i = instance().m_stringLiteralTypes.find(literal);
 	if (i != instance().m_stringLiteralTypes.end())
 		return i->second.get();
@@ -1404,6 +353,7 @@ StringLiteralType const* TypeProvider::stringLiteral(std::string const& literal)
 }
 
 VarIntegerType const* TypeProvider::varinteger(unsigned m, IntegerType::Modifier _modifier) {
+	auto lock = TypeProvider::lock();
 	auto& map = instance().m_varinterger;
 	auto i = map.find(std::make_pair(m, _modifier));
 	if (i != map.end())
@@ -1422,6 +372,7 @@ VarIntegerType const* TypeProvider::coins() {
 
 FixedPointType const* TypeProvider::fixedPoint(unsigned m, unsigned n, FixedPointType::Modifier _modifier)
 {
+	auto lock = TypeProvider::lock();
 	auto& map = _modifier == FixedPointType::Modifier::Unsigned ? instance().m_ufixedMxN : instance().m_fixedMxN;
 
 	auto i = map.find(std::make_pair(m, n));
@@ -1437,7 +388,7 @@ FixedPointType const* TypeProvider::fixedPoint(unsigned m, unsigned n, FixedPoin
 TupleType const* TypeProvider::tuple(std::vector<Type const*> members)
 {
 	if (members.empty())
-		return &m_emptyTuple;
+		return &instance().m_emptyTuple;
 
 	return createAndGet<TupleType>(std::move(members));
 }
@@ -1567,7 +518,7 @@ ModifierType const* TypeProvider::modifier(ModifierDefinition const& _def)
 MagicType const* TypeProvider::magic(MagicType::Kind _kind)
 {
 	solAssert(_kind != MagicType::Kind::MetaType, "MetaType is handled separately");
-	return m_magics.at(static_cast<size_t>(_kind)).get();
+	return instance().m_magics.at(static_cast<size_t>(_kind)).get();
 }
 
 MagicType const* TypeProvider::meta(Type const* _type)
@@ -23,6 +23,7 @@
 #include <array>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <utility>
 
@@ -37,18 +38,35 @@ namespace solidity::frontend
  *
  * It is not recommended to explicitly instantiate types unless you really know what and why
  * you are doing it.
+ *
+ * Every compilation owns its TypeProvider instance (see CompilerStack). The static functions
+ * below work with the instance that is selected on the calling thread, so compilations running
+ * on different threads never share types. Threads of one compilation may select the same instance,
+ * creating types is synchronized.
  */
 class TypeProvider
 {
 public:
-	TypeProvider() = default;
-	TypeProvider(TypeProvider&&) = default;
+	TypeProvider();
+	TypeProvider(TypeProvider&&) = delete;
 	TypeProvider(TypeProvider const&) = delete;
-	TypeProvider& operator=(TypeProvider&&) = default;
+	TypeProvider& operator=(TypeProvider&&) = delete;
 	TypeProvider& operator=(TypeProvider const&) = delete;
-	~TypeProvider() = default;
+	~TypeProvider();
+
+	/// Selects the instance used by the static functions on the calling thread.
+	/// nullptr selects the default instance of the thread.
+	static void select(TypeProvider* _provider) noexcept { s_selected = _provider; }
+	/// @returns true if @a _provider is selected on the calling thread.
+	static bool isSelected(TypeProvider const* _provider) noexcept { return s_selected == _provider; }
+
+	/// Sets whether several threads use the selected instance. Must not be called while they do.
+	static void setConcurrent(bool _concurrent) noexcept { instance().m_concurrent = _concurrent; }
+	/// @returns a lock of the selected instance if several threads use it and an empty lock otherwise.
+	/// Guards the types that are created on demand and the lazily computed parts of all types.
+	static std::unique_lock<std::recursive_mutex> lock();
 
-	/// Resets state of this TypeProvider to initial state, wiping all mutable types.
+	/// Resets state of the selected TypeProvider to initial state, wiping all mutable types.
 	/// This invalidates all dangling pointers to types provided by this TypeProvider.
 	static void reset();
 
@@ -61,15 +79,15 @@ public:
 	static Type const* fromElementaryTypeName(std::string const& _name);
 
 	/// @returns boolean type.
-	static BoolType const* boolean() noexcept { return &m_boolean; }
-	static NullType const* nullType() noexcept { return &m_nullType; }
-	static EmptyMapType const* emptyMapType() noexcept { return &m_emptyMapType; }
-	static TvmCellType const* tvmcell() noexcept { return &m_tvmcell; }
-	static TvmSliceType const* tvmslice() noexcept { return &m_tvmslice; }
-	static TvmBuilderType const* tvmbuilder() noexcept { return &m_tvmbuilder; }
-	static StringBuilderType const* stringBuilder() noexcept { return &m_stringBuilder; }
+	static BoolType const* boolean() noexcept { return &instance().m_boolean; }
+	static NullType const* nullType() noexcept { return &instance().m_nullType; }
+	static EmptyMapType const* emptyMapType() noexcept { return &instance().m_emptyMapType; }
+	static TvmCellType const* tvmcell() noexcept { return &instance().m_tvmcell; }
+	static TvmSliceType const* tvmslice() noexcept { return &instance().m_tvmslice; }
+	static TvmBuilderType const* tvmbuilder() noexcept { return &instance().m_tvmbuilder; }
+	static StringBuilderType const* stringBuilder() noexcept { return &instance().m_stringBuilder; }
 	static FixedBytesType const* byte() { return fixedBytes(1); }
-	static FixedBytesType const* fixedBytes(unsigned m) { return m_bytesM.at(m - 1).get(); }
+	static FixedBytesType const* fixedBytes(unsigned m) { return instance().m_bytesM.at(m - 1).get(); }
 	static ArrayType const* bytesStorage();
 	static ArrayType const* bytesMemory();
 	static ArrayType const* bytesCalldata();
@@ -88,34 +106,34 @@ public:
 
 	static ArraySliceType const* arraySlice(ArrayType const& _arrayType);
 
-	static AddressType const* address() noexcept { return &m_address; }
-	static InitializerListType const* initializerList() noexcept { return &m_initializerList; }
-	static CallListType const* callList() noexcept { return &m_callList; }
+	static AddressType const* address() noexcept { return &instance().m_address; }
+	static InitializerListType const* initializerList() noexcept { return &instance().m_initializerList; }
+	static CallListType const* callList() noexcept { return &instance().m_callList; }
 
 	static IntegerType const* integer(unsigned _bits, IntegerType::Modifier _modifier)
 	{
 		if (_modifier == IntegerType::Modifier::Unsigned)
-			return m_uintM.at(_bits - 1).get();
+			return instance().m_uintM.at(_bits - 1).get();
 		else
-			return m_intM.at(_bits - 1).get();
+			return instance().m_intM.at(_bits - 1).get();
 	}
 
 	static NanType const* qIntegerNAN()
 	{
-		return m_qintNAN.get();
+		return instance().m_qintNAN.get();
 	}
 
 	static QIntegerType const* qInteger(unsigned _bits, IntegerType::Modifier _modifier)
 	{
 		if (_modifier == IntegerType::Modifier::Unsigned)
-			return m_quintM.at(_bits - 1).get();
+			return instance().m_quintM.at(_bits - 1).get();
 		else
-			return m_qintM.at(_bits - 1).get();
+			return instance().m_qintM.at(_bits - 1).get();
 	}
 
 	static QBoolType const* qBool()
 	{
-		return m_qbool.get();
+		return instance().m_qbool.get();
 	}
 
 	static IntegerType const* uint(unsigned _bits) { return integer(_bits, IntegerType::Modifier::Unsigned); }
@@ -138,7 +156,7 @@ public:
 	/// @returns a tuple type with the given members.
 	static TupleType const* tuple(std::vector<Type const*> members);
 
-	static TupleType const* emptyTuple() noexcept { return &m_emptyTuple; }
+	static TupleType const* emptyTuple() noexcept { return &instance().m_emptyTuple; }
 
 	/// @returns the internally-facing or externally-facing type of a function or the type of a function declaration.
 	static FunctionType const* function(FunctionDefinition const& _function, FunctionType::Kind _kind = FunctionType::Kind::Declaration);
@@ -186,7 +204,7 @@ public:
 
 	static ContractType const* contract(ContractDefinition const& _contract, bool _isSuper = false);
 
-	static InaccessibleDynamicType const* inaccessibleDynamic() noexcept { return &m_inaccessibleDynamic; }
+	static InaccessibleDynamicType const* inaccessibleDynamic() noexcept { return &instance().m_inaccessibleDynamic; }
 
 	/// @returns the type of an enum instance for given definition, there is one distinct type per enum definition.
 	static EnumType const* enumType(EnumDefinition const& _enum);
@@ -217,46 +235,52 @@ public:
 	static UserDefinedValueType const* userDefinedValueType(UserDefinedValueTypeDefinition const& _definition);
 
 private:
-	/// Global TypeProvider instance.
+	/// TypeProvider instance selected on the calling thread.
 	static TypeProvider& instance()
 	{
-		static TypeProvider _provider;
-		return _provider;
+		return s_selected ? *s_selected : defaultInstance();
 	}
+	static TypeProvider& defaultInstance();
 
 	template <typename T, typename... Args>
 	static inline T const* createAndGet(Args&& ... _args);
 
-	static BoolType const m_boolean;
-	static NullType const m_nullType;
-	static EmptyMapType const m_emptyMapType;
-	static TvmCellType const m_tvmcell;
-	static TvmSliceType const m_tvmslice;
-	static TvmBuilderType const m_tvmbuilder;
-	static StringBuilderType const m_stringBuilder;
+	static inline thread_local TypeProvider* s_selected = nullptr;
+
+	/// Recursive because computing a type or its members requests other types.
+	std::recursive_mutex m_mutex;
+	bool m_concurrent = false;
+
+	BoolType const m_boolean{};
+	NullType const m_nullType{};
+	EmptyMapType const m_emptyMapType{};
+	TvmCellType const m_tvmcell{};
+	TvmSliceType const m_tvmslice{};
+	TvmBuilderType const m_tvmbuilder{};
+	StringBuilderType const m_stringBuilder{};
 
-	static InaccessibleDynamicType const m_inaccessibleDynamic;
+	InaccessibleDynamicType const m_inaccessibleDynamic{};
 
 	/// These are lazy-initialized because they depend on `byte` being available.
-	static std::unique_ptr<ArrayType> m_bytesStorage;
-	static std::unique_ptr<ArrayType> m_bytesMemory;
-	static std::unique_ptr<ArrayType> m_bytesCalldata;
-	static std::unique_ptr<ArrayType> m_stringStorage;
-    static std::unique_ptr<Variant> m_variant;
-	static std::unique_ptr<ArrayType> m_stringMemory;
-
-	static TupleType const m_emptyTuple;
-	static AddressType const m_address;
-	static InitializerListType const m_initializerList;
-	static CallListType const m_callList;
-	static std::array<std::unique_ptr<IntegerType>, 257> const m_intM;
-	static std::array<std::unique_ptr<IntegerType>, 256> const m_uintM;
-	static std::unique_ptr<NanType> const m_qintNAN;
-	static std::array<std::unique_ptr<QIntegerType>, 257> const m_qintM;
-	static std::array<std::unique_ptr<QIntegerType>, 256> const m_quintM;
-	static std::unique_ptr<QBoolType> const m_qbool;
-	static std::array<std::unique_ptr<FixedBytesType>, 32> const m_bytesM;
-	static std::array<std::unique_ptr<MagicType>, 9> const m_magics;        ///< MagicType's except MetaType
+	std::unique_ptr<ArrayType> m_bytesStorage;
+	std::unique_ptr<ArrayType> m_bytesMemory;
+	std::unique_ptr<ArrayType> m_bytesCalldata;
+	std::unique_ptr<ArrayType> m_stringStorage;
+	std::unique_ptr<Variant> m_variant;
+	std::unique_ptr<ArrayType> m_stringMemory;
+
+	TupleType const m_emptyTuple{};
+	AddressType const m_address{};
+	InitializerListType const m_initializerList{};
+	CallListType const m_callList{};
+	std::array<std::unique_ptr<IntegerType>, 257> m_intM;
+	std::array<std::unique_ptr<IntegerType>, 256> m_uintM;
+	std::unique_ptr<NanType> const m_qintNAN;
+	std::array<std::unique_ptr<QIntegerType>, 257> m_qintM;
+	std::array<std::unique_ptr<QIntegerType>, 256> m_quintM;
+	std::unique_ptr<QBoolType> const m_qbool;
+	std::array<std::unique_ptr<FixedBytesType>, 32> m_bytesM;
+	std::array<std::unique_ptr<MagicType>, 9> m_magics;        ///< MagicType's except MetaType
 
 	std::map<std::pair<unsigned, IntegerType::Modifier>, std::unique_ptr<VarIntegerType>> m_varinterger{};
 	std::map<std::pair<unsigned, unsigned>, std::unique_ptr<FixedPointType>> m_ufixedMxN{};
@@ -150,8 +150,14 @@ BoolResult Type::isImplicitlyConvertibleTo(Type const& _other) const {
 	return false;
 }
 
+std::unique_lock<std::recursive_mutex> Type::cacheLock()
+{
+	return TypeProvider::lock();
+}
+
 void Type::clearCache() const
 {
+	auto lock = cacheLock();
 	m_members.clear();
 	m_stackItems.reset();
 	m_stackSize.reset();
@@ -344,6 +350,7 @@ Type const* Type::commonType(Type const* _a, Type const* _b)
 
 MemberList const& Type::members(ASTNode const* _currentScope) const
 {
+	auto lock = cacheLock();
 	if (!m_members[_currentScope])
 	{
 		solAssert(
@@ -2318,6 +2325,7 @@ TypeResult ArrayType::interfaceType(bool) const
 	else
 		result = TypeProvider::array(baseInterfaceType, m_length);
 
+	auto lock = cacheLock();
 	m_interfaceType = result;
 
 	return result;
@@ -2445,6 +2453,7 @@ MemberList::MemberMap ContractType::nativeMembers(ASTNode const*) const
 
 FunctionType const* ContractType::newExpressionType() const
 {
+	auto lock = cacheLock();
 	if (!m_constructorType)
 		m_constructorType = FunctionType::newExpressionType(m_contract);
 	return m_constructorType;
@@ -38,6 +38,7 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <set>
 #include <string>
@@ -312,6 +313,7 @@ public:
 	/// - Each named stack item is typed and contributes the stack slots given by the stack items of its type.
 	std::vector<std::tuple<std::string, Type const*>> const& stackItems() const
 	{
+		auto lock = cacheLock();
 		if (!m_stackItems)
 			m_stackItems = makeStackItems();
 		return *m_stackItems;
@@ -320,6 +322,7 @@ public:
 	// TODO: consider changing the return type to be size_t
 	unsigned sizeOnStack() const
 	{
+		auto lock = cacheLock();
 		if (!m_stackSize)
 		{
 			size_t sizeOnStack = 0;
@@ -426,6 +429,10 @@ protected:
 	}
 
 
+	/// @returns TypeProvider::lock(), which guards the lazy-initialized members below while several
+	/// threads of one compilation use the same types.
+	static std::unique_lock<std::recursive_mutex> cacheLock();
+
 	/// List of member types (parameterised by scape), will be lazy-initialized.
 	mutable std::map<ASTNode const*, std::unique_ptr<MemberList>> m_members;
 	mutable std::optional<std::vector<std::tuple<std::string, Type const*>>> m_stackItems;
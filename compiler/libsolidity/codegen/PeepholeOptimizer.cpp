@@ -16,11 +16,15 @@
 
 #include <boost/format.hpp>
 
+#include <sstream>
+#include <unordered_map>
+
 #include <libsolidity/ast/TypeProvider.h>
 
 #include <libsolidity/codegen/PeepholeOptimizer.hpp>
 #include <libsolidity/codegen/StackOpcodeSquasher.hpp>
 #include <libsolidity/codegen/TVM.hpp>
+#include <libsolidity/codegen/TVMCodeMetrics.hpp>
 #include <libsolidity/codegen/TVMConstants.hpp>
 #include <libsolidity/codegen/TVMPusher.hpp>
 #include <libsolidity/codegen/TvmAst.hpp>
@@ -30,57 +34,354 @@ using namespace solidity::util;
 
 namespace solidity::frontend {
 
+/// Identifiers of the rewrite rules. A rule that rewrites one pattern in several ways has one identifier.
+#define PEEPHOLE_RULES(R) \
+	R(SliceZeroesToStZeroes) \
+	R(SliceToInt) \
+	R(NeutralConstOp) \
+	R(AddConstToInc) \
+	R(AddConstToDec) \
+	R(MulConstToNegate) \
+	R(EmptyIfToDrop) \
+	R(EmptyIfJmpToIfRet) \
+	R(IfThrowToThrowIf) \
+	R(IfRetAltToIfRetAlt) \
+	R(CallRetAltToRetAlt) \
+	R(EqualBranchesToCall) \
+	R(IfElseCommonTail) \
+	R(EmptyElseToIf) \
+	R(EmptyThenToIfNot) \
+	R(IfElseToCondSel) \
+	R(WhileTrueToAgain) \
+	R(InlineCallX) \
+	R(PushContCallRefToPushRef) \
+	R(ZeroOrNullBranchToAlign) \
+	R(SwapToReverseOp) \
+	R(SwapCommutativeOp) \
+	R(PushIntOneToIncDec) \
+	R(PushIntToConstOp) \
+	R(DeadCodeAfterReturn) \
+	R(DupSwap) \
+	R(PopDropToBlkDrop2) \
+	R(SwapPopToBlkDrop2) \
+	R(PushDrop) \
+	R(BlkPushDrop) \
+	R(PushBlkDrop2) \
+	R(Gen01BlkDrop2) \
+	R(PushBlkDrop2Reorder) \
+	R(BlkPushBlkDrop2) \
+	R(DupBlkDrop2) \
+	R(NipDrop) \
+	R(NotCondition) \
+	R(EqIntZeroCondition) \
+	R(NeqIntZeroCondition) \
+	R(TrueCondition) \
+	R(BlkSwapBlkDrop2) \
+	R(BlkDrop2Drop) \
+	R(BlkSwapDrop) \
+	R(BlkSwapBlkSwap) \
+	R(TupleUntuple) \
+	R(UntupleTuple) \
+	R(SetGlobGetGlob) \
+	R(PushIntConstAdd) \
+	R(PushIntFits) \
+	R(ConstAddConstAdd) \
+	R(IndexIndexToIndex2) \
+	R(Index2IndexToIndex3) \
+	R(PushIntShift) \
+	R(PushIntPow2MulDiv) \
+	R(PushIntPow2Mod) \
+	R(PushIntPow2DecAnd) \
+	R(PushIntCompareToConst) \
+	R(BlkDrop2BlkDrop2) \
+	R(BlkSwapDropToBlkDrop2) \
+	R(NewcEndcToPushRef) \
+	R(CompareNot) \
+	R(NotNot) \
+	R(ConstBoolNot) \
+	R(FitsFits) \
+	R(BoolStIrToStSliceConst) \
+	R(ZeroStUrToStZeroes) \
+	R(AbsUfits256) \
+	R(OneStZeroesToStSliceConst) \
+	R(ReverseBlkSwap) \
+	R(ReverseDropToBlkDrop2) \
+	R(EndcStRefRToStBRefR) \
+	R(Gen01Xchg12) \
+	R(DupAndTrue) \
+	R(TrueAnd) \
+	R(NullIsNull) \
+	R(ConstTrueThrowIfNot) \
+	R(PushIntIsNull) \
+	R(ConstTrueThrowIf) \
+	R(PureUnaryDrop) \
+	R(AbsModPow2) \
+	R(ModPow2ModPow2) \
+	R(DupBlkPush) \
+	R(LoadDropToPreload) \
+	R(PldRefCtosToLdRefRtos) \
+	R(NewcStoreRToStore) \
+	R(DupThrowIfDrop) \
+	R(NewcStSliceConstEndcToPushRef) \
+	R(PushIntPushCompareToConst) \
+	R(FoldPushIntAddMulMax) \
+	R(FoldPushIntDiv) \
+	R(PushIntPushAddMulToConst) \
+	R(BoolNewcStIToStSliceConst) \
+	R(BlkSwapGen01BlkSwap) \
+	R(NullDupIsNull) \
+	R(Gen01BlkPushGen01) \
+	R(SwapGen01Rot) \
+	R(ConcatenateConstStrings) \
+	R(DupIfUpdateC4) \
+	R(FoldPushIntAddSub) \
+	R(PushSliceStSliceConst) \
+	R(ConstAddFitsConstAddFits) \
+	R(PushIntStSliceConstStore) \
+	R(PushSliceToCellToPushRef) \
+	R(ZeroStUrZeroStUr) \
+	R(PushSliceToCellStBRefRToPushRef) \
+	R(DupIsNullThrowIfUnsingle) \
+	R(PushSlicePushSliceConcat) \
+	R(PushIntPushSliceConcat) \
+	R(NullPushSliceStDict) \
+	R(PushSliceStSliceConstStB) \
+	R(TrailingRet) \
+	R(NullSwapIfNotJmpToAsym) \
+	R(SquashStores) \
+	R(SquashDrops) \
+	R(BlkSwapCycle) \
+	R(PopSequenceToBlkDrop2) \
+	R(ReversePopSequence) \
+	R(BlkSwapPopSequenceToBlkDrop2) \
+	R(RollSequenceToBlkSwapReverse) \
+	R(SquashStackOpcodes) \
+	R(SquashPurePermutation) \
+	R(UnsquashPush2) \
+	R(UnpackReturn) \
+	R(UnpackOpaque) \
+	R(SquashPushToBlkPush) \
+	R(SquashPushToPush3) \
+	R(SquashPushToPush2) \
+	R(SquashGen01ToBlkPush) \
+	R(SquashPushRefToBlkPush) \
+	R(SquashPushSwapToPuxc) \
+	R(SquashXchgPushToXcpu)
+
+enum class Rule {
+#define R(name) name,
+	PEEPHOLE_RULES(R)
+#undef R
+};
+
+char const* const ruleNames[] = {
+#define R(name) #name,
+	PEEPHOLE_RULES(R)
+#undef R
+};
+
+size_t constexpr ruleCount = sizeof(ruleNames) / sizeof(ruleNames[0]);
+
 struct Result {
 
+	Rule rule{};
 	int removeQty{};
 	vector<Pointer<TvmAstNode>> commands{};
 
 
 	template <class ...Args>
-	explicit Result(int remove,  Args... cmds) :
-		removeQty(remove), commands{cmds...}
+	explicit Result(Rule _rule, int remove,  Args... cmds) :
+		rule(_rule), removeQty(remove), commands{cmds...}
 	{
 	}
 
-	explicit Result(int remove, vector<Pointer<TvmAstNode>> commands = {}) :
-		removeQty(remove), commands{std::move(commands)}
+	explicit Result(Rule _rule, int remove, vector<Pointer<TvmAstNode>> commands = {}) :
+		rule(_rule), removeQty(remove), commands{std::move(commands)}
 	{
 	}
 };
 
+class PrivatePeepholeOptimizer;
+
+/// Kinds of instructions the rules are dispatched on.
+enum class OpKind {
+	Stack,
+	StackOpcode,
+	Glob,
+	PushCellOrSlice,
+	Opaque,
+	HardCode,
+	SubProgram,
+	IfElse,
+	CodeBlock,
+	While,
+	Return,
+	Exception,
+	Other
+};
+
+size_t constexpr opKindCount = size_t(OpKind::Other) + 1;
+size_t constexpr stackOpcodeCount = size_t(Stack::Opcode::PU2XC) + 1;
+
+/// Instruction a rule can start at: any instruction of a kind, a Stack with the opcode or a
+/// StackOpcode with the mnemonic.
+struct OpPattern {
+	OpPattern(OpKind _kind) : kind{_kind} {}
+	OpPattern(Stack::Opcode _opcode) : kind{OpKind::Stack}, stackOpcode{_opcode} {}
+	OpPattern(char const* _mnemonic) : kind{OpKind::StackOpcode}, mnemonic{_mnemonic} {}
+
+	OpKind kind{};
+	std::optional<Stack::Opcode> stackOpcode;
+	std::string mnemonic;
+};
+
+/// Instructions a rule looks at: the one at @a idx1 and the ones after it, `.loc` skipped.
+/// The instructions past the end of the block are null.
+struct Window {
+	int idx1{};
+	int idx2{};
+	Pointer<TvmAstNode> const& cmd1;
+	Pointer<TvmAstNode> const& cmd2;
+	Pointer<TvmAstNode> const& cmd3;
+	Pointer<TvmAstNode> const& cmd4;
+	Pointer<TvmAstNode> const& cmd5;
+	Pointer<TvmAstNode> const& cmd6;
+};
+
+/// Rewrite rule. The rule looks at @a window instructions, 0 means that it scans the block as far
+/// as it needs. It is only tried at the instructions that match one of @a first, or at every
+/// instruction if @a first is empty.
+struct PeepholeRule {
+	int window{};
+	std::vector<OpPattern> first;
+	std::optional<Result> (*match)(PrivatePeepholeOptimizer const&, Window const&){};
+};
+
+/// Rules of one window in the order they are tried: the rules of one instruction, the rules that
+/// scan the block, then the rules of two and more instructions.
+struct RuleGroup {
+	int window{};
+	char const* name{};
+};
+
+RuleGroup constexpr ruleGroups[] = {
+	{1, "window1"},
+	{0, "scan"},
+	{2, "window2"},
+	{3, "window3"},
+	{4, "window4"},
+	{5, "window5"},
+	{6, "window6"}
+};
+
+size_t constexpr ruleGroupCount = sizeof(ruleGroups) / sizeof(ruleGroups[0]);
+
+/**
+ * The rule table compiled into a dispatch table. Each instruction gets a tag: its kind, refined by
+ * the opcode of Stack and by the mnemonic of StackOpcode if a rule starts at it. For each tag and
+ * group the table keeps the rules that can start at such an instruction, in the order of the rule
+ * table, so the optimizer does not try the rules that cannot match.
+ */
+class RuleTable {
+public:
+	explicit RuleTable(std::vector<PeepholeRule> _rules);
+
+	int tag(TvmAstNode const& _node) const;
+	std::vector<PeepholeRule const*> const& candidates(int _tag, size_t _group) const {
+		return m_candidates.at(_tag * ruleGroupCount + _group);
+	}
+
+private:
+	static OpKind kind(TvmAstNode const& _node);
+
+	std::vector<PeepholeRule> m_rules;
+	/// Mnemonics the rules start at, the tag of a mnemonic is opKindCount + stackOpcodeCount + its index.
+	std::unordered_map<std::string, int> m_mnemonics;
+	std::vector<std::vector<PeepholeRule const*>> m_candidates;
+};
+
+/**
+ * The instructions of a block in a gap buffer. The gap stays where the last rewrite was, so a
+ * rewrite costs its size and the distance from the previous one instead of the length of the block.
+ * For each instruction the buffer also keeps how far the matcher read when it did not match there:
+ * such an instruction is not tried again until a rewrite replaces one of the instructions it read.
+ */
+class InstructionBuffer {
+public:
+	explicit InstructionBuffer(std::vector<Pointer<TvmAstNode>> const& _instructions);
+
+	int size() const { return static_cast<int>(m_slots.size() - (m_gapEnd - m_gapBegin)); }
+	Pointer<TvmAstNode> const& at(int _idx) const { return slot(_idx).node; }
+	/// @returns true if the matcher has to be tried at @a _idx.
+	bool dirty(int _idx) const { return slot(_idx).reach < 0; }
+	/// Records that the matcher does not match at @a _idx after reading the instructions up to @a _lastRead.
+	void setClean(int _idx, int _lastRead);
+	void setAllDirty();
+	/// Replaces the instructions from @a _begin to @a _end exclusive with @a _nodes. The new
+	/// instructions and the ones the matcher read the replaced instructions for become dirty.
+	void replace(int _begin, int _end, std::vector<Pointer<TvmAstNode>> const& _nodes);
+	std::vector<Pointer<TvmAstNode>> toVector() const;
+
+private:
+	struct Slot {
+		Pointer<TvmAstNode> node;
+		/// The distance to the last instruction the matcher read, -1 if the instruction is dirty.
+		int reach{-1};
+	};
+
+	Slot& slot(int _idx) { return m_slots[physical(_idx)]; }
+	Slot const& slot(int _idx) const { return m_slots[physical(_idx)]; }
+	size_t physical(int _idx) const;
+	void moveGap(size_t _pos);
+	void growGap(size_t _size);
+
+	std::vector<Slot> m_slots;
+	size_t m_gapBegin{};
+	size_t m_gapEnd{};
+	/// The largest reach recorded, a rewrite makes dirty at most so many instructions before it.
+	int m_maxReach{};
+};
+
 class PrivatePeepholeOptimizer {
 public:
-	explicit PrivatePeepholeOptimizer(std::vector<Pointer<TvmAstNode>> instructions, std::bitset<3> const _flags) :
-		m_instructions{std::move(instructions)},
-		m_flags{_flags}
+	explicit PrivatePeepholeOptimizer(
+		std::vector<Pointer<TvmAstNode>> const& instructions,
+		std::bitset<3> const _flags,
+		PeepholeStats* _stats = nullptr
+	) :
+		m_instructions{instructions},
+		m_flags{_flags},
+		m_stats{_stats}
 	{
 	}
-	vector<Pointer<TvmAstNode>> const &instructions() const { return m_instructions; }
+	std::vector<Pointer<TvmAstNode>> instructions() const { return m_instructions.toVector(); }
 
 	int nextCommandLine(int idx) const;
 	static int nextCommandLine(int idx, std::vector<Pointer<TvmAstNode>> const& instructions);
-	Pointer<TvmAstNode> get(int idx) const;
+	Pointer<TvmAstNode> const& get(int idx) const;
 	bool valid(int idx) const;
-	void remove(int idx);
-	void insert(int idx, const Pointer<TvmAstNode>& node);
 	std::optional<Result> optimizeAt(int idx1) const;
 	std::optional<Result> optimizeSlice(int idx1) const;
+	/// Tries the rules of one instruction at @a cmd1 alone.
 	std::optional<Result> optimizeAt1(Pointer<TvmAstNode> const& cmd1) const;
-	std::optional<Result> optimizeAt2(Pointer<TvmAstNode> const& cmd1, Pointer<TvmAstNode> const& cmd2) const;
-	std::optional<Result> optimizeAt3(Pointer<TvmAstNode> const& cmd1, Pointer<TvmAstNode> const& cmd2, Pointer<TvmAstNode> const& cmd3) const;
-	std::optional<Result> optimizeAt4(Pointer<TvmAstNode> const& cmd1, Pointer<TvmAstNode> const& cmd2, Pointer<TvmAstNode> const& cmd3,
-					   Pointer<TvmAstNode> const& cmd4) const;
-	std::optional<Result> optimizeAt5(Pointer<TvmAstNode> const& cmd1, Pointer<TvmAstNode> const& cmd2, Pointer<TvmAstNode> const& cmd3,
-					   Pointer<TvmAstNode> const& cmd4, Pointer<TvmAstNode> const& cmd5) const;
-	std::optional<Result> optimizeAt6(Pointer<TvmAstNode> const& cmd1, Pointer<TvmAstNode> const& cmd2, Pointer<TvmAstNode> const& cmd3,
-					   Pointer<TvmAstNode> const& cmd4, Pointer<TvmAstNode> const& cmd5, Pointer<TvmAstNode> const& cmd6) const;
-	std::optional<Result> optimizeAtInf(int idx1) const;
+	/// Tries the rules of group @a _group that can start at an instruction with tag @a _tag.
+	std::optional<Result> applyRules(size_t _group, int _tag, Window const& _window) const;
+	static RuleTable const& rules();
+	/// @returns the rewrite rules in the order they are tried.
+	static std::vector<PeepholeRule> ruleTable();
 	static bool hasRetOrJmp(TvmAstNode const* _node);
 
+	/// Runs the matcher @a _match and measures its time if the stats are collected.
+	template<class F>
+	std::optional<Result> match(char const* _matcher, F const& _match) const;
+	void countHit(int idx1, Result const& res) const;
 	void updateLinesAndIndex(int idx1, const std::optional<Result>& res);
 	std::optional<Result> unsquash(bool _withUnpackOpaque, int idx1) const;
 	std::optional<Result> squash(int idx1) const;
+	/// Applies @a f once at each instruction, @returns true if it rewrote something.
 	bool optimize(const std::function<std::optional<Result>(int)> &f);
+	/// Applies @a f until it does not rewrite anything, trying again only the dirty instructions.
+	void optimizeUntilFixpoint(const std::function<std::optional<Result>(int)> &f);
 
 	static std::optional<std::pair<int, int>> isBLKDROP2(Pointer<TvmAstNode>const& node);
 	static bigint pushintValue(Pointer<TvmAstNode> const& node);
@@ -100,15 +401,170 @@ public:
 	static int getAddNum(Pointer<TvmAstNode> const& node);
 	static bool isStack(Pointer<TvmAstNode> const& node, Stack::Opcode op);
 private:
-	std::vector<Pointer<TvmAstNode>> m_instructions{};
+	bool pass(const std::function<std::optional<Result>(int)> &f);
+	/// Records that the matcher read the instruction @a idx.
+	void read(int idx) const { m_lastRead = std::max(m_lastRead, idx); }
+
+	InstructionBuffer m_instructions;
 	std::bitset<3> const m_flags;
+	PeepholeStats* const m_stats{};
+	/// The last instruction read by the current matcher, reading past the end counts as reading the last one.
+	mutable int m_lastRead{};
 };
 
+namespace {
+
+/// @returns the estimated bits and gas of @a _nodes.
+std::pair<int, int> estimateCost(std::vector<Pointer<TvmAstNode>> const& _nodes) {
+	std::ostringstream out;
+	Printer printer{out};
+	for (Pointer<TvmAstNode> const& node : _nodes)
+		node->accept(printer);
+	int bits = 0;
+	int gas = 0;
+	std::istringstream lines{out.str()};
+	for (std::string line; std::getline(lines, line);) {
+		bits += TVMCodeMetrics::instructionBits(line);
+		gas += TVMCodeMetrics::instructionGas(line);
+	}
+	return {bits, gas};
+}
+
+void countHit(PeepholeStats& _stats, Result const& _res, std::vector<Pointer<TvmAstNode>> const& _removed) {
+	auto const [oldBits, oldGas] = estimateCost(_removed);
+	auto const [newBits, newGas] = estimateCost(_res.commands);
+	_stats.addHit(static_cast<std::size_t>(_res.rule), oldBits, oldGas, newBits, newGas);
+}
+
+}
+
+PeepholeStats::PeepholeStats() :
+	m_rules(ruleCount)
+{
+}
+
+void PeepholeStats::addHit(std::size_t _rule, int _oldBits, int _oldGas, int _newBits, int _newGas) {
+	RuleCounters& counters = m_rules.at(_rule);
+	++counters.hits;
+	counters.bitsSaved += _oldBits - _newBits;
+	counters.gasSaved += _oldGas - _newGas;
+}
+
+void PeepholeStats::addMatch(std::string const& _matcher, std::chrono::nanoseconds _time, bool _matched) {
+	MatcherCounters& counters = m_matchers[_matcher];
+	++counters.calls;
+	if (_matched)
+		++counters.matches;
+	counters.time += _time;
+}
+
+Json::Value PeepholeStats::toJson() const {
+	Json::Value rules{Json::objectValue};
+	for (size_t i = 0; i < ruleCount; ++i) {
+		Json::Value& rule = rules[ruleNames[i]];
+		rule["hits"] = Json::Int64{m_rules.at(i).hits};
+		rule["bitsSaved"] = Json::Int64{m_rules.at(i).bitsSaved};
+		rule["gasSaved"] = Json::Int64{m_rules.at(i).gasSaved};
+	}
+	Json::Value matchers{Json::objectValue};
+	for (auto const& [name, counters] : m_matchers) {
+		Json::Value& matcher = matchers[name];
+		matcher["calls"] = Json::Int64{counters.calls};
+		matcher["matches"] = Json::Int64{counters.matches};
+		matcher["timeUs"] = Json::Int64{std::chrono::duration_cast<std::chrono::microseconds>(counters.time).count()};
+	}
+	Json::Value result;
+	result["rules"] = rules;
+	result["matchers"] = matchers;
+	return result;
+}
+
+InstructionBuffer::InstructionBuffer(std::vector<Pointer<TvmAstNode>> const& _instructions) {
+	m_slots.reserve(_instructions.size());
+	for (Pointer<TvmAstNode> const& node : _instructions)
+		m_slots.push_back(Slot{node});
+	m_gapBegin = m_gapEnd = m_slots.size();
+}
+
+void InstructionBuffer::setClean(int _idx, int _lastRead) {
+	solAssert(_idx <= _lastRead, "");
+	slot(_idx).reach = _lastRead - _idx;
+	m_maxReach = std::max(m_maxReach, _lastRead - _idx);
+}
+
+void InstructionBuffer::setAllDirty() {
+	for (Slot& s : m_slots)
+		s.reach = -1;
+}
+
+void InstructionBuffer::replace(int _begin, int _end, std::vector<Pointer<TvmAstNode>> const& _nodes) {
+	solAssert(0 <= _begin && _begin <= _end && _end <= size(), "");
+	moveGap(_end);
+	for (int i = _begin; i < _end; ++i)
+		m_slots[i] = Slot{};
+	m_gapBegin = _begin;
+	if (m_gapEnd - m_gapBegin < _nodes.size())
+		growGap(_nodes.size());
+	for (Pointer<TvmAstNode> const& node : _nodes)
+		m_slots[m_gapBegin++] = Slot{node};
+	// the instructions before the gap are not moved
+	for (int i = _begin - 1; i >= 0 && _begin - i <= m_maxReach; --i) {
+		Slot& s = m_slots[i];
+		if (s.reach >= 0 && i + s.reach >= _begin)
+			s.reach = -1;
+	}
+}
+
+std::vector<Pointer<TvmAstNode>> InstructionBuffer::toVector() const {
+	std::vector<Pointer<TvmAstNode>> instructions;
+	instructions.reserve(size());
+	for (int i = 0; i < size(); ++i)
+		instructions.push_back(at(i));
+	return instructions;
+}
+
+size_t InstructionBuffer::physical(int _idx) const {
+	solAssert(0 <= _idx && _idx < size(), "");
+	size_t const idx = _idx;
+	return idx < m_gapBegin ? idx : idx + (m_gapEnd - m_gapBegin);
+}
+
+void InstructionBuffer::moveGap(size_t _pos) {
+	if (_pos < m_gapBegin) {
+		size_t const n = m_gapBegin - _pos;
+		std::move_backward(m_slots.begin() + _pos, m_slots.begin() + m_gapBegin, m_slots.begin() + m_gapEnd);
+		m_gapBegin -= n;
+		m_gapEnd -= n;
+	} else if (_pos > m_gapBegin) {
+		size_t const n = _pos - m_gapBegin;
+		std::move(m_slots.begin() + m_gapEnd, m_slots.begin() + m_gapEnd + n, m_slots.begin() + m_gapBegin);
+		m_gapBegin += n;
+		m_gapEnd += n;
+	}
+}
+
+void InstructionBuffer::growGap(size_t _size) {
+	size_t const gap = std::max(_size, m_slots.size() / 2 + 16);
+	std::vector<Slot> slots(m_slots.size() - (m_gapEnd - m_gapBegin) + gap);
+	std::move(m_slots.begin(), m_slots.begin() + m_gapBegin, slots.begin());
+	std::move(m_slots.begin() + m_gapEnd, m_slots.end(), slots.begin() + m_gapBegin + gap);
+	m_slots = std::move(slots);
+	m_gapEnd = m_gapBegin + gap;
+}
+
 int PrivatePeepholeOptimizer::nextCommandLine(int idx) const {
 	if (idx == -1) {
 		return -1;
 	}
-	return nextCommandLine(idx + 1, m_instructions);
+	int const n = m_instructions.size();
+	for (++idx; idx < n; ++idx) {
+		if (!isLoc(m_instructions.at(idx))) {
+			read(idx);
+			return idx;
+		}
+	}
+	read(n - 1);
+	return -1;
 }
 
 int PrivatePeepholeOptimizer::nextCommandLine(int idx, std::vector<Pointer<TvmAstNode>> const& instructions) {
@@ -124,20 +580,15 @@ int PrivatePeepholeOptimizer::nextCommandLine(int idx, std::vector<Pointer<TvmAs
 	return -1;
 }
 
-Pointer<TvmAstNode> PrivatePeepholeOptimizer::get(int idx) const {
-	return valid(idx) ? m_instructions.at(idx) : nullptr;
+Pointer<TvmAstNode> const& PrivatePeepholeOptimizer::get(int idx) const {
+	static Pointer<TvmAstNode> const none;
+	return valid(idx) ? m_instructions.at(idx) : none;
 }
 
 bool PrivatePeepholeOptimizer::valid(int idx) const {
-	return idx >= 0 && size_t(idx) < m_instructions.size();
-}
-
-void PrivatePeepholeOptimizer::remove(int idx) {
-	m_instructions.erase(m_instructions.begin() + idx);
-}
-
-void PrivatePeepholeOptimizer::insert(int idx, const Pointer<TvmAstNode>& node) {
-	m_instructions.insert(m_instructions.begin() + idx, node);
+	bool const inside = idx >= 0 && idx < m_instructions.size();
+	read(inside ? idx : m_instructions.size() - 1);
+	return inside;
 }
 
 std::optional<Result> PrivatePeepholeOptimizer::optimizeSlice(int idx1) const {
@@ -167,9 +618,9 @@ std::optional<Result> PrivatePeepholeOptimizer::optimizeSlice(int idx1) const {
 		// STZEROES
 		if (all_of(binStr.begin(), binStr.end(), [](char ch) { return ch == '0'; })) {
 			if (firstCase)
-				return Result{2, gen("PUSHINT " + toString(sliceBits)), gen("STZEROES")};
+				return Result{Rule::SliceZeroesToStZeroes, 2, gen("PUSHINT " + toString(sliceBits)), gen("STZEROES")};
 			else
-				return Result{3, gen("NEWC"), gen("PUSHINT " + toString(sliceBits)), gen("STZEROES")};
+				return Result{Rule::SliceZeroesToStZeroes, 3, gen("NEWC"), gen("PUSHINT " + toString(sliceBits)), gen("STZEROES")};
 		}
 
 		std::optional<bigint> negNum = StrUtils::toNegBigint(binStr);
@@ -183,23 +634,23 @@ std::optional<Result> PrivatePeepholeOptimizer::optimizeSlice(int idx1) const {
 				if (numLength < negNumLength)
 					// PUSHINT N
 					// STUR sliceBits
-					return Result{2, gen("PUSHINT " + toString(num)), gen("STUR " + toString(sliceBits))};
+					return Result{Rule::SliceToInt, 2, gen("PUSHINT " + toString(num)), gen("STUR " + toString(sliceBits))};
 				else
 					// PUSHINT N
 					// STIR sliceBits
-					return Result{2, gen("PUSHINT " + toString(*negNum)), gen("STIR " + toString(sliceBits))};
+					return Result{Rule::SliceToInt, 2, gen("PUSHINT " + toString(*negNum)), gen("STIR " + toString(sliceBits))};
 			}
 			else {
 				if (numLength < negNumLength)
 					// PUSHINT N
 					// NEWC
 					// STU sliceBits
-					return Result{3, gen("PUSHINT " + toString(num)), gen("NEWC"), gen("STU " + toString(sliceBits))};
+					return Result{Rule::SliceToInt, 3, gen("PUSHINT " + toString(num)), gen("NEWC"), gen("STU " + toString(sliceBits))};
 				else {
 					// PUSHINT N
 					// NEWC
 					// STI sliceBits
-					return Result{3, gen("PUSHINT " + toString(*negNum)), gen("NEWC"), gen("STI " + toString(sliceBits))};
+					return Result{Rule::SliceToInt, 3, gen("PUSHINT " + toString(*negNum)), gen("NEWC"), gen("STI " + toString(sliceBits))};
 				}
 			}
 		}
@@ -208,9 +659,74 @@ std::optional<Result> PrivatePeepholeOptimizer::optimizeSlice(int idx1) const {
 	return {};
 }
 
-std::optional<Result> PrivatePeepholeOptimizer::optimizeAt(const int idx1) const {
-	std::optional<Result> res;
+RuleTable::RuleTable(std::vector<PeepholeRule> _rules) :
+	m_rules{std::move(_rules)}
+{
+	for (PeepholeRule const& rule : m_rules)
+		for (OpPattern const& pattern : rule.first)
+			if (!pattern.mnemonic.empty())
+				m_mnemonics.emplace(pattern.mnemonic, opKindCount + stackOpcodeCount + m_mnemonics.size());
+
+	size_t const tagCount = opKindCount + stackOpcodeCount + m_mnemonics.size();
+	std::vector<OpPattern> tags;
+	tags.reserve(tagCount);
+	for (size_t kind = 0; kind < opKindCount; ++kind)
+		tags.emplace_back(OpKind(kind));
+	for (size_t opcode = 0; opcode < stackOpcodeCount; ++opcode)
+		tags.emplace_back(Stack::Opcode(opcode));
+	tags.resize(tagCount, OpKind::StackOpcode);
+	for (auto const& [mnemonic, tag] : m_mnemonics)
+		tags.at(tag).mnemonic = mnemonic;
+
+	auto matches = [](OpPattern const& _pattern, OpPattern const& _tag) {
+		return _pattern.kind == _tag.kind &&
+			(!_pattern.stackOpcode || _pattern.stackOpcode == _tag.stackOpcode) &&
+			(_pattern.mnemonic.empty() || _pattern.mnemonic == _tag.mnemonic);
+	};
+	m_candidates.resize(tagCount * ruleGroupCount);
+	for (size_t tag = 0; tag < tagCount; ++tag)
+		for (size_t group = 0; group < ruleGroupCount; ++group)
+			for (PeepholeRule const& rule : m_rules)
+				if (
+					rule.window == ruleGroups[group].window &&
+					(rule.first.empty() || std::any_of(rule.first.begin(), rule.first.end(), [&](OpPattern const& _pattern) {
+						return matches(_pattern, tags.at(tag));
+					}))
+				)
+					m_candidates.at(tag * ruleGroupCount + group).push_back(&rule);
+}
+
+int RuleTable::tag(TvmAstNode const& _node) const {
+	OpKind const opKind = kind(_node);
+	if (opKind == OpKind::Stack)
+		return opKindCount + int(cast<Stack>(_node).opcode());
+	if (opKind == OpKind::StackOpcode) {
+		auto it = m_mnemonics.find(cast<StackOpcode>(_node).opcode());
+		if (it != m_mnemonics.end())
+			return it->second;
+	}
+	return int(opKind);
+}
 
+OpKind RuleTable::kind(TvmAstNode const& _node) {
+	switch (_node.kind()) {
+		case TvmAstNode::Kind::Stack: return OpKind::Stack;
+		case TvmAstNode::Kind::StackOpcode: return OpKind::StackOpcode;
+		case TvmAstNode::Kind::Glob: return OpKind::Glob;
+		case TvmAstNode::Kind::PushCellOrSlice: return OpKind::PushCellOrSlice;
+		case TvmAstNode::Kind::Opaque: return OpKind::Opaque;
+		case TvmAstNode::Kind::HardCode: return OpKind::HardCode;
+		case TvmAstNode::Kind::SubProgram: return OpKind::SubProgram;
+		case TvmAstNode::Kind::TvmIfElse: return OpKind::IfElse;
+		case TvmAstNode::Kind::CodeBlock: return OpKind::CodeBlock;
+		case TvmAstNode::Kind::While: return OpKind::While;
+		case TvmAstNode::Kind::TvmReturn: return OpKind::Return;
+		case TvmAstNode::Kind::TvmException: return OpKind::Exception;
+		default: return OpKind::Other;
+	}
+}
+
+std::optional<Result> PrivatePeepholeOptimizer::optimizeAt(const int idx1) const {
 	int idx2 = nextCommandLine(idx1);
 	int idx3 = nextCommandLine(idx2);
 	int idx4 = nextCommandLine(idx3);
@@ -223,1994 +739,2391 @@ std::optional<Result> PrivatePeepholeOptimizer::optimizeAt(const int idx1) const
 	Pointer<TvmAstNode> const &cmd4 = get(idx4);
 	Pointer<TvmAstNode> const &cmd5 = get(idx5);
 	Pointer<TvmAstNode> const &cmd6 = get(idx6);
+	Pointer<TvmAstNode> const* const cmds[] = {&cmd1, &cmd2, &cmd3, &cmd4, &cmd5, &cmd6};
 
-	res = optimizeAt1(cmd1);
-	if (res) return res;
-
-	res = optimizeAtInf(idx1);
-	if (res) return res;
-
-	if (!cmd2) return {};
-	res = optimizeAt2(cmd1, cmd2);
-	if (res) return res;
-
-	if (!cmd3) return {};
-	res = optimizeAt3(cmd1, cmd2, cmd3);
-	if (res) return res;
-
-	if (!cmd4) return {};
-	res = optimizeAt4(cmd1, cmd2, cmd3, cmd4);
-	if (res) return res;
-
-	if (!cmd5) return {};
-	res = optimizeAt5(cmd1, cmd2, cmd3, cmd4, cmd5);
-	if (res) return res;
-
-	if (!cmd6) return {};
-	res = optimizeAt6(cmd1, cmd2, cmd3, cmd4, cmd5, cmd6);
-	if (res) return res;
-
+	Window const window{idx1, idx2, cmd1, cmd2, cmd3, cmd4, cmd5, cmd6};
+	int const tag = rules().tag(*cmd1);
+	for (size_t group = 0; group < ruleGroupCount; ++group) {
+		if (ruleGroups[group].window >= 2 && !*cmds[ruleGroups[group].window - 1])
+			return {};
+		if (std::optional<Result> res = applyRules(group, tag, window))
+			return res;
+	}
 	return {};
 }
 
 std::optional<Result> PrivatePeepholeOptimizer::optimizeAt1(Pointer<TvmAstNode> const& cmd1) const {
-	auto cmd1CodeBlock = to<CodeBlock>(cmd1.get());
-	auto cmd1GenOpcode = to<StackOpcode>(cmd1.get());
-	auto cmd1IfElse = to<TvmIfElse>(cmd1.get());
-	auto cmd1Sub = to<SubProgram>(cmd1.get());
+	Pointer<TvmAstNode> const none;
+	Window const window{0, -1, cmd1, none, none, none, none, none};
+	return applyRules(0, rules().tag(*cmd1), window);
+}
 
-	if (cmd1GenOpcode && isIn(cmd1GenOpcode->fullOpcode(), "ADDCONST 0", "MULCONST 1")) {
-		return Result{1};
-	}
-	if (cmd1GenOpcode && cmd1GenOpcode->fullOpcode() == "ADDCONST 1") {
-		return Result{1, gen("INC")};
-	}
-	if (cmd1GenOpcode && cmd1GenOpcode->fullOpcode() == "ADDCONST -1") {
-		return Result{1, gen("DEC")};
-	}
-	if (cmd1GenOpcode && cmd1GenOpcode->fullOpcode() == "MULCONST -1") {
-		return Result{1, gen("NEGATE")};
-	}
-	// PUSHCONT {} IF/IFNOT => DROP
-	if (
-		cmd1IfElse && qtyWithoutLoc(cmd1IfElse->trueBody()->instructions()) == 0 &&
-		cmd1IfElse->falseBody() == nullptr && !cmd1IfElse->withJmp()
-	) {
-		return Result{1, makeDROP()};
-	}
-	// PUSHCONT {} IFJMP => IFRET
-	// PUSHCONT {} IFNOTJMP => IFNOTRET
-	if (cmd1IfElse && qtyWithoutLoc(cmd1IfElse->trueBody()->instructions()) == 0 && cmd1IfElse->falseBody() == nullptr && cmd1IfElse->withJmp()) {
-		if (cmd1IfElse->withNot())
-			return Result{1, makeIFNOTRET()};
-		return Result{1, makeIFRET()};
-	}
-	// PUSHCONT { THROW N } IF/IFJMP => THROWIF
-	// PUSHCONT { THROW N } IFNOT/IFNOTJMP => THROWIFNOT
-	if (cmd1IfElse && cmd1IfElse->falseBody() == nullptr) {
-		std::vector<Pointer<TvmAstNode>> const& inst = cmd1IfElse->trueBody()->instructions();
-		if (qtyWithoutLoc(inst) == 1) {
-			Pointer<TvmAstNode> pos;
-			for (const auto& x : inst) if (!to<Loc>(x.get())) pos = x;
-			auto _throw = to<TvmException>(pos.get());
-			if (_throw && _throw->opcode() == "THROW") {
-				if (cmd1IfElse->withNot())
-					return Result{1, makeTHROW("THROWIFNOT " + _throw->arg())};
-				return Result{1, makeTHROW("THROWIF " + _throw->arg())};
-			}
-		}
-	}
+std::optional<Result> PrivatePeepholeOptimizer::applyRules(size_t _group, int _tag, Window const& _window) const {
+	std::vector<PeepholeRule const*> const& candidates = rules().candidates(_tag, _group);
+	if (candidates.empty())
+		return {};
+	return match(ruleGroups[_group].name, [&]() -> std::optional<Result> {
+		for (PeepholeRule const* rule : candidates)
+			if (std::optional<Result> res = rule->match(*this, _window))
+				return res;
+		return {};
+	});
+}
 
-	// PUSH[REF]CONT { RETALT } IF[NOT][JMP] => IFRETALT
-	if (cmd1IfElse && cmd1IfElse->falseBody() == nullptr) {
-		std::vector<Pointer<TvmAstNode>> const& inst = cmd1IfElse->trueBody()->instructions();
-		if (qtyWithoutLoc(inst) == 1) {
-			Pointer<TvmAstNode> pos;
-			for (const auto& x : inst) if (!to<Loc>(x.get())) pos = x;
-			auto ret = to<TvmReturn>(pos.get());
-			if (ret && !ret->withIf() && ret->withAlt()) {
-				if (cmd1IfElse->withNot())
-					return Result{1, makeIFNOTRETALT()};
-				return Result{1, makeIFRETALT()};
-			}
-		}
-	}
+RuleTable const& PrivatePeepholeOptimizer::rules() {
+	static RuleTable const table{ruleTable()};
+	return table;
+}
 
-	// PUSH[REF]CONT { RETALT } JMP/CALLX => RETALT
-	if (cmd1Sub) {
-		std::vector<Pointer<TvmAstNode>> const& inst = cmd1Sub->block()->instructions();
-		if (qtyWithoutLoc(inst) == 1) {
-			Pointer<TvmAstNode> pos;
-			for (const auto& x : inst) if (!to<Loc>(x.get())) pos = x;
-			auto ret = to<TvmReturn>(pos.get());
-			if (ret && !ret->withIf() && ret->withAlt()) {
-				return Result{1, makeRETALT()};
+std::vector<PeepholeRule> PrivatePeepholeOptimizer::ruleTable() {
+	using namespace MathConsts;
+	std::vector<OpPattern> const pushes{Stack::Opcode::PUSH_S, Stack::Opcode::BLKPUSH};
+	std::vector<OpPattern> const pops{Stack::Opcode::POP_S, Stack::Opcode::BLKDROP2};
+	std::vector<OpPattern> const swaps{Stack::Opcode::BLKSWAP, Stack::Opcode::XCHG, Stack::Opcode::REVERSE};
+	std::vector<OpPattern> const gens{
+		OpKind::StackOpcode, OpKind::Glob, OpKind::PushCellOrSlice, OpKind::Opaque, OpKind::HardCode,
+		OpKind::SubProgram, OpKind::IfElse
+	};
+	std::vector<OpPattern> gensAndPush = gens;
+	gensAndPush.emplace_back(Stack::Opcode::PUSH_S);
+	std::vector<OpPattern> gensAndPushes = gens;
+	gensAndPushes.insert(gensAndPushes.end(), pushes.begin(), pushes.end());
+
+	return {
+		{1, {"ADDCONST", "MULCONST"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd1GenOpcode = dyn_cast<StackOpcode>(w.cmd1.get());
+			if (cmd1GenOpcode && isIn(cmd1GenOpcode->fullOpcode(), "ADDCONST 0", "MULCONST 1")) {
+				return Result{Rule::NeutralConstOp, 1};
 			}
-		}
-	}
+			return {};
+		}},
 
-	// PUSHCONT {
-	//  LDU 256
-	//	ENDS
-	// }
-	// PUSHCONT {
-	//	LDU 256
-	//	ENDS
-	// }
-	// IFELSE
-	// =>
-	// DROP
-	// PUSHCONT {
-	//	LDU 256
-	//	ENDS
-	// }
-	// CALLX
-	if (cmd1IfElse && cmd1IfElse->falseBody() != nullptr) {
-		std::vector<Pointer<TvmAstNode>> const& t = cmd1IfElse->trueBody()->instructions();
-		std::vector<Pointer<TvmAstNode>> const& f = cmd1IfElse->falseBody()->instructions();
-		if (t.size() == f.size()) {
-			bool eq = true;
-			int n = f.size();
-			for (int i = 0; i < n; ++i) {
-				eq &= *t.at(i) == *f.at(i);
-			}
-			if (eq) {
-				auto subProg = createNode<SubProgram>(0, 0, false, cmd1IfElse->trueBody(), false);
-				return Result{1, makeDROP(), subProg};
+		{1, {"ADDCONST"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd1GenOpcode = dyn_cast<StackOpcode>(w.cmd1.get());
+			if (cmd1GenOpcode && cmd1GenOpcode->fullOpcode() == "ADDCONST 1") {
+				return Result{Rule::AddConstToInc, 1, gen("INC")};
 			}
-		}
-	}
-
-	// PUSHCONT {
-	//   ...
-	//   Z
-	// }
-	// PUSHCONT {
-	//   ...
-	//   Z
-	// }
-	// IFELSE
-	// =>
-	// PUSHCONT {
-	//   ...
-	// }
-	// PUSHCONT {
-	//   ...
-	// }
-	// IFELSE
-	// Z
-	if (m_flags.test(OptFlags::UnpackOpaque) && cmd1IfElse && cmd1IfElse->falseBody() != nullptr && cmd1IfElse->ret() == 0) {
-		std::vector<Pointer<TvmAstNode>> const& t = cmd1IfElse->trueBody()->instructions();
-		std::vector<Pointer<TvmAstNode>> const& f = cmd1IfElse->falseBody()->instructions();
-		if (!t.empty() &&
-			!f.empty() &&
-			*t.back() == *f.back() &&
-			!cmd1IfElse->withJmp() &&
-			cmd1IfElse->trueBody()->type() == CodeBlock::Type::PUSHCONT &&
-			cmd1IfElse->falseBody()->type() == CodeBlock::Type::PUSHCONT &&
-			!hasRetOrJmp(cmd1IfElse->trueBody().get()) &&
-			!hasRetOrJmp(cmd1IfElse->falseBody().get())
-		) {
-			auto tt = createNode<CodeBlock>(CodeBlock::Type::PUSHCONT, std::vector<Pointer<TvmAstNode>>(t.begin(), t.end() - 1));
-			auto ff = createNode<CodeBlock>(CodeBlock::Type::PUSHCONT, std::vector<Pointer<TvmAstNode>>(f.begin(), f.end() - 1));
-			auto ifElse2 = createNode<TvmIfElse>(cmd1IfElse->withNot(), false, tt, ff, 0);
-			return Result{1, ifElse2, t.back()};
-		}
-	}
-
-	// PUSHCONT {
-	//   ...
-	// }
-	// PUSHCONT {
-	// }
-	// IFELSE
-	// =>
-	// PUSHCONT {
-	//   ...
-	// }
-	// IF
-	if (cmd1IfElse && cmd1IfElse->falseBody() != nullptr) {
-		std::vector<Pointer<TvmAstNode>> const& f = cmd1IfElse->falseBody()->instructions();
-		if (qtyWithoutLoc(f) == 0 &&
-			!cmd1IfElse->withJmp()
-		) {
-			auto ifElse2 = createNode<TvmIfElse>(cmd1IfElse->withNot(), false, cmd1IfElse->trueBody(), nullptr, 0);
-			return Result{1, ifElse2};
-		}
-	}
+			return {};
+		}},
 
-	// PUSHCONT {
-	// }
-	// PUSHCONT {
-	//    ...
-	// }
-	// IFELSE
-	// =>
-	// PUSHCONT {
-	//   ...
-	// }
-	// IFNOT
-	if (cmd1IfElse && cmd1IfElse->falseBody() != nullptr) {
-		std::vector<Pointer<TvmAstNode>> const& t = cmd1IfElse->trueBody()->instructions();
-		if (qtyWithoutLoc(t) == 0 &&
-			!cmd1IfElse->withJmp()
-		) {
-			auto ifElse2 = createNode<TvmIfElse>(!cmd1IfElse->withNot(), false, cmd1IfElse->falseBody(), nullptr, 0);
-			return Result{1, ifElse2};
-		}
-	}
+		{1, {"ADDCONST"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd1GenOpcode = dyn_cast<StackOpcode>(w.cmd1.get());
+			if (cmd1GenOpcode && cmd1GenOpcode->fullOpcode() == "ADDCONST -1") {
+				return Result{Rule::AddConstToDec, 1, gen("DEC")};
+			}
+			return {};
+		}},
 
-	// PUSHCONT { a }
-	// PUSHCONT { b }
-	// IFELSE
-	// =>
-	// newA
-	// newB
-	// CONDSEL
-	if (cmd1IfElse && cmd1IfElse->falseBody() != nullptr) {
-		std::vector<Pointer<TvmAstNode>> const& t = cmd1IfElse->trueBody()->instructions();
-		std::vector<Pointer<TvmAstNode>> const& f = cmd1IfElse->falseBody()->instructions();
-		if (qtyWithoutLoc(t) == 1 && qtyWithoutLoc(f) == 1) {
-			int ti = nextCommandLine(0, t);
-			int fi = nextCommandLine(0, f);
-			Pointer<TvmAstNode> a = t.at(ti);
-			Pointer<TvmAstNode> b = f.at(fi);
-			if ((isPureGen01(*a) && to<StackOpcode>(a.get())) ||
-				to<Glob>(a.get()) ||
-				to<PushCellOrSlice>(a.get()) ||
-				isPUSH(a)
+		{1, {"MULCONST"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd1GenOpcode = dyn_cast<StackOpcode>(w.cmd1.get());
+			if (cmd1GenOpcode && cmd1GenOpcode->fullOpcode() == "MULCONST -1") {
+				return Result{Rule::MulConstToNegate, 1, gen("NEGATE")};
+			}
+			return {};
+		}},
+
+		// PUSHCONT {} IF/IFNOT => DROP
+		{1, {OpKind::IfElse}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd1IfElse = dyn_cast<TvmIfElse>(w.cmd1.get());
+			if (
+				cmd1IfElse && qtyWithoutLoc(cmd1IfElse->trueBody()->instructions()) == 0 &&
+				cmd1IfElse->falseBody() == nullptr && !cmd1IfElse->withJmp()
 			) {
-				Pointer<TvmAstNode> newA = a;
-				if (auto index = isPUSH(a))
-					newA = makePUSH(*index + 1); // +1 because condition flag
-
-				Pointer<TvmAstNode> newB;
-				if (to<StackOpcode>(b.get()) ||
-					to<Glob>(b.get()) ||
-					to<PushCellOrSlice>(b.get())
-				)
-					newB = b;
-				else if (auto index = isPUSH(b))
-					newB = makePUSH(*index + 2); // +2 because condition flag and value from first branch
-
-				if (newB)
-					return Result{1, newA, newB, gen("CONDSEL")};
+				return Result{Rule::EmptyIfToDrop, 1, makeDROP()};
 			}
-		}
-	}
-
-	// PUSHCONT { TRUE }
-	// PUSHCONT { ... }
-	// WHILE
-	// =>
-	// PUSHCONT { ... }
-	// AGAIN
-	if (auto _while = to<While>(cmd1.get())) {
-		std::vector<Pointer<TvmAstNode>> const& instr = _while->condition()->instructions();
-		if (instr.size() == 1 && is(instr.at(0), "TRUE") && !_while->isInfinite()) {
-			return Result{1, createNode<While>(true, _while->withBreakOrReturn(), _while->condition(), _while->body())};
-		}
-	}
-
-	// PUSHCONT { here }
-	// CALLX
-	// =>
-	// here
-	if (cmd1Sub && !cmd1Sub->isJmp() && cmd1Sub->block()->type() == CodeBlock::Type::PUSHCONT) {
-		bool ok = true;
-		for (Pointer<TvmAstNode> const& cmd : cmd1Sub->block()->instructions()) {
-			if (hasRetOrJmp(cmd.get())) {
-				ok = false;
+			return {};
+		}},
+
+		// PUSHCONT {} IFJMP => IFRET
+		// PUSHCONT {} IFNOTJMP => IFNOTRET
+		{1, {OpKind::IfElse}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd1IfElse = dyn_cast<TvmIfElse>(w.cmd1.get());
+			if (cmd1IfElse && qtyWithoutLoc(cmd1IfElse->trueBody()->instructions()) == 0 && cmd1IfElse->falseBody() == nullptr && cmd1IfElse->withJmp()) {
+				if (cmd1IfElse->withNot())
+					return Result{Rule::EmptyIfJmpToIfRet, 1, makeIFNOTRET()};
+				return Result{Rule::EmptyIfJmpToIfRet, 1, makeIFRET()};
 			}
-		}
-		if (ok) {
-			return Result{1, cmd1Sub->block()->instructions()};
-		}
-	}
-
-	// PUSHCONT {
-	//    CALLREF {
-	//       code
-	//    }
-	// }
-	// =>
-	// PUSHREF {
-	//    code
-	// }
-	if (cmd1CodeBlock && cmd1CodeBlock->type() == CodeBlock::Type::PUSHCONT) {
-		std::vector<Pointer<TvmAstNode>> const&  opcodes = cmd1CodeBlock->instructions();
-		if (qtyWithoutLoc(opcodes) == 1) {
-			int index = nextCommandLine(0, opcodes);
-			TvmAstNode const* opcode = opcodes.at(index).get();
-			if (auto sub = to<SubProgram>(opcode)) {
-				return Result{1, createNode<CodeBlock>(sub->block()->type(), sub->block()->instructions())};
+			return {};
+		}},
+
+		// PUSHCONT { THROW N } IF/IFJMP => THROWIF
+		// PUSHCONT { THROW N } IFNOT/IFNOTJMP => THROWIFNOT
+		{1, {OpKind::IfElse}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd1IfElse = dyn_cast<TvmIfElse>(w.cmd1.get());
+			if (cmd1IfElse && cmd1IfElse->falseBody() == nullptr) {
+				std::vector<Pointer<TvmAstNode>> const& inst = cmd1IfElse->trueBody()->instructions();
+				if (qtyWithoutLoc(inst) == 1) {
+					Pointer<TvmAstNode> pos;
+					for (const auto& x : inst) if (!isa<Loc>(x.get())) pos = x;
+					auto _throw = dyn_cast<TvmException>(pos.get());
+					if (_throw && _throw->opcode() == "THROW") {
+						if (cmd1IfElse->withNot())
+							return Result{Rule::IfThrowToThrowIf, 1, makeTHROW("THROWIFNOT " + _throw->arg())};
+						return Result{Rule::IfThrowToThrowIf, 1, makeTHROW("THROWIF " + _throw->arg())};
+					}
+				}
 			}
-		}
-	}
-
-	auto f = [](bool isZero, bool isSwap, std::vector<Pointer<TvmAstNode>> const& instructions) {
-		if (instructions.size() != (isSwap ? 2 : 1)) {
-			return false;
-		}
-		return *instructions.at(0) == *gen(isZero ? "PUSHINT 0" : "NULL") &&
-			   (!isSwap || *instructions.at(1) == *makeXCH_S(1));
-	};
-
-	// PUSHCONT {
-	//    PUSHINT 0 / NULL
-	//    [SWAP]
-	// }
-	// IF[ELSE][NOT][JMP]
-	// =>
-	// ZERO/NULL SWAP/ROTR IF [NOT]
-	// PUSHCONT { ... }
-	// IF[ELSE][NOT][JMP]
-	if (m_flags.test(OptFlags::UnpackOpaque) && cmd1IfElse) {
-		for (bool isZero : {true, false}) {
-			if (isZero && *GlobalParams::g_tvmVersion == langutil::TVMVersion::ton()){
-				// ignore ZERO SWAP/ROTR IF [NOT]
-				continue;
-			}
-			for (bool isSwap : {true, false}) {
-				for (bool trueBranch: {true, false}) {
-					Pointer<CodeBlock> curBranch = trueBranch ? cmd1IfElse->trueBody() : cmd1IfElse->falseBody();
-					if (!curBranch) {
-						continue;
+			return {};
+		}},
+
+		// PUSH[REF]CONT { RETALT } IF[NOT][JMP] => IFRETALT
+		{1, {OpKind::IfElse}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd1IfElse = dyn_cast<TvmIfElse>(w.cmd1.get());
+			if (cmd1IfElse && cmd1IfElse->falseBody() == nullptr) {
+				std::vector<Pointer<TvmAstNode>> const& inst = cmd1IfElse->trueBody()->instructions();
+				if (qtyWithoutLoc(inst) == 1) {
+					Pointer<TvmAstNode> pos;
+					for (const auto& x : inst) if (!isa<Loc>(x.get())) pos = x;
+					auto ret = dyn_cast<TvmReturn>(pos.get());
+					if (ret && !ret->withIf() && ret->withAlt()) {
+						if (cmd1IfElse->withNot())
+							return Result{Rule::IfRetAltToIfRetAlt, 1, makeIFNOTRETALT()};
+						return Result{Rule::IfRetAltToIfRetAlt, 1, makeIFRETALT()};
 					}
-					if (f(isZero, isSwap, curBranch->instructions())) {
-						Pointer<AsymGen> align = getZeroOrNullAlignment(isZero, !isSwap,
-																		!trueBranch || cmd1IfElse->withNot());
-						solAssert(trueBranch ? true : !cmd1IfElse->withNot(), "");
-						auto emptyBlock = createNode<CodeBlock>(curBranch->type());
-						return Result{1,
-									  align,
-									  createNode<TvmIfElse>(cmd1IfElse->withNot(), cmd1IfElse->withJmp(),
-															trueBranch ? emptyBlock : cmd1IfElse->trueBody(),
-															trueBranch ? cmd1IfElse->falseBody() : emptyBlock,
-															cmd1IfElse->ret())
-						};
+				}
+			}
+			return {};
+		}},
+
+		// PUSH[REF]CONT { RETALT } JMP/CALLX => RETALT
+		{1, {OpKind::SubProgram}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd1Sub = dyn_cast<SubProgram>(w.cmd1.get());
+			if (cmd1Sub) {
+				std::vector<Pointer<TvmAstNode>> const& inst = cmd1Sub->block()->instructions();
+				if (qtyWithoutLoc(inst) == 1) {
+					Pointer<TvmAstNode> pos;
+					for (const auto& x : inst) if (!isa<Loc>(x.get())) pos = x;
+					auto ret = dyn_cast<TvmReturn>(pos.get());
+					if (ret && !ret->withIf() && ret->withAlt()) {
+						return Result{Rule::CallRetAltToRetAlt, 1, makeRETALT()};
 					}
 				}
 			}
-		}
-	}
-
-	return {};
-}
-
-std::optional<Result> PrivatePeepholeOptimizer::optimizeAt2(Pointer<TvmAstNode> const& cmd1, Pointer<TvmAstNode> const& cmd2) const {
-	using namespace MathConsts;
-	auto cmd1GenOp = to<StackOpcode>(cmd1.get());
-	auto cmd1Glob = to<Glob>(cmd1.get());
-
-	auto cmd2Exc = to<TvmException>(cmd2.get());
-	auto cmd2GenOpcode = to<StackOpcode>(cmd2.get());
-	auto cmd2Glob = to<Glob>(cmd2.get());
-	auto cmd2IfElse = to<TvmIfElse>(cmd2.get());
-	auto cmd1Ret = to<TvmReturn>(cmd1.get());
-
-	auto _isBLKDROP1 = isBLKDROP2(cmd1);
-	auto _isBLKDROP2 = isBLKDROP2(cmd2);
-	auto isBLKPUSH1 = isBLKPUSH(cmd1);
-	auto isPUSH1 = isPUSH(cmd1);
-
-	if (isSWAP(cmd1)) {
-		if (is(cmd2, "STU")) return Result{2, gen("STUR " + arg(cmd2))};
-		if (is(cmd2, "STSLICE")) return Result{2, gen("STSLICER")};
-		if (is(cmd2, "SUB")) return Result{2, gen("SUBR")};
-		if (is(cmd2, "SUBR")) return Result{2, gen("SUB")};
-		if (isCommutative(cmd2)) return Result{1};
-		if (cmd2GenOpcode &&
-			boost::starts_with(cmd2GenOpcode->opcode(), "ST") &&
-			boost::ends_with(cmd2GenOpcode->opcode(), "R") &&
-			cmd2GenOpcode->take() == 2 &&
-			cmd2GenOpcode->ret() == 1
-		) {
-			auto opcode = cmd2GenOpcode->opcode();
-			opcode = opcode.substr(0, opcode.size() - 1);
-			return Result{2, gen(opcode + " " + arg(cmd2))};
-		}
-	}
-	if (is(cmd1, "PUSHINT")) {
-		if (arg(cmd1) == "1") {
-			if (is(cmd2, "ADD")) return Result{2, gen("INC")};
-			if (is(cmd2, "SUB")) return Result{2, gen("DEC")};
-		}
-		bigint value = pushintValue(cmd1);
-		if (-128 <= value && value <= 127) {
-			if (is(cmd2, "ADD")) return Result{2, gen("ADDCONST " + toString(value))};
-			if (is(cmd2, "MUL")) return Result{2, gen("MULCONST " + toString(value))};
-		}
-		if (-128 <= -value && -value <= 127) {
-			if (is(cmd2, "SUB")) return Result{2, gen("ADDCONST " + toString(-value))};
-		}
-	}
-	if ((cmd1Ret && !cmd1Ret->withIf()) || isExc(cmd1, "THROWANY", "THROW")) {
-		// delete commands after non return opcode
-		return Result{2, cmd1};
-	}
-	if (isPUSH1 && *isPUSH1 == 0 && isSWAP(cmd2)) {
-		return Result{2, cmd1};
-	}
-	// POP Sn
-	// DROP n-1
-	// =>
-	// BLKDROP2 n, 1
-	if (isPOP(cmd1) && isDrop(cmd2) && isPOP(cmd1).value() == isDrop(cmd2).value() + 1) {
-		int n = isPOP(cmd1).value();
-		if (1 <= n && n <= 15) {
-			return Result{2, makeBLKDROP2(n, 1)};
-		}
-	}
-
-	// SWAP
-	// POP S2
-	//
-	// BLKDROP2 1, 2
-	if (isSWAP(cmd1) && isPOP(cmd2) && isPOP(cmd2).value() == 2) {
-		return Result{2, makeBLKDROP2(1, 2)};
-	}
-	// PUSH Si | gen01
-	// DROP N
-	//
-	// DROP N-1
-	if ((isPUSH(cmd1) || isPureGen01(*cmd1)) && isDrop(cmd2)) {
-		int qty = isDrop(cmd2).value();
-		if (qty == 1) {
-			return Result{2};
-		} else {
-			return Result{2, makeDROP(qty - 1)};
-		}
-	}
-
-	// BLKPUSH N, index / DROP
-	// BLKDROP N
-	if (m_flags.test(OptFlags::UseCompoundOpcodes) && isBLKPUSH1 && isDrop(cmd2)) {
-		auto [qty, index] = isBLKPUSH1.value();
-		int diff = qty - isDrop(cmd2).value();
-		if (diff == 0)
-			return Result{2};
-		if (diff < 0)
-			return Result{2, makeDROP(-diff)};
-		else
-			return Result{2, makeBLKPUSH(diff, index)};
-	}
-
-	// PUSH S[n-1]
-	// BLKDROP2 N, 1 / NIP
-	// =>
-	// DROP N-1
-	if (isPUSH1 && _isBLKDROP2) {
-		int index = *isPUSH1;
-		auto [drop, rest] = _isBLKDROP2.value();
-
-		if (drop == index + 1 && rest == 1) {
-			if (drop == 1) {
-				return Result{2};
-			} else {
-				return Result{2, makeDROP(drop - 1)};
+			return {};
+		}},
+
+		// PUSHCONT {
+		//  LDU 256
+		//	ENDS
+		// }
+		// PUSHCONT {
+		//	LDU 256
+		//	ENDS
+		// }
+		// IFELSE
+		// =>
+		// DROP
+		// PUSHCONT {
+		//	LDU 256
+		//	ENDS
+		// }
+		// CALLX
+		{1, {OpKind::IfElse}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd1IfElse = dyn_cast<TvmIfElse>(w.cmd1.get());
+			if (cmd1IfElse && cmd1IfElse->falseBody() != nullptr) {
+				std::vector<Pointer<TvmAstNode>> const& t = cmd1IfElse->trueBody()->instructions();
+				std::vector<Pointer<TvmAstNode>> const& f = cmd1IfElse->falseBody()->instructions();
+				if (t.size() == f.size()) {
+					bool eq = true;
+					int n = f.size();
+					for (int i = 0; i < n; ++i) {
+						eq &= *t.at(i) == *f.at(i);
+					}
+					if (eq) {
+						auto subProg = createNode<SubProgram>(0, cmd1IfElse->ret(), false, cmd1IfElse->trueBody(), false);
+						return Result{Rule::EqualBranchesToCall, 1, makeDROP(), subProg};
+					}
+				}
 			}
-		}
-	}
-	// s01
-	// BLKDROP2 N, M
-	// =>
-	// BLKDROP2 N, M-1
-	// s01
-	if (isPureGen01(*cmd1) && _isBLKDROP2) {
-		auto [down, up] = _isBLKDROP2.value();
-		return Result{2, makeBLKDROP2(down, up - 1), cmd1};
-	}
-	// PUSH SN
-	// BLKDROP2 down, top
-	// =>
-	// BLKDROP2 down, top-1
-	// PUSH S?
-	if (m_flags.test(OptFlags::UseCompoundOpcodes) && isPUSH(cmd1) && _isBLKDROP2) {
-		int n = *isPUSH(cmd1);
-		auto [down, top] = _isBLKDROP2.value();
-		if (n + 2 <= top)
-			return Result{2, makeBLKDROP2(down, top - 1), cmd1};
-		else if (n >= down + top - 1)
-			return Result{2, makeBLKDROP2(down, top - 1), makePUSH(n - down)};
-	}
-	// BLKPUSH
-	// BLKDROP2
-	// =>
-	// ???
-	if (isBLKPUSH1 && _isBLKDROP2) {
-		auto [qty, index] = isBLKPUSH1.value();
-		auto [drop, rest] = _isBLKDROP2.value();
-
-		// BLKPUSH  qty, qty-1
-		// BLKDROP2 qty+X, qty
+			return {};
+		}},
+
+		// PUSHCONT {
+		//   ...
+		//   Z
+		// }
+		// PUSHCONT {
+		//   ...
+		//   Z
+		// }
+		// IFELSE
 		// =>
-		// BLKDROP2 X, qty
-		if (qty == index + 1 && rest == qty) {
-			if (drop == qty) {
-				return Result{2};
-			} else if (drop > qty) {
-				return Result{2, makeBLKDROP2(drop - qty, qty)};
+		// PUSHCONT {
+		//   ...
+		// }
+		// PUSHCONT {
+		//   ...
+		// }
+		// IFELSE
+		// Z
+		{1, {OpKind::IfElse}, [](PrivatePeepholeOptimizer const& self, Window const& w) -> std::optional<Result> {
+			auto cmd1IfElse = dyn_cast<TvmIfElse>(w.cmd1.get());
+			if (self.m_flags.test(OptFlags::UnpackOpaque) && cmd1IfElse && cmd1IfElse->falseBody() != nullptr && cmd1IfElse->ret() == 0) {
+				std::vector<Pointer<TvmAstNode>> const& t = cmd1IfElse->trueBody()->instructions();
+				std::vector<Pointer<TvmAstNode>> const& f = cmd1IfElse->falseBody()->instructions();
+				if (!t.empty() &&
+					!f.empty() &&
+					*t.back() == *f.back() &&
+					!cmd1IfElse->withJmp() &&
+					cmd1IfElse->trueBody()->type() == CodeBlock::Type::PUSHCONT &&
+					cmd1IfElse->falseBody()->type() == CodeBlock::Type::PUSHCONT &&
+					!hasRetOrJmp(cmd1IfElse->trueBody().get()) &&
+					!hasRetOrJmp(cmd1IfElse->falseBody().get())
+				) {
+					auto tt = createNode<CodeBlock>(CodeBlock::Type::PUSHCONT, std::vector<Pointer<TvmAstNode>>(t.begin(), t.end() - 1));
+					auto ff = createNode<CodeBlock>(CodeBlock::Type::PUSHCONT, std::vector<Pointer<TvmAstNode>>(f.begin(), f.end() - 1));
+					auto ifElse2 = createNode<TvmIfElse>(cmd1IfElse->withNot(), false, tt, ff, 0);
+					return Result{Rule::IfElseCommonTail, 1, ifElse2, t.back()};
+				}
 			}
-		}
-
-		// BLKPUSH   qty, index
-		// BLKDROP2 drop, qty
+			return {};
+		}},
+
+		// PUSHCONT {
+		//   ...
+		// }
+		// PUSHCONT {
+		// }
+		// IFELSE
 		// =>
-		// DROP X, qty
-		if (qty == rest) {
-			int lastIndex = index - qty + 1; // include
-			if (lastIndex >= 0 && lastIndex + qty == drop) {
-				// a b c d e f X Y |
-				// X Y a b c d e f X Y | BLKPUSH
-				// X Y | BLKDROP2
-				int newDrop = lastIndex;
-				return Result{2, makeDROP(newDrop)};
+		// PUSHCONT {
+		//   ...
+		// }
+		// IF
+		{1, {OpKind::IfElse}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd1IfElse = dyn_cast<TvmIfElse>(w.cmd1.get());
+			if (cmd1IfElse && cmd1IfElse->falseBody() != nullptr) {
+				std::vector<Pointer<TvmAstNode>> const& f = cmd1IfElse->falseBody()->instructions();
+				if (qtyWithoutLoc(f) == 0 &&
+					!cmd1IfElse->withJmp()
+				) {
+					auto ifElse2 = createNode<TvmIfElse>(cmd1IfElse->withNot(), false, cmd1IfElse->trueBody(), nullptr, 0);
+					return Result{Rule::EmptyElseToIf, 1, ifElse2};
+				}
 			}
-		}
-	}
-	// DUP
-	// BLKDROP2 n, 1
-	// =>
-	// BLKDROP2 n-1, 1
-	// Same as prev
-	if (isPUSH1 && *isPUSH1 == 0 &&
-		_isBLKDROP2 && _isBLKDROP2.value().second == 1
-	) {
-		int n = _isBLKDROP2.value().first;
-		if (n == 1) {
-			return Result{2};
-		} else {
-			return Result{2, makeBLKDROP2(n - 1, 1)};
-		}
-	}
-
-	// NIP
-	// DROP n
-	// =>
-	// DROP n+1
-	if (isNIP(cmd1) && isDrop(cmd2)) {
-		return Result{2, makeDROP(isDrop(cmd2).value() + 1)};
-	}
-	// NOT THROWIFNOT/THROWIF N => THROWIF/THROWIFNOT N
-	// NOT PUSHCONT {} IF/IFNOT => PUSHCONT {} IFNOT/IF
-	if (is(cmd1, "NOT")) {
-		if (isExc(cmd2, "THROWIF"))
-			return Result{2, makeTHROW("THROWIFNOT " + cmd2Exc->arg())};
-		if (isExc(cmd2, "THROWIFNOT"))
-			return Result{2, makeTHROW("THROWIF " + cmd2Exc->arg())};
-		if (cmd2IfElse)
-			return Result{2, flipIfElse(*cmd2IfElse)};
-	}
-	// EQINT 0 THROWIFNOT/THROWIF N => THROWIF/THROWIFNOT N
-	// EQINT 0 PUSHCONT {} IF/IFNOT => PUSHCONT {} IFNOT/IF
-	if (is(cmd1, "EQINT") && cmd1GenOp->arg() == "0") {
-		if (isExc(cmd2, "THROWIF"))
-			return Result{2, makeTHROW("THROWIFNOT " + cmd2Exc->arg())};
-		if (isExc(cmd2, "THROWIFNOT"))
-			return Result{2, makeTHROW("THROWIF " + cmd2Exc->arg())};
-		if (cmd2IfElse)
-			return Result{2, flipIfElse(*cmd2IfElse)};
-	}
-	// NEQINT 0, THROWIF/THROWIFNOT N => THROWIF/THROWIFNOT N
-	// NEQINT 0, PUSHCONT {} IF => PUSHCONT {} IF
-	if (is(cmd1, "NEQINT") && cmd1GenOp->arg() == "0") {
-		if (isExc(cmd2, "THROWIF"))
-			return Result{2, makeTHROW("THROWIF " + cmd2Exc->arg())};
-		if (isExc(cmd2, "THROWIFNOT"))
-			return Result{2, makeTHROW("THROWIFNOT " + cmd2Exc->arg())};
-		if (cmd2IfElse)
-			return Result{2, cmd2};
-	}
-
-	// TRUE
-	// PUSHCONT {} / PUSHREF {}
-	// ...
-	// IF / IFJMP / IFELSE / IFELSE_WITH_JMP
-	if (is(cmd1, "TRUE") && cmd2IfElse && !cmd2IfElse->withNot()) {
-		auto subProg = createNode<SubProgram>(0, 0, cmd2IfElse->withJmp(), cmd2IfElse->trueBody(), false);
-		return Result{2, subProg};
-	}
-
-	// BLKSWAP  down, up
-	// BLKDROP2 drop, rest where drop==up and rest==down
-	// ...
-	// DROP up
-	if (isBLKSWAP(cmd1) && isBLKDROP2(cmd2)) {
-		auto [down, up] = isBLKSWAP(cmd1).value();
-		auto [drop, rest] = isBLKDROP2(cmd2).value();
-		if (drop==up && rest==down)
-			return Result{2, makeDROP(up)};
-	}
-
-	// BLKDROP2 drop, rest
-	// BLKDROP rest + some
-	// ...
-	// BLKDROP drop + rest + some
-	if (isBLKDROP2(cmd1) && isDrop(cmd2)) {
-		auto [drop, rest] = isBLKDROP2(cmd1).value();
-		int n = isDrop(cmd2).value();
-		int some = n - rest;
-		if (some >= 0)
-			return Result{2, makeDROP(drop + rest + some)};
-	}
-
-	// BLKSWAP down, up
-	// DROP down
-	// =>
-	// BLKDROP down, up
-	if (isBLKSWAP(cmd1) && isDrop(cmd2)) {
-		auto [down, up] = isBLKSWAP(cmd1).value();
-		int n = isDrop(cmd2).value();
-		if (n == down)
-			return Result{2, makeBLKDROP2(down, up)};
-	}
+			return {};
+		}},
+
+		// PUSHCONT {
+		// }
+		// PUSHCONT {
+		//    ...
+		// }
+		// IFELSE
+		// =>
+		// PUSHCONT {
+		//   ...
+		// }
+		// IFNOT
+		{1, {OpKind::IfElse}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd1IfElse = dyn_cast<TvmIfElse>(w.cmd1.get());
+			if (cmd1IfElse && cmd1IfElse->falseBody() != nullptr) {
+				std::vector<Pointer<TvmAstNode>> const& t = cmd1IfElse->trueBody()->instructions();
+				if (qtyWithoutLoc(t) == 0 &&
+					!cmd1IfElse->withJmp()
+				) {
+					auto ifElse2 = createNode<TvmIfElse>(!cmd1IfElse->withNot(), false, cmd1IfElse->falseBody(), nullptr, 0);
+					return Result{Rule::EmptyThenToIfNot, 1, ifElse2};
+				}
+			}
+			return {};
+		}},
 
-	if (isBLKSWAP(cmd1) && isBLKSWAP(cmd2)) {
-		auto [down1, top1] = isBLKSWAP(cmd1).value();
-		auto [down2, top2] = isBLKSWAP(cmd2).value();
-		if (down1 + top1 == down2 + top2) {
-			// BLKSWAP down1, top1 where down1 + top1 == n
-			// BLKSWAP     1, n-1
-			// ...
-			// BLKSWAP down1+1, top1-1
-			if (down2 == 1) {
-				if (top1 == 1) {
-					return Result{2};
-				} else {
-					return Result{2, makeBLKSWAP(down1 + 1, top1 - 1)};
+		// PUSHCONT { a }
+		// PUSHCONT { b }
+		// IFELSE
+		// =>
+		// newA
+		// newB
+		// CONDSEL
+		{1, {OpKind::IfElse}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd1IfElse = dyn_cast<TvmIfElse>(w.cmd1.get());
+			if (cmd1IfElse && cmd1IfElse->falseBody() != nullptr) {
+				std::vector<Pointer<TvmAstNode>> const& t = cmd1IfElse->trueBody()->instructions();
+				std::vector<Pointer<TvmAstNode>> const& f = cmd1IfElse->falseBody()->instructions();
+				if (qtyWithoutLoc(t) == 1 && qtyWithoutLoc(f) == 1) {
+					int ti = nextCommandLine(0, t);
+					int fi = nextCommandLine(0, f);
+					Pointer<TvmAstNode> a = t.at(ti);
+					Pointer<TvmAstNode> b = f.at(fi);
+					if ((isPureGen01(*a) && isa<StackOpcode>(a.get())) ||
+						dyn_cast<Glob>(a.get()) ||
+						dyn_cast<PushCellOrSlice>(a.get()) ||
+						isPUSH(a)
+					) {
+						Pointer<TvmAstNode> newA = a;
+						if (auto index = isPUSH(a))
+							newA = makePUSH(*index + 1); // +1 because condition flag
+
+						Pointer<TvmAstNode> newB;
+						if (isa<StackOpcode>(b.get()) ||
+							dyn_cast<Glob>(b.get()) ||
+							dyn_cast<PushCellOrSlice>(b.get())
+						)
+							newB = b;
+						else if (auto index = isPUSH(b))
+							newB = makePUSH(*index + 2); // +2 because condition flag and value from first branch
+
+						if (newB)
+							return Result{Rule::IfElseToCondSel, 1, newA, newB, gen("CONDSEL")};
+					}
 				}
 			}
-			// BLKSWAP down1, top1  where down1 + top1 == n
-			// BLKSWAP n-1,    1
-			// ...
-			// BLKSWAP down1-1, top1+1
-			if (top2 == 1) {
-				if (down1 == 1) {
-					return Result{2};
-				} else {
-					return Result{2, makeBLKSWAP(down1 - 1, top1 + 1)};
+			return {};
+		}},
+
+		// PUSHCONT { TRUE }
+		// PUSHCONT { ... }
+		// WHILE
+		// =>
+		// PUSHCONT { ... }
+		// AGAIN
+		{1, {OpKind::While}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (auto _while = dyn_cast<While>(w.cmd1.get())) {
+				std::vector<Pointer<TvmAstNode>> const& instr = _while->condition()->instructions();
+				if (instr.size() == 1 && is(instr.at(0), "TRUE") && !_while->isInfinite()) {
+					return Result{Rule::WhileTrueToAgain, 1, createNode<While>(true, _while->withBreakOrReturn(), _while->condition(), _while->body())};
 				}
 			}
-		}
-	}
-	if (is(cmd1, "TUPLE") &&
-		is(cmd2, "UNTUPLE") &&
-		fetchInt(cmd1) == fetchInt(cmd2))
-	{
-		return Result{2};
-	}
-	if (is(cmd1, "UNTUPLE") &&
-		is(cmd2, "TUPLE") &&
-		fetchInt(cmd1) == fetchInt(cmd2))
-	{
-		return Result{2};
-	}
-	// SETGLOB N
-	// GETGLOB N
-	//
-	// DUP
-	// SETGLOB N
-	if (cmd1Glob && cmd1Glob->opcode() == Glob::Opcode::SetOrSetVar &&
-		cmd2Glob && cmd2Glob->opcode() == Glob::Opcode::GetOrGetVar &&
-		cmd1Glob->index() == cmd2Glob->index()
-	) {
-		return Result{2, makePUSH(0), makeSetGlob(cmd1Glob->index())};
-	}
-	// PUSHINT N
-	// ADDCONST ? | INC | DEC
-	//
-	// PUSHINT (N+delta)
-	if (is(cmd1, "PUSHINT") && isConstAdd(cmd2)) {
-		bigint n = pushintValue(cmd1);
-		bigint delta = getAddNum(cmd2);
-		// TODO check overflow
-		return Result{2, gen("PUSHINT " + toString(n + delta))};
-	}
-	// PUSHINT N
-	// UFITS ? | FITS ?
-	//
-	// PUSHINT N
-	if (is(cmd1, "PUSHINT") && (is(cmd2, "UFITS") || is(cmd2, "FITS"))) {
-		bigint n = pushintValue(cmd1);
-		int bits = fetchInt(cmd2);
-		auto type = TypeProvider::integer(bits,
-										  is(cmd2, "UFITS") ? IntegerType::Modifier::Unsigned :
-										  						IntegerType::Modifier::Signed);
-		if (type->minValue() <= n && n <= type->maxValue())
-			return Result{2, gen("PUSHINT " + toString(n))};
-	}
-	if (isConstAdd(cmd1) && isConstAdd(cmd2)) {
-		int final_add = getAddNum(cmd1) + getAddNum(cmd2);
-		if (-128 <= final_add && final_add <= 127)
-			return Result{2, gen("ADDCONST " + std::to_string(final_add))};
-	}
-	if ((is(cmd1, "INDEX_NOEXCEP") || is(cmd1, "INDEX_EXCEP")) && 0 <= fetchInt(cmd1) && fetchInt(cmd1) <= 3 &&
-		(is(cmd2, "INDEX_NOEXCEP") || is(cmd2, "INDEX_EXCEP")) && 0 <= fetchInt(cmd2) && fetchInt(cmd2) <= 3) {
-		return Result{2, gen("INDEX2 " + arg(cmd1) + ", " + arg(cmd2))};
-	}
-	if (is(cmd1, "INDEX2") &&
-		(is(cmd2, "INDEX_NOEXCEP") || is(cmd2, "INDEX_EXCEP")) && 0 <= fetchInt(cmd2) && fetchInt(cmd2) <= 3
-	) {
-		auto [i, j] = getIndexes(arg(cmd1));
-		if (0 <= i && i <= 3 &&
-			0 <= j && j <= 3) {
-			return Result{2, gen("INDEX3 " + toString(i) + ", " + toString(j) + ", " + arg(cmd2))};
-		}
-	}
-	if (
-		is(cmd1, "PUSHINT") && 1 <= pushintValue(cmd1) && pushintValue(cmd1) <= 256 &&
-		(is(cmd2, "RSHIFT") || is(cmd2, "LSHIFT")) && arg(cmd2).empty()
-	) {
-		return Result{2, gen(cmd2GenOpcode->opcode() + " " + arg(cmd1))};
-	}
-	// PUSHINT 2**N
-	// DIV / MUL
-	// =>
-	// RSHIFT N / LSHIFT N
-	if (is(cmd1, "PUSHINT") &&
-		(is(cmd2, "DIV") || is(cmd2, "MUL"))) {
-		bigint val = pushintValue(cmd1);
-		if (power2Exp().count(val)) {
-			std::string const& newOp = is(cmd2, "DIV") ? "RSHIFT" : "LSHIFT";
-			int const n = power2Exp().at(val);
-			if (n > 0)
-				return Result{2, gen(newOp + " " + toString(n))};
-		}
-	}
-	// PUSHINT 2**N
-	// MOD
-	// =>
-	// MODPOW2 N
-	if (is(cmd1, "PUSHINT") && is(cmd2, "MOD")) {
-		bigint val = pushintValue(cmd1);
-		if (power2Exp().count(val)) {
-			return Result{2, gen("MODPOW2 " + toString(power2Exp().at(val)))};
-		}
-	}
-	// PUSHINT (2**N)-1
-	// AND
-	// =>
-	// MODPOW2 N
-	if (is(cmd1, "PUSHINT") && is(cmd2, "AND")) {
-		bigint val = pushintValue(cmd1);
-		if (power2DecExp().count(val)) {
-			return Result{2, gen("MODPOW2 " + toString(power2DecExp().at(val)))};
-		}
-	}
-	if (is(cmd1, "PUSHINT")) {
-		bigint val = pushintValue(cmd1);
-		if (-128 <= val && val < 128) {
-			if (is(cmd2, "NEQ"))
-				return Result{2, gen("NEQINT " + toString(val))};
-			if (is(cmd2, "EQUAL"))
-				return Result{2, gen("EQINT " + toString(val))};
-			if (is(cmd2, "GREATER"))
-				return Result{2, gen("GTINT " + toString(val))};
-			if (is(cmd2, "LESS"))
-				return Result{2, gen("LESSINT " + toString(val))};
-		}
-		if (-128 <= val - 1 && val - 1 < 128 && is(cmd2, "GEQ"))
-			return Result{2, gen("GTINT " + toString(val - 1))};
-		if (-128 <= val + 1 && val + 1 < 128 && is(cmd2, "LEQ"))
-			return Result{2, gen("LESSINT " + toString(val + 1))};
-	}
-	if (_isBLKDROP1 && _isBLKDROP2) {
-		auto [drop1, rest1] = _isBLKDROP1.value();
-		auto [drop2, rest2] = _isBLKDROP2.value();
-		// BLKDROP2 drop0, rest
-		// BLKDROP2 drop1, rest
+			return {};
+		}},
+
+		// PUSHCONT { here }
+		// CALLX
 		// =>
-		// BLKDROP2 drop0+drop1, rest
-		if (rest1 == rest2 && drop1 + drop2 <= 15) {
-			return Result{2, makeBLKDROP2(drop1 + drop2, rest1)};
-		}
-		// BLKDROP2 drop1, rest1
-		// BLKDROP2 drop2, rest2
+		// here
+		{1, {OpKind::SubProgram}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd1Sub = dyn_cast<SubProgram>(w.cmd1.get());
+			if (cmd1Sub && !cmd1Sub->isJmp() && cmd1Sub->block()->type() == CodeBlock::Type::PUSHCONT) {
+				bool ok = true;
+				for (Pointer<TvmAstNode> const& cmd : cmd1Sub->block()->instructions()) {
+					if (hasRetOrJmp(cmd.get())) {
+						ok = false;
+					}
+				}
+				if (ok) {
+					return Result{Rule::InlineCallX, 1, cmd1Sub->block()->instructions()};
+				}
+			}
+			return {};
+		}},
+
+		// PUSHCONT {
+		//    CALLREF {
+		//       code
+		//    }
+		// }
 		// =>
-		// BLKDROP2 drop1+drop2, rest1
-		if (rest1 == drop2 + rest2 && rest1 >= rest2) {
-			return Result{2, makeBLKDROP2(drop1 + drop2, rest2)};
-		}
-	}
-
-	// BLKSWAP bottom, top
-	// BLKDROP bottom
-	// =>
-	// BLKDROP2 bottom, top
-	if (isBLKSWAP(cmd1) &&
-		isDrop(cmd2)
-	) {
-		auto [bottom, top] = isBLKSWAP(cmd1).value();
-		int n = isDrop(cmd2).value();
-		if (n == bottom) {
-			return Result{2, makeBLKDROP2(n, top)};
-		}
-	}
+		// PUSHREF {
+		//    code
+		// }
+		{1, {OpKind::CodeBlock}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd1CodeBlock = dyn_cast<CodeBlock>(w.cmd1.get());
+			if (cmd1CodeBlock && cmd1CodeBlock->type() == CodeBlock::Type::PUSHCONT) {
+				std::vector<Pointer<TvmAstNode>> const&  opcodes = cmd1CodeBlock->instructions();
+				if (qtyWithoutLoc(opcodes) == 1) {
+					int index = nextCommandLine(0, opcodes);
+					TvmAstNode const* opcode = opcodes.at(index).get();
+					if (auto sub = dyn_cast<SubProgram>(opcode)) {
+						return Result{Rule::PushContCallRefToPushRef, 1, createNode<CodeBlock>(sub->block()->type(), sub->block()->instructions())};
+					}
+				}
+			}
+			return {};
+		}},
+
+		// PUSHCONT {
+		//    PUSHINT 0 / NULL
+		//    [SWAP]
+		// }
+		// IF[ELSE][NOT][JMP]
+		// =>
+		// ZERO/NULL SWAP/ROTR IF [NOT]
+		// PUSHCONT { ... }
+		// IF[ELSE][NOT][JMP]
+		{1, {OpKind::IfElse}, [](PrivatePeepholeOptimizer const& self, Window const& w) -> std::optional<Result> {
+			auto cmd1IfElse = dyn_cast<TvmIfElse>(w.cmd1.get());
+			auto f = [](bool isZero, bool isSwap, std::vector<Pointer<TvmAstNode>> const& instructions) {
+				if (instructions.size() != (isSwap ? 2 : 1)) {
+					return false;
+				}
+				return *instructions.at(0) == *gen(isZero ? "PUSHINT 0" : "NULL") &&
+					   (!isSwap || *instructions.at(1) == *makeXCH_S(1));
+			};
+			if (self.m_flags.test(OptFlags::UnpackOpaque) && cmd1IfElse) {
+				for (bool isZero : {true, false}) {
+					if (isZero && *GlobalParams::g_tvmVersion == langutil::TVMVersion::ton()){
+						// ignore ZERO SWAP/ROTR IF [NOT]
+						continue;
+					}
+					for (bool isSwap : {true, false}) {
+						for (bool trueBranch: {true, false}) {
+							Pointer<CodeBlock> curBranch = trueBranch ? cmd1IfElse->trueBody() : cmd1IfElse->falseBody();
+							if (!curBranch) {
+								continue;
+							}
+							if (f(isZero, isSwap, curBranch->instructions())) {
+								Pointer<AsymGen> align = getZeroOrNullAlignment(isZero, !isSwap,
+																				!trueBranch || cmd1IfElse->withNot());
+								solAssert(trueBranch ? true : !cmd1IfElse->withNot(), "");
+								auto emptyBlock = createNode<CodeBlock>(curBranch->type());
+								return Result{Rule::ZeroOrNullBranchToAlign, 1,
+											  align,
+											  createNode<TvmIfElse>(cmd1IfElse->withNot(), cmd1IfElse->withJmp(),
+																	trueBranch ? emptyBlock : cmd1IfElse->trueBody(),
+																	trueBranch ? cmd1IfElse->falseBody() : emptyBlock,
+																	cmd1IfElse->ret())
+								};
+							}
+						}
+					}
+				}
+			}
+			return {};
+		}},
+
+		// delete last RET in block
+		{0, {OpKind::Return}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd1Ret = dyn_cast<TvmReturn>(w.cmd1.get());
+			if (cmd1Ret && !cmd1Ret->withIf() && !cmd1Ret->withAlt() && w.idx2 == -1) {
+				return Result{Rule::TrailingRet, 1};
+			}
+			return {};
+		}},
+
+		// PUSHCONT {
+		//    NULL
+		//    SWAP
+		// }
+		// IFNOTJMP
+		// =>
+		// NULLROTRIFNOT
+		// DROP
+		{0, {OpKind::IfElse}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd1IfElse = dyn_cast<TvmIfElse>(w.cmd1.get());
+			if (cmd1IfElse && cmd1IfElse->falseBody() == nullptr && cmd1IfElse->withJmp() && cmd1IfElse->withNot() &&
+				w.idx2 == -1) {
+				std::vector<Pointer<TvmAstNode>> const& insts = cmd1IfElse->trueBody()->instructions();
+				if (insts.size() == 2 && is(insts.at(0), "NULL") && isSWAP(insts.at(1))) {
+					return Result{Rule::NullSwapIfNotJmpToAsym, 1, StackPusher::makeAsym("NULLROTRIFNOT"), makeDROP()};
+				}
+			}
+			return {};
+		}},
+
+		// squash ST* opcodes
+		{0, {OpKind::PushCellOrSlice, "PUSHINT", "STSLICECONST"}, [](PrivatePeepholeOptimizer const& self, Window const& w) -> std::optional<Result> {
+			// another stores?
+			int i = w.idx1;
+			std::string bitString;
+			int opcodeQty = 0;
+			vector<Pointer<TvmAstNode>> takenOpcodes;
+			bool withBuilder = false;
+			{
+				int j = self.nextCommandLine(i);
+				int k = self.nextCommandLine(j);
+				Pointer<TvmAstNode> const& cmd2 = self.get(j);
+				Pointer<TvmAstNode> const& cmd3 = self.get(k);
+
+				if (k != -1 &&
+					isPlainPushSlice(w.cmd1) &&
+					is(cmd2, "NEWC") &&
+					is(cmd3, "STSLICE")
+				) {
+					withBuilder = true;
+					std::string hexSlice = isPlainPushSlice(w.cmd1)->blob();
+					bitString += StrUtils::toBitString(hexSlice);
+					opcodeQty += 3;
+					takenOpcodes.emplace_back(w.cmd1);
+					takenOpcodes.emplace_back(cmd2);
+					takenOpcodes.emplace_back(cmd3);
+					i = self.nextCommandLine(k);
+				}
+				// PUSHINT ?
+				// NEWC
+				// STU y | STI y
+				else if (
+					is(w.cmd1, "PUSHINT") &&
+					is(cmd2, "NEWC") &&
+					(is(cmd3, "STU") || is(cmd3, "STI"))
+				) {
+					if (auto bitStr = StrUtils::toBitString(pushintValue(w.cmd1), fetchInt(cmd3), is(cmd3, "STI"))) {
+						withBuilder = true;
+						bitString += bitStr.value();
+						opcodeQty += 3;
+						takenOpcodes.emplace_back(w.cmd1);
+						takenOpcodes.emplace_back(cmd2);
+						takenOpcodes.emplace_back(cmd3);
+						i = self.nextCommandLine(k);
+					}
+				}
+			}
 
-	if (is(cmd1, "NEWC") && is(cmd2, "ENDC")) {
-		return Result{2, makePUSHREF()};
-	}
+			while (i != -1) {
+				Pointer<TvmAstNode> const& c1 = self.get(i);
+				int j = self.nextCommandLine(i);
+				Pointer<TvmAstNode> c2;
+				if (j != -1) {
+					c2 = self.get(j);
+				}
 
-	// LESS | LEQ    | GREATER | GEQ  | EQUAL | NEQ   | EQINT  | NEQINT | NOT | TRUE  | FALSE
-	// NOT
-	// =>
-	// GEQ | GREATER | LEQ     | LESS | NEQ   | EQUAL | NEQINT | EQINT  |     | FALSE | TRUE
-	if (is(cmd2, "NOT")) {
-		if (is(cmd1, "LESS")) return Result{2, gen("GEQ")};
-		if (is(cmd1, "LEQ")) return Result{2, gen("GREATER")};
-		if (is(cmd1, "GREATER")) return Result{2, gen("LEQ")};
-		if (is(cmd1, "GEQ")) return Result{2, gen("LESS")};
-		if (is(cmd1, "EQUAL")) return Result{2, gen("NEQ")};
-		if (is(cmd1, "NEQ")) return Result{2, gen("EQUAL")};
-
-		if (is(cmd1, "LESSINT")) {  // !(x < value) => x >= value => x > value-1
-			int value = fetchInt(cmd1);
-			if (-128 <= value - 1 && value - 1 < 128)
-				return Result{2, gen("GTINT " + toString(value - 1))};
-		}
-		if (is(cmd1, "GTINT")) {  // !(x > value) => x <= value => x < value+1
-			int value = fetchInt(cmd1);
-			if (-128 <= value + 1 && value + 1 < 128)
-				return Result{2, gen("LESSINT " + toString(value + 1))};
-		}
-		if (is(cmd1, "EQINT")) return Result{2, gen("NEQINT " + arg(cmd1))};
-		if (is(cmd1, "NEQINT")) return Result{2, gen("EQINT " + arg(cmd1))};
+				// TODO ADD LD[I|U]LE[4|8]
+				int curOpcodeQty = 0;
+				if (is(c1, "STSLICECONST")) {
+					bitString += StrUtils::toBitString(arg(c1));
+					curOpcodeQty = 1;
+					i = j;
+				} else if (c2 && is(c1, "PUSHINT") && (is(c2, "STUR") || is(c2, "STIR"))) {
+					bigint num = pushintValue(c1);
+					int len = fetchInt(c2);
+					if (auto bitStr = StrUtils::toBitString(num, len, is(c2, "STIR"))) {
+						bitString += bitStr.value();
+						curOpcodeQty = 2;
+						i = self.nextCommandLine(j);
+					} else
+						break;
+				} else if (c2 && is(c1, "PUSHINT") && is(c2, "STVARUINT16", "STGRAMS")) {
+					bigint num = pushintValue(c1);
+					bitString += StrUtils::tonsToBinaryString(num);
+					curOpcodeQty = 2;
+					i = self.nextCommandLine(j);
+				} else if (c2 && is(c1, "PUSHINT") && is(c2, "STZEROES")) {
+					int len = fetchInt(c1);
+					bitString += std::string(len, '0');
+					curOpcodeQty = 2;
+					i = self.nextCommandLine(j);
+				} else if (c2 && isPlainPushSlice(c1) && is(c2, "STSLICER")) {
+					std::string hexSlice = isPlainPushSlice(c1)->blob();
+					bitString += StrUtils::toBitString(hexSlice);
+					curOpcodeQty = 2;
+					i = self.nextCommandLine(j);
+				} else {
+					break;
+				}
+				opcodeQty += curOpcodeQty;
+				takenOpcodes.emplace_back(c1);
+				if (curOpcodeQty >= 2)
+					takenOpcodes.emplace_back(c2);
+			}
 
-		if (is(cmd1, "NOT")) return Result{2};
+			std::optional<std::string> slice = StrUtils::unitBitStringToHex(bitString, "");
+			if (slice) {
+				vector<Pointer<TvmAstNode>> opcodes;
+				std::optional<Result> res;
+				if (StrUtils::toBitString(*slice).length() <= TvmConst::MaxSTSLICECONST) {
+					if (withBuilder)
+						opcodes.push_back(gen("NEWC"));
+					opcodes.push_back(gen("STSLICECONST " + *slice));
+					res = Result{Rule::SquashStores, opcodeQty, opcodes};
+				} else {
+					if (withBuilder) {
+						opcodes.push_back(genPushSlice(*slice));
+						opcodes.push_back(gen("NEWC"));
+						opcodes.push_back(gen("STSLICE"));
+					} else {
+						opcodes.push_back(genPushSlice(*slice));
+						opcodes.push_back(gen("STSLICER"));
+					}
+					res = Result{Rule::SquashStores, opcodeQty, opcodes};
+				}
+				if (opcodeQty > int(res->commands.size()))
+				{
+					return res;
+				}
+				if (opcodeQty == int(res->commands.size()))
+				{
+					bool eq = true;
+					for (int i = 0; i < int(takenOpcodes.size()); ++i) {
+						bool curEq = *takenOpcodes.at(i) == *res->commands.at(i);
+						eq &= curEq;
+					}
+					if (!eq)
+						return res;
+				}
+			}
 
-		if (is(cmd1, "TRUE")) return Result{2, gen("FALSE")};
-		if (is(cmd1, "FALSE")) return Result{2, gen("TRUE")};
-	}
+			return {};
+		}},
 
-	if ((is(cmd1, "UFITS") && is(cmd2, "UFITS")) || (is(cmd1, "FITS") && is(cmd2, "FITS"))) {
-		int bitSize = std::min(fetchInt(cmd1), fetchInt(cmd2));
-		return Result{2, gen(cmd1GenOp->opcode() + " " + toString(bitSize))};
-	}
-	if ((is(cmd1, "TRUE") || is(cmd1, "FALSE")) &&
-		is(cmd2, "STIR") && fetchInt(cmd2) == 1
-	) {
-		if (is(cmd1, "FALSE"))
-			return Result{2, gen("STSLICECONST 0")};
-		return Result{2, gen("STSLICECONST 1")};
-	}
-	if (
-		is(cmd1, "PUSHINT") && pushintValue(cmd1) == 0 &&
-		is(cmd2, "STUR")
-	) {
-		return Result{2,
-			gen("PUSHINT " + arg(cmd2)),
-			gen("STZEROES")};
-	}
-	if (
-		is(cmd1, "ABS") &&
-		is(cmd2, "UFITS") && fetchInt(cmd2) == 256
-	) {
-		return Result{2, gen("ABS")};
-	}
+		// squash DROPs
+		{0, {Stack::Opcode::DROP}, [](PrivatePeepholeOptimizer const& self, Window const& w) -> std::optional<Result> {
+			int i = w.idx1, n = 0, total = 0;
+			while (i != -1 && isDrop(self.get(i))) {
+				n++;
+				total += isDrop(self.get(i)).value();
+				i = self.nextCommandLine(i);
+			}
+			if (n >= 2) {
+				return Result{Rule::SquashDrops, n, makeDROP(total)};
+			}
 
-	if (
-		is(cmd1, "PUSHINT") && pushintValue(cmd1) == 1 &&
-		is(cmd2, "STZEROES")
-	) {
-		return Result{2, gen("STSLICECONST 0")};
-	}
+			return {};
+		}},
 
-	// REVERSE N, 1
-	// BLKSWAP N, 1
-	// =>
-	// REVERSE N+1, 0
-	if (isREVERSE(cmd1) && isBLKSWAP(cmd2)) {
-		auto [qty, index] = isREVERSE(cmd1).value();
-		auto [bottom, top] = isBLKSWAP(cmd2).value();
-		if (top == 1 && index == 1 && qty == bottom)
-			return Result{2, makeREVERSE(qty + 1, 0)};
-	}
+		// BLKSWAP N, 1
+		// BLKSWAP N, 1
+		// BLKSWAP N, 1
+		// ...
+		// BLKSWAP N, 1
+		// =>
+		//
+		{0, swaps, [](PrivatePeepholeOptimizer const& self, Window const& w) -> std::optional<Result> {
+			if (isBLKSWAP(w.cmd1)) {
+				auto [n, top] = isBLKSWAP(w.cmd1).value();
+				if (top == 1) {
+					bool ok = true;
+					for (int iter = 0; iter < n + 1; ++iter) {
+						if (self.get(w.idx1 + iter) == nullptr) {
+							ok = false;
+							break;
+						}
+						auto c = self.get(w.idx1 + iter);
+						ok &= isBLKSWAP(c) && std::make_pair(n, 1) == isBLKSWAP(c).value();
+					}
+					if (ok) {
+						return Result{Rule::BlkSwapCycle, n + 1};
+					}
+				}
+			}
+			return {};
+		}},
 
-	// REVERSE N+1, 0
-	// BLKDROP N
-	// =>
-	// BLKDROP2 N, 1
-	if (isREVERSE(cmd1) && isDrop(cmd2)) {
-		auto [qty, index] = isREVERSE(cmd1).value();
-		int n = isDrop(cmd2).value();
-		if (n + 1 == qty && index == 0)
-			return Result{2, makeBLKDROP2(n, 1)};
-	}
+		// POP N
+		// POP N
+		// ...
+		// =>
+		// BLKDROP2 N, N
+		{0, pops, [](PrivatePeepholeOptimizer const& self, Window const& w) -> std::optional<Result> {
+			if (isPOP(w.cmd1)) {
+				int n = isPOP(w.cmd1).value();
+				if (n >= 2) {
+					int index = w.idx1;
+					bool ok = true;
+					int i = 0;
+					for (; ok && i < n && index != -1; ++i, index = self.nextCommandLine(index)) {
+						auto cmd = self.get(index);
+						ok &= isPOP(cmd) && isPOP(cmd).value() == n;
+					}
+					ok &= i == n;
+					if (ok) {
+						return Result{Rule::PopSequenceToBlkDrop2, n, makeBLKDROP2(n, n)};
+					}
+				}
+			}
+			return {};
+		}},
 
-	// ENDC
-	// STREFR
-	// =>
-	// STBREFR
-	if (
-		is(cmd1, "ENDC") &&
-		is(cmd2, "STREFR")
-	) {
-		return Result{2, gen("STBREFR")};
-	}
+		// REVERSE n, 0
+		// POP
+		// ...
+		// POP
+		// =>
+		// POP
+		// ..
+		// POP
+		{0, swaps, [](PrivatePeepholeOptimizer const& self, Window const& w) -> std::optional<Result> {
+			if (isREVERSE(w.cmd1) && w.idx2 != -1) {
+				auto [n, startIndex] = isREVERSE(w.cmd1).value();
+				if (startIndex == 0) {
+					vector<Pointer<TvmAstNode>> newCmds;
+					int index = w.idx2;
+					bool ok = true;
+					int i = 0;
+					for (; ok && i < n && index != -1; ++i, index = self.nextCommandLine(index)) {
+						auto cmd = self.get(index);
+						ok &= isPOP(cmd).has_value();
+						newCmds.push_back(cmd);
+					}
+					ok &= i == n;
+					if (ok) {
+						std::reverse(newCmds.begin(), newCmds.end());
+						std::set<int> uniqInds;
+						int deltaSi = n - 1;
+						for (i = 0; i < n; ++i) {
+							int si = isPOP(newCmds[i]).value();
+							int newSi = si + deltaSi;
+							ok &= newSi >= n - i;
+							if (!ok) {
+								break;
+							}
+							newCmds[i] = makePOP(newSi);
+							deltaSi -= 2;
+							uniqInds.insert(newSi + i);
+						}
+						ok &= static_cast<int>(uniqInds.size()) == n;
+						if (ok) {
+							return Result{Rule::ReversePopSequence, n + 1, newCmds};
+						}
+					}
+				}
+			}
+			return {};
+		}},
 
-	// s01
-	// XCHG S1, S2
-	// =>
-	// SWAP
-	// s01
-	if (isPureGen01(*cmd1) &&
-		isXCHG(cmd2, 1, 2)
-	) {
-		return Result{2, makeBLKSWAP(1, 1), cmd1};
-	}
+		// BLKSWAP n, 1
+		// POP n+1
+		// ...
+		// POP n+1 // n times
+		// =>
+		// BLKDROP2 n, n+1
+		{0, swaps, [](PrivatePeepholeOptimizer const& self, Window const& w) -> std::optional<Result> {
+			if (isBLKSWAP(w.cmd1) && w.idx2 != -1) {
+				auto [n, up] = isBLKSWAP(w.cmd1).value();
+				if (up == 1) {
+					int index = w.idx2;
+					bool ok = true;
+					int i = 0;
+					for (; ok && i < n && index != -1; ++i, index = self.nextCommandLine(index)) {
+						auto cmd = self.get(index);
+						ok &= isPOP(cmd).has_value() && isPOP(cmd) == n + 1;
+					}
+					ok &= i == n;
+					if (ok) {
+						return Result{Rule::BlkSwapPopSequenceToBlkDrop2, n + 1, makeBLKDROP2(n, n + 1)};
+					}
+				}
+			}
+			return {};
+		}},
 
-	// DUP
-	// PUSHCONT {
-	//   DROP
-	//   TRUE
-	// }
-	// IF
-	// =>
-	//
-	if (isPUSH1 && *isPUSH1 == 0) {
-		if (auto lc = to<LogCircuit>(cmd2.get())) {
-			if (lc->type() == LogCircuit::Type::AND && lc->body()->instructions().size() == 2) {
-				auto cmd2_0 = lc->body()->instructions().at(0);
-				auto cmd2_1 = lc->body()->instructions().at(1);
-				auto _true = to<StackOpcode>(cmd2_1.get());
-				if (isDrop(cmd2_0) == 1 && _true && _true->opcode() == "TRUE") {
-					return Result{2};
+		// ROLL n
+		// ROLL n+1
+		// ROLL n+2
+		// ...
+		// =>
+		// BLKSWAP qty, n
+		// REVERSE qty, 0
+		{0, swaps, [](PrivatePeepholeOptimizer const& self, Window const& w) -> std::optional<Result> {
+			if (isBLKSWAP(w.cmd1)) {
+				auto [down, up] = isBLKSWAP(w.cmd1).value();
+				if (down == 1) {
+					int i = self.nextCommandLine(w.idx1);
+					int targetUp = up + 1;
+					int qty = 1;
+					while (true) {
+						if (i == -1 || !isBLKSWAP(self.get(i)))
+							break;
+						auto [downi, upi] = isBLKSWAP(self.get(i)).value();
+						if (downi != 1 || upi != targetUp)
+							break;
+						++targetUp;
+						i = self.nextCommandLine(i);
+						++qty;
+					}
+					if (qty >= 2) {
+						return Result{Rule::RollSequenceToBlkSwapReverse, qty, makeBLKSWAP(qty, up), makeREVERSE(qty, 0)};
+					}
 				}
 			}
-		}
-	}
+			return {};
+		}},
+
+		// squash stack opcodes
+		{0, {OpKind::Stack}, [](PrivatePeepholeOptimizer const& self, Window const& w) -> std::optional<Result> {
+			struct BestResult {
+				StackState bestState;
+				int bestStartStackSize = 0;
+				int bestOpcodeQty = 0;
+			};
+			std::optional<BestResult> bestResult;
 
-	// TRUE
-	// AND
-	// =>
-	//
-	auto _true = to<StackOpcode>(cmd1.get());
-	auto _and = to<StackOpcode>(cmd2.get());
-	if (_true && _true->opcode() == "TRUE" &&
-		_and && _and->opcode() == "AND") {
-		return Result{2};
-	}
+			for (int startStackSize = 0; startStackSize <= StackState::MAX_STACK_DEPTH; ++startStackSize)
+			{
+				StackState state{startStackSize};
+				int i = w.idx1;
+				int gasCost = 0;
+				int opcodeQty = 0;
+				while (true) {
+					if (i == -1)
+						break;
+					auto stack = dyn_cast<Stack>(self.get(i).get());
+					if (!stack)
+						break;
+					if (!state.apply(*stack)) {
+						break;
+					}
 
-	// NULL
-	// ISNULL
-	// =>
-	// TRUE
-	if (is(cmd1, "NULL") && is(cmd2, "ISNULL")) {
-		return Result{2, gen("TRUE")};
-	}
+					++opcodeQty;
+					gasCost += OpcodeUtils::gasCost(*stack);
+					auto newGasCost = StackOpcodeSquasher::gasCost(startStackSize, state, self.m_flags.test(OptFlags::UseCompoundOpcodes));
+					if (newGasCost.has_value() && newGasCost < gasCost) {
+						bestResult = BestResult{state, startStackSize, opcodeQty};
+					}
 
-	// TRUE       / FALSE
-	// THROWIFNOT / THROWIF
-	// =>
-	//
-	if ((is(cmd1, "TRUE") && isExc(cmd2, "THROWIFNOT")) || (is(cmd1, "FALSE") && isExc(cmd2, "THROWIF"))) {
-		return Result{2};
-	}
+					i = self.nextCommandLine(i);
+				}
+			}
 
-	// PUSHINT N
-	// ISNULL
-	// =>
-	// FALSE
-	if (is(cmd1, "PUSHINT") && is(cmd2, "ISNULL")) {
-		return Result{2, gen("FALSE")};
-	}
+			if (bestResult.has_value()) {
+				auto newOpcodes = StackOpcodeSquasher::recover(bestResult.value().bestStartStackSize,
+															   bestResult.value().bestState,
+															   self.m_flags.test(OptFlags::UseCompoundOpcodes));
+				return Result{Rule::SquashStackOpcodes, bestResult.value().bestOpcodeQty, newOpcodes};
+			}
 
-	// TRUE    / FALSE
-	// THROWIF / THROWIFNOT
-	// =>
-	//
-	if ((is(cmd1, "TRUE") && isExc(cmd2, "THROWIF")) || (is(cmd1, "FALSE") && isExc(cmd2, "THROWIFNOT"))) {
-		return Result{2, makeTHROW("THROW " + cmd2Exc->arg())};
-	}
+			return {};
+		}},
+
+		// squash permutation of pure operations
+		{0, gensAndPush, [](PrivatePeepholeOptimizer const& self, Window const& w) -> std::optional<Result> {
+			// pure gen, get glob, push Si
+			// BLKSWAP, REVERSE, XCHG
+			std::deque<std::pair<Pointer<TvmAstNode>, int>> opcodes;
+			bool removed = false;
+			int cnt = 0;
+
+			for (int ii = w.idx1; ii != -1; ii = self.nextCommandLine(ii)) {
+				TvmAstNode const* op = self.get(ii).get();
+				auto stack = dyn_cast<Stack>(op);
+				if (isPureGen01(*op)) {
+					opcodes.emplace_front(self.get(ii), opcodes.size());
+					++cnt;
+				} else if (stack) {
+					int i = stack->i();
+					int j = stack->j();
+					int n = opcodes.size();
+					bool ok = true;
+					switch (stack->opcode()) {
+						case Stack::Opcode::BLKSWAP: {
+							if (i + j <= n) {
+								std::reverse(opcodes.begin() + j, opcodes.begin() + j + i);
+								std::reverse(opcodes.begin() , opcodes.begin() + j);
+								std::reverse(opcodes.begin(), opcodes.begin() + j + i);
+								removed = true;
+								++cnt;
+							} else {
+								ok = false;
+							}
+							break;
+						}
+						case Stack::Opcode::REVERSE: {
+							if (j < n && j + i <= n) {
+								std::reverse(opcodes.begin() + j, opcodes.begin() + j + i);
+								removed = true;
+								++cnt;
+							} else {
+								ok = false;
+							}
+							break;
+						}
+						case Stack::Opcode::XCHG: {
+							if (i < n && j < n) {
+								swap(opcodes[i], opcodes[j]);
+								removed = true;
+								++cnt;
+							} else {
+								ok = false;
+							}
+							break;
+						}
+						case Stack::Opcode::PUSH_S: {
+							if (i >= n) {
+								opcodes.emplace_front(self.get(ii), opcodes.size());
+								++cnt;
+							} else {
+								ok = false;
+							}
+							break;
+						}
+						// TODO implement another cases
+						default:
+							ok = false;
+							break;
+					}
+					if (!ok) {
+						break;
+					}
+				} else {
+					break;
+				}
+			}
 
-	// pure gen(1, 1)
-	// DROP N
-	// =>
-	// DROP N
-	if (cmd1GenOp && cmd1GenOp->isPure() &&
-		std::make_pair(cmd1GenOp->take(), cmd1GenOp->ret()) == std::make_pair(1, 1) &&
-		isDrop(cmd2)
-	) {
-		return Result{2, cmd2};
-	}
+			if (removed) {
+				vector<Pointer<TvmAstNode>> res;
+				res.reserve(opcodes.size());
+				for (auto const& [opcode, stackSize]  : opcodes | boost::adaptors::reversed) {
+					if (isPUSH(opcode)) {
+						int index = isPUSH(opcode).value();
+						int newStackSize = res.size();
+						int newIndex = index - stackSize + newStackSize;
+						res.emplace_back(makePUSH(newIndex));
+					} else {
+						res.emplace_back(opcode);
+					}
+				}
+				return Result{Rule::SquashPurePermutation, cnt, res};
+			}
 
-	// ABS
-	// MODPOW2 256
-	// =>
-	// ABS
-	if (is(cmd1, "ABS") &&
-		cmd2GenOpcode && cmd2GenOpcode->opcode() == "MODPOW2" && cmd2GenOpcode->arg() == "256"
-	) {
-		return Result{2, gen("ABS")};
-	}
+			return {};
+		}},
+
+		{2, swaps, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd2GenOpcode = dyn_cast<StackOpcode>(w.cmd2.get());
+			if (isSWAP(w.cmd1)) {
+				if (is(w.cmd2, "STU")) return Result{Rule::SwapToReverseOp, 2, gen("STUR " + arg(w.cmd2))};
+				if (is(w.cmd2, "STSLICE")) return Result{Rule::SwapToReverseOp, 2, gen("STSLICER")};
+				if (is(w.cmd2, "SUB")) return Result{Rule::SwapToReverseOp, 2, gen("SUBR")};
+				if (is(w.cmd2, "SUBR")) return Result{Rule::SwapToReverseOp, 2, gen("SUB")};
+				if (isCommutative(w.cmd2)) return Result{Rule::SwapCommutativeOp, 1};
+				if (cmd2GenOpcode &&
+					boost::starts_with(cmd2GenOpcode->opcode(), "ST") &&
+					boost::ends_with(cmd2GenOpcode->opcode(), "R") &&
+					cmd2GenOpcode->take() == 2 &&
+					cmd2GenOpcode->ret() == 1
+				) {
+					auto opcode = cmd2GenOpcode->opcode();
+					opcode = opcode.substr(0, opcode.size() - 1);
+					return Result{Rule::SwapToReverseOp, 2, gen(opcode + " " + arg(w.cmd2))};
+				}
+			}
+			return {};
+		}},
+
+		{2, {"PUSHINT"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (is(w.cmd1, "PUSHINT")) {
+				if (arg(w.cmd1) == "1") {
+					if (is(w.cmd2, "ADD")) return Result{Rule::PushIntOneToIncDec, 2, gen("INC")};
+					if (is(w.cmd2, "SUB")) return Result{Rule::PushIntOneToIncDec, 2, gen("DEC")};
+				}
+				bigint value = pushintValue(w.cmd1);
+				if (-128 <= value && value <= 127) {
+					if (is(w.cmd2, "ADD")) return Result{Rule::PushIntToConstOp, 2, gen("ADDCONST " + toString(value))};
+					if (is(w.cmd2, "MUL")) return Result{Rule::PushIntToConstOp, 2, gen("MULCONST " + toString(value))};
+				}
+				if (-128 <= -value && -value <= 127) {
+					if (is(w.cmd2, "SUB")) return Result{Rule::PushIntToConstOp, 2, gen("ADDCONST " + toString(-value))};
+				}
+			}
+			return {};
+		}},
+
+		{2, {OpKind::Return, OpKind::Exception}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd1Ret = dyn_cast<TvmReturn>(w.cmd1.get());
+			if ((cmd1Ret && !cmd1Ret->withIf()) || isExc(w.cmd1, "THROWANY", "THROW")) {
+				// delete commands after non return opcode
+				return Result{Rule::DeadCodeAfterReturn, 2, w.cmd1};
+			}
+			return {};
+		}},
 
-	// MODPOW2 x
-	// MODPOW2 y
-	// =>
-	// MODPOW2 min(x, y)
-	if (is(cmd1, "MODPOW2") && is(cmd2, "MODPOW2")) {
-		int x = fetchInt(cmd1);
-		int y = fetchInt(cmd2);
-		return Result{2, gen("MODPOW2 " + toString(std::min(x, y)))};
-	}
+		{2, pushes, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto isPUSH1 = isPUSH(w.cmd1);
+			if (isPUSH1 && *isPUSH1 == 0 && isSWAP(w.cmd2)) {
+				return Result{Rule::DupSwap, 2, w.cmd1};
+			}
+			return {};
+		}},
 
-	// BLKPUSH N, 0 / DUP
-	// BLKPUSH Q, 0 / DUP
-	// =>
-	// BLKPUSH N+Q, 0
-	if (m_flags.test(OptFlags::UseCompoundOpcodes) && isBLKPUSH(cmd1) && isBLKPUSH(cmd2)) {
-		auto [qty0, index0] = isBLKPUSH(cmd1).value();
-		auto [qty1, index1] = isBLKPUSH(cmd2).value();
-		if (index0 == 0 && index1 == 0 && qty0 + qty1 <= 15)
-			return Result{2, makeBLKPUSH(qty0 + qty1, 0)};
-	}
+		// POP Sn
+		// DROP n-1
+		// =>
+		// BLKDROP2 n, 1
+		{2, pops, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (isPOP(w.cmd1) && isDrop(w.cmd2) && isPOP(w.cmd1).value() == isDrop(w.cmd2).value() + 1) {
+				int n = isPOP(w.cmd1).value();
+				if (1 <= n && n <= 15) {
+					return Result{Rule::PopDropToBlkDrop2, 2, makeBLKDROP2(n, 1)};
+				}
+			}
+			return {};
+		}},
+
+		// SWAP
+		// POP S2
+		//
+		// BLKDROP2 1, 2
+		{2, swaps, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (isSWAP(w.cmd1) && isPOP(w.cmd2) && isPOP(w.cmd2).value() == 2) {
+				return Result{Rule::SwapPopToBlkDrop2, 2, makeBLKDROP2(1, 2)};
+			}
+			return {};
+		}},
+
+		// PUSH Si | gen01
+		// DROP N
+		//
+		// DROP N-1
+		{2, gensAndPushes, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if ((isPUSH(w.cmd1) || isPureGen01(*w.cmd1)) && isDrop(w.cmd2)) {
+				int qty = isDrop(w.cmd2).value();
+				if (qty == 1) {
+					return Result{Rule::PushDrop, 2};
+				} else {
+					return Result{Rule::PushDrop, 2, makeDROP(qty - 1)};
+				}
+			}
+			return {};
+		}},
+
+		// BLKPUSH N, index / DROP
+		// BLKDROP N
+		{2, pushes, [](PrivatePeepholeOptimizer const& self, Window const& w) -> std::optional<Result> {
+			auto isBLKPUSH1 = isBLKPUSH(w.cmd1);
+			if (self.m_flags.test(OptFlags::UseCompoundOpcodes) && isBLKPUSH1 && isDrop(w.cmd2)) {
+				auto [qty, index] = isBLKPUSH1.value();
+				int diff = qty - isDrop(w.cmd2).value();
+				if (diff == 0)
+					return Result{Rule::BlkPushDrop, 2};
+				if (diff < 0)
+					return Result{Rule::BlkPushDrop, 2, makeDROP(-diff)};
+				else
+					return Result{Rule::BlkPushDrop, 2, makeBLKPUSH(diff, index)};
+			}
+			return {};
+		}},
 
-	// LD[I|U] N / LDDICT / LDREF / LD[I|U]X N
-	// DROP
-	if ((is(cmd1, "LDU", "LDI", "LDREF", "LDDICT", "LDUX", "LDIX",
-			"LDSLICE", "LDSLICEX")) &&
-		isDrop(cmd2)
-	) {
-		// TODO add LD[I|U]LE[4|8]
-		int n = isDrop(cmd2).value();
-		Pointer<StackOpcode> newOpcode = gen("P" + cmd1GenOp->fullOpcode());
-		if (n == 1) {
-			return Result{2, newOpcode};
-		} else {
-			return Result{2, {newOpcode, makeDROP(n - 1)}};
-		}
-	}
+		// PUSH S[n-1]
+		// BLKDROP2 N, 1 / NIP
+		// =>
+		// DROP N-1
+		{2, pushes, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto _isBLKDROP2 = isBLKDROP2(w.cmd2);
+			auto isPUSH1 = isPUSH(w.cmd1);
+			if (isPUSH1 && _isBLKDROP2) {
+				int index = *isPUSH1;
+				auto [drop, rest] = _isBLKDROP2.value();
+
+				if (drop == index + 1 && rest == 1) {
+					if (drop == 1) {
+						return Result{Rule::PushBlkDrop2, 2};
+					} else {
+						return Result{Rule::PushBlkDrop2, 2, makeDROP(drop - 1)};
+					}
+				}
+			}
+			return {};
+		}},
 
-	// 26 + 118 gas units
-	// PLDREF
-	// CTOS
-	// =>
-	// 118 + 18 gas units
-	// LDREFRTOS
-	// NIP
-	if (is(cmd1, "PLDREF") && is(cmd2, "CTOS")) {
-		return Result{2, gen("LDREFRTOS"), makeBLKDROP2(1, 1)};
-	}
+		// s01
+		// BLKDROP2 N, M
+		// =>
+		// BLKDROP2 N, M-1
+		// s01
+		{2, gens, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto _isBLKDROP2 = isBLKDROP2(w.cmd2);
+			if (isPureGen01(*w.cmd1) && _isBLKDROP2) {
+				auto [down, up] = _isBLKDROP2.value();
+				return Result{Rule::Gen01BlkDrop2, 2, makeBLKDROP2(down, up - 1), w.cmd1};
+			}
+			return {};
+		}},
 
-	return {};
-}
+		// PUSH SN
+		// BLKDROP2 down, top
+		// =>
+		// BLKDROP2 down, top-1
+		// PUSH S?
+		{2, pushes, [](PrivatePeepholeOptimizer const& self, Window const& w) -> std::optional<Result> {
+			auto _isBLKDROP2 = isBLKDROP2(w.cmd2);
+			if (self.m_flags.test(OptFlags::UseCompoundOpcodes) && isPUSH(w.cmd1) && _isBLKDROP2) {
+				int n = *isPUSH(w.cmd1);
+				auto [down, top] = _isBLKDROP2.value();
+				if (n + 2 <= top)
+					return Result{Rule::PushBlkDrop2Reorder, 2, makeBLKDROP2(down, top - 1), w.cmd1};
+				else if (n >= down + top - 1)
+					return Result{Rule::PushBlkDrop2Reorder, 2, makeBLKDROP2(down, top - 1), makePUSH(n - down)};
+			}
+			return {};
+		}},
 
-std::optional<Result> PrivatePeepholeOptimizer::optimizeAt3(Pointer<TvmAstNode> const& cmd1, Pointer<TvmAstNode> const& cmd2,
-											 Pointer<TvmAstNode> const& cmd3) const {
-	auto isPUSH1 = isPUSH(cmd1);
-	auto cmd1PushCellOrSlice = to<PushCellOrSlice>(cmd1.get());
-	auto isPUSH2 = isPUSH(cmd2);
-	auto cmd2PushCellOrSlice = to<PushCellOrSlice>(cmd2.get());
-	auto cmd3GenOpcode = to<StackOpcode>(cmd3.get());
-	auto cmd3SubProgram = to<SubProgram>(cmd3.get());
-
-	// NEW
-	// s01
-	// ST**R
-	// =>
-	// s01
-	// NEW
-	// ST**
-	if (
-		is(cmd1, "NEWC") &&
-		isSimpleCommand(cmd2) &&
-		cmd3GenOpcode &&
-		boost::starts_with(cmd3GenOpcode->opcode(), "ST") && boost::ends_with(cmd3GenOpcode->opcode(), "R")
-	) {
-		const auto& opcode = cmd3GenOpcode->opcode();
-		return Result{3,
-					  cmd2,
-					  gen("NEWC"),
-					  gen(opcode.substr(0, opcode.size() - 1) + " " + arg(cmd3))};
-	}
-	// DUP
-	// THROWIFNOT 507
-	// DROP n
-	if (isPUSH1 && *isPUSH1 == 0 &&
-		isExc(cmd2, "THROWIFNOT", "THROWIF") &&
-		isDrop(cmd3)
-	) {
-		int n = isDrop(cmd3).value();
-		if (n == 1) {
-			return Result{3, cmd2};
-		} else {
-			return Result{3, cmd2, makeDROP(n - 1)};
-		}
-	}
-	if (
-		is(cmd1, "NEWC") &&
-		is(cmd2, "STSLICECONST") && arg(cmd2).length() > 1 &&
-		is(cmd3, "ENDC")
-	) {
-		return Result{3, makePUSHREF(arg(cmd2))};
-	}
+		// BLKPUSH
+		// BLKDROP2
+		// =>
+		// ???
+		{2, pushes, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto _isBLKDROP2 = isBLKDROP2(w.cmd2);
+			auto isBLKPUSH1 = isBLKPUSH(w.cmd1);
+			if (isBLKPUSH1 && _isBLKDROP2) {
+				auto [qty, index] = isBLKPUSH1.value();
+				auto [drop, rest] = _isBLKDROP2.value();
+
+				// BLKPUSH  qty, qty-1
+				// BLKDROP2 qty+X, qty
+				// =>
+				// BLKDROP2 X, qty
+				if (qty == index + 1 && rest == qty) {
+					if (drop == qty) {
+						return Result{Rule::BlkPushBlkDrop2, 2};
+					} else if (drop > qty) {
+						return Result{Rule::BlkPushBlkDrop2, 2, makeBLKDROP2(drop - qty, qty)};
+					}
+				}
 
-	// PUSHINT x
-	// PUSH Si (i!=0) or gen(0,1)
-	// CMP
-	// =>
-	// PUSH S(i-1) or gen(0,1)
-	// CMP2
-	if (is(cmd1, "PUSHINT") && ((isPUSH2 && *isPUSH2 != 0) || isPureGen01(*cmd2))) {
-		auto newCmd2 = isPUSH2 ? makePUSH(*isPUSH2 - 1) : cmd2;
-		bigint val = pushintValue(cmd1);
-		if (-128 <= val && val < 128) {
-			if (is(cmd3, "NEQ"))
-				return Result{3, newCmd2, gen("NEQINT " + toString(val))};
-			if (is(cmd3, "EQUAL"))
-				return Result{3, newCmd2, gen("EQINT " + toString(val))};
-			if (is(cmd3, "GREATER"))
-				return Result{3, newCmd2, gen("LESSINT " + toString(val))};
-			if (is(cmd3, "LESS"))
-				return Result{3, newCmd2, gen("GTINT " + toString(val))};
-		}
-		if (-128 <= val + 1 && val + 1 < 128 && is(cmd3, "GEQ"))
-			return Result{3, newCmd2, gen("LESSINT " + toString(val + 1))};
-		if (-128 <= val - 1 && val - 1 < 128 && is(cmd3, "LEQ"))
-			return Result{3, newCmd2, gen("GTINT " + toString(val - 1))};
-	}
-	// PUSHINT A
-	// PUSHINT B
-	// ADD | MUL
-	//
-	// PUSHINT A+B | PUSHINT A*B
-	if (is(cmd1, "PUSHINT") &&
-		is(cmd2, "PUSHINT") &&
-		cmd3GenOpcode && isIn(cmd3GenOpcode->opcode(), "ADD", "MUL", "MAX")
-	) {
-		bigint a = pushintValue(cmd1);
-		bigint b = pushintValue(cmd2);
-		bigint c;
-		if (cmd3GenOpcode->opcode() == "ADD")
-			c = a + b;
-		else if (cmd3GenOpcode->opcode() == "MUL")
-			c = a * b;
-		else if (cmd3GenOpcode->opcode() == "MAX")
-			c = std::max(a, b);
-		else
-			solUnimplemented("");
-		return Result{3, gen("PUSHINT " + toString(c))};
-	}
-	// PUSHINT A
-	// PUSHINT B
-	// DIV
-	//
-	// PUSHINT A/B
-	if (is(cmd1, "PUSHINT") &&
-		is(cmd2, "PUSHINT") &&
-		cmd3GenOpcode && cmd3GenOpcode->opcode() == "DIV"
-	) {
-		bigint a = pushintValue(cmd1);
-		bigint b = pushintValue(cmd2);
-		if (a >= 0 && b > 0) { // note in TVM  -9 / 2 == -5
-			bigint c = a / b;
-			return Result{3, gen("PUSHINT " + toString(c))};
-		}
-	}
+				// BLKPUSH   qty, index
+				// BLKDROP2 drop, qty
+				// =>
+				// DROP X, qty
+				if (qty == rest) {
+					int lastIndex = index - qty + 1; // include
+					if (lastIndex >= 0 && lastIndex + qty == drop) {
+						// a b c d e f X Y |
+						// X Y a b c d e f X Y | BLKPUSH
+						// X Y | BLKDROP2
+						int newDrop = lastIndex;
+						return Result{Rule::BlkPushBlkDrop2, 2, makeDROP(newDrop)};
+					}
+				}
+			}
+			return {};
+		}},
 
-	// PUSHINT
-	// PUSH SN / gen01
-	// ADD / MUL
-	//
-	// PUSH S(N-1) / gen01
-	// ADDCONST / MULCONST
-	if (is(cmd1, "PUSHINT") &&
-		(is(cmd3, "ADD") || is(cmd3, "MUL"))
-	) {
-		bigint val = pushintValue(cmd1);
-		if (-128 <= val && val <= 127) {
-			if ((isPureGen01(*cmd2) && to<StackOpcode>(cmd2.get())) ||
-				to<Glob>(cmd2.get()) ||
-				isPUSH(cmd2)
+		// DUP
+		// BLKDROP2 n, 1
+		// =>
+		// BLKDROP2 n-1, 1
+		// Same as prev
+		{2, pushes, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto _isBLKDROP2 = isBLKDROP2(w.cmd2);
+			auto isPUSH1 = isPUSH(w.cmd1);
+			if (isPUSH1 && *isPUSH1 == 0 &&
+				_isBLKDROP2 && _isBLKDROP2.value().second == 1
 			) {
-				Pointer<TvmAstNode> newCmd;
-				if (to<StackOpcode>(cmd2.get()) ||
-					to<Glob>(cmd2.get())
-				) {
-					newCmd = cmd2;
-				} else if (auto index = isPUSH(cmd2); index.has_value() && *index > 0) {
-					newCmd = makePUSH(*index - 1);
+				int n = _isBLKDROP2.value().first;
+				if (n == 1) {
+					return Result{Rule::DupBlkDrop2, 2};
+				} else {
+					return Result{Rule::DupBlkDrop2, 2, makeBLKDROP2(n - 1, 1)};
 				}
-				if (newCmd)
-					return Result{3,  newCmd, gen((is(cmd3, "ADD") ? "ADDCONST " : "MULCONST ") + toString(val))};
 			}
-		}
-	}
-
-	// TRUE
-	// NEWC
-	// STI 1
-	if ((is(cmd1, "TRUE") || is(cmd1, "FALSE")) &&
-		is(cmd2, "NEWC") &&
-		is(cmd3, "STI") && arg(cmd3) == "1"
-	) {
-		if (is(cmd1, "TRUE"))
-			return Result{3, gen("NEWC"), gen("STSLICECONST 1")};
-		return Result{3, gen("NEWC"), gen("STSLICECONST 0")};
-	}
-
-	if (
-		isBLKSWAP(cmd1) &&
-		isPureGen01(*cmd2) &&
-		isBLKSWAP(cmd3)
-	) {
-		auto [bottom1, top1] = isBLKSWAP(cmd1).value();
-		auto [bottom3, top3] = isBLKSWAP(cmd3).value();
-		if (bottom1 == 1 && bottom3 == 1 && top3 == 1) {
-			return Result{3, cmd2, makeBLKSWAP(bottom1, top1 + 1)};
-		}
-	}
-
-	if (is(cmd1, "NULL") && isPUSH2 && *isPUSH2 == 0 && is(cmd3, "ISNULL")) {
-		return Result{3, gen("NULL"), gen("TRUE")};
-	}
+			return {};
+		}},
 
-	// gen(0, 1)
-	// BLKPUSH N, 0
-	// gen(0, 1)
-	// =>
-	// gen(0, 1)
-	// BLKPUSH N+1, 0
-	if (m_flags.test(OptFlags::UseCompoundOpcodes) && // ?
-		isPureGen01(*cmd1) &&
-		isBLKPUSH(cmd2) &&
-		isPureGen01(*cmd3) &&
-		*cmd1 == *cmd3
-	) {
-		auto [qty, index] = isBLKPUSH(cmd2).value();
-		if (index == 0 && qty + 1 <= 15) {
-			return Result{3, cmd1, makeBLKPUSH(qty + 1, index)};
-		}
-	}
-
-	//            ; a b
-	// SWAP       ; b a
-	// gen(0, 1)  ; b a c
-	// ROT        ; a c b
-	// =>
-	// gen(0,1)
-	// SWAP
-	if (isSWAP(cmd1)) {
-		std::optional<std::pair<int, int>> rot = isBLKSWAP(cmd3);
-		if (rot && *rot == std::make_pair(1, 2)) {
-			if (isPureGen01(*cmd2)) {
-				return Result{3, cmd2, makeXCH_S(1)};
+		// NIP
+		// DROP n
+		// =>
+		// DROP n+1
+		{2, pops, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (isNIP(w.cmd1) && isDrop(w.cmd2)) {
+				return Result{Rule::NipDrop, 2, makeDROP(isDrop(w.cmd2).value() + 1)};
 			}
-		}
-	}
-
-
-	if (cmd1PushCellOrSlice && cmd1PushCellOrSlice->type() == PushCellOrSlice::Type::PUSHREF &&
-		cmd2PushCellOrSlice && cmd2PushCellOrSlice->type() == PushCellOrSlice::Type::PUSHREF
-	) {
-		if (cmd3SubProgram) {
-			std::vector<Pointer<TvmAstNode>> const& instructions = cmd3SubProgram->block()->instructions();
-			if (instructions.size() == 1 &&
-				*instructions.at(0) == *createNode<StackOpcode>(".inline __concatenateStrings", 2, 1)) {
-				string hexStr = cmd1PushCellOrSlice->chainBlob() + cmd2PushCellOrSlice->chainBlob();
-				return Result{3, makePushCellOrSlice(hexStr, false)};
+			return {};
+		}},
+
+		// NOT THROWIFNOT/THROWIF N => THROWIF/THROWIFNOT N
+		// NOT PUSHCONT {} IF/IFNOT => PUSHCONT {} IFNOT/IF
+		{2, {"NOT"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd2Exc = dyn_cast<TvmException>(w.cmd2.get());
+			auto cmd2IfElse = dyn_cast<TvmIfElse>(w.cmd2.get());
+			if (is(w.cmd1, "NOT")) {
+				if (isExc(w.cmd2, "THROWIF"))
+					return Result{Rule::NotCondition, 2, makeTHROW("THROWIFNOT " + cmd2Exc->arg())};
+				if (isExc(w.cmd2, "THROWIFNOT"))
+					return Result{Rule::NotCondition, 2, makeTHROW("THROWIF " + cmd2Exc->arg())};
+				if (cmd2IfElse)
+					return Result{Rule::NotCondition, 2, flipIfElse(*cmd2IfElse)};
 			}
-		}
-	}
+			return {};
+		}},
+
+		// EQINT 0 THROWIFNOT/THROWIF N => THROWIF/THROWIFNOT N
+		// EQINT 0 PUSHCONT {} IF/IFNOT => PUSHCONT {} IFNOT/IF
+		{2, {"EQINT"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd1GenOp = dyn_cast<StackOpcode>(w.cmd1.get());
+			auto cmd2Exc = dyn_cast<TvmException>(w.cmd2.get());
+			auto cmd2IfElse = dyn_cast<TvmIfElse>(w.cmd2.get());
+			if (is(w.cmd1, "EQINT") && cmd1GenOp->arg() == "0") {
+				if (isExc(w.cmd2, "THROWIF"))
+					return Result{Rule::EqIntZeroCondition, 2, makeTHROW("THROWIFNOT " + cmd2Exc->arg())};
+				if (isExc(w.cmd2, "THROWIFNOT"))
+					return Result{Rule::EqIntZeroCondition, 2, makeTHROW("THROWIF " + cmd2Exc->arg())};
+				if (cmd2IfElse)
+					return Result{Rule::EqIntZeroCondition, 2, flipIfElse(*cmd2IfElse)};
+			}
+			return {};
+		}},
+
+		// NEQINT 0, THROWIF/THROWIFNOT N => THROWIF/THROWIFNOT N
+		// NEQINT 0, PUSHCONT {} IF => PUSHCONT {} IF
+		{2, {"NEQINT"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd1GenOp = dyn_cast<StackOpcode>(w.cmd1.get());
+			auto cmd2Exc = dyn_cast<TvmException>(w.cmd2.get());
+			auto cmd2IfElse = dyn_cast<TvmIfElse>(w.cmd2.get());
+			if (is(w.cmd1, "NEQINT") && cmd1GenOp->arg() == "0") {
+				if (isExc(w.cmd2, "THROWIF"))
+					return Result{Rule::NeqIntZeroCondition, 2, makeTHROW("THROWIF " + cmd2Exc->arg())};
+				if (isExc(w.cmd2, "THROWIFNOT"))
+					return Result{Rule::NeqIntZeroCondition, 2, makeTHROW("THROWIFNOT " + cmd2Exc->arg())};
+				if (cmd2IfElse)
+					return Result{Rule::NeqIntZeroCondition, 2, w.cmd2};
+			}
+			return {};
+		}},
+
+		// TRUE
+		// PUSHCONT {} / PUSHREF {}
+		// ...
+		// IF / IFJMP / IFELSE / IFELSE_WITH_JMP
+		{2, {"TRUE"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd2IfElse = dyn_cast<TvmIfElse>(w.cmd2.get());
+			if (is(w.cmd1, "TRUE") && cmd2IfElse && !cmd2IfElse->withNot()) {
+				auto subProg = createNode<SubProgram>(0, cmd2IfElse->ret(), cmd2IfElse->withJmp(), cmd2IfElse->trueBody(), false);
+				return Result{Rule::TrueCondition, 2, subProg};
+			}
+			return {};
+		}},
+
+		// BLKSWAP  down, up
+		// BLKDROP2 drop, rest where drop==up and rest==down
+		// ...
+		// DROP up
+		{2, swaps, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (isBLKSWAP(w.cmd1) && isBLKDROP2(w.cmd2)) {
+				auto [down, up] = isBLKSWAP(w.cmd1).value();
+				auto [drop, rest] = isBLKDROP2(w.cmd2).value();
+				if (drop==up && rest==down)
+					return Result{Rule::BlkSwapBlkDrop2, 2, makeDROP(up)};
+			}
+			return {};
+		}},
+
+		// BLKDROP2 drop, rest
+		// BLKDROP rest + some
+		// ...
+		// BLKDROP drop + rest + some
+		{2, pops, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (isBLKDROP2(w.cmd1) && isDrop(w.cmd2)) {
+				auto [drop, rest] = isBLKDROP2(w.cmd1).value();
+				int n = isDrop(w.cmd2).value();
+				int some = n - rest;
+				if (some >= 0)
+					return Result{Rule::BlkDrop2Drop, 2, makeDROP(drop + rest + some)};
+			}
+			return {};
+		}},
 
-	// TODO delete, fix in stackOpt
-	// Note: breaking stack
-	// DUP
-	// IFREF { CALL $c7_to_c4$ / $upd_only_time_in_c4$ }
-	// =>
-	// IFREF { CALL $c7_to_c4$ / $upd_only_time_in_c4$ }
-	if (m_flags.test(OptFlags::UnpackOpaque) && isPUSH(cmd1)) {
-		if (auto ifRef = to<TvmIfElse>(cmd2.get());
-			ifRef && !ifRef->withJmp() && !ifRef->withNot() && ifRef->falseBody() == nullptr
-		) {
-			std::vector<Pointer<TvmAstNode>> const &cmds = ifRef->trueBody()->instructions();
-			if (cmds.size() == 1) {
-				if (auto gen = to<StackOpcode>(cmds.at(0).get())) {
-					if (isIn(gen->fullOpcode(), ".inline c7_to_c4", ".inline upd_only_time_in_c4")) {
-						return Result{2, cmd2};
+		// BLKSWAP down, up
+		// DROP down
+		// =>
+		// BLKDROP down, up
+		{2, swaps, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (isBLKSWAP(w.cmd1) && isDrop(w.cmd2)) {
+				auto [down, up] = isBLKSWAP(w.cmd1).value();
+				int n = isDrop(w.cmd2).value();
+				if (n == down)
+					return Result{Rule::BlkSwapDrop, 2, makeBLKDROP2(down, up)};
+			}
+			return {};
+		}},
+
+		{2, swaps, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (isBLKSWAP(w.cmd1) && isBLKSWAP(w.cmd2)) {
+				auto [down1, top1] = isBLKSWAP(w.cmd1).value();
+				auto [down2, top2] = isBLKSWAP(w.cmd2).value();
+				if (down1 + top1 == down2 + top2) {
+					// BLKSWAP down1, top1 where down1 + top1 == n
+					// BLKSWAP     1, n-1
+					// ...
+					// BLKSWAP down1+1, top1-1
+					if (down2 == 1) {
+						if (top1 == 1) {
+							return Result{Rule::BlkSwapBlkSwap, 2};
+						} else {
+							return Result{Rule::BlkSwapBlkSwap, 2, makeBLKSWAP(down1 + 1, top1 - 1)};
+						}
+					}
+					// BLKSWAP down1, top1  where down1 + top1 == n
+					// BLKSWAP n-1,    1
+					// ...
+					// BLKSWAP down1-1, top1+1
+					if (top2 == 1) {
+						if (down1 == 1) {
+							return Result{Rule::BlkSwapBlkSwap, 2};
+						} else {
+							return Result{Rule::BlkSwapBlkSwap, 2, makeBLKSWAP(down1 - 1, top1 + 1)};
+						}
 					}
 				}
 			}
-		}
-	}
+			return {};
+		}},
 
-	return {};
-}
+		{2, {"TUPLE"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (is(w.cmd1, "TUPLE") &&
+				is(w.cmd2, "UNTUPLE") &&
+				fetchInt(w.cmd1) == fetchInt(w.cmd2))
+			{
+				return Result{Rule::TupleUntuple, 2};
+			}
+			return {};
+		}},
 
-std::optional<Result> PrivatePeepholeOptimizer::optimizeAt4(Pointer<TvmAstNode> const& cmd1, Pointer<TvmAstNode> const& cmd2,
-											 Pointer<TvmAstNode> const& cmd3, Pointer<TvmAstNode> const& cmd4) const {
-	auto cmd3Exc = to<TvmException>(cmd3.get());
-
-	if (is(cmd1, "PUSHINT") && is(cmd3, "PUSHINT")) {
-		if (isAddOrSub(cmd2) && isAddOrSub(cmd4)) {
-			bigint sum = 0;
-			sum += (is(cmd2, "ADD") ? +1 : -1) * pushintValue(cmd1);
-			sum += (is(cmd4, "ADD") ? +1 : -1) * pushintValue(cmd3);
-			// TODO DELETE
-			return Result{4, gen("PUSHINT " + toString(sum)), gen("ADD")};
-		}
-	}
-	if (isPlainPushSlice(cmd1) &&
-		is(cmd2, "NEWC") &&
-		is(cmd3, "STSLICECONST") &&
-		is(cmd4, "STSLICE")) {
-		std::optional<std::string> slice = StrUtils::unitSlices(arg(cmd3), isPlainPushSlice(cmd1)->blob());
-		if (slice.has_value()) {
-			return Result{4,
-						  genPushSlice(*slice),
-						   gen("NEWC"),
-						   gen("STSLICE")};
-		}
-	}
-	// TODO if value on the top of the stack < 0
-	// ADDCONST/INC/DEC
-	// UFIT/FIT N
-	// ADDCONST/INC/DEC
-	// UFIT/FIT N
-	// =>
-	// ADDCONST
-	// UFIT/FIT N
-	if (isConstAdd(cmd1) && isConstAdd(cmd3)) {
-		for (std::string fit : {"UFITS", "FITS"}) {
-			if (is(cmd2, fit) && is(cmd4, fit) && arg(cmd2) == arg(cmd4)) {
-				int final_add = getAddNum(cmd1) + getAddNum(cmd3);
-				if (-128 <= final_add && final_add <= 127)
-					return Result{4,
-										   gen("ADDCONST " + std::to_string(final_add)),
-										   gen(fit + " " + arg(cmd2))};
+		{2, {"UNTUPLE"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (is(w.cmd1, "UNTUPLE") &&
+				is(w.cmd2, "TUPLE") &&
+				fetchInt(w.cmd1) == fetchInt(w.cmd2))
+			{
+				return Result{Rule::UntupleTuple, 2};
 			}
-		}
-	}
+			return {};
+		}},
+
+		// SETGLOB N
+		// GETGLOB N
+		//
+		// DUP
+		// SETGLOB N
+		{2, {OpKind::Glob}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd1Glob = dyn_cast<Glob>(w.cmd1.get());
+			auto cmd2Glob = dyn_cast<Glob>(w.cmd2.get());
+			if (cmd1Glob && cmd1Glob->opcode() == Glob::Opcode::SetOrSetVar &&
+				cmd2Glob && cmd2Glob->opcode() == Glob::Opcode::GetOrGetVar &&
+				cmd1Glob->index() == cmd2Glob->index()
+			) {
+				return Result{Rule::SetGlobGetGlob, 2, makePUSH(0), makeSetGlob(cmd1Glob->index())};
+			}
+			return {};
+		}},
+
+		// PUSHINT N
+		// ADDCONST ? | INC | DEC
+		//
+		// PUSHINT (N+delta)
+		{2, {"PUSHINT"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (is(w.cmd1, "PUSHINT") && isConstAdd(w.cmd2)) {
+				bigint n = pushintValue(w.cmd1);
+				bigint delta = getAddNum(w.cmd2);
+				// TODO check overflow
+				return Result{Rule::PushIntConstAdd, 2, gen("PUSHINT " + toString(n + delta))};
+			}
+			return {};
+		}},
+
+		// PUSHINT N
+		// UFITS ? | FITS ?
+		//
+		// PUSHINT N
+		{2, {"PUSHINT"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (is(w.cmd1, "PUSHINT") && (is(w.cmd2, "UFITS") || is(w.cmd2, "FITS"))) {
+				bigint n = pushintValue(w.cmd1);
+				int bits = fetchInt(w.cmd2);
+				auto type = TypeProvider::integer(bits,
+												  is(w.cmd2, "UFITS") ? IntegerType::Modifier::Unsigned :
+												  						IntegerType::Modifier::Signed);
+				if (type->minValue() <= n && n <= type->maxValue())
+					return Result{Rule::PushIntFits, 2, gen("PUSHINT " + toString(n))};
+			}
+			return {};
+		}},
 
-	if (is(cmd1, "PUSHINT") &&
-		is(cmd2, "NEWC") &&
-		is(cmd3, "STSLICECONST") &&
-		is(cmd4, "STU", "STI")) {
-		std::string bitStr = StrUtils::toBitString(arg(cmd3));
-		if (auto x = StrUtils::toBitString(pushintValue(cmd1), fetchInt(cmd4), is(cmd4, "STI"))) {
-			bitStr += x.value();
-			std::optional<std::string> slice = StrUtils::unitBitStringToHex(bitStr, "");
-			if (slice.has_value())
-				return Result{4, genPushSlice(*slice), gen("NEWC"), gen("STSLICE")};
-		}
-	}
-	if (
-		isPlainPushSlice(cmd1) &&
-		is(cmd2, "NEWC") &&
-		is(cmd3, "STSLICE") &&
-		is(cmd4, "ENDC")
-	) {
-		return Result{4, makePUSHREF(isPlainPushSlice(cmd1)->blob())};
-	}
-	if (is(cmd1, "PUSHINT") && pushintValue(cmd1) == 0 &&
-		is(cmd2, "STUR") &&
-		is(cmd3, "PUSHINT") && pushintValue(cmd3) == 0 &&
-		is(cmd4, "STUR")
-	) {
-		int bitSize = fetchInt(cmd2) + fetchInt(cmd4);
-		if (bitSize <= 256)
-			return Result{4, gen("PUSHINT 0"), gen("STUR " + toString(bitSize))};
-	}
+		{2, {"INC", "DEC", "ADDCONST"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (isConstAdd(w.cmd1) && isConstAdd(w.cmd2)) {
+				int final_add = getAddNum(w.cmd1) + getAddNum(w.cmd2);
+				if (-128 <= final_add && final_add <= 127)
+					return Result{Rule::ConstAddConstAdd, 2, gen("ADDCONST " + std::to_string(final_add))};
+			}
+			return {};
+		}},
 
+		{2, {"INDEX_NOEXCEP", "INDEX_EXCEP"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if ((is(w.cmd1, "INDEX_NOEXCEP") || is(w.cmd1, "INDEX_EXCEP")) && 0 <= fetchInt(w.cmd1) && fetchInt(w.cmd1) <= 3 &&
+				(is(w.cmd2, "INDEX_NOEXCEP") || is(w.cmd2, "INDEX_EXCEP")) && 0 <= fetchInt(w.cmd2) && fetchInt(w.cmd2) <= 3) {
+				return Result{Rule::IndexIndexToIndex2, 2, gen("INDEX2 " + arg(w.cmd1) + ", " + arg(w.cmd2))};
+			}
+			return {};
+		}},
 
-	// PUSHSLICE xXXX
-	// NEWC
-	// STSLICE
-	// STBREFR
-	// =>
-	// PUSHCELL
-	// STREFR
-	if (
-		isPlainPushSlice(cmd1) &&
-		is(cmd2, "NEWC") &&
-		is(cmd3, "STSLICE") &&
-		is(cmd4, "STBREFR")
-	) {
-		return Result{4, makePUSHREF(isPlainPushSlice(cmd1)->blob()), gen("STREFR")};
-	}
+		{2, {"INDEX2"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (is(w.cmd1, "INDEX2") &&
+				(is(w.cmd2, "INDEX_NOEXCEP") || is(w.cmd2, "INDEX_EXCEP")) && 0 <= fetchInt(w.cmd2) && fetchInt(w.cmd2) <= 3
+			) {
+				auto [i, j] = getIndexes(arg(w.cmd1));
+				if (0 <= i && i <= 3 &&
+					0 <= j && j <= 3) {
+					return Result{Rule::Index2IndexToIndex3, 2, gen("INDEX3 " + toString(i) + ", " + toString(j) + ", " + arg(w.cmd2))};
+				}
+			}
+			return {};
+		}},
+
+		{2, {"PUSHINT"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd2GenOpcode = dyn_cast<StackOpcode>(w.cmd2.get());
+			if (
+				is(w.cmd1, "PUSHINT") && 1 <= pushintValue(w.cmd1) && pushintValue(w.cmd1) <= 256 &&
+				(is(w.cmd2, "RSHIFT") || is(w.cmd2, "LSHIFT")) && arg(w.cmd2).empty()
+			) {
+				return Result{Rule::PushIntShift, 2, gen(cmd2GenOpcode->opcode() + " " + arg(w.cmd1))};
+			}
+			return {};
+		}},
 
-	// DUP
-	// ISNULL
-	// THROWIF 63
-	// UNSINGLE
-	// =>
-	// UNSINGLE
-	if (
-		isPUSH(cmd1) && isPUSH(cmd1).value() == 0 &&
-		is(cmd2, "ISNULL") &&
-		cmd3Exc && cmd3Exc->opcode() == "THROWIF" && cmd3Exc->arg() == toString(TvmConst::RuntimeException::GetOptionalException) &&
-		is(cmd4, "UNTUPLE") && fetchInt(cmd4) == 1
-	) {
-		return Result{4, cmd4};
-	}
+		// PUSHINT 2**N
+		// DIV / MUL
+		// =>
+		// RSHIFT N / LSHIFT N
+		{2, {"PUSHINT"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (is(w.cmd1, "PUSHINT") &&
+				(is(w.cmd2, "DIV") || is(w.cmd2, "MUL"))) {
+				bigint val = pushintValue(w.cmd1);
+				if (power2Exp().count(val)) {
+					std::string const& newOp = is(w.cmd2, "DIV") ? "RSHIFT" : "LSHIFT";
+					int const n = power2Exp().at(val);
+					if (n > 0)
+						return Result{Rule::PushIntPow2MulDiv, 2, gen(newOp + " " + toString(n))};
+				}
+			}
+			return {};
+		}},
 
-	return {};
-}
+		// PUSHINT 2**N
+		// MOD
+		// =>
+		// MODPOW2 N
+		{2, {"PUSHINT"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (is(w.cmd1, "PUSHINT") && is(w.cmd2, "MOD")) {
+				bigint val = pushintValue(w.cmd1);
+				if (power2Exp().count(val)) {
+					return Result{Rule::PushIntPow2Mod, 2, gen("MODPOW2 " + toString(power2Exp().at(val)))};
+				}
+			}
+			return {};
+		}},
 
-std::optional<Result> PrivatePeepholeOptimizer::optimizeAt5(Pointer<TvmAstNode> const& cmd1, Pointer<TvmAstNode> const& cmd2,
-											 Pointer<TvmAstNode> const& cmd3, Pointer<TvmAstNode> const& cmd4,
-											 Pointer<TvmAstNode> const& cmd5) const {
-	// PUSHSLICE A
-	// PUSHSLICE B
-	// NEWC
-	// STSLICE
-	// STSLICE
-	// =>
-	// PUSHSLICE BA
-	// NEWC
-	// STSLICE
-	if (isPlainPushSlice(cmd1) &&
-		isPlainPushSlice(cmd2) &&
-		is(cmd3, "NEWC") &&
-		is(cmd4, "STSLICE") &&
-		is(cmd5, "STSLICE")
-	) {
-		std::string bitStr = StrUtils::toBitString(isPlainPushSlice(cmd2)->blob()) +
-							 StrUtils::toBitString(isPlainPushSlice(cmd1)->blob());
-		std::optional<std::string> slice = StrUtils::unitBitStringToHex(bitStr, "");
-		if (slice.has_value()) {
-			return Result{5,
-						  genPushSlice(*slice),
-						  gen("NEWC"),
-						  gen("STSLICE")};
-		}
-	}
+		// PUSHINT (2**N)-1
+		// AND
+		// =>
+		// MODPOW2 N
+		{2, {"PUSHINT"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (is(w.cmd1, "PUSHINT") && is(w.cmd2, "AND")) {
+				bigint val = pushintValue(w.cmd1);
+				if (power2DecExp().count(val)) {
+					return Result{Rule::PushIntPow2DecAnd, 2, gen("MODPOW2 " + toString(power2DecExp().at(val)))};
+				}
+			}
+			return {};
+		}},
+
+		{2, {"PUSHINT"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (is(w.cmd1, "PUSHINT")) {
+				bigint val = pushintValue(w.cmd1);
+				if (-128 <= val && val < 128) {
+					if (is(w.cmd2, "NEQ"))
+						return Result{Rule::PushIntCompareToConst, 2, gen("NEQINT " + toString(val))};
+					if (is(w.cmd2, "EQUAL"))
+						return Result{Rule::PushIntCompareToConst, 2, gen("EQINT " + toString(val))};
+					if (is(w.cmd2, "GREATER"))
+						return Result{Rule::PushIntCompareToConst, 2, gen("GTINT " + toString(val))};
+					if (is(w.cmd2, "LESS"))
+						return Result{Rule::PushIntCompareToConst, 2, gen("LESSINT " + toString(val))};
+				}
+				if (-128 <= val - 1 && val - 1 < 128 && is(w.cmd2, "GEQ"))
+					return Result{Rule::PushIntCompareToConst, 2, gen("GTINT " + toString(val - 1))};
+				if (-128 <= val + 1 && val + 1 < 128 && is(w.cmd2, "LEQ"))
+					return Result{Rule::PushIntCompareToConst, 2, gen("LESSINT " + toString(val + 1))};
+			}
+			return {};
+		}},
+
+		{2, pops, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto _isBLKDROP1 = isBLKDROP2(w.cmd1);
+			auto _isBLKDROP2 = isBLKDROP2(w.cmd2);
+			if (_isBLKDROP1 && _isBLKDROP2) {
+				auto [drop1, rest1] = _isBLKDROP1.value();
+				auto [drop2, rest2] = _isBLKDROP2.value();
+				// BLKDROP2 drop0, rest
+				// BLKDROP2 drop1, rest
+				// =>
+				// BLKDROP2 drop0+drop1, rest
+				if (rest1 == rest2 && drop1 + drop2 <= 15) {
+					return Result{Rule::BlkDrop2BlkDrop2, 2, makeBLKDROP2(drop1 + drop2, rest1)};
+				}
+				// BLKDROP2 drop1, rest1
+				// BLKDROP2 drop2, rest2
+				// =>
+				// BLKDROP2 drop1+drop2, rest1
+				if (rest1 == drop2 + rest2 && rest1 >= rest2) {
+					return Result{Rule::BlkDrop2BlkDrop2, 2, makeBLKDROP2(drop1 + drop2, rest2)};
+				}
+			}
+			return {};
+		}},
 
-	// PUSHINT ?
-	// PUSHSLICE ?
-	// NEWC
-	// STSLICE ?
-	// STU ?
-	if (is(cmd1, "PUSHINT") &&
-		isPlainPushSlice(cmd2) &&
-		is(cmd3, "NEWC") &&
-		is(cmd4, "STSLICE") &&
-		(is(cmd5, "STU") || is(cmd5, "STI"))
-	) {
-		std::string bitStr = StrUtils::toBitString(isPlainPushSlice(cmd2)->blob());
-		if (auto v = StrUtils::toBitString(pushintValue(cmd1), fetchInt(cmd5), is(cmd5, "STI"))) {
-			bitStr += v.value();
-			std::optional<std::string> slice = StrUtils::unitBitStringToHex(bitStr, "");
-			if (slice.has_value()) {
-				return Result{5,
-						genPushSlice(*slice),
-						gen("NEWC"),
-						gen("STSLICE")};
+		// BLKSWAP bottom, top
+		// BLKDROP bottom
+		// =>
+		// BLKDROP2 bottom, top
+		{2, swaps, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (isBLKSWAP(w.cmd1) &&
+				isDrop(w.cmd2)
+			) {
+				auto [bottom, top] = isBLKSWAP(w.cmd1).value();
+				int n = isDrop(w.cmd2).value();
+				if (n == bottom) {
+					return Result{Rule::BlkSwapDropToBlkDrop2, 2, makeBLKDROP2(n, top)};
+				}
 			}
-		}
-	}
+			return {};
+		}},
 
-	// NULL
-	// PUSHSLICE ?
-	// NEWC
-	// STSLICE ?
-	// STDICT
-	if (is(cmd1, "NULL") &&
-		isPlainPushSlice(cmd2) &&
-		is(cmd3, "NEWC") &&
-		is(cmd4, "STSLICE") &&
-		is(cmd5, "STDICT")
-	) {
-		std::string bitStr = StrUtils::toBitString(isPlainPushSlice(cmd2)->blob()) +
-			"0";
-		std::optional<std::string> slice = StrUtils::unitBitStringToHex(bitStr, "");
-		if (slice.has_value()) {
-			return Result{5,
-					genPushSlice(*slice),
-					gen("NEWC"),
-					gen("STSLICE")};
-		}
-	}
-	return {};
-}
+		{2, {"NEWC"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (is(w.cmd1, "NEWC") && is(w.cmd2, "ENDC")) {
+				return Result{Rule::NewcEndcToPushRef, 2, makePUSHREF()};
+			}
+			return {};
+		}},
 
-std::optional<Result> PrivatePeepholeOptimizer::optimizeAt6(Pointer<TvmAstNode> const& cmd1, Pointer<TvmAstNode> const& cmd2,
-											 Pointer<TvmAstNode> const& cmd3, Pointer<TvmAstNode> const& cmd4,
-											 Pointer<TvmAstNode> const& cmd5, Pointer<TvmAstNode> const& cmd6) const {
-
-	if (
-		isPlainPushSlice(cmd1) &&
-		is(cmd2, "NEWC") &&
-		is(cmd3, "STSLICE") &&
-		is(cmd4, "NEWC") &&
-		is(cmd5, "STSLICECONST") &&
-		is(cmd6, "STB")
-	) {
-		std::string str1 = StrUtils::toBitString(isPlainPushSlice(cmd1)->blob());
-		std::string str5 = StrUtils::toBitString(arg(cmd5));
-		std::optional<std::string> slice = StrUtils::unitBitStringToHex(str5, str1);
-		if (slice.has_value()) {
-			return Result{6,
-						  genPushSlice(*slice),
-						  gen("NEWC"),
-						  gen("STSLICE")
-			};
-		}
-	}
-	return {};
-}
+		// LESS | LEQ    | GREATER | GEQ  | EQUAL | NEQ   | EQINT  | NEQINT | NOT | TRUE  | FALSE
+		// NOT
+		// =>
+		// GEQ | GREATER | LEQ     | LESS | NEQ   | EQUAL | NEQINT | EQINT  |     | FALSE | TRUE
+		{2, {"LESS", "LEQ", "GREATER", "GEQ", "EQUAL", "NEQ", "LESSINT", "GTINT", "EQINT", "NEQINT", "NOT", "TRUE", "FALSE"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (is(w.cmd2, "NOT")) {
+				if (is(w.cmd1, "LESS")) return Result{Rule::CompareNot, 2, gen("GEQ")};
+				if (is(w.cmd1, "LEQ")) return Result{Rule::CompareNot, 2, gen("GREATER")};
+				if (is(w.cmd1, "GREATER")) return Result{Rule::CompareNot, 2, gen("LEQ")};
+				if (is(w.cmd1, "GEQ")) return Result{Rule::CompareNot, 2, gen("LESS")};
+				if (is(w.cmd1, "EQUAL")) return Result{Rule::CompareNot, 2, gen("NEQ")};
+				if (is(w.cmd1, "NEQ")) return Result{Rule::CompareNot, 2, gen("EQUAL")};
+
+				if (is(w.cmd1, "LESSINT")) {  // !(x < value) => x >= value => x > value-1
+					int value = fetchInt(w.cmd1);
+					if (-128 <= value - 1 && value - 1 < 128)
+						return Result{Rule::CompareNot, 2, gen("GTINT " + toString(value - 1))};
+				}
+				if (is(w.cmd1, "GTINT")) {  // !(x > value) => x <= value => x < value+1
+					int value = fetchInt(w.cmd1);
+					if (-128 <= value + 1 && value + 1 < 128)
+						return Result{Rule::CompareNot, 2, gen("LESSINT " + toString(value + 1))};
+				}
+				if (is(w.cmd1, "EQINT")) return Result{Rule::CompareNot, 2, gen("NEQINT " + arg(w.cmd1))};
+				if (is(w.cmd1, "NEQINT")) return Result{Rule::CompareNot, 2, gen("EQINT " + arg(w.cmd1))};
 
-std::optional<Result> PrivatePeepholeOptimizer::optimizeAtInf(int idx1) const {
-	Pointer<TvmAstNode> const& cmd1 = get(idx1);
-	auto cmd1IfElse = to<TvmIfElse>(cmd1.get());
-	auto cmd1Ret = to<TvmReturn>(cmd1.get());
-	int idx2 = nextCommandLine(idx1);
+				if (is(w.cmd1, "NOT")) return Result{Rule::NotNot, 2};
 
-	// delete last RET in block
-	if (cmd1Ret && !cmd1Ret->withIf() && !cmd1Ret->withAlt() && idx2 == -1) {
-		return Result{1};
-	}
+				if (is(w.cmd1, "TRUE")) return Result{Rule::ConstBoolNot, 2, gen("FALSE")};
+				if (is(w.cmd1, "FALSE")) return Result{Rule::ConstBoolNot, 2, gen("TRUE")};
+			}
+			return {};
+		}},
+
+		{2, {"UFITS", "FITS"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd1GenOp = dyn_cast<StackOpcode>(w.cmd1.get());
+			if ((is(w.cmd1, "UFITS") && is(w.cmd2, "UFITS")) || (is(w.cmd1, "FITS") && is(w.cmd2, "FITS"))) {
+				int bitSize = std::min(fetchInt(w.cmd1), fetchInt(w.cmd2));
+				return Result{Rule::FitsFits, 2, gen(cmd1GenOp->opcode() + " " + toString(bitSize))};
+			}
+			return {};
+		}},
 
-	// PUSHCONT {
-	//    NULL
-	//    SWAP
-	// }
-	// IFNOTJMP
-	// =>
-	// NULLROTRIFNOT
-	// DROP
-	if (cmd1IfElse && cmd1IfElse->falseBody() == nullptr && cmd1IfElse->withJmp() && cmd1IfElse->withNot() &&
-		idx2 == -1) {
-		std::vector<Pointer<TvmAstNode>> const& insts = cmd1IfElse->trueBody()->instructions();
-		if (insts.size() == 2 && is(insts.at(0), "NULL") && isSWAP(insts.at(1))) {
-			return Result{1, StackPusher::makeAsym("NULLROTRIFNOT"), makeDROP()};
-		}
-	}
+		{2, {"TRUE", "FALSE"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if ((is(w.cmd1, "TRUE") || is(w.cmd1, "FALSE")) &&
+				is(w.cmd2, "STIR") && fetchInt(w.cmd2) == 1
+			) {
+				if (is(w.cmd1, "FALSE"))
+					return Result{Rule::BoolStIrToStSliceConst, 2, gen("STSLICECONST 0")};
+				return Result{Rule::BoolStIrToStSliceConst, 2, gen("STSLICECONST 1")};
+			}
+			return {};
+		}},
 
+		{2, {"PUSHINT"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (
+				is(w.cmd1, "PUSHINT") && pushintValue(w.cmd1) == 0 &&
+				is(w.cmd2, "STUR")
+			) {
+				return Result{Rule::ZeroStUrToStZeroes, 2,
+					gen("PUSHINT " + arg(w.cmd2)),
+					gen("STZEROES")};
+			}
+			return {};
+		}},
 
-	// squash ST* opcodes
-	{
-		// another stores?
-		int i = idx1;
-		std::string bitString;
-		int opcodeQty = 0;
-		vector<Pointer<TvmAstNode>> takenOpcodes;
-		bool withBuilder = false;
-		{
-			int j = nextCommandLine(i);
-			int k = nextCommandLine(j);
-			Pointer<TvmAstNode> const& cmd2 = get(j);
-			Pointer<TvmAstNode> const& cmd3 = get(k);
-
-			if (k != -1 &&
-				isPlainPushSlice(cmd1) &&
-				is(cmd2, "NEWC") &&
-				is(cmd3, "STSLICE")
+		{2, {"ABS"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (
+				is(w.cmd1, "ABS") &&
+				is(w.cmd2, "UFITS") && fetchInt(w.cmd2) == 256
 			) {
-				withBuilder = true;
-				std::string hexSlice = isPlainPushSlice(cmd1)->blob();
-				bitString += StrUtils::toBitString(hexSlice);
-				opcodeQty += 3;
-				takenOpcodes.emplace_back(cmd1);
-				takenOpcodes.emplace_back(cmd2);
-				takenOpcodes.emplace_back(cmd3);
-				i = nextCommandLine(k);
-			}
-			// PUSHINT ?
-			// NEWC
-			// STU y | STI y
-			else if (
-				is(cmd1, "PUSHINT") &&
-				is(cmd2, "NEWC") &&
-				(is(cmd3, "STU") || is(cmd3, "STI"))
+				return Result{Rule::AbsUfits256, 2, gen("ABS")};
+			}
+			return {};
+		}},
+
+		{2, {"PUSHINT"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (
+				is(w.cmd1, "PUSHINT") && pushintValue(w.cmd1) == 1 &&
+				is(w.cmd2, "STZEROES")
 			) {
-				if (auto bitStr = StrUtils::toBitString(pushintValue(cmd1), fetchInt(cmd3), is(cmd3, "STI"))) {
-					withBuilder = true;
-					bitString += bitStr.value();
-					opcodeQty += 3;
-					takenOpcodes.emplace_back(cmd1);
-					takenOpcodes.emplace_back(cmd2);
-					takenOpcodes.emplace_back(cmd3);
-					i = nextCommandLine(k);
-				}
+				return Result{Rule::OneStZeroesToStSliceConst, 2, gen("STSLICECONST 0")};
 			}
-		}
+			return {};
+		}},
 
-		while (i != -1) {
-			Pointer<TvmAstNode> const& c1 = get(i);
-			int j = nextCommandLine(i);
-			Pointer<TvmAstNode> c2;
-			if (j != -1) {
-				c2 = get(j);
-			}
-
-			// TODO ADD LD[I|U]LE[4|8]
-			int curOpcodeQty = 0;
-			if (is(c1, "STSLICECONST")) {
-				bitString += StrUtils::toBitString(arg(c1));
-				curOpcodeQty = 1;
-				i = j;
-			} else if (c2 && is(c1, "PUSHINT") && (is(c2, "STUR") || is(c2, "STIR"))) {
-				bigint num = pushintValue(c1);
-				int len = fetchInt(c2);
-				if (auto bitStr = StrUtils::toBitString(num, len, is(c2, "STIR"))) {
-					bitString += bitStr.value();
-					curOpcodeQty = 2;
-					i = nextCommandLine(j);
-				} else
-					break;
-			} else if (c2 && is(c1, "PUSHINT") && is(c2, "STVARUINT16", "STGRAMS")) {
-				bigint num = pushintValue(c1);
-				bitString += StrUtils::tonsToBinaryString(num);
-				curOpcodeQty = 2;
-				i = nextCommandLine(j);
-			} else if (c2 && is(c1, "PUSHINT") && is(c2, "STZEROES")) {
-				int len = fetchInt(c1);
-				bitString += std::string(len, '0');
-				curOpcodeQty = 2;
-				i = nextCommandLine(j);
-			} else if (c2 && isPlainPushSlice(c1) && is(c2, "STSLICER")) {
-				std::string hexSlice = isPlainPushSlice(c1)->blob();
-				bitString += StrUtils::toBitString(hexSlice);
-				curOpcodeQty = 2;
-				i = nextCommandLine(j);
-			} else {
-				break;
+		// REVERSE N, 1
+		// BLKSWAP N, 1
+		// =>
+		// REVERSE N+1, 0
+		{2, swaps, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (isREVERSE(w.cmd1) && isBLKSWAP(w.cmd2)) {
+				auto [qty, index] = isREVERSE(w.cmd1).value();
+				auto [bottom, top] = isBLKSWAP(w.cmd2).value();
+				if (top == 1 && index == 1 && qty == bottom)
+					return Result{Rule::ReverseBlkSwap, 2, makeREVERSE(qty + 1, 0)};
 			}
-			opcodeQty += curOpcodeQty;
-			takenOpcodes.emplace_back(c1);
-			if (curOpcodeQty >= 2)
-				takenOpcodes.emplace_back(c2);
-		}
+			return {};
+		}},
 
-		std::optional<std::string> slice = StrUtils::unitBitStringToHex(bitString, "");
-		if (slice) {
-			vector<Pointer<TvmAstNode>> opcodes;
-			std::optional<Result> res;
-			if (StrUtils::toBitString(*slice).length() <= TvmConst::MaxSTSLICECONST) {
-				if (withBuilder)
-					opcodes.push_back(gen("NEWC"));
-				opcodes.push_back(gen("STSLICECONST " + *slice));
-				res = Result{opcodeQty, opcodes};
-			} else {
-				if (withBuilder) {
-					opcodes.push_back(genPushSlice(*slice));
-					opcodes.push_back(gen("NEWC"));
-					opcodes.push_back(gen("STSLICE"));
-				} else {
-					opcodes.push_back(genPushSlice(*slice));
-					opcodes.push_back(gen("STSLICER"));
-				}
-				res = Result{opcodeQty, opcodes};
+		// REVERSE N+1, 0
+		// BLKDROP N
+		// =>
+		// BLKDROP2 N, 1
+		{2, swaps, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (isREVERSE(w.cmd1) && isDrop(w.cmd2)) {
+				auto [qty, index] = isREVERSE(w.cmd1).value();
+				int n = isDrop(w.cmd2).value();
+				if (n + 1 == qty && index == 0)
+					return Result{Rule::ReverseDropToBlkDrop2, 2, makeBLKDROP2(n, 1)};
 			}
-			if (opcodeQty > int(res->commands.size()))
-			{
-				return res;
+			return {};
+		}},
+
+		// ENDC
+		// STREFR
+		// =>
+		// STBREFR
+		{2, {"ENDC"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (
+				is(w.cmd1, "ENDC") &&
+				is(w.cmd2, "STREFR")
+			) {
+				return Result{Rule::EndcStRefRToStBRefR, 2, gen("STBREFR")};
 			}
-			if (opcodeQty == int(res->commands.size()))
-			{
-				bool eq = true;
-				for (int i = 0; i < int(takenOpcodes.size()); ++i) {
-					bool curEq = *takenOpcodes.at(i) == *res->commands.at(i);
-					eq &= curEq;
+			return {};
+		}},
+
+		// s01
+		// XCHG S1, S2
+		// =>
+		// SWAP
+		// s01
+		{2, gens, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (isPureGen01(*w.cmd1) &&
+				isXCHG(w.cmd2, 1, 2)
+			) {
+				return Result{Rule::Gen01Xchg12, 2, makeBLKSWAP(1, 1), w.cmd1};
+			}
+			return {};
+		}},
+
+		// DUP
+		// PUSHCONT {
+		//   DROP
+		//   TRUE
+		// }
+		// IF
+		// =>
+		//
+		{2, pushes, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto isPUSH1 = isPUSH(w.cmd1);
+			if (isPUSH1 && *isPUSH1 == 0) {
+				if (auto lc = dyn_cast<LogCircuit>(w.cmd2.get())) {
+					if (lc->type() == LogCircuit::Type::AND && lc->body()->instructions().size() == 2) {
+						auto cmd2_0 = lc->body()->instructions().at(0);
+						auto cmd2_1 = lc->body()->instructions().at(1);
+						auto _true = dyn_cast<StackOpcode>(cmd2_1.get());
+						if (isDrop(cmd2_0) == 1 && _true && _true->opcode() == "TRUE") {
+							return Result{Rule::DupAndTrue, 2};
+						}
+					}
 				}
-				if (!eq)
-					return res;
 			}
-		}
-	}
+			return {};
+		}},
 
-	// squash DROPs
-	{
-		int i = idx1, n = 0, total = 0;
-		while (i != -1 && isDrop(get(i))) {
-			n++;
-			total += isDrop(get(i)).value();
-			i = nextCommandLine(i);
-		}
-		if (n >= 2) {
-			return Result{n, makeDROP(total)};
-		}
-	}
+		// TRUE
+		// AND
+		// =>
+		//
+		{2, {"TRUE"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto _true = dyn_cast<StackOpcode>(w.cmd1.get());
+			auto _and = dyn_cast<StackOpcode>(w.cmd2.get());
+			if (_true && _true->opcode() == "TRUE" &&
+				_and && _and->opcode() == "AND") {
+				return Result{Rule::TrueAnd, 2};
+			}
+			return {};
+		}},
 
-	// BLKSWAP N, 1
-	// BLKSWAP N, 1
-	// BLKSWAP N, 1
-	// ...
-	// BLKSWAP N, 1
-	// =>
-	//
-	if (isBLKSWAP(cmd1)) {
-		auto [n, top] = isBLKSWAP(cmd1).value();
-		if (top == 1) {
-			bool ok = true;
-			for (int iter = 0; iter < n + 1; ++iter) {
-				if (get(idx1 + iter) == nullptr) {
-					ok = false;
-					break;
-				}
-				auto c = get(idx1 + iter);
-				ok &= isBLKSWAP(c) && std::make_pair(n, 1) == isBLKSWAP(c).value();
+		// NULL
+		// ISNULL
+		// =>
+		// TRUE
+		{2, {"NULL"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (is(w.cmd1, "NULL") && is(w.cmd2, "ISNULL")) {
+				return Result{Rule::NullIsNull, 2, gen("TRUE")};
 			}
-			if (ok) {
-				return Result{n + 1};
+			return {};
+		}},
+
+		// TRUE       / FALSE
+		// THROWIFNOT / THROWIF
+		// =>
+		//
+		{2, {"TRUE", "FALSE"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if ((is(w.cmd1, "TRUE") && isExc(w.cmd2, "THROWIFNOT")) || (is(w.cmd1, "FALSE") && isExc(w.cmd2, "THROWIF"))) {
+				return Result{Rule::ConstTrueThrowIfNot, 2};
 			}
-		}
-	}
+			return {};
+		}},
 
-	// POP N
-	// POP N
-	// ...
-	// =>
-	// BLKDROP2 N, N
-	if (isPOP(cmd1)) {
-		int n = isPOP(cmd1).value();
-		if (n >= 2) {
-			int index = idx1;
-			bool ok = true;
-			int i = 0;
-			for (; ok && i < n && index != -1; ++i, index = nextCommandLine(index)) {
-				auto cmd = get(index);
-				ok &= isPOP(cmd) && isPOP(cmd).value() == n;
+		// PUSHINT N
+		// ISNULL
+		// =>
+		// FALSE
+		{2, {"PUSHINT"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (is(w.cmd1, "PUSHINT") && is(w.cmd2, "ISNULL")) {
+				return Result{Rule::PushIntIsNull, 2, gen("FALSE")};
 			}
-			ok &= i == n;
-			if (ok) {
-				return Result{n, makeBLKDROP2(n, n)};
+			return {};
+		}},
+
+		// TRUE    / FALSE
+		// THROWIF / THROWIFNOT
+		// =>
+		//
+		{2, {"TRUE", "FALSE"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd2Exc = dyn_cast<TvmException>(w.cmd2.get());
+			if ((is(w.cmd1, "TRUE") && isExc(w.cmd2, "THROWIF")) || (is(w.cmd1, "FALSE") && isExc(w.cmd2, "THROWIFNOT"))) {
+				return Result{Rule::ConstTrueThrowIf, 2, makeTHROW("THROW " + cmd2Exc->arg())};
 			}
-		}
-	}
+			return {};
+		}},
 
-	// REVERSE n, 0
-	// POP
-	// ...
-	// POP
-	// =>
-	// POP
-	// ..
-	// POP
-	if (isREVERSE(cmd1) && idx2 != -1) {
-		auto [n, startIndex] = isREVERSE(cmd1).value();
-		if (startIndex == 0) {
-			vector<Pointer<TvmAstNode>> newCmds;
-			int index = idx2;
-			bool ok = true;
-			int i = 0;
-			for (; ok && i < n && index != -1; ++i, index = nextCommandLine(index)) {
-				auto cmd = get(index);
-				ok &= isPOP(cmd).has_value();
-				newCmds.push_back(cmd);
-			}
-			ok &= i == n;
-			if (ok) {
-				std::reverse(newCmds.begin(), newCmds.end());
-				std::set<int> uniqInds;
-				int deltaSi = n - 1;
-				for (i = 0; i < n; ++i) {
-					int si = isPOP(newCmds[i]).value();
-					int newSi = si + deltaSi;
-					ok &= newSi >= n - i;
-					if (!ok) {
-						break;
-					}
-					newCmds[i] = makePOP(newSi);
-					deltaSi -= 2;
-					uniqInds.insert(newSi + i);
-				}
-				ok &= static_cast<int>(uniqInds.size()) == n;
-				if (ok) {
-					return Result{n + 1, newCmds};
+		// pure gen(1, 1)
+		// DROP N
+		// =>
+		// DROP N
+		{2, {OpKind::StackOpcode}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd1GenOp = dyn_cast<StackOpcode>(w.cmd1.get());
+			if (cmd1GenOp && cmd1GenOp->isPure() &&
+				std::make_pair(cmd1GenOp->take(), cmd1GenOp->ret()) == std::make_pair(1, 1) &&
+				isDrop(w.cmd2)
+			) {
+				return Result{Rule::PureUnaryDrop, 2, w.cmd2};
+			}
+			return {};
+		}},
+
+		// ABS
+		// MODPOW2 256
+		// =>
+		// ABS
+		{2, {"ABS"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd2GenOpcode = dyn_cast<StackOpcode>(w.cmd2.get());
+			if (is(w.cmd1, "ABS") &&
+				cmd2GenOpcode && cmd2GenOpcode->opcode() == "MODPOW2" && cmd2GenOpcode->arg() == "256"
+			) {
+				return Result{Rule::AbsModPow2, 2, gen("ABS")};
+			}
+			return {};
+		}},
+
+		// MODPOW2 x
+		// MODPOW2 y
+		// =>
+		// MODPOW2 min(x, y)
+		{2, {"MODPOW2"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (is(w.cmd1, "MODPOW2") && is(w.cmd2, "MODPOW2")) {
+				int x = fetchInt(w.cmd1);
+				int y = fetchInt(w.cmd2);
+				return Result{Rule::ModPow2ModPow2, 2, gen("MODPOW2 " + toString(std::min(x, y)))};
+			}
+			return {};
+		}},
+
+		// BLKPUSH N, 0 / DUP
+		// BLKPUSH Q, 0 / DUP
+		// =>
+		// BLKPUSH N+Q, 0
+		{2, pushes, [](PrivatePeepholeOptimizer const& self, Window const& w) -> std::optional<Result> {
+			if (self.m_flags.test(OptFlags::UseCompoundOpcodes) && isBLKPUSH(w.cmd1) && isBLKPUSH(w.cmd2)) {
+				auto [qty0, index0] = isBLKPUSH(w.cmd1).value();
+				auto [qty1, index1] = isBLKPUSH(w.cmd2).value();
+				if (index0 == 0 && index1 == 0 && qty0 + qty1 <= 15)
+					return Result{Rule::DupBlkPush, 2, makeBLKPUSH(qty0 + qty1, 0)};
+			}
+			return {};
+		}},
+
+		// LD[I|U] N / LDDICT / LDREF / LD[I|U]X N
+		// DROP
+		{2, {"LDU", "LDI", "LDREF", "LDDICT", "LDUX", "LDIX", "LDSLICE", "LDSLICEX"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd1GenOp = dyn_cast<StackOpcode>(w.cmd1.get());
+			if ((is(w.cmd1, "LDU", "LDI", "LDREF", "LDDICT", "LDUX", "LDIX",
+					"LDSLICE", "LDSLICEX")) &&
+				isDrop(w.cmd2)
+			) {
+				// TODO add LD[I|U]LE[4|8]
+				int n = isDrop(w.cmd2).value();
+				Pointer<StackOpcode> newOpcode = gen("P" + cmd1GenOp->fullOpcode());
+				if (n == 1) {
+					return Result{Rule::LoadDropToPreload, 2, newOpcode};
+				} else {
+					return Result{Rule::LoadDropToPreload, 2, {newOpcode, makeDROP(n - 1)}};
 				}
 			}
-		}
-	}
+			return {};
+		}},
 
-	// BLKSWAP n, 1
-	// POP n+1
-	// ...
-	// POP n+1 // n times
-	// =>
-	// BLKDROP2 n, n+1
-	if (isBLKSWAP(cmd1) && idx2 != -1) {
-		auto [n, up] = isBLKSWAP(cmd1).value();
-		if (up == 1) {
-			int index = idx2;
-			bool ok = true;
-			int i = 0;
-			for (; ok && i < n && index != -1; ++i, index = nextCommandLine(index)) {
-				auto cmd = get(index);
-				ok &= isPOP(cmd).has_value() && isPOP(cmd) == n + 1;
-			}
-			ok &= i == n;
-			if (ok) {
-				return Result{n + 1, makeBLKDROP2(n, n + 1)};
+		// 26 + 118 gas units
+		// PLDREF
+		// CTOS
+		// =>
+		// 118 + 18 gas units
+		// LDREFRTOS
+		// NIP
+		{2, {"PLDREF"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (is(w.cmd1, "PLDREF") && is(w.cmd2, "CTOS")) {
+				return Result{Rule::PldRefCtosToLdRefRtos, 2, gen("LDREFRTOS"), makeBLKDROP2(1, 1)};
 			}
-		}
-	}
+			return {};
+		}},
 
-	// ROLL n
-	// ROLL n+1
-	// ROLL n+2
-	// ...
-	// =>
-	// BLKSWAP qty, n
-	// REVERSE qty, 0
-	if (isBLKSWAP(cmd1)) {
-		auto [down, up] = isBLKSWAP(cmd1).value();
-		if (down == 1) {
-			int i = nextCommandLine(idx1);
-			int targetUp = up + 1;
-			int qty = 1;
-			while (true) {
-				if (i == -1 || !isBLKSWAP(get(i)))
-					break;
-				auto [downi, upi] = isBLKSWAP(get(i)).value();
-				if (downi != 1 || upi != targetUp)
-					break;
-				++targetUp;
-				i = nextCommandLine(i);
-				++qty;
+		// NEW
+		// s01
+		// ST**R
+		// =>
+		// s01
+		// NEW
+		// ST**
+		{3, {"NEWC"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd3GenOpcode = dyn_cast<StackOpcode>(w.cmd3.get());
+			if (
+				is(w.cmd1, "NEWC") &&
+				isSimpleCommand(w.cmd2) &&
+				cmd3GenOpcode &&
+				boost::starts_with(cmd3GenOpcode->opcode(), "ST") && boost::ends_with(cmd3GenOpcode->opcode(), "R")
+			) {
+				const auto& opcode = cmd3GenOpcode->opcode();
+				return Result{Rule::NewcStoreRToStore, 3,
+							  w.cmd2,
+							  gen("NEWC"),
+							  gen(opcode.substr(0, opcode.size() - 1) + " " + arg(w.cmd3))};
+			}
+			return {};
+		}},
+
+		// DUP
+		// THROWIFNOT 507
+		// DROP n
+		{3, pushes, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto isPUSH1 = isPUSH(w.cmd1);
+			if (isPUSH1 && *isPUSH1 == 0 &&
+				isExc(w.cmd2, "THROWIFNOT", "THROWIF") &&
+				isDrop(w.cmd3)
+			) {
+				int n = isDrop(w.cmd3).value();
+				if (n == 1) {
+					return Result{Rule::DupThrowIfDrop, 3, w.cmd2};
+				} else {
+					return Result{Rule::DupThrowIfDrop, 3, w.cmd2, makeDROP(n - 1)};
+				}
 			}
-			if (qty >= 2) {
-				return Result{qty, makeBLKSWAP(qty, up), makeREVERSE(qty, 0)};
+			return {};
+		}},
+
+		{3, {"NEWC"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (
+				is(w.cmd1, "NEWC") &&
+				is(w.cmd2, "STSLICECONST") && arg(w.cmd2).length() > 1 &&
+				is(w.cmd3, "ENDC")
+			) {
+				return Result{Rule::NewcStSliceConstEndcToPushRef, 3, makePUSHREF(arg(w.cmd2))};
 			}
-		}
-	}
+			return {};
+		}},
 
-	// squash stack opcodes
-	{
-		struct BestResult {
-			StackState bestState;
-			int bestStartStackSize = 0;
-			int bestOpcodeQty = 0;
-		};
-		std::optional<BestResult> bestResult;
-
-		for (int startStackSize = 0; startStackSize <= StackState::MAX_STACK_DEPTH; ++startStackSize)
-		{
-			StackState state{startStackSize};
-			int i = idx1;
-			int gasCost = 0;
-			int opcodeQty = 0;
-			while (true) {
-				if (i == -1)
-					break;
-				auto stack = to<Stack>(get(i).get());
-				if (!stack)
-					break;
-				if (!state.apply(*stack)) {
-					break;
+		// PUSHINT x
+		// PUSH Si (i!=0) or gen(0,1)
+		// CMP
+		// =>
+		// PUSH S(i-1) or gen(0,1)
+		// CMP2
+		{3, {"PUSHINT"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto isPUSH2 = isPUSH(w.cmd2);
+			if (is(w.cmd1, "PUSHINT") && ((isPUSH2 && *isPUSH2 != 0) || isPureGen01(*w.cmd2))) {
+				auto newCmd2 = isPUSH2 ? makePUSH(*isPUSH2 - 1) : w.cmd2;
+				bigint val = pushintValue(w.cmd1);
+				if (-128 <= val && val < 128) {
+					if (is(w.cmd3, "NEQ"))
+						return Result{Rule::PushIntPushCompareToConst, 3, newCmd2, gen("NEQINT " + toString(val))};
+					if (is(w.cmd3, "EQUAL"))
+						return Result{Rule::PushIntPushCompareToConst, 3, newCmd2, gen("EQINT " + toString(val))};
+					if (is(w.cmd3, "GREATER"))
+						return Result{Rule::PushIntPushCompareToConst, 3, newCmd2, gen("LESSINT " + toString(val))};
+					if (is(w.cmd3, "LESS"))
+						return Result{Rule::PushIntPushCompareToConst, 3, newCmd2, gen("GTINT " + toString(val))};
+				}
+				if (-128 <= val + 1 && val + 1 < 128 && is(w.cmd3, "GEQ"))
+					return Result{Rule::PushIntPushCompareToConst, 3, newCmd2, gen("LESSINT " + toString(val + 1))};
+				if (-128 <= val - 1 && val - 1 < 128 && is(w.cmd3, "LEQ"))
+					return Result{Rule::PushIntPushCompareToConst, 3, newCmd2, gen("GTINT " + toString(val - 1))};
+			}
+			return {};
+		}},
+
+		// PUSHINT A
+		// PUSHINT B
+		// ADD | MUL
+		//
+		// PUSHINT A+B | PUSHINT A*B
+		{3, {"PUSHINT"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd3GenOpcode = dyn_cast<StackOpcode>(w.cmd3.get());
+			if (is(w.cmd1, "PUSHINT") &&
+				is(w.cmd2, "PUSHINT") &&
+				cmd3GenOpcode && isIn(cmd3GenOpcode->opcode(), "ADD", "MUL", "MAX")
+			) {
+				bigint a = pushintValue(w.cmd1);
+				bigint b = pushintValue(w.cmd2);
+				bigint c;
+				if (cmd3GenOpcode->opcode() == "ADD")
+					c = a + b;
+				else if (cmd3GenOpcode->opcode() == "MUL")
+					c = a * b;
+				else if (cmd3GenOpcode->opcode() == "MAX")
+					c = std::max(a, b);
+				else
+					solUnimplemented("");
+				return Result{Rule::FoldPushIntAddMulMax, 3, gen("PUSHINT " + toString(c))};
+			}
+			return {};
+		}},
+
+		// PUSHINT A
+		// PUSHINT B
+		// DIV
+		//
+		// PUSHINT A/B
+		{3, {"PUSHINT"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd3GenOpcode = dyn_cast<StackOpcode>(w.cmd3.get());
+			if (is(w.cmd1, "PUSHINT") &&
+				is(w.cmd2, "PUSHINT") &&
+				cmd3GenOpcode && cmd3GenOpcode->opcode() == "DIV"
+			) {
+				bigint a = pushintValue(w.cmd1);
+				bigint b = pushintValue(w.cmd2);
+				if (a >= 0 && b > 0) { // note in TVM  -9 / 2 == -5
+					bigint c = a / b;
+					return Result{Rule::FoldPushIntDiv, 3, gen("PUSHINT " + toString(c))};
+				}
+			}
+			return {};
+		}},
+
+		// PUSHINT
+		// PUSH SN / gen01
+		// ADD / MUL
+		//
+		// PUSH S(N-1) / gen01
+		// ADDCONST / MULCONST
+		{3, {"PUSHINT"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (is(w.cmd1, "PUSHINT") &&
+				(is(w.cmd3, "ADD") || is(w.cmd3, "MUL"))
+			) {
+				bigint val = pushintValue(w.cmd1);
+				if (-128 <= val && val <= 127) {
+					if ((isPureGen01(*w.cmd2) && isa<StackOpcode>(w.cmd2.get())) ||
+						dyn_cast<Glob>(w.cmd2.get()) ||
+						isPUSH(w.cmd2)
+					) {
+						Pointer<TvmAstNode> newCmd;
+						if (isa<StackOpcode>(w.cmd2.get()) ||
+							dyn_cast<Glob>(w.cmd2.get())
+						) {
+							newCmd = w.cmd2;
+						} else if (auto index = isPUSH(w.cmd2); index.has_value() && *index > 0) {
+							newCmd = makePUSH(*index - 1);
+						}
+						if (newCmd)
+							return Result{Rule::PushIntPushAddMulToConst, 3,  newCmd, gen((is(w.cmd3, "ADD") ? "ADDCONST " : "MULCONST ") + toString(val))};
+					}
 				}
+			}
+			return {};
+		}},
 
-				++opcodeQty;
-				gasCost += OpcodeUtils::gasCost(*stack);
-				auto newGasCost = StackOpcodeSquasher::gasCost(startStackSize, state, m_flags.test(OptFlags::UseCompoundOpcodes));
-				if (newGasCost.has_value() && newGasCost < gasCost) {
-					bestResult = BestResult{state, startStackSize, opcodeQty};
+		// TRUE
+		// NEWC
+		// STI 1
+		{3, {"TRUE", "FALSE"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if ((is(w.cmd1, "TRUE") || is(w.cmd1, "FALSE")) &&
+				is(w.cmd2, "NEWC") &&
+				is(w.cmd3, "STI") && arg(w.cmd3) == "1"
+			) {
+				if (is(w.cmd1, "TRUE"))
+					return Result{Rule::BoolNewcStIToStSliceConst, 3, gen("NEWC"), gen("STSLICECONST 1")};
+				return Result{Rule::BoolNewcStIToStSliceConst, 3, gen("NEWC"), gen("STSLICECONST 0")};
+			}
+			return {};
+		}},
+
+		{3, swaps, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (
+				isBLKSWAP(w.cmd1) &&
+				isPureGen01(*w.cmd2) &&
+				isBLKSWAP(w.cmd3)
+			) {
+				auto [bottom1, top1] = isBLKSWAP(w.cmd1).value();
+				auto [bottom3, top3] = isBLKSWAP(w.cmd3).value();
+				if (bottom1 == 1 && bottom3 == 1 && top3 == 1) {
+					return Result{Rule::BlkSwapGen01BlkSwap, 3, w.cmd2, makeBLKSWAP(bottom1, top1 + 1)};
 				}
+			}
+			return {};
+		}},
 
-				i = nextCommandLine(i);
+		{3, {"NULL"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto isPUSH2 = isPUSH(w.cmd2);
+			if (is(w.cmd1, "NULL") && isPUSH2 && *isPUSH2 == 0 && is(w.cmd3, "ISNULL")) {
+				return Result{Rule::NullDupIsNull, 3, gen("NULL"), gen("TRUE")};
 			}
-		}
+			return {};
+		}},
 
-		if (bestResult.has_value()) {
-			auto newOpcodes = StackOpcodeSquasher::recover(bestResult.value().bestStartStackSize,
-														   bestResult.value().bestState,
-														   m_flags.test(OptFlags::UseCompoundOpcodes));
-			return Result{bestResult.value().bestOpcodeQty, newOpcodes};
-		}
-	}
+		// gen(0, 1)
+		// BLKPUSH N, 0
+		// gen(0, 1)
+		// =>
+		// gen(0, 1)
+		// BLKPUSH N+1, 0
+		{3, gens, [](PrivatePeepholeOptimizer const& self, Window const& w) -> std::optional<Result> {
+			if (self.m_flags.test(OptFlags::UseCompoundOpcodes) && // ?
+				isPureGen01(*w.cmd1) &&
+				isBLKPUSH(w.cmd2) &&
+				isPureGen01(*w.cmd3) &&
+				*w.cmd1 == *w.cmd3
+			) {
+				auto [qty, index] = isBLKPUSH(w.cmd2).value();
+				if (index == 0 && qty + 1 <= 15) {
+					return Result{Rule::Gen01BlkPushGen01, 3, w.cmd1, makeBLKPUSH(qty + 1, index)};
+				}
+			}
+			return {};
+		}},
 
-	// squash permutation of pure operations
-	{
-		// pure gen, get glob, push Si
-		// BLKSWAP, REVERSE, XCHG
-		std::deque<std::pair<Pointer<TvmAstNode>, int>> opcodes;
-		bool removed = false;
-		int cnt = 0;
-
-		for (int ii = idx1; ii != -1; ii = nextCommandLine(ii)) {
-			TvmAstNode const* op = get(ii).get();
-			auto stack = to<Stack>(op);
-			if (isPureGen01(*op)) {
-				opcodes.emplace_front(get(ii), opcodes.size());
-				++cnt;
-			} else if (stack) {
-				int i = stack->i();
-				int j = stack->j();
-				int n = opcodes.size();
-				bool ok = true;
-				switch (stack->opcode()) {
-					case Stack::Opcode::BLKSWAP: {
-						if (i + j <= n) {
-							std::reverse(opcodes.begin() + j, opcodes.begin() + j + i);
-							std::reverse(opcodes.begin() , opcodes.begin() + j);
-							std::reverse(opcodes.begin(), opcodes.begin() + j + i);
-							removed = true;
-							++cnt;
-						} else {
-							ok = false;
-						}
-						break;
+		//            ; a b
+		// SWAP       ; b a
+		// gen(0, 1)  ; b a c
+		// ROT        ; a c b
+		// =>
+		// gen(0,1)
+		// SWAP
+		{3, swaps, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (isSWAP(w.cmd1)) {
+				std::optional<std::pair<int, int>> rot = isBLKSWAP(w.cmd3);
+				if (rot && *rot == std::make_pair(1, 2)) {
+					if (isPureGen01(*w.cmd2)) {
+						return Result{Rule::SwapGen01Rot, 3, w.cmd2, makeXCH_S(1)};
 					}
-					case Stack::Opcode::REVERSE: {
-						if (j < n && j + i <= n) {
-							std::reverse(opcodes.begin() + j, opcodes.begin() + j + i);
-							removed = true;
-							++cnt;
-						} else {
-							ok = false;
-						}
-						break;
+				}
+			}
+			return {};
+		}},
+
+		{3, {OpKind::PushCellOrSlice}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd1PushCellOrSlice = dyn_cast<PushCellOrSlice>(w.cmd1.get());
+			auto cmd2PushCellOrSlice = dyn_cast<PushCellOrSlice>(w.cmd2.get());
+			auto cmd3SubProgram = dyn_cast<SubProgram>(w.cmd3.get());
+			if (cmd1PushCellOrSlice && cmd1PushCellOrSlice->type() == PushCellOrSlice::Type::PUSHREF &&
+				cmd2PushCellOrSlice && cmd2PushCellOrSlice->type() == PushCellOrSlice::Type::PUSHREF
+			) {
+				if (cmd3SubProgram) {
+					std::vector<Pointer<TvmAstNode>> const& instructions = cmd3SubProgram->block()->instructions();
+					if (instructions.size() == 1 &&
+						*instructions.at(0) == *createNode<StackOpcode>(".inline __concatenateStrings", 2, 1)) {
+						string hexStr = cmd1PushCellOrSlice->chainBlob() + cmd2PushCellOrSlice->chainBlob();
+						return Result{Rule::ConcatenateConstStrings, 3, makePushCellOrSlice(hexStr, false)};
 					}
-					case Stack::Opcode::XCHG: {
-						if (i < n && j < n) {
-							swap(opcodes[i], opcodes[j]);
-							removed = true;
-							++cnt;
-						} else {
-							ok = false;
+				}
+			}
+			return {};
+		}},
+
+		// TODO delete, fix in stackOpt
+		// Note: breaking stack
+		// DUP
+		// IFREF { CALL $c7_to_c4$ / $upd_only_time_in_c4$ }
+		// =>
+		// IFREF { CALL $c7_to_c4$ / $upd_only_time_in_c4$ }
+		{3, pushes, [](PrivatePeepholeOptimizer const& self, Window const& w) -> std::optional<Result> {
+			if (self.m_flags.test(OptFlags::UnpackOpaque) && isPUSH(w.cmd1)) {
+				if (auto ifRef = dyn_cast<TvmIfElse>(w.cmd2.get());
+					ifRef && !ifRef->withJmp() && !ifRef->withNot() && ifRef->falseBody() == nullptr
+				) {
+					std::vector<Pointer<TvmAstNode>> const &cmds = ifRef->trueBody()->instructions();
+					if (cmds.size() == 1) {
+						if (auto gen = dyn_cast<StackOpcode>(cmds.at(0).get())) {
+							if (isIn(gen->fullOpcode(), ".inline c7_to_c4", ".inline upd_only_time_in_c4")) {
+								return Result{Rule::DupIfUpdateC4, 2, w.cmd2};
+							}
 						}
-						break;
 					}
-					case Stack::Opcode::PUSH_S: {
-						if (i >= n) {
-							opcodes.emplace_front(get(ii), opcodes.size());
-							++cnt;
-						} else {
-							ok = false;
-						}
-						break;
+				}
+			}
+			return {};
+		}},
+
+		{4, {"PUSHINT"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (is(w.cmd1, "PUSHINT") && is(w.cmd3, "PUSHINT")) {
+				if (isAddOrSub(w.cmd2) && isAddOrSub(w.cmd4)) {
+					bigint sum = 0;
+					sum += (is(w.cmd2, "ADD") ? +1 : -1) * pushintValue(w.cmd1);
+					sum += (is(w.cmd4, "ADD") ? +1 : -1) * pushintValue(w.cmd3);
+					// TODO DELETE
+					return Result{Rule::FoldPushIntAddSub, 4, gen("PUSHINT " + toString(sum)), gen("ADD")};
+				}
+			}
+			return {};
+		}},
+
+		{4, {OpKind::PushCellOrSlice}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (isPlainPushSlice(w.cmd1) &&
+				is(w.cmd2, "NEWC") &&
+				is(w.cmd3, "STSLICECONST") &&
+				is(w.cmd4, "STSLICE")) {
+				std::optional<std::string> slice = StrUtils::unitSlices(arg(w.cmd3), isPlainPushSlice(w.cmd1)->blob());
+				if (slice.has_value()) {
+					return Result{Rule::PushSliceStSliceConst, 4,
+								  genPushSlice(*slice),
+								   gen("NEWC"),
+								   gen("STSLICE")};
+				}
+			}
+			return {};
+		}},
+
+		// TODO if value on the top of the stack < 0
+		// ADDCONST/INC/DEC
+		// UFIT/FIT N
+		// ADDCONST/INC/DEC
+		// UFIT/FIT N
+		// =>
+		// ADDCONST
+		// UFIT/FIT N
+		{4, {"INC", "DEC", "ADDCONST"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (isConstAdd(w.cmd1) && isConstAdd(w.cmd3)) {
+				for (std::string fit : {"UFITS", "FITS"}) {
+					if (is(w.cmd2, fit) && is(w.cmd4, fit) && arg(w.cmd2) == arg(w.cmd4)) {
+						int final_add = getAddNum(w.cmd1) + getAddNum(w.cmd3);
+						if (-128 <= final_add && final_add <= 127)
+							return Result{Rule::ConstAddFitsConstAddFits, 4,
+												   gen("ADDCONST " + std::to_string(final_add)),
+												   gen(fit + " " + arg(w.cmd2))};
 					}
-					// TODO implement another cases
-					default:
-						ok = false;
-						break;
 				}
-				if (!ok) {
-					break;
+			}
+			return {};
+		}},
+
+		{4, {"PUSHINT"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (is(w.cmd1, "PUSHINT") &&
+				is(w.cmd2, "NEWC") &&
+				is(w.cmd3, "STSLICECONST") &&
+				is(w.cmd4, "STU", "STI")) {
+				std::string bitStr = StrUtils::toBitString(arg(w.cmd3));
+				if (auto x = StrUtils::toBitString(pushintValue(w.cmd1), fetchInt(w.cmd4), is(w.cmd4, "STI"))) {
+					bitStr += x.value();
+					std::optional<std::string> slice = StrUtils::unitBitStringToHex(bitStr, "");
+					if (slice.has_value())
+						return Result{Rule::PushIntStSliceConstStore, 4, genPushSlice(*slice), gen("NEWC"), gen("STSLICE")};
 				}
-			} else {
-				break;
 			}
-		}
+			return {};
+		}},
+
+		{4, {OpKind::PushCellOrSlice}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (
+				isPlainPushSlice(w.cmd1) &&
+				is(w.cmd2, "NEWC") &&
+				is(w.cmd3, "STSLICE") &&
+				is(w.cmd4, "ENDC")
+			) {
+				return Result{Rule::PushSliceToCellToPushRef, 4, makePUSHREF(isPlainPushSlice(w.cmd1)->blob())};
+			}
+			return {};
+		}},
+
+		{4, {"PUSHINT"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (is(w.cmd1, "PUSHINT") && pushintValue(w.cmd1) == 0 &&
+				is(w.cmd2, "STUR") &&
+				is(w.cmd3, "PUSHINT") && pushintValue(w.cmd3) == 0 &&
+				is(w.cmd4, "STUR")
+			) {
+				int bitSize = fetchInt(w.cmd2) + fetchInt(w.cmd4);
+				if (bitSize <= 256)
+					return Result{Rule::ZeroStUrZeroStUr, 4, gen("PUSHINT 0"), gen("STUR " + toString(bitSize))};
+			}
+			return {};
+		}},
 
-		if (removed) {
-			vector<Pointer<TvmAstNode>> res;
-			res.reserve(opcodes.size());
-			for (auto const& [opcode, stackSize]  : opcodes | boost::adaptors::reversed) {
-				if (isPUSH(opcode)) {
-					int index = isPUSH(opcode).value();
-					int newStackSize = res.size();
-					int newIndex = index - stackSize + newStackSize;
-					res.emplace_back(makePUSH(newIndex));
-				} else {
-					res.emplace_back(opcode);
+		// PUSHSLICE xXXX
+		// NEWC
+		// STSLICE
+		// STBREFR
+		// =>
+		// PUSHCELL
+		// STREFR
+		{4, {OpKind::PushCellOrSlice}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (
+				isPlainPushSlice(w.cmd1) &&
+				is(w.cmd2, "NEWC") &&
+				is(w.cmd3, "STSLICE") &&
+				is(w.cmd4, "STBREFR")
+			) {
+				return Result{Rule::PushSliceToCellStBRefRToPushRef, 4, makePUSHREF(isPlainPushSlice(w.cmd1)->blob()), gen("STREFR")};
+			}
+			return {};
+		}},
+
+		// DUP
+		// ISNULL
+		// THROWIF 63
+		// UNSINGLE
+		// =>
+		// UNSINGLE
+		{4, pushes, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			auto cmd3Exc = dyn_cast<TvmException>(w.cmd3.get());
+			if (
+				isPUSH(w.cmd1) && isPUSH(w.cmd1).value() == 0 &&
+				is(w.cmd2, "ISNULL") &&
+				cmd3Exc && cmd3Exc->opcode() == "THROWIF" && cmd3Exc->arg() == toString(TvmConst::RuntimeException::GetOptionalException) &&
+				is(w.cmd4, "UNTUPLE") && fetchInt(w.cmd4) == 1
+			) {
+				return Result{Rule::DupIsNullThrowIfUnsingle, 4, w.cmd4};
+			}
+			return {};
+		}},
+
+		// PUSHSLICE A
+		// PUSHSLICE B
+		// NEWC
+		// STSLICE
+		// STSLICE
+		// =>
+		// PUSHSLICE BA
+		// NEWC
+		// STSLICE
+		{5, {OpKind::PushCellOrSlice}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (isPlainPushSlice(w.cmd1) &&
+				isPlainPushSlice(w.cmd2) &&
+				is(w.cmd3, "NEWC") &&
+				is(w.cmd4, "STSLICE") &&
+				is(w.cmd5, "STSLICE")
+			) {
+				std::string bitStr = StrUtils::toBitString(isPlainPushSlice(w.cmd2)->blob()) +
+									 StrUtils::toBitString(isPlainPushSlice(w.cmd1)->blob());
+				std::optional<std::string> slice = StrUtils::unitBitStringToHex(bitStr, "");
+				if (slice.has_value()) {
+					return Result{Rule::PushSlicePushSliceConcat, 5,
+								  genPushSlice(*slice),
+								  gen("NEWC"),
+								  gen("STSLICE")};
 				}
 			}
-			return Result{cnt, res};
-		}
-	}
+			return {};
+		}},
 
-	return {};
+		// PUSHINT ?
+		// PUSHSLICE ?
+		// NEWC
+		// STSLICE ?
+		// STU ?
+		{5, {"PUSHINT"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (is(w.cmd1, "PUSHINT") &&
+				isPlainPushSlice(w.cmd2) &&
+				is(w.cmd3, "NEWC") &&
+				is(w.cmd4, "STSLICE") &&
+				(is(w.cmd5, "STU") || is(w.cmd5, "STI"))
+			) {
+				std::string bitStr = StrUtils::toBitString(isPlainPushSlice(w.cmd2)->blob());
+				if (auto v = StrUtils::toBitString(pushintValue(w.cmd1), fetchInt(w.cmd5), is(w.cmd5, "STI"))) {
+					bitStr += v.value();
+					std::optional<std::string> slice = StrUtils::unitBitStringToHex(bitStr, "");
+					if (slice.has_value()) {
+						return Result{Rule::PushIntPushSliceConcat, 5,
+								genPushSlice(*slice),
+								gen("NEWC"),
+								gen("STSLICE")};
+					}
+				}
+			}
+			return {};
+		}},
+
+		// NULL
+		// PUSHSLICE ?
+		// NEWC
+		// STSLICE ?
+		// STDICT
+		{5, {"NULL"}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (is(w.cmd1, "NULL") &&
+				isPlainPushSlice(w.cmd2) &&
+				is(w.cmd3, "NEWC") &&
+				is(w.cmd4, "STSLICE") &&
+				is(w.cmd5, "STDICT")
+			) {
+				std::string bitStr = StrUtils::toBitString(isPlainPushSlice(w.cmd2)->blob()) +
+					"0";
+				std::optional<std::string> slice = StrUtils::unitBitStringToHex(bitStr, "");
+				if (slice.has_value()) {
+					return Result{Rule::NullPushSliceStDict, 5,
+							genPushSlice(*slice),
+							gen("NEWC"),
+							gen("STSLICE")};
+				}
+			}
+			return {};
+		}},
+
+		{6, {OpKind::PushCellOrSlice}, [](PrivatePeepholeOptimizer const&, Window const& w) -> std::optional<Result> {
+			if (
+				isPlainPushSlice(w.cmd1) &&
+				is(w.cmd2, "NEWC") &&
+				is(w.cmd3, "STSLICE") &&
+				is(w.cmd4, "NEWC") &&
+				is(w.cmd5, "STSLICECONST") &&
+				is(w.cmd6, "STB")
+			) {
+				std::string str1 = StrUtils::toBitString(isPlainPushSlice(w.cmd1)->blob());
+				std::string str5 = StrUtils::toBitString(arg(w.cmd5));
+				std::optional<std::string> slice = StrUtils::unitBitStringToHex(str5, str1);
+				if (slice.has_value()) {
+					return Result{Rule::PushSliceStSliceConstStB, 6,
+								  genPushSlice(*slice),
+								  gen("NEWC"),
+								  gen("STSLICE")
+					};
+				}
+			}
+			return {};
+		}},
+	};
 }
 
 bool PrivatePeepholeOptimizer::hasRetOrJmp(TvmAstNode const* _node) {
-	if (auto opaque = to<Opaque>(_node)) {
+	if (auto opaque = dyn_cast<Opaque>(_node)) {
 		for (Pointer<TvmAstNode> const& i : opaque->block()->instructions()) {
 			if (hasRetOrJmp(i.get())) {
 				return true;
 			}
 		}
 	}
-	if (auto cb = to<CodeBlock>(_node)) {
+	if (auto cb = dyn_cast<CodeBlock>(_node)) {
 		for (Pointer<TvmAstNode> const& i : cb->instructions()) {
 			if (hasRetOrJmp(i.get())) {
 				return true;
 			}
 		}
 	}
-	if (to<ReturnOrBreakOrCont>(_node)) {
+	if (isa<ReturnOrBreakOrCont>(_node)) {
 		return true;
 	}
-	if (to<TvmReturn>(_node)) {
+	if (isa<TvmReturn>(_node)) {
 		return true;
 	}
-	if (auto sub = to<SubProgram>(_node)) {
+	if (auto sub = dyn_cast<SubProgram>(_node)) {
 		if (sub->isJmp())
 			return true;
 	}
-	if (auto isElse = to<TvmIfElse>(_node)) {
+	if (auto isElse = dyn_cast<TvmIfElse>(_node)) {
 		if (isElse->withJmp())
 			return true;
 	}
@@ -2219,18 +3132,18 @@ bool PrivatePeepholeOptimizer::hasRetOrJmp(TvmAstNode const* _node) {
 
 std::optional<Result> PrivatePeepholeOptimizer::unsquash(bool _withUnpackOpaque, const int idx1) const {
 	auto c = get(idx1);
-	auto stack = to<Stack>(c.get());
+	auto stack = dyn_cast<Stack>(c.get());
 	if (isStack(c, Stack::Opcode::PUSH2_S)) {
 		int si = stack->i();
 		int sj = stack->j() + 1;
-		return Result{1, makePUSH(si), makePUSH(sj)};
+		return Result{Rule::UnsquashPush2, 1, makePUSH(si), makePUSH(sj)};
 	}
 	if (_withUnpackOpaque) {
-		if (auto ret = to<ReturnOrBreakOrCont>(c.get())) {
-			return Result{1, ret->body()->instructions()};
+		if (auto ret = dyn_cast<ReturnOrBreakOrCont>(c.get())) {
+			return Result{Rule::UnpackReturn, 1, ret->body()->instructions()};
 		}
-		if (auto op = to<Opaque>(c.get())) {
-			return Result{1, op->block()->instructions()};
+		if (auto op = dyn_cast<Opaque>(c.get())) {
+			return Result{Rule::UnpackOpaque, 1, op->block()->instructions()};
 		}
 	}
 	return {};
@@ -2242,8 +3155,8 @@ std::optional<Result> PrivatePeepholeOptimizer::squash(const int idx1) const {
 	Pointer<TvmAstNode> const& cmd1 = get(idx1);
 	Pointer<TvmAstNode> const& cmd2 = get(idx2);
 	Pointer<TvmAstNode> const& cmd3 = get(idx3);
-	auto cmd1Gen = to<Gen>(cmd1.get());
-	auto cmd1PushCellOrSlice = to<PushCellOrSlice>(cmd1.get());
+	auto cmd1Gen = dyn_cast<Gen>(cmd1.get());
+	auto cmd1PushCellOrSlice = dyn_cast<PushCellOrSlice>(cmd1.get());
 
 	if (isPUSH(cmd1) && isPUSH(cmd2)) {
 		int i = idx1, n = 0;
@@ -2252,7 +3165,7 @@ std::optional<Result> PrivatePeepholeOptimizer::squash(const int idx1) const {
 			i = nextCommandLine(i);
 		}
 		if (n >= 2 && isPUSH(cmd1) <= 15) {
-			return Result{n, makeBLKPUSH(n, isPUSH(cmd1).value())};
+			return Result{Rule::SquashPushToBlkPush, n, makeBLKPUSH(n, isPUSH(cmd1).value())};
 		}
 	}
 
@@ -2263,7 +3176,7 @@ std::optional<Result> PrivatePeepholeOptimizer::squash(const int idx1) const {
 				*isPUSH(cmd3) - 2 == -2? sj : *isPUSH(cmd3) - 2
 		);
 		if (si <= 15 && sj <= 15 && sk <= 15) {
-			return Result{3, makePUSH3(si, sj, sk)};
+			return Result{Rule::SquashPushToPush3, 3, makePUSH3(si, sj, sk)};
 		}
 	}
 
@@ -2271,7 +3184,7 @@ std::optional<Result> PrivatePeepholeOptimizer::squash(const int idx1) const {
 		const int si = *isPUSH(cmd1);
 		const int sj = *isPUSH(cmd2) - 1 == -1? si : *isPUSH(cmd2) - 1;
 		if (si <= 15 && sj <= 15) {
-			return Result{2, makePUSH2(si, sj)};
+			return Result{Rule::SquashPushToPush2, 2, makePUSH2(si, sj)};
 		}
 	}
 
@@ -2281,7 +3194,7 @@ std::optional<Result> PrivatePeepholeOptimizer::squash(const int idx1) const {
 		int i = idx1;
 		int n = 0;
 		while (true) {
-			auto cmdI = to<Gen>(get(i).get());
+			auto cmdI = dyn_cast<Gen>(get(i).get());
 			if  (cmdI && *cmd1Gen == *cmdI) {
 				n++;
 				i = nextCommandLine(i);
@@ -2290,7 +3203,7 @@ std::optional<Result> PrivatePeepholeOptimizer::squash(const int idx1) const {
 			}
 		}
 		if (n >= 2) {
-			return Result{n, cmd1, makeBLKPUSH(n - 1, 0)};
+			return Result{Rule::SquashGen01ToBlkPush, n, cmd1, makeBLKPUSH(n - 1, 0)};
 		}
 	}
 
@@ -2299,7 +3212,7 @@ std::optional<Result> PrivatePeepholeOptimizer::squash(const int idx1) const {
 		int i = idx1;
 		int n = 0;
 		while (true) {
-			auto cmdI = to<PushCellOrSlice>(get(i).get());
+			auto cmdI = dyn_cast<PushCellOrSlice>(get(i).get());
 			if  (cmdI && *cmd1PushCellOrSlice == *cmdI)
 			{
 				n++;
@@ -2309,7 +3222,7 @@ std::optional<Result> PrivatePeepholeOptimizer::squash(const int idx1) const {
 			}
 		}
 		if (n >= 2) {
-			return Result{n, cmd1, makeBLKPUSH(n - 1, 0)};
+			return Result{Rule::SquashPushRefToBlkPush, n, cmd1, makeBLKPUSH(n - 1, 0)};
 		}
 	}
 
@@ -2322,7 +3235,7 @@ std::optional<Result> PrivatePeepholeOptimizer::squash(const int idx1) const {
 	) {
 		int i = *isPUSH(cmd1);
 		if (0 <= i && i <= 15)
-			return Result{2, makePUXC(i, -1)};
+			return Result{Rule::SquashPushSwapToPuxc, 2, makePUXC(i, -1)};
 	}
 
 	// XCHG Si
@@ -2338,13 +3251,30 @@ std::optional<Result> PrivatePeepholeOptimizer::squash(const int idx1) const {
 			0 <= i && i <= 15 &&
 			0 <= j && j <= 15
 		) {
-			return Result{2, makeXCPU(i, j)};
+			return Result{Rule::SquashXchgPushToXcpu, 2, makeXCPU(i, j)};
 		}
 	}
 
 	return {};
 }
 
+template<class F>
+std::optional<Result> PrivatePeepholeOptimizer::match(char const* _matcher, F const& _match) const {
+	if (!m_stats)
+		return _match();
+	auto const start = std::chrono::steady_clock::now();
+	std::optional<Result> res = _match();
+	m_stats->addMatch(_matcher, std::chrono::steady_clock::now() - start, res.has_value());
+	return res;
+}
+
+void PrivatePeepholeOptimizer::countHit(int idx1, Result const& res) const {
+	std::vector<Pointer<TvmAstNode>> removed;
+	for (int i = idx1, n = 0; n < res.removeQty; i = nextCommandLine(i), ++n)
+		removed.push_back(m_instructions.at(i));
+	frontend::countHit(*m_stats, res, removed);
+}
+
 void PrivatePeepholeOptimizer::updateLinesAndIndex(int idx1, const std::optional<Result>& res) {
 	solAssert(res, "");
 	if (res && res.value().removeQty > 0) {
@@ -2364,40 +3294,44 @@ void PrivatePeepholeOptimizer::updateLinesAndIndex(int idx1, const std::optional
 			}
 		}
 
-		// save opcodes after the peephole
-		std::vector<Pointer<TvmAstNode>> codeTail(m_instructions.begin() + lastInx + 1, m_instructions.end());
-		// delete the peephole and all after it
-		m_instructions.erase(m_instructions.begin() + idx1, m_instructions.end());
-		// insert new peephole
-		for (Pointer<TvmAstNode> const& inst : res.value().commands) {
-			m_instructions.emplace_back(inst);
-		}
-		// insert .loc if it presents
+		// replace the peephole with the new one and .loc if it presents
+		std::vector<Pointer<TvmAstNode>> commands = res.value().commands;
 		if (locLine != nullptr) {
-			m_instructions.push_back(locLine);
+			commands.push_back(locLine);
 		}
-		// insert the tail
-		m_instructions.insert(m_instructions.end(), codeTail.begin(), codeTail.end());
+		m_instructions.replace(idx1, lastInx + 1, commands);
 	}
 }
 
 bool PrivatePeepholeOptimizer::optimize(const std::function<std::optional<Result>(int)> &f) {
+	m_instructions.setAllDirty();
+	return pass(f);
+}
+
+void PrivatePeepholeOptimizer::optimizeUntilFixpoint(const std::function<std::optional<Result>(int)> &f) {
+	m_instructions.setAllDirty();
+	while (pass(f)) {
+	}
+}
+
+bool PrivatePeepholeOptimizer::pass(const std::function<std::optional<Result>(int)> &f) {
 	int idx1 = 0;
-	while (idx1 < static_cast<int>(m_instructions.size()) && isLoc(m_instructions.at(idx1))) {
+	while (idx1 < m_instructions.size() && isLoc(m_instructions.at(idx1))) {
 		++idx1;
 	}
 
 	bool didSomething = false;
 	while (valid(idx1)) {
 		solAssert(!isLoc(m_instructions.at(idx1)), "");
+		if (!m_instructions.dirty(idx1)) {
+			idx1 = nextCommandLine(idx1);
+			continue;
+		}
+		m_lastRead = idx1;
 		std::optional<Result> res = f(idx1);
 		if (res) {
-			{
-//				std::cout << ">>>A\n";
-//				Printer p{std::cout};
-//				for (const auto &x: m_instructions) x->accept(p);
-//				std::cout << std::endl;
-			}
+			if (m_stats)
+				countHit(idx1, *res);
 			didSomething = true;
 			updateLinesAndIndex(idx1, res);
 			// step back to several commands
@@ -2409,15 +3343,11 @@ bool PrivatePeepholeOptimizer::optimize(const std::function<std::optional<Result
 				if (!isLoc(m_instructions.at(idx1)))
 					--cnt;
 			}
-			while (idx1 < static_cast<int>(m_instructions.size()) && isLoc(m_instructions.at(idx1))) {
+			while (idx1 < m_instructions.size() && isLoc(m_instructions.at(idx1))) {
 				++idx1;
 			}
-
-//			std::cout << "<<<B\n";
-//			Printer p{std::cout};
-//			for (const auto& x : m_instructions) x->accept(p);
-//			std::cout << std::endl;
 		} else {
+			m_instructions.setClean(idx1, m_lastRead);
 			idx1 = nextCommandLine(idx1);
 		}
 	}
@@ -2426,11 +3356,11 @@ bool PrivatePeepholeOptimizer::optimize(const std::function<std::optional<Result
 
 std::optional<std::pair<int, int>> PrivatePeepholeOptimizer::isBLKDROP2(Pointer<TvmAstNode> const& node) {
 	if (isStack(node, Stack::Opcode::BLKDROP2)) {
-		auto stack = to<Stack>(node.get());
+		auto stack = dyn_cast<Stack>(node.get());
 		return {{stack->i(), stack->j()}};
 	}
 	if (isStack(node, Stack::Opcode::POP_S)) {
-		auto stack = to<Stack>(node.get());
+		auto stack = dyn_cast<Stack>(node.get());
 		if (stack->i() == 1)
 			return {{1, 1}};
 	}
@@ -2439,31 +3369,31 @@ std::optional<std::pair<int, int>> PrivatePeepholeOptimizer::isBLKDROP2(Pointer<
 
 bigint PrivatePeepholeOptimizer::pushintValue(Pointer<TvmAstNode> const& node) {
 	solAssert(is(node, "PUSHINT"), "");
-	auto g = dynamic_pointer_cast<StackOpcode>(node);
+	auto g = dyn_cast<StackOpcode>(node);
 	return bigint{g->arg()};
 }
 
 int PrivatePeepholeOptimizer::fetchInt(Pointer<TvmAstNode> const& node) {
-	auto g = dynamic_pointer_cast<StackOpcode>(node);
+	auto g = dyn_cast<StackOpcode>(node);
 	return strToInt(g->arg());
 }
 
 bool PrivatePeepholeOptimizer::isNIP(Pointer<TvmAstNode> const& node) {
-	auto swap = dynamic_pointer_cast<Stack>(node);
+	auto swap = dyn_cast<Stack>(node);
 	return
 	(isPOP(node) && isPOP(node).value() == 1) ||
 	(isBLKDROP2(node) && isBLKDROP2(node).value() == std::make_pair(1, 1));
 }
 
 std::string PrivatePeepholeOptimizer::arg(Pointer<TvmAstNode> const& node) {
-	auto g = dynamic_pointer_cast<StackOpcode>(node);
+	auto g = dyn_cast<StackOpcode>(node);
 	solAssert(g, "");
 	return g->arg();
 }
 
 template<class ...Args>
 bool PrivatePeepholeOptimizer::is(Pointer<TvmAstNode> const& node, Args&&... cmd) {
-	auto g = to<StackOpcode>(node.get());
+	auto g = dyn_cast<StackOpcode>(node.get());
 	return g && isIn(g->opcode(), std::forward<Args>(cmd)...);
 }
 
@@ -2475,18 +3405,18 @@ std::pair<int, int> PrivatePeepholeOptimizer::getIndexes(std::string const& str)
 
 template<class ...Args>
 bool PrivatePeepholeOptimizer::isExc(Pointer<TvmAstNode> const& node, Args&&... cmd) {
-	auto cfi = to<TvmException>(node.get());
+	auto cfi = dyn_cast<TvmException>(node.get());
 	return cfi && isIn(cfi->opcode(), std::forward<Args>(cmd)...);
 }
 
 bool PrivatePeepholeOptimizer::isConstAdd(Pointer<TvmAstNode> const& node) {
-	auto gen = to<StackOpcode>(node.get());
+	auto gen = dyn_cast<StackOpcode>(node.get());
 	return gen && isIn(gen->opcode(), "INC", "DEC", "ADDCONST");
 }
 
 int PrivatePeepholeOptimizer::getAddNum(Pointer<TvmAstNode> const& node) {
 	solAssert(isConstAdd(node), "");
-	auto gen = to<StackOpcode>(node.get());
+	auto gen = dyn_cast<StackOpcode>(node.get());
 	solAssert(gen, "");
 	if (gen->opcode() == "INC") {
 		return +1;
@@ -2501,16 +3431,16 @@ int PrivatePeepholeOptimizer::getAddNum(Pointer<TvmAstNode> const& node) {
 }
 
 bool PrivatePeepholeOptimizer::isStack(Pointer<TvmAstNode> const& node, Stack::Opcode op) {
-	auto stack = to<Stack>(node.get());
+	auto stack = dyn_cast<Stack>(node.get());
 	return stack && stack->opcode() == op;
 }
 
 
 bool PrivatePeepholeOptimizer::isSimpleCommand(Pointer<TvmAstNode> const& node) {
 	// See also isPureGen01
-	auto gen = to<Gen>(node.get());
+	auto gen = dyn_cast<Gen>(node.get());
 	return gen &&
-		   (to<StackOpcode>(gen) || to<PushCellOrSlice>(gen) || to<Glob>(gen) || to<Opaque>(gen) || to<HardCode>(gen)) &&
+		   (isa<StackOpcode>(gen) || isa<PushCellOrSlice>(gen) || isa<Glob>(gen) || isa<Opaque>(gen) || isa<HardCode>(gen)) &&
 		gen->take() == 0 && gen->ret() == 1;
 }
 
@@ -2519,7 +3449,7 @@ bool PrivatePeepholeOptimizer::isAddOrSub(Pointer<TvmAstNode> const& node) {
 }
 
 bool PrivatePeepholeOptimizer::isCommutative(Pointer<TvmAstNode> const& node) {
-	auto g = dynamic_pointer_cast<StackOpcode>(node);
+	auto g = dyn_cast<StackOpcode>(node);
 	return g && isIn(g->fullOpcode(),
 					 "ADD",
 					 "AND",
@@ -2552,7 +3482,9 @@ void PeepholeOptimizer::optimizeBlock(CodeBlock &_node) const {
 	{
 		std::optional<Result> r = PrivatePeepholeOptimizer{{}, m_flags}.optimizeAt1(_node.shared_from_this());
 		if (r && r.value().commands.size() == 1) {
-			auto newBlock = to<CodeBlock>(r.value().commands.at(0).get());
+			if (m_stats)
+				countHit(*m_stats, *r, {_node.shared_from_this()});
+			auto newBlock = dyn_cast<CodeBlock>(r.value().commands.at(0).get());
 			_node.upd(newBlock->instructions());
 			_node.updType(newBlock->type());
 		}
@@ -2560,20 +3492,22 @@ void PeepholeOptimizer::optimizeBlock(CodeBlock &_node) const {
 
 	std::vector<Pointer<TvmAstNode>> instructions = _node.instructions();
 
-	PrivatePeepholeOptimizer optimizer{instructions, m_flags};
+	PrivatePeepholeOptimizer optimizer{instructions, m_flags, m_stats};
 	optimizer.optimize([&](int index){
-		return optimizer.unsquash(m_flags.test(OptFlags::UnpackOpaque), index);
+		return optimizer.match("unsquash", [&]{ return optimizer.unsquash(m_flags.test(OptFlags::UnpackOpaque), index); });
 	});
 
 	if (m_flags.test(OptFlags::OptimizeSlice))
-		while (optimizer.optimize([&optimizer](int index){ return optimizer.optimizeSlice(index); })){
-		}
+		optimizer.optimizeUntilFixpoint([&optimizer](int index){
+			return optimizer.match("optimizeSlice", [&]{ return optimizer.optimizeSlice(index); });
+		});
 	else
-		while (optimizer.optimize([&optimizer](int index){ return optimizer.optimizeAt(index); })) {
-		}
+		optimizer.optimizeUntilFixpoint([&optimizer](int index){ return optimizer.optimizeAt(index); });
 
 	if (m_flags.test(OptFlags::UseCompoundOpcodes))
-		optimizer.optimize([&optimizer](int index){ return optimizer.squash(index);});
+		optimizer.optimize([&optimizer](int index){
+			return optimizer.match("squash", [&]{ return optimizer.squash(index); });
+		});
 	_node.upd(optimizer.instructions());
 }
 
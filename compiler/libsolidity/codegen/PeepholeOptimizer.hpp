@@ -17,18 +17,57 @@
 #pragma once
 
 #include <bitset>
+#include <chrono>
+#include <map>
 #include <libsolidity/codegen/TvmAstVisitor.hpp>
 
+#include <json/json.h>
+
 namespace solidity::frontend {
 enum OptFlags : unsigned {
 	UnpackOpaque = 0,
 	OptimizeSlice = 1,
 	UseCompoundOpcodes = 2
 };
+
+/**
+ * Counters of the peephole optimizer over all its runs on a contract: how often each rewrite rule
+ * fired and the bits and gas it saved, estimated with TVMCodeMetrics, and the time spent in each
+ * matcher. The rules are tried one after another in a few matchers, so the time is measured per
+ * matcher and not per rule.
+ */
+class PeepholeStats {
+public:
+	PeepholeStats();
+
+	/// Records that the rule @a _rule replaced instructions of @a _oldBits and @a _oldGas with
+	/// instructions of @a _newBits and @a _newGas.
+	void addHit(std::size_t _rule, int _oldBits, int _oldGas, int _newBits, int _newGas);
+	void addMatch(std::string const& _matcher, std::chrono::nanoseconds _time, bool _matched);
+
+	/// @returns the counters of all rules, including the rules that never fired, and of the matchers.
+	Json::Value toJson() const;
+
+private:
+	struct RuleCounters {
+		int64_t hits{};
+		int64_t bitsSaved{};
+		int64_t gasSaved{};
+	};
+	struct MatcherCounters {
+		int64_t calls{};
+		int64_t matches{};
+		std::chrono::nanoseconds time{};
+	};
+	std::vector<RuleCounters> m_rules;
+	std::map<std::string, MatcherCounters> m_matchers;
+};
+
 class PeepholeOptimizer : public TvmAstVisitor {
 public:
-	explicit PeepholeOptimizer(std::bitset<3> const _flags)
-		: m_flags{_flags } { }
+	/// Counts the rewrites in @a _stats if it is not null.
+	explicit PeepholeOptimizer(std::bitset<3> const _flags, PeepholeStats* _stats = nullptr)
+		: m_flags{_flags }, m_stats{_stats} { }
 	bool visit(CodeBlock &_node) override;
 	bool visit(Function &_node) override;
 	void endVisit(CodeBlock &_node) override;
@@ -36,6 +75,7 @@ private:
 	void optimizeBlock(CodeBlock &_node) const;
 private:
 	std::bitset<3> m_flags;
+	PeepholeStats* m_stats{};
 };
 } // end solidity::frontend
 
@@ -17,30 +17,39 @@
 #include <boost/format.hpp>
 #include <boost/range/adaptor/map.hpp>
 
+#include <unordered_map>
+
 #include <libsolidity/codegen/SizeOptimizer.hpp>
 
 using namespace std;
 using namespace solidity::util;
 using namespace solidity::frontend;
 
-struct SPtrNodeLess {
-	bool operator()(const Pointer<PushCellOrSlice> &first, const Pointer<PushCellOrSlice> &second) const {
-		return *first < *second;
-	}
-};
-
 class SizeOptimizerPrivate : public TvmAstVisitor {
 public:
 	bool visit(PushCellOrSlice &_node) override;
 	void upd();
 private:
-	std::map<Pointer<PushCellOrSlice>, std::vector<Pointer<PushCellOrSlice>>, SPtrNodeLess> m_qty;
+	/// The first of each set of equal PUSHSLICE instructions.
+	TvmAstNodeTable m_slices;
+	std::unordered_map<TvmAstNode const*, std::vector<Pointer<PushCellOrSlice>>> m_qty;
+};
+
+/// Makes equal constant cells and continuations in the code blocks of the contract share one node.
+class NodeSharer : public TvmAstVisitor {
+public:
+	void endVisit(CodeBlock &_node) override;
+	void upd();
+private:
+	TvmAstNodeTable m_nodes;
+	/// The new instructions of the blocks, they are set after all nodes are hashed.
+	std::vector<std::pair<CodeBlock*, std::vector<Pointer<TvmAstNode>>>> m_blocks;
 };
 
 bool SizeOptimizerPrivate::visit(PushCellOrSlice &_node) {
 	if (_node.type() == PushCellOrSlice::Type::PUSHSLICE) {
-		auto slice = dynamic_pointer_cast<PushCellOrSlice>(_node.shared_from_this());
-		m_qty[slice].push_back(slice);
+		auto slice = dyn_cast<PushCellOrSlice>(_node.shared_from_this());
+		m_qty[m_slices.intern(slice).get()].push_back(slice);
 	}
 	return false;
 }
@@ -60,8 +69,35 @@ void SizeOptimizerPrivate::upd() {
 	}
 }
 
+void NodeSharer::endVisit(CodeBlock &_node) {
+	std::vector<Pointer<TvmAstNode>> instructions = _node.instructions();
+	bool changed = false;
+	for (Pointer<TvmAstNode>& node : instructions) {
+		if (isa<PushCellOrSlice>(node) || isa<CodeBlock>(node)) {
+			Pointer<TvmAstNode> const& shared = m_nodes.intern(node);
+			if (shared != node) {
+				node = shared;
+				changed = true;
+			}
+		}
+	}
+	if (changed) {
+		m_blocks.emplace_back(&_node, std::move(instructions));
+	}
+}
+
+void NodeSharer::upd() {
+	for (auto& [block, instructions] : m_blocks) {
+		block->upd(std::move(instructions));
+	}
+}
+
 void SizeOptimizer::optimize(Pointer<Contract>& c){
 	SizeOptimizerPrivate sp;
 	c->accept(sp);
 	sp.upd();
+
+	NodeSharer sharer;
+	c->accept(sharer);
+	sharer.upd();
 }
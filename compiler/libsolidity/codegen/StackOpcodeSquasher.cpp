@@ -13,6 +13,7 @@
 
 #include <chrono>
 #include <deque>
+#include <mutex>
 
 #include <libsolidity/codegen/StackOpcodeSquasher.hpp>
 
@@ -294,9 +295,8 @@ void StackState::updHash() {
 }
 
 std::optional<int> StackOpcodeSquasher::gasCost(int startStackSize, StackState const& _state, bool _withCompoundOpcodes) {
-	if (m_dp[_withCompoundOpcodes][StackState::MAX_STACK_DEPTH].empty()) {
-		init();
-	}
+	static std::once_flag initFlag;
+	std::call_once(initFlag, init);
 	auto it = m_dp[_withCompoundOpcodes][startStackSize].find(_state);
 	if (it == m_dp[_withCompoundOpcodes][startStackSize].end()) {
 		return std::nullopt;
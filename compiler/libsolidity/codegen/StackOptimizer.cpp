@@ -314,14 +314,14 @@ void StackOptimizer::endVisitNode(TvmAstNode const&) {
 
 bool StackOptimizer::successfullyUpdate(int index, std::vector<Pointer<TvmAstNode>>& instructions) {
 	Pointer<TvmAstNode> const& op = instructions.at(index);
-	if (to<Loc>(op.get()))
+	if (isa<Loc>(op.get()))
 		return false;
 
 	size_t index2 = index + 1;
 	while (index2 < instructions.size() && isLoc(instructions.at(index2)))
 		++index2;
 
-	auto stack = to<Stack>(op.get());
+	auto stack = dyn_cast<Stack>(op.get());
 	bool ok = false;
 	std::vector<Pointer<TvmAstNode>> commands;
 
@@ -331,13 +331,13 @@ bool StackOptimizer::successfullyUpdate(int index, std::vector<Pointer<TvmAstNod
 	// =>
 	// ...
 	// gen(0, 1)
-	if (auto gen = to<Gen>(op.get());
+	if (auto gen = dyn_cast<Gen>(op.get());
 		gen && gen->isPure() && std::make_pair(gen->take(), gen->ret()) == std::make_pair(0, 1)
 	) {
 		Simulator sim{instructions.begin() + index + 1, instructions.end(), 1, 1, false, true};
 		bool good = true;
 		{
-			auto glob = to<Glob>(op.get());
+			auto glob = dyn_cast<Glob>(op.get());
 			if (glob) {
 				good = glob->opcode() == Glob::Opcode::GetOrGetVar &&
 						sim.setGlobIndexes().count(glob->index()) == 0 &&
@@ -585,7 +585,7 @@ bool StackOptimizer::successfullyUpdate(int index, std::vector<Pointer<TvmAstNod
 		bool isPrevFlag{};
 		if (index > 0) {
 			Pointer<TvmAstNode> prevOp = instructions.at(index - 1);
-			isPrevFlag = to<DeclRetFlag>(prevOp.get()) != nullptr;
+			isPrevFlag = dyn_cast<DeclRetFlag>(prevOp.get()) != nullptr;
 		}
 		if (scopeSize() >= 1 && !isPrevFlag) {
 			auto beg = instructions.begin() + index;
@@ -21,9 +21,9 @@
 using namespace std;
 using namespace solidity::frontend;
 
-solidity::langutil::ErrorReporter* GlobalParams::g_errorReporter{};
-solidity::langutil::CharStreamProvider* GlobalParams::g_charStreamProvider{};
-solidity::util::SetOnce<solidity::langutil::TVMVersion> GlobalParams::g_tvmVersion{};
+thread_local solidity::langutil::ErrorReporter* GlobalParams::g_errorReporter{};
+thread_local solidity::langutil::CharStreamProvider* GlobalParams::g_charStreamProvider{};
+thread_local std::optional<solidity::langutil::TVMVersion> GlobalParams::g_tvmVersion{};
 
 std::string getPathToFiles(
 	const std::string& solFileName,
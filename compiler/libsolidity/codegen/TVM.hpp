@@ -16,18 +16,19 @@
 
 #pragma once
 
+#include <optional>
 #include <vector>
 #include <liblangutil/ErrorReporter.h>
 #include <liblangutil/TVMVersion.h>
 #include <libsolidity/ast/ASTForward.h>
 #include <liblangutil/CharStreamProvider.h>
-#include <libsolutil/SetOnce.h>
 
+// Parameters of the compilation that runs on the current thread (see CompilerStack::activate).
 class GlobalParams {
 public:
-	static solidity::langutil::ErrorReporter* g_errorReporter;
-	static solidity::langutil::CharStreamProvider* g_charStreamProvider;
-	static solidity::util::SetOnce<solidity::langutil::TVMVersion> g_tvmVersion;
+	static thread_local solidity::langutil::ErrorReporter* g_errorReporter;
+	static thread_local solidity::langutil::CharStreamProvider* g_charStreamProvider;
+	static thread_local std::optional<solidity::langutil::TVMVersion> g_tvmVersion;
 };
 
 std::string getPathToFiles(
@@ -600,6 +600,11 @@ int DecodePositionAbiV2::countOfCreatedBuilders() const {
 	return m_countOfCreatedBuilders;
 }
 
+// Returns true if parameters are split into cells in the same way for both positions
+bool DecodePositionAbiV2::hasSameLayout(DecodePositionAbiV2 const& other) const {
+	return m_doLoadNextCell == other.m_doLoadNextCell;
+}
+
 ChainDataDecoder::ChainDataDecoder(StackPusher *pusher) :
 		pusher{pusher} {
 
@@ -636,6 +641,15 @@ void ChainDataDecoder::decodePublicFunctionParameters(
 }
 
 void ChainDataDecoder::decodeFunctionParameters(const std::vector<Type const*>& types, bool isResponsible) {
+	// Headers of internal and external messages have different lengths. But usually parameters take the same cells
+	// for both of them, so we decode parameters once and don't branch on the type of the message.
+	DecodePositionAbiV2 internalPosition{minBits(isResponsible), 0, types};
+	DecodePositionAbiV2 externalPosition{maxBits(isResponsible), 0, types};
+	if (internalPosition.hasSameLayout(externalPosition)) {
+		decodePublicFunctionParameters(types, isResponsible, true);
+		return;
+	}
+
 	pusher->startOpaque();
 	pusher->pushS(1);
 	pusher->fixStack(-1); // fix stack
@@ -731,7 +745,9 @@ void ChainDataDecoder::decodeParameter(Type const* type, DecodePosition* positio
 		solAssert(ti.isNumeric, "");
 		loadNextSliceIfNeed(position->loadNextCell(type));
 		pusher->load(type, false);
-		if (auto enumType = to<EnumType>(type)) {
+		auto enumType = to<EnumType>(type);
+		// there is no need to check the value if all values that fit in `numBits` are valid
+		if (enumType && (bigint(1) << ti.numBits) > enumType->numberOfMembers()) {
 			pusher->pushS(1);
 			pusher->pushInt(enumType->enumDefinition().members().size());
 			*pusher << "GEQ";
@@ -70,6 +70,7 @@ public:
 	DecodePositionAbiV2(int _bitOffset, int _refOffset, const std::vector<Type const *>& _types);
 	bool loadNextCell(Type const* type) override;
 	int countOfCreatedBuilders() const;
+	bool hasSameLayout(DecodePositionAbiV2 const& other) const;
 private:
 	void initTypes(Type const* type);
 
@@ -210,6 +210,53 @@ bool ContactsUsageScanner::visit(const FunctionDefinition &fd) {
 	return true;
 }
 
+ScalarStructFinder::ScalarStructFinder(Block const& _block) {
+	_block.accept(*this);
+}
+
+bool ScalarStructFinder::visit(VariableDeclarationStatement const& _statement) {
+	// the loop drops its variable as a single stack slot
+	if (_statement.declarations().size() != 1 || m_loopDeclarations.count(&_statement))
+		return true;
+	VariableDeclaration const* variable = _statement.declarations().at(0).get();
+	if (variable == nullptr)
+		return true;
+	if (auto structType = to<StructType>(variable->type())) {
+		size_t const memberQty = structType->structDefinition().members().size();
+		if (1 <= memberQty && memberQty <= MaxMemberQty)
+			m_scalarStructs.insert(variable);
+	}
+	return true;
+}
+
+bool ScalarStructFinder::visit(ForStatement const& _forStatement) {
+	m_loopDeclarations.insert(_forStatement.initializationExpression());
+	return true;
+}
+
+bool ScalarStructFinder::visit(ForEachStatement const& _forStatement) {
+	m_loopDeclarations.insert(_forStatement.rangeDeclaration());
+	return true;
+}
+
+bool ScalarStructFinder::visit(MemberAccess const& _memberAccess) {
+	auto identifier = to<Identifier>(&_memberAccess.expression());
+	if (identifier &&
+		to<StructType>(getType(identifier)) &&
+		to<VariableDeclaration>(_memberAccess.annotation().referencedDeclaration)
+	)
+		m_memberBases.insert(identifier);
+	return true;
+}
+
+bool ScalarStructFinder::visit(Identifier const& _identifier) {
+	// the whole struct is used, so it must be a tuple
+	if (!m_memberBases.count(&_identifier))
+		if (auto variable = to<VariableDeclaration>(_identifier.annotation().referencedDeclaration))
+			m_scalarStructs.erase(variable);
+	return true;
+}
+
 bool withPrelocatedRetValues(const FunctionDefinition *f) {
 	LocationReturn locationReturn = ::notNeedsPushContWhenInlining(f->body());
 	if (!f->returnParameters().empty() && isIn(locationReturn, LocationReturn::noReturn, LocationReturn::Anywhere)) {
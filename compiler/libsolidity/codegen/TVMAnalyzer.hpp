@@ -74,6 +74,28 @@ private:
 	std::set<Declaration const*> m_usedFunctions;
 };
 
+// Finds local struct variables that are used only to access their members. Members of such variables are kept in
+// separate stack slots instead of a tuple.
+class ScalarStructFinder: public ASTConstVisitor
+{
+public:
+	explicit ScalarStructFinder(Block const& _block);
+	std::set<VariableDeclaration const*> const& scalarStructs() const { return m_scalarStructs; }
+
+protected:
+	bool visit(VariableDeclarationStatement const& _statement) override;
+	bool visit(ForStatement const& _forStatement) override;
+	bool visit(ForEachStatement const& _forStatement) override;
+	bool visit(MemberAccess const& _memberAccess) override;
+	bool visit(Identifier const& _identifier) override;
+
+private:
+	static constexpr size_t MaxMemberQty = 8;
+	std::set<VariableDeclaration const*> m_scalarStructs;
+	std::set<Statement const*> m_loopDeclarations;
+	std::set<Identifier const*> m_memberBases;
+};
+
 template <typename T>
 static bool doesAlways(const Statement* st) {
 	auto rec = [] (const Statement* s) {
@@ -0,0 +1,709 @@
+/*
+ * Copyright (C) 2025 EverX. All Rights Reserved.
+ *
+ * Licensed under the  terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the  GNU General Public License for more details at: https://www.gnu.org/licenses/gpl-3.0.html
+ */
+/**
+ * Estimation of the size and the gas of the TVM code of a contract
+ */
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <libsolidity/codegen/TVMCodeMetrics.hpp>
+#include <libsolidity/codegen/TVMCommons.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+using namespace solidity;
+using namespace solidity::util;
+using namespace solidity::frontend;
+
+namespace {
+
+int constexpr maxCellBits = 1023;
+int constexpr maxCellRefs = 4;
+
+int basicGas(int _bits, int _refs = 0) {
+	return 10 + _bits + 5 * _refs;
+}
+
+/// @returns the mnemonic and the argument of the instruction @a _instruction without its comment.
+std::pair<std::string, std::string> splitInstruction(std::string const& _instruction) {
+	std::string const text = boost::algorithm::trim_copy(_instruction.substr(0, _instruction.find(';')));
+	auto const pos = text.find(' ');
+	std::string const mnemonic = text.substr(0, pos);
+	std::string const arg = pos == std::string::npos ? "" : boost::algorithm::trim_copy(text.substr(pos + 1));
+	return {mnemonic, arg};
+}
+
+std::optional<int> toInt(std::string const& _str) {
+	int value{};
+	if (boost::conversion::try_lexical_convert(_str, value))
+		return value;
+	return {};
+}
+
+/// @returns the index of the stack register "S<i>" or nullopt if @a _str is not a stack register.
+std::optional<int> stackIndex(std::string const& _str) {
+	std::string const str = boost::algorithm::trim_copy(_str);
+	if (str.size() < 2 || (str[0] != 'S' && str[0] != 's'))
+		return {};
+	return toInt(str.substr(1));
+}
+
+int pushIntBits(std::string const& _value) {
+	// Function ids are substituted by the assembler and take 32 bits.
+	if (_value.empty() || _value.at(0) == '$')
+		return 48;
+	bigint value;
+	try {
+		value = bigint{_value};
+	} catch (...) {
+		return 48;
+	}
+	if (MathConsts::power2Exp().count(value) && MathConsts::power2Exp().at(value) >= 7)
+		return 16; // PUSHPOW2
+	if (MathConsts::power2DecExp().count(value) && MathConsts::power2DecExp().at(value) >= 8)
+		return 16; // PUSHPOW2DEC
+	if (MathConsts::power2NegExp().count(value) && MathConsts::power2NegExp().at(value) >= 8)
+		return 16; // PUSHNEGPOW2
+	if (-5 <= value && value <= 10)
+		return 8;
+	if (-128 <= value && value < 128)
+		return 16;
+	if (-32768 <= value && value < 32768)
+		return 24;
+	// 8-bit prefix, 5-bit length l and a value of 8 * l + 19 bits
+	int valueBits = 19;
+	while (value < -(bigint(1) << (valueBits - 1)) || value >= (bigint(1) << (valueBits - 1)))
+		valueBits += 8;
+	return 13 + valueBits;
+}
+
+int pushSliceBits(int _dataBits) {
+	// The data and its completion tag take 8 * x + 4 bits after a 12-bit prefix if x < 16,
+	// and 8 * x + 6 bits after an 18-bit prefix otherwise.
+	int const shortLength = std::max(0, (_dataBits + 1 - 4 + 7) / 8);
+	if (shortLength < 16)
+		return 16 + 8 * shortLength;
+	return 24 + 8 * std::max(0, (_dataBits + 1 - 6 + 7) / 8);
+}
+
+int stackBits(Stack const& _node) {
+	int const i = _node.i();
+	int const j = _node.j();
+	switch (_node.opcode()) {
+	case Stack::Opcode::DROP:
+		if (i <= 2)
+			return 8; // DROP, DROP2
+		if (i <= 15)
+			return 16; // BLKDROP
+		return pushIntBits(std::to_string(i)) + 8; // DROPX
+	case Stack::Opcode::BLKDROP2:
+		if (i > 15 || j > 15)
+			return pushIntBits(std::to_string(i)) + pushIntBits(std::to_string(j)) + 8 + 16;
+		return 16;
+	case Stack::Opcode::POP_S:
+	case Stack::Opcode::PUSH_S:
+		return i < 16 ? 8 : 16;
+	case Stack::Opcode::XCHG:
+		if ((i == 0 || i == 1) && j < 16)
+			return 8;
+		return 16;
+	case Stack::Opcode::BLKSWAP:
+		if (isIn(std::make_pair(i, j), std::make_pair(1, 1), std::make_pair(1, 2), std::make_pair(2, 1), std::make_pair(2, 2)))
+			return 8; // SWAP, ROT, ROTREV, SWAP2
+		if (1 <= i && i <= 16 && 1 <= j && j <= 16)
+			return 16;
+		return pushIntBits(std::to_string(i)) + pushIntBits(std::to_string(j)) + 16;
+	case Stack::Opcode::REVERSE:
+		if ((i == 2 || i == 3) && j == 0)
+			return 8; // SWAP, XCHG S2
+		if (i <= 17 && j <= 15)
+			return 16;
+		return pushIntBits(std::to_string(i)) + pushIntBits(std::to_string(j)) + 16;
+	case Stack::Opcode::BLKPUSH:
+		if (i == 2 && (j == 1 || j == 3))
+			return 8; // DUP2, OVER2
+		return 16 * ((i + 14) / 15);
+	case Stack::Opcode::PUSH2_S:
+		if ((i == 1 && j == 0) || (i == 3 && j == 2))
+			return 8; // DUP2, OVER2
+		return 16;
+	case Stack::Opcode::XCHG3:
+	case Stack::Opcode::XCHG2:
+	case Stack::Opcode::XCPU:
+	case Stack::Opcode::PUXC:
+		return 16;
+	case Stack::Opcode::PUSH3_S:
+	case Stack::Opcode::XC2PU:
+	case Stack::Opcode::XCPU2:
+	case Stack::Opcode::PUXC2:
+	case Stack::Opcode::XCPUXC:
+	case Stack::Opcode::PUXCPU:
+	case Stack::Opcode::PU2XC:
+		return 24;
+	}
+	solUnimplemented("");
+}
+
+int cellChainBits(PushCellOrSlice const& _node) {
+	int bits = getRootBitSize(_node);
+	if (_node.child())
+		bits += cellChainBits(*_node.child());
+	return bits;
+}
+
+int cellChainLength(PushCellOrSlice const& _node) {
+	return 1 + (_node.child() ? cellChainLength(*_node.child()) : 0);
+}
+
+/// @returns the number of cells that a lookup in a dictionary with @a _entries entries loads.
+int dictionaryLevels(std::size_t _entries) {
+	return 1 + static_cast<int>(std::ceil(std::log2(std::max<std::size_t>(_entries, 1))));
+}
+
+/// @returns the gas that the instruction @a _mnemonic costs in addition to its basic gas.
+int extraGas(std::string const& _mnemonic, std::string const& _arg) {
+	static std::set<std::string> const createCell{"ENDC", "ENDCST", "ENDXC", "STBREF", "STBREFR"};
+	static std::set<std::string> const loadCell{"CTOS", "XCTOS", "XLOAD", "LDREFRTOS", "PUSHREFSLICE"};
+	static std::set<std::string> const tuple{"TUPLE", "UNTUPLE", "UNPACKFIRST", "EXPLODE"};
+	if (createCell.count(_mnemonic))
+		return TvmGas::cellCreate;
+	if (loadCell.count(_mnemonic))
+		return TvmGas::cellLoad;
+	if (tuple.count(_mnemonic))
+		return toInt(_arg).value_or(0);
+	if (boost::algorithm::starts_with(_mnemonic, "DICT") || boost::algorithm::starts_with(_mnemonic, "PFXDICT")) {
+		// The size of the dictionary is not known, it counts as a dictionary of one entry.
+		// Changing it loads its root cell and creates a new one.
+		int const load = dictionaryLevels(1) * TvmGas::cellLoad;
+		for (std::string const& change : {"SET", "ADD", "REPLACE", "DEL"})
+			if (_mnemonic.find(change) != std::string::npos)
+				return load + TvmGas::cellCreate;
+		for (std::string const& lookup : {"GET", "MIN", "MAX", "REMMIN", "REMMAX"})
+			if (_mnemonic.find(lookup) != std::string::npos)
+				return load;
+	}
+	if (isIn(_mnemonic, "THROW", "THROWARG", "THROWANY", "THROWARGANY"))
+		return TvmGas::exception;
+	return 0;
+}
+
+}
+
+TVMCodeMetrics::TVMCodeMetrics(Contract const& _contract) :
+	m_privateFunctions{_contract.privateFunctions()}
+{
+	for (Pointer<Function> const& f : _contract.functions()) {
+		m_functionsByName[f->name()] = f.get();
+		if (f->functionId() && f->type() == Function::FunctionType::Fragment)
+			m_privateFunctions.emplace(*f->functionId(), f->name());
+	}
+
+	for (Pointer<Function> const& f : _contract.functions()) {
+		Code const c = layout(functionItems(f->name()));
+		FunctionCodeMetrics metrics;
+		metrics.function = f.get();
+		metrics.bits = c.bits + c.refBits;
+		metrics.cells = 1 + c.refCells;
+		metrics.codeCells = 1 + c.extraCodeCells;
+		metrics.refContinuations = c.refContinuations;
+		metrics.minGas = c.gas.min;
+		metrics.maxGas = c.gas.max;
+		metrics.loopIterationGas = c.loops;
+		metrics.standalone = f->type() != Function::FunctionType::Fragment || (
+			f->functionId() && (_contract.saveAllFunction() || _contract.privateFunctions().count(*f->functionId()))
+		);
+		m_functions.emplace_back(metrics);
+	}
+}
+
+Json::Value TVMCodeMetrics::codeMetricsJson() const {
+	Json::Value functions = Json::arrayValue;
+	int bits = 0;
+	int cells = 0;
+	for (FunctionCodeMetrics const& metrics : m_functions) {
+		Json::Value function;
+		function["name"] = metrics.function->name();
+		if (metrics.function->functionId())
+			function["id"] = *metrics.function->functionId();
+		function["bits"] = metrics.bits;
+		function["cells"] = metrics.cells;
+		function["codeCells"] = metrics.codeCells;
+		function["refContinuations"] = metrics.refContinuations;
+		function["minGas"] = metrics.minGas;
+		function["standalone"] = metrics.standalone;
+		functions.append(function);
+		if (metrics.standalone) {
+			bits += metrics.bits;
+			cells += metrics.cells;
+		}
+	}
+
+	Json::Value result;
+	result["bits"] = bits;
+	result["cells"] = cells;
+	result["functions"] = functions;
+	return result;
+}
+
+Json::Value TVMCodeMetrics::gasEstimatesJson() const {
+	Json::Value functions = Json::arrayValue;
+	for (FunctionCodeMetrics const& metrics : m_functions) {
+		Json::Value function;
+		function["name"] = metrics.function->name();
+		if (metrics.function->functionId())
+			function["id"] = *metrics.function->functionId();
+		function["best"] = metrics.minGas;
+		function["worstWithoutLoops"] = metrics.maxGas;
+		function["loopIteration"] = Json::arrayValue;
+		for (int gas : metrics.loopIterationGas)
+			function["loopIteration"].append(gas);
+		functions.append(function);
+	}
+
+	Json::Value result;
+	result["functions"] = functions;
+	return result;
+}
+
+int TVMCodeMetrics::instructionBits(std::string const& _instruction) {
+	auto const [mnemonic, arg] = splitInstruction(_instruction);
+
+	if (mnemonic.empty() || mnemonic.at(0) == '.' || mnemonic == "}")
+		return 0;
+	if (mnemonic == "PUSHINT")
+		return pushIntBits(arg);
+	if (isIn(mnemonic, "CALL", "CALLDICT", "JMP", "JMPDICT"))
+		return toInt(arg).value_or(1 << 14) < 256 ? 16 : 24;
+	if (isIn(mnemonic, "THROW", "THROWIF", "THROWIFNOT"))
+		return toInt(arg).value_or(64) < 64 ? 16 : 24;
+	if (isIn(mnemonic, "THROWARG", "THROWARGIF", "THROWARGIFNOT"))
+		return 24;
+	if (isIn(mnemonic, "PUSH", "POP")) {
+		std::optional<int> const index = stackIndex(arg);
+		return index && *index < 16 ? 8 : 16;
+	}
+	if (mnemonic == "XCHG") {
+		auto const comma = arg.find(',');
+		if (comma == std::string::npos)
+			return stackIndex(arg).value_or(16) < 16 ? 8 : 16;
+		std::optional<int> const i = stackIndex(arg.substr(0, comma));
+		std::optional<int> const j = stackIndex(arg.substr(comma + 1));
+		return i && j && *i <= 1 && *j < 16 ? 8 : 16;
+	}
+	if (mnemonic == "PUSHSLICE")
+		return pushSliceBits(static_cast<int>(StrUtils::toBitString(arg).size()));
+	if (mnemonic == "STSLICECONST")
+		return 14 + (static_cast<int>(StrUtils::toBitString(arg).size()) + 2 + 7) / 8 * 8;
+
+	static std::set<std::string> const oneByte{
+		"NOP", "SWAP", "DUP", "OVER", "DROP", "NIP", "ROT", "ROTREV", "-ROT", "SWAP2", "DROP2", "DUP2", "OVER2", "TUCK",
+		"ADD", "SUB", "SUBR", "NEGATE", "INC", "DEC", "MUL", "LSHIFT", "RSHIFT", "POW2",
+		"AND", "OR", "XOR", "NOT", "BITNOT",
+		"SGN", "LESS", "EQUAL", "LEQ", "GREATER", "NEQ", "GEQ", "CMP",
+		"NEWC", "ENDC", "STREF", "STBREF", "STSLICE", "CTOS", "ENDS", "LDREF", "LDREFRTOS",
+		"NULL", "PUSHNULL", "ISNULL", "TRUE", "FALSE", "ZERO", "ONE", "TWO", "TEN",
+		"IFRET", "IFNOTRET", "IF", "IFNOT", "IFJMP", "IFNOTJMP", "IFELSE", "CALLX", "JMPX", "EXECUTE",
+		"REPEAT", "UNTIL", "WHILE", "AGAIN", "REPEATEND", "UNTILEND", "WHILEEND", "AGAINEND",
+		"PUSHREF", "PUSHREFSLICE", "PUSHREFCONT",
+	};
+	static std::set<std::string> const threeBytes{
+		"PUSH3", "XC2PU", "XCPUXC", "XCPU2", "PUXC2", "PUXCPU", "PU2XC",
+		"DICTPUSHCONST", "PLDU", "PLDI", "PLDUZ", "LDUQ", "LDIQ", "PLDUQ", "PLDIQ",
+	};
+	if (oneByte.count(mnemonic))
+		return 8;
+	if (threeBytes.count(mnemonic))
+		return 24;
+	return 16;
+}
+
+int TVMCodeMetrics::instructionGas(std::string const& _instruction) {
+	auto const [mnemonic, arg] = splitInstruction(_instruction);
+	if (mnemonic.empty() || mnemonic.at(0) == '.' || mnemonic == "}")
+		return 0;
+	return basicGas(instructionBits(_instruction)) + extraGas(mnemonic, arg);
+}
+
+void TVMCodeMetrics::append(std::vector<Code>& _items, TvmAstNode const& _node) {
+	auto instruction = [&](int bits, Gas extra = {}) {
+		Code c;
+		c.bits = bits;
+		c.gas = Gas{basicGas(bits), basicGas(bits)};
+		c.gas += extra;
+		_items.emplace_back(c);
+	};
+
+	if (isa<Loc>(_node)) {
+		return;
+	} else if (auto stack = dyn_cast<Stack>(&_node)) {
+		instruction(stackBits(*stack));
+	} else if (auto glob = dyn_cast<Glob>(&_node)) {
+		switch (glob->opcode()) {
+		case Glob::Opcode::GetOrGetVar:
+		case Glob::Opcode::SetOrSetVar:
+			if (1 <= glob->index() && glob->index() <= 31)
+				instruction(16);
+			else {
+				instruction(pushIntBits(std::to_string(glob->index())));
+				instruction(16);
+			}
+			break;
+		default:
+			instruction(16);
+			break;
+		}
+	} else if (isa<DeclRetFlag>(_node)) {
+		instruction(8);
+	} else if (auto asym = dyn_cast<AsymGen>(&_node)) {
+		instruction(instructionBits(asym->opcode()));
+	} else if (auto hardCode = dyn_cast<HardCode>(&_node)) {
+		// Nested continuations in hard-coded assembly are placed into the referenced cell as a whole.
+		std::vector<bool> inRef;
+		for (std::string const& line : hardCode->code()) {
+			std::string const text = boost::algorithm::trim_copy(line.substr(0, line.find(';')));
+			if (text.empty())
+				continue;
+			bool const opens = text.back() == '{';
+			bool const closes = text.at(0) == '}';
+			if (closes) {
+				if (!inRef.empty())
+					inRef.pop_back();
+				continue;
+			}
+			std::string const instructionText = opens ? text.substr(0, text.size() - 1) : text;
+			int const bits = instructionBits(instructionText);
+			int const gas = instructionGas(instructionText);
+			bool const nested = std::find(inRef.begin(), inRef.end(), true) != inRef.end();
+			if (nested) {
+				solAssert(!_items.empty(), "");
+				_items.back().refBits += bits;
+				_items.back().gas += gas;
+			} else if (opens && text.find("REF") != std::string::npos) {
+				Code c;
+				c.bits = bits;
+				c.refs = 1;
+				c.refCells = 1;
+				c.refContinuations = 1;
+				c.gas += basicGas(bits, 1) + TvmGas::cellLoad;
+				_items.emplace_back(c);
+			} else
+				instruction(bits, Gas{gas - basicGas(bits), gas - basicGas(bits)});
+			if (opens)
+				inRef.push_back(nested || text.find("REF") != std::string::npos);
+		}
+	} else if (auto opcode = dyn_cast<StackOpcode>(&_node)) {
+		std::string const& name = opcode->opcode();
+		std::string const& arg = opcode->arg();
+		if (name == ".inline") {
+			appendInline(_items, arg);
+		} else if (name == "CALL") {
+			std::optional<int> const id = toInt(arg);
+			int const bits = instructionBits(opcode->fullOpcode());
+			if (id)
+				_items.emplace_back(call(bits, *id));
+			else
+				instruction(bits);
+		} else if (isIn(name, "UNTUPLE", "UNPACKFIRST", "INDEX_EXCEP", "INDEX_NOEXCEP")) {
+			std::optional<int> const n = toInt(arg);
+			if (n && *n > 15)
+				instruction(pushIntBits(arg));
+			int const entries = isIn(name, "UNTUPLE", "UNPACKFIRST") ? n.value_or(0) : 0;
+			instruction(16, Gas{entries, entries});
+		} else if (name == "PUSHINT") {
+			instruction(pushIntBits(arg));
+		} else {
+			int const bits = instructionBits(opcode->fullOpcode());
+			int const extra = instructionGas(opcode->fullOpcode()) - basicGas(bits);
+			instruction(bits, Gas{extra, extra});
+		}
+	} else if (auto push = dyn_cast<PushCellOrSlice>(&_node)) {
+		switch (push->type()) {
+		case PushCellOrSlice::Type::PUSHSLICE:
+			instruction(pushSliceBits(getRootBitSize(*push)));
+			break;
+		case PushCellOrSlice::Type::PUSHREF_COMPUTE:
+		case PushCellOrSlice::Type::PUSHREFSLICE_COMPUTE:
+		case PushCellOrSlice::Type::PUSHREF:
+		case PushCellOrSlice::Type::PUSHREFSLICE:
+		case PushCellOrSlice::Type::CELL: {
+			bool const computed = isIn(push->type(), PushCellOrSlice::Type::PUSHREF_COMPUTE, PushCellOrSlice::Type::PUSHREFSLICE_COMPUTE);
+			bool const toSlice = isIn(push->type(), PushCellOrSlice::Type::PUSHREFSLICE, PushCellOrSlice::Type::PUSHREFSLICE_COMPUTE);
+			Code c;
+			c.bits = 8;
+			c.refs = 1;
+			c.refBits = computed ? 0 : cellChainBits(*push);
+			c.refCells = computed ? 1 : cellChainLength(*push);
+			c.gas += basicGas(8, 1) + (toSlice ? TvmGas::cellLoad : 0);
+			_items.emplace_back(c);
+			break;
+		}
+		}
+	} else if (auto block = dyn_cast<CodeBlock>(&_node)) {
+		if (block->type() == CodeBlock::Type::None)
+			appendBlock(_items, *block);
+		else
+			_items.emplace_back(pushContinuation(code(*block), block->type() == CodeBlock::Type::PUSHCONT));
+	} else if (auto sub = dyn_cast<SubProgram>(&_node)) {
+		Code const body = code(*sub->block());
+		if (sub->block()->type() == CodeBlock::Type::PUSHREFCONT) {
+			Code c = refInstruction(16, {body}); // CALLREF, JMPREF
+			c.gas += body.gas;
+			c.gas += TvmGas::cellLoad + TvmGas::implicitRet;
+			_items.emplace_back(c);
+		} else {
+			Code const push = pushContinuation(body, true);
+			_items.emplace_back(push);
+			instruction(8, runGas(push, body)); // CALLX, JMPX
+		}
+	} else if (auto lc = dyn_cast<LogCircuit>(&_node)) {
+		// The cheaper way skips the body.
+		Code const body = code(*lc->body());
+		Code const push = pushContinuation(body, true);
+		_items.emplace_back(push);
+		instruction(8, Gas{0, runGas(push, body).max}); // IF, IFNOT
+	} else if (auto ifElse = dyn_cast<TvmIfElse>(&_node)) {
+		Pointer<CodeBlock> const& trueBody = ifElse->trueBody();
+		Pointer<CodeBlock> const& falseBody = ifElse->falseBody();
+		bool const trueRef = trueBody->type() == CodeBlock::Type::PUSHREFCONT;
+		if (falseBody == nullptr) {
+			// The cheaper way skips the body.
+			Code const body = code(*trueBody);
+			if (trueRef) {
+				Code c = refInstruction(16, {body}); // IFREF, IFNOTREF, IFJMPREF, IFNOTJMPREF
+				c.gas.max += TvmGas::cellLoad + body.gas.max + TvmGas::implicitRet;
+				_items.emplace_back(c);
+			} else {
+				Code const push = pushContinuation(body, true);
+				_items.emplace_back(push);
+				instruction(8, Gas{0, runGas(push, body).max}); // IF, IFNOT, IFJMP, IFNOTJMP
+			}
+		} else {
+			bool const falseRef = falseBody->type() == CodeBlock::Type::PUSHREFCONT;
+			Code const trueCode = code(*trueBody);
+			Code const falseCode = code(*falseBody);
+			if (trueRef && falseRef) {
+				Code c = refInstruction(16, {trueCode, falseCode}); // IFREFELSEREF
+				c.gas.min += std::min(trueCode.gas.min, falseCode.gas.min);
+				c.gas.max += std::max(trueCode.gas.max, falseCode.gas.max);
+				c.gas += TvmGas::cellLoad + TvmGas::implicitRet;
+				_items.emplace_back(c);
+			} else if (trueRef || falseRef) {
+				Code const& inlineCode = trueRef ? falseCode : trueCode;
+				Code const& refCode = trueRef ? trueCode : falseCode;
+				Code const push = pushContinuation(inlineCode, true);
+				_items.emplace_back(push);
+				Code c = refInstruction(16, {refCode}); // IFREFELSE, IFELSEREF
+				// The referenced cell is only loaded if its branch is taken.
+				Gas const inlineGas = runGas(push, inlineCode);
+				c.gas.min += std::min(TvmGas::cellLoad + refCode.gas.min + TvmGas::implicitRet, inlineGas.min);
+				c.gas.max += std::max(TvmGas::cellLoad + refCode.gas.max + TvmGas::implicitRet, inlineGas.max);
+				_items.emplace_back(c);
+			} else {
+				Code const truePush = pushContinuation(trueCode, true);
+				Code const falsePush = pushContinuation(falseCode, true);
+				_items.emplace_back(truePush);
+				_items.emplace_back(falsePush);
+				Gas const trueGas = runGas(truePush, trueCode);
+				Gas const falseGas = runGas(falsePush, falseCode);
+				instruction(8, Gas{std::min(trueGas.min, falseGas.min), std::max(trueGas.max, falseGas.max)}); // IFELSE
+			}
+		}
+	} else if (auto repeat = dyn_cast<TvmRepeat>(&_node)) {
+		// The body may run zero times.
+		Code const body = code(*repeat->body());
+		Code const push = pushContinuation(body, true);
+		_items.emplace_back(push);
+		instruction(repeat->withBreakOrReturn() ? 16 : 8);
+		_items.back().loops.push_back(runGas(push, body).max);
+	} else if (auto until = dyn_cast<TvmUntil>(&_node)) {
+		// The body runs at least once.
+		Code const body = code(*until->body());
+		Code const push = pushContinuation(body, true);
+		_items.emplace_back(push);
+		Gas const bodyGas = runGas(push, body);
+		instruction(until->withBreakOrReturn() ? 16 : 8, bodyGas);
+		_items.back().loops.push_back(bodyGas.max);
+	} else if (auto loop = dyn_cast<While>(&_node)) {
+		// The condition of a while loop or the body of an infinite loop runs at least once.
+		Gas gas;
+		int iteration = 0;
+		if (!loop->isInfinite()) {
+			Code const condition = code(*loop->condition());
+			Code const push = pushContinuation(condition, true);
+			_items.emplace_back(push);
+			gas += runGas(push, condition);
+			iteration += runGas(push, condition).max;
+		}
+		Code const body = code(*loop->body());
+		Code const push = pushContinuation(body, true);
+		_items.emplace_back(push);
+		if (loop->isInfinite())
+			gas += runGas(push, body);
+		iteration += runGas(push, body).max;
+		instruction(loop->withBreakOrReturn() ? 16 : 8, gas);
+		_items.back().loops.push_back(iteration);
+	} else if (auto tryCatch = dyn_cast<TryCatch>(&_node)) {
+		if (tryCatch->saveAltC2())
+			instruction(16); // SAVEALT C2
+		Code const tryBody = code(*tryCatch->tryBody());
+		Code const catchBody = code(*tryCatch->catchBody());
+		Code const tryPush = pushContinuation(tryBody, true);
+		Code const catchPush = pushContinuation(catchBody, true);
+		_items.emplace_back(tryPush);
+		_items.emplace_back(catchPush);
+		// The most expensive way throws an exception at the end of the try block.
+		Gas const tryGas = runGas(tryPush, tryBody);
+		Gas const catchGas = runGas(catchPush, catchBody);
+		instruction(16, Gas{tryGas.min, tryGas.max + TvmGas::exception + catchGas.max}); // TRYKEEP
+	} else if (auto ret = dyn_cast<ReturnOrBreakOrCont>(&_node)) {
+		appendBlock(_items, *ret->body());
+	} else if (auto opaque = dyn_cast<Opaque>(&_node)) {
+		appendBlock(_items, *opaque->block());
+	} else if (auto tvmReturn = dyn_cast<TvmReturn>(&_node)) {
+		// RET and RETALT have 16-bit codes, as well as IFRETALT and IFNOTRETALT.
+		instruction(tvmReturn->withIf() && !tvmReturn->withAlt() ? 8 : 16);
+	} else if (auto exception = dyn_cast<TvmException>(&_node)) {
+		std::string const throwInstruction = exception->opcode() + (exception->arg().empty() ? "" : " " + exception->arg());
+		int const bits = instructionBits(throwInstruction);
+		instruction(bits, exception->withIf() ? Gas{} : Gas{TvmGas::exception, TvmGas::exception});
+	} else {
+		solUnimplemented("");
+	}
+}
+
+void TVMCodeMetrics::appendBlock(std::vector<Code>& _items, CodeBlock const& _block) {
+	for (Pointer<TvmAstNode> const& node : _block.instructions())
+		append(_items, *node);
+}
+
+void TVMCodeMetrics::appendInline(std::vector<Code>& _items, std::string const& _functionName) {
+	if (!m_functionsByName.count(_functionName))
+		return;
+	std::vector<Code> const& items = functionItems(_functionName);
+	_items.insert(_items.end(), items.begin(), items.end());
+}
+
+TVMCodeMetrics::Code TVMCodeMetrics::layout(std::vector<Code> const& _items) {
+	Code code;
+	int cellBits = 0;
+	int cellRefs = 0;
+	for (Code const& item : _items) {
+		// One reference of a full cell is kept for the cell the code continues in.
+		if (cellBits + item.bits > maxCellBits || cellRefs + item.refs > maxCellRefs - 1) {
+			++code.extraCodeCells;
+			++code.refCells;
+			code.gas += TvmGas::implicitJump + TvmGas::cellLoad;
+			cellBits = 0;
+			cellRefs = 0;
+		}
+		cellBits += item.bits;
+		cellRefs += item.refs;
+		code.bits += item.bits;
+		code.refs += item.refs;
+		code.refBits += item.refBits;
+		code.refCells += item.refCells;
+		code.refContinuations += item.refContinuations;
+		code.gas += item.gas;
+		code.loops.insert(code.loops.end(), item.loops.begin(), item.loops.end());
+	}
+	return code;
+}
+
+TVMCodeMetrics::Code TVMCodeMetrics::code(CodeBlock const& _block) {
+	std::vector<Code> items;
+	appendBlock(items, _block);
+	return layout(items);
+}
+
+TVMCodeMetrics::Code TVMCodeMetrics::pushContinuation(Code const& _body, bool _inline) {
+	Code push;
+	if (_inline && _body.extraCodeCells == 0 && _body.refs == 0 && _body.bits <= 15 * 8) {
+		push.bits = 8 + _body.bits; // PUSHCONT with a 4-bit length
+	} else if (_inline && _body.extraCodeCells == 0 && _body.refs <= 3 && _body.bits <= 127 * 8) {
+		push.bits = 16 + _body.bits; // PUSHCONT with a 7-bit length and references
+		push.refs = _body.refs;
+	} else {
+		push.bits = 8; // PUSHREFCONT
+		push.refs = 1;
+		push.refCells = 1;
+		push.refContinuations = 1;
+		push.refBits = _body.bits;
+	}
+	push.refBits += _body.refBits;
+	push.refCells += _body.refCells;
+	push.refContinuations += _body.refContinuations;
+	push.gas += basicGas(push.bits, push.refs);
+	// The loops of the body count where the continuation is pushed.
+	push.loops = _body.loops;
+	return push;
+}
+
+TVMCodeMetrics::Gas TVMCodeMetrics::runGas(Code const& _push, Code const& _body) {
+	// A continuation pushed with PUSHREFCONT is loaded when it runs.
+	bool const referenced = _push.refContinuations > _body.refContinuations;
+	Gas gas = _body.gas;
+	gas += TvmGas::implicitRet + (referenced ? TvmGas::cellLoad : 0);
+	return gas;
+}
+
+TVMCodeMetrics::Code TVMCodeMetrics::refInstruction(int _bits, std::vector<Code> const& _bodies) {
+	Code c;
+	c.bits = _bits;
+	c.refs = static_cast<int>(_bodies.size());
+	c.gas += basicGas(c.bits, c.refs);
+	for (Code const& body : _bodies) {
+		c.refBits += body.bits + body.refBits;
+		c.refCells += 1 + body.refCells;
+		c.refContinuations += 1 + body.refContinuations;
+		c.loops.insert(c.loops.end(), body.loops.begin(), body.loops.end());
+	}
+	return c;
+}
+
+TVMCodeMetrics::Code TVMCodeMetrics::call(int _bits, uint32_t _functionId) {
+	// CALLDICT jumps to c3, which looks the function up in the dictionary of the private functions
+	// with DICTPUSHCONST and DICTUGETJMPZ.
+	int const levels = dictionaryLevels(m_privateFunctions.size());
+	Code c;
+	c.bits = _bits;
+	c.gas += basicGas(_bits) + basicGas(24) + basicGas(16) + levels * TvmGas::cellLoad;
+	if (auto it = m_privateFunctions.find(_functionId); it != m_privateFunctions.end() && m_functionsByName.count(it->second)) {
+		// Recursive calls are not followed.
+		if (!m_inProgress.count(it->second)) {
+			Code const callee = layout(functionItems(it->second));
+			c.gas += callee.gas;
+			c.gas += TvmGas::implicitRet;
+			c.loops = callee.loops;
+		}
+	}
+	return c;
+}
+
+std::vector<TVMCodeMetrics::Code> const& TVMCodeMetrics::functionItems(std::string const& _functionName) {
+	if (auto it = m_items.find(_functionName); it != m_items.end())
+		return it->second;
+
+	static std::vector<Code> const empty;
+	if (m_inProgress.count(_functionName))
+		return empty;
+
+	std::vector<Code> items;
+	m_inProgress.insert(_functionName);
+	appendBlock(items, *m_functionsByName.at(_functionName)->block());
+	m_inProgress.erase(_functionName);
+	return m_items[_functionName] = std::move(items);
+}
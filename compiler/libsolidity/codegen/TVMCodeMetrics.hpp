@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2025 EverX. All Rights Reserved.
+ *
+ * Licensed under the  terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the  GNU General Public License for more details at: https://www.gnu.org/licenses/gpl-3.0.html
+ */
+/**
+ * Estimation of the size and the gas of the TVM code of a contract
+ */
+
+#pragma once
+
+#include <libsolidity/codegen/TvmAst.hpp>
+
+#include <json/json.h>
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace solidity::frontend {
+
+/// Gas that TVM charges in addition to the basic cost of an instruction.
+namespace TvmGas {
+	/// Loading a cell for the first time in a transaction.
+	int constexpr cellLoad = 100;
+	/// The implicit jump to the cell the code continues in.
+	int constexpr implicitJump = 10;
+	/// Throwing an exception.
+	int constexpr exception = 50;
+	/// Creating a cell.
+	int constexpr cellCreate = 500;
+	/// The implicit RET at the end of a continuation.
+	int constexpr implicitRet = 5;
+}
+
+/// Estimated size and cost of the code of one function of a contract.
+struct FunctionCodeMetrics {
+	Function const* function{};
+	/// Size of the code, including the inlined fragments and the cells the code refers to.
+	int bits{};
+	int cells{};
+	/// Number of cells the instructions of the function are spread over. Code that does not fit
+	/// into one cell is continued in a referenced cell, which is loaded whenever the code runs into it.
+	int codeCells{};
+	/// Number of continuations in referenced cells, i.e. of CALLREF, JMPREF, IFREF... and PUSHREFCONT.
+	int refContinuations{};
+	/// Gas of the cheapest run of the function: conditions take the cheaper branch, loops that can
+	/// be skipped are skipped and no exception is thrown. Private functions that are called through
+	/// the dictionary count with their cheapest run.
+	int minGas{};
+	/// Gas of the most expensive run of the function without repeating loops: conditions take the
+	/// more expensive branch and loops run as often as they have to, i.e. the body of an until loop
+	/// and the condition of a while loop once.
+	int maxGas{};
+	/// Most expensive gas of one further iteration of each loop of the function, including the loops
+	/// of inlined and called functions.
+	std::vector<int> loopIterationGas;
+	/// Whether the code of the function is placed into the contract code on its own. Other functions
+	/// are only inlined where they are used.
+	bool standalone{};
+};
+
+/**
+ * Estimates the size and the gas of the functions of a contract from its TVM assembly before
+ * it is assembled. The size of an instruction is the size of the encoding that the assembler
+ * chooses for it, and its gas is the basic cost 10 + bits + 5 * refs plus the cost of creating
+ * and loading cells, of dictionary lookups and of exceptions that the instruction incurs. Loading
+ * the cells the code continues in is added to the gas.
+ *
+ * A dictionary lookup loads one cell per level of the dictionary, i.e. 1 + ceil(log2(n)) cells
+ * for n entries. The dictionary of the private functions has one entry per function. The size of
+ * the dictionaries in the data is not known, they count as dictionaries of one entry.
+ */
+class TVMCodeMetrics : private boost::noncopyable {
+public:
+	explicit TVMCodeMetrics(Contract const& _contract);
+
+	std::vector<FunctionCodeMetrics> const& functions() const { return m_functions; }
+
+	/// @returns the metrics of the functions and the total size of the functions that are placed
+	/// into the contract code on their own.
+	Json::Value codeMetricsJson() const;
+	/// @returns the best case, the worst case without loops and the gas of a loop iteration of
+	/// each function.
+	Json::Value gasEstimatesJson() const;
+
+	/// @returns the estimated size in bits of the instruction @a _instruction as printed in the
+	/// assembly, for example "PUSHINT 300" or "XCHG S1, S2".
+	static int instructionBits(std::string const& _instruction);
+	/// @returns the estimated gas of the instruction @a _instruction as printed in the assembly,
+	/// without the gas of the continuations it runs.
+	static int instructionGas(std::string const& _instruction);
+
+private:
+	struct Gas {
+		int min{};
+		int max{};
+		Gas& operator+=(Gas const& _other) { min += _other.min; max += _other.max; return *this; }
+		Gas& operator+=(int _gas) { min += _gas; max += _gas; return *this; }
+	};
+
+	/// Size and gas of a sequence of instructions.
+	struct Code {
+		/// Bits and references of the instructions themselves.
+		int bits{};
+		int refs{};
+		/// Bits and number of the cells the instructions refer to, including the cells they continue in.
+		int refBits{};
+		int refCells{};
+		int extraCodeCells{};
+		int refContinuations{};
+		Gas gas;
+		/// Gas of one iteration of each loop in the instructions.
+		std::vector<int> loops;
+	};
+
+	void append(std::vector<Code>& _items, TvmAstNode const& _node);
+	void appendBlock(std::vector<Code>& _items, CodeBlock const& _block);
+	void appendInline(std::vector<Code>& _items, std::string const& _functionName);
+	/// Places @a _items into as many cells as they need.
+	static Code layout(std::vector<Code> const& _items);
+	Code code(CodeBlock const& _block);
+	/// @returns the instruction that pushes the continuation @a _body. The body is inlined if it fits
+	/// into the current cell and @a _inline is true and is referenced otherwise.
+	static Code pushContinuation(Code const& _body, bool _inline);
+	/// @returns the gas of running the continuation @a _body pushed by @a _push.
+	static Gas runGas(Code const& _push, Code const& _body);
+	/// @returns the instruction with the continuations @a _bodies in referenced cells, e.g. CALLREF.
+	/// Its gas does not include loading and running them.
+	static Code refInstruction(int _bits, std::vector<Code> const& _bodies);
+	/// @returns the instruction that calls the private function with the id @a _functionId through
+	/// the dictionary in c3, with the gas and the loops of the function.
+	Code call(int _bits, uint32_t _functionId);
+	std::vector<Code> const& functionItems(std::string const& _functionName);
+
+	std::map<std::string, Function const*> m_functionsByName;
+	std::map<uint32_t, std::string> m_privateFunctions;
+	/// Instructions of the functions whose items were computed, with the inlined fragments expanded.
+	std::map<std::string, std::vector<Code>> m_items;
+	/// Functions whose items are being computed.
+	std::set<std::string> m_inProgress;
+	std::vector<FunctionCodeMetrics> m_functions;
+};
+
+}	// end solidity::frontend
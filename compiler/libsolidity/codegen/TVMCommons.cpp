@@ -15,6 +15,7 @@
  */
 
 #include <boost/algorithm/string/trim.hpp>
+#include <mutex>
 
 #include <libsolidity/ast/TypeProvider.h>
 
@@ -446,8 +447,7 @@ void ABITypeSize::init(Type const* type) {
 }
 
 bool isLoc(Pointer<TvmAstNode> const& node) {
-	auto c = dynamic_pointer_cast<Loc>(node);
-	return c != nullptr;
+	return isa<Loc>(node);
 }
 
 vector<string> split (const string &s, char sep) {
@@ -471,7 +471,7 @@ int qtyWithoutLoc(std::vector<Pointer<TvmAstNode>>::const_iterator beg,
 				  std::vector<Pointer<TvmAstNode>>::const_iterator end) {
 	int qty = 0;
 	for (auto it = beg; it != end; ++it) {
-		if (!to<Loc>((*it).get())){
+		if (!isa<Loc>((*it).get())){
 			++qty;
 		}
 	}
@@ -694,51 +694,82 @@ std::optional<bool> ExprUtils::constBool(Expression const& _e) {
 	return {};
 }
 
+// Returns the bit string of the address for compile-time constants like `address(0x123...)` or `IFoo(address(0x123...))`
+std::optional<std::string> ExprUtils::constAddress(Expression const& _e) {
+	if (*_e.annotation().isPure) {
+		VariableDeclaration const* variable{};
+		if (auto memberAccess = to<MemberAccess>(&_e))
+			variable = dynamic_cast<VariableDeclaration const *>(memberAccess->annotation().referencedDeclaration);
+		else if (auto ident = to<Identifier>(&_e))
+			variable = to<VariableDeclaration>(ident->annotation().referencedDeclaration);
+		if (variable && variable->isConstant())
+			return constAddress(*variable->value());
+	}
+
+	auto funCall = to<FunctionCall>(&_e);
+	if (funCall &&
+		*funCall->annotation().kind == FunctionCallKind::TypeConversion &&
+		funCall->arguments().size() == 1
+	) {
+		Expression const& argument = *funCall->arguments().at(0);
+		if (funCall->annotation().type->category() == Type::Category::Contract)
+			return constAddress(argument);
+		if (funCall->annotation().type->category() == Type::Category::Address)
+			if (auto number = to<RationalNumberType>(argument.annotation().type))
+				return StrUtils::literalToSliceAddress(number->value2());
+	}
+	return {};
+}
+
 std::map<bigint, int> const& MathConsts::power2Exp() {
 	static std::map<bigint, int> power2Exp;
-	if (power2Exp.empty()) {
+	static std::once_flag flag;
+	std::call_once(flag, [] {
 		bigint p2 = 1;
 		for (int p = 0; p <= 256; ++p) {
 			power2Exp[p2] = p;
 			p2 *= 2;
 		}
-	}
+	});
 	return power2Exp;
 }
 
 std::map<bigint, int> const& MathConsts::power2DecExp() {
 	static std::map<bigint, int> power2DecExp;
-	if (power2DecExp.empty()) {
+	static std::once_flag flag;
+	std::call_once(flag, [] {
 		bigint p2 = 1;
 		for (int p = 0; p <= 256; ++p) {
 			power2DecExp[p2 - 1] = p;
 			p2 *= 2;
 		}
-	}
+	});
 	return power2DecExp;
 }
 
 std::map<bigint, int> const& MathConsts::power2NegExp() {
 	static std::map<bigint, int> power2NegExp;
-	if (power2NegExp.empty()) {
+	static std::once_flag flag;
+	std::call_once(flag, [] {
 		bigint p2 = 1;
 		for (int p = 0; p <= 256; ++p) {
 			power2NegExp[-p2] = p;
 			p2 *= 2;
 		}
-	}
+	});
 	return power2NegExp;
 }
 
 std::map<int, bigint> const& MathConsts::power10() {
 	static std::map<int, bigint> power10;
-	if (power10.empty()) {
+	static std::once_flag flag;
+	std::call_once(flag, [] {
 		bigint p10 = 1;
 		for (int i = 0; i <= 80; ++i) {
 			power10[i] = p10;
 			p10 *= 10;
 		}
-	}
+	});
 	return power10;
 }
 
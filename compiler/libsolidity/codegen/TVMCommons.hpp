@@ -394,6 +394,7 @@ namespace StrUtils {
 namespace ExprUtils {
 	std::optional<bigint> constValue(Expression const &_e);
 	std::optional<bool> constBool(Expression const &_e);
+	std::optional<std::string> constAddress(Expression const &_e);
 }
 
 namespace MathConsts {
@@ -96,8 +96,11 @@ Pointer<Contract>
 TVMContractCompiler::generateContractCode(
 	ContractDefinition const *contract,
 	std::vector<std::shared_ptr<SourceUnit>>const& _sourceUnits,
-	PragmaDirectiveHelper const &pragmaHelper
+	PragmaDirectiveHelper const &pragmaHelper,
+	PeepholeStats* _stats,
+	std::function<bool()> const& _cancelled
 ) {
+	auto cancelled = [&]() { return _cancelled && _cancelled(); };
 	std::vector<Pointer<Function>> functions;
 
 	TVMCompilerContext ctx{contract, pragmaHelper};
@@ -114,6 +117,8 @@ TVMContractCompiler::generateContractCode(
 
 	for (ContractDefinition const* c : contract->annotation().linearizedBaseContracts) {
 		for (FunctionDefinition const *_function : c->definedFunctions()) {
+			if (cancelled())
+				return nullptr;
 			if (_function->isConstructor() ||
 				!_function->isImplemented() ||
 				_function->isInline()) {
@@ -285,12 +290,14 @@ TVMContractCompiler::generateContractCode(
 	LocSquasher sq;
 	c->accept(sq);
 
-	optimizeCode(c);
+	if (cancelled())
+		return nullptr;
+	optimizeCode(c, _stats);
 
 	return c;
 }
 
-void TVMContractCompiler::optimizeCode(Pointer<Contract>& c) {
+void TVMContractCompiler::optimizeCode(Pointer<Contract>& c, PeepholeStats* _stats) {
 	DeleterCallX dc;
 	c->accept(dc);
 
@@ -306,23 +313,23 @@ void TVMContractCompiler::optimizeCode(Pointer<Contract>& c) {
 	c->accept(lce);
 
 	for (int i = 0; i < 10; ++i) { // TODO
-		PeepholeOptimizer peepHole{{}};
+		PeepholeOptimizer peepHole{{}, _stats};
 		c->accept(peepHole);
 
 		StackOptimizer opt;
 		c->accept(opt);
 	}
 
-	PeepholeOptimizer peepHole = PeepholeOptimizer{{}};
+	PeepholeOptimizer peepHole = PeepholeOptimizer{{}, _stats};
 	c->accept(peepHole);
 
-	peepHole = PeepholeOptimizer{1 << OptFlags::UnpackOpaque};
+	peepHole = PeepholeOptimizer{1 << OptFlags::UnpackOpaque, _stats};
 	c->accept(peepHole);
 
-	peepHole = PeepholeOptimizer{(1 << OptFlags::UnpackOpaque) | (1 << OptFlags::UseCompoundOpcodes)};
+	peepHole = PeepholeOptimizer{(1 << OptFlags::UnpackOpaque) | (1 << OptFlags::UseCompoundOpcodes), _stats};
 	c->accept(peepHole);
 
-	peepHole = PeepholeOptimizer{(1 << OptFlags::OptimizeSlice) | (1 << OptFlags::UseCompoundOpcodes)};
+	peepHole = PeepholeOptimizer{(1 << OptFlags::OptimizeSlice) | (1 << OptFlags::UseCompoundOpcodes), _stats};
 	c->accept(peepHole);
 
 	LocSquasher sq = LocSquasher{};
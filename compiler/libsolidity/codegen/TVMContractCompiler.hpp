@@ -20,8 +20,11 @@
 #include <libsolidity/codegen/TVMPusher.hpp>
 #include <libsolidity/codegen/TvmAst.hpp>
 
+#include <functional>
+
 namespace solidity::frontend {
 
+class PeepholeStats;
 class TVMCompilerContext;
 
 class TVMContractCompiler: private boost::noncopyable {
@@ -44,12 +47,16 @@ public:
 		std::vector<std::shared_ptr<SourceUnit>> const& _sourceUnits,
 		PragmaDirectiveHelper const &pragmaHelper
 	);
+	/// Counts the rewrites of the peephole optimizer in @a _stats if it is not null.
+	/// @returns nullptr if @a _cancelled returned true before a function or before the optimization.
 	static Pointer<Contract> generateContractCode(
 		ContractDefinition const* contract,
 		std::vector<std::shared_ptr<SourceUnit>>const& _sourceUnits,
-		PragmaDirectiveHelper const& pragmaHelper
+		PragmaDirectiveHelper const& pragmaHelper,
+		PeepholeStats* _stats = nullptr,
+		std::function<bool()> const& _cancelled = {}
 	);
-	static void optimizeCode(Pointer<Contract>& c);
+	static void optimizeCode(Pointer<Contract>& c, PeepholeStats* _stats = nullptr);
 private:
 	static void fillInlineFunctions(TVMCompilerContext& ctx, ContractDefinition const* contract);
 };
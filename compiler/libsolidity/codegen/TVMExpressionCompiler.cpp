@@ -226,6 +226,7 @@ bool TVMExpressionCompiler::pushLocalOrStateVariable(Identifier const &_identifi
 	auto& stack = m_pusher.getStack();
 	Declaration const* declaration = _identifier.annotation().referencedDeclaration;
 	if (stack.isParam(declaration)) {
+		solAssert(!stack.isScalarStruct(declaration), "");
 		auto offset = stack.getOffset(declaration);
 		m_pusher.pushS(offset);
 		return true;
@@ -239,6 +240,25 @@ bool TVMExpressionCompiler::pushLocalOrStateVariable(Identifier const &_identifi
 	return false;
 }
 
+bool TVMExpressionCompiler::isScalarStruct(Identifier const& _identifier) const {
+	auto& stack = m_pusher.getStack();
+	Declaration const* declaration = _identifier.annotation().referencedDeclaration;
+	return stack.isParam(declaration) && stack.isScalarStruct(declaration);
+}
+
+std::optional<int> TVMExpressionCompiler::scalarStructMemberOffset(MemberAccess const& _memberAccess) const {
+	auto identifier = to<Identifier>(&_memberAccess.expression());
+	if (identifier == nullptr || !isScalarStruct(*identifier))
+		return {};
+	auto structType = to<StructType>(getType(identifier));
+	ast_vec<VariableDeclaration> const& members = structType->structDefinition().members();
+	for (size_t i = 0; i < members.size(); ++i) {
+		if (members[i]->name() == _memberAccess.memberName())
+			return m_pusher.getStack().getMemberOffset(identifier->annotation().referencedDeclaration, i);
+	}
+	solUnimplemented("");
+}
+
 void TVMExpressionCompiler::visit2(Identifier const &_identifier) {
 	const string& name = _identifier.name();
 	if (pushLocalOrStateVariable(_identifier)) {
@@ -472,6 +492,36 @@ void TVMExpressionCompiler::visitBinaryOperationForString(
 	}
 }
 
+// Compiles `a + b + c + ...` with one string builder, so intermediate strings aren't created.
+// String literals are appended as slices without building cells for them.
+bool TVMExpressionCompiler::tryConcatenateStrings(BinaryOperation const& _binaryOperation) {
+	std::vector<Expression const*> const order = unroll(_binaryOperation);
+	int literalQty = 0;
+	for (Expression const* e : order)
+		if (to<StringLiteralType>(getType(e)))
+			++literalQty;
+	// concatenation of two strings is done by __concatenateStrings, concatenation of literals is done by the optimizer
+	if ((order.size() == 2 && literalQty == 0) || literalQty == static_cast<int>(order.size()))
+		return false;
+
+	Type const* commonType = _binaryOperation.annotation().commonType;
+	int const stackSize = m_pusher.stackSize();
+	m_pusher.pushStringBuilder();
+	for (Expression const* e : order) {
+		// stack: Stack(TvmBuilder)
+		if (auto literal = to<StringLiteralType>(getType(e))) {
+			m_pusher.appendToStringBuilder(literal->value());
+		} else {
+			compileNewExpr(e);
+			m_pusher.convert(commonType, getType(e));
+			m_pusher.pushFragmentInCallRef(2, 1, "__appendStringToStringBuilder");
+		}
+	}
+	m_pusher.pushFragmentInCallRef(1, 1, "__makeString");
+	solAssert(stackSize + 1 == m_pusher.stackSize(), "");
+	return true;
+}
+
 void TVMExpressionCompiler::visitBinaryOperationForTvmCell(
 	const std::function<void()>& pushLeft,
 	const std::function<void()>& pushRight,
@@ -606,6 +656,8 @@ void TVMExpressionCompiler::visit2(BinaryOperation const &_binaryOperation) {
 	}
 
 	if (isString(commonType)) {
+		if (op == Token::Add && tryConcatenateStrings(_binaryOperation))
+			return;
 		visitBinaryOperationForString(acceptLeft, acceptRight, op);
 		return;
 	}
@@ -969,6 +1021,11 @@ void TVMExpressionCompiler::visit2(MemberAccess const &_node) {
 	const std::string& memberName = _node.memberName();
 	auto category = getType(&_node.expression())->category();
 	if (category == Type::Category::Struct) {
+		if (std::optional<int> offset = scalarStructMemberOffset(_node)) {
+			m_pusher.pushS(*offset);
+			return;
+		}
+
 		Expression const* expression = &_node.expression();
 		acceptExpr(expression);
 
@@ -1266,7 +1323,10 @@ TVMExpressionCompiler::expandLValue(
 		if (auto variable = to<Identifier>(lValueInfo.expressions[i])) {
 			auto& stack = m_pusher.getStack();
 			auto name = variable->name();
-			if (stack.isParam(variable->annotation().referencedDeclaration)) {
+			if (isScalarStruct(*variable)) {
+				// members are expanded separately
+				solAssert(!isLast, "");
+			} else if (stack.isParam(variable->annotation().referencedDeclaration)) {
 				if (isLast && !withExpandLastValue)
 					break;
 				pushLocalOrStateVariable(*variable);
@@ -1324,6 +1384,10 @@ TVMExpressionCompiler::expandLValue(
 			if (isLast && !withExpandLastValue) {
 				break;
 			}
+			if (std::optional<int> offset = scalarStructMemberOffset(*memberAccess)) {
+				m_pusher.pushS(*offset);
+				continue;
+			}
 			m_pusher.pushS(0);
 			structCompiler.pushMember(memberName);
 		} else if (isOptionalGet(lValueInfo.expressions[i])) {
@@ -1359,7 +1423,9 @@ TVMExpressionCompiler::collectLValue(
 
 		if (auto variable = to<Identifier>(lValueInfo.expressions[i])) {
 			auto& stack = m_pusher.getStack();
-			if (stack.isParam(variable->annotation().referencedDeclaration)) {
+			if (isScalarStruct(*variable)) {
+				// members are already collected
+			} else if (stack.isParam(variable->annotation().referencedDeclaration)) {
 				solAssert((haveValueOnStackTop && n == 1) || n > 1, "");
 				m_pusher.assignStackVariable(variable->annotation().referencedDeclaration);
 			} else {
@@ -1405,6 +1471,11 @@ TVMExpressionCompiler::collectLValue(
 				solUnimplemented("");
 			}
 		} else if (auto memberAccess = to<MemberAccess>(lValueInfo.expressions[i])) {
+			if (std::optional<int> offset = scalarStructMemberOffset(*memberAccess)) {
+				// value
+				m_pusher.popS(*offset);
+				continue;
+			}
 			auto structType = to<StructType>(memberAccess->expression().annotation().type);
 			StructCompiler structCompiler{&m_pusher, structType};
 			const string &memberName = memberAccess->memberName();
@@ -44,6 +44,8 @@ public:
 protected:
 	bool tryPushConstant(Declaration const* declaration);
 	bool pushLocalOrStateVariable(Identifier const& _identifier);
+	bool isScalarStruct(Identifier const& _identifier) const;
+	std::optional<int> scalarStructMemberOffset(MemberAccess const& _memberAccess) const;
 
 	void visit2(Identifier const& _identifier);
 	void compileUnaryOperation(UnaryOperation const& _node, const std::string& tvmUnaryOperation, bool isPrefixOperation);
@@ -62,6 +64,7 @@ protected:
 		const std::function<void()>& pushRight,
 		const Token op
 	);
+	bool tryConcatenateStrings(BinaryOperation const& _binaryOperation);
 	void visitLogicalShortCircuiting(BinaryOperation const &_binaryOperation);
 	void visit2(BinaryOperation const& _node);
 protected:
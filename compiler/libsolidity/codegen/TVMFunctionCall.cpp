@@ -657,7 +657,10 @@ bool FunctionCallCompiler::checkRemoteMethodCall(FunctionCall const &_functionCa
 			constParams[TvmConst::int_msg_info::tons] = getDefaultMsgValue();
 
 		// remote_addr
-		exprs[TvmConst::int_msg_info::dest] = &memberAccess->expression();
+		if (auto address = ExprUtils::constAddress(memberAccess->expression()))
+			constParams[TvmConst::int_msg_info::dest] = *address;
+		else
+			exprs[TvmConst::int_msg_info::dest] = &memberAccess->expression();
 
 		// function definition
 		functionDefinition = getRemoteFunctionDefinition(memberAccess);
@@ -687,7 +690,10 @@ bool FunctionCallCompiler::checkRemoteMethodCall(FunctionCall const &_functionCa
 		if (memberValue == nullptr) {
 			return false;
 		}
-		exprs[TvmConst::int_msg_info::dest] = &memberValue->expression();
+		if (auto address = ExprUtils::constAddress(memberValue->expression()))
+			constParams[TvmConst::int_msg_info::dest] = *address;
+		else
+			exprs[TvmConst::int_msg_info::dest] = &memberValue->expression();
 		functionDefinition = getRemoteFunctionDefinition(memberValue);
 		if (functionDefinition == nullptr) {
 			return false;
@@ -820,9 +826,13 @@ void FunctionCallCompiler::abiBuildIntMsg() {
 		{bounceArg, "bounce", TvmConst::int_msg_info::bounce}
 	}) {
 		if (argIndex != - 1) {
+			std::optional<std::string> address = id == TvmConst::int_msg_info::dest ?
+				ExprUtils::constAddress(*m_arguments.at(argIndex)) : std::nullopt;
 			std::optional<bigint> value = ExprUtils::constValue(*m_arguments.at(argIndex));
 			std::optional<bool> flag = ExprUtils::constBool(*m_arguments.at(argIndex));
-			if (value) {
+			if (address) {
+				constParams[id] = *address;
+			} else if (value) {
 				constParams[id] = StrUtils::tonsToBinaryString(*value);
 			} else if (flag) {
 				constParams[id] = StrUtils::boolToBinaryString(*flag);
@@ -2013,7 +2023,10 @@ void FunctionCallCompiler::addressMethod() {
 			};
 		};
 
-		exprs[TvmConst::int_msg_info::dest] = &m_memberAccess->expression();
+		if (auto address = ExprUtils::constAddress(m_memberAccess->expression()))
+			constParams[TvmConst::int_msg_info::dest] = *address;
+		else
+			exprs[TvmConst::int_msg_info::dest] = &m_memberAccess->expression();
 
 		int argumentQty = static_cast<int>(m_arguments.size());
 		if (!m_names.empty() || argumentQty == 0) {
@@ -3391,24 +3404,11 @@ bool FunctionCallCompiler::checkSolidityUnits() {
 				pos = 0;
 			}
 			// stack: Stack(TvmBuilder)
-			m_pusher << "NEWC";
-			m_pusher << "NULL";
-			m_pusher << "TUPLE 2";
-
-			auto pushConstStr = [&](const string& constStr) {
-				if (!constStr.empty()) {
-					size_t maxSlice = TvmConst::CellBitLength / 8;
-					for(size_t i = 0; i  < constStr.length(); i += maxSlice) {
-						m_pusher.pushString(constStr.substr(i, min(maxSlice, constStr.length() - i)), true);
-						// stack: Stack(TvmBuilder) slice
-						m_pusher.pushFragmentInCallRef(2, 1, "__appendSliceToStringBuilder");
-					}
-					// stack: Stack(TvmBuilder) slice
-				}
-			};
+			m_pusher.pushStringBuilder();
+
 			for (size_t it = 0; it < substrings.size(); it++) {
 				// stack: Stack(TvmBuilder)
-				pushConstStr(substrings[it].first);
+				m_pusher.appendToStringBuilder(substrings[it].first);
 
 				Type::Category cat = m_arguments[it + 1]->annotation().type->category();
 				Type const *argType = m_arguments[it + 1]->annotation().type;
@@ -3462,7 +3462,7 @@ bool FunctionCallCompiler::checkSolidityUnits() {
 					cast_error(*m_arguments[it + 1].get(), "Unsupported argument type");
 				}
 			}
-			pushConstStr(formatStr);
+			m_pusher.appendToStringBuilder(formatStr);
 
 			m_pusher.pushFragmentInCallRef(1, 1, "__makeString");
 
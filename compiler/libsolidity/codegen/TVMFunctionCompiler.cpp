@@ -402,7 +402,7 @@ TVMFunctionCompiler::generatePublicFunction(TVMCompilerContext& ctx, FunctionDef
 	ctx.resetCurrentFunction();
 	// takes selector, sliceWithBody, functionId
 	// returns nothing
-	return createNode<Function>(3, 0, name, nullopt, type, block);
+	return createNode<Function>(3, 0, name, nullopt, type, block, function);
 }
 
 void TVMFunctionCompiler::generateFunctionWithModifiers(
@@ -481,7 +481,7 @@ Pointer<Function> TVMFunctionCompiler::generateLibFunctionWithObject(
 	int take = function->parameters().size();
 	int ret = function->returnParameters().size();
 	ctx.resetCurrentFunction();
-	return createNode<Function>(take, ret + 1, name, nullopt, Function::FunctionType::Fragment, pusher.getBlock());
+	return createNode<Function>(take, ret + 1, name, nullopt, Function::FunctionType::Fragment, pusher.getBlock(), function);
 }
 
 Pointer<Function> TVMFunctionCompiler::generateReceive(TVMCompilerContext& ctx, FunctionDefinition const* function) {
@@ -520,7 +520,7 @@ Pointer<Function> TVMFunctionCompiler::generateReceiveOrFallbackOrOnBounce(
 	funCompiler.pushC4ToC7IfNeed();
 	funCompiler.visitFunctionWithModifiers();
 	funCompiler.updC4IfItNeeds();
-	return createNode<Function>(take, 0, name, nullopt, Function::FunctionType::Fragment, pusher.getBlock());
+	return createNode<Function>(take, 0, name, nullopt, Function::FunctionType::Fragment, pusher.getBlock(), function);
 }
 
 // pop params.size() elements from stack top
@@ -647,6 +647,7 @@ void TVMFunctionCompiler::visitModifierOrFunctionBlock(Block const &body, int ar
 	if (m_currentModifier == static_cast<int>(m_function->modifiers().size()) && withPrelocatedRetValues(m_function)) {
 		pushDefaultParameters(m_function->returnParameters());
 	}
+	m_scalarStructs = ScalarStructFinder{body}.scalarStructs();
 	acceptBody(body, {{argQty, nameRetQty}});
 	if (locationReturn == LocationReturn::Last) {
 		m_pusher.pollLastRetOpcode();
@@ -763,6 +764,13 @@ void TVMFunctionCompiler::acceptExpr(const Expression *expr, const bool isResult
 }
 
 bool TVMFunctionCompiler::visit(VariableDeclarationStatement const &_variableDeclarationStatement) {
+	if (_variableDeclarationStatement.declarations().size() == 1 &&
+		m_scalarStructs.count(_variableDeclarationStatement.declarations().at(0).get())
+	) {
+		declareScalarStruct(_variableDeclarationStatement);
+		return false;
+	}
+
 	const int saveStackSize = m_pusher.stackSize();
 	int bad = 0;
 	ast_vec<VariableDeclaration> variables = _variableDeclarationStatement.declarations();
@@ -829,6 +837,30 @@ bool TVMFunctionCompiler::visit(VariableDeclarationStatement const &_variableDec
 	return false;
 }
 
+void TVMFunctionCompiler::declareScalarStruct(VariableDeclarationStatement const& _variableDeclarationStatement) {
+	const int saveStackSize = m_pusher.stackSize();
+	VariableDeclaration const* variable = _variableDeclarationStatement.declarations().at(0).get();
+	auto structType = to<StructType>(variable->type());
+	ast_vec<VariableDeclaration> const& members = structType->structDefinition().members();
+	const int memberQty = members.size();
+
+	// stack: member0 member1 ... memberN
+	if (auto init = _variableDeclarationStatement.initialValue()) {
+		acceptExpr(init);
+		m_pusher.convert(variable->type(), init->annotation().type);
+		m_pusher.untuple(memberQty);
+	} else {
+		for (const ASTPointer<VariableDeclaration>& member : members) {
+			m_pusher.pushDefaultValue(member->type());
+		}
+	}
+
+	m_pusher.getStack().change(-1);
+	m_pusher.getStack().add(variable, true);
+	m_pusher.getStack().addScalarStruct(variable, memberQty);
+	m_pusher.ensureSize(saveStackSize + memberQty, "VariableDeclarationStatement", &_variableDeclarationStatement);
+}
+
 void TVMFunctionCompiler::acceptBody(Block const& _block, std::optional<std::tuple<int, int>> functionBlock) {
 	const int startStackSize = m_pusher.stackSize();
 
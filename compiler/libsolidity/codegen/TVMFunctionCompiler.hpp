@@ -90,6 +90,7 @@ private:
 	bool visitNode(ASTNode const&) override { solUnimplemented("Internal error: unreachable"); }
 
 	bool visit(VariableDeclarationStatement const& _variableDeclarationStatement) override;
+	void declareScalarStruct(VariableDeclarationStatement const& _variableDeclarationStatement);
 	void acceptBody(Block const& _block, std::optional<std::tuple<int, int>> functionBlock);
 	bool visit(Block const& _block) override;
 	bool visit(ExpressionStatement const& _expressionStatement) override;
@@ -134,6 +135,7 @@ private:
 private:
 	StackPusher& m_pusher;
 	std::vector<ControlFlowInfo> m_controlFlowInfo;
+	std::set<VariableDeclaration const*> m_scalarStructs;
 
 	const int m_startStackSize{};
 	const int m_currentModifier{};
@@ -0,0 +1,2299 @@
+/*
+ * Copyright (C) 2025 EverX. All Rights Reserved.
+ *
+ * Licensed under the  terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the  GNU General Public License for more details at: https://www.gnu.org/licenses/gpl-3.0.html
+ */
+/**
+ * Interpreter of the TVM assembly of a contract
+ */
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <libsolidity/codegen/TVMCodeMetrics.hpp>
+#include <libsolidity/codegen/TVMCommons.hpp>
+#include <libsolidity/codegen/TVMInterpreter.hpp>
+#include <libsolidity/codegen/TvmAstVisitor.hpp>
+
+#include <libsolutil/Common.h>
+#include <libsolutil/picosha2.h>
+
+#include <algorithm>
+#include <set>
+#include <sstream>
+
+using namespace std;
+using namespace solidity;
+using namespace solidity::util;
+using namespace solidity::frontend;
+
+namespace {
+
+std::size_t constexpr maxCellBits = 1023;
+std::size_t constexpr maxCellRefs = 4;
+std::size_t constexpr maxTupleSize = 255;
+/// Continuations nested deeper than that stop the run as if it ran out of gas.
+int constexpr maxDepth = 2000;
+
+namespace ExitCode {
+	int constexpr stackUnderflow = 2;
+	int constexpr intOverflow = 4;
+	int constexpr rangeCheck = 5;
+	int constexpr typeCheck = 7;
+	int constexpr cellOverflow = 8;
+	int constexpr cellUnderflow = 9;
+	int constexpr dictError = 10;
+	int constexpr unknownFunction = 78;
+}
+
+bigint const& pow2(int _n) {
+	static std::vector<bigint> const powers = []() {
+		std::vector<bigint> p(1025);
+		for (std::size_t i = 0; i < p.size(); ++i)
+			p[i] = bigint(1) << i;
+		return p;
+	}();
+	return powers.at(_n);
+}
+
+bool fitsSigned(bigint const& _value, int _bits) {
+	if (_bits == 0)
+		return _value == 0;
+	return -pow2(_bits - 1) <= _value && _value < pow2(_bits - 1);
+}
+
+bool fitsUnsigned(bigint const& _value, int _bits) {
+	return 0 <= _value && _value < pow2(_bits);
+}
+
+bigint floorDiv(bigint const& _a, bigint const& _b) {
+	bigint q = _a / _b;
+	if (q * _b != _a && ((_a < 0) != (_b < 0)))
+		--q;
+	return q;
+}
+
+bigint ceilDiv(bigint const& _a, bigint const& _b) {
+	return -floorDiv(-_a, _b);
+}
+
+/// Division rounded to the nearest integer, ties are rounded up.
+bigint roundDiv(bigint const& _a, bigint const& _b) {
+	return floorDiv(2 * _a + _b, 2 * _b);
+}
+
+bigint floorMod(bigint const& _a, bigint const& _b) {
+	return _a - _b * floorDiv(_a, _b);
+}
+
+/// Bitwise operations work on the 257-bit two's complement representation.
+bigint toTwos(bigint const& _value) {
+	return _value < 0 ? bigint(_value + pow2(257)) : _value;
+}
+
+bigint fromTwos(bigint const& _value) {
+	return _value >= pow2(256) ? bigint(_value - pow2(257)) : _value;
+}
+
+int bitLength(bigint _value) {
+	int bits = 0;
+	while (_value > 0) {
+		_value >>= 1;
+		++bits;
+	}
+	return bits;
+}
+
+/// @returns the number of bits of an integer that is at most @a _max, as in the TL-B type (#<= max).
+int bitsFor(std::size_t _max) {
+	return bitLength(bigint(_max));
+}
+
+std::string toBits(bigint _value, std::size_t _bits) {
+	if (_value < 0)
+		_value += pow2(static_cast<int>(_bits));
+	std::string bits(_bits, '0');
+	for (std::size_t i = 0; i < _bits; ++i)
+		if (bit_test(_value, static_cast<unsigned>(i)))
+			bits[_bits - 1 - i] = '1';
+	return bits;
+}
+
+bigint fromBits(std::string const& _bits, bool _signed) {
+	bigint value = 0;
+	for (char c : _bits)
+		value = value * 2 + (c == '1' ? 1 : 0);
+	if (_signed && !_bits.empty() && _bits.at(0) == '1')
+		value -= pow2(static_cast<int>(_bits.size()));
+	return value;
+}
+
+/// Reverses the order of the bytes of @a _bits.
+std::string reverseBytes(std::string const& _bits) {
+	std::string result;
+	for (std::size_t i = _bits.size(); i >= 8; i -= 8)
+		result += _bits.substr(i - 8, 8);
+	return result;
+}
+
+std::string bitsToHex(std::string _bits) {
+	bool const tagged = _bits.size() % 4 != 0;
+	if (tagged) {
+		_bits += '1';
+		while (_bits.size() % 4 != 0)
+			_bits += '0';
+	}
+	std::string hex;
+	for (std::size_t i = 0; i < _bits.size(); i += 4)
+		hex += "0123456789ABCDEF"[static_cast<int>(fromBits(_bits.substr(i, 4), false))];
+	return "x" + hex + (tagged ? "_" : "");
+}
+
+std::string cellToString(VmCellPtr const& _cell) {
+	std::string result = bitsToHex(_cell->bits);
+	for (VmCellPtr const& ref : _cell->refs)
+		result += ",C{" + cellToString(ref) + "}";
+	return result;
+}
+
+/// @returns the bits of the slice literal @a _literal, e.g. "x4_".
+std::string literalBits(std::string const& _literal) {
+	if (_literal.empty() || _literal == "x")
+		return "";
+	return StrUtils::toBitString(_literal);
+}
+
+std::optional<int> toInt(std::string const& _str) {
+	int value{};
+	if (boost::conversion::try_lexical_convert(boost::algorithm::trim_copy(_str), value))
+		return value;
+	return {};
+}
+
+/// @returns the arguments of an instruction, e.g. {1, 2} for "S1, S2" or "1, 2".
+std::vector<int> instructionArgs(std::string const& _arg) {
+	std::vector<int> args;
+	std::istringstream stream{_arg};
+	for (std::string item; std::getline(stream, item, ',');) {
+		boost::algorithm::trim(item);
+		if (!item.empty() && (item.at(0) == 'S' || item.at(0) == 's'))
+			item = item.substr(1);
+		std::optional<int> const value = toInt(item);
+		solAssert(value, "Bad argument of instruction: " + _arg);
+		args.push_back(*value);
+	}
+	return args;
+}
+
+int intArg(std::string const& _arg) {
+	std::optional<int> const value = toInt(_arg);
+	solAssert(value, "Bad argument of instruction: " + _arg);
+	return *value;
+}
+
+/// Reads the cell that the hard-coded assembly defines with PUSHREF or .cell, e.g. ".blob x4_".
+Pointer<PushCellOrSlice> parseCell(std::vector<std::string> const& _lines, std::size_t& _pos, PushCellOrSlice::Type _type) {
+	std::string blob;
+	Pointer<PushCellOrSlice> child;
+	while (_pos < _lines.size()) {
+		std::string const text = boost::algorithm::trim_copy(_lines[_pos].substr(0, _lines[_pos].find(';')));
+		++_pos;
+		if (text.empty())
+			continue;
+		if (text == "}")
+			break;
+		if (boost::algorithm::starts_with(text, ".blob "))
+			blob += literalBits(boost::algorithm::trim_copy(text.substr(6)));
+		else if (text == ".cell {") {
+			solUnimplementedAssert(!child, "Cells with several references are not supported");
+			child = parseCell(_lines, _pos, PushCellOrSlice::Type::CELL);
+		} else
+			solUnimplemented("Unsupported cell in assembly: " + text);
+	}
+	return createNode<PushCellOrSlice>(_type, blob.empty() ? "" : StrUtils::binaryStringToSlice(blob), child);
+}
+
+/// Converts hard-coded assembly to TvmAst, continuations in the assembly become CodeBlocks.
+Pointer<CodeBlock> parseHardCode(std::vector<std::string> const& _lines, std::size_t& _pos, CodeBlock::Type _type) {
+	std::vector<Pointer<TvmAstNode>> instructions;
+	while (_pos < _lines.size()) {
+		std::string const text = boost::algorithm::trim_copy(_lines[_pos].substr(0, _lines[_pos].find(';')));
+		++_pos;
+		if (text.empty())
+			continue;
+		if (text == "}")
+			break;
+		if (text.back() != '{') {
+			instructions.push_back(createNode<StackOpcode>(text, 0, 0));
+			continue;
+		}
+		std::string const head = boost::algorithm::trim_copy(text.substr(0, text.size() - 1));
+		if (head == "PUSHCONT")
+			instructions.push_back(parseHardCode(_lines, _pos, CodeBlock::Type::PUSHCONT));
+		else if (head == "PUSHREFCONT")
+			instructions.push_back(parseHardCode(_lines, _pos, CodeBlock::Type::PUSHREFCONT));
+		else if (isIn(head, "CALLREF", "JMPREF")) {
+			Pointer<CodeBlock> body = parseHardCode(_lines, _pos, CodeBlock::Type::PUSHREFCONT);
+			instructions.push_back(createNode<SubProgram>(0, 0, head == "JMPREF", body, false));
+		} else if (isIn(head, "IFREF", "IFNOTREF", "IFJMPREF", "IFNOTJMPREF")) {
+			Pointer<CodeBlock> body = parseHardCode(_lines, _pos, CodeBlock::Type::PUSHREFCONT);
+			bool const withNot = head.find("NOT") != std::string::npos;
+			bool const withJmp = head.find("JMP") != std::string::npos;
+			instructions.push_back(createNode<TvmIfElse>(withNot, withJmp, body, nullptr, 0));
+		} else if (head == "PUSHREF")
+			instructions.push_back(parseCell(_lines, _pos, PushCellOrSlice::Type::PUSHREF));
+		else if (head == "PUSHREFSLICE")
+			instructions.push_back(parseCell(_lines, _pos, PushCellOrSlice::Type::PUSHREFSLICE));
+		else
+			solUnimplemented("Unsupported assembly: " + text);
+	}
+	return createNode<CodeBlock>(_type, instructions);
+}
+
+VmCellPtr cellChain(PushCellOrSlice const& _node) {
+	std::vector<VmCellPtr> refs;
+	if (_node.child())
+		refs.push_back(cellChain(*_node.child()));
+	return TVMInterpreter::makeCell(literalBits(_node.blob()), refs);
+}
+
+}
+
+bigint const& VmCell::hash() const {
+	if (!m_hash) {
+		// Representation of an ordinary cell: descriptors, data with a completion tag,
+		// and the depths and the hashes of the references.
+		std::string data = bits;
+		if (data.size() % 8 != 0) {
+			data += '1';
+			while (data.size() % 8 != 0)
+				data += '0';
+		}
+		std::vector<uint8_t> repr;
+		repr.push_back(static_cast<uint8_t>(refs.size()));
+		repr.push_back(static_cast<uint8_t>(bits.size() / 8 + (bits.size() + 7) / 8));
+		for (std::size_t i = 0; i < data.size(); i += 8)
+			repr.push_back(static_cast<uint8_t>(fromBits(data.substr(i, 8), false)));
+		for (VmCellPtr const& ref : refs) {
+			repr.push_back(static_cast<uint8_t>(ref->depth() >> 8));
+			repr.push_back(static_cast<uint8_t>(ref->depth() & 0xFF));
+		}
+		for (VmCellPtr const& ref : refs) {
+			std::string const refHash = toBits(ref->hash(), 256);
+			for (std::size_t i = 0; i < refHash.size(); i += 8)
+				repr.push_back(static_cast<uint8_t>(fromBits(refHash.substr(i, 8), false)));
+		}
+		std::vector<uint8_t> digest(32);
+		picosha2::hash256(repr.begin(), repr.end(), digest.begin(), digest.end());
+		bigint value = 0;
+		for (uint8_t byte : digest)
+			value = value * 256 + byte;
+		m_hash = value;
+	}
+	return *m_hash;
+}
+
+int VmCell::depth() const {
+	if (!m_depth) {
+		int depth = 0;
+		for (VmCellPtr const& ref : refs)
+			depth = std::max(depth, ref->depth() + 1);
+		m_depth = depth;
+	}
+	return *m_depth;
+}
+
+bool VmValue::operator==(VmValue const& _other) const {
+	if (value.index() != _other.value.index())
+		return false;
+	auto refsEqual = [](auto beginA, auto endA, auto beginB, auto endB) {
+		return std::equal(beginA, endA, beginB, endB, [](VmCellPtr const& a, VmCellPtr const& b) {
+			return a == b || a->hash() == b->hash();
+		});
+	};
+	return std::visit([&](auto const& a) -> bool {
+		using T = std::decay_t<decltype(a)>;
+		auto const& b = std::get<T>(_other.value);
+		if constexpr (std::is_same_v<T, VmNull> || std::is_same_v<T, VmNaN>)
+			return true;
+		else if constexpr (std::is_same_v<T, bigint>)
+			return a == b;
+		else if constexpr (std::is_same_v<T, VmCellPtr>)
+			return a == b || a->hash() == b->hash();
+		else if constexpr (std::is_same_v<T, VmSlice>)
+			return a.bits() == b.bits() && refsEqual(
+				a.cell->refs.begin() + a.refBegin, a.cell->refs.begin() + a.refEnd,
+				b.cell->refs.begin() + b.refBegin, b.cell->refs.begin() + b.refEnd
+			);
+		else if constexpr (std::is_same_v<T, VmBuilder>)
+			return a.bits == b.bits && refsEqual(a.refs.begin(), a.refs.end(), b.refs.begin(), b.refs.end());
+		else if constexpr (std::is_same_v<T, VmTuple>)
+			return a == b || *a == *b;
+		else
+			return a.block == b.block;
+	}, value);
+}
+
+std::string VmValue::toString() const {
+	return std::visit([](auto const& a) -> std::string {
+		using T = std::decay_t<decltype(a)>;
+		if constexpr (std::is_same_v<T, VmNull>)
+			return "null";
+		else if constexpr (std::is_same_v<T, VmNaN>)
+			return "NaN";
+		else if constexpr (std::is_same_v<T, bigint>)
+			return a.str();
+		else if constexpr (std::is_same_v<T, VmCellPtr>)
+			return "C{" + cellToString(a) + "}";
+		else if constexpr (std::is_same_v<T, VmSlice>) {
+			VmCellPtr const cell = TVMInterpreter::makeCell(
+				a.bits(),
+				{a.cell->refs.begin() + a.refBegin, a.cell->refs.begin() + a.refEnd}
+			);
+			return "CS{" + cellToString(cell) + "}";
+		} else if constexpr (std::is_same_v<T, VmBuilder>)
+			return "BC{" + cellToString(TVMInterpreter::makeCell(a.bits, a.refs)) + "}";
+		else if constexpr (std::is_same_v<T, VmTuple>) {
+			std::string result = "[";
+			for (std::size_t i = 0; i < a->size(); ++i)
+				result += (i == 0 ? "" : " ") + a->at(i).toString();
+			return result + "]";
+		} else
+			return a.block ? "Cont" : "Cont{selector}";
+	}, value);
+}
+
+TVMInterpreter::TVMInterpreter(Contract const* _contract, int64_t _gasLimit) :
+	m_contract{_contract},
+	m_gasLimit{_gasLimit}
+{
+	if (m_contract == nullptr)
+		return;
+	for (Pointer<Function> const& f : m_contract->functions()) {
+		m_functionsByName[f->name()] = f.get();
+		if (f->functionId())
+			m_functionsById.emplace(*f->functionId(), f.get());
+	}
+	for (auto const& [id, name] : m_contract->privateFunctions())
+		if (m_functionsByName.count(name))
+			m_functionsById[id] = m_functionsByName.at(name);
+}
+
+TVMRunResult TVMInterpreter::run(std::string const& _functionName, TVMRunState _state) {
+	solAssert(m_functionsByName.count(_functionName), "Unknown function: " + _functionName);
+	return run(*m_functionsByName.at(_functionName)->block(), std::move(_state));
+}
+
+TVMRunResult TVMInterpreter::run(CodeBlock const& _block, TVMRunState _state) {
+	m_stack = std::move(_state.stack);
+	m_c4 = _state.c4 ? _state.c4 : makeCell("");
+	m_c7 = _state.c7.isNull() ? defaultC7() : _state.c7;
+	m_c3 = VmContinuation{};
+	m_committedC4 = m_c4;
+	m_actions.clear();
+	m_committedActions.clear();
+	m_gas = 0;
+	m_altIsReturn = false;
+	m_depth = 0;
+	// Nodes may have been changed since the previous run.
+	m_printedGas.clear();
+	m_hardCode.clear();
+
+	TVMRunResult result;
+	try {
+		Status const status = runContinuation(_block);
+		result.exitCode = status == Status::RetAlt ? 1 : 0;
+		m_committedC4 = m_c4;
+		m_committedActions = m_actions;
+	} catch (VmException const& _exception) {
+		result.exitCode = _exception.code;
+		result.exitArg = _exception.arg;
+		m_stack = {_exception.arg, bigint(_exception.code)};
+	} catch (OutOfGas const&) {
+		result.exitCode = -14;
+		result.exitArg = bigint(m_gas);
+		m_stack = {bigint(m_gas), bigint(-14)};
+	}
+	result.state.stack = std::move(m_stack);
+	result.state.c4 = m_committedC4;
+	result.state.c7 = m_c7;
+	result.actions = m_committedActions;
+	result.gasUsed = std::min(m_gas, m_gasLimit);
+	return result;
+}
+
+VmValue TVMInterpreter::defaultC7() {
+	// SmartContractInfo: magic, actions, msgs_sent, unixtime, block_lt, trans_lt, rand_seed,
+	// balance, myself, global_config
+	std::vector<VmValue> info{
+		bigint(0x076ef1ea), bigint(0), bigint(0), bigint(0), bigint(0), bigint(0), bigint(0),
+		VmValue{std::make_shared<std::vector<VmValue> const>(std::vector<VmValue>{bigint(0), VmValue{}})},
+		toSlice(makeCell("00")),
+		VmValue{}
+	};
+	std::vector<VmValue> c7{VmValue{std::make_shared<std::vector<VmValue> const>(std::move(info))}};
+	return VmValue{std::make_shared<std::vector<VmValue> const>(std::move(c7))};
+}
+
+VmCellPtr TVMInterpreter::makeCell(std::string _bits, std::vector<VmCellPtr> _refs) {
+	auto cell = std::make_shared<VmCell>();
+	cell->bits = std::move(_bits);
+	cell->refs = std::move(_refs);
+	return cell;
+}
+
+VmSlice TVMInterpreter::toSlice(VmCellPtr const& _cell) {
+	return VmSlice{_cell, 0, _cell->bits.size(), 0, _cell->refs.size()};
+}
+
+TVMInterpreter::Status TVMInterpreter::runContinuation(CodeBlock const& _block) {
+	if (_block.type() == CodeBlock::Type::PUSHREFCONT)
+		charge(TvmGas::cellLoad);
+	if (m_depth >= maxDepth)
+		throw OutOfGas{};
+	bool const altIsReturn = m_altIsReturn;
+	++m_depth;
+	m_altIsReturn = false;
+	ScopeGuard restore{[&]() {
+		--m_depth;
+		m_altIsReturn = altIsReturn;
+	}};
+
+	Status status = execute(_block.instructions());
+	if (status == Status::Next)
+		charge(TvmGas::implicitRet);
+	if (status == Status::RetAlt && m_altIsReturn)
+		status = Status::Ret;
+	return status;
+}
+
+TVMInterpreter::Status TVMInterpreter::call(VmContinuation const& _cont) {
+	Status const status = _cont.block ? runContinuation(*_cont.block) : selectFunction();
+	return status == Status::RetAlt ? Status::RetAlt : Status::Next;
+}
+
+TVMInterpreter::Status TVMInterpreter::jump(VmContinuation const& _cont) {
+	Status const status = _cont.block ? runContinuation(*_cont.block) : selectFunction();
+	return status == Status::RetAlt ? Status::RetAlt : Status::Ret;
+}
+
+TVMInterpreter::Status TVMInterpreter::selectFunction() {
+	// The selector in c3 is DICTPUSHCONST 32; DICTUGETJMPZ; THROW 78
+	charge("DICTPUSHCONST 32");
+	charge("DICTUGETJMPZ");
+	bigint const id = popInt();
+	auto it = fitsUnsigned(id, 32) ? m_functionsById.find(static_cast<uint32_t>(id)) : m_functionsById.end();
+	if (it == m_functionsById.end()) {
+		push(id);
+		throwException(ExitCode::unknownFunction);
+	}
+	return runContinuation(*it->second->block());
+}
+
+TVMInterpreter::Status TVMInterpreter::callC3(uint32_t _functionId, bool _jump) {
+	push(bigint(_functionId));
+	if (!std::holds_alternative<VmContinuation>(m_c3.value))
+		throwException(ExitCode::typeCheck);
+	VmContinuation const c3 = std::get<VmContinuation>(m_c3.value);
+	return _jump ? jump(c3) : call(c3);
+}
+
+Pointer<CodeBlock> const& TVMInterpreter::hardCode(HardCode const& _node) {
+	auto it = m_hardCode.find(&_node);
+	if (it == m_hardCode.end()) {
+		std::size_t pos = 0;
+		it = m_hardCode.emplace(&_node, parseHardCode(_node.code(), pos, CodeBlock::Type::None)).first;
+	}
+	return it->second;
+}
+
+TVMInterpreter::Status TVMInterpreter::execute(std::vector<Pointer<TvmAstNode>> const& _instructions) {
+	for (Pointer<TvmAstNode> const& node : _instructions) {
+		Status const status = execute(*node);
+		if (status != Status::Next)
+			return status;
+	}
+	return Status::Next;
+}
+
+TVMInterpreter::Status TVMInterpreter::execute(TvmAstNode const& _node) {
+	if (isa<Loc>(_node)) {
+		return Status::Next;
+	} else if (auto stack = dyn_cast<Stack>(&_node)) {
+		chargePrinted(_node);
+		stackInstruction(*stack);
+		return Status::Next;
+	} else if (auto glob = dyn_cast<Glob>(&_node)) {
+		chargePrinted(_node);
+		switch (glob->opcode()) {
+		case Glob::Opcode::GetOrGetVar:
+			push(global(glob->index()));
+			break;
+		case Glob::Opcode::SetOrSetVar:
+			setGlobal(glob->index(), pop());
+			break;
+		case Glob::Opcode::PUSHROOT:
+			push(m_c4);
+			break;
+		case Glob::Opcode::POPROOT:
+			m_c4 = popCell();
+			break;
+		case Glob::Opcode::PUSH_C3:
+			push(m_c3);
+			break;
+		case Glob::Opcode::POP_C3:
+			m_c3 = popCont();
+			break;
+		case Glob::Opcode::PUSH_C7:
+			push(m_c7);
+			break;
+		case Glob::Opcode::POP_C7:
+			m_c7 = popTuple();
+			break;
+		}
+		return Status::Next;
+	} else if (isa<DeclRetFlag>(_node)) {
+		chargePrinted(_node);
+		pushBool(false);
+		return Status::Next;
+	} else if (auto asym = dyn_cast<AsymGen>(&_node)) {
+		chargePrinted(_node);
+		std::string const& text = asym->opcode();
+		auto const pos = text.find(' ');
+		return instruction(text.substr(0, pos), pos == std::string::npos ? "" : text.substr(pos + 1));
+	} else if (auto hard = dyn_cast<HardCode>(&_node)) {
+		return execute(hardCode(*hard)->instructions());
+	} else if (auto opcode = dyn_cast<StackOpcode>(&_node)) {
+		if (opcode->opcode() == ".inline") {
+			solAssert(m_functionsByName.count(opcode->arg()), "Unknown function: " + opcode->arg());
+			return execute(m_functionsByName.at(opcode->arg())->block()->instructions());
+		}
+		chargePrinted(_node);
+		return instruction(opcode->opcode(), opcode->arg());
+	} else if (auto pushCell = dyn_cast<PushCellOrSlice>(&_node)) {
+		chargePrinted(_node);
+		switch (pushCell->type()) {
+		case PushCellOrSlice::Type::PUSHREF_COMPUTE:
+		case PushCellOrSlice::Type::PUSHREFSLICE_COMPUTE:
+			solUnimplemented("Computed cells are not supported");
+		case PushCellOrSlice::Type::PUSHREF:
+		case PushCellOrSlice::Type::CELL:
+			push(cellChain(*pushCell));
+			break;
+		case PushCellOrSlice::Type::PUSHREFSLICE:
+		case PushCellOrSlice::Type::PUSHSLICE:
+			push(toSlice(cellChain(*pushCell)));
+			break;
+		}
+		return Status::Next;
+	} else if (auto block = dyn_cast<CodeBlock>(&_node)) {
+		if (block->type() == CodeBlock::Type::None)
+			return execute(block->instructions());
+		pushBlock(std::static_pointer_cast<CodeBlock const>(block->shared_from_this()));
+		return Status::Next;
+	} else if (auto sub = dyn_cast<SubProgram>(&_node)) {
+		if (sub->block()->type() == CodeBlock::Type::PUSHREFCONT)
+			charge(sub->isJmp() ? "JMPREF" : "CALLREF");
+		else
+			charge(std::string{"PUSHCONT"} + "\n" + (sub->isJmp() ? "JMPX" : "CALLX"));
+		VmContinuation const cont{sub->block()};
+		return sub->isJmp() ? jump(cont) : call(cont);
+	} else if (auto lc = dyn_cast<LogCircuit>(&_node)) {
+		charge("PUSHCONT");
+		charge(lc->type() == LogCircuit::Type::AND ? "IF" : "IFNOT");
+		bool const flag = popBool();
+		if (flag == (lc->type() == LogCircuit::Type::AND))
+			return call(VmContinuation{lc->body()});
+		return Status::Next;
+	} else if (auto ifElse = dyn_cast<TvmIfElse>(&_node)) {
+		Pointer<CodeBlock> const& trueBody = ifElse->trueBody();
+		Pointer<CodeBlock> const& falseBody = ifElse->falseBody();
+		bool const trueRef = trueBody->type() == CodeBlock::Type::PUSHREFCONT;
+		if (falseBody == nullptr) {
+			std::string const mnemonic = std::string{"IF"} + (ifElse->withNot() ? "NOT" : "") + (ifElse->withJmp() ? "JMP" : "");
+			if (trueRef)
+				charge(mnemonic + "REF");
+			else
+				charge("PUSHCONT\n" + mnemonic);
+			if (popBool() == ifElse->withNot())
+				return Status::Next;
+			return ifElse->withJmp() ? jump(VmContinuation{trueBody}) : call(VmContinuation{trueBody});
+		}
+		bool const falseRef = falseBody->type() == CodeBlock::Type::PUSHREFCONT;
+		if (trueRef && falseRef)
+			charge("IFREFELSEREF");
+		else if (trueRef)
+			charge("PUSHCONT\nIFREFELSE");
+		else if (falseRef)
+			charge("PUSHCONT\nIFELSEREF");
+		else
+			charge("PUSHCONT\nPUSHCONT\nIFELSE");
+		return call(VmContinuation{popBool() ? trueBody : falseBody});
+	} else if (auto repeat = dyn_cast<TvmRepeat>(&_node)) {
+		pushBlock(repeat->body());
+		std::string const mnemonic = repeat->withBreakOrReturn() ? "REPEATBRK" : "REPEAT";
+		charge(mnemonic);
+		return *controlFlow(mnemonic, "");
+	} else if (auto until = dyn_cast<TvmUntil>(&_node)) {
+		pushBlock(until->body());
+		std::string const mnemonic = until->withBreakOrReturn() ? "UNTILBRK" : "UNTIL";
+		charge(mnemonic);
+		return *controlFlow(mnemonic, "");
+	} else if (auto loop = dyn_cast<While>(&_node)) {
+		if (!loop->isInfinite())
+			pushBlock(loop->condition());
+		pushBlock(loop->body());
+		std::string const mnemonic = std::string{loop->isInfinite() ? "AGAIN" : "WHILE"} + (loop->withBreakOrReturn() ? "BRK" : "");
+		charge(mnemonic);
+		return *controlFlow(mnemonic, "");
+	} else if (auto tryCatch = dyn_cast<TryCatch>(&_node)) {
+		// Leaving the try block with RETALT also leaves the handler, so SAVEALT C2 changes nothing here.
+		if (tryCatch->saveAltC2())
+			charge("SAVEALT C2");
+		pushBlock(tryCatch->tryBody());
+		pushBlock(tryCatch->catchBody());
+		charge("TRYKEEP");
+		return *controlFlow("TRYKEEP", "");
+	} else if (auto ret = dyn_cast<ReturnOrBreakOrCont>(&_node)) {
+		return execute(ret->body()->instructions());
+	} else if (auto opaque = dyn_cast<Opaque>(&_node)) {
+		return execute(opaque->block()->instructions());
+	} else if (auto tvmReturn = dyn_cast<TvmReturn>(&_node)) {
+		chargePrinted(_node);
+		if (tvmReturn->withIf() && popBool() == tvmReturn->withNot())
+			return Status::Next;
+		return tvmReturn->withAlt() ? Status::RetAlt : Status::Ret;
+	} else if (auto exception = dyn_cast<TvmException>(&_node)) {
+		chargePrinted(_node);
+		return instruction(exception->opcode(), exception->arg());
+	}
+	solUnimplemented("Unsupported node");
+}
+
+void TVMInterpreter::pushBlock(std::shared_ptr<CodeBlock const> const& _block) {
+	if (_block->type() != CodeBlock::Type::None)
+		charge(CodeBlock::toString(_block->type()));
+	push(VmContinuation{_block});
+}
+
+TVMInterpreter::Status TVMInterpreter::instruction(std::string const& _mnemonic, std::string const& _arg) {
+	if (std::optional<Status> status = controlFlow(_mnemonic, _arg))
+		return *status;
+	if (
+		stackInstruction(_mnemonic, _arg) ||
+		arithmetic(_mnemonic, _arg) ||
+		tupleInstruction(_mnemonic, _arg) ||
+		cellInstruction(_mnemonic, _arg) ||
+		dictInstruction(_mnemonic) ||
+		environmentInstruction(_mnemonic, _arg)
+	)
+		return Status::Next;
+	solUnimplemented("Unsupported instruction: " + _mnemonic);
+}
+
+std::optional<TVMInterpreter::Status> TVMInterpreter::controlFlow(std::string const& _mnemonic, std::string const& _arg) {
+	if (isIn(_mnemonic, "CALLX", "EXECUTE"))
+		return call(popCont());
+	if (_mnemonic == "JMPX")
+		return jump(popCont());
+	if (isIn(_mnemonic, "IF", "IFNOT", "IFJMP", "IFNOTJMP")) {
+		VmContinuation const cont = popCont();
+		bool const withNot = _mnemonic.find("NOT") != std::string::npos;
+		if (popBool() == withNot)
+			return Status::Next;
+		return _mnemonic.find("JMP") != std::string::npos ? jump(cont) : call(cont);
+	}
+	if (_mnemonic == "IFELSE") {
+		VmContinuation const falseCont = popCont();
+		VmContinuation const trueCont = popCont();
+		return call(popBool() ? trueCont : falseCont);
+	}
+	if (isIn(_mnemonic, "CALL", "CALLDICT", "JMP", "JMPDICT"))
+		return callC3(static_cast<uint32_t>(intArg(_arg)), boost::algorithm::starts_with(_mnemonic, "JMP"));
+	if (isIn(_mnemonic, "RET", "RETALT", "IFRET", "IFNOTRET", "IFRETALT", "IFNOTRETALT")) {
+		if (boost::algorithm::starts_with(_mnemonic, "IF") && popBool() == (_mnemonic.find("NOT") != std::string::npos))
+			return Status::Next;
+		return boost::algorithm::ends_with(_mnemonic, "ALT") ? Status::RetAlt : Status::Ret;
+	}
+
+	std::string loop = _mnemonic;
+	bool const withBreak = boost::algorithm::ends_with(loop, "BRK");
+	if (withBreak)
+		loop.resize(loop.size() - 3);
+	if (!isIn(loop, "REPEAT", "UNTIL", "WHILE", "AGAIN", "TRYKEEP", "TRY"))
+		return std::nullopt;
+	VmContinuation const body = popCont();
+	if (loop == "TRYKEEP" || loop == "TRY") {
+		VmContinuation const tryBody = popCont();
+		// The handler starts from the stack as it was when the try block started.
+		std::vector<VmValue> const stack = m_stack;
+		try {
+			return call(tryBody);
+		} catch (VmException const& _exception) {
+			m_stack = stack;
+			push(_exception.arg);
+			push(bigint(_exception.code));
+			return call(body);
+		}
+	}
+
+	// c1 of the loop body is c0 of the current continuation.
+	if (withBreak)
+		m_altIsReturn = true;
+	if (loop == "REPEAT") {
+		bigint const count = popInt();
+		if (!fitsSigned(count, 32))
+			throwException(ExitCode::rangeCheck);
+		for (bigint i = 0; i < count; ++i)
+			if (call(body) == Status::RetAlt)
+				return Status::RetAlt;
+	} else if (loop == "UNTIL") {
+		do {
+			if (call(body) == Status::RetAlt)
+				return Status::RetAlt;
+		} while (!popBool());
+	} else if (loop == "WHILE") {
+		VmContinuation const condition = popCont();
+		while (true) {
+			if (call(condition) == Status::RetAlt)
+				return Status::RetAlt;
+			if (!popBool())
+				break;
+			if (call(body) == Status::RetAlt)
+				return Status::RetAlt;
+		}
+	} else {
+		while (true)
+			if (call(body) == Status::RetAlt)
+				return Status::RetAlt;
+	}
+	return Status::Next;
+}
+
+void TVMInterpreter::stackInstruction(Stack const& _node) {
+	int const i = _node.i();
+	int const j = _node.j();
+	int const k = _node.k();
+	// PUXC s(a), s(b) is PUSH s(a); SWAP; XCHG s(b+1)
+	auto puxc = [&](int a, int b) {
+		pushS(a);
+		xchg(0, 1);
+		xchg(0, b + 1);
+	};
+	auto xchg2 = [&](int a, int b) {
+		xchg(1, a);
+		xchg(0, b);
+	};
+	switch (_node.opcode()) {
+	case Stack::Opcode::DROP:
+		drop(i);
+		break;
+	case Stack::Opcode::BLKDROP2:
+		blkSwap(i, j);
+		drop(i);
+		break;
+	case Stack::Opcode::POP_S:
+		xchg(0, i);
+		drop(1);
+		break;
+	case Stack::Opcode::BLKPUSH:
+		for (int n = 0; n < i; ++n)
+			pushS(j);
+		break;
+	case Stack::Opcode::PUSH2_S:
+		pushS(i);
+		pushS(j + 1);
+		break;
+	case Stack::Opcode::PUSH3_S:
+		pushS(i);
+		pushS(j + 1);
+		pushS(k + 2);
+		break;
+	case Stack::Opcode::PUSH_S:
+		pushS(i);
+		break;
+	case Stack::Opcode::BLKSWAP:
+		blkSwap(i, j);
+		break;
+	case Stack::Opcode::REVERSE:
+		reverse(i, j);
+		break;
+	case Stack::Opcode::XCHG:
+		xchg(i, j);
+		break;
+	case Stack::Opcode::XCHG3:
+		xchg(2, i);
+		xchg(1, j);
+		xchg(0, k);
+		break;
+	case Stack::Opcode::XCHG2:
+		xchg2(i, j);
+		break;
+	case Stack::Opcode::XCPU:
+		xchg(0, i);
+		pushS(j);
+		break;
+	case Stack::Opcode::PUXC:
+		puxc(i, j);
+		break;
+	case Stack::Opcode::XC2PU:
+		xchg2(i, j);
+		pushS(k);
+		break;
+	case Stack::Opcode::XCPU2:
+		xchg(0, i);
+		pushS(j);
+		pushS(k + 1);
+		break;
+	case Stack::Opcode::PUXC2:
+		pushS(i);
+		xchg(0, 2);
+		xchg2(j + 1, k + 1);
+		break;
+	case Stack::Opcode::XCPUXC:
+		xchg(1, i);
+		puxc(j, k);
+		break;
+	case Stack::Opcode::PUXCPU:
+		puxc(i, j);
+		pushS(k + 1);
+		break;
+	case Stack::Opcode::PU2XC:
+		pushS(i);
+		xchg(0, 1);
+		puxc(j + 1, k + 1);
+		break;
+	}
+}
+
+bool TVMInterpreter::stackInstruction(std::string const& _mnemonic, std::string const& _arg) {
+	static std::map<std::string, std::tuple<Stack::Opcode, int, int>> const fixed{
+		{"DUP", {Stack::Opcode::PUSH_S, 0, -1}},
+		{"OVER", {Stack::Opcode::PUSH_S, 1, -1}},
+		{"NIP", {Stack::Opcode::POP_S, 1, -1}},
+		{"SWAP", {Stack::Opcode::XCHG, 0, 1}},
+		{"DROP", {Stack::Opcode::DROP, 1, -1}},
+		{"DROP2", {Stack::Opcode::DROP, 2, -1}},
+		{"ROT", {Stack::Opcode::BLKSWAP, 1, 2}},
+		{"ROTREV", {Stack::Opcode::BLKSWAP, 2, 1}},
+		{"-ROT", {Stack::Opcode::BLKSWAP, 2, 1}},
+		{"SWAP2", {Stack::Opcode::BLKSWAP, 2, 2}},
+		{"DUP2", {Stack::Opcode::PUSH2_S, 1, 0}},
+		{"OVER2", {Stack::Opcode::PUSH2_S, 3, 2}},
+		{"TUCK", {Stack::Opcode::XCPU, 1, 1}},
+	};
+	static std::map<std::string, Stack::Opcode> const withArgs{
+		{"PUSH", Stack::Opcode::PUSH_S},
+		{"POP", Stack::Opcode::POP_S},
+		{"BLKDROP", Stack::Opcode::DROP},
+		{"BLKDROP2", Stack::Opcode::BLKDROP2},
+		{"BLKPUSH", Stack::Opcode::BLKPUSH},
+		{"BLKSWAP", Stack::Opcode::BLKSWAP},
+		{"REVERSE", Stack::Opcode::REVERSE},
+		{"PUSH2", Stack::Opcode::PUSH2_S},
+		{"PUSH3", Stack::Opcode::PUSH3_S},
+		{"XCHG2", Stack::Opcode::XCHG2},
+		{"XCHG3", Stack::Opcode::XCHG3},
+		{"XCPU", Stack::Opcode::XCPU},
+		{"PUXC", Stack::Opcode::PUXC},
+		{"XC2PU", Stack::Opcode::XC2PU},
+		{"XCPU2", Stack::Opcode::XCPU2},
+		{"PUXC2", Stack::Opcode::PUXC2},
+		{"XCPUXC", Stack::Opcode::XCPUXC},
+		{"PUXCPU", Stack::Opcode::PUXCPU},
+		{"PU2XC", Stack::Opcode::PU2XC},
+	};
+
+	if (auto it = fixed.find(_mnemonic); it != fixed.end()) {
+		auto const& [opcode, i, j] = it->second;
+		stackInstruction(Stack{opcode, i, j});
+	} else if (auto it = withArgs.find(_mnemonic); it != withArgs.end()) {
+		std::vector<int> args = instructionArgs(_arg);
+		args.resize(3, -1);
+		stackInstruction(Stack{it->second, args[0], args[1], args[2]});
+	} else if (_mnemonic == "XCHG") {
+		std::vector<int> const args = instructionArgs(_arg);
+		if (args.size() == 1)
+			xchg(0, args.at(0));
+		else
+			xchg(args.at(0), args.at(1));
+	} else if (isIn(_mnemonic, "ROLL", "ROLLREV")) {
+		int const n = intArg(_arg);
+		_mnemonic == "ROLL" ? blkSwap(1, n) : blkSwap(n, 1);
+	} else if (_mnemonic == "ROLLX") {
+		blkSwap(1, popSmallInt(0, 255));
+	} else if (_mnemonic == "ROLLREVX") {
+		blkSwap(popSmallInt(0, 255), 1);
+	} else if (_mnemonic == "BLKSWX") {
+		int const top = popSmallInt(0, 255);
+		blkSwap(popSmallInt(0, 255), top);
+	} else if (_mnemonic == "REVX") {
+		int const index = popSmallInt(0, 255);
+		reverse(popSmallInt(0, 255), index);
+	} else if (_mnemonic == "DROPX") {
+		drop(popSmallInt(0, 255));
+	} else if (isIn(_mnemonic, "PICK", "PUSHX")) {
+		pushS(popSmallInt(0, 255));
+	} else if (_mnemonic == "XCHGX") {
+		xchg(0, popSmallInt(0, 255));
+	} else if (_mnemonic == "DEPTH") {
+		push(bigint(m_stack.size()));
+	} else if (_mnemonic == "NOP") {
+	} else if (_mnemonic == "CONDSEL") {
+		VmValue const y = pop();
+		VmValue const x = pop();
+		push(popBool() ? x : y);
+	} else {
+		// {NULL,ZERO}{SWAP,ROTR}IF[NOT]: pushes null or zero under the top one or two values if the top
+		// value is (not) zero.
+		bool const isNull = boost::algorithm::starts_with(_mnemonic, "NULL");
+		if (!isNull && !boost::algorithm::starts_with(_mnemonic, "ZERO"))
+			return false;
+		std::string const rest = _mnemonic.substr(4);
+		if (!isIn(rest, "SWAPIF", "SWAPIFNOT", "ROTRIF", "ROTRIFNOT"))
+			return false;
+		int const under = boost::algorithm::starts_with(rest, "SWAP") ? 1 : 2;
+		if (at(0) == VmValue{} || !std::holds_alternative<bigint>(at(0).value))
+			throwException(ExitCode::typeCheck);
+		bool const isZero = std::get<bigint>(at(0).value) == 0;
+		if (isZero == boost::algorithm::ends_with(rest, "NOT")) {
+			push(isNull ? VmValue{} : VmValue{bigint(0)});
+			blkSwap(under, 1);
+		}
+	}
+	return true;
+}
+
+bool TVMInterpreter::arithmetic(std::string const& _mnemonic, std::string const& _arg) {
+	// take and ret of the instructions
+	static std::map<std::string, std::pair<int, int>> const arity{
+		{"ADD", {2, 1}}, {"SUB", {2, 1}}, {"SUBR", {2, 1}}, {"MUL", {2, 1}},
+		{"DIV", {2, 1}}, {"DIVR", {2, 1}}, {"DIVC", {2, 1}}, {"MOD", {2, 1}}, {"DIVMOD", {2, 2}},
+		{"MULDIV", {3, 1}}, {"MULDIVR", {3, 1}}, {"MULDIVC", {3, 1}}, {"MULMOD", {3, 1}}, {"MULDIVMOD", {3, 2}},
+		{"AND", {2, 1}}, {"OR", {2, 1}}, {"XOR", {2, 1}}, {"NOT", {1, 1}}, {"BITNOT", {1, 1}},
+		{"MIN", {2, 1}}, {"MAX", {2, 1}}, {"MINMAX", {2, 2}},
+		{"LESS", {2, 1}}, {"LEQ", {2, 1}}, {"GREATER", {2, 1}}, {"GEQ", {2, 1}}, {"EQUAL", {2, 1}}, {"NEQ", {2, 1}}, {"CMP", {2, 1}},
+		{"NEGATE", {1, 1}}, {"INC", {1, 1}}, {"DEC", {1, 1}}, {"ABS", {1, 1}}, {"SGN", {1, 1}}, {"POW2", {1, 1}},
+		{"ADDCONST", {1, 1}}, {"MULCONST", {1, 1}}, {"MODPOW2", {1, 1}}, {"FITS", {1, 1}}, {"UFITS", {1, 1}},
+		{"EQINT", {1, 1}}, {"NEQINT", {1, 1}}, {"LESSINT", {1, 1}}, {"GTINT", {1, 1}},
+		{"ISNEG", {1, 1}}, {"ISPOS", {1, 1}}, {"ISNNEG", {1, 1}}, {"ISNPOS", {1, 1}}, {"ISZERO", {1, 1}},
+		{"BITSIZE", {1, 1}}, {"UBITSIZE", {1, 1}},
+	};
+
+	if (isIn(_mnemonic, "PUSHINT", "PUSHPOW2", "PUSHPOW2DEC", "PUSHNEGPOW2")) {
+		bigint value;
+		try {
+			value = bigint{boost::algorithm::trim_copy(_arg)};
+		} catch (...) {
+			solUnimplemented("Unsupported integer: " + _arg);
+		}
+		if (_mnemonic == "PUSHPOW2")
+			value = pow2(static_cast<int>(value));
+		else if (_mnemonic == "PUSHPOW2DEC")
+			value = pow2(static_cast<int>(value)) - 1;
+		else if (_mnemonic == "PUSHNEGPOW2")
+			value = -pow2(static_cast<int>(value));
+		pushInt(value);
+		return true;
+	}
+	static std::map<std::string, int> const constants{
+		{"TRUE", -1}, {"FALSE", 0}, {"ZERO", 0}, {"ONE", 1}, {"TWO", 2}, {"TEN", 10}
+	};
+	if (auto it = constants.find(_mnemonic); it != constants.end()) {
+		push(bigint(it->second));
+		return true;
+	}
+	if (_mnemonic == "PUSHNAN") {
+		push(VmNaN{});
+		return true;
+	}
+	if (_mnemonic == "ISNAN") {
+		VmValue const x = pop();
+		if (!std::holds_alternative<VmNaN>(x.value) && !std::holds_alternative<bigint>(x.value))
+			throwException(ExitCode::typeCheck);
+		pushBool(std::holds_alternative<VmNaN>(x.value));
+		return true;
+	}
+
+	auto isShift = [](std::string const& _name) { return isIn(_name, "LSHIFT", "RSHIFT", "MULRSHIFT"); };
+	bool const quiet = _mnemonic.size() > 1 && _mnemonic.at(0) == 'Q' &&
+		(arity.count(_mnemonic.substr(1)) || isShift(_mnemonic.substr(1)));
+	std::string const name = quiet ? _mnemonic.substr(1) : _mnemonic;
+	bool const shift = isShift(name);
+	if (!arity.count(name) && !shift)
+		return false;
+	int take = shift ? (name == "MULRSHIFT" ? 3 : 2) - (_arg.empty() ? 0 : 1) : arity.at(name).first;
+	int const ret = shift ? 1 : arity.at(name).second;
+
+	std::optional<int> shiftArg;
+	if (shift && !_arg.empty())
+		shiftArg = intArg(_arg);
+	else if (shift) {
+		shiftArg = popSmallInt(0, 1023);
+		--take;
+	}
+
+	std::vector<bigint> x(take);
+	bool isNaN = false;
+	for (int i = take - 1; i >= 0; --i) {
+		std::optional<bigint> value = quiet ? popIntOrNaN() : std::optional<bigint>{popInt()};
+		if (value)
+			x[i] = std::move(*value);
+		else
+			isNaN = true;
+	}
+	if (isNaN) {
+		for (int i = 0; i < ret; ++i)
+			push(VmNaN{});
+		return true;
+	}
+
+	// Division by zero or a result that does not fit gives NaN or an integer overflow.
+	auto result = [&](auto const& _value) {
+		if constexpr (std::is_same_v<std::decay_t<decltype(_value)>, std::optional<bigint>>) {
+			if (!_value) {
+				if (!quiet)
+					throwException(ExitCode::intOverflow);
+				push(VmNaN{});
+			} else
+				pushInt(*_value, quiet);
+		} else
+			pushInt(bigint(_value), quiet);
+	};
+	auto divide = [&](bigint const& a, bigint const& b, char rounding) -> std::optional<bigint> {
+		if (b == 0)
+			return std::nullopt;
+		return rounding == 'R' ? roundDiv(a, b) : rounding == 'C' ? ceilDiv(a, b) : floorDiv(a, b);
+	};
+	auto boolean = [&](bool _value) { result(bigint(_value ? -1 : 0)); };
+	int const arg = shift || _arg.empty() ? 0 : intArg(_arg);
+
+	if (name == "ADD") result(x[0] + x[1]);
+	else if (name == "SUB") result(x[0] - x[1]);
+	else if (name == "SUBR") result(x[1] - x[0]);
+	else if (name == "MUL") result(x[0] * x[1]);
+	else if (isIn(name, "DIV", "DIVR", "DIVC")) result(divide(x[0], x[1], name.back()));
+	else if (name == "MOD") result(x[1] == 0 ? std::nullopt : std::optional<bigint>{floorMod(x[0], x[1])});
+	else if (name == "DIVMOD") {
+		result(divide(x[0], x[1], 'F'));
+		result(x[1] == 0 ? std::nullopt : std::optional<bigint>{floorMod(x[0], x[1])});
+	}
+	else if (isIn(name, "MULDIV", "MULDIVR", "MULDIVC")) result(divide(x[0] * x[1], x[2], name.back()));
+	else if (name == "MULMOD") result(x[2] == 0 ? std::nullopt : std::optional<bigint>{floorMod(x[0] * x[1], x[2])});
+	else if (name == "MULDIVMOD") {
+		result(divide(x[0] * x[1], x[2], 'F'));
+		result(x[2] == 0 ? std::nullopt : std::optional<bigint>{floorMod(x[0] * x[1], x[2])});
+	}
+	else if (name == "LSHIFT") result(x[0] * pow2(*shiftArg));
+	else if (name == "RSHIFT") result(floorDiv(x[0], pow2(*shiftArg)));
+	else if (name == "MULRSHIFT") result(floorDiv(x[0] * x[1], pow2(*shiftArg)));
+	else if (name == "AND") result(fromTwos(toTwos(x[0]) & toTwos(x[1])));
+	else if (name == "OR") result(fromTwos(toTwos(x[0]) | toTwos(x[1])));
+	else if (name == "XOR") result(fromTwos(toTwos(x[0]) ^ toTwos(x[1])));
+	else if (isIn(name, "NOT", "BITNOT")) result(-x[0] - 1);
+	else if (name == "MIN") result(std::min(x[0], x[1]));
+	else if (name == "MAX") result(std::max(x[0], x[1]));
+	else if (name == "MINMAX") {
+		result(std::min(x[0], x[1]));
+		result(std::max(x[0], x[1]));
+	}
+	else if (name == "LESS") boolean(x[0] < x[1]);
+	else if (name == "LEQ") boolean(x[0] <= x[1]);
+	else if (name == "GREATER") boolean(x[0] > x[1]);
+	else if (name == "GEQ") boolean(x[0] >= x[1]);
+	else if (name == "EQUAL") boolean(x[0] == x[1]);
+	else if (name == "NEQ") boolean(x[0] != x[1]);
+	else if (name == "CMP") result(bigint(x[0] < x[1] ? -1 : x[0] > x[1] ? 1 : 0));
+	else if (name == "NEGATE") result(-x[0]);
+	else if (name == "INC") result(x[0] + 1);
+	else if (name == "DEC") result(x[0] - 1);
+	else if (name == "ABS") result(abs(x[0]));
+	else if (name == "SGN") result(bigint(x[0] < 0 ? -1 : x[0] > 0 ? 1 : 0));
+	else if (name == "POW2") {
+		if (x[0] < 0 || x[0] > 1023)
+			throwException(ExitCode::rangeCheck);
+		result(pow2(static_cast<int>(x[0])));
+	}
+	else if (name == "ADDCONST") result(x[0] + arg);
+	else if (name == "MULCONST") result(x[0] * arg);
+	else if (name == "MODPOW2") result(floorMod(x[0], pow2(arg)));
+	else if (name == "FITS") result(fitsSigned(x[0], arg) ? std::optional<bigint>{x[0]} : std::nullopt);
+	else if (name == "UFITS") result(fitsUnsigned(x[0], arg) ? std::optional<bigint>{x[0]} : std::nullopt);
+	else if (name == "EQINT") boolean(x[0] == arg);
+	else if (name == "NEQINT") boolean(x[0] != arg);
+	else if (name == "LESSINT") boolean(x[0] < arg);
+	else if (name == "GTINT") boolean(x[0] > arg);
+	else if (name == "ISNEG") boolean(x[0] < 0);
+	else if (name == "ISPOS") boolean(x[0] > 0);
+	else if (name == "ISNNEG") boolean(x[0] >= 0);
+	else if (name == "ISNPOS") boolean(x[0] <= 0);
+	else if (name == "ISZERO") boolean(x[0] == 0);
+	else if (name == "BITSIZE") {
+		int bits = 0;
+		while (!fitsSigned(x[0], bits))
+			++bits;
+		result(bigint(bits));
+	}
+	else if (name == "UBITSIZE") {
+		if (x[0] < 0)
+			throwException(ExitCode::rangeCheck);
+		result(bigint(bitLength(x[0])));
+	}
+	else
+		solUnimplemented("");
+	return true;
+}
+
+bool TVMInterpreter::tupleInstruction(std::string const& _mnemonic, std::string const& _arg) {
+	auto makeTuple = [](std::vector<VmValue> _values) {
+		return VmValue{std::make_shared<std::vector<VmValue> const>(std::move(_values))};
+	};
+	auto popValues = [&](int n) {
+		std::vector<VmValue> values(n);
+		for (int i = n - 1; i >= 0; --i)
+			values[i] = pop();
+		return values;
+	};
+	auto index = [&](VmTuple const& t, int i) -> VmValue {
+		if (i < 0 || static_cast<std::size_t>(i) >= t->size())
+			throwException(ExitCode::rangeCheck);
+		return t->at(i);
+	};
+	auto setIndex = [&](VmValue const& t, int i, VmValue x, bool quiet) {
+		std::vector<VmValue> values;
+		if (!t.isNull() || !quiet) {
+			if (!std::holds_alternative<VmTuple>(t.value))
+				throwException(ExitCode::typeCheck);
+			values = *std::get<VmTuple>(t.value);
+		}
+		if (static_cast<std::size_t>(i) >= values.size()) {
+			if (!quiet)
+				throwException(ExitCode::rangeCheck);
+			if (x.isNull()) {
+				push(t);
+				return;
+			}
+			values.resize(i + 1);
+		}
+		values[i] = std::move(x);
+		push(makeTuple(std::move(values)));
+	};
+	static std::map<std::string, int> const aliases{
+		{"SINGLE", 1}, {"PAIR", 2}, {"TRIPLE", 3}, {"UNSINGLE", 1}, {"UNPAIR", 2}, {"UNTRIPLE", 3},
+		{"FIRST", 0}, {"SECOND", 1}, {"THIRD", 2},
+	};
+	std::string name = _mnemonic;
+	std::string arg = _arg;
+	if (auto it = aliases.find(name); it != aliases.end()) {
+		arg = std::to_string(it->second);
+		name = isIn(name, "FIRST", "SECOND", "THIRD") ? "INDEX" :
+			boost::algorithm::starts_with(name, "UN") ? "UNTUPLE" : "TUPLE";
+	}
+	for (std::string const var : {"TUPLE", "UNTUPLE", "UNPACKFIRST", "EXPLODE", "INDEX"})
+		if (name == var + "VAR") {
+			arg = std::to_string(popSmallInt(0, static_cast<int>(maxTupleSize)));
+			name = var;
+		}
+
+	if (name == "TUPLE") {
+		push(makeTuple(popValues(intArg(arg))));
+	} else if (isIn(name, "UNTUPLE", "UNPACKFIRST", "EXPLODE")) {
+		int const n = intArg(arg);
+		VmTuple const t = popTuple();
+		int const size = static_cast<int>(t->size());
+		if ((name == "UNTUPLE" && size != n) || (name == "UNPACKFIRST" && size < n) || (name == "EXPLODE" && size > n))
+			throwException(ExitCode::typeCheck);
+		charge(name == "UNPACKFIRST" ? n : size);
+		for (int i = 0; i < (name == "UNPACKFIRST" ? n : size); ++i)
+			push(t->at(i));
+		if (name == "EXPLODE")
+			push(bigint(size));
+	} else if (isIn(name, "INDEX", "INDEX_EXCEP", "INDEX_NOEXCEP")) {
+		push(index(popTuple(), intArg(arg)));
+	} else if (name == "INDEXQ") {
+		VmValue const t = pop();
+		int const i = intArg(arg);
+		if (t.isNull() || !std::holds_alternative<VmTuple>(t.value))
+			push(VmValue{});
+		else {
+			VmTuple const& tuple = std::get<VmTuple>(t.value);
+			push(static_cast<std::size_t>(i) < tuple->size() ? tuple->at(i) : VmValue{});
+		}
+	} else if (isIn(name, "INDEX2", "INDEX3")) {
+		std::vector<int> const indexes = instructionArgs(arg);
+		VmValue value = pop();
+		for (int i : indexes) {
+			if (!std::holds_alternative<VmTuple>(value.value))
+				throwException(ExitCode::typeCheck);
+			value = index(std::get<VmTuple>(value.value), i);
+		}
+		push(value);
+	} else if (isIn(name, "SETINDEX", "SETINDEXQ")) {
+		VmValue x = pop();
+		VmValue const t = pop();
+		setIndex(t, intArg(arg), std::move(x), name == "SETINDEXQ");
+	} else if (isIn(name, "SETINDEXVAR", "SETINDEXVARQ")) {
+		int const i = popSmallInt(0, static_cast<int>(maxTupleSize) - 1);
+		VmValue x = pop();
+		VmValue const t = pop();
+		setIndex(t, i, std::move(x), name == "SETINDEXVARQ");
+	} else if (name == "TLEN") {
+		push(bigint(popTuple()->size()));
+	} else if (name == "QTLEN") {
+		VmValue const t = pop();
+		push(std::holds_alternative<VmTuple>(t.value) ? bigint(std::get<VmTuple>(t.value)->size()) : bigint(-1));
+	} else if (name == "ISTUPLE") {
+		pushBool(std::holds_alternative<VmTuple>(pop().value));
+	} else if (name == "TPUSH") {
+		VmValue x = pop();
+		std::vector<VmValue> values = *popTuple();
+		if (values.size() >= maxTupleSize)
+			throwException(ExitCode::typeCheck);
+		values.push_back(std::move(x));
+		push(makeTuple(std::move(values)));
+	} else if (name == "TPOP") {
+		std::vector<VmValue> values = *popTuple();
+		if (values.empty())
+			throwException(ExitCode::typeCheck);
+		VmValue x = values.back();
+		values.pop_back();
+		push(makeTuple(std::move(values)));
+		push(std::move(x));
+	} else if (name == "LAST") {
+		VmTuple const t = popTuple();
+		if (t->empty())
+			throwException(ExitCode::typeCheck);
+		push(t->back());
+	} else if (isIn(name, "NULL", "PUSHNULL")) {
+		push(VmValue{});
+	} else if (name == "ISNULL") {
+		pushBool(pop().isNull());
+	} else
+		return false;
+	return true;
+}
+
+bool TVMInterpreter::cellInstruction(std::string const& _mnemonic, std::string const& _arg) {
+	auto subslice = [](VmSlice const& s, std::size_t bits, std::size_t refs) {
+		return VmSlice{s.cell, s.bitBegin, s.bitBegin + bits, s.refBegin, s.refBegin + refs};
+	};
+	auto skip = [](VmSlice s, std::size_t bits, std::size_t refs) {
+		s.bitBegin += bits;
+		s.refBegin += refs;
+		return s;
+	};
+	// Maybe ^Cell
+	auto loadMaybeRef = [&](VmSlice& s) -> VmValue {
+		if (loadBits(s, 1) == "0")
+			return VmValue{};
+		return loadRef(s);
+	};
+
+	// Integers and subslices: [P]LD{U,I,SLICE}[X][Q], [P]LD{U,I}LE{4,8}[Q]
+	{
+		std::string rest = _mnemonic;
+		bool const preload = boost::algorithm::starts_with(rest, "PLD");
+		if (preload)
+			rest = rest.substr(1);
+		bool const load = boost::algorithm::starts_with(rest, "LD");
+		bool const quiet = load && rest.size() > 2 && rest.back() == 'Q';
+		if (quiet)
+			rest.pop_back();
+		bool const var = load && rest.size() > 2 && rest.back() == 'X';
+		if (var)
+			rest.pop_back();
+		if (load && isIn(rest, "LDU", "LDI", "LDSLICE", "LDULE4", "LDULE8", "LDILE4", "LDILE8") && !(var && rest.size() > 6 && rest.find("LE") != std::string::npos)) {
+			bool const isSlice = rest == "LDSLICE";
+			bool const isSigned = rest.at(2) == 'I';
+			int bits = 0;
+			if (var)
+				bits = popSmallInt(0, isSlice ? 1023 : isSigned ? 257 : 256);
+			else if (boost::algorithm::ends_with(rest, "LE4"))
+				bits = 32;
+			else if (boost::algorithm::ends_with(rest, "LE8"))
+				bits = 64;
+			else
+				bits = intArg(_arg);
+			VmSlice s = popSlice();
+			if (s.bitSize() < static_cast<std::size_t>(bits)) {
+				if (!quiet)
+					throwException(ExitCode::cellUnderflow);
+				if (!preload)
+					push(s);
+				pushBool(false);
+				return true;
+			}
+			VmSlice const loaded = subslice(s, bits, 0);
+			std::string data = loadBits(s, bits);
+			if (rest.find("LE") != std::string::npos)
+				data = reverseBytes(data);
+			if (isSlice)
+				push(loaded);
+			else
+				push(fromBits(data, isSigned));
+			if (!preload)
+				push(s);
+			if (quiet)
+				pushBool(true);
+			return true;
+		}
+	}
+
+	std::string const& name = _mnemonic;
+	if (name == "NEWC") {
+		push(VmBuilder{});
+	} else if (name == "ENDC") {
+		VmBuilder const b = popBuilder();
+		push(makeCell(b.bits, b.refs));
+	} else if (name == "ENDXC") {
+		bool const exotic = popBool();
+		solUnimplementedAssert(!exotic, "Exotic cells are not supported");
+		VmBuilder const b = popBuilder();
+		push(makeCell(b.bits, b.refs));
+	} else if (isIn(name, "STU", "STI", "STUR", "STIR", "STUX", "STIX", "STUXR", "STIXR", "STULE4", "STULE8", "STILE4", "STILE8")) {
+		bool const isSigned = name.at(2) == 'I';
+		bool const var = name.find('X') != std::string::npos;
+		bool const reversed = name.back() == 'R';
+		int bits = 0;
+		if (var)
+			bits = popSmallInt(0, isSigned ? 257 : 256);
+		else if (boost::algorithm::ends_with(name, "LE4"))
+			bits = 32;
+		else if (boost::algorithm::ends_with(name, "LE8"))
+			bits = 64;
+		else
+			bits = intArg(_arg);
+		VmBuilder b;
+		bigint x;
+		if (reversed) {
+			x = popInt();
+			b = popBuilder();
+		} else {
+			b = popBuilder();
+			x = popInt();
+		}
+		if (isSigned ? !fitsSigned(x, bits) : !fitsUnsigned(x, bits))
+			throwException(ExitCode::rangeCheck);
+		std::string data = toBits(x, bits);
+		if (name.find("LE") != std::string::npos)
+			data = reverseBytes(data);
+		storeBits(b, data);
+		push(b);
+	} else if (isIn(name, "STSLICE", "STSLICER")) {
+		VmBuilder b;
+		VmSlice s;
+		if (name == "STSLICER") {
+			s = popSlice();
+			b = popBuilder();
+		} else {
+			b = popBuilder();
+			s = popSlice();
+		}
+		if (b.refs.size() + s.refSize() > maxCellRefs)
+			throwException(ExitCode::cellOverflow);
+		storeBits(b, s.bits());
+		for (std::size_t i = s.refBegin; i < s.refEnd; ++i)
+			storeRef(b, s.cell->refs.at(i));
+		push(b);
+	} else if (isIn(name, "STSLICECONST", "STZERO", "STONE")) {
+		VmBuilder b = popBuilder();
+		storeBits(b, name == "STZERO" ? "0" : name == "STONE" ? "1" : literalBits(_arg));
+		push(b);
+	} else if (isIn(name, "STREF", "STREFR")) {
+		VmBuilder b;
+		VmCellPtr c;
+		if (name == "STREFR") {
+			c = popCell();
+			b = popBuilder();
+		} else {
+			b = popBuilder();
+			c = popCell();
+		}
+		storeRef(b, c);
+		push(b);
+	} else if (isIn(name, "STBREF", "STBREFR", "ENDCST", "STB", "STBR")) {
+		VmBuilder b;
+		VmBuilder other;
+		if (isIn(name, "STBREFR", "ENDCST", "STBR")) {
+			other = popBuilder();
+			b = popBuilder();
+		} else {
+			b = popBuilder();
+			other = popBuilder();
+		}
+		if (isIn(name, "STB", "STBR")) {
+			if (b.refs.size() + other.refs.size() > maxCellRefs)
+				throwException(ExitCode::cellOverflow);
+			storeBits(b, other.bits);
+			for (VmCellPtr const& ref : other.refs)
+				storeRef(b, ref);
+		} else
+			storeRef(b, makeCell(other.bits, other.refs));
+		push(b);
+	} else if (name == "STDICT") {
+		VmBuilder b = popBuilder();
+		VmCellPtr const dict = popMaybeCell();
+		storeBits(b, dict ? "1" : "0");
+		if (dict)
+			storeRef(b, dict);
+		push(b);
+	} else if (isIn(name, "STZEROES", "STONES", "STSAME")) {
+		char bit = name == "STONES" ? '1' : '0';
+		if (name == "STSAME")
+			bit = popSmallInt(0, 1) == 1 ? '1' : '0';
+		int const n = popSmallInt(0, 1023);
+		VmBuilder b = popBuilder();
+		storeBits(b, std::string(n, bit));
+		push(b);
+	} else if (isIn(name, "STGRAMS", "STVARUINT16", "STVARUINT32", "STVARINT16", "STVARINT32")) {
+		bool const isSigned = name.find("VARINT") != std::string::npos;
+		int const lengthBits = boost::algorithm::ends_with(name, "32") ? 5 : 4;
+		bigint const x = popInt();
+		VmBuilder b = popBuilder();
+		int bytes = 0;
+		while (isSigned ? !fitsSigned(x, 8 * bytes) : !fitsUnsigned(x, 8 * bytes))
+			++bytes;
+		if (bytes >= (1 << lengthBits))
+			throwException(ExitCode::rangeCheck);
+		storeBits(b, toBits(bytes, lengthBits) + toBits(x, 8 * bytes));
+		push(b);
+	} else if (isIn(name, "LDGRAMS", "LDVARUINT16", "LDVARUINT32", "LDVARINT16", "LDVARINT32")) {
+		bool const isSigned = name.find("VARINT") != std::string::npos;
+		int const lengthBits = boost::algorithm::ends_with(name, "32") ? 5 : 4;
+		VmSlice s = popSlice();
+		int const bytes = static_cast<int>(fromBits(loadBits(s, lengthBits), false));
+		push(fromBits(loadBits(s, 8 * bytes), isSigned));
+		push(s);
+	} else if (isIn(name, "BBITS", "BREFS", "BBITREFS", "BREMBITS", "BREMREFS", "BREMBITREFS")) {
+		VmBuilder const b = popBuilder();
+		bool const remaining = boost::algorithm::starts_with(name, "BREM");
+		if (name.find("BITS") != std::string::npos)
+			push(bigint(remaining ? maxCellBits - b.bits.size() : b.bits.size()));
+		if (name.find("REFS") != std::string::npos)
+			push(bigint(remaining ? maxCellRefs - b.refs.size() : b.refs.size()));
+	} else if (name == "CTOS") {
+		push(toSlice(popCell()));
+	} else if (name == "XCTOS") {
+		push(toSlice(popCell()));
+		pushBool(false);
+	} else if (name == "XLOAD") {
+		push(popCell());
+	} else if (name == "XLOADQ") {
+		push(popCell());
+		pushBool(true);
+	} else if (name == "ENDS") {
+		VmSlice const s = popSlice();
+		if (s.bitSize() != 0 || s.refSize() != 0)
+			throwException(ExitCode::cellUnderflow);
+	} else if (isIn(name, "LDREF", "PLDREF", "LDREFRTOS")) {
+		VmSlice s = popSlice();
+		VmCellPtr const c = loadRef(s);
+		if (name == "LDREF") {
+			push(c);
+			push(s);
+		} else if (name == "PLDREF")
+			push(c);
+		else {
+			push(s);
+			push(toSlice(c));
+		}
+	} else if (isIn(name, "PLDREFIDX", "PLDREFVAR")) {
+		int const i = name == "PLDREFVAR" ? popSmallInt(0, 3) : intArg(_arg);
+		VmSlice const s = popSlice();
+		if (s.refSize() <= static_cast<std::size_t>(i))
+			throwException(ExitCode::cellUnderflow);
+		push(s.cell->refs.at(s.refBegin + i));
+	} else if (isIn(name, "LDDICT", "PLDDICT", "LDDICTQ")) {
+		VmSlice s = popSlice();
+		if (name == "LDDICTQ" && (s.bitSize() == 0 || (s.bits().at(0) == '1' && s.refSize() == 0))) {
+			push(s);
+			pushBool(false);
+			return true;
+		}
+		push(loadMaybeRef(s));
+		if (name != "PLDDICT")
+			push(s);
+		if (name == "LDDICTQ")
+			pushBool(true);
+	} else if (name == "PLDUZ") {
+		int const bits = intArg(_arg);
+		VmSlice const s = popSlice();
+		std::string data = s.bits().substr(0, bits);
+		data.resize(bits, '0');
+		push(s);
+		push(fromBits(data, false));
+	} else if (isIn(name, "LDZEROES", "LDONES", "LDSAME")) {
+		char bit = name == "LDONES" ? '1' : '0';
+		if (name == "LDSAME")
+			bit = popSmallInt(0, 1) == 1 ? '1' : '0';
+		VmSlice s = popSlice();
+		std::string const data = s.bits();
+		std::size_t n = 0;
+		while (n < data.size() && data.at(n) == bit)
+			++n;
+		push(bigint(n));
+		push(skip(s, n, 0));
+	} else if (isIn(name, "SDSKIPFIRST", "SDCUTFIRST", "SDSKIPLAST", "SDCUTLAST")) {
+		int const bits = popSmallInt(0, 1023);
+		VmSlice s = popSlice();
+		if (s.bitSize() < static_cast<std::size_t>(bits))
+			throwException(ExitCode::cellUnderflow);
+		if (name == "SDSKIPFIRST")
+			s.bitBegin += bits;
+		else if (name == "SDCUTFIRST")
+			s.bitEnd = s.bitBegin + bits;
+		else if (name == "SDSKIPLAST")
+			s.bitEnd -= bits;
+		else
+			s.bitBegin = s.bitEnd - bits;
+		push(s);
+	} else if (isIn(name, "SSKIPFIRST", "SCUTFIRST", "SPLIT", "SPLITQ")) {
+		int const refs = popSmallInt(0, 4);
+		int const bits = popSmallInt(0, 1023);
+		VmSlice const s = popSlice();
+		if (s.bitSize() < static_cast<std::size_t>(bits) || s.refSize() < static_cast<std::size_t>(refs)) {
+			if (name != "SPLITQ")
+				throwException(ExitCode::cellUnderflow);
+			push(s);
+			pushBool(false);
+			return true;
+		}
+		if (name == "SSKIPFIRST")
+			push(skip(s, bits, refs));
+		else if (name == "SCUTFIRST")
+			push(subslice(s, bits, refs));
+		else {
+			push(subslice(s, bits, refs));
+			push(skip(s, bits, refs));
+			if (name == "SPLITQ")
+				pushBool(true);
+		}
+	} else if (isIn(name, "SBITS", "SREFS", "SBITREFS")) {
+		VmSlice const s = popSlice();
+		if (name != "SREFS")
+			push(bigint(s.bitSize()));
+		if (name != "SBITS")
+			push(bigint(s.refSize()));
+	} else if (isIn(name, "SEMPTY", "SDEMPTY", "SREMPTY", "SDFIRST")) {
+		VmSlice const s = popSlice();
+		if (name == "SEMPTY")
+			pushBool(s.bitSize() == 0 && s.refSize() == 0);
+		else if (name == "SDEMPTY")
+			pushBool(s.bitSize() == 0);
+		else if (name == "SREMPTY")
+			pushBool(s.refSize() == 0);
+		else
+			pushBool(s.bitSize() > 0 && s.bits().at(0) == '1');
+	} else if (isIn(name, "SCHKBITSQ", "SCHKREFSQ", "SCHKBITREFSQ")) {
+		int const refs = name == "SCHKBITSQ" ? 0 : popSmallInt(0, 4);
+		int const bits = name == "SCHKREFSQ" ? 0 : popSmallInt(0, 1023);
+		VmSlice const s = popSlice();
+		pushBool(s.bitSize() >= static_cast<std::size_t>(bits) && s.refSize() >= static_cast<std::size_t>(refs));
+	} else if (isIn(name, "SDEQ", "SDLEXCMP", "SDPFX", "SDPFXREV")) {
+		std::string const b = popSlice().bits();
+		std::string const a = popSlice().bits();
+		if (name == "SDEQ")
+			pushBool(a == b);
+		else if (name == "SDLEXCMP")
+			push(bigint(a < b ? -1 : a > b ? 1 : 0));
+		else if (name == "SDPFX")
+			pushBool(boost::algorithm::starts_with(b, a));
+		else
+			pushBool(boost::algorithm::starts_with(a, b));
+	} else if (isIn(name, "SDBEGINSX", "SDBEGINSXQ", "SDBEGINS", "SDBEGINSQ")) {
+		bool const quiet = name.back() == 'Q';
+		std::string const prefix = boost::algorithm::starts_with(name, "SDBEGINSX") ? popSlice().bits() : literalBits(_arg);
+		VmSlice const s = popSlice();
+		bool const begins = boost::algorithm::starts_with(s.bits(), prefix);
+		if (!begins && !quiet)
+			throwException(ExitCode::cellUnderflow);
+		push(begins ? skip(s, prefix.size(), 0) : s);
+		if (quiet)
+			pushBool(begins);
+	} else if (name == "PUSHSLICE") {
+		push(toSlice(makeCell(literalBits(_arg))));
+	} else if (isIn(name, "CDEPTH", "SDEPTH", "BDEPTH")) {
+		int depth = 0;
+		if (name == "CDEPTH") {
+			VmCellPtr const c = popMaybeCell();
+			depth = c ? c->depth() : 0;
+		} else {
+			std::vector<VmCellPtr> refs;
+			if (name == "SDEPTH") {
+				VmSlice const s = popSlice();
+				refs.assign(s.cell->refs.begin() + s.refBegin, s.cell->refs.begin() + s.refEnd);
+			} else
+				refs = popBuilder().refs;
+			for (VmCellPtr const& ref : refs)
+				depth = std::max(depth, ref->depth() + 1);
+		}
+		push(bigint(depth));
+	} else if (isIn(name, "HASHCU", "HASHSU", "SHA256U")) {
+		if (name == "HASHCU")
+			push(popCell()->hash());
+		else {
+			VmSlice const s = popSlice();
+			if (name == "HASHSU")
+				push(makeCell(s.bits(), {s.cell->refs.begin() + s.refBegin, s.cell->refs.begin() + s.refEnd})->hash());
+			else {
+				std::string const data = s.bits();
+				if (data.size() % 8 != 0)
+					throwException(ExitCode::cellUnderflow);
+				std::vector<uint8_t> bytes;
+				for (std::size_t i = 0; i < data.size(); i += 8)
+					bytes.push_back(static_cast<uint8_t>(fromBits(data.substr(i, 8), false)));
+				std::vector<uint8_t> digest(32);
+				picosha2::hash256(bytes.begin(), bytes.end(), digest.begin(), digest.end());
+				bigint value = 0;
+				for (uint8_t byte : digest)
+					value = value * 256 + byte;
+				push(value);
+			}
+		}
+	} else if (isIn(name, "CDATASIZE", "CDATASIZEQ", "SDATASIZE", "SDATASIZEQ")) {
+		bool const quiet = name.back() == 'Q';
+		bigint const limit = popInt();
+		if (limit < 0)
+			throwException(ExitCode::rangeCheck);
+		std::vector<VmCellPtr> roots;
+		bigint bits = 0;
+		bigint refs = 0;
+		bigint cells = 0;
+		if (boost::algorithm::starts_with(name, "C")) {
+			if (VmCellPtr const c = popMaybeCell())
+				roots.push_back(c);
+		} else {
+			VmSlice const s = popSlice();
+			bits = s.bitSize();
+			refs = s.refSize();
+			roots.assign(s.cell->refs.begin() + s.refBegin, s.cell->refs.begin() + s.refEnd);
+		}
+		std::set<bigint> visited;
+		std::vector<VmCellPtr> queue = roots;
+		while (!queue.empty()) {
+			VmCellPtr const c = queue.back();
+			queue.pop_back();
+			if (!visited.insert(c->hash()).second)
+				continue;
+			++cells;
+			bits += c->bits.size();
+			refs += c->refs.size();
+			queue.insert(queue.end(), c->refs.begin(), c->refs.end());
+		}
+		if (cells > limit) {
+			if (!quiet)
+				throwException(ExitCode::cellOverflow);
+			pushBool(false);
+			return true;
+		}
+		push(cells);
+		push(bits);
+		push(refs);
+		if (quiet)
+			pushBool(true);
+	} else if (isIn(name, "LDMSGADDR", "LDMSGADDRQ", "PARSEMSGADDR", "REWRITESTDADDR")) {
+		VmSlice const s = popSlice();
+		std::string const data = s.bits();
+		// MsgAddress: addr_none$00, addr_extern$01, addr_std$10, addr_var$11
+		std::size_t pos = 2;
+		auto read = [&](std::size_t _bits) -> std::optional<std::string> {
+			if (pos + _bits > data.size())
+				return std::nullopt;
+			pos += _bits;
+			return data.substr(pos - _bits, _bits);
+		};
+		std::optional<std::string> tag = read(0);
+		VmValue anycast;
+		std::optional<std::string> workchain;
+		std::optional<std::string> address;
+		if (data.size() < 2)
+			tag.reset();
+		else {
+			tag = data.substr(0, 2);
+			if (*tag == "01") {
+				std::optional<std::string> const length = read(9);
+				address = length ? read(static_cast<std::size_t>(fromBits(*length, false))) : std::nullopt;
+				if (!address)
+					tag.reset();
+			} else if (*tag == "10" || *tag == "11") {
+				std::optional<std::string> const hasAnycast = read(1);
+				if (hasAnycast == std::string{"1"}) {
+					std::optional<std::string> const depth = read(5);
+					std::optional<std::string> const prefix = depth ? read(static_cast<std::size_t>(fromBits(*depth, false))) : std::nullopt;
+					if (prefix)
+						anycast = toSlice(makeCell(*prefix));
+					else
+						tag.reset();
+				}
+				if (tag && *tag == "10") {
+					workchain = read(8);
+					address = read(256);
+				} else if (tag) {
+					std::optional<std::string> const length = read(9);
+					workchain = read(32);
+					address = length ? read(static_cast<std::size_t>(fromBits(*length, false))) : std::nullopt;
+				}
+				if (!hasAnycast || !workchain || !address)
+					tag.reset();
+			}
+		}
+		if (!tag) {
+			if (name != "LDMSGADDRQ")
+				throwException(ExitCode::cellUnderflow);
+			push(s);
+			pushBool(false);
+			return true;
+		}
+		if (isIn(name, "LDMSGADDR", "LDMSGADDRQ")) {
+			push(subslice(s, pos, 0));
+			push(skip(s, pos, 0));
+			if (name == "LDMSGADDRQ")
+				pushBool(true);
+		} else if (name == "PARSEMSGADDR") {
+			std::vector<VmValue> fields{bigint(fromBits(*tag, false))};
+			if (*tag == "01")
+				fields.push_back(toSlice(makeCell(*address)));
+			else if (*tag != "00") {
+				fields.push_back(anycast);
+				fields.push_back(fromBits(*workchain, true));
+				fields.push_back(toSlice(makeCell(*address)));
+			}
+			push(VmValue{std::make_shared<std::vector<VmValue> const>(std::move(fields))});
+		} else {
+			if (!isIn(*tag, "10", "11") || address->size() != 256)
+				throwException(ExitCode::cellUnderflow);
+			std::string rewritten = *address;
+			if (!anycast.isNull()) {
+				std::string const prefix = std::get<VmSlice>(anycast.value).bits();
+				rewritten.replace(0, prefix.size(), prefix);
+			}
+			push(fromBits(*workchain, true));
+			push(fromBits(rewritten, false));
+		}
+	} else
+		return false;
+	return true;
+}
+
+bool TVMInterpreter::dictInstruction(std::string const& _mnemonic) {
+	if (!boost::algorithm::starts_with(_mnemonic, "DICT") || isIn(_mnemonic, "DICTPUSHCONST"))
+		return false;
+	if (_mnemonic == "DICTEMPTY") {
+		pushBool(pop().isNull());
+		return true;
+	}
+
+	std::string rest = _mnemonic.substr(4);
+	char keyType = ' ';
+	if (!rest.empty() && (rest.at(0) == 'I' || rest.at(0) == 'U')) {
+		keyType = rest.at(0);
+		rest = rest.substr(1);
+	}
+	static std::vector<std::string> const operations{
+		"REMMIN", "REMMAX", "SETGET", "ADDGET", "REPLACEGET", "DELGET", "REPLACE", "SET", "ADD", "DEL",
+		"GETNEXTEQ", "GETNEXT", "GETPREVEQ", "GETPREV", "GET", "MIN", "MAX"
+	};
+	std::string operation;
+	for (std::string const& op : operations)
+		if (boost::algorithm::starts_with(rest, op)) {
+			operation = op;
+			break;
+		}
+	std::string const suffix = rest.substr(operation.size());
+	if (operation.empty() || !isIn(suffix, "", "REF", "B"))
+		return false;
+	bool const isSigned = keyType == 'I';
+
+	int const n = popSmallInt(0, 1023);
+	VmCellPtr const root = popMaybeCell();
+	std::map<std::string, VmSlice> dict;
+	if (root)
+		parseDict(toSlice(root), static_cast<std::size_t>(n), "", dict);
+
+	auto keyValue = [&](std::string const& _bits) -> bigint { return fromBits(_bits, isSigned); };
+	auto pushKey = [&](std::string const& _bits) {
+		if (keyType == ' ')
+			push(toSlice(makeCell(_bits)));
+		else
+			push(keyValue(_bits));
+	};
+	auto pushValue = [&](VmSlice const& _value) {
+		if (suffix == "REF") {
+			if (_value.bitSize() != 0 || _value.refSize() != 1)
+				throwException(ExitCode::dictError);
+			push(_value.cell->refs.at(_value.refBegin));
+		} else
+			push(_value);
+	};
+	auto pushDict = [&]() {
+		push(dict.empty() ? VmValue{} : VmValue{buildDict(dict.begin(), dict.end(), 0, static_cast<std::size_t>(n))});
+	};
+
+	if (isIn(operation, "MIN", "MAX", "REMMIN", "REMMAX")) {
+		auto it = dict.end();
+		for (auto i = dict.begin(); i != dict.end(); ++i)
+			if (it == dict.end() || (boost::algorithm::ends_with(operation, "MIN") ? keyValue(i->first) < keyValue(it->first) : keyValue(i->first) > keyValue(it->first)))
+				it = i;
+		if (it == dict.end()) {
+			if (boost::algorithm::starts_with(operation, "REM"))
+				push(root ? VmValue{root} : VmValue{});
+			pushBool(false);
+			return true;
+		}
+		std::string const key = it->first;
+		VmSlice const value = it->second;
+		if (boost::algorithm::starts_with(operation, "REM")) {
+			dict.erase(it);
+			pushDict();
+		}
+		pushValue(value);
+		pushKey(key);
+		pushBool(true);
+		return true;
+	}
+
+	// The key: an integer, which may not fit into n bits, or the first n bits of a slice.
+	std::optional<std::string> key;
+	std::optional<bigint> intKey;
+	if (keyType == ' ') {
+		VmSlice const s = popSlice();
+		if (s.bitSize() < static_cast<std::size_t>(n))
+			throwException(ExitCode::cellUnderflow);
+		key = s.bits().substr(0, n);
+	} else {
+		intKey = popInt();
+		if (isSigned ? fitsSigned(*intKey, n) : fitsUnsigned(*intKey, n))
+			key = toBits(*intKey, n);
+	}
+
+	if (boost::algorithm::starts_with(operation, "GET") && operation != "GET") {
+		bigint const k = key ? keyValue(*key) : *intKey;
+		bool const next = operation.find("NEXT") != std::string::npos;
+		bool const orEqual = boost::algorithm::ends_with(operation, "EQ");
+		auto found = dict.end();
+		for (auto i = dict.begin(); i != dict.end(); ++i) {
+			bigint const v = keyValue(i->first);
+			bool const fits = next ? (v > k || (orEqual && v == k)) : (v < k || (orEqual && v == k));
+			if (fits && (found == dict.end() || (next ? v < keyValue(found->first) : v > keyValue(found->first))))
+				found = i;
+		}
+		if (found == dict.end()) {
+			pushBool(false);
+			return true;
+		}
+		pushValue(found->second);
+		pushKey(found->first);
+		pushBool(true);
+		return true;
+	}
+
+	if (isIn(operation, "GET", "DEL", "DELGET")) {
+		auto it = key ? dict.find(*key) : dict.end();
+		if (operation == "GET") {
+			if (it == dict.end()) {
+				pushBool(false);
+				return true;
+			}
+			pushValue(it->second);
+			pushBool(true);
+			return true;
+		}
+		if (it == dict.end()) {
+			push(root ? VmValue{root} : VmValue{});
+			pushBool(false);
+			return true;
+		}
+		VmSlice const value = it->second;
+		dict.erase(it);
+		pushDict();
+		if (operation == "DELGET")
+			pushValue(value);
+		pushBool(true);
+		return true;
+	}
+
+	// SET, ADD, REPLACE and their GET variants
+	if (!key)
+		throwException(ExitCode::rangeCheck);
+	VmSlice newValue;
+	if (suffix == "REF")
+		newValue = toSlice(makeCell("", {popCell()}));
+	else if (suffix == "B") {
+		VmBuilder const b = popBuilder();
+		newValue = toSlice(makeCell(b.bits, b.refs));
+	} else
+		newValue = popSlice();
+	auto const it = dict.find(*key);
+	std::optional<VmSlice> oldValue;
+	if (it != dict.end())
+		oldValue = it->second;
+	bool const change = (!boost::algorithm::starts_with(operation, "ADD") || !oldValue) && (!boost::algorithm::starts_with(operation, "REPLACE") || oldValue);
+	if (change)
+		dict[*key] = newValue;
+	if (change)
+		pushDict();
+	else
+		push(root ? VmValue{root} : VmValue{});
+	if (operation == "SET")
+		return true;
+	if (boost::algorithm::ends_with(operation, "GET") && oldValue) {
+		if (suffix == "REF")
+			pushValue(*oldValue);
+		else
+			push(*oldValue);
+	}
+	// ADD and ADDGET report whether the key was added, the others whether it was there before.
+	pushBool(boost::algorithm::starts_with(operation, "ADD") ? change : oldValue.has_value());
+	return true;
+}
+
+void TVMInterpreter::parseDict(VmSlice _slice, std::size_t _bits, std::string const& _prefix, std::map<std::string, VmSlice>& _dict) {
+	// HmLabel: hml_short$0 len:(Unary ~n) s:(n * Bit), hml_long$10 n:(#<= m) s:(n * Bit),
+	// hml_same$11 v:Bit n:(#<= m)
+	try {
+		std::string label;
+		if (loadBits(_slice, 1) == "0") {
+			std::size_t length = 0;
+			while (loadBits(_slice, 1) == "1")
+				++length;
+			label = loadBits(_slice, length);
+		} else if (loadBits(_slice, 1) == "0") {
+			std::size_t const length = static_cast<std::size_t>(fromBits(loadBits(_slice, bitsFor(_bits)), false));
+			label = loadBits(_slice, length);
+		} else {
+			char const bit = loadBits(_slice, 1).at(0);
+			std::size_t const length = static_cast<std::size_t>(fromBits(loadBits(_slice, bitsFor(_bits)), false));
+			label = std::string(length, bit);
+		}
+		if (label.size() > _bits)
+			throwException(ExitCode::dictError);
+		std::string const key = _prefix + label;
+		std::size_t const rest = _bits - label.size();
+		if (rest == 0) {
+			_dict[key] = _slice;
+			return;
+		}
+		VmCellPtr const left = loadRef(_slice);
+		VmCellPtr const right = loadRef(_slice);
+		parseDict(toSlice(left), rest - 1, key + "0", _dict);
+		parseDict(toSlice(right), rest - 1, key + "1", _dict);
+	} catch (VmException const&) {
+		throwException(ExitCode::dictError, bigint(0), true);
+	}
+}
+
+VmCellPtr TVMInterpreter::buildDict(
+	std::map<std::string, VmSlice>::const_iterator _begin,
+	std::map<std::string, VmSlice>::const_iterator _end,
+	std::size_t _offset,
+	std::size_t _bits
+) {
+	// The keys are sorted, so the common prefix of all of them is the one of the first and the last key.
+	std::string const& first = _begin->first;
+	std::string const& last = std::prev(_end)->first;
+	std::size_t length = 0;
+	while (length < _bits && first.at(_offset + length) == last.at(_offset + length))
+		++length;
+	std::string const label = first.substr(_offset, length);
+
+	// The shortest label encoding, as TVM chooses it.
+	int const k = bitsFor(_bits);
+	std::string bits;
+	bool const same = label.find_first_not_of(label.empty() ? '0' : label.at(0)) == std::string::npos;
+	if (label.empty())
+		bits = "00";
+	else if (label.size() > 1 && same && k < 2 * static_cast<int>(label.size()) - 1)
+		bits = std::string{"11"} + label.at(0) + toBits(label.size(), k);
+	else if (k < static_cast<int>(label.size()))
+		bits = "10" + toBits(label.size(), k) + label;
+	else
+		bits = "0" + std::string(label.size(), '1') + "0" + label;
+
+	VmBuilder b;
+	storeBits(b, bits);
+	if (length == _bits) {
+		VmSlice const& value = _begin->second;
+		storeBits(b, value.bits());
+		for (std::size_t i = value.refBegin; i < value.refEnd; ++i)
+			storeRef(b, value.cell->refs.at(i));
+	} else {
+		std::size_t const fork = _offset + length;
+		auto const middle = std::find_if(_begin, _end, [&](auto const& item) { return item.first.at(fork) == '1'; });
+		storeRef(b, buildDict(_begin, middle, fork + 1, _bits - length - 1));
+		storeRef(b, buildDict(middle, _end, fork + 1, _bits - length - 1));
+	}
+	return makeCell(b.bits, b.refs);
+}
+
+bool TVMInterpreter::environmentInstruction(std::string const& _mnemonic, std::string const& _arg) {
+	static std::map<std::string, int> const params{
+		{"NOW", 3}, {"BLOCKLT", 4}, {"LTIME", 5}, {"RANDSEED", 6}, {"BALANCE", 7}, {"MYADDR", 8},
+		{"CONFIGROOT", 9}, {"MYCODE", 10},
+	};
+	if (_mnemonic == "GETPARAM" || params.count(_mnemonic)) {
+		int const index = _mnemonic == "GETPARAM" ? intArg(_arg) : params.at(_mnemonic);
+		VmValue const info = global(0);
+		if (!std::holds_alternative<VmTuple>(info.value))
+			throwException(ExitCode::typeCheck);
+		VmTuple const& tuple = std::get<VmTuple>(info.value);
+		if (static_cast<std::size_t>(index) >= tuple->size())
+			throwException(ExitCode::rangeCheck);
+		push(tuple->at(index));
+	} else if (isIn(_mnemonic, "GETGLOB", "GETGLOBVAR")) {
+		push(global(_mnemonic == "GETGLOB" ? intArg(_arg) : popSmallInt(0, 254)));
+	} else if (isIn(_mnemonic, "SETGLOB", "SETGLOBVAR")) {
+		int const index = _mnemonic == "SETGLOB" ? intArg(_arg) : popSmallInt(0, 254);
+		setGlobal(index, pop());
+	} else if (isIn(_mnemonic, "THROW", "THROWIF", "THROWIFNOT", "THROWARG", "THROWARGIF", "THROWARGIFNOT",
+		"THROWANY", "THROWANYIF", "THROWANYIFNOT", "THROWARGANY", "THROWARGANYIF", "THROWARGANYIFNOT")) {
+		bool const conditional = _mnemonic.find("IF") != std::string::npos;
+		bool const any = _mnemonic.find("ANY") != std::string::npos;
+		bool const withArg = _mnemonic.find("ARG") != std::string::npos;
+		bool flag = true;
+		if (conditional)
+			flag = popBool() != boost::algorithm::ends_with(_mnemonic, "NOT");
+		int const code = any ? popSmallInt(0, 0xFFFF) : intArg(_arg);
+		VmValue arg = bigint(0);
+		if (withArg)
+			arg = pop();
+		if (flag)
+			throwException(code, arg, !conditional);
+	} else if (isIn(_mnemonic, "ACCEPT", "SETGASLIMIT", "BUYGAS", "PRINTSTR", "DUMPSTK")) {
+		if (isIn(_mnemonic, "SETGASLIMIT", "BUYGAS"))
+			popInt();
+	} else if (isIn(_mnemonic, "STRDUMP", "HEXDUMP", "BINDUMP", "DUMP")) {
+		at(0);
+	} else if (_mnemonic == "COMMIT") {
+		m_committedC4 = m_c4;
+		m_committedActions = m_actions;
+	} else if (_mnemonic == "GASREMAINING") {
+		push(bigint(m_gasLimit - m_gas));
+	} else if (isIn(_mnemonic, "CONFIGPARAM", "CONFIGOPTPARAM")) {
+		popInt();
+		// The interpreter has no configuration.
+		if (_mnemonic == "CONFIGPARAM")
+			pushBool(false);
+		else
+			push(VmValue{});
+	} else if (isIn(_mnemonic, "SENDRAWMSG", "RAWRESERVE", "RAWRESERVEX", "SETCODE", "SETLIBCODE", "CHANGELIB")) {
+		static std::map<std::string, int> const take{
+			{"SENDRAWMSG", 2}, {"RAWRESERVE", 2}, {"RAWRESERVEX", 3}, {"SETCODE", 1}, {"SETLIBCODE", 2}, {"CHANGELIB", 2}
+		};
+		VmAction action{_mnemonic, {}};
+		action.arguments.resize(take.at(_mnemonic));
+		for (int i = take.at(_mnemonic) - 1; i >= 0; --i)
+			action.arguments[i] = pop();
+		m_actions.push_back(std::move(action));
+	} else
+		return false;
+	return true;
+}
+
+VmValue TVMInterpreter::global(int _index) {
+	if (!std::holds_alternative<VmTuple>(m_c7.value))
+		throwException(ExitCode::typeCheck);
+	VmTuple const& c7 = std::get<VmTuple>(m_c7.value);
+	return static_cast<std::size_t>(_index) < c7->size() ? c7->at(_index) : VmValue{};
+}
+
+void TVMInterpreter::setGlobal(int _index, VmValue _value) {
+	if (!std::holds_alternative<VmTuple>(m_c7.value))
+		throwException(ExitCode::typeCheck);
+	std::vector<VmValue> c7 = *std::get<VmTuple>(m_c7.value);
+	if (static_cast<std::size_t>(_index) >= c7.size()) {
+		if (_value.isNull())
+			return;
+		c7.resize(_index + 1);
+	}
+	c7[_index] = std::move(_value);
+	m_c7 = VmValue{std::make_shared<std::vector<VmValue> const>(std::move(c7))};
+}
+
+void TVMInterpreter::charge(int64_t _gas) {
+	m_gas += _gas;
+	if (m_gas > m_gasLimit)
+		throw OutOfGas{};
+}
+
+void TVMInterpreter::charge(std::string const& _instructions) {
+	std::istringstream lines{_instructions};
+	for (std::string line; std::getline(lines, line);)
+		charge(TVMCodeMetrics::instructionGas(line));
+}
+
+void TVMInterpreter::chargePrinted(TvmAstNode const& _node) {
+	auto it = m_printedGas.find(&_node);
+	if (it == m_printedGas.end()) {
+		std::ostringstream out;
+		Printer printer{out};
+		const_cast<TvmAstNode&>(_node).accept(printer);
+		int gas = 0;
+		std::istringstream lines{out.str()};
+		for (std::string line; std::getline(lines, line);)
+			gas += TVMCodeMetrics::instructionGas(line);
+		it = m_printedGas.emplace(&_node, gas).first;
+	}
+	charge(it->second);
+}
+
+void TVMInterpreter::throwException(int _code, VmValue _arg, bool _charged) {
+	if (!_charged)
+		charge(TvmGas::exception);
+	throw VmException{_code, std::move(_arg)};
+}
+
+VmValue& TVMInterpreter::at(int _i) {
+	solAssert(_i >= 0, "");
+	if (static_cast<std::size_t>(_i) >= m_stack.size())
+		throwException(ExitCode::stackUnderflow);
+	return m_stack.at(m_stack.size() - 1 - _i);
+}
+
+void TVMInterpreter::push(VmValue _value) {
+	m_stack.push_back(std::move(_value));
+}
+
+VmValue TVMInterpreter::pop() {
+	if (m_stack.empty())
+		throwException(ExitCode::stackUnderflow);
+	VmValue value = std::move(m_stack.back());
+	m_stack.pop_back();
+	return value;
+}
+
+void TVMInterpreter::pushInt(bigint _value, bool _quiet) {
+	if (!fitsSigned(_value, 257)) {
+		if (!_quiet)
+			throwException(ExitCode::intOverflow);
+		push(VmNaN{});
+		return;
+	}
+	push(std::move(_value));
+}
+
+void TVMInterpreter::xchg(int _i, int _j) {
+	std::swap(at(_i), at(_j));
+}
+
+void TVMInterpreter::blkSwap(int _down, int _top) {
+	if (m_stack.size() < static_cast<std::size_t>(_down + _top))
+		throwException(ExitCode::stackUnderflow);
+	std::rotate(m_stack.end() - _down - _top, m_stack.end() - _top, m_stack.end());
+}
+
+void TVMInterpreter::reverse(int _count, int _index) {
+	if (m_stack.size() < static_cast<std::size_t>(_count + _index))
+		throwException(ExitCode::stackUnderflow);
+	std::reverse(m_stack.end() - _index - _count, m_stack.end() - _index);
+}
+
+void TVMInterpreter::drop(int _count) {
+	if (m_stack.size() < static_cast<std::size_t>(_count))
+		throwException(ExitCode::stackUnderflow);
+	m_stack.resize(m_stack.size() - _count);
+}
+
+bigint TVMInterpreter::popInt() {
+	std::optional<bigint> value = popIntOrNaN();
+	if (!value)
+		throwException(ExitCode::intOverflow);
+	return std::move(*value);
+}
+
+std::optional<bigint> TVMInterpreter::popIntOrNaN() {
+	VmValue value = pop();
+	if (std::holds_alternative<VmNaN>(value.value))
+		return std::nullopt;
+	if (!std::holds_alternative<bigint>(value.value))
+		throwException(ExitCode::typeCheck);
+	return std::get<bigint>(std::move(value.value));
+}
+
+int TVMInterpreter::popSmallInt(int _min, int _max) {
+	bigint const value = popInt();
+	if (value < _min || value > _max)
+		throwException(ExitCode::rangeCheck);
+	return static_cast<int>(value);
+}
+
+bool TVMInterpreter::popBool() {
+	return popInt() != 0;
+}
+
+VmCellPtr TVMInterpreter::popCell() {
+	VmValue value = pop();
+	if (!std::holds_alternative<VmCellPtr>(value.value))
+		throwException(ExitCode::typeCheck);
+	return std::get<VmCellPtr>(value.value);
+}
+
+VmCellPtr TVMInterpreter::popMaybeCell() {
+	VmValue value = pop();
+	if (value.isNull())
+		return nullptr;
+	if (!std::holds_alternative<VmCellPtr>(value.value))
+		throwException(ExitCode::typeCheck);
+	return std::get<VmCellPtr>(value.value);
+}
+
+VmSlice TVMInterpreter::popSlice() {
+	VmValue value = pop();
+	if (!std::holds_alternative<VmSlice>(value.value))
+		throwException(ExitCode::typeCheck);
+	return std::get<VmSlice>(value.value);
+}
+
+VmBuilder TVMInterpreter::popBuilder() {
+	VmValue value = pop();
+	if (!std::holds_alternative<VmBuilder>(value.value))
+		throwException(ExitCode::typeCheck);
+	return std::get<VmBuilder>(std::move(value.value));
+}
+
+VmTuple TVMInterpreter::popTuple() {
+	VmValue value = pop();
+	if (!std::holds_alternative<VmTuple>(value.value))
+		throwException(ExitCode::typeCheck);
+	return std::get<VmTuple>(value.value);
+}
+
+VmContinuation TVMInterpreter::popCont() {
+	VmValue value = pop();
+	if (!std::holds_alternative<VmContinuation>(value.value))
+		throwException(ExitCode::typeCheck);
+	return std::get<VmContinuation>(value.value);
+}
+
+std::string TVMInterpreter::loadBits(VmSlice& _slice, std::size_t _bits) {
+	if (_slice.bitSize() < _bits)
+		throwException(ExitCode::cellUnderflow);
+	std::string bits = _slice.cell->bits.substr(_slice.bitBegin, _bits);
+	_slice.bitBegin += _bits;
+	return bits;
+}
+
+VmCellPtr TVMInterpreter::loadRef(VmSlice& _slice) {
+	if (_slice.refSize() == 0)
+		throwException(ExitCode::cellUnderflow);
+	return _slice.cell->refs.at(_slice.refBegin++);
+}
+
+void TVMInterpreter::storeBits(VmBuilder& _builder, std::string const& _bits) {
+	if (_builder.bits.size() + _bits.size() > maxCellBits)
+		throwException(ExitCode::cellOverflow);
+	_builder.bits += _bits;
+}
+
+void TVMInterpreter::storeRef(VmBuilder& _builder, VmCellPtr _cell) {
+	if (_builder.refs.size() >= maxCellRefs)
+		throwException(ExitCode::cellOverflow);
+	_builder.refs.push_back(std::move(_cell));
+}
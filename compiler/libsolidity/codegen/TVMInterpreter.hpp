@@ -0,0 +1,268 @@
+/*
+ * Copyright (C) 2025 EverX. All Rights Reserved.
+ *
+ * Licensed under the  terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the  GNU General Public License for more details at: https://www.gnu.org/licenses/gpl-3.0.html
+ */
+/**
+ * Interpreter of the TVM assembly of a contract
+ */
+
+#pragma once
+
+#include <libsolidity/codegen/TvmAst.hpp>
+
+#include <libsolutil/Numeric.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace solidity::frontend {
+
+struct VmCell;
+using VmCellPtr = std::shared_ptr<VmCell const>;
+
+/// Ordinary cell. Bits are stored as a string of '0' and '1'.
+struct VmCell {
+	std::string bits;
+	std::vector<VmCellPtr> refs;
+
+	/// @returns the representation hash of the cell.
+	bigint const& hash() const;
+	int depth() const;
+private:
+	mutable std::optional<bigint> m_hash;
+	mutable std::optional<int> m_depth;
+};
+
+struct VmSlice {
+	VmCellPtr cell;
+	std::size_t bitBegin{};
+	std::size_t bitEnd{};
+	std::size_t refBegin{};
+	std::size_t refEnd{};
+
+	std::size_t bitSize() const { return bitEnd - bitBegin; }
+	std::size_t refSize() const { return refEnd - refBegin; }
+	std::string bits() const { return cell->bits.substr(bitBegin, bitSize()); }
+};
+
+struct VmBuilder {
+	std::string bits;
+	std::vector<VmCellPtr> refs;
+};
+
+struct VmNull {};
+struct VmNaN {};
+
+/// Continuation whose code is @a block, or the function selector in c3 if @a block is null.
+struct VmContinuation {
+	std::shared_ptr<CodeBlock const> block;
+};
+
+struct VmValue;
+using VmTuple = std::shared_ptr<std::vector<VmValue> const>;
+
+/// Value of an entry of the stack or of a control register.
+struct VmValue {
+	std::variant<VmNull, VmNaN, bigint, VmCellPtr, VmSlice, VmBuilder, VmTuple, VmContinuation> value;
+
+	VmValue() = default;
+	VmValue(bigint _value) : value{std::move(_value)} {}
+	VmValue(VmCellPtr _cell) : value{std::move(_cell)} {}
+	VmValue(VmSlice _slice) : value{std::move(_slice)} {}
+	VmValue(VmBuilder _builder) : value{std::move(_builder)} {}
+	VmValue(VmTuple _tuple) : value{std::move(_tuple)} {}
+	VmValue(VmContinuation _cont) : value{std::move(_cont)} {}
+	VmValue(VmNaN _nan) : value{_nan} {}
+
+	bool isNull() const { return std::holds_alternative<VmNull>(value); }
+	bool operator==(VmValue const& _other) const;
+	bool operator!=(VmValue const& _other) const { return !(*this == _other); }
+	/// @returns the value in the notation of the TVM debugger, e.g. "CS{x4_}" for a slice.
+	std::string toString() const;
+};
+
+/// Action that the code registered, e.g. an outbound message.
+struct VmAction {
+	std::string instruction;
+	std::vector<VmValue> arguments;
+
+	bool operator==(VmAction const& _other) const {
+		return instruction == _other.instruction && arguments == _other.arguments;
+	}
+};
+
+/// State of TVM before and after a run.
+struct TVMRunState {
+	/// The stack, the top of the stack is the last element.
+	std::vector<VmValue> stack;
+	/// Persistent data in c4.
+	VmCellPtr c4;
+	/// Temporary data in c7: the smart contract info and the global variables.
+	VmValue c7;
+};
+
+struct TVMRunResult {
+	/// 0 if the code returned, 1 if it returned with RETALT, the code of the exception otherwise.
+	/// Running out of gas gives -14.
+	int exitCode{};
+	VmValue exitArg;
+	TVMRunState state;
+	std::vector<VmAction> actions;
+	int64_t gasUsed{};
+
+	/// @returns true if both runs ended the same way with the same stack, c4, c7 and actions.
+	/// c7 is not compared after an exception, TVM discards it. The gas is not compared.
+	bool sameOutcome(TVMRunResult const& _other) const {
+		bool const returned = exitCode == 0 || exitCode == 1;
+		return exitCode == _other.exitCode && exitArg == _other.exitArg &&
+			state.stack == _other.state.stack && VmValue{state.c4} == VmValue{_other.state.c4} &&
+			(!returned || state.c7 == _other.state.c7) && actions == _other.actions;
+	}
+};
+
+/**
+ * Runs the TvmAst of a function of a contract. The interpreter supports the instructions the
+ * compiler emits for integers, tuples, cells, slices and builders, dictionaries, continuations,
+ * c4 and c7. Instructions that depend on the blockchain, e.g. signature checks, stop the run with
+ * solUnimplemented. Gas is counted with the cost table of TVMCodeMetrics for every instruction as
+ * it is printed, plus the loading of referenced continuations, implicit returns and exceptions.
+ */
+class TVMInterpreter : private boost::noncopyable {
+public:
+	/// @a _contract resolves CALL and .inline, it may be null if the code calls no function.
+	explicit TVMInterpreter(Contract const* _contract = nullptr, int64_t _gasLimit = 1'000'000);
+
+	/// Runs the function @a _functionName of the contract.
+	TVMRunResult run(std::string const& _functionName, TVMRunState _state);
+	/// Runs @a _block as a continuation.
+	TVMRunResult run(CodeBlock const& _block, TVMRunState _state);
+
+	/// @returns c7 with an empty smart contract info and no global variables.
+	static VmValue defaultC7();
+	/// @returns a cell with the bits @a _bits, given as a string of '0' and '1'.
+	static VmCellPtr makeCell(std::string _bits, std::vector<VmCellPtr> _refs = {});
+	static VmSlice toSlice(VmCellPtr const& _cell);
+
+private:
+	/// How the execution continues after an instruction.
+	enum class Status {
+		Next,
+		/// Return to c0 of the current continuation.
+		Ret,
+		/// Jump to c1.
+		RetAlt
+	};
+	struct VmException {
+		int code{};
+		VmValue arg;
+	};
+	struct OutOfGas {};
+
+	Status execute(std::vector<Pointer<TvmAstNode>> const& _instructions);
+	Status execute(TvmAstNode const& _node);
+	/// Executes the instruction @a _mnemonic as the Printer prints it, e.g. "STU" with "32".
+	Status instruction(std::string const& _mnemonic, std::string const& _arg);
+	/// @returns nothing if @a _mnemonic is not a control flow instruction.
+	std::optional<Status> controlFlow(std::string const& _mnemonic, std::string const& _arg);
+	void stackInstruction(Stack const& _node);
+	// The instructions below return false if they do not know @a _mnemonic.
+	bool stackInstruction(std::string const& _mnemonic, std::string const& _arg);
+	bool arithmetic(std::string const& _mnemonic, std::string const& _arg);
+	bool tupleInstruction(std::string const& _mnemonic, std::string const& _arg);
+	bool cellInstruction(std::string const& _mnemonic, std::string const& _arg);
+	bool dictInstruction(std::string const& _mnemonic);
+	bool environmentInstruction(std::string const& _mnemonic, std::string const& _arg);
+
+	/// Runs the continuation @a _cont. A return from it continues after the instruction.
+	Status call(VmContinuation const& _cont);
+	/// Runs the continuation @a _cont instead of the rest of the current continuation.
+	Status jump(VmContinuation const& _cont);
+	Status runContinuation(CodeBlock const& _block);
+	/// Runs the function selector in c3 on the function id on the top of the stack.
+	Status selectFunction();
+	Status callC3(uint32_t _functionId, bool _jump);
+	void pushBlock(std::shared_ptr<CodeBlock const> const& _block);
+	Pointer<CodeBlock> const& hardCode(HardCode const& _node);
+
+	/// Reads the dictionary with @a _bits bit keys from the root @a _slice into @a _dict.
+	void parseDict(VmSlice _slice, std::size_t _bits, std::string const& _prefix, std::map<std::string, VmSlice>& _dict);
+	/// @returns the root of the dictionary with the items from @a _begin to @a _end, which all start
+	/// with the same @a _offset bits.
+	VmCellPtr buildDict(
+		std::map<std::string, VmSlice>::const_iterator _begin,
+		std::map<std::string, VmSlice>::const_iterator _end,
+		std::size_t _offset,
+		std::size_t _bits
+	);
+	VmValue global(int _index);
+	void setGlobal(int _index, VmValue _value);
+
+	void charge(int64_t _gas);
+	void charge(std::string const& _instruction);
+	void chargePrinted(TvmAstNode const& _node);
+	[[noreturn]] void throwException(int _code, VmValue _arg = bigint(0), bool _charged = false);
+
+	// stack primitives, s(i) is the i-th entry from the top
+	VmValue& at(int _i);
+	void push(VmValue _value);
+	VmValue pop();
+	void pushInt(bigint _value, bool _quiet = false);
+	void pushBool(bool _value) { push(bigint(_value ? -1 : 0)); }
+	void xchg(int _i, int _j);
+	void pushS(int _i) { push(at(_i)); }
+	void blkSwap(int _down, int _top);
+	void reverse(int _count, int _index);
+	void drop(int _count);
+
+	bigint popInt();
+	std::optional<bigint> popIntOrNaN();
+	int popSmallInt(int _min, int _max);
+	bool popBool();
+	VmCellPtr popCell();
+	VmCellPtr popMaybeCell();
+	VmSlice popSlice();
+	VmBuilder popBuilder();
+	VmTuple popTuple();
+	VmContinuation popCont();
+
+	std::string loadBits(VmSlice& _slice, std::size_t _bits);
+	VmCellPtr loadRef(VmSlice& _slice);
+	void storeBits(VmBuilder& _builder, std::string const& _bits);
+	void storeRef(VmBuilder& _builder, VmCellPtr _cell);
+
+	Contract const* m_contract{};
+	std::map<std::string, Function const*> m_functionsByName;
+	std::map<uint32_t, Function const*> m_functionsById;
+	int64_t const m_gasLimit{};
+
+	std::vector<VmValue> m_stack;
+	VmCellPtr m_c4;
+	VmValue m_c7;
+	VmValue m_c3;
+	std::vector<VmAction> m_actions;
+	/// c4 and the actions as of the last COMMIT, they survive an exception.
+	VmCellPtr m_committedC4;
+	std::vector<VmAction> m_committedActions;
+	int64_t m_gas{};
+	/// Whether c1 of the current continuation is its c0, i.e. a loop with BRK ran in it.
+	bool m_altIsReturn{};
+	int m_depth{};
+	std::unordered_map<TvmAstNode const*, int> m_printedGas;
+	std::unordered_map<HardCode const*, Pointer<CodeBlock>> m_hardCode;
+};
+
+}	// end solidity::frontend
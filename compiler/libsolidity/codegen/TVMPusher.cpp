@@ -12,6 +12,7 @@
  */
 
 #include <boost/range/adaptor/map.hpp>
+#include <mutex>
 #include <utility>
 
 #include <libsolidity/ast/TypeProvider.h>
@@ -55,6 +56,23 @@ void StackPusher::pushString(const std::string& _str, bool toSlice) {
 	ensureSize(saveStackSize + 1, "");
 }
 
+void StackPusher::pushStringBuilder() {
+	// stack: Stack(TvmBuilder)
+	*this << "NEWC";
+	*this << "NULL";
+	*this << "TUPLE 2";
+}
+
+void StackPusher::appendToStringBuilder(const std::string& str) {
+	// stack: Stack(TvmBuilder) => Stack(TvmBuilder)
+	size_t const maxSlice = TvmConst::CellBitLength / 8;
+	for (size_t i = 0; i < str.length(); i += maxSlice) {
+		pushString(str.substr(i, std::min(maxSlice, str.length() - i)), true);
+		// stack: Stack(TvmBuilder) slice
+		pushFragmentInCallRef(2, 1, "__appendSliceToStringBuilder");
+	}
+}
+
 void StackPusher::pushLog() {
 	*this << "CTOS";
 	*this << "STRDUMP";
@@ -480,11 +498,11 @@ void StackPusher::pollLastRetOpcode() {
 		++offset;
 	int begPos = size - 1 - offset;
 
-	auto opcode = to<ReturnOrBreakOrCont>(opcodes.at(begPos).get());
+	auto opcode = dyn_cast<ReturnOrBreakOrCont>(opcodes.at(begPos).get());
 	solAssert(opcode, "");
 	vector<Pointer<TvmAstNode>> instructions = opcode->body()->instructions();
 	solAssert(!instructions.empty(), "");
-	auto ret = to<TvmReturn>(instructions.back().get());
+	auto ret = dyn_cast<TvmReturn>(instructions.back().get());
 	solAssert(ret, "");
 	solAssert(!ret->withIf() && !ret->withAlt(), "");
 	instructions.pop_back();
@@ -496,7 +514,7 @@ void StackPusher::pollLastRetOpcode() {
 bool StackPusher::tryPollEmptyPushCont() {
 	std::vector<Pointer<TvmAstNode>>& opcodes = m_instructions.back();
 	solAssert(opcodes.size() >= 2, "");
-	auto block = dynamic_pointer_cast<CodeBlock>(opcodes.back());
+	auto block = dyn_cast<CodeBlock>(opcodes.back());
 	solAssert(block != nullptr, "");
 	if (block->instructions().empty()) {
 		opcodes.pop_back();
@@ -554,7 +572,8 @@ void StackPusher::declRetFlag() {
 Pointer<AsymGen>
 StackPusher::makeAsym(const string& cmd) {
 	static std::set<string> asymOpcodes;
-	if (asymOpcodes.empty()) {
+	static std::once_flag asymOpcodesFlag;
+	std::call_once(asymOpcodesFlag, [] {
 		for (std::string type : {"", "I", "U"}) {
 			for (std::string suf : {"", "REF"}) {
 				for (std::string op : {"MIN", "MAX"}) {
@@ -606,7 +625,7 @@ StackPusher::makeAsym(const string& cmd) {
 			"STSLICEQ",
 			"STUQ",
 		});
-	}
+	});
 
 	istringstream iss(cmd);
 	string baseCmd;
@@ -735,10 +754,10 @@ void StackPusher::pushContAndCallX(int take, int ret, bool isPure) {
 
 void StackPusher::ifElse(bool withJmp) {
 	solAssert(m_instructions.back().size() >= 3, "");
-	auto falseBlock = dynamic_pointer_cast<CodeBlock>(m_instructions.back().back());
+	auto falseBlock = dyn_cast<CodeBlock>(m_instructions.back().back());
 	solAssert(falseBlock != nullptr, "");
 	m_instructions.back().pop_back();
-	auto trueBlock = dynamic_pointer_cast<CodeBlock>(m_instructions.back().back());
+	auto trueBlock = dyn_cast<CodeBlock>(m_instructions.back().back());
 	solAssert(trueBlock != nullptr, "");
 	m_instructions.back().pop_back();
 	auto b = createNode<TvmIfElse>(false, withJmp, trueBlock, falseBlock, 0);
@@ -747,10 +766,10 @@ void StackPusher::ifElse(bool withJmp) {
 
 void StackPusher::pushConditional(int ret) {
 	solAssert(m_instructions.back().size() >= 3, "");
-	auto falseBlock = dynamic_pointer_cast<CodeBlock>(m_instructions.back().back());
+	auto falseBlock = dyn_cast<CodeBlock>(m_instructions.back().back());
 	solAssert(falseBlock != nullptr, "");
 	m_instructions.back().pop_back();
-	auto trueBlock = dynamic_pointer_cast<CodeBlock>(m_instructions.back().back());
+	auto trueBlock = dyn_cast<CodeBlock>(m_instructions.back().back());
 	solAssert(trueBlock != nullptr, "");
 	m_instructions.back().pop_back();
 	auto b = createNode<TvmIfElse>(false, false, trueBlock, falseBlock, ret);
@@ -760,7 +779,7 @@ void StackPusher::pushConditional(int ret) {
 
 void StackPusher::if_or_ifNot(bool _withNot, bool _withJmp) {
 	solAssert(!m_instructions.back().empty(), "");
-	auto trueBlock = dynamic_pointer_cast<CodeBlock>(m_instructions.back().back());
+	auto trueBlock = dyn_cast<CodeBlock>(m_instructions.back().back());
 	solAssert(trueBlock, "");
 	m_instructions.back().pop_back();
 	auto b = createNode<TvmIfElse>(_withNot, _withJmp, trueBlock, nullptr, 0);
@@ -786,7 +805,7 @@ void StackPusher::ifNotJmp() {
 void StackPusher::repeatOrUntil(bool withBreakOrReturn, bool isRepeat) {
 	solAssert(!m_instructions.back().empty(), "");
 
-	auto loopBody = dynamic_pointer_cast<CodeBlock>(m_instructions.back().back());
+	auto loopBody = dyn_cast<CodeBlock>(m_instructions.back().back());
 	m_instructions.back().pop_back();
 	solAssert(loopBody != nullptr, "");
 
@@ -809,10 +828,10 @@ void StackPusher::until(bool withBreakOrReturn) {
 
 void StackPusher::_while(bool _withBreakOrReturn) {
 	solAssert(m_instructions.back().size() >= 2, "");
-	auto body = dynamic_pointer_cast<CodeBlock>(m_instructions.back().back());
+	auto body = dyn_cast<CodeBlock>(m_instructions.back().back());
 	solAssert(body != nullptr, "");
 	m_instructions.back().pop_back();
-	auto condition = dynamic_pointer_cast<CodeBlock>(m_instructions.back().back());
+	auto condition = dyn_cast<CodeBlock>(m_instructions.back().back());
 	solAssert(condition != nullptr, "");
 	m_instructions.back().pop_back();
 	auto b = createNode<While>(false, _withBreakOrReturn, condition, body);
@@ -821,10 +840,10 @@ void StackPusher::_while(bool _withBreakOrReturn) {
 
 void StackPusher::tryOpcode(bool saveAltC2) {
 	solAssert(m_instructions.back().size() >= 2, "");
-	auto catchBody = dynamic_pointer_cast<CodeBlock>(m_instructions.back().back());
+	auto catchBody = dyn_cast<CodeBlock>(m_instructions.back().back());
 	solAssert(catchBody != nullptr, "");
 	m_instructions.back().pop_back();
-	auto tryBody = dynamic_pointer_cast<CodeBlock>(m_instructions.back().back());
+	auto tryBody = dyn_cast<CodeBlock>(m_instructions.back().back());
 	solAssert(tryBody != nullptr, "");
 	m_instructions.back().pop_back();
 	auto b = createNode<TryCatch>(tryBody, catchBody, saveAltC2);
@@ -2101,6 +2120,22 @@ void TVMStack::takeLast(int n) {
 	solAssert(int(m_stackSize.size()) == n, "");
 }
 
+void TVMStack::addScalarStruct(Declaration const* name, int memberQty) {
+	solAssert(isParam(name), "");
+	solAssert(getStackSize(name) + 1 >= memberQty, "");
+	m_scalarStructs[name] = memberQty;
+}
+
+bool TVMStack::isScalarStruct(Declaration const* name) const {
+	return m_scalarStructs.count(name) != 0;
+}
+
+int TVMStack::getMemberOffset(Declaration const* name, int memberIndex) const {
+	int const memberQty = m_scalarStructs.at(name);
+	solAssert(0 <= memberIndex && memberIndex < memberQty, "");
+	return getOffset(name) + memberQty - 1 - memberIndex;
+}
+
 InherHelper::InherHelper(const ContractDefinition *contract) {
 	for (ContractDefinition const* c : contract->annotation().linearizedBaseContracts) {
 		for (FunctionDefinition const *_function : c->definedFunctions()) {
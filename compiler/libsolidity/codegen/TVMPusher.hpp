@@ -40,10 +40,16 @@ public:
 	int getStackSize(Declaration const* name) const;
 	void ensureSize(int savedStackSize, const std::string& location = "", const ASTNode* node = nullptr) const;
 	void takeLast(int n);
+	// Local struct variable which members are kept in separate stack slots.
+	// The variable is bound to the slot of its last member.
+	void addScalarStruct(Declaration const* name, int memberQty);
+	bool isScalarStruct(Declaration const* name) const;
+	int getMemberOffset(Declaration const* name, int memberIndex) const;
 
 private:
 	int m_size{};
 	std::vector<Declaration const*> m_stackSize;
+	std::map<Declaration const*, int> m_scalarStructs;
 };
 
 class InherHelper {
@@ -249,6 +255,8 @@ public:
 	TVMStack& getStack();
 	void pushLoc(const std::string& file, int line);
 	void pushString(const std::string& str, bool toSlice);
+	void pushStringBuilder();
+	void appendToStringBuilder(const std::string& str);
 	void pushLog();
 	void untuple(int n);
 	void unpackFirst(int n);
@@ -14,10 +14,12 @@
  * TVM Solidity abstract syntax tree.
  */
 
+#include <limits>
 #include <string>
 #include <unordered_map>
 
 #include <boost/algorithm/string/trim.hpp>
+#include <boost/functional/hash.hpp>
 
 #include <liblangutil/Exceptions.h>
 
@@ -32,6 +34,57 @@ using namespace solidity::frontend;
 using namespace std;
 
 namespace {
+	int globTake(Glob::Opcode _opcode) {
+		switch (_opcode) {
+			case Glob::Opcode::GetOrGetVar:
+			case Glob::Opcode::PUSHROOT:
+			case Glob::Opcode::PUSH_C3:
+			case Glob::Opcode::PUSH_C7:
+				return 0;
+
+			case Glob::Opcode::SetOrSetVar:
+			case Glob::Opcode::POPROOT:
+			case Glob::Opcode::POP_C3:
+			case Glob::Opcode::POP_C7:
+				return 1;
+		}
+		solUnimplemented("");
+	}
+
+	/// Changes of nodes made by this thread, a cached hash is valid while it doesn't change.
+	/// A tree is built, optimized and printed by one thread, so other compilations don't invalidate its hashes.
+	thread_local std::uint64_t hashEpoch = 1;
+	/// The epoch of the hashes of leaf nodes, they never change.
+	constexpr std::uint64_t leafEpoch = std::numeric_limits<std::uint64_t>::max();
+
+	bool isLeaf(TvmAstNode::Kind _kind) {
+		switch (_kind) {
+			case TvmAstNode::Kind::Loc:
+			case TvmAstNode::Kind::Stack:
+			case TvmAstNode::Kind::Glob:
+			case TvmAstNode::Kind::HardCode:
+			case TvmAstNode::Kind::StackOpcode:
+			case TvmAstNode::Kind::DeclRetFlag:
+			case TvmAstNode::Kind::AsymGen:
+			case TvmAstNode::Kind::TvmReturn:
+			case TvmAstNode::Kind::TvmException:
+				return true;
+			default:
+				return false;
+		}
+	}
+
+	template<class... Args>
+	std::size_t hashOf(TvmAstNode const& _node, Args const&... _args) {
+		std::size_t seed = static_cast<std::size_t>(_node.kind());
+		(boost::hash_combine(seed, _args), ...);
+		return seed;
+	}
+
+	std::size_t hashOf(Pointer<TvmAstNode> const& _node) {
+		return _node ? _node->hash() : 0;
+	}
+
 	bool eq(Pointer<TvmAstNode> const& a,Pointer<TvmAstNode> const& b) {
 		if ((a == nullptr) ^ (b == nullptr)) {
 			return false;
@@ -40,16 +93,55 @@ namespace {
 	}
 }
 
+bool TvmAstNode::operator==(TvmAstNode const& _node) const {
+	if (m_kind != _node.m_kind)
+		return false;
+	if (hasHash() && _node.hasHash() && m_hash != _node.m_hash)
+		return false;
+	return equals(_node);
+}
+
+std::size_t TvmAstNode::hash() const {
+	if (!hasHash()) {
+		m_hash = computeHash();
+		m_hashEpoch = isLeaf(m_kind) ? leafEpoch : hashEpoch;
+	}
+	return m_hash;
+}
+
+bool TvmAstNode::hasHash() const {
+	return m_hashEpoch == leafEpoch || m_hashEpoch == hashEpoch;
+}
+
+void TvmAstNode::invalidateHashes() {
+	++hashEpoch;
+}
+
+Pointer<TvmAstNode> const& TvmAstNodeTable::intern(Pointer<TvmAstNode> const& _node) {
+	std::size_t const hash = _node->hash();
+	auto [begin, end] = m_nodes.equal_range(hash);
+	for (auto it = begin; it != end; ++it) {
+		if (*it->second == *_node) {
+			return it->second;
+		}
+	}
+	return m_nodes.emplace(hash, _node)->second;
+}
+
 void Loc::accept(TvmAstVisitor& _visitor) {
 	_visitor.visit(*this);
 }
 
-bool Loc::operator==(TvmAstNode const& node) const {
-	auto n = to<Loc>(&node);
+bool Loc::equals(TvmAstNode const& node) const {
+	auto n = dyn_cast<Loc>(&node);
 	return n && std::tie(m_file, m_line) == std::tie(n->m_file, n->m_line);
 }
 
-Stack::Stack(Stack::Opcode opcode, int i, int j, int k) : m_opcode{opcode}, m_i{i}, m_j{j}, m_k{k}
+std::size_t Loc::computeHash() const {
+	return hashOf(*this, m_file, m_line);
+}
+
+Stack::Stack(Stack::Opcode opcode, int i, int j, int k) : TvmAstNode{Kind::Stack}, m_opcode{opcode}, m_i{i}, m_j{j}, m_k{k}
 {
 }
 
@@ -57,13 +149,22 @@ void Stack::accept(TvmAstVisitor& _visitor) {
 	_visitor.visit(*this);
 }
 
-bool Stack::operator==(TvmAstNode const& _node) const {
-	auto st = to<Stack>(&_node);
+bool Stack::equals(TvmAstNode const& _node) const {
+	auto st = dyn_cast<Stack>(&_node);
 	return st && std::tie(m_opcode, m_i, m_j, m_k) == std::tie(st->m_opcode, st->m_i, st->m_j, st->m_k);
 }
 
+std::size_t Stack::computeHash() const {
+	return hashOf(*this, static_cast<int>(m_opcode), m_i, m_j, m_k);
+}
+
 Glob::Glob(Glob::Opcode opcode, int index) :
-	Gen{isIn(opcode, Glob::Opcode::GetOrGetVar, Glob::Opcode::PUSHROOT, Glob::Opcode::PUSH_C3)},
+	Gen{
+		Kind::Glob,
+		globTake(opcode),
+		1 - globTake(opcode),
+		isIn(opcode, Glob::Opcode::GetOrGetVar, Glob::Opcode::PUSHROOT, Glob::Opcode::PUSH_C3)
+	},
 	m_opcode{opcode},
 	m_index{index}
 {
@@ -73,54 +174,28 @@ void Glob::accept(TvmAstVisitor& _visitor) {
 	_visitor.visit(*this);
 }
 
-bool Glob::operator==(TvmAstNode const&node) const {
-	auto g = to<Glob>(&node);
+bool Glob::equals(TvmAstNode const& node) const {
+	auto g = dyn_cast<Glob>(&node);
 	return g && std::tie(m_opcode, m_index) == std::tie(g->m_opcode, g->m_index);
 }
 
-int Glob::take() const {
-	switch (m_opcode) {
-		case Opcode::GetOrGetVar:
-		case Opcode::PUSHROOT:
-		case Opcode::PUSH_C3:
-		case Opcode::PUSH_C7:
-			return 0;
-
-		case Opcode::SetOrSetVar:
-		case Opcode::POPROOT:
-		case Opcode::POP_C3:
-		case Opcode::POP_C7:
-			return 1;
-	}
-	solUnimplemented("");
-}
-
-int Glob::ret() const {
-	switch (m_opcode) {
-		case Opcode::GetOrGetVar:
-		case Opcode::PUSHROOT:
-		case Opcode::PUSH_C3:
-		case Opcode::PUSH_C7:
-			return 1;
-
-		case Opcode::SetOrSetVar:
-		case Opcode::POPROOT:
-		case Opcode::POP_C3:
-		case Opcode::POP_C7:
-			return 0;
-	}
-	solUnimplemented("");
+std::size_t Glob::computeHash() const {
+	return hashOf(*this, static_cast<int>(m_opcode), m_index);
 }
 
 void DeclRetFlag::accept(TvmAstVisitor& _visitor) {
 	_visitor.visit(*this);
 }
 
-bool DeclRetFlag::operator==(TvmAstNode const& node) const {
-	auto d = to<DeclRetFlag>(&node);
+bool DeclRetFlag::equals(TvmAstNode const& node) const {
+	auto d = dyn_cast<DeclRetFlag>(&node);
 	return d;
 }
 
+std::size_t DeclRetFlag::computeHash() const {
+	return hashOf(*this);
+}
+
 void Opaque::accept(TvmAstVisitor& _visitor) {
 	if (_visitor.visit(*this))
 	{
@@ -128,21 +203,30 @@ void Opaque::accept(TvmAstVisitor& _visitor) {
 	}
 }
 
-bool Opaque::operator==(TvmAstNode const& _node) const {
-	auto op = to<Opaque>(&_node);
-	return op && std::tie(*m_block.get(), m_take, m_ret) == std::tie(*op->m_block.get(), op->m_take, op->m_ret);
+bool Opaque::equals(TvmAstNode const& _node) const {
+	auto op = dyn_cast<Opaque>(&_node);
+	return op && take() == op->take() && ret() == op->ret() && *m_block.get() == *op->m_block.get();
+}
+
+std::size_t Opaque::computeHash() const {
+	return hashOf(*this, take(), ret(), hashOf(m_block));
 }
 
 void AsymGen::accept(TvmAstVisitor& _visitor) {
 	_visitor.visit(*this);
 }
 
-bool AsymGen::operator==(TvmAstNode const& _node) const {
-	auto a = to<AsymGen>(&_node);
+bool AsymGen::equals(TvmAstNode const& _node) const {
+	auto a = dyn_cast<AsymGen>(&_node);
 	return a && opcode() == a->opcode();
 }
 
+std::size_t AsymGen::computeHash() const {
+	return hashOf(*this, m_opcode);
+}
+
 AsymGen::AsymGen(std::string opcode) :
+	TvmAstNode{Kind::AsymGen},
 	m_opcode(std::move(opcode))
 {
 	if (boost::starts_with(m_opcode, "ZERO"))
@@ -153,12 +237,16 @@ void HardCode::accept(TvmAstVisitor& _visitor) {
 	_visitor.visit(*this);
 }
 
-bool HardCode::operator==(TvmAstNode const& _node) const {
-	auto g = to<HardCode>(&_node);
-	return g && std::tie(m_code, m_take, m_ret) == std::tie(g->m_code, g->m_take, g->m_ret);
+bool HardCode::equals(TvmAstNode const& _node) const {
+	auto g = dyn_cast<HardCode>(&_node);
+	return g && take() == g->take() && ret() == g->ret() && m_code == g->m_code;
 }
 
-StackOpcode::StackOpcode(const std::string& opcode, int take, int ret, bool _isPure) : Gen{_isPure}, m_take{take}, m_ret{ret} {
+std::size_t HardCode::computeHash() const {
+	return hashOf(*this, m_code, take(), ret());
+}
+
+StackOpcode::StackOpcode(const std::string& opcode, int take, int ret, bool _isPure) : Gen{Kind::StackOpcode, take, ret, _isPure} {
 	vector<string> lines = split(opcode, ';');
 	solAssert(lines.size() <= 2, "");
 
@@ -186,8 +274,8 @@ std::string StackOpcode::fullOpcode() const {
 	return ret;
 }
 
-bool StackOpcode::operator==(TvmAstNode const& _node) const {
-	auto gen = to<StackOpcode>(&_node);
+bool StackOpcode::equals(TvmAstNode const& _node) const {
+	auto gen = dyn_cast<StackOpcode>(&_node);
 	if (gen) {
 		if (
 			(isIn(fullOpcode(), "TRUE", "PUSHINT -1") && isIn(gen->fullOpcode(), "TRUE", "PUSHINT -1")) ||
@@ -199,7 +287,17 @@ bool StackOpcode::operator==(TvmAstNode const& _node) const {
 	return gen && std::tie(m_opcode, m_arg) == std::tie(gen->m_opcode, gen->m_arg);
 }
 
+std::size_t StackOpcode::computeHash() const {
+	// TRUE and FALSE are equal to PUSHINT -1 and PUSHINT 0, the comment is not compared
+	if (m_opcode == "TRUE" && m_arg.empty())
+		return hashOf(*this, std::string{"PUSHINT"}, std::string{"-1"});
+	if (m_opcode == "FALSE" && m_arg.empty())
+		return hashOf(*this, std::string{"PUSHINT"}, std::string{"0"});
+	return hashOf(*this, m_opcode, m_arg);
+}
+
 TvmReturn::TvmReturn(bool _withIf, bool _withNot, bool _withAlt) :
+	TvmAstNode{Kind::TvmReturn},
 	m_withIf{_withIf},
 	m_withNot{_withNot},
 	m_withAlt{_withAlt}
@@ -211,11 +309,15 @@ void TvmReturn::accept(TvmAstVisitor& _visitor) {
 	_visitor.visit(*this);
 }
 
-bool TvmReturn::operator==(TvmAstNode const& _node) const {
-	auto t = to<TvmReturn>(&_node);
+bool TvmReturn::equals(TvmAstNode const& _node) const {
+	auto t = dyn_cast<TvmReturn>(&_node);
 	return t && std::tie(m_withIf, m_withNot, m_withAlt) == std::tie(t->m_withIf, t->m_withNot, t->m_withAlt);
 }
 
+std::size_t TvmReturn::computeHash() const {
+	return hashOf(*this, m_withIf, m_withNot, m_withAlt);
+}
+
 void ReturnOrBreakOrCont::accept(TvmAstVisitor& _visitor) {
 	if (_visitor.visit(*this))
 	{
@@ -223,21 +325,29 @@ void ReturnOrBreakOrCont::accept(TvmAstVisitor& _visitor) {
 	}
 }
 
-bool ReturnOrBreakOrCont::operator==(TvmAstNode const& _node) const {
-	auto r = to<ReturnOrBreakOrCont>(&_node);
+bool ReturnOrBreakOrCont::equals(TvmAstNode const& _node) const {
+	auto r = dyn_cast<ReturnOrBreakOrCont>(&_node);
 	return r && std::tie(m_take, *m_body.get()) == std::tie(r->m_take, *r->m_body.get());
 }
 
+std::size_t ReturnOrBreakOrCont::computeHash() const {
+	return hashOf(*this, m_take, hashOf(m_body));
+}
+
 void TvmException::accept(TvmAstVisitor& _visitor) {
 	_visitor.visit(*this);
 }
 
-bool TvmException::operator==(TvmAstNode const& _node) const {
-	auto ex = to<TvmException>(&_node);
+bool TvmException::equals(TvmAstNode const& _node) const {
+	auto ex = dyn_cast<TvmException>(&_node);
 	return ex && std::tie(m_arg, m_any, m_if, m_not, m_param) ==
 		std::tie(ex->m_arg, ex->m_any, ex->m_if, ex->m_not, ex->m_param);
 }
 
+std::size_t TvmException::computeHash() const {
+	return hashOf(*this, m_arg, m_any, m_if, m_not, m_param);
+}
+
 std::string TvmException::opcode() const {
 	std::string str = "THROW";
 	if (m_arg) str += "ARG";
@@ -264,8 +374,8 @@ void PushCellOrSlice::accept(TvmAstVisitor& _visitor) {
 	}
 }
 
-bool PushCellOrSlice::operator==(TvmAstNode const& _node) const {
-	auto p = to<PushCellOrSlice>(&_node);
+bool PushCellOrSlice::equals(TvmAstNode const& _node) const {
+	auto p = dyn_cast<PushCellOrSlice>(&_node);
 	if (p && std::tie(m_type, m_blob) == std::tie(p->m_type, p->m_blob)) {
 		if ((m_child == nullptr) ^ (p->m_child == nullptr)) {
 			return false;
@@ -279,14 +389,8 @@ bool PushCellOrSlice::operator==(TvmAstNode const& _node) const {
 	return false;
 }
 
-bool PushCellOrSlice::operator<(TvmAstNode const& _node) const {
-	auto p = to<PushCellOrSlice>(&_node);
-	if ((m_child == nullptr) ^ (p->m_child == nullptr)) {
-		return m_child < p->m_child;
-	}
-	if (m_child == nullptr)
-		return std::tie(m_type, m_blob) < std::tie(p->m_type, p->m_blob);
-	return std::tie(m_type, m_blob, *m_child) < std::tie(p->m_type, p->m_blob, *p->m_child);
+std::size_t PushCellOrSlice::computeHash() const {
+	return hashOf(*this, static_cast<int>(m_type), m_blob, hashOf(m_child));
 }
 
 std::string PushCellOrSlice::chainBlob() const {
@@ -306,6 +410,7 @@ std::string PushCellOrSlice::chainBlob() const {
 
 void PushCellOrSlice::updToRef() {
 	m_type = Type::PUSHREFSLICE;
+	invalidateHashes();
 }
 
 std::string CodeBlock::toString(CodeBlock::Type t) {
@@ -330,8 +435,8 @@ void CodeBlock::accept(TvmAstVisitor& _visitor) {
 	_visitor.endVisit(*this);
 }
 
-bool CodeBlock::operator==(TvmAstNode const& _node) const {
-	auto c = to<CodeBlock>(&_node);
+bool CodeBlock::equals(TvmAstNode const& _node) const {
+	auto c = dyn_cast<CodeBlock>(&_node);
 	if (c && m_type == c->m_type && m_instructions.size() == c->m_instructions.size()) {
 		for (size_t i = 0; i < m_instructions.size(); ++i) {
 			if (!(*m_instructions.at(i) == *c->m_instructions.at(i))) {
@@ -343,6 +448,14 @@ bool CodeBlock::operator==(TvmAstNode const& _node) const {
 	return false;
 }
 
+std::size_t CodeBlock::computeHash() const {
+	std::size_t seed = hashOf(*this, static_cast<int>(m_type));
+	for (Pointer<TvmAstNode> const& node : m_instructions) {
+		boost::hash_combine(seed, node->hash());
+	}
+	return seed;
+}
+
 void SubProgram::accept(TvmAstVisitor &_visitor) {
 	if (_visitor.visit(*this))
 	{
@@ -350,9 +463,9 @@ void SubProgram::accept(TvmAstVisitor &_visitor) {
 	}
 }
 
-bool SubProgram::operator==(TvmAstNode const& _node) const {
-	auto s = to<SubProgram>(&_node);
-	if (s && std::tie(m_take, m_ret, m_isJmp) == std::tie(s->m_take, s->m_ret, s->m_isJmp)) {
+bool SubProgram::equals(TvmAstNode const& _node) const {
+	auto s = dyn_cast<SubProgram>(&_node);
+	if (s && take() == s->take() && ret() == s->ret() && m_isJmp == s->m_isJmp) {
 		if (m_block == nullptr && s->m_block == nullptr) {
 			return true;
 		}
@@ -363,6 +476,10 @@ bool SubProgram::operator==(TvmAstNode const& _node) const {
 	return false;
 }
 
+std::size_t SubProgram::computeHash() const {
+	return hashOf(*this, take(), ret(), m_isJmp, hashOf(m_block));
+}
+
 void LogCircuit::accept(TvmAstVisitor& _visitor) {
 	if (_visitor.visit(*this))
 	{
@@ -370,19 +487,22 @@ void LogCircuit::accept(TvmAstVisitor& _visitor) {
 	}
 }
 
-bool LogCircuit::operator==(TvmAstNode const& _node) const {
-	auto l = to<LogCircuit>(&_node);
+bool LogCircuit::equals(TvmAstNode const& _node) const {
+	auto l = dyn_cast<LogCircuit>(&_node);
 	return l && std::tie(m_type, *m_body.get()) == std::tie(l->m_type, *l->m_body.get());
 }
 
+std::size_t LogCircuit::computeHash() const {
+	return hashOf(*this, static_cast<int>(m_type), hashOf(m_body));
+}
+
 TvmIfElse::TvmIfElse(bool _withNot, bool _withJmp, Pointer<CodeBlock> const &trueBody,
 					 Pointer<CodeBlock> const &falseBody, int ret) :
-		Gen{false},
+		Gen{Kind::TvmIfElse, 1, ret, false},
 		m_withNot{_withNot},
 		m_withJmp{_withJmp},
 		m_trueBody(trueBody),
-		m_falseBody(falseBody),
-		m_ret{ret}
+		m_falseBody(falseBody)
 {
 	solAssert((m_withNot && falseBody == nullptr) || !m_withNot, "");
 }
@@ -397,10 +517,14 @@ void TvmIfElse::accept(TvmAstVisitor& _visitor) {
 	}
 }
 
-bool TvmIfElse::operator==(TvmAstNode const& _node) const {
-	auto op = to<TvmIfElse>(&_node);
-	return op && eq(m_trueBody, op->m_trueBody) && eq(op->m_falseBody, op->m_falseBody) &&
-		std::tie(m_withNot, m_withJmp, m_ret) == std::tie(op->m_withNot, op->m_withJmp, op->m_ret);
+bool TvmIfElse::equals(TvmAstNode const& _node) const {
+	auto op = dyn_cast<TvmIfElse>(&_node);
+	return op && eq(m_trueBody, op->m_trueBody) && eq(m_falseBody, op->m_falseBody) &&
+		std::tie(m_withNot, m_withJmp) == std::tie(op->m_withNot, op->m_withJmp) && ret() == op->ret();
+}
+
+std::size_t TvmIfElse::computeHash() const {
+	return hashOf(*this, m_withNot, m_withJmp, ret(), hashOf(m_trueBody), hashOf(m_falseBody));
 }
 
 void TvmRepeat::accept(TvmAstVisitor& _visitor) {
@@ -435,6 +559,7 @@ void TryCatch::accept(TvmAstVisitor& _visitor) {
 
 Function::Function(int take, int ret, std::string name, std::optional<uint32_t> _functionId,
 	Function::FunctionType type, Pointer<CodeBlock> block, const FunctionDefinition *_function) :
+	TvmAstNode{Kind::Function},
 	m_take{take},
 	m_ret{ret},
 	m_name{std::move(name)},
@@ -1059,7 +1184,7 @@ Pointer<TvmIfElse> flipIfElse(TvmIfElse const& node) {
 
 bool isPureGen01(TvmAstNode const& node) {
 	// See also isSimpleCommand
-	auto gen = to<Gen>(&node);
+	auto gen = dyn_cast<Gen>(&node);
 	return gen && gen->isPure() && gen->take() == 0 && gen->ret() == 1;
 }
 
@@ -1069,7 +1194,7 @@ bool isSWAP(Pointer<TvmAstNode> const& node) {
 
 // down, top
 std::optional<std::pair<int, int>> isBLKSWAP(Pointer<TvmAstNode> const& node) {
-	auto stack = to<Stack>(node.get());
+	auto stack = dyn_cast<Stack>(node.get());
 	if (stack) {
 		int i = stack->i();
 		int j = stack->j();
@@ -1094,7 +1219,7 @@ std::optional<std::pair<int, int>> isBLKSWAP(Pointer<TvmAstNode> const& node) {
 }
 
 std::optional<int> isDrop(Pointer<TvmAstNode> const& node) {
-	auto stack = to<Stack>(node.get());
+	auto stack = dyn_cast<Stack>(node.get());
 	if (!stack)
 		return {};
 	switch (stack->opcode()) {
@@ -1107,7 +1232,7 @@ std::optional<int> isDrop(Pointer<TvmAstNode> const& node) {
 }
 
 std::optional<int> isPOP(Pointer<TvmAstNode> const& node) {
-	auto stack = to<Stack>(node.get());
+	auto stack = dyn_cast<Stack>(node.get());
 	if (stack) {
 		switch (stack->opcode()) {
 		case Stack::Opcode::POP_S:
@@ -1124,7 +1249,7 @@ std::optional<int> isPOP(Pointer<TvmAstNode> const& node) {
 }
 
 std::optional<int> isPUSH(Pointer<TvmAstNode> const& node) {
-	if (auto stack = to<Stack>(node.get())) {
+	if (auto stack = dyn_cast<Stack>(node.get())) {
 		switch (stack->opcode()) {
 		case Stack::Opcode::PUSH_S:
 			return stack->i();
@@ -1140,7 +1265,7 @@ std::optional<int> isPUSH(Pointer<TvmAstNode> const& node) {
 }
 
 std::optional<std::pair<int, int>> isBLKPUSH(Pointer<TvmAstNode> const& node) {
-	if (auto stack = to<Stack>(node.get())) {
+	if (auto stack = dyn_cast<Stack>(node.get())) {
 		switch (stack->opcode()) {
 		case Stack::Opcode::BLKPUSH:
 			return {{stack->i(), stack->j()}};
@@ -1157,14 +1282,14 @@ std::optional<std::pair<int, int>> isBLKPUSH(Pointer<TvmAstNode> const& node) {
 }
 
 bool isXCHG(Pointer<TvmAstNode> const& node, int i, int j) {
-	auto cmd2Stack = to<Stack>(node.get());
+	auto cmd2Stack = dyn_cast<Stack>(node.get());
 	return cmd2Stack && cmd2Stack->opcode() == Stack::Opcode::XCHG &&
 			cmd2Stack->i() == i &&
 			cmd2Stack->j() == j;
 }
 
 std::optional<int> isXCHG_S0(Pointer<TvmAstNode> const& node) {
-	auto stack = to<Stack>(node.get());
+	auto stack = dyn_cast<Stack>(node.get());
 	if (stack) {
 		int i = stack->i();
 		int j = stack->j();
@@ -1192,7 +1317,7 @@ std::optional<int> isXCHG_S0(Pointer<TvmAstNode> const& node) {
 
 // qty, index
 std::optional<std::pair<int, int>> isREVERSE(Pointer<TvmAstNode> const& node) {
-	auto stack = to<Stack>(node.get());
+	auto stack = dyn_cast<Stack>(node.get());
 	if (stack) {
 		int i = stack->i();
 		int j = stack->j();
@@ -1217,13 +1342,15 @@ std::optional<std::pair<int, int>> isREVERSE(Pointer<TvmAstNode> const& node) {
 }
 
 Pointer<PushCellOrSlice> isPlainPushSlice(Pointer<TvmAstNode> const& node) {
-	auto p = dynamic_pointer_cast<PushCellOrSlice>(node);
+	auto p = dyn_cast<PushCellOrSlice>(node);
 	if (p && p->child() == nullptr)
 		return p;
 	return {};
 }
 
 int getRootBitSize(PushCellOrSlice const &_node) {
+	if (_node.blob().empty()) // empty cell, e.g. `NEWC ENDC`
+		return 0;
 	int size = StrUtils::toBitString(_node.blob()).length();
 	return size;
 }
@@ -16,8 +16,10 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <optional>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -41,16 +43,62 @@ Pointer<NodeType> createNode(Args&& ... _args)
 
 class TvmAstNode : private boost::noncopyable, public std::enable_shared_from_this<TvmAstNode> {
 public:
+	/// The class of a node, the kinds of the subclasses of Gen go in a row.
+	enum class Kind : uint8_t {
+		Loc,
+		Stack,
+		Glob,
+		Opaque,
+		HardCode,
+		StackOpcode,
+		PushCellOrSlice,
+		SubProgram,
+		TvmIfElse,
+		DeclRetFlag,
+		AsymGen,
+		TvmReturn,
+		ReturnOrBreakOrCont,
+		TvmException,
+		CodeBlock,
+		LogCircuit,
+		TvmRepeat,
+		TvmUntil,
+		While,
+		TryCatch,
+		Function,
+		Contract
+	};
 	virtual ~TvmAstNode() = default;
 	virtual void accept(TvmAstVisitor& _visitor) = 0;
-	virtual bool operator==(TvmAstNode const& _node) const = 0;
+	/// Compares the nodes structurally. If both hashes are cached and differ, it doesn't look further.
+	bool operator==(TvmAstNode const& _node) const;
+	virtual bool equals(TvmAstNode const& _node) const = 0;
+	Kind kind() const { return m_kind; }
+	/// @returns the structural hash, equal nodes have equal hashes.
+	/// Hashes of leaves are cached for good. Hashes of other nodes are cached until this thread changes any node,
+	/// which the optimizers do all the time, so they are mostly reused after the optimization, e.g. by SizeOptimizer.
+	std::size_t hash() const;
+	virtual std::size_t computeHash() const { return static_cast<std::size_t>(m_kind); }
+protected:
+	explicit TvmAstNode(Kind _kind) : m_kind{_kind} {}
+	/// Invalidates the cached hashes of all non-leaf nodes of this thread, must be called by every change of a node.
+	static void invalidateHashes();
+private:
+	bool hasHash() const;
+
+	Kind const m_kind;
+	mutable std::size_t m_hash{};
+	/// The value of the change counter when m_hash was computed, 0 if it was not.
+	mutable std::uint64_t m_hashEpoch{};
 };
 
 class Loc : public TvmAstNode {
 public:
-	explicit Loc(std::string  _file, int _line) : m_file{std::move(_file)}, m_line{_line} { }
+	static bool classof(TvmAstNode const& _node) { return _node.kind() == Kind::Loc; }
+	explicit Loc(std::string  _file, int _line) : TvmAstNode{Kind::Loc}, m_file{std::move(_file)}, m_line{_line} { }
 	void accept(TvmAstVisitor& _visitor) override;
-	bool operator==(TvmAstNode const& n) const override;
+	bool equals(TvmAstNode const& _node) const override;
+	std::size_t computeHash() const override;
 	std::string const& file() const { return m_file; }
 	int line() const { return m_line; }
 private:
@@ -60,6 +108,7 @@ private:
 
 class Stack : public TvmAstNode {
 public:
+	static bool classof(TvmAstNode const& _node) { return _node.kind() == Kind::Stack; }
 	enum class Opcode {
 		DROP,
 		BLKDROP2, // BLKDROP2 1, 1
@@ -88,7 +137,8 @@ public:
 	};
 	explicit Stack(Opcode opcode, int i = -1, int j = -1, int k = -1);
 	void accept(TvmAstVisitor& _visitor) override;
-	bool operator==(TvmAstNode const& _node) const override;
+	bool equals(TvmAstNode const& _node) const override;
+	std::size_t computeHash() const override;
 	Opcode opcode() const { return m_opcode; }
 	int i() const { return m_i; }
 	int j() const { return m_j; }
@@ -103,16 +153,24 @@ private:
 // abstract
 class Gen : public TvmAstNode {
 public:
-	explicit Gen(bool _isPure) : m_isPure{_isPure} {}
-	virtual int take() const = 0;
-	virtual int ret() const = 0;
+	static bool classof(TvmAstNode const& _node) {
+		return Kind::Glob <= _node.kind() && _node.kind() <= Kind::TvmIfElse;
+	}
+	int take() const { return m_take; }
+	int ret() const { return m_ret; }
 	bool isPure() const { return m_isPure; }
+protected:
+	Gen(Kind _kind, int _take, int _ret, bool _isPure) :
+		TvmAstNode{_kind}, m_take{_take}, m_ret{_ret}, m_isPure{_isPure} {}
 private:
+	int m_take{};
+	int m_ret{};
 	bool m_isPure{}; // it doesn't throw exception, has no side effects (doesn't change any GLOB vars)
 };
 
 class Glob : public Gen {
 public:
+	static bool classof(TvmAstNode const& _node) { return _node.kind() == Kind::Glob; }
 	enum class Opcode {
 		GetOrGetVar,
 		SetOrSetVar,
@@ -128,11 +186,10 @@ public:
 	};
 	explicit Glob(Opcode opcode, int index = -1);
 	void accept(TvmAstVisitor& _visitor) override;
-	bool operator==(TvmAstNode const&) const override;
+	bool equals(TvmAstNode const& _node) const override;
+	std::size_t computeHash() const override;
 	Opcode opcode() const { return m_opcode; }
 	int index() const { return m_index; }
-	int take() const override;
-	int ret() const override;
 private:
 	Opcode m_opcode{};
 	int m_index{-1};
@@ -142,30 +199,33 @@ class CodeBlock;
 
 class DeclRetFlag : public TvmAstNode {
 public:
+	static bool classof(TvmAstNode const& _node) { return _node.kind() == Kind::DeclRetFlag; }
+	DeclRetFlag() : TvmAstNode{Kind::DeclRetFlag} {}
 	void accept(TvmAstVisitor& _visitor) override;
-	bool operator==(TvmAstNode const&) const override;
+	bool equals(TvmAstNode const& _node) const override;
+	std::size_t computeHash() const override;
 };
 
 class Opaque : public Gen {
 public:
+	static bool classof(TvmAstNode const& _node) { return _node.kind() == Kind::Opaque; }
 	explicit Opaque(Pointer<CodeBlock> _block, int take, int ret, bool isPure) :
-		Gen{isPure}, m_block(std::move(_block)), m_take{take}, m_ret{ret} {}
+		Gen{Kind::Opaque, take, ret, isPure}, m_block(std::move(_block)) {}
 	void accept(TvmAstVisitor& _visitor) override;
-	bool operator==(TvmAstNode const&) const override;
+	bool equals(TvmAstNode const& _node) const override;
+	std::size_t computeHash() const override;
 	Pointer<CodeBlock> const& block() const { return m_block; }
-	int take() const override { return m_take; }
-	int ret() const override { return m_ret; }
 private:
 	Pointer<CodeBlock> m_block;
-	int m_take{};
-	int m_ret{};
 };
 
 class AsymGen : public TvmAstNode {
 public:
+	static bool classof(TvmAstNode const& _node) { return _node.kind() == Kind::AsymGen; }
 	explicit AsymGen(std::string opcode);
 	void accept(TvmAstVisitor& _visitor) override;
-	bool operator==(TvmAstNode const&) const override;
+	bool equals(TvmAstNode const& _node) const override;
+	std::size_t computeHash() const override;
 	std::string const& opcode() const { return m_opcode; }
 private:
 	std::string m_opcode;
@@ -173,43 +233,41 @@ private:
 
 class HardCode : public Gen {
 public:
+	static bool classof(TvmAstNode const& _node) { return _node.kind() == Kind::HardCode; }
 	explicit HardCode(std::vector<std::string> code, int take, int ret, bool _isPure) :
-		Gen{_isPure}, m_code(std::move(code)), m_take{take}, m_ret{ret} {}
+		Gen{Kind::HardCode, take, ret, _isPure}, m_code(std::move(code)) {}
 	void accept(TvmAstVisitor& _visitor) override;
-	bool operator==(TvmAstNode const&) const override;
+	bool equals(TvmAstNode const& _node) const override;
+	std::size_t computeHash() const override;
 	std::vector<std::string> const& code() const { return m_code; }
-	int take() const override { return m_take; }
-	int ret() const override { return m_ret; }
 private:
 	std::vector<std::string> m_code;
-	int m_take{};
-	int m_ret{};
 };
 
 class StackOpcode : public Gen {
 public:
+	static bool classof(TvmAstNode const& _node) { return _node.kind() == Kind::StackOpcode; }
 	explicit StackOpcode(const std::string& opcode, int take, int ret, bool _isPure = false);
 	void accept(TvmAstVisitor& _visitor) override;
 	std::string fullOpcode() const;
 	std::string const &opcode() const { return m_opcode; }
 	std::string const &arg() const { return m_arg; }
 	std::string const &comment() const { return m_comment; }
-	int take() const override { return m_take; }
-	int ret() const override { return m_ret; }
-	bool operator==(TvmAstNode const& _node) const override;
+	bool equals(TvmAstNode const& _node) const override;
+	std::size_t computeHash() const override;
 private:
 	std::string m_opcode;
 	std::string m_arg;
 	std::string m_comment;
-	int m_take{};
-	int m_ret{};
 };
 
 class TvmReturn : public TvmAstNode {
 public:
+	static bool classof(TvmAstNode const& _node) { return _node.kind() == Kind::TvmReturn; }
 	TvmReturn(bool _withIf, bool _withNot, bool _withAlt);
 	void accept(TvmAstVisitor& _visitor) override;
-	bool operator==(TvmAstNode const&) const override;
+	bool equals(TvmAstNode const& _node) const override;
+	std::size_t computeHash() const override;
 	bool withIf() const { return m_withIf; }
 	bool withNot() const { return m_withNot; }
 	bool withAlt() const { return m_withAlt; }
@@ -221,14 +279,17 @@ private:
 
 class ReturnOrBreakOrCont : public TvmAstNode {
 public:
+	static bool classof(TvmAstNode const& _node) { return _node.kind() == Kind::ReturnOrBreakOrCont; }
 	explicit ReturnOrBreakOrCont(int _take, Pointer<CodeBlock> const &body) :
+		TvmAstNode{Kind::ReturnOrBreakOrCont},
 		m_take{_take},
 		m_body{body}
 	{
 	}
 	Pointer<CodeBlock> const &body() const { return m_body; }
 	void accept(TvmAstVisitor& _visitor) override;
-	bool operator==(TvmAstNode const&) const override;
+	bool equals(TvmAstNode const& _node) const override;
+	std::size_t computeHash() const override;
 	int take() const { return m_take; }
 private:
 	int m_take{};
@@ -237,7 +298,9 @@ private:
 
 class TvmException : public TvmAstNode {
 public:
+	static bool classof(TvmAstNode const& _node) { return _node.kind() == Kind::TvmException; }
 	explicit TvmException(bool _arg, bool _any, bool _if, bool _not, std::string  _param) :
+		TvmAstNode{Kind::TvmException},
 		m_arg{_arg},
 		m_any{_any},
 		m_if{_if},
@@ -246,7 +309,8 @@ public:
 	{
 	}
 	void accept(TvmAstVisitor& _visitor) override;
-	bool operator==(TvmAstNode const&) const override;
+	bool equals(TvmAstNode const& _node) const override;
+	std::size_t computeHash() const override;
 	std::string opcode() const;
 	std::string const& arg() const { return m_param; }
 	int take() const;
@@ -264,6 +328,7 @@ private:
 
 class PushCellOrSlice : public Gen {
 public:
+	static bool classof(TvmAstNode const& _node) { return _node.kind() == Kind::PushCellOrSlice; }
 	enum class Type {
 		PUSHREF_COMPUTE,
 		PUSHREFSLICE_COMPUTE,
@@ -273,17 +338,15 @@ public:
 		PUSHSLICE
 	};
 	PushCellOrSlice(Type type, std::string blob, Pointer<PushCellOrSlice> child) :
-		Gen{true}, // we don't execute data
+		Gen{Kind::PushCellOrSlice, 0, 1, true}, // we don't execute data
 		m_type{type},
 		m_blob{std::move(blob)},
 		m_child{std::move(child)}
 	{
 	}
 	void accept(TvmAstVisitor& _visitor) override;
-	bool operator==(TvmAstNode const&) const override;
-	bool operator<(TvmAstNode const&) const;
-	int take() const override { return 0; }
-	int ret() const override { return 1; }
+	bool equals(TvmAstNode const& _node) const override;
+	std::size_t computeHash() const override;
 	Type type() const  { return m_type; }
 	std::string const &blob() const { return m_blob; }
 	std::string chainBlob() const;
@@ -297,6 +360,7 @@ private:
 
 class CodeBlock : public TvmAstNode {
 public:
+	static bool classof(TvmAstNode const& _node) { return _node.kind() == Kind::CodeBlock; }
 	enum class Type {
 		None,
 		PUSHCONT,
@@ -304,17 +368,24 @@ public:
 	};
 	static std::string toString(Type t);
 	CodeBlock(Type type, std::vector<Pointer<TvmAstNode>> instructions = {}) :
-		m_type{type}, m_instructions(std::move(instructions)) {
+		TvmAstNode{Kind::CodeBlock}, m_type{type}, m_instructions(std::move(instructions)) {
 		for (const Pointer<TvmAstNode>& i : m_instructions) {
 			solAssert(i != nullptr, "");
 		}
 	}
 	void accept(TvmAstVisitor& _visitor) override;
-	bool operator==(TvmAstNode const&) const override;
+	bool equals(TvmAstNode const& _node) const override;
+	std::size_t computeHash() const override;
 	Type type() const { return m_type; }
 	std::vector<Pointer<TvmAstNode>> const& instructions() const { return m_instructions; }
-	void upd(std::vector<Pointer<TvmAstNode>> instructions) { m_instructions = std::move(instructions); }
-	void updType(Type type) { m_type = type; }
+	void upd(std::vector<Pointer<TvmAstNode>> instructions) {
+		m_instructions = std::move(instructions);
+		invalidateHashes();
+	}
+	void updType(Type type) {
+		m_type = type;
+		invalidateHashes();
+	}
 private:
 	Type m_type;
 	std::vector<Pointer<TvmAstNode>> m_instructions;
@@ -322,23 +393,19 @@ private:
 
 class SubProgram : public Gen {
 public:
+	static bool classof(TvmAstNode const& _node) { return _node.kind() == Kind::SubProgram; }
 	SubProgram(int take, int ret, bool _isJmp, Pointer<CodeBlock> const &_block, bool isPure) :
-		Gen{isPure},
-		m_take{take},
-		m_ret{ret},
+		Gen{Kind::SubProgram, take, ret, isPure},
 		m_isJmp{_isJmp},
 		m_block{_block}
 	{
 	}
 	void accept(TvmAstVisitor &_visitor) override;
-	bool operator==(TvmAstNode const&) const override;
-	int take() const override { return  m_take; }
-	int ret() const override { return m_ret; }
+	bool equals(TvmAstNode const& _node) const override;
+	std::size_t computeHash() const override;
 	Pointer<CodeBlock> const &block() const { return m_block; }
 	bool isJmp() const { return m_isJmp; }
 private:
-	int m_take{};
-	int m_ret{};
 	bool m_isJmp{};
 	Pointer<CodeBlock> m_block;
 };
@@ -346,17 +413,20 @@ private:
 // Take one value from stack and return one
 class LogCircuit : public TvmAstNode {
 public:
+	static bool classof(TvmAstNode const& _node) { return _node.kind() == Kind::LogCircuit; }
 	enum class Type {
 		AND,
 		OR
 	};
 	LogCircuit(Type type, Pointer<CodeBlock> const &body) :
+		TvmAstNode{Kind::LogCircuit},
 		m_type{type},
 		m_body{body}
 	{
 	}
 	void accept(TvmAstVisitor& _visitor) override;
-	bool operator==(TvmAstNode const&) const override;
+	bool equals(TvmAstNode const& _node) const override;
+	std::size_t computeHash() const override;
 	Type type() const { return m_type; }
 	Pointer<CodeBlock> const &body() const { return m_body; }
 private:
@@ -366,35 +436,36 @@ private:
 
 class TvmIfElse : public Gen {
 public:
+	static bool classof(TvmAstNode const& _node) { return _node.kind() == Kind::TvmIfElse; }
 	TvmIfElse(bool _withNot, bool _withJmp,
 			  Pointer<CodeBlock> const &trueBody,
 			  Pointer<CodeBlock> const &falseBody,
 			  int ret);
 	void accept(TvmAstVisitor& _visitor) override;
-	bool operator==(TvmAstNode const&) const override;
+	bool equals(TvmAstNode const& _node) const override;
+	std::size_t computeHash() const override;
 	bool withNot() const { return m_withNot; }
 	bool withJmp() const { return m_withJmp; }
 	Pointer<CodeBlock> const& trueBody() const { return m_trueBody; }
 	Pointer<CodeBlock> const& falseBody() const { return m_falseBody; }
-	int take() const override { return 1; }
-	int ret() const override { return m_ret; }
 private:
 	bool m_withNot{};
 	bool m_withJmp{};
 	Pointer<CodeBlock> m_trueBody;
 	Pointer<CodeBlock> m_falseBody; // nullptr for if-statement
-	int m_ret{};
 };
 
 class TvmRepeat : public TvmAstNode {
 public:
+	static bool classof(TvmAstNode const& _node) { return _node.kind() == Kind::TvmRepeat; }
 	explicit TvmRepeat(bool _withBreakOrReturn, Pointer<CodeBlock> const &body) :
+		TvmAstNode{Kind::TvmRepeat},
 		m_withBreakOrReturn{_withBreakOrReturn},
 		m_body(body)
 	{
 	}
 	void accept(TvmAstVisitor& _visitor) override;
-	bool operator==(TvmAstNode const&) const override { return false; } // TODO
+	bool equals(TvmAstNode const&) const override { return false; } // TODO
 	bool withBreakOrReturn() const { return m_withBreakOrReturn; }
 	Pointer<CodeBlock> const& body() const { return m_body; }
 private:
@@ -404,11 +475,13 @@ private:
 
 class TvmUntil : public TvmAstNode {
 public:
+	static bool classof(TvmAstNode const& _node) { return _node.kind() == Kind::TvmUntil; }
 	explicit TvmUntil(bool _withBreakOrReturn, Pointer<CodeBlock> const &body) :
+		TvmAstNode{Kind::TvmUntil},
 		m_withBreakOrReturn{_withBreakOrReturn},
 		m_body(body) { }
 	void accept(TvmAstVisitor& _visitor) override;
-	bool operator==(TvmAstNode const&) const override { return false; } // TODO
+	bool equals(TvmAstNode const&) const override { return false; } // TODO
 	bool withBreakOrReturn() const { return m_withBreakOrReturn; }
 	Pointer<CodeBlock> const& body() const { return m_body; }
 private:
@@ -418,15 +491,17 @@ private:
 
 class While : public TvmAstNode {
 public:
+	static bool classof(TvmAstNode const& _node) { return _node.kind() == Kind::While; }
 	While(bool _infinite, bool _withBreakOrReturn, Pointer<CodeBlock> const &condition,
 		  Pointer<CodeBlock> const &body
 	) :
+		TvmAstNode{Kind::While},
 		m_infinite{_infinite},
 		m_withBreakOrReturn{_withBreakOrReturn},
 		m_condition{condition},
 		m_body(body) { }
 	void accept(TvmAstVisitor& _visitor) override;
-	bool operator==(TvmAstNode const&) const override { return false; } // TODO
+	bool equals(TvmAstNode const&) const override { return false; } // TODO
 	Pointer<CodeBlock> const& condition() const { return m_condition; }
 	Pointer<CodeBlock> const& body() const { return m_body; }
 	bool isInfinite() const { return m_infinite; }
@@ -440,13 +515,15 @@ private:
 
 class TryCatch : public TvmAstNode {
 public:
+	static bool classof(TvmAstNode const& _node) { return _node.kind() == Kind::TryCatch; }
 	TryCatch(Pointer<CodeBlock> _tryBody, Pointer<CodeBlock> _catchBody, bool _saveAltC2) :
+		TvmAstNode{Kind::TryCatch},
 		m_tryBody{std::move(_tryBody)},
 		m_catchBody{std::move(_catchBody)},
 		m_saveAltC2{_saveAltC2}
 	{}
 	void accept(TvmAstVisitor& _visitor) override;
-	bool operator==(TvmAstNode const&) const override { return false; } // TODO
+	bool equals(TvmAstNode const&) const override { return false; } // TODO
 Pointer <CodeBlock> const& tryBody() const { return m_tryBody; }
 	Pointer <CodeBlock> const& catchBody() const { return m_catchBody; }
 	bool saveAltC2() const { return m_saveAltC2; }
@@ -458,6 +535,7 @@ private:
 
 class Function : public TvmAstNode {
 public:
+	static bool classof(TvmAstNode const& _node) { return _node.kind() == Kind::Function; }
 	enum class FunctionType {
 		PrivateFunctionWithObj,
 		Fragment,
@@ -470,7 +548,7 @@ public:
 	Function(int take, int ret, std::string name, std::optional<uint32_t> functionId, FunctionType type, Pointer<CodeBlock> block,
 			 FunctionDefinition const* _function = {});
 	void accept(TvmAstVisitor& _visitor) override;
-	bool operator==(TvmAstNode const&) const override { return false; } // TODO
+	bool equals(TvmAstNode const&) const override { return false; } // TODO
 	int take() const { return m_take; }
 	int ret() const { return m_ret; }
 	std::string const& name() const { return m_name; }
@@ -490,6 +568,7 @@ private:
 
 class Contract : public TvmAstNode {
 public:
+	static bool classof(TvmAstNode const& _node) { return _node.kind() == Kind::Contract; }
 	explicit Contract(
 		bool _isLib,
 		bool _saveAllFunction,
@@ -499,6 +578,7 @@ public:
 		std::vector<Pointer<Function>> functions,
 		std::map<uint32_t, std::string> _privateFunctions
 	) :
+		TvmAstNode{Kind::Contract},
 		m_isLib{_isLib},
 		m_saveAllFunction{_saveAllFunction},
 		m_upgradeFunc{_upgradeFunc},
@@ -509,7 +589,7 @@ public:
 	{
 	}
 	void accept(TvmAstVisitor& _visitor) override;
-	bool operator==(TvmAstNode const&) const override { return false; } // TODO
+	bool equals(TvmAstNode const&) const override { return false; } // TODO
 	bool isLib() const { return m_isLib; }
 	bool saveAllFunction() const { return m_saveAllFunction; }
 	bool upgradeFunc() const { return m_upgradeFunc; }
@@ -527,6 +607,46 @@ private:
 	std::map<uint32_t, std::string> m_privateFunctions;
 };
 
+/// LLVM-style checks and casts of nodes. They compare the kind of the node instead of using RTTI,
+/// the pointer versions accept nullptr.
+template<class T>
+bool isa(TvmAstNode const& _node) { return T::classof(_node); }
+
+template<class T>
+bool isa(TvmAstNode const* _node) { return _node && T::classof(*_node); }
+
+template<class T, class U>
+bool isa(Pointer<U> const& _node) { return isa<T>(_node.get()); }
+
+template<class T>
+T const& cast(TvmAstNode const& _node) {
+	solAssert(isa<T>(_node), "");
+	return static_cast<T const&>(_node);
+}
+
+template<class T>
+T const* dyn_cast(TvmAstNode const* _node) { return isa<T>(_node) ? static_cast<T const*>(_node) : nullptr; }
+
+template<class T>
+T* dyn_cast(TvmAstNode* _node) { return isa<T>(_node) ? static_cast<T*>(_node) : nullptr; }
+
+template<class T, class U>
+Pointer<T> dyn_cast(Pointer<U> const& _node) { return isa<T>(_node) ? std::static_pointer_cast<T>(_node) : nullptr; }
+
+/**
+ * Hash-consing table: keeps one node of each set of structurally equal nodes, so equal subtrees
+ * found anywhere in a contract can be shared. The nodes must not change while they are in the table.
+ */
+class TvmAstNodeTable {
+public:
+	/// @returns the node equal to @a _node added earlier, or adds @a _node and returns it.
+	Pointer<TvmAstNode> const& intern(Pointer<TvmAstNode> const& _node);
+	/// @returns the number of distinct nodes in the table.
+	size_t size() const { return m_nodes.size(); }
+private:
+	std::unordered_multimap<std::size_t, Pointer<TvmAstNode>> m_nodes;
+};
+
 Pointer<StackOpcode> gen(const std::string& cmd);
 Pointer<PushCellOrSlice> genPushSlice(const std::string& _str);
 Pointer<PushCellOrSlice> makePushCellOrSlice(std::string const& hexStr, bool toSlice);
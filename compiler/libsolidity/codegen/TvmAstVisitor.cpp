@@ -869,8 +869,8 @@ bool LocSquasher::visit(CodeBlock &_node) {
 		if (!a.empty()) {
 			b.push_back(a.front());
 			for (size_t i = 1; i < a.size(); ++i) {
-				if (!b.empty() && dynamic_cast<Loc const *>(b.back().get()) &&
-					dynamic_cast<Loc const *>(a[i].get()))
+				if (!b.empty() && isa<Loc>(b.back().get()) &&
+					dyn_cast<Loc>(a[i].get()))
 					b.pop_back();
 				b.push_back(a[i]);
 			}
@@ -882,7 +882,7 @@ bool LocSquasher::visit(CodeBlock &_node) {
 	std::vector<Pointer<TvmAstNode>> res;
 	std::optional<Pointer<Loc>> lastLoc;
 	for (const Pointer<TvmAstNode>& node : res0) {
-		auto loc = std::dynamic_pointer_cast<Loc>(node);
+		auto loc = dyn_cast<Loc>(node);
 		if (loc) {
 			if (!lastLoc || std::make_pair(lastLoc.value()->file(), lastLoc.value()->line()) !=
 							std::make_pair(loc->file(), loc->line())) {
@@ -905,16 +905,16 @@ void DeleterAfterRet::endVisit(CodeBlock &_node) {
 	bool didFind{};
 	std::vector<Pointer<TvmAstNode>> newInstrs;
 	for (Pointer<TvmAstNode> const& opcode : _node.instructions()) {
-		auto ret = to<ReturnOrBreakOrCont>(opcode.get());
-		auto ifElse = to<TvmIfElse>(opcode.get());
+		auto ret = dyn_cast<ReturnOrBreakOrCont>(opcode.get());
+		auto ifElse = dyn_cast<TvmIfElse>(opcode.get());
 		bool ifElseWithJmp = ifElse && ifElse->falseBody() != nullptr && ifElse->withJmp();
-		auto _throw = to<TvmException>(opcode.get());
+		auto _throw = dyn_cast<TvmException>(opcode.get());
 		bool th = _throw && !_throw->withIf();
 		if (!didFind && (ret || ifElseWithJmp || th)) {
 			didFind = true;
 			newInstrs.emplace_back(opcode);
 		} else {
-			if (!didFind || to<Loc>(opcode.get())) {
+			if (!didFind || isa<Loc>(opcode.get())) {
 				newInstrs.emplace_back(opcode);
 			}
 		}
@@ -928,9 +928,9 @@ bool DeleterCallX::visit(Function &_node) {
 	if (qtyWithoutLoc(inst) == 1) {
 		std::vector<Pointer<TvmAstNode>> newCmds;
 		for (Pointer<TvmAstNode> const& op : inst) {
-			if (to<Loc>(op.get())) {
+			if (isa<Loc>(op.get())) {
 				newCmds.emplace_back(op);
-			} else if (auto sub = to<SubProgram>(op.get()); sub) {
+			} else if (auto sub = dyn_cast<SubProgram>(op.get()); sub) {
 				newCmds.insert(newCmds.end(), sub->block()->instructions().begin(), sub->block()->instructions().end());
 			} else {
 				return false;
@@ -944,7 +944,7 @@ bool DeleterCallX::visit(Function &_node) {
 void LogCircuitExpander::endVisit(CodeBlock &_node) {
 	std::vector<Pointer<TvmAstNode>> block;
 	for (Pointer<TvmAstNode> const& opcode : _node.instructions()) {
-		auto lc = to<LogCircuit>(opcode.get());
+		auto lc = dyn_cast<LogCircuit>(opcode.get());
 		if (lc) {
 			m_stackSize = 1;
 			m_newInst = {};
@@ -956,7 +956,7 @@ void LogCircuitExpander::endVisit(CodeBlock &_node) {
 					solAssert(isDrop(inst.at(i)).value() == 1, "");
 					continue;
 				}
-				if (to<LogCircuit>(op.get()) && i + 1 != inst.size()) {
+				if (isa<LogCircuit>(op.get()) && i + 1 != inst.size()) {
 					isPure = false; // never happens
 				}
 
@@ -965,9 +965,9 @@ void LogCircuitExpander::endVisit(CodeBlock &_node) {
 			if (isPure) {
 				solAssert(m_stackSize == 2, "");
 				Pointer<TvmAstNode> tail = m_newInst.back();
-				bool hasTailLogCircuit = !m_newInst.empty() && to<LogCircuit>(m_newInst.back().get());
+				bool hasTailLogCircuit = !m_newInst.empty() && isa<LogCircuit>(m_newInst.back().get());
 				if (hasTailLogCircuit) {
-					if (to<LogCircuit>(m_newInst.back().get())->type() != lc->type()) {
+					if (cast<LogCircuit>(*m_newInst.back()).type() != lc->type()) {
 						block.emplace_back(opcode);
 						continue;
 					}
@@ -999,14 +999,14 @@ void LogCircuitExpander::endVisit(CodeBlock &_node) {
 }
 
 bool LogCircuitExpander::isPureOperation(Pointer<TvmAstNode> const& op) {
-	auto gen = to<Gen>(op.get());
+	auto gen = dyn_cast<Gen>(op.get());
 	if (gen && gen->isPure()) {
 		m_newInst.emplace_back(op);
 		m_stackSize += -gen->take() + gen->ret();
 		return true;
 	}
 
-	if (to<LogCircuit>(op.get())) {
+	if (isa<LogCircuit>(op.get())) {
 		m_newInst.emplace_back(op);
 		m_stackSize += -2 + 1;
 		return true;
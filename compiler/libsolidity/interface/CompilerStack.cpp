@@ -81,16 +81,21 @@
 
 #include <fmt/format.h>
 
+#include <condition_variable>
 #include <utility>
 #include <map>
 #include <limits>
+#include <mutex>
 #include <string>
+#include <thread>
 
 #include <libsolidity/codegen/TVM.hpp>
 #include <libsolidity/codegen/TVMTypeChecker.hpp>
 #include <libsolidity/codegen/TVMABI.hpp>
+#include <libsolidity/codegen/TVMCodeMetrics.hpp>
 #include <libsolidity/codegen/TvmAstVisitor.hpp>
 #include <libsolidity/codegen/TVMContractCompiler.hpp>
+#include <libsolidity/codegen/PeepholeOptimizer.hpp>
 
 using namespace solidity;
 using namespace solidity::langutil;
@@ -103,28 +108,36 @@ using solidity::util::errinfo_comment;
 
 using solidity::util::h256;
 
-static int g_compilerStackCounts = 0;
-
 using namespace solidity::langutil;
 
 #include <stdlib.h>
 
 CompilerStack::CompilerStack(ReadCallback::Callback _readFile):
+	m_typeProvider{std::make_unique<TypeProvider>()},
 	m_readFile{std::move(_readFile)},
 	m_errorReporter{m_errorList}
 {
-	// Because TypeProvider is currently a singleton API, we must ensure that
-	// no more than one entity is actually using it at a time.
-	solAssert(g_compilerStackCounts == 0, "You shall not have another CompilerStack aside me.");
-	++g_compilerStackCounts;
-	GlobalParams::g_errorReporter = &m_errorReporter;
-	GlobalParams::g_charStreamProvider = this;
+	activate();
 }
 
 CompilerStack::~CompilerStack()
 {
-	--g_compilerStackCounts;
-	TypeProvider::reset();
+	if (GlobalParams::g_charStreamProvider == this)
+	{
+		GlobalParams::g_errorReporter = nullptr;
+		GlobalParams::g_charStreamProvider = nullptr;
+		GlobalParams::g_tvmVersion.reset();
+	}
+}
+
+void CompilerStack::activate() const
+{
+	// Activating does not change the compilation, the parameters only refer to it.
+	CompilerStack& self = const_cast<CompilerStack&>(*this);
+	TypeProvider::select(self.m_typeProvider.get());
+	GlobalParams::g_errorReporter = &self.m_errorReporter;
+	GlobalParams::g_charStreamProvider = &self;
+	GlobalParams::g_tvmVersion = m_tvmVersion;
 }
 
 void CompilerStack::createAndAssignCallGraphs()
@@ -246,8 +259,28 @@ void CompilerStack::setTVMVersion(langutil::TVMVersion _version)
 	if (m_stackState >= ParsedAndImported)
 		solThrow(CompilerError, "Must set TVM version before parsing.");
 	m_tvmVersion = _version;
+	activate();
+}
 
-	GlobalParams::g_tvmVersion = m_tvmVersion;
+void CompilerStack::setAnalysisThreadCount(unsigned _threadCount)
+{
+	if (m_stackState >= ParsedAndImported)
+		solThrow(CompilerError, "Must set the number of analysis threads before parsing.");
+	m_analysisThreadCount = std::max(_threadCount, 1u);
+}
+
+void CompilerStack::setAnalyzeReachableOnly(bool _reachableOnly)
+{
+	if (m_stackState >= ParsedAndImported)
+		solThrow(CompilerError, "Must set the analysis of reachable sources before parsing.");
+	m_analyzeReachableOnly = _reachableOnly;
+}
+
+void CompilerStack::setASTArenaAllocation(bool _arenaAllocation)
+{
+	if (m_stackState >= ParsedAndImported)
+		solThrow(CompilerError, "Must set the AST arena allocation before parsing.");
+	m_astArenaAllocation = _arenaAllocation;
 }
 
 void CompilerStack::setLibraries(std::map<std::string, util::h160> const& _libraries)
@@ -310,12 +343,18 @@ void CompilerStack::reset(bool _keepSettings)
 		m_metadataFormat = defaultMetadataFormat();
 		m_metadataHash = MetadataHash::IPFS;
 		m_stopAfter = State::CompilationSuccessful;
+		m_analysisThreadCount = 1;
+		m_analyzeReachableOnly = false;
+		m_astArenaAllocation = false;
+		m_cancelled = nullptr;
+		m_deadline.reset();
 	}
 	m_experimentalAnalysis.reset();
 	m_globalContext.reset();
 	m_sourceOrder.clear();
 	m_contracts.clear();
 	m_errorReporter.clear();
+	activate();
 	TypeProvider::reset();
 }
 
@@ -325,8 +364,8 @@ void CompilerStack::setSources(StringMap _sources)
 		solThrow(CompilerError, "Cannot change sources once set.");
 	if (m_stackState != Empty)
 		solThrow(CompilerError, "Must set sources before parsing.");
-	for (auto source: _sources)
-		m_sources[source.first].charStream = std::make_unique<CharStream>(/*content*/std::move(source.second), /*name*/source.first);
+	for (auto& [name, content]: _sources)
+		m_sources[name].charStream = std::make_shared<CharStream>(/*content*/std::move(content), /*name*/name);
 	m_stackState = SourcesSet;
 }
 
@@ -334,9 +373,10 @@ bool CompilerStack::parse()
 {
 	if (m_stackState != SourcesSet)
 		solThrow(CompilerError, "Must call parse only after the SourcesSet state.");
+	activate();
 	m_errorReporter.clear();
 
-	Parser parser{m_errorReporter, m_evmVersion};
+	Parser parser{m_errorReporter, m_evmVersion, m_astArenaAllocation};
 
 	std::vector<std::string> sourcesToParse;
 	for (auto const& s: m_sources)
@@ -344,6 +384,8 @@ bool CompilerStack::parse()
 
 	for (size_t i = 0; i < sourcesToParse.size(); ++i)
 	{
+		if (cancelled())
+			return false;
 		std::string const& path = sourcesToParse[i];
 		Source& source = m_sources[path];
 		source.ast = parser.parse(*source.charStream);
@@ -360,8 +402,9 @@ bool CompilerStack::parse()
 				auto it = stdlib::sources.find(import->path());
 				if (it != stdlib::sources.end())
 				{
-					auto [name, content] = *it;
-					m_sources[name].charStream = std::make_unique<CharStream>(content, name);
+					// The standard library sources are static, so they do not need to be copied.
+					auto const& [name, content] = *it;
+					m_sources[name].charStream = std::make_shared<CharStream>(std::string_view{content}, nullptr, name);
 					sourcesToParse.push_back(name);
 				}
 
@@ -375,11 +418,9 @@ bool CompilerStack::parse()
 			}
 
 			if (m_stopAfter >= ParsedAndImported)
-				for (auto const& newSource: loadMissingSources(*source.ast))
+				for (auto& [newPath, newCharStream]: loadMissingSources(*source.ast))
 				{
-					std::string const& newPath = newSource.first;
-					std::string const& newContents = newSource.second;
-					m_sources[newPath].charStream = std::make_shared<CharStream>(newContents, newPath);
+					m_sources[newPath].charStream = std::move(newCharStream);
 					sourcesToParse.push_back(newPath);
 				}
 		}
@@ -401,6 +442,7 @@ void CompilerStack::importASTs(std::map<std::string, Json::Value> const& _source
 {
 	if (m_stackState != Empty)
 		solThrow(CompilerError, "Must call importASTs only before the SourcesSet state.");
+	activate();
 	std::map<std::string, ASTPointer<SourceUnit>> reconstructedSources = ASTJsonImporter(m_evmVersion).jsonToSourceUnit(_sources);
 	for (auto& src: reconstructedSources)
 	{
@@ -425,6 +467,7 @@ bool CompilerStack::analyze()
 {
 	if (m_stackState != ParsedAndImported)
 		solThrow(CompilerError, "Must call analyze only after parsing was successful.");
+	activate();
 
 	if (!resolveImports())
 		return false;
@@ -437,11 +480,11 @@ bool CompilerStack::analyze()
 
 	try
 	{
-		SyntaxChecker syntaxChecker(m_errorReporter);
 		bool experimentalSolidity = isExperimentalSolidity();
-		for (Source const* source: m_sourceOrder)
-			if (source->ast && !syntaxChecker.checkSyntax(*source->ast))
-				noErrors = false;
+		if (!runPerSource([](SourceUnit const& _sourceUnit, ErrorReporter& _errorReporter) {
+			return SyntaxChecker(_errorReporter).checkSyntax(_sourceUnit);
+		}))
+			noErrors = false;
 
 		m_globalContext = std::make_shared<GlobalContext>(m_evmVersion);
 		// We need to keep the same resolver during the whole process.
@@ -471,6 +514,9 @@ bool CompilerStack::analyze()
 			if (source->ast && !resolver.resolveNamesAndTypes(*source->ast))
 				return false;
 
+		if (m_analyzeReachableOnly && !experimentalSolidity)
+			restrictToReachableSources();
+
 		if (experimentalSolidity)
 		{
 			if (!analyzeExperimental())
@@ -526,18 +572,18 @@ bool CompilerStack::analyzeLegacy(bool _noErrorsSoFar)
 	//
 	// Note: this does not resolve overloaded functions. In order to do that, types of arguments are needed,
 	// which is only done one step later.
-	TypeChecker typeChecker(m_evmVersion, m_errorReporter);
-	for (Source const* source: m_sourceOrder)
-		if (source->ast && !typeChecker.checkTypeRequirements(*source->ast))
-			noErrors = false;
+	if (!runPerSource([&](SourceUnit const& _sourceUnit, ErrorReporter& _errorReporter) {
+		return TypeChecker(m_evmVersion, _errorReporter).checkTypeRequirements(_sourceUnit);
+	}))
+		noErrors = false;
 
 	if (noErrors)
 	{
 		// Requires ContractLevelChecker and TypeChecker
-		DocStringAnalyser docStringAnalyser(m_errorReporter);
-		for (Source const* source: m_sourceOrder)
-			if (source->ast && !docStringAnalyser.analyseDocStrings(*source->ast))
-				noErrors = false;
+		if (!runPerSource([](SourceUnit const& _sourceUnit, ErrorReporter& _errorReporter) {
+			return DocStringAnalyser(_errorReporter).analyseDocStrings(_sourceUnit);
+		}))
+			noErrors = false;
 	}
 
 	if (noErrors)
@@ -596,10 +642,10 @@ bool CompilerStack::analyzeLegacy(bool _noErrorsSoFar)
 	if (noErrors)
 	{
 		// Checks for common mistakes. Only generates warnings.
-		StaticAnalyzer staticAnalyzer(m_errorReporter);
-		for (Source const* source: m_sourceOrder)
-			if (source->ast && !staticAnalyzer.analyze(*source->ast))
-				noErrors = false;
+		if (!runPerSource([](SourceUnit const& _sourceUnit, ErrorReporter& _errorReporter) {
+			return StaticAnalyzer(_errorReporter).analyze(_sourceUnit);
+		}))
+			noErrors = false;
 	}
 
 	if (noErrors)
@@ -616,10 +662,10 @@ bool CompilerStack::analyzeLegacy(bool _noErrorsSoFar)
 
 	if (noErrors) {
 		// Check for TVM specific issues.
-		TVMAnalyzer tvmAnalyzer(m_errorReporter);
-		for (Source const* source: m_sourceOrder)
-			if (source->ast && !tvmAnalyzer.analyze(*source->ast))
-				noErrors = false;
+		if (!runPerSource([](SourceUnit const& _sourceUnit, ErrorReporter& _errorReporter) {
+			return TVMAnalyzer(_errorReporter).analyze(_sourceUnit);
+		}))
+			noErrors = false;
 	}
 
 	if (noErrors)
@@ -637,18 +683,196 @@ bool CompilerStack::analyzeLegacy(bool _noErrorsSoFar)
 
 		// Check for TVM specific issues.
 		// TODO merge TVMTypeChecker and TVMAnalyzer ?
-		for (Source const* source: m_sourceOrder) {
-			TVMTypeChecker checker(m_errorReporter);
-			source->ast->accept(checker);
-			if (m_errorReporter.hasErrors()) {
+		if (!runPerSource([](SourceUnit const& _sourceUnit, ErrorReporter& _errorReporter) {
+			TVMTypeChecker checker(_errorReporter);
+			_sourceUnit.accept(checker);
+			return !_errorReporter.hasErrors();
+		}))
+			noErrors = false;
+	}
+
+	return noErrors;
+}
+
+bool CompilerStack::runPerSource(std::function<bool(SourceUnit const&, ErrorReporter&)> const& _pass)
+{
+	std::vector<SourceUnit const*> sourceUnits;
+	for (Source const* source: m_sourceOrder)
+		if (source->ast)
+			sourceUnits.push_back(source->ast.get());
+
+	bool noErrors = true;
+	if (m_analysisThreadCount <= 1 || sourceUnits.size() <= 1)
+	{
+		for (SourceUnit const* sourceUnit: sourceUnits)
+			if (cancelled() || !_pass(*sourceUnit, m_errorReporter))
 				noErrors = false;
+		return noErrors;
+	}
+
+	// Annotations are created on first access. Create all of them up front,
+	// so that the threads below only ever read the annotation pointers.
+	SimpleASTVisitor annotationCreator{
+		[](ASTNode const& _node) { _node.annotation(); return true; },
+		[](ASTNode const&) {}
+	};
+	for (SourceUnit const* sourceUnit: sourceUnits)
+		sourceUnit->accept(annotationCreator);
+
+	// A source unit is checked only after all source units it imports are checked.
+	// Source units checked at the same time thus never see each other's partial results.
+	// Imports of source units that come later in m_sourceOrder are part of an import cycle and are ignored.
+	size_t const count = sourceUnits.size();
+	std::map<SourceUnit const*, size_t> indices;
+	for (size_t i = 0; i < count; ++i)
+		indices[sourceUnits[i]] = i;
+	std::vector<size_t> pendingImports(count, 0);
+	std::vector<std::vector<size_t>> importedBy(count);
+	for (size_t i = 0; i < count; ++i)
+		for (SourceUnit const* imported: sourceUnits[i]->referencedSourceUnits())
+			if (auto it = indices.find(imported); it != indices.end() && it->second < i)
+			{
+				++pendingImports[i];
+				importedBy[it->second].push_back(i);
+			}
+
+	std::vector<ErrorList> errors(count);
+	std::vector<char> success(count, false);
+	std::vector<std::exception_ptr> exceptions(count);
+	std::set<size_t> ready;
+	for (size_t i = 0; i < count; ++i)
+		if (pendingImports[i] == 0)
+			ready.insert(i);
+	// Index of the first source unit whose check threw. Later source units are not started anymore,
+	// since a serial run would not have reached them.
+	size_t firstFailure = count;
+	size_t running = 0;
+	std::mutex mutex;
+	std::condition_variable changed;
+
+	auto worker = [&]() {
+		TypeProvider::select(m_typeProvider.get());
+		GlobalParams::g_charStreamProvider = this;
+		GlobalParams::g_tvmVersion = m_tvmVersion;
+
+		std::unique_lock<std::mutex> lock(mutex);
+		while (true)
+		{
+			auto hasWork = [&]() { return !ready.empty() && *ready.begin() < firstFailure && !cancelled(); };
+			changed.wait(lock, [&]() { return hasWork() || running == 0; });
+			if (!hasWork())
+				break;
+
+			size_t const i = *ready.begin();
+			ready.erase(ready.begin());
+			++running;
+			lock.unlock();
+
+			ErrorReporter errorReporter(errors[i]);
+			GlobalParams::g_errorReporter = &errorReporter;
+			try
+			{
+				success[i] = _pass(*sourceUnits[i], errorReporter);
+			}
+			catch (...)
+			{
+				exceptions[i] = std::current_exception();
 			}
+			GlobalParams::g_errorReporter = nullptr;
+
+			lock.lock();
+			--running;
+			if (exceptions[i])
+				firstFailure = std::min(firstFailure, i);
+			else
+				for (size_t dependent: importedBy[i])
+					if (--pendingImports[dependent] == 0)
+						ready.insert(dependent);
+			changed.notify_all();
 		}
-	}
+	};
 
+	// Types are only locked while the threads below share them.
+	TypeProvider::setConcurrent(true);
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < std::min<size_t>(m_analysisThreadCount, count); ++i)
+		threads.emplace_back(worker);
+	for (std::thread& thread: threads)
+		thread.join();
+	TypeProvider::setConcurrent(false);
+
+	// Report in source order, exactly as a serial run would.
+	for (size_t i = 0; i < count && i <= firstFailure; ++i)
+	{
+		m_errorReporter.append(errors[i]);
+		if (exceptions[i])
+			std::rethrow_exception(exceptions[i]);
+		if (!success[i])
+			noErrors = false;
+	}
 	return noErrors;
 }
 
+void CompilerStack::restrictToReachableSources()
+{
+	auto root = m_sources.find(m_inputFile);
+	if (root == m_sources.end() || !root->second.ast)
+		return;
+
+	std::set<SourceUnit const*> reachable;
+	std::vector<SourceUnit const*> toVisit;
+	auto addSourceUnit = [&](SourceUnit const* _sourceUnit) {
+		if (_sourceUnit && reachable.insert(_sourceUnit).second)
+			toVisit.push_back(_sourceUnit);
+	};
+	auto addDeclaration = [&](Declaration const* _declaration) {
+		// Magic variables have no scope.
+		if (!_declaration || !_declaration->scope())
+			return;
+		// Members of a unit alias are only resolved by the type checker, so the whole unit is needed.
+		if (auto import = dynamic_cast<ImportDirective const*>(_declaration))
+			addSourceUnit(import->annotation().sourceUnit);
+		addSourceUnit(&_declaration->sourceUnit());
+	};
+
+	// Bases, libraries, free functions and types are all referenced by name, so the
+	// references resolved so far are enough to find every source the input file depends on.
+	SimpleASTVisitor referenceCollector{
+		[&](ASTNode const& _node) {
+			if (auto identifier = dynamic_cast<Identifier const*>(&_node))
+			{
+				addDeclaration(identifier->annotation().referencedDeclaration);
+				for (Declaration const* declaration: identifier->annotation().candidateDeclarations)
+					addDeclaration(declaration);
+				for (Declaration const* declaration: identifier->annotation().overloadedDeclarations)
+					addDeclaration(declaration);
+			}
+			else if (auto path = dynamic_cast<IdentifierPath const*>(&_node))
+				for (Declaration const* declaration: path->annotation().pathDeclarations)
+					addDeclaration(declaration);
+			return true;
+		},
+		[](ASTNode const&) {}
+	};
+
+	addSourceUnit(root->second.ast.get());
+	while (!toVisit.empty())
+	{
+		SourceUnit const* sourceUnit = toVisit.back();
+		toVisit.pop_back();
+		sourceUnit->accept(referenceCollector);
+	}
+
+	std::vector<Source const*> sourceOrder;
+	for (Source const* source: m_sourceOrder)
+		if (reachable.count(source->ast.get()))
+			sourceOrder.push_back(source);
+		else if (source->ast)
+			for (ContractDefinition const* contract: ASTNode::filteredNodes<ContractDefinition>(source->ast->nodes()))
+				m_contracts.erase(contract->fullyQualifiedName());
+	swap(m_sourceOrder, sourceOrder);
+}
+
 bool CompilerStack::analyzeExperimental()
 {
 	solAssert(!m_experimentalAnalysis);
@@ -783,6 +1007,7 @@ CompilerStack::findMainContract() {
 
 std::pair<bool, bool> CompilerStack::compile(bool json)
 {
+	activate();
 	bool didCompileSomething{};
 	if (m_stackState < AnalysisSuccessful)
 		if (!parseAndAnalyze())
@@ -809,13 +1034,29 @@ std::pair<bool, bool> CompilerStack::compile(bool json)
 							c.abi = std::make_unique<Json::Value>(abi);
 						}
 						if (m_generateCode) {
-							Pointer<solidity::frontend::Contract> codeContract =
-								TVMContractCompiler::generateContractCode(targetContract, getSourceUnits(), pragmaHelper);
+							std::optional<PeepholeStats> optimizerStats;
+							if (m_generateOptimizerStats)
+								optimizerStats.emplace();
+							Pointer<solidity::frontend::Contract> codeContract = TVMContractCompiler::generateContractCode(
+								targetContract,
+								getSourceUnits(),
+								pragmaHelper,
+								optimizerStats ? &*optimizerStats : nullptr
+							);
+							if (optimizerStats)
+								c.optimizerStats = std::make_unique<Json::Value>(optimizerStats->toJson());
 							std::ostringstream out;
 							Printer p{out};
 							codeContract->accept(p);
 							Json::Value code = Json::Value(out.str());
 							c.code = std::make_unique<Json::Value>(code);
+							if (m_generateCodeMetrics || m_generateGasEstimates) {
+								TVMCodeMetrics const metrics{*codeContract};
+								if (m_generateCodeMetrics)
+									c.codeMetrics = std::make_unique<Json::Value>(metrics.codeMetricsJson());
+								if (m_generateGasEstimates)
+									c.gasEstimates = std::make_unique<Json::Value>(metrics.gasEstimatesJson());
+							}
 						}
 						if (m_doPrintFunctionIds)
 						{
@@ -859,6 +1100,27 @@ std::pair<bool, bool> CompilerStack::compile(bool json)
 	return {true, didCompileSomething};
 }
 
+std::shared_ptr<frontend::Contract> CompilerStack::generateCode(ContractDefinition const& _contract)
+{
+	activate();
+	if (m_stackState < AnalysisSuccessful || m_hasError)
+		solThrow(CompilerError, "Analysis was not successful.");
+
+	std::vector<PragmaDirective const *> pragmaDirectives = getPragmaDirectives(&source(_contract.sourceUnitName()));
+	PragmaDirectiveHelper pragmaHelper{pragmaDirectives};
+	try {
+		return TVMContractCompiler::generateContractCode(
+			&_contract,
+			getSourceUnits(),
+			pragmaHelper,
+			nullptr,
+			[this]() { return cancelled(); }
+		);
+	} catch (FatalError const &) {
+		return nullptr;
+	}
+}
+
 void CompilerStack::link()
 {
 	solAssert(m_stackState >= CompilationSuccessful, "");
@@ -933,6 +1195,16 @@ std::string const& CompilerStack::yulIROptimized(std::string const& _contractNam
 }
 
 
+CompilerStack::State CompilerStack::sourceState(std::string const& _sourceName) const
+{
+	if (m_stackState <= ParsedAndImported)
+		return m_stackState;
+	Source const* analyzedSource = &source(_sourceName);
+	if (std::find(m_sourceOrder.begin(), m_sourceOrder.end(), analyzedSource) == m_sourceOrder.end())
+		return ParsedAndImported;
+	return m_stackState;
+}
+
 std::vector<std::string> CompilerStack::sourceNames() const
 {
 	return ranges::to<std::vector>(m_sources | ranges::views::keys);
@@ -988,6 +1260,24 @@ Json::Value const& CompilerStack::privateFunctionIds(std::string const& _contrac
 	return c.privateFunctionIds ? *c.privateFunctionIds : Json::Value::null;
 }
 
+Json::Value const& CompilerStack::codeMetrics(std::string const& _contractName) const
+{
+	Contract const &c = contract(_contractName);
+	return c.codeMetrics ? *c.codeMetrics : Json::Value::null;
+}
+
+Json::Value const& CompilerStack::gasEstimates(std::string const& _contractName) const
+{
+	Contract const &c = contract(_contractName);
+	return c.gasEstimates ? *c.gasEstimates : Json::Value::null;
+}
+
+Json::Value const& CompilerStack::optimizerStats(std::string const& _contractName) const
+{
+	Contract const &c = contract(_contractName);
+	return c.optimizerStats ? *c.optimizerStats : Json::Value::null;
+}
+
 Json::Value const& CompilerStack::natspecUser(std::string const& _contractName) const
 {
 	if (m_stackState < AnalysisSuccessful)
@@ -1004,6 +1294,7 @@ Json::Value const& CompilerStack::natspecUser(Contract const& _contract) const
 	solAssert(_contract.contract, "");
 	solUnimplementedAssert(!isExperimentalSolidity());
 
+	activate();
 	return _contract.userDocumentation.init([&]{ return Natspec::userDocumentation(*_contract.contract); });
 }
 
@@ -1024,6 +1315,7 @@ Json::Value const& CompilerStack::natspecDev(Contract const& _contract) const
 
 	solUnimplementedAssert(!isExperimentalSolidity());
 
+	activate();
 	return _contract.devDocumentation.init([&]{ return Natspec::devDocumentation(*_contract.contract); });
 }
 
@@ -1034,6 +1326,7 @@ Json::Value CompilerStack::interfaceSymbols(std::string const& _contractName) co
 
 	solUnimplementedAssert(!isExperimentalSolidity());
 
+	activate();
 	Json::Value interfaceSymbols(Json::objectValue);
 	// Always have a methods object
 	interfaceSymbols["methods"] = Json::objectValue;
@@ -1064,6 +1357,7 @@ bytes CompilerStack::cborMetadata(std::string const& _contractName, bool _forIR)
 	if (m_stackState < AnalysisSuccessful)
 		solThrow(CompilerError, "Analysis was not successful.");
 
+	activate();
 	return createCBORMetadata(contract(_contractName), _forIR);
 }
 
@@ -1076,6 +1370,7 @@ std::string const& CompilerStack::metadata(Contract const& _contract) const
 
 	solUnimplementedAssert(!isExperimentalSolidity());
 
+	activate();
 	return _contract.metadata.init([&]{ return createMetadata(_contract, m_viaIR); });
 }
 
@@ -1126,28 +1421,28 @@ size_t CompilerStack::functionEntryPoint(
 h256 const& CompilerStack::Source::keccak256() const
 {
 	if (keccak256HashCached == h256{})
-		keccak256HashCached = util::keccak256(charStream->source());
+		keccak256HashCached = util::keccak256(std::string(charStream->source()));
 	return keccak256HashCached;
 }
 
 h256 const& CompilerStack::Source::swarmHash() const
 {
 	if (swarmHashCached == h256{})
-		swarmHashCached = util::bzzr1Hash(charStream->source());
+		swarmHashCached = util::bzzr1Hash(std::string(charStream->source()));
 	return swarmHashCached;
 }
 
 std::string const& CompilerStack::Source::ipfsUrl() const
 {
 	if (ipfsUrlCached.empty())
-		ipfsUrlCached = "dweb:/ipfs/" + util::ipfsHashBase58(charStream->source());
+		ipfsUrlCached = "dweb:/ipfs/" + util::ipfsHashBase58(std::string(charStream->source()));
 	return ipfsUrlCached;
 }
 
-StringMap CompilerStack::loadMissingSources(SourceUnit const& _ast)
+std::map<std::string, std::shared_ptr<CharStream>> CompilerStack::loadMissingSources(SourceUnit const& _ast)
 {
 	solAssert(m_stackState < ParsedAndImported, "");
-	StringMap newSources;
+	std::map<std::string, std::shared_ptr<CharStream>> newSources;
 	try
 	{
 		for (auto const& node: _ast.nodes())
@@ -1162,8 +1457,10 @@ StringMap CompilerStack::loadMissingSources(SourceUnit const& _ast)
 				if (m_readFile)
 					result = m_readFile(ReadCallback::kindString(ReadCallback::Kind::ReadFile), importPath);
 
-				if (result.success)
-					newSources[importPath] = result.responseOrErrorMessage;
+				if (result.success && result.contents)
+					newSources[importPath] = std::make_shared<CharStream>(result.contents->text(), result.contents, importPath);
+				else if (result.success)
+					newSources[importPath] = std::make_shared<CharStream>(std::move(result.responseOrErrorMessage), importPath);
 				else
 				{
 					m_errorReporter.parserError(
@@ -1376,7 +1673,7 @@ std::string CompilerStack::createMetadata(Contract const& _contract, bool _forIR
 		if (std::optional<std::string> licenseString = s.second.ast->licenseString())
 			meta["sources"][s.first]["license"] = *licenseString;
 		if (m_metadataLiteralSources)
-			meta["sources"][s.first]["content"] = s.second.charStream->source();
+			meta["sources"][s.first]["content"] = std::string(s.second.charStream->source());
 		else
 		{
 			meta["sources"][s.first]["urls"] = Json::arrayValue;
@@ -46,8 +46,11 @@
 
 #include <json/json.h>
 
+#include <atomic>
+#include <chrono>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <ostream>
 #include <set>
 #include <string>
@@ -63,12 +66,14 @@ namespace solidity::frontend
 
 // forward declarations
 class ASTNode;
+class Contract;
 class ContractDefinition;
 class FunctionDefinition;
 class SourceUnit;
 class Compiler;
 class GlobalContext;
 class Natspec;
+class TypeProvider;
 class DeclarationContainer;
 class PragmaDirective;
 namespace experimental
@@ -129,8 +134,18 @@ public:
 	/// @returns the current state.
 	State state() const { return m_stackState; }
 
+	/// @returns the state of the AST of @a _sourceName. Sources that were not analyzed,
+	/// e.g. because they are not reachable from the input file, stay parsed and imported.
+	State sourceState(std::string const& _sourceName) const;
+
 	virtual bool compilationSuccessful() const { return m_stackState >= CompilationSuccessful; }
 
+	/// Makes the type provider and the codegen parameters of this compilation current on the calling thread.
+	/// Several compilations can run at the same time if each of them is used on its own thread.
+	/// Has to be called before the AST of a compilation that ran on another thread is used.
+	/// The getters of artifacts that are created on demand call it themselves.
+	void activate() const;
+
 	/// Resets the compiler to an empty state. Unless @a _keepSettings is set to true,
 	/// all settings are reset as well.
 	void reset(bool _keepSettings = false);
@@ -165,6 +180,32 @@ public:
 
 	void setTVMVersion(langutil::TVMVersion _version = langutil::TVMVersion{});
 
+	/// Sets the number of threads used by the analysis passes that check every source unit on its own.
+	/// A source unit is checked once all source units it imports are checked. Errors are reported
+	/// in the same order as with a single thread, which is the default.
+	/// Must be set before parsing.
+	void setAnalysisThreadCount(unsigned _threadCount);
+
+	/// Enables or disables the analysis of only those sources that are reachable from the input file.
+	/// Other sources are parsed and their names are resolved, but they are not type checked,
+	/// and their contracts are not part of the output.
+	/// Must be set before parsing.
+	void setAnalyzeReachableOnly(bool _reachableOnly);
+
+	/// Enables or disables the allocation of the AST of each source unit, including the annotations,
+	/// in one memory arena that is released in bulk together with that AST.
+	/// Must be set before parsing.
+	void setASTArenaAllocation(bool _arenaAllocation);
+
+	/// Sets a flag that is checked while sources are parsed and analyzed and while generateCode runs.
+	/// Once it is set, the remaining sources are skipped and parsing or analysis fails without further
+	/// errors, generateCode returns nullptr. The flag has to outlive the compilation. Can be null, which
+	/// is the default.
+	void setCancellationFlag(std::atomic<bool> const* _cancelled) { m_cancelled = _cancelled; }
+
+	/// Sets a time after which the compilation counts as cancelled, see setCancellationFlag.
+	void setDeadline(std::optional<std::chrono::steady_clock::time_point> _deadline) { m_deadline = _deadline; }
+
 	/// Sets the requested contract names by source.
 	/// If empty, no filtering is performed and every contract
 	/// found in the supplied sources is compiled.
@@ -187,6 +228,21 @@ public:
 		m_generateCode = true;
 	}
 
+	/// Enables the estimation of the size and the gas of the functions of the generated code.
+	void generateCodeMetrics() {
+		m_generateCodeMetrics = true;
+	}
+
+	/// Enables the static gas estimation of the functions of the generated code.
+	void generateGasEstimates() {
+		m_generateGasEstimates = true;
+	}
+
+	/// Enables the counters of the rewrite rules of the peephole optimizer.
+	void generateOptimizerStats() {
+		m_generateOptimizerStats = true;
+	}
+
 	void setOutputFolder(const std::string& folder) {
 		m_folder = folder;
 	}
@@ -253,6 +309,11 @@ public:
 	/// @returns false on error.
 	std::pair<bool, bool> compile(bool json = false);
 
+	/// Generates the optimized TVM code of @a _contract, which has to be defined in one of the
+	/// analyzed source units, without storing it.
+	/// @returns nullptr if the code generation failed or was cancelled. Its errors are added to errors().
+	std::shared_ptr<frontend::Contract> generateCode(ContractDefinition const& _contract);
+
 	/// Checks whether experimental analysis is on; used in SyntaxTests to skip compilation in case it's ``true``.
 	/// @returns true if experimental analysis is set
 	bool isExperimentalAnalysis() const
@@ -309,6 +370,12 @@ public:
 
 	Json::Value const& functionIds(std::string const& _contractName) const;
 	Json::Value const& privateFunctionIds(std::string const& _contractName) const;
+	/// @returns the estimated size and gas of the functions of the contract, if they were requested.
+	Json::Value const& codeMetrics(std::string const& _contractName) const;
+	/// @returns the static gas estimates of the functions of the contract, if they were requested.
+	Json::Value const& gasEstimates(std::string const& _contractName) const;
+	/// @returns the counters of the peephole optimizer rules on the contract, if they were requested.
+	Json::Value const& optimizerStats(std::string const& _contractName) const;
 
 	/// @returns a JSON representing the storage layout of the contract.
 	/// Prerequisite: Successful call to parse or compile.
@@ -375,6 +442,9 @@ private:
 		mutable std::unique_ptr<Json::Value const> abi;
 		mutable std::unique_ptr<Json::Value const> functionIds;
 		mutable std::unique_ptr<Json::Value const> privateFunctionIds;
+		mutable std::unique_ptr<Json::Value const> codeMetrics;
+		mutable std::unique_ptr<Json::Value const> gasEstimates;
+		mutable std::unique_ptr<Json::Value const> optimizerStats;
 		util::LazyInit<Json::Value const> storageLayout;
 		util::LazyInit<Json::Value const> userDocumentation;
 		util::LazyInit<Json::Value const> devDocumentation;
@@ -387,10 +457,28 @@ private:
 	void createAndAssignCallGraphs();
 	void findAndReportCyclicContractDependencies();
 
+	/// @returns true if the cancellation flag is set or the deadline passed.
+	bool cancelled() const
+	{
+		return
+			(m_cancelled && m_cancelled->load(std::memory_order_relaxed)) ||
+			(m_deadline && std::chrono::steady_clock::now() > *m_deadline);
+	}
+
+	/// Runs @a _pass on every parsed source unit, on m_analysisThreadCount threads.
+	/// @returns false if @a _pass returned false for any of them.
+	bool runPerSource(std::function<bool(SourceUnit const&, langutil::ErrorReporter&)> const& _pass);
+
+	/// Removes the sources that are not reachable from the input file from m_sourceOrder and their
+	/// contracts from m_contracts. A source is reachable if the input file or a reachable source
+	/// refers to one of its declarations. Requires name resolution.
+	void restrictToReachableSources();
+
 	/// Loads the missing sources from @a _ast (named @a _path) using the callback
 	/// @a m_readFile
-	/// @returns the newly loaded sources.
-	StringMap loadMissingSources(SourceUnit const& _ast);
+	/// @returns the character streams of the newly loaded sources, which share the contents
+	/// provided by the callback instead of copying them.
+	std::map<std::string, std::shared_ptr<langutil::CharStream>> loadMissingSources(SourceUnit const& _ast);
 	std::string applyRemapping(std::string const& _path, std::string const& _context);
 	bool resolveImports();
 
@@ -478,6 +566,8 @@ private:
 	std::vector<PragmaDirective const *> getPragmaDirectives(Source const* source) const;
 	std::vector<std::shared_ptr<SourceUnit>> getSourceUnits() const;
 
+	/// Owns all types of this compilation. Declared first so that it is destroyed last.
+	std::unique_ptr<TypeProvider> m_typeProvider;
 	ReadCallback::Callback m_readFile;
 	OptimiserSettings m_optimiserSettings;
 	RevertStrings m_revertStrings = RevertStrings::Default;
@@ -512,12 +602,20 @@ private:
 	std::string m_mainContract;
 	bool m_generateAbi{};
 	bool m_generateCode{};
+	bool m_generateCodeMetrics{};
+	bool m_generateGasEstimates{};
+	bool m_generateOptimizerStats{};
 	std::string m_folder;
 	std::string m_file_prefix;
 	std::string m_inputFile;
 	bool m_doPrintFunctionIds = false;
     bool m_doPrivateFunctionIds = false;
 	solidity::langutil::TVMVersion m_tvmVersion;
+	unsigned m_analysisThreadCount = 1;
+	bool m_analyzeReachableOnly = false;
+	bool m_astArenaAllocation = false;
+	std::atomic<bool> const* m_cancelled = nullptr;
+	std::optional<std::chrono::steady_clock::time_point> m_deadline;
 
 	CompilationSourceType m_compilationSourceType = CompilationSourceType::Solidity;
 	MetadataFormat m_metadataFormat = defaultMetadataFormat();
@@ -80,19 +80,29 @@ void FileReader::allowDirectory(boost::filesystem::path _path)
 	m_allowedDirectories.insert(std::move(_path));
 }
 
+FileReader::StringMap FileReader::sourceUnits() const
+{
+	StringMap sources;
+	for (auto const& [name, buffer]: m_sourceCodes)
+		sources.emplace(name, buffer->text());
+	return sources;
+}
+
 void FileReader::addOrUpdateFile(boost::filesystem::path const& _path, SourceCode _source)
 {
-	m_sourceCodes[cliPathToSourceUnitName(_path)] = std::move(_source);
+	m_sourceCodes[cliPathToSourceUnitName(_path)] = SourceStore::instance().add(_source);
 }
 
 void FileReader::setStdin(SourceCode _source)
 {
-	m_sourceCodes["<stdin>"] = std::move(_source);
+	m_sourceCodes["<stdin>"] = SourceStore::instance().add(_source);
 }
 
 void FileReader::setSourceUnits(StringMap _sources)
 {
-	m_sourceCodes = std::move(_sources);
+	m_sourceCodes.clear();
+	for (auto const& [name, source]: _sources)
+		m_sourceCodes.emplace(name, SourceStore::instance().add(source));
 }
 
 ReadCallback::Result FileReader::readFile(std::string const& _kind, std::string const& _sourceUnitName)
@@ -160,10 +170,10 @@ ReadCallback::Result FileReader::readFile(std::string const& _kind, std::string
 			return ReadCallback::Result{false, "Not a valid file."};
 
 		// NOTE: we ignore the FileNotFound exception as we manually check above
-		auto contents = readFileAsString(candidates[0]);
+		std::shared_ptr<SourceBuffer const> contents = SourceStore::instance().load(candidates[0]);
 		solAssert(m_sourceCodes.count(_sourceUnitName) == 0, "");
 		m_sourceCodes[_sourceUnitName] = contents;
-		return ReadCallback::Result{true, contents};
+		return ReadCallback::Result{true, {}, std::move(contents)};
 	}
 	catch (util::Exception const& _exception)
 	{
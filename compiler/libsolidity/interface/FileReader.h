@@ -19,10 +19,12 @@
 
 #include <libsolidity/interface/ImportRemapper.h>
 #include <libsolidity/interface/ReadFile.h>
+#include <libsolidity/interface/SourceStore.h>
 
 #include <boost/filesystem.hpp>
 
 #include <map>
+#include <memory>
 #include <set>
 
 namespace solidity::frontend
@@ -36,6 +38,7 @@ class FileReader
 {
 public:
 	using StringMap = std::map<SourceUnitName, SourceCode>;
+	using SourceBufferMap = std::map<SourceUnitName, std::shared_ptr<SourceBuffer const>>;
 	using PathMap = std::map<SourceUnitName, boost::filesystem::path>;
 	using FileSystemPathSet = std::set<boost::filesystem::path>;
 
@@ -61,8 +64,12 @@ public:
 	void allowDirectory(boost::filesystem::path _path);
 	FileSystemPathSet const& allowedDirectories() const noexcept { return m_allowedDirectories; }
 
-	/// @returns all sources by their internal source unit names.
-	StringMap const& sourceUnits() const noexcept { return m_sourceCodes; }
+	/// @returns copies of all sources by their internal source unit names.
+	StringMap sourceUnits() const;
+
+	/// @returns the contents of all sources by their internal source unit names.
+	/// The contents are shared with the @a SourceStore.
+	SourceBufferMap const& sourceBuffers() const noexcept { return m_sourceCodes; }
 
 	/// Resets all sources to the given map of source unit name to source codes.
 	/// Does not enforce @a allowedDirectories().
@@ -81,9 +88,9 @@ public:
 	/// and attempts to interpret it as a path and read the corresponding file from disk.
 	/// The read will only succeed if the canonical path of the file is within one of the @a allowedDirectories().
 	/// @param _kind must be equal to "source". Other values are not supported.
-	/// @return Content of the loaded file or an error message. If the operation succeeds, a copy of
-	/// the content is retained in @a sourceUnits() under the key of @a _sourceUnitName. If the key
-	/// already exists, previous content is discarded.
+	/// @return Content of the loaded file or an error message. If the operation succeeds, the
+	/// content is retained in @a sourceBuffers() under the key of @a _sourceUnitName and also
+	/// returned in @a ReadCallback::Result::contents. If the key already exists, previous content is discarded.
 	frontend::ReadCallback::Result readFile(std::string const& _kind, std::string const& _sourceUnitName);
 
 	frontend::ReadCallback::Callback reader()
@@ -164,8 +171,8 @@ private:
 	/// list of allowed directories to read files from
 	FileSystemPathSet m_allowedDirectories;
 
-	/// map of input files to source code strings
-	StringMap m_sourceCodes;
+	/// map of input files to their contents
+	SourceBufferMap m_sourceCodes;
 };
 
 }
@@ -19,17 +19,44 @@
 #include <libsolutil/CommonIO.h>
 #include <liblangutil/Exceptions.h>
 
+#include <map>
+#include <mutex>
+
 namespace solidity::frontend
 {
 
+struct ImportRemapper::Cache
+{
+	std::mutex mutex;
+	std::map<std::pair<ImportPath, std::string>, SourceUnitName> remappedPaths;
+};
+
 void ImportRemapper::setRemappings(std::vector<Remapping> _remappings)
 {
 	for (auto const& remapping: _remappings)
 		solAssert(!remapping.prefix.empty(), "");
 	m_remappings = std::move(_remappings);
+	m_cache = m_remappings.empty() ? nullptr : std::make_shared<Cache>();
 }
 
 SourceUnitName ImportRemapper::apply(ImportPath const& _path, std::string const& _context) const
+{
+	if (!m_cache)
+		return remap(_path, _context);
+
+	{
+		std::lock_guard lock(m_cache->mutex);
+		auto it = m_cache->remappedPaths.find({_path, _context});
+		if (it != m_cache->remappedPaths.end())
+			return it->second;
+	}
+	SourceUnitName remapped = remap(_path, _context);
+	std::lock_guard lock(m_cache->mutex);
+	m_cache->remappedPaths.emplace(std::pair{_path, _context}, remapped);
+	return remapped;
+}
+
+SourceUnitName ImportRemapper::remap(ImportPath const& _path, std::string const& _context) const
 {
 	// Try to find the longest prefix match in all remappings that are active in the current context.
 	auto isPrefixOf = [](std::string const& _a, std::string const& _b)
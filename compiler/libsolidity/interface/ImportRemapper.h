@@ -17,6 +17,7 @@
 // SPDX-License-Identifier: GPL-3.0
 #pragma once
 
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
@@ -49,11 +50,17 @@ public:
 		std::string target;
 	};
 
-	void clear() { m_remappings.clear(); }
+	void clear()
+	{
+		m_remappings.clear();
+		m_cache.reset();
+	}
 
 	void setRemappings(std::vector<Remapping> _remappings);
 	std::vector<Remapping> const& remappings() const noexcept { return m_remappings; }
 
+	/// @returns the source unit name that @a _path is remapped to in the context @a _context.
+	/// The results are cached until the remappings change.
 	SourceUnitName apply(ImportPath const& _path, std::string const& _context) const;
 
 	/// @returns true if the string can be parsed as a remapping
@@ -63,9 +70,15 @@ public:
 	static std::optional<Remapping> parseRemapping(std::string_view _input);
 
 private:
+	struct Cache;
+
+	SourceUnitName remap(ImportPath const& _path, std::string const& _context) const;
+
 	/// list of path prefix remappings, e.g. mylibrary: github.com/ethereum = /usr/local/ethereum
 	/// "context:prefix=target"
 	std::vector<Remapping> m_remappings = {};
+	/// Results of apply() for m_remappings, not used if there are no remappings.
+	std::shared_ptr<Cache> m_cache;
 };
 
 }
@@ -20,8 +20,12 @@
 
 #include <liblangutil/Exceptions.h>
 
+#include <libsolidity/interface/SourceStore.h>
+
 #include <functional>
+#include <memory>
 #include <string>
+#include <string_view>
 
 #include <boost/filesystem.hpp>
 
@@ -40,6 +44,15 @@ public:
 	{
 		bool success;
 		std::string responseOrErrorMessage;
+		/// Contents of a source file that was read successfully. If set, the contents are shared
+		/// instead of being copied to @a responseOrErrorMessage.
+		std::shared_ptr<SourceBuffer const> contents = nullptr;
+
+		/// @returns the contents if set and @a responseOrErrorMessage otherwise.
+		std::string_view response() const noexcept
+		{
+			return contents ? contents->text() : std::string_view{responseOrErrorMessage};
+		}
 	};
 
 	enum class Kind
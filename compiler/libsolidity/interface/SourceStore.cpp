@@ -0,0 +1,215 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+// SPDX-License-Identifier: GPL-3.0
+
+#include <libsolidity/interface/SourceStore.h>
+
+#include <libsolutil/Assertions.h>
+#include <libsolutil/CommonIO.h>
+#include <libsolutil/Exceptions.h>
+
+#include <functional>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+using namespace solidity;
+using namespace solidity::frontend;
+
+namespace
+{
+
+/// Files smaller than this are read, since mapping them costs more than copying them.
+std::size_t constexpr minMappedFileSize = 16 * 1024;
+/// Files modified less than this many nanoseconds ago are not recognized by their modification time,
+/// since file systems store it with a coarser granularity than nanoseconds.
+std::uintmax_t constexpr modificationTimeGranularity = 2'000'000'000u;
+
+std::shared_ptr<SourceBuffer const> readFile(boost::filesystem::path const& _path, bool _map)
+{
+#if !defined(_WIN32)
+	int const fd = _map ? open(_path.c_str(), O_RDONLY | O_CLOEXEC) : -1;
+	if (fd >= 0)
+	{
+		std::shared_ptr<SourceBuffer const> buffer;
+		struct stat status{};
+		long const pageSize = sysconf(_SC_PAGESIZE);
+		// The rest of the last page of a mapping is filled with zeros. Files that end exactly at
+		// a page boundary are read instead, so that every buffer is followed by a zero byte.
+		if (
+			fstat(fd, &status) == 0 &&
+			S_ISREG(status.st_mode) &&
+			static_cast<std::size_t>(status.st_size) >= minMappedFileSize &&
+			pageSize > 0 &&
+			status.st_size % pageSize != 0
+		)
+		{
+			auto const size = static_cast<std::size_t>(status.st_size);
+			void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (data != MAP_FAILED)
+				buffer = std::make_shared<SourceBuffer const>(data, size);
+		}
+		close(fd);
+		if (buffer)
+			return buffer;
+	}
+#else
+	(void)_map;
+#endif
+	return std::make_shared<SourceBuffer const>(util::readFileAsString(_path));
+}
+
+/// @returns the size and the modification time of the file at @a _path, which change
+/// whenever the file is written to, or nullopt if they are not known precisely enough.
+/// A file that was modified very recently can be written again without a change of either.
+std::optional<std::pair<std::uintmax_t, std::uintmax_t>> fileVersion(boost::filesystem::path const& _path)
+{
+#if defined(_WIN32)
+	(void)_path;
+	return std::nullopt;
+#else
+	struct stat status{};
+	if (stat(_path.c_str(), &status) != 0)
+		return std::nullopt;
+#if defined(__APPLE__)
+	auto const& modified = status.st_mtimespec;
+#else
+	auto const& modified = status.st_mtim;
+#endif
+	struct timespec now{};
+	if (clock_gettime(CLOCK_REALTIME, &now) != 0)
+		return std::nullopt;
+	auto const nanoseconds = [](struct timespec const& _time) {
+		return static_cast<std::uintmax_t>(_time.tv_sec) * 1000000000u + static_cast<std::uintmax_t>(_time.tv_nsec);
+	};
+	if (nanoseconds(modified) + modificationTimeGranularity > nanoseconds(now))
+		return std::nullopt;
+	return std::pair{static_cast<std::uintmax_t>(status.st_size), nanoseconds(modified)};
+#endif
+}
+
+}
+
+SourceBuffer::SourceBuffer(std::string _contents):
+	m_contents(std::move(_contents)),
+	m_text(m_contents)
+{
+}
+
+SourceBuffer::SourceBuffer(void const* _data, std::size_t _size):
+	m_mapping(_data),
+	m_mappingSize(_size),
+	m_text(static_cast<char const*>(_data), _size)
+{
+}
+
+SourceBuffer::~SourceBuffer()
+{
+#if !defined(_WIN32)
+	if (m_mapping)
+		munmap(const_cast<void*>(m_mapping), m_mappingSize);
+#endif
+}
+
+SourceStore& SourceStore::instance()
+{
+	static SourceStore store;
+	return store;
+}
+
+std::shared_ptr<SourceBuffer const> SourceStore::load(boost::filesystem::path const& _path)
+{
+	assertThrow(boost::filesystem::exists(_path), util::FileNotFound, _path.string());
+	assertThrow(boost::filesystem::is_regular_file(_path), util::NotAFile, _path.string());
+
+	auto const version = fileVersion(_path);
+	if (version)
+	{
+		std::lock_guard lock(m_mutex);
+		auto file = m_files.find(_path);
+		if (file != m_files.end() && file->second.version == *version)
+			if (auto buffer = file->second.buffer.lock())
+				return buffer;
+	}
+
+	std::shared_ptr<SourceBuffer const> buffer = deduplicate(readFile(_path, m_mapFiles));
+	if (version)
+	{
+		std::lock_guard lock(m_mutex);
+		if (m_files.size() >= m_fileSweepSize)
+		{
+			for (auto it = m_files.begin(); it != m_files.end();)
+				if (it->second.buffer.expired())
+					it = m_files.erase(it);
+				else
+					++it;
+			m_fileSweepSize = std::max<std::size_t>(2 * m_files.size(), 64);
+		}
+		m_files[_path] = FileEntry{*version, buffer};
+	}
+	return buffer;
+}
+
+std::shared_ptr<SourceBuffer const> SourceStore::add(std::string_view _contents)
+{
+	std::size_t const hash = std::hash<std::string_view>{}(_contents);
+	{
+		std::lock_guard lock(m_mutex);
+		if (auto buffer = find(hash, _contents))
+			return buffer;
+	}
+	return deduplicate(std::make_shared<SourceBuffer const>(std::string(_contents)), hash);
+}
+
+std::shared_ptr<SourceBuffer const> SourceStore::deduplicate(std::shared_ptr<SourceBuffer const> _buffer)
+{
+	return deduplicate(_buffer, std::hash<std::string_view>{}(_buffer->text()));
+}
+
+std::shared_ptr<SourceBuffer const> SourceStore::deduplicate(std::shared_ptr<SourceBuffer const> _buffer, std::size_t _hash)
+{
+	std::lock_guard lock(m_mutex);
+	if (auto buffer = find(_hash, _buffer->text()))
+		return buffer;
+
+	// Forget the buffers that are not used anymore once in a while.
+	if (m_buffersByHash.size() >= m_sweepSize)
+	{
+		for (auto it = m_buffersByHash.begin(); it != m_buffersByHash.end();)
+			if (it->second.expired())
+				it = m_buffersByHash.erase(it);
+			else
+				++it;
+		m_sweepSize = std::max<std::size_t>(2 * m_buffersByHash.size(), 64);
+	}
+	m_buffersByHash.emplace(_hash, _buffer);
+	return _buffer;
+}
+
+std::shared_ptr<SourceBuffer const> SourceStore::find(std::size_t _hash, std::string_view _contents) const
+{
+	auto [begin, end] = m_buffersByHash.equal_range(_hash);
+	for (auto it = begin; it != end; ++it)
+		if (auto buffer = it->second.lock(); buffer && buffer->text() == _contents)
+			return buffer;
+	return nullptr;
+}
@@ -0,0 +1,116 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+// SPDX-License-Identifier: GPL-3.0
+/**
+ * Process-wide store of source file contents, shared by all compilations.
+ */
+
+#pragma once
+
+#include <boost/filesystem.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace solidity::frontend
+{
+
+/**
+ * Immutable contents of a source file. The contents are either a read-only memory mapping
+ * of the file or a string. In both cases they are followed by a zero byte.
+ */
+class SourceBuffer
+{
+public:
+	explicit SourceBuffer(std::string _contents);
+	/// Takes over the memory mapping of @a _size bytes at @a _data.
+	SourceBuffer(void const* _data, std::size_t _size);
+	~SourceBuffer();
+
+	SourceBuffer(SourceBuffer const&) = delete;
+	SourceBuffer& operator=(SourceBuffer const&) = delete;
+
+	std::string_view text() const noexcept { return m_text; }
+	bool isMapped() const noexcept { return m_mapping != nullptr; }
+
+private:
+	std::string m_contents;
+	void const* m_mapping = nullptr;
+	std::size_t m_mappingSize = 0;
+	std::string_view m_text;
+};
+
+/**
+ * Store of source buffers, keyed by the hash of their contents, so that equal sources that are
+ * read or passed in several times are kept in memory only once. The store does not keep buffers
+ * alive, they are released once no compilation uses them anymore. A file is loaded again if its
+ * buffer was released or its size or modification time changed. If enabled, large files are
+ * mapped into memory. All functions can be called concurrently.
+ */
+class SourceStore
+{
+public:
+	static SourceStore& instance();
+
+	/// @returns the contents of the regular file at @a _path.
+	/// Throws FileNotFound or NotAFile if the file cannot be read.
+	std::shared_ptr<SourceBuffer const> load(boost::filesystem::path const& _path);
+
+	/// @returns a buffer with the contents @a _contents, which is only copied if no such buffer is stored.
+	std::shared_ptr<SourceBuffer const> add(std::string_view _contents);
+
+	/// Enables mapping large files into memory instead of reading them. Only for processes that
+	/// exit before the files can change, such as a batch build: a mapped file that is truncated
+	/// raises SIGBUS when it is read, and one that is rewritten in place changes under its readers.
+	void setMapFiles(bool _mapFiles) { m_mapFiles = _mapFiles; }
+
+private:
+	struct FileEntry
+	{
+		/// Size and modification time in nanoseconds.
+		std::pair<std::uintmax_t, std::uintmax_t> version;
+		std::weak_ptr<SourceBuffer const> buffer;
+	};
+
+	/// @returns a stored buffer with the same contents as @a _buffer, which is stored if there is none.
+	std::shared_ptr<SourceBuffer const> deduplicate(std::shared_ptr<SourceBuffer const> _buffer);
+	std::shared_ptr<SourceBuffer const> deduplicate(std::shared_ptr<SourceBuffer const> _buffer, std::size_t _hash);
+	/// @returns the stored buffer with the contents @a _contents and hash @a _hash or nullptr.
+	/// Requires the mutex to be locked.
+	std::shared_ptr<SourceBuffer const> find(std::size_t _hash, std::string_view _contents) const;
+
+	std::atomic<bool> m_mapFiles = false;
+	std::mutex m_mutex;
+	/// Buffers by content hash. Buffers that are not used anymore are removed lazily.
+	std::unordered_multimap<std::size_t, std::weak_ptr<SourceBuffer const>> m_buffersByHash;
+	/// Size of m_buffersByHash at which buffers that are not used anymore are removed.
+	std::size_t m_sweepSize = 64;
+	/// Most recently loaded buffer of each file. Entries of released buffers are removed lazily.
+	std::map<boost::filesystem::path, FileEntry> m_files;
+	/// Size of m_files at which entries of released buffers are removed.
+	std::size_t m_fileSweepSize = 64;
+};
+
+}
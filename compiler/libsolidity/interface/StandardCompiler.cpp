@@ -39,7 +39,9 @@
 #include <boost/algorithm/string/predicate.hpp>
 
 #include <algorithm>
+#include <array>
 #include <optional>
+#include <streambuf>
 
 using namespace solidity;
 using namespace solidity::yul;
@@ -167,6 +169,41 @@ std::map<std::string, std::set<std::string>> requestedContractNames(Json::Value
 	return contracts;
 }
 
+/// Stream buffer that passes everything written to it to @a _output in chunks.
+class ChunkedOutputBuffer: public std::streambuf
+{
+public:
+	explicit ChunkedOutputBuffer(std::function<void(std::string_view)> _output):
+		m_output(std::move(_output))
+	{
+		setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+	}
+
+protected:
+	int_type overflow(int_type _char) override
+	{
+		sync();
+		if (!traits_type::eq_int_type(_char, traits_type::eof()))
+		{
+			*pptr() = traits_type::to_char_type(_char);
+			pbump(1);
+		}
+		return traits_type::not_eof(_char);
+	}
+
+	int sync() override
+	{
+		if (pptr() > pbase())
+			m_output(std::string_view(pbase(), static_cast<size_t>(pptr() - pbase())));
+		setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+		return 0;
+	}
+
+private:
+	std::function<void(std::string_view)> m_output;
+	std::array<char, 64 * 1024> m_buffer;
+};
+
 /// Returns true iff @a _hash (hex with 0x prefix) is the Keccak256 hash of the binary data in @a _content.
 bool hashMatchesContent(std::string const& _hash, std::string const& _content)
 {
@@ -259,6 +296,7 @@ bool isBinaryRequested(Json::Value const& _outputSelection)
 	static std::vector<std::string> const outputsThatRequireBinaries = std::vector<std::string>{
 		"*",
 		"assembly",
+		"codeMetrics", "gasEstimates", "optimizerStats",
 		"ir", "irAst", "irOptimized", "irOptimizedAst",
 		"evm.gasEstimates", "evm.legacyAssembly", "evm.assembly"
 	} + evmObjectComponents("bytecode") + evmObjectComponents("deployedBytecode");
@@ -271,6 +309,19 @@ bool isBinaryRequested(Json::Value const& _outputSelection)
 	return false;
 }
 
+/// @returns true if the output @a _artifact of any contract was requested.
+bool isContractArtifactRequested(Json::Value const& _outputSelection, std::string const& _artifact)
+{
+	if (!_outputSelection.isObject())
+		return false;
+
+	for (auto const& fileRequests: _outputSelection)
+		for (auto const& requests: fileRequests)
+			if (isArtifactRequested(requests, _artifact, false))
+				return true;
+	return false;
+}
+
 /// @returns true if EVM bytecode was requested, i.e. we have to run the old code generator.
 bool isEvmBytecodeRequested(Json::Value const& _outputSelection)
 {
@@ -344,7 +395,8 @@ std::optional<Json::Value> checkAuxiliaryInputKeys(Json::Value const& _input)
 std::optional<Json::Value> checkSettingsKeys(Json::Value const& _input)
 {
 	static std::set<std::string> keys{"debug", "evmVersion", "libraries", "metadata", "modelChecker", "optimizer", "outputSelection", "remappings", "stopAfter", "viaIR",
-									  "includePaths", "mainContract", "tvmVersion"};
+									  "includePaths", "mainContract", "tvmVersion", "analysisThreads",
+									  "analyzeReachableOnly", "astArena"};
 	return checkKeys(_input, keys, "settings");
 }
 
@@ -572,7 +624,8 @@ std::variant<StandardCompiler::InputsAndSettings, Json::Value> StandardCompiler:
 					ReadCallback::Result result = m_readFile(ReadCallback::kindString(ReadCallback::Kind::ReadFile), url.asString());
 					if (result.success)
 					{
-						if (!hash.empty() && !hashMatchesContent(hash, result.responseOrErrorMessage))
+						std::string content{result.response()};
+						if (!hash.empty() && !hashMatchesContent(hash, content))
 							ret.errors.append(formatError(
 								Error::Type::IOError,
 								"general",
@@ -580,7 +633,7 @@ std::variant<StandardCompiler::InputsAndSettings, Json::Value> StandardCompiler:
 							));
 						else
 						{
-							ret.sources[sourceName] = result.responseOrErrorMessage;
+							ret.sources[sourceName] = std::move(content);
 							found = true;
 							break;
 						}
@@ -709,6 +762,27 @@ std::variant<StandardCompiler::InputsAndSettings, Json::Value> StandardCompiler:
 		ret.viaIR = settings["viaIR"].asBool();
 	}
 
+	if (settings.isMember("analysisThreads"))
+	{
+		if (!settings["analysisThreads"].isUInt())
+			return formatFatalError(Error::Type::JSONError, "\"settings.analysisThreads\" must be an unsigned integer.");
+		ret.analysisThreads = settings["analysisThreads"].asUInt();
+	}
+
+	if (settings.isMember("analyzeReachableOnly"))
+	{
+		if (!settings["analyzeReachableOnly"].isBool())
+			return formatFatalError(Error::Type::JSONError, "\"settings.analyzeReachableOnly\" must be a Boolean.");
+		ret.analyzeReachableOnly = settings["analyzeReachableOnly"].asBool();
+	}
+
+	if (settings.isMember("astArena"))
+	{
+		if (!settings["astArena"].isBool())
+			return formatFatalError(Error::Type::JSONError, "\"settings.astArena\" must be a Boolean.");
+		ret.astArena = settings["astArena"].asBool();
+	}
+
 	if (settings.isMember("evmVersion"))
 	{
 		if (!settings["evmVersion"].isString())
@@ -1003,6 +1077,9 @@ Json::Value StandardCompiler::compileSolidity(StandardCompiler::InputsAndSetting
 	// TODO DELETE: do we need EVMVersion and other stuff?
 	compilerStack.setEVMVersion(_inputsAndSettings.evmVersion);
 	compilerStack.setViaIR(_inputsAndSettings.viaIR);
+	compilerStack.setAnalysisThreadCount(_inputsAndSettings.analysisThreads);
+	compilerStack.setAnalyzeReachableOnly(_inputsAndSettings.analyzeReachableOnly);
+	compilerStack.setASTArenaAllocation(_inputsAndSettings.astArena);
 	compilerStack.setEVMVersion(_inputsAndSettings.evmVersion);
 	compilerStack.setRemappings(std::move(_inputsAndSettings.remappings));
 	compilerStack.setOptimiserSettings(std::move(_inputsAndSettings.optimiserSettings));
@@ -1030,6 +1107,12 @@ Json::Value StandardCompiler::compileSolidity(StandardCompiler::InputsAndSetting
 	compilerStack.generateAbi();
 	if (binariesRequested)
 		compilerStack.generateCode();
+	if (isContractArtifactRequested(_inputsAndSettings.outputSelection, "codeMetrics"))
+		compilerStack.generateCodeMetrics();
+	if (isContractArtifactRequested(_inputsAndSettings.outputSelection, "gasEstimates"))
+		compilerStack.generateGasEstimates();
+	if (isContractArtifactRequested(_inputsAndSettings.outputSelection, "optimizerStats"))
+		compilerStack.generateOptimizerStats();
 	compilerStack.printFunctionIds();
 	compilerStack.printPrivateFunctionIds();
 
@@ -1173,7 +1256,23 @@ Json::Value StandardCompiler::compileSolidity(StandardCompiler::InputsAndSetting
 			Json::Value sourceResult = Json::objectValue;
 			sourceResult["id"] = sourceIndex++;
 			if (isArtifactRequested(_inputsAndSettings.outputSelection, sourceName, "", "ast", wildcardMatchesExperimental))
-				sourceResult["ast"] = ASTJsonExporter(compilerStack.state(), compilerStack.sourceIndices()).toJson(compilerStack.ast(sourceName));
+			{
+				ASTJsonExporter exporter(compilerStack.sourceState(sourceName), compilerStack.sourceIndices());
+				if (m_astSink || m_artifactSink)
+				{
+					ChunkedOutputBuffer buffer([&](std::string_view _chunk) {
+						if (m_astSink)
+							m_astSink(sourceName, _chunk);
+						else
+							m_artifactSink(sourceName, "", "ast", _chunk);
+					});
+					std::ostream stream(&buffer);
+					exporter.stream(stream, compilerStack.ast(sourceName));
+					stream.flush();
+				}
+				else
+					sourceResult["ast"] = exporter.toJson(compilerStack.ast(sourceName));
+			}
 			output["sources"][sourceName] = sourceResult;
 		}
 
@@ -1186,10 +1285,38 @@ Json::Value StandardCompiler::compileSolidity(StandardCompiler::InputsAndSetting
 		std::string name = contractName.substr(colon + 1);
 
 		Json::Value contractData(Json::objectValue);
-		contractData["abi"] = compilerStack.contractABI(contractName);
-		contractData["assembly"] = compilerStack.contractCode(contractName);
-		contractData["functionIds"] = compilerStack.functionIds(contractName);
-		contractData["privateFunctionIds"] = compilerStack.privateFunctionIds(contractName);
+		if (m_artifactSink)
+		{
+			// The assembly is passed on as it is stored, without escaping it.
+			Json::Value const& code = compilerStack.contractCode(contractName);
+			char const* codeBegin = nullptr;
+			char const* codeEnd = nullptr;
+			if (code.getString(&codeBegin, &codeEnd))
+				m_artifactSink(file, name, "assembly", std::string_view(codeBegin, static_cast<size_t>(codeEnd - codeBegin)));
+			for (auto const& [artifact, value]: {
+				std::pair<std::string, Json::Value const*>{"abi", &compilerStack.contractABI(contractName)},
+				{"functionIds", &compilerStack.functionIds(contractName)},
+				{"privateFunctionIds", &compilerStack.privateFunctionIds(contractName)},
+				{"codeMetrics", &compilerStack.codeMetrics(contractName)},
+				{"gasEstimates", &compilerStack.gasEstimates(contractName)},
+				{"optimizerStats", &compilerStack.optimizerStats(contractName)}
+			})
+				if (!value->isNull())
+					m_artifactSink(file, name, artifact, util::jsonCompactPrint(*value));
+		}
+		else
+		{
+			contractData["abi"] = compilerStack.contractABI(contractName);
+			contractData["assembly"] = compilerStack.contractCode(contractName);
+			contractData["functionIds"] = compilerStack.functionIds(contractName);
+			contractData["privateFunctionIds"] = compilerStack.privateFunctionIds(contractName);
+			if (Json::Value const& codeMetrics = compilerStack.codeMetrics(contractName); !codeMetrics.isNull())
+				contractData["codeMetrics"] = codeMetrics;
+			if (Json::Value const& gasEstimates = compilerStack.gasEstimates(contractName); !gasEstimates.isNull())
+				contractData["gasEstimates"] = gasEstimates;
+			if (Json::Value const& optimizerStats = compilerStack.optimizerStats(contractName); !optimizerStats.isNull())
+				contractData["optimizerStats"] = optimizerStats;
+		}
 		contractData["metadata"] = compilerStack.metadata(contractName);
 		contractData["userdoc"] = compilerStack.natspecUser(contractName);
 		contractData["devdoc"] = compilerStack.natspecDev(contractName);
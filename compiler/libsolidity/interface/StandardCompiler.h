@@ -28,7 +28,9 @@
 
 #include <liblangutil/DebugInfoSelection.h>
 
+#include <functional>
 #include <optional>
+#include <string_view>
 #include <utility>
 #include <variant>
 
@@ -42,6 +44,16 @@ namespace solidity::frontend
 class StandardCompiler
 {
 public:
+	/// Receives the compact JSON of the AST of the source @a _sourceName in consecutive chunks.
+	using ASTSink = std::function<void(std::string const& _sourceName, std::string_view _chunk)>;
+	/// Receives the artifact @a _artifact of the contract @a _contractName in the source @a _sourceName.
+	using ArtifactSink = std::function<void(
+		std::string const& _sourceName,
+		std::string const& _contractName,
+		std::string const& _artifact,
+		std::string_view _data
+	)>;
+
 	/// Noncopyable.
 	StandardCompiler(StandardCompiler const&) = delete;
 	StandardCompiler& operator=(StandardCompiler const&) = delete;
@@ -63,6 +75,14 @@ public:
 	/// output. Parsing errors are returned as regular errors.
 	std::string compile(std::string const& _input) noexcept;
 
+	/// Sets @a _sink to receive the ASTs requested in the output selection. They are written to
+	/// the sink while the syntax tree is walked and are left out of the output.
+	void setASTSink(ASTSink _sink) { m_astSink = std::move(_sink); }
+	/// Sets @a _sink to receive the assembly as text and the ABI and the function ids as compact JSON
+	/// of every contract, which are then left out of the output. The ASTs are passed to the sink
+	/// as artifact "ast" with an empty contract name, in several parts, unless an AST sink is set.
+	void setArtifactSink(ArtifactSink _sink) { m_artifactSink = std::move(_sink); }
+
 private:
 	struct InputsAndSettings
 	{
@@ -89,6 +109,9 @@ private:
 		CompilerStack::MetadataHash metadataHash = CompilerStack::MetadataHash::IPFS;
 		Json::Value outputSelection;
 		bool viaIR = false;
+		unsigned analysisThreads = 1;
+		bool analyzeReachableOnly = false;
+		bool astArena = false;
 	};
 
 	/// Parses the input json (and potentially invokes the read callback) and either returns
@@ -101,6 +124,8 @@ private:
 	ReadCallback::Callback m_readFile;
 
 	util::JsonFormat m_jsonPrintingFormat;
+	ASTSink m_astSink;
+	ArtifactSink m_artifactSink;
 };
 
 }
@@ -17,6 +17,7 @@
 // SPDX-License-Identifier: GPL-3.0
 
 #include <libsolidity/lsp/FileRepository.h>
+#include <libsolidity/interface/SourceStore.h>
 #include <libsolidity/lsp/Transport.h>
 #include <libsolidity/lsp/Utils.h>
 
@@ -38,7 +39,6 @@ using namespace solidity;
 using namespace solidity::lsp;
 using namespace solidity::frontend;
 
-using solidity::util::readFileAsString;
 using solidity::util::joinHumanReadable;
 using solidity::util::Result;
 
@@ -165,7 +165,7 @@ frontend::ReadCallback::Result FileRepository::readFile(std::string const& _kind
 		if (!resolvedPath.message().empty())
 			return ReadCallback::Result{false, resolvedPath.message()};
 
-		auto contents = readFileAsString(resolvedPath.get());
+		std::string contents{SourceStore::instance().load(resolvedPath.get())->text()};
 		solAssert(m_sourceCodes.count(_sourceUnitName) == 0, "");
 		m_sourceCodes[_sourceUnitName] = contents;
 		return ReadCallback::Result{true, std::move(contents)};
@@ -18,7 +18,10 @@
 #include <libsolidity/ast/AST.h>
 #include <libsolidity/ast/ASTUtils.h>
 #include <libsolidity/ast/ASTVisitor.h>
+#include <libsolidity/codegen/TVMCodeMetrics.hpp>
+#include <libsolidity/codegen/TvmAst.hpp>
 #include <libsolidity/interface/ReadFile.h>
+#include <libsolidity/interface/SourceStore.h>
 #include <libsolidity/interface/StandardCompiler.h>
 #include <libsolidity/lsp/LanguageServer.h>
 #include <libsolidity/lsp/HandlerBase.h>
@@ -33,6 +36,7 @@
 #include <liblangutil/SourceReferenceExtractor.h>
 #include <liblangutil/CharStream.h>
 
+#include <libsolutil/CommonData.h>
 #include <libsolutil/CommonIO.h>
 #include <libsolutil/Visitor.h>
 #include <libsolutil/JSON.h>
@@ -129,6 +133,20 @@ Json::Value semanticTokensLegend()
 	return legend;
 }
 
+std::string codeLensTitle(FunctionCodeMetrics const& _metrics)
+{
+	std::string title = fmt::format("{} bits, {} cells, {}\u2013{} gas", _metrics.bits, _metrics.cells, _metrics.minGas, _metrics.maxGas);
+	if (!_metrics.loopIterationGas.empty())
+		title += " + loops";
+	if (_metrics.codeCells > 1)
+		title += fmt::format(
+			" \u26a0 exceeds one cell: {} extra cell load{}",
+			_metrics.codeCells - 1,
+			_metrics.codeCells > 2 ? "s" : ""
+		);
+	return title;
+}
+
 }
 
 LanguageServer::LanguageServer(Transport& _transport):
@@ -141,20 +159,44 @@ LanguageServer::LanguageServer(Transport& _transport):
 		{"initialized", std::bind(&LanguageServer::handleInitialized, this, _1, _2)},
 		{"$/setTrace", [this](auto, Json::Value const& args) { setTrace(args["value"]); }},
 		{"shutdown", [this](auto, auto) { m_state = State::ShutdownRequested; }},
-		{"textDocument/definition", GotoDefinition(*this) },
+		{"textDocument/codeLens", std::bind(&LanguageServer::codeLens, this, _1, _2)},
+		{"textDocument/definition", withAnalysis(GotoDefinition(*this)) },
 		{"textDocument/didOpen", std::bind(&LanguageServer::handleTextDocumentDidOpen, this, _2)},
 		{"textDocument/didChange", std::bind(&LanguageServer::handleTextDocumentDidChange, this, _2)},
 		{"textDocument/didClose", std::bind(&LanguageServer::handleTextDocumentDidClose, this, _2)},
-		{"textDocument/hover", DocumentHoverHandler(*this) },
-		{"textDocument/rename", RenameSymbol(*this) },
-		{"textDocument/implementation", GotoDefinition(*this) },
-		{"textDocument/semanticTokens/full", std::bind(&LanguageServer::semanticTokensFull, this, _1, _2)},
+		{"textDocument/hover", withAnalysis(DocumentHoverHandler(*this)) },
+		{"textDocument/rename", withAnalysis(RenameSymbol(*this), true) },
+		{"textDocument/implementation", withAnalysis(GotoDefinition(*this)) },
+		{"textDocument/semanticTokens/full", withAnalysis(std::bind(&LanguageServer::semanticTokensFull, this, _1, _2))},
+		{"textDocument/semanticTokens/full/delta", withAnalysis(std::bind(&LanguageServer::semanticTokensFullDelta, this, _1, _2))},
 		{"workspace/didChangeConfiguration", std::bind(&LanguageServer::handleWorkspaceDidChangeConfiguration, this, _2)},
 	},
-	m_fileRepository("/" /* basePath */, {} /* no search paths */) //,
-	//m_compilerStack{m_fileRepository.candidateGetter(), m_fileRepository.reader()}
+	m_fileRepository("/" /* basePath */, {} /* no search paths */),
+	m_compilerStack{std::make_unique<CompilerStack>()},
+	m_compilationThread{&LanguageServer::compilationLoop, this}
 {
-	solUnimplemented("TODO, SOLVE THIS ^^");
+}
+
+LanguageServer::~LanguageServer()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopCompilation = true;
+		if (m_runningCompilationCancelled)
+			*m_runningCompilationCancelled = true;
+	}
+	m_compilationRequested.notify_all();
+	m_compilationThread.join();
+}
+
+LanguageServer::MessageHandler LanguageServer::withAnalysis(MessageHandler _handler, bool _allSources)
+{
+	return [this, handler = std::move(_handler), _allSources](MessageID _id, Json::Value const& _args) {
+		compile(m_fileRepository.uriToSourceUnitName(_args["textDocument"]["uri"].asString()), _allSources);
+		// The analysis may have run on the compilation thread.
+		m_compilerStack->activate();
+		handler(_id, _args);
+	};
 }
 
 Json::Value LanguageServer::toRange(SourceLocation const& _location)
@@ -189,6 +231,25 @@ void LanguageServer::changeConfiguration(Json::Value const& _settings)
 			lspRequire(false, ErrorCode::InvalidParams, "Invalid file load strategy: " + text);
 	}
 
+	// The setting "compile-delay" is the time in milliseconds without changes after which the changes are analyzed.
+	if (_settings["compile-delay"].isUInt())
+		m_compilationDelay = std::chrono::milliseconds(_settings["compile-delay"].asUInt());
+
+	// The setting "tvm-metrics" enables the code lenses with the estimated size and gas of the functions,
+	// which are computed within "tvm-metrics-budget" milliseconds after the analysis. Contracts whose
+	// code is not generated within the budget get no code lenses.
+	if (_settings["tvm-metrics"].isBool() && _settings["tvm-metrics"].asBool() != m_tvmMetrics)
+	{
+		m_tvmMetrics = _settings["tvm-metrics"].asBool();
+		m_codeMetricsRevision = 0;
+		m_codeLenses.clear();
+		if (m_codeLensRefreshSupport)
+			m_client.request("workspace/codeLens/refresh", Json::nullValue);
+		m_compilationRequested.notify_all();
+	}
+	if (_settings["tvm-metrics-budget"].isUInt())
+		m_tvmMetricsBudget = std::chrono::milliseconds(_settings["tvm-metrics-budget"].asUInt());
+
 	m_settingsObject = _settings;
 	Json::Value jsonIncludePaths = _settings["include-paths"];
 
@@ -212,6 +273,11 @@ void LanguageServer::changeConfiguration(Json::Value const& _settings)
 
 		if (typeFailureCount)
 			m_client.trace("Invalid JSON configuration passed. \"include-paths\" must be an array of strings.");
+
+		// Imports may resolve to other files now.
+		m_analyzedSources.clear();
+		m_imports.clear();
+		m_incompleteSources.clear();
 	}
 }
 
@@ -238,7 +304,25 @@ std::vector<boost::filesystem::path> LanguageServer::allSolidityFilesFromProject
 	return collectedPaths;
 }
 
-void LanguageServer::compile()
+void LanguageServer::compile(std::string const& _sourceUnitName, bool _allSources)
+{
+	if (
+		m_analyzedRevision == m_revision &&
+		(!_allSources || m_allSourcesAnalyzed) &&
+		(_sourceUnitName.empty() || util::contains(m_compilerStack->sourceNames(), _sourceUnitName))
+	)
+		return;
+
+	// The analysis on the compilation thread would be outdated by this one.
+	if (m_runningCompilationCancelled)
+		*m_runningCompilationCancelled = true;
+
+	Compilation compilation = prepareCompilation(_sourceUnitName, _allSources);
+	runCompilation(compilation);
+	finishCompilation(std::move(compilation));
+}
+
+LanguageServer::Compilation LanguageServer::prepareCompilation(std::string const& _sourceUnitName, bool _allSources)
 {
 	// For files that are not open, we have to take changes on disk into account,
 	// so we just remove all non-open files.
@@ -246,14 +330,14 @@ void LanguageServer::compile()
 	FileRepository oldRepository(m_fileRepository.basePath(), m_fileRepository.includePaths());
 	std::swap(oldRepository, m_fileRepository);
 
-	// Load all solidity files from project.
+	// Load all solidity files from project. Files that did not change on disk are not read again.
 	if (m_fileLoadStrategy == FileLoadStrategy::ProjectDirectory)
 		for (auto const& projectFile: allSolidityFilesFromProject())
 		{
 			lspDebug(fmt::format("adding project file: {}", projectFile.generic_string()));
 			m_fileRepository.setSourceByUri(
 				m_fileRepository.sourceUnitNameToUri(projectFile.generic_string()),
-				util::readFileAsString(projectFile)
+				std::string(SourceStore::instance().load(projectFile)->text())
 			);
 		}
 
@@ -264,27 +348,164 @@ void LanguageServer::compile()
 			oldRepository.sourceUnits().at(oldRepository.uriToSourceUnitName(fileName))
 		);
 
-	// TODO: optimize! do not recompile if nothing has changed (file(s) not flagged dirty).
+	// Imported files are read again to notice changes on disk.
+	for (std::string const& sourceUnitName: m_analyzedSources | ranges::views::keys)
+		if (!m_fileRepository.sourceUnits().count(sourceUnitName))
+			m_fileRepository.readFile(ReadCallback::kindString(ReadCallback::Kind::ReadFile), sourceUnitName);
+
+	StringMap const& sources = m_fileRepository.sourceUnits();
+	std::set<std::string> changedSources;
+	for (auto const& [sourceUnitName, content]: sources)
+		if (auto it = m_analyzedSources.find(sourceUnitName); it == m_analyzedSources.end() || it->second != content)
+			changedSources.insert(sourceUnitName);
+
+	Compilation compilation;
+	for (std::string const& sourceUnitName: m_analyzedSources | ranges::views::keys)
+		if (!sources.count(sourceUnitName))
+		{
+			changedSources.insert(sourceUnitName);
+			compilation.removedSources.insert(sourceUnitName);
+		}
+
+	// The sources that import changed sources, directly or indirectly, have to be analyzed again.
+	std::map<std::string, std::set<std::string>> importedBy;
+	for (auto const& [sourceUnitName, imports]: m_imports)
+		for (std::string const& import: imports)
+			importedBy[import].insert(sourceUnitName);
+	std::set<std::string> affectedSources;
+	std::vector<std::string> toVisit(changedSources.begin(), changedSources.end());
+	while (!toVisit.empty())
+	{
+		std::string sourceUnitName = std::move(toVisit.back());
+		toVisit.pop_back();
+		if (!affectedSources.insert(sourceUnitName).second)
+			continue;
+		if (auto it = importedBy.find(sourceUnitName); it != importedBy.end())
+			toVisit.insert(toVisit.end(), it->second.begin(), it->second.end());
+	}
+
+	for (auto const& [sourceUnitName, content]: sources)
+		if (
+			_allSources ||
+			sourceUnitName == _sourceUnitName ||
+			affectedSources.count(sourceUnitName) ||
+			m_incompleteSources.count(sourceUnitName)
+		)
+			compilation.sources[sourceUnitName] = content;
+
+	lspDebug(fmt::format("analyzing {} of {} sources", compilation.sources.size(), sources.size()));
+	compilation.fileRepository = std::make_shared<FileRepository>(m_fileRepository);
+	compilation.revision = m_revision;
+	compilation.allSources = _allSources;
+	return compilation;
+}
+
+void LanguageServer::runCompilation(Compilation& _compilation)
+{
+	if (_compilation.sources.empty())
+		return;
+
+	// The compiler stack reads the imported sources from its own copy of the file repository,
+	// which stays unchanged while the sources are edited.
+	std::shared_ptr<FileRepository> fileRepository = _compilation.fileRepository;
+	_compilation.compilerStack = std::make_unique<CompilerStack>(
+		[fileRepository](std::string const& _kind, std::string const& _sourceUnitName) {
+			return fileRepository->readFile(_kind, _sourceUnitName);
+		}
+	);
+	_compilation.compilerStack->setCancellationFlag(_compilation.cancelled.get());
+	_compilation.compilerStack->setSources(std::move(_compilation.sources));
+	_compilation.compilerStack->parseAndAnalyze(CompilerStack::State::AnalysisSuccessful);
+}
+
+void LanguageServer::finishCompilation(Compilation _compilation)
+{
+	if (*_compilation.cancelled || _compilation.revision < m_analyzedRevision)
+		return;
+	m_analyzedRevision = _compilation.revision;
+
+	for (std::string const& sourceUnitName: _compilation.removedSources)
+	{
+		m_analyzedSources.erase(sourceUnitName);
+		m_imports.erase(sourceUnitName);
+		m_incompleteSources.erase(sourceUnitName);
+	}
+
+	std::set<std::string> analyzedSources;
+	langutil::ErrorList errors;
+	if (_compilation.compilerStack)
+	{
+		CompilerStack const& compilerStack = *_compilation.compilerStack;
+		bool const parsed = compilerStack.state() >= CompilerStack::State::Parsed;
+		errors = compilerStack.errors();
+
+		std::set<std::string> sourcesWithErrors;
+		for (std::shared_ptr<Error const> const& error: errors)
+			if (Error::isError(error->severity()) && error->sourceLocation() && error->sourceLocation()->sourceName)
+				sourcesWithErrors.insert(*error->sourceLocation()->sourceName);
 
-	m_compilerStack.reset(false);
-	m_compilerStack.setSources(m_fileRepository.sourceUnits());
-	solUnimplemented("TODO Uncomment this");
-	//m_compilerStack.compile(CompilerStack::State::AnalysisSuccessful);
+		for (std::string const& sourceUnitName: compilerStack.sourceNames())
+		{
+			// The standard library is not read from files and never changes.
+			if (!_compilation.fileRepository->sourceUnits().count(sourceUnitName))
+				continue;
+			analyzedSources.insert(sourceUnitName);
+			m_analyzedSources[sourceUnitName] = std::string(compilerStack.charStream(sourceUnitName).source());
+			if (parsed)
+			{
+				std::set<std::string>& imports = m_imports[sourceUnitName];
+				imports.clear();
+				for (SourceUnit const* import: compilerStack.ast(sourceUnitName).referencedSourceUnits())
+					imports.insert(*import->location().sourceName);
+			}
+		}
+
+		// Errors in one source stop the analysis of all sources. The sources that neither have errors
+		// nor import sources with errors are analyzed again the next time to complete their diagnostics.
+		m_incompleteSources.clear();
+		if (!sourcesWithErrors.empty())
+			for (std::string const& sourceUnitName: analyzedSources)
+			{
+				std::set<std::string> visited;
+				std::vector<std::string> toVisit{sourceUnitName};
+				bool importsErrors = false;
+				while (!toVisit.empty() && !importsErrors)
+				{
+					std::string current = std::move(toVisit.back());
+					toVisit.pop_back();
+					if (!visited.insert(current).second)
+						continue;
+					importsErrors = sourcesWithErrors.count(current) > 0;
+					if (auto it = m_imports.find(current); it != m_imports.end())
+						toVisit.insert(toVisit.end(), it->second.begin(), it->second.end());
+				}
+				if (!importsErrors)
+					m_incompleteSources.insert(sourceUnitName);
+			}
+
+		m_compilerStack = std::move(_compilation.compilerStack);
+		m_allSourcesAnalyzed = _compilation.allSources;
+	}
+
+	analyzedSources += _compilation.removedSources;
+	publishDiagnostics(errors, analyzedSources);
 }
 
 void LanguageServer::compileAndUpdateDiagnostics()
 {
 	compile();
+}
 
+void LanguageServer::publishDiagnostics(ErrorList const& _errors, std::set<std::string> const& _sourceUnitNames)
+{
 	// These are the source units we will sent diagnostics to the client for sure,
-	// even if it is just to clear previous diagnostics.
+	// even if it is just to clear previous diagnostics. The diagnostics of the other
+	// source units did not change.
 	std::map<std::string, Json::Value> diagnosticsBySourceUnit;
-	for (std::string const& sourceUnitName: m_fileRepository.sourceUnits() | ranges::views::keys)
-		diagnosticsBySourceUnit[sourceUnitName] = Json::arrayValue;
-	for (std::string const& sourceUnitName: m_nonemptyDiagnostics)
+	for (std::string const& sourceUnitName: _sourceUnitNames)
 		diagnosticsBySourceUnit[sourceUnitName] = Json::arrayValue;
 
-	for (std::shared_ptr<Error const> const& error: m_compilerStack.errors())
+	for (std::shared_ptr<Error const> const& error: _errors)
 	{
 		SourceLocation const* location = error->sourceLocation();
 		if (!location || !location->sourceName)
@@ -320,18 +541,216 @@ void LanguageServer::compileAndUpdateDiagnostics()
 		m_client.trace("Number of currently open files: " + std::to_string(diagnosticsBySourceUnit.size()), extra);
 	}
 
-	m_nonemptyDiagnostics.clear();
 	for (auto&& [sourceUnitName, diagnostics]: diagnosticsBySourceUnit)
 	{
 		Json::Value params;
 		params["uri"] = m_fileRepository.sourceUnitNameToUri(sourceUnitName);
-		if (!diagnostics.empty())
-			m_nonemptyDiagnostics.insert(sourceUnitName);
 		params["diagnostics"] = std::move(diagnostics);
 		m_client.notify("textDocument/publishDiagnostics", std::move(params));
 	}
 }
 
+void LanguageServer::scheduleCompilation()
+{
+	++m_revision;
+	m_lastChange = std::chrono::steady_clock::now();
+	if (m_runningCompilationCancelled)
+		*m_runningCompilationCancelled = true;
+	m_compilationRequested.notify_all();
+}
+
+void LanguageServer::compilationLoop()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (!m_stopCompilation)
+	{
+		bool const analysisOutdated = m_analyzedRevision != m_revision;
+		bool const codeMetricsOutdated = m_tvmMetrics && m_codeMetricsRevision != m_revision;
+		if ((!analysisOutdated && !codeMetricsOutdated) || m_state != State::Initialized)
+		{
+			m_compilationRequested.wait(lock);
+			continue;
+		}
+		// Wait until the sources did not change for a while, so that typing does not start an analysis on every key stroke.
+		if (auto const due = m_lastChange + m_compilationDelay; std::chrono::steady_clock::now() < due)
+		{
+			m_compilationRequested.wait_until(lock, due);
+			continue;
+		}
+
+		if (!analysisOutdated)
+		{
+			CodeMetrics metrics = prepareCodeMetrics();
+			m_runningCompilationCancelled = metrics.cancelled;
+			lock.unlock();
+			std::string failure;
+			try
+			{
+				runCodeMetrics(metrics);
+			}
+			catch (...)
+			{
+				failure = boost::current_exception_diagnostic_information();
+			}
+			lock.lock();
+			m_runningCompilationCancelled = nullptr;
+
+			if (failure.empty())
+				finishCodeMetrics(std::move(metrics));
+			else if (!*metrics.cancelled)
+			{
+				// Generating the same code again would fail again.
+				m_codeMetricsRevision = metrics.revision;
+				m_client.trace("Estimating the code failed: " + failure);
+			}
+			continue;
+		}
+
+		Compilation compilation = prepareCompilation({}, false);
+		m_runningCompilationCancelled = compilation.cancelled;
+		lock.unlock();
+		std::string failure;
+		try
+		{
+			runCompilation(compilation);
+		}
+		catch (...)
+		{
+			failure = boost::current_exception_diagnostic_information();
+		}
+		lock.lock();
+		m_runningCompilationCancelled = nullptr;
+
+		if (failure.empty())
+			finishCompilation(std::move(compilation));
+		else if (!*compilation.cancelled)
+		{
+			// Analyzing the same sources again would fail again.
+			m_analyzedRevision = std::max(m_analyzedRevision, compilation.revision);
+			m_client.trace("Analysis failed: " + failure);
+		}
+	}
+}
+
+LanguageServer::CodeMetrics LanguageServer::prepareCodeMetrics()
+{
+	CodeMetrics metrics;
+	for (std::string const& uri: m_openFiles)
+	{
+		std::string const sourceUnitName = m_fileRepository.uriToSourceUnitName(uri);
+		if (auto it = m_fileRepository.sourceUnits().find(sourceUnitName); it != m_fileRepository.sourceUnits().end())
+			metrics.sources[sourceUnitName] = it->second;
+	}
+	metrics.fileRepository = std::make_shared<FileRepository>(m_fileRepository);
+	metrics.revision = m_revision;
+	metrics.budget = m_tvmMetricsBudget;
+	return metrics;
+}
+
+void LanguageServer::runCodeMetrics(CodeMetrics& _metrics)
+{
+	std::shared_ptr<FileRepository> fileRepository = _metrics.fileRepository;
+	for (std::string const& sourceUnitName: _metrics.sources | ranges::views::keys)
+		_metrics.codeLenses[fileRepository->sourceUnitNameToUri(sourceUnitName)] = Json::arrayValue;
+	if (_metrics.sources.empty())
+		return;
+
+	auto const deadline = std::chrono::steady_clock::now() + _metrics.budget;
+
+	// The code is generated by a compiler stack of its own, because the one of the last analysis
+	// is used by the requests while the code is generated.
+	CompilerStack compilerStack(
+		[fileRepository](std::string const& _kind, std::string const& _sourceUnitName) {
+			return fileRepository->readFile(_kind, _sourceUnitName);
+		}
+	);
+	// The budget covers the analysis and the code generation, which stop once it ran out.
+	compilerStack.setCancellationFlag(_metrics.cancelled.get());
+	compilerStack.setDeadline(deadline);
+	compilerStack.setSources(_metrics.sources);
+	auto const budgetRanOut = [&]() { return !*_metrics.cancelled && std::chrono::steady_clock::now() > deadline; };
+	// Sources with errors have no code. Their diagnostics come from the analysis.
+	if (!compilerStack.parseAndAnalyze(CompilerStack::State::AnalysisSuccessful))
+	{
+		if (budgetRanOut())
+			_metrics.incomplete = "The time budget ran out before the code was generated.";
+		return;
+	}
+
+	for (std::string const& sourceUnitName: _metrics.sources | ranges::views::keys)
+	{
+		Json::Value& codeLenses = _metrics.codeLenses[fileRepository->sourceUnitNameToUri(sourceUnitName)];
+		CharStream const& charStream = compilerStack.charStream(sourceUnitName);
+		for (ContractDefinition const* contract: ASTNode::filteredNodes<ContractDefinition>(compilerStack.ast(sourceUnitName).nodes()))
+		{
+			if (!contract->canBeDeployed())
+				continue;
+			if (*_metrics.cancelled)
+				return;
+			if (budgetRanOut())
+			{
+				_metrics.incomplete = fmt::format("The time budget ran out before {} was compiled.", contract->name());
+				return;
+			}
+
+			std::shared_ptr<Contract> code = compilerStack.generateCode(*contract);
+			if (*_metrics.cancelled)
+				return;
+			if (!code && budgetRanOut())
+			{
+				_metrics.incomplete = fmt::format("The time budget ran out while {} was compiled.", contract->name());
+				return;
+			}
+			if (!code)
+				continue;
+
+			// A public function has a wrapper that calls or inlines the function itself.
+			// The wrapper shows the cost of calling the function from outside.
+			std::map<FunctionDefinition const*, FunctionCodeMetrics> byDefinition;
+			for (FunctionCodeMetrics const& metrics: TVMCodeMetrics(*code).functions())
+				if (FunctionDefinition const* function = metrics.function->functionDefinition())
+					if (*function->location().sourceName == sourceUnitName)
+					{
+						auto [it, inserted] = byDefinition.emplace(function, metrics);
+						if (!inserted && it->second.function->functionId() && !metrics.function->functionId())
+							it->second = metrics;
+					}
+
+			for (auto const& [function, metrics]: byDefinition)
+			{
+				std::optional<SourceLocation> location = declarationLocation(function);
+				if (!location || !location->hasText())
+					continue;
+				std::string title = codeLensTitle(metrics);
+				if (function->scope() != contract)
+					title = contract->name() + ": " + title;
+
+				Json::Value codeLens;
+				codeLens["range"] = toJsonRange(
+					charStream.translatePositionToLineColumn(location->start),
+					charStream.translatePositionToLineColumn(location->end)
+				);
+				codeLens["command"]["title"] = std::move(title);
+				codeLens["command"]["command"] = "";
+				codeLenses.append(std::move(codeLens));
+			}
+		}
+	}
+}
+
+void LanguageServer::finishCodeMetrics(CodeMetrics _metrics)
+{
+	if (*_metrics.cancelled || _metrics.revision != m_revision || !m_tvmMetrics)
+		return;
+	m_codeMetricsRevision = _metrics.revision;
+	if (!_metrics.incomplete.empty())
+		m_client.trace(_metrics.incomplete);
+
+	m_codeLenses = std::move(_metrics.codeLenses);
+	if (m_codeLensRefreshSupport)
+		m_client.request("workspace/codeLens/refresh", Json::nullValue);
+}
+
 bool LanguageServer::run()
 {
 	while (m_state != State::ExitRequested && m_state != State::ExitWithoutShutdown && !m_client.closed())
@@ -343,6 +762,8 @@ bool LanguageServer::run()
 			if (!jsonMessage)
 				continue;
 
+			std::lock_guard<std::mutex> lock(m_mutex);
+
 			if ((*jsonMessage)["method"].isString())
 			{
 				std::string const methodName = (*jsonMessage)["method"].asString();
@@ -354,19 +775,25 @@ bool LanguageServer::run()
 				else
 					m_client.error(id, ErrorCode::MethodNotFound, "Unknown method " + methodName);
 			}
+			else if (jsonMessage->isMember("result") || jsonMessage->isMember("error"))
+				// Responses to the requests of the server are not needed.
+				continue;
 			else
 				m_client.error({}, ErrorCode::ParseError, "\"method\" has to be a string.");
 		}
 		catch (Json::Exception const&)
 		{
+			std::lock_guard<std::mutex> lock(m_mutex);
 			m_client.error(id, ErrorCode::InvalidParams, "JSON object access error. Most likely due to a badly formatted JSON request message."s);
 		}
 		catch (RequestError const& error)
 		{
+			std::lock_guard<std::mutex> lock(m_mutex);
 			m_client.error(id, error.code(), error.comment() ? *error.comment() : ""s);
 		}
 		catch (...)
 		{
+			std::lock_guard<std::mutex> lock(m_mutex);
 			m_client.error(id, ErrorCode::InternalError, "Unhandled exception: "s + boost::current_exception_diagnostic_information());
 		}
 	}
@@ -411,6 +838,8 @@ void LanguageServer::handleInitialize(MessageID _id, Json::Value const& _args)
 	if (_args["trace"])
 		setTrace(_args["trace"]);
 
+	m_codeLensRefreshSupport = _args["capabilities"]["workspace"]["codeLens"]["refreshSupport"].asBool();
+
 	m_fileRepository = FileRepository(rootPath, {});
 	if (_args["initializationOptions"].isObject())
 		changeConfiguration(_args["initializationOptions"]);
@@ -424,9 +853,10 @@ void LanguageServer::handleInitialize(MessageID _id, Json::Value const& _args)
 	replyArgs["capabilities"]["textDocumentSync"]["openClose"] = true;
 	replyArgs["capabilities"]["semanticTokensProvider"]["legend"] = semanticTokensLegend();
 	replyArgs["capabilities"]["semanticTokensProvider"]["range"] = false;
-	replyArgs["capabilities"]["semanticTokensProvider"]["full"] = true; // XOR requests.full.delta = true
+	replyArgs["capabilities"]["semanticTokensProvider"]["full"]["delta"] = true;
 	replyArgs["capabilities"]["renameProvider"] = true;
 	replyArgs["capabilities"]["hoverProvider"] = true;
+	replyArgs["capabilities"]["codeLensProvider"]["resolveProvider"] = false;
 
 	m_client.reply(_id, std::move(replyArgs));
 }
@@ -437,23 +867,91 @@ void LanguageServer::handleInitialized(MessageID, Json::Value const&)
 		compileAndUpdateDiagnostics();
 }
 
+LanguageServer::SemanticTokens const& LanguageServer::updateSemanticTokens(std::string const& _uri)
+{
+	auto const sourceName = m_fileRepository.uriToSourceUnitName(_uri);
+	SourceUnit const& ast = m_compilerStack->ast(sourceName);
+	Json::Value data = SemanticTokensBuilder().build(ast, m_compilerStack->charStream(sourceName));
+
+	SemanticTokens& tokens = m_semanticTokens[_uri];
+	tokens.resultId = std::to_string(++tokens.responses);
+	tokens.data = std::move(data);
+	return tokens;
+}
+
 void LanguageServer::semanticTokensFull(MessageID _id, Json::Value const& _args)
 {
-	auto uri = _args["textDocument"]["uri"];
+	SemanticTokens const& tokens = updateSemanticTokens(_args["textDocument"]["uri"].asString());
 
-	compile();
+	Json::Value reply = Json::objectValue;
+	reply["resultId"] = tokens.resultId;
+	reply["data"] = tokens.data;
+
+	m_client.reply(_id, std::move(reply));
+}
 
-	auto const sourceName = m_fileRepository.uriToSourceUnitName(uri.as<std::string>());
-	SourceUnit const& ast = m_compilerStack.ast(sourceName);
-	m_compilerStack.charStream(sourceName);
-	Json::Value data = SemanticTokensBuilder().build(ast, m_compilerStack.charStream(sourceName));
+void LanguageServer::semanticTokensFullDelta(MessageID _id, Json::Value const& _args)
+{
+	std::string const uri = _args["textDocument"]["uri"].asString();
+
+	std::optional<Json::Value> previousData;
+	if (auto it = m_semanticTokens.find(uri); it != m_semanticTokens.end() && it->second.resultId == _args["previousResultId"].asString())
+		previousData = it->second.data;
+	SemanticTokens const& tokens = updateSemanticTokens(uri);
 
 	Json::Value reply = Json::objectValue;
-	reply["data"] = data;
+	reply["resultId"] = tokens.resultId;
+	if (!previousData)
+	{
+		// The client does not have the tokens the edits would apply to.
+		reply["data"] = tokens.data;
+		m_client.reply(_id, std::move(reply));
+		return;
+	}
+
+	// A single edit replaces the tokens between the unchanged beginning and the unchanged end.
+	Json::Value const& oldData = *previousData;
+	Json::Value const& newData = tokens.data;
+	Json::ArrayIndex const oldSize = oldData.size();
+	Json::ArrayIndex const newSize = newData.size();
+	Json::ArrayIndex prefix = 0;
+	while (prefix < oldSize && prefix < newSize && oldData[prefix] == newData[prefix])
+		++prefix;
+	Json::ArrayIndex suffix = 0;
+	while (
+		suffix < oldSize - prefix &&
+		suffix < newSize - prefix &&
+		oldData[oldSize - 1 - suffix] == newData[newSize - 1 - suffix]
+	)
+		++suffix;
+
+	reply["edits"] = Json::arrayValue;
+	if (prefix + suffix < oldSize || prefix + suffix < newSize)
+	{
+		Json::Value edit = Json::objectValue;
+		edit["start"] = prefix;
+		edit["deleteCount"] = oldSize - prefix - suffix;
+		edit["data"] = Json::arrayValue;
+		for (Json::ArrayIndex i = prefix; i < newSize - suffix; ++i)
+			edit["data"].append(newData[i]);
+		reply["edits"].append(std::move(edit));
+	}
 
 	m_client.reply(_id, std::move(reply));
 }
 
+void LanguageServer::codeLens(MessageID _id, Json::Value const& _args)
+{
+	requireServerInitialized();
+
+	// The code lenses are computed in the background and are not waited for.
+	std::string const uri = _args["textDocument"]["uri"].asString();
+	if (auto it = m_codeLenses.find(uri); it != m_codeLenses.end())
+		m_client.reply(_id, it->second);
+	else
+		m_client.reply(_id, Json::arrayValue);
+}
+
 void LanguageServer::handleWorkspaceDidChangeConfiguration(Json::Value const& _args)
 {
 	requireServerInitialized();
@@ -491,7 +989,7 @@ void LanguageServer::handleTextDocumentDidOpen(Json::Value const& _args)
 	std::string uri = _args["textDocument"]["uri"].asString();
 	m_openFiles.insert(uri);
 	m_fileRepository.setSourceByUri(uri, std::move(text));
-	compileAndUpdateDiagnostics();
+	scheduleCompilation();
 }
 
 void LanguageServer::handleTextDocumentDidChange(Json::Value const& _args)
@@ -532,7 +1030,9 @@ void LanguageServer::handleTextDocumentDidChange(Json::Value const& _args)
 		m_fileRepository.setSourceByUri(uri, std::move(text));
 	}
 
-	compileAndUpdateDiagnostics();
+	// The code lenses would be shown at the wrong lines.
+	m_codeLenses.erase(uri);
+	scheduleCompilation();
 }
 
 void LanguageServer::handleTextDocumentDidClose(Json::Value const& _args)
@@ -547,8 +1047,10 @@ void LanguageServer::handleTextDocumentDidClose(Json::Value const& _args)
 
 	std::string uri = _args["textDocument"]["uri"].asString();
 	m_openFiles.erase(uri);
+	m_semanticTokens.erase(uri);
+	m_codeLenses.erase(uri);
 
-	compileAndUpdateDiagnostics();
+	scheduleCompilation();
 }
 
 ASTNode const* LanguageServer::astNodeAtSourceLocation(std::string const& _sourceUnitName, LineColumn const& _filePos)
@@ -558,14 +1060,17 @@ ASTNode const* LanguageServer::astNodeAtSourceLocation(std::string const& _sourc
 
 std::tuple<ASTNode const*, int> LanguageServer::astNodeAndOffsetAtSourceLocation(std::string const& _sourceUnitName, LineColumn const& _filePos)
 {
-	if (m_compilerStack.state() < CompilerStack::AnalysisSuccessful)
+	if (m_compilerStack->state() < CompilerStack::AnalysisSuccessful)
 		return {nullptr, -1};
-	if (!m_fileRepository.sourceUnits().count(_sourceUnitName))
+	if (
+		!m_fileRepository.sourceUnits().count(_sourceUnitName) ||
+		!util::contains(m_compilerStack->sourceNames(), _sourceUnitName)
+	)
 		return {nullptr, -1};
 
-	std::optional<int> sourcePos = m_compilerStack.charStream(_sourceUnitName).translateLineColumnToPosition(_filePos);
+	std::optional<int> sourcePos = m_compilerStack->charStream(_sourceUnitName).translateLineColumnToPosition(_filePos);
 	if (!sourcePos)
 		return {nullptr, -1};
 
-	return {locateInnermostASTNode(*sourcePos, m_compilerStack.ast(_sourceUnitName)), *sourcePos};
+	return {locateInnermostASTNode(*sourcePos, m_compilerStack->ast(_sourceUnitName)), *sourcePos};
 }
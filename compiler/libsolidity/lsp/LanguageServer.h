@@ -24,10 +24,18 @@
 
 #include <json/value.h>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <set>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace solidity::lsp
@@ -57,14 +65,24 @@ enum class FileLoadStrategy
  * Solidity Language Server, managing one LSP client.
  * This implements a subset of LSP version 3.16 that can be found at:
  * https://microsoft.github.io/language-server-protocol/specifications/specification-3-16/
+ *
+ * Only the sources that changed since they were last analyzed and the sources that import them
+ * are analyzed again. Changes to documents are analyzed on a separate thread once no further
+ * change arrived for a short while. Requests that need the analysis wait for it.
+ *
+ * If enabled by the setting "tvm-metrics", the TVM code of the contracts in the open documents is
+ * generated afterwards on the same thread, and the estimated size and gas of their functions are
+ * shown as code lenses.
  */
 class LanguageServer
 {
 public:
 	/// @param _transport Customizable transport layer.
 	explicit LanguageServer(Transport& _transport);
+	~LanguageServer();
 
-	/// Re-compiles the project and updates the diagnostics pushed to the client.
+	/// Analyzes the sources that changed since the last analysis and updates their diagnostics
+	/// pushed to the client.
 	void compileAndUpdateDiagnostics();
 
 	/// Loops over incoming messages via the transport layer until shutdown condition is met.
@@ -79,7 +97,7 @@ public:
 	Transport& client() noexcept { return m_client; }
 	std::tuple<frontend::ASTNode const*, int> astNodeAndOffsetAtSourceLocation(std::string const& _sourceUnitName, langutil::LineColumn const& _filePos);
 	frontend::ASTNode const* astNodeAtSourceLocation(std::string const& _sourceUnitName, langutil::LineColumn const& _filePos);
-	frontend::CompilerStack const& compilerStack() const noexcept { return m_compilerStack; }
+	frontend::CompilerStack const& compilerStack() const noexcept { return *m_compilerStack; }
 
 private:
 	/// Checks if the server is initialized (to be used by messages that need it to be initialized).
@@ -95,16 +113,88 @@ private:
 	void handleRename(Json::Value const& _args);
 	void handleGotoDefinition(MessageID _id, Json::Value const& _args);
 	void semanticTokensFull(MessageID _id, Json::Value const& _args);
+	void semanticTokensFullDelta(MessageID _id, Json::Value const& _args);
+	void codeLens(MessageID _id, Json::Value const& _args);
 
 	/// Invoked when the server user-supplied configuration changes (initiated by the client).
 	void changeConfiguration(Json::Value const&);
 
-	/// Compile everything until after analysis phase.
-	void compile();
+	using MessageHandler = std::function<void(MessageID, Json::Value const&)>;
 
-	std::vector<boost::filesystem::path> allSolidityFilesFromProject() const;
+	/// Sources of one analysis and its result.
+	struct Compilation
+	{
+		/// Source units to analyze, in addition to the ones they import.
+		StringMap sources;
+		/// Source units that were analyzed before, but do not exist anymore.
+		std::set<std::string> removedSources;
+		/// Copy of the file repository that the imported sources are read from.
+		std::shared_ptr<FileRepository> fileRepository;
+		std::uint64_t revision = 0;
+		bool allSources = false;
+		std::shared_ptr<std::atomic<bool>> cancelled = std::make_shared<std::atomic<bool>>(false);
+		std::unique_ptr<frontend::CompilerStack> compilerStack;
+	};
 
-	using MessageHandler = std::function<void(MessageID, Json::Value const&)>;
+	/// Sources and result of estimating the code of the contracts in the open documents.
+	struct CodeMetrics
+	{
+		/// Source units of the open documents.
+		StringMap sources;
+		std::shared_ptr<FileRepository> fileRepository;
+		std::uint64_t revision = 0;
+		/// Time for the analysis and the code generation, both stop once it ran out.
+		std::chrono::milliseconds budget{};
+		std::shared_ptr<std::atomic<bool>> cancelled = std::make_shared<std::atomic<bool>>(false);
+		/// Code lenses of the open documents, by URI.
+		std::map<std::string, Json::Value> codeLenses;
+		/// Why the code of some contracts was not estimated, if it was not.
+		std::string incomplete;
+	};
+
+	/// The semantic tokens last sent for a document.
+	struct SemanticTokens
+	{
+		/// Counts the responses for the document, so that the ids do not depend on other documents.
+		std::uint64_t responses = 0;
+		std::string resultId;
+		Json::Value data;
+	};
+
+	/// @returns @a _handler preceded by the analysis of the document the request refers to,
+	/// or of all sources if @a _allSources is true.
+	MessageHandler withAnalysis(MessageHandler _handler, bool _allSources = false);
+
+	/// Analyzes the sources that changed since the last analysis, the sources that import them and
+	/// @a _sourceUnitName, or all sources if @a _allSources is true, unless the analysis is up to date.
+	/// Updates the diagnostics of the analyzed sources.
+	void compile(std::string const& _sourceUnitName = {}, bool _allSources = false);
+
+	/// Reloads the sources and selects the ones to analyze. Requires m_mutex to be locked.
+	Compilation prepareCompilation(std::string const& _sourceUnitName, bool _allSources);
+	/// Parses and analyzes the sources of @a _compilation. Does not access the state of the server.
+	static void runCompilation(Compilation& _compilation);
+	/// Makes the result of @a _compilation current unless it was cancelled and updates the
+	/// diagnostics of the analyzed sources. Requires m_mutex to be locked.
+	void finishCompilation(Compilation _compilation);
+	void publishDiagnostics(langutil::ErrorList const& _errors, std::set<std::string> const& _sourceUnitNames);
+
+	/// Records that the sources changed and requests their analysis on the compilation thread.
+	void scheduleCompilation();
+	void compilationLoop();
+
+	/// Copies the open documents. Requires m_mutex to be locked.
+	CodeMetrics prepareCodeMetrics();
+	/// Compiles the contracts of the open documents that can be deployed and estimates the size and
+	/// gas of their functions. Does not access the state of the server.
+	static void runCodeMetrics(CodeMetrics& _metrics);
+	/// Makes the code lenses of @a _metrics current unless the sources changed. Requires m_mutex to be locked.
+	void finishCodeMetrics(CodeMetrics _metrics);
+
+	/// Computes the semantic tokens of the document @a _uri under a new result id.
+	SemanticTokens const& updateSemanticTokens(std::string const& _uri);
+
+	std::vector<boost::filesystem::path> allSolidityFilesFromProject() const;
 
 	Json::Value toRange(langutil::SourceLocation const& _location);
 	Json::Value toJson(langutil::SourceLocation const& _location);
@@ -119,15 +209,52 @@ private:
 
 	/// Set of files (names in URI form) known to be open by the client.
 	std::set<std::string> m_openFiles;
-	/// Set of source unit names for which we sent diagnostics to the client in the last iteration.
-	std::set<std::string> m_nonemptyDiagnostics;
 	FileRepository m_fileRepository;
 	FileLoadStrategy m_fileLoadStrategy = FileLoadStrategy::ProjectDirectory;
 
-	frontend::CompilerStack m_compilerStack;
+	/// Result of the last analysis.
+	std::unique_ptr<frontend::CompilerStack> m_compilerStack;
+	/// Whether the last analysis included all sources.
+	bool m_allSourcesAnalyzed = false;
+	/// Contents of the source units as of the last analysis that included them.
+	std::map<std::string, std::string> m_analyzedSources;
+	/// Source units imported by each analyzed source unit.
+	std::map<std::string, std::set<std::string>> m_imports;
+	/// Source units without errors whose last analysis stopped early because of errors elsewhere.
+	std::set<std::string> m_incompleteSources;
+
+	/// Incremented whenever the sources change.
+	std::uint64_t m_revision = 1;
+	/// Revision of the sources that were last analyzed.
+	std::uint64_t m_analyzedRevision = 0;
+	std::chrono::steady_clock::time_point m_lastChange;
+	/// Time without changes after which the changes are analyzed.
+	std::chrono::milliseconds m_compilationDelay{300};
+	/// Cancellation flag of the analysis running on the compilation thread, if any.
+	std::shared_ptr<std::atomic<bool>> m_runningCompilationCancelled;
+
+	/// Whether the code metrics are shown, set by "tvm-metrics".
+	bool m_tvmMetrics = false;
+	/// Time for estimating the code of the open documents, set by "tvm-metrics-budget".
+	std::chrono::milliseconds m_tvmMetricsBudget{2000};
+	/// Revision of the sources whose code metrics were last computed.
+	std::uint64_t m_codeMetricsRevision = 0;
+	/// Code lenses of the open documents, by URI.
+	std::map<std::string, Json::Value> m_codeLenses;
+	/// Whether the client can be asked to request the code lenses again.
+	bool m_codeLensRefreshSupport = false;
+
+	std::map<std::string, SemanticTokens> m_semanticTokens;
 
 	/// User-supplied custom configuration settings (such as EVM version).
 	Json::Value m_settingsObject;
+
+	/// Guards the state of the server, which is shared by the thread handling the messages
+	/// and the compilation thread.
+	std::mutex m_mutex;
+	std::condition_variable m_compilationRequested;
+	bool m_stopCompilation = false;
+	std::thread m_compilationThread;
 };
 
 }
@@ -111,6 +111,16 @@ void Transport::notify(std::string _method, Json::Value _message)
 	send(std::move(json));
 }
 
+MessageID Transport::request(std::string _method, Json::Value _params)
+{
+	MessageID id = Json::UInt64{m_nextRequestId++};
+	Json::Value json;
+	json["method"] = std::move(_method);
+	json["params"] = std::move(_params);
+	send(std::move(json), id);
+	return id;
+}
+
 void Transport::reply(MessageID _id, Json::Value _message)
 {
 	Json::Value json;
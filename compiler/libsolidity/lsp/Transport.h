@@ -21,6 +21,7 @@
 
 #include <json/value.h>
 
+#include <cstdint>
 #include <functional>
 #include <iosfwd>
 #include <map>
@@ -100,6 +101,9 @@ public:
 
 	std::optional<Json::Value> receive();
 	void notify(std::string _method, Json::Value _params);
+	/// Sends a request to the client. Its response is not waited for.
+	/// @returns the id of the request.
+	MessageID request(std::string _method, Json::Value _params);
 	void reply(MessageID _id, Json::Value _result);
 	void error(MessageID _id, ErrorCode _code, std::string _message);
 
@@ -112,6 +116,7 @@ public:
 
 private:
 	TraceValue m_logTrace = TraceValue::Off;
+	std::uint64_t m_nextRequestId = 1;
 
 protected:
 	/// Reads from the transport and parses the headers until the beginning
@@ -134,7 +139,7 @@ protected:
 
 	/// Sends an arbitrary raw message to the client.
 	///
-	/// Used by the notify/reply/error function family.
+	/// Used by the notify/request/reply/error function family.
 	virtual void send(Json::Value _message, MessageID _id = Json::nullValue);
 };
 
@@ -74,7 +74,16 @@ public:
 		solAssert(m_location.sourceName, "");
 		if (m_location.end < 0)
 			markEndPosition();
-		return std::make_shared<NodeType>(m_parser.nextID(), m_location, std::forward<Args>(_args)...);
+		if (!m_parser.m_arena)
+			return std::make_shared<NodeType>(m_parser.nextID(), m_location, std::forward<Args>(_args)...);
+		auto node = std::allocate_shared<NodeType>(
+			ASTArena::Allocator<NodeType>{m_parser.m_arena},
+			m_parser.nextID(),
+			m_location,
+			std::forward<Args>(_args)...
+		);
+		node->allocateAnnotationIn(*m_parser.m_arena);
+		return node;
 	}
 
 	SourceLocation const& location() const noexcept { return m_location; }
@@ -91,6 +100,7 @@ ASTPointer<SourceUnit> Parser::parse(CharStream& _charStream)
 	{
 		m_recursionDepth = 0;
 		m_scanner = std::make_shared<Scanner>(_charStream);
+		m_arena = m_arenaAllocation ? std::make_shared<ASTArena>() : nullptr;
 		ASTNodeFactory nodeFactory(*this);
 		m_experimentalSolidityEnabledInCurrentSourceUnit = false;
 
@@ -169,10 +179,14 @@ ASTPointer<SourceUnit> Parser::parse(CharStream& _charStream)
 			}
 		}
 		solAssert(m_recursionDepth == 0, "");
-		return nodeFactory.createNode<SourceUnit>(findLicenseString(nodes), nodes, m_experimentalSolidityEnabledInCurrentSourceUnit);
+		auto sourceUnit = nodeFactory.createNode<SourceUnit>(findLicenseString(nodes), nodes, m_experimentalSolidityEnabledInCurrentSourceUnit);
+		// The nodes keep the arena alive from now on.
+		m_arena.reset();
+		return sourceUnit;
 	}
 	catch (FatalError const&)
 	{
+		m_arena.reset();
 		if (m_errorReporter.errors().empty())
 			throw; // Something is weird here, rather throw again.
 		return nullptr;
@@ -2691,24 +2705,25 @@ std::optional<std::string> Parser::findLicenseString(std::vector<ASTPointer<ASTN
 
 	// Search inside all parts of the source not covered by parsed nodes.
 	// This will leave e.g. "global comments".
-	using iter = std::string::const_iterator;
+	using iter = char const*;
 	std::vector<std::pair<iter, iter>> sequencesToSearch;
-	std::string const& source = m_scanner->charStream().source();
-	sequencesToSearch.emplace_back(source.begin(), source.end());
+	std::string_view const source = m_scanner->charStream().source();
+	iter const sourceEnd = source.data() + source.size();
+	sequencesToSearch.emplace_back(source.data(), sourceEnd);
 	for (ASTPointer<ASTNode> const& node: _nodes)
 		if (node->location().hasText())
 		{
-			sequencesToSearch.back().second = source.begin() + node->location().start;
-			sequencesToSearch.emplace_back(source.begin() + node->location().end, source.end());
+			sequencesToSearch.back().second = source.data() + node->location().start;
+			sequencesToSearch.emplace_back(source.data() + node->location().end, sourceEnd);
 		}
 
 	std::vector<std::string> licenseNames;
 	for (auto const& [start, end]: sequencesToSearch)
 	{
-		auto declarationsBegin = std::sregex_iterator(start, end, licenseDeclarationRegex);
-		auto declarationsEnd = std::sregex_iterator();
+		auto declarationsBegin = std::cregex_iterator(start, end, licenseDeclarationRegex);
+		auto declarationsEnd = std::cregex_iterator();
 
-		for (std::sregex_iterator declIt = declarationsBegin; declIt != declarationsEnd; ++declIt)
+		for (std::cregex_iterator declIt = declarationsBegin; declIt != declarationsEnd; ++declIt)
 			if (!declIt->empty())
 			{
 				std::string license = boost::trim_copy(std::string((*declIt)[1]));
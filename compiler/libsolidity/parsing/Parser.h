@@ -38,12 +38,16 @@ namespace solidity::frontend
 class Parser: public langutil::ParserBase
 {
 public:
+	/// @param _arenaAllocation if true, the nodes of each parsed source unit and their annotations
+	/// are allocated from an arena of that source unit, see ASTArena.
 	explicit Parser(
 		langutil::ErrorReporter& _errorReporter,
-		langutil::EVMVersion _evmVersion
+		langutil::EVMVersion _evmVersion,
+		bool _arenaAllocation = false
 	):
 		ParserBase(_errorReporter),
-		m_evmVersion(_evmVersion)
+		m_evmVersion(_evmVersion),
+		m_arenaAllocation(_arenaAllocation)
 	{}
 
 	ASTPointer<SourceUnit> parse(langutil::CharStream& _charStream);
@@ -256,6 +260,9 @@ private:
 	/// Flag that signifies whether '_' is parsed as a PlaceholderStatement or a regular identifier.
 	bool m_insideModifier = false;
 	langutil::EVMVersion m_evmVersion;
+	bool m_arenaAllocation = false;
+	/// Arena of the source unit that is currently parsed, if arena allocation is enabled.
+	std::shared_ptr<ASTArena> m_arena;
 	/// Counter for the next AST node ID
 	int64_t m_currentNodeID = 0;
 	/// Flag that indicates whether experimental mode is enabled in the current source unit
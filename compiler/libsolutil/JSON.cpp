@@ -86,6 +86,48 @@ bool parse(Json::CharReaderBuilder& _builder, std::string const& _input, Json::V
 	return reader->parse(_input.c_str(), _input.c_str() + _input.length(), &_json, _errs);
 }
 
+/// Writes @a _value in the format of the compact stream writer. Scalars are written by
+/// @a _scalarWriter, so that they are escaped and formatted exactly like by jsoncpp.
+void writeCompact(
+	std::ostream& _stream,
+	Json::Value const& _value,
+	Json::StreamWriter& _scalarWriter,
+	std::function<bool(Json::Value const&, std::ostream&)> const& _writeValue
+)
+{
+	if (_writeValue && _writeValue(_value, _stream))
+		return;
+
+	switch (_value.type())
+	{
+	case Json::arrayValue:
+		_stream << '[';
+		for (Json::ArrayIndex i = 0; i < _value.size(); ++i)
+		{
+			if (i > 0)
+				_stream << ',';
+			writeCompact(_stream, _value[i], _scalarWriter, _writeValue);
+		}
+		_stream << ']';
+		break;
+	case Json::objectValue:
+		_stream << '{';
+		for (auto it = _value.begin(); it != _value.end(); ++it)
+		{
+			if (it != _value.begin())
+				_stream << ',';
+			_scalarWriter.write(Json::Value(it.name()), &_stream);
+			_stream << ':';
+			writeCompact(_stream, *it, _scalarWriter, _writeValue);
+		}
+		_stream << '}';
+		break;
+	default:
+		_scalarWriter.write(_value, &_stream);
+		break;
+	}
+}
+
 /// Takes a JSON value (@ _json) and removes all its members with value 'null' recursively.
 void removeNullMembersHelper(Json::Value& _json)
 {
@@ -138,6 +180,17 @@ std::string jsonPrint(Json::Value const& _input, JsonFormat const& _format)
 	return result;
 }
 
+void jsonCompactPrint(
+	std::ostream& _stream,
+	Json::Value const& _input,
+	std::function<bool(Json::Value const&, std::ostream&)> const& _writeValue
+)
+{
+	StreamWriterBuilder writerBuilder(std::map<std::string, Json::Value>{{"indentation", ""}});
+	std::unique_ptr<Json::StreamWriter> scalarWriter(writerBuilder.newStreamWriter());
+	writeCompact(_stream, _input, *scalarWriter, _writeValue);
+}
+
 bool jsonParseStrict(std::string const& _input, Json::Value& _json, std::string* _errs /* = nullptr */)
 {
 	static StrictModeCharReaderBuilder readerBuilder;
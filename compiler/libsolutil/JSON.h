@@ -25,6 +25,8 @@
 
 #include <json/json.h>
 
+#include <functional>
+#include <ostream>
 #include <string>
 #include <string_view>
 #include <optional>
@@ -62,6 +64,15 @@ std::string jsonCompactPrint(Json::Value const& _input);
 /// Serialise the JSON object (@a _input) using specified format (@a _format)
 std::string jsonPrint(Json::Value const& _input, JsonFormat const& _format);
 
+/// Serialise the JSON object (@a _input) without indentation to @a _stream, value by value.
+/// The output is the same as that of jsonCompactPrint(), except for the values that
+/// @a _writeValue writes to the stream itself, which it signals by returning true.
+void jsonCompactPrint(
+	std::ostream& _stream,
+	Json::Value const& _input,
+	std::function<bool(Json::Value const&, std::ostream&)> const& _writeValue
+);
+
 /// Parse a JSON string (@a _input) with enabled strict-mode and writes resulting JSON object to (@a _json)
 /// \param _input JSON input string
 /// \param _json [out] resulting JSON object
@@ -22,6 +22,7 @@
 #include <libsolutil/Exceptions.h>
 
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <type_traits>
 #include <utility>
@@ -34,6 +35,7 @@ DEV_SIMPLE_EXCEPTION(BadLazyInitAccess);
 /**
  * A value that is initialized at some point after construction of the LazyInit. The stored value can only be accessed
  * while calling "init", which initializes the stored value (if it has not already been initialized).
+ * Concurrent calls of "init" initialize the value only once.
  *
  * @tparam T the type of the stored value; may not be a function, reference, array, or void type; may be const-qualified.
  */
@@ -85,11 +87,13 @@ private:
 	template<typename F>
 	void doInit(F&& _fun) const
 	{
+		std::lock_guard<std::mutex> lock(m_mutex);
 		if (!m_value.has_value())
 			m_value.emplace(std::forward<F>(_fun)());
 	}
 
 	mutable std::optional<value_type> m_value;
+	mutable std::mutex m_mutex;
 };
 
 }
@@ -36,6 +36,7 @@
 #include <libsolidity/interface/StandardCompiler.h>
 #include <libsolidity/interface/DebugSettings.h>
 #include <libsolidity/interface/ImportRemapper.h>
+#include <libsolidity/interface/SourceStore.h>
 #include <libsolidity/interface/StorageLayout.h>
 #include <libsolidity/lsp/LanguageServer.h>
 #include <libsolidity/lsp/Transport.h>
@@ -196,6 +197,10 @@ void CommandLineInterface::readInputFiles()
 	if (noInputFiles.count(m_options.input.mode) == 1)
 		return;
 
+	// The language server runs until it is stopped, while the files it has read are edited.
+	if (m_options.input.mode != InputMode::LanguageServer)
+		SourceStore::instance().setMapFiles(true);
+
 	m_fileReader.setBasePath(m_options.input.basePath);
 
 	if (m_fileReader.basePath() != "")
@@ -282,7 +287,7 @@ void CommandLineInterface::readInputFiles()
 
 	if (
 		m_options.input.mode != InputMode::LanguageServer &&
-		m_fileReader.sourceUnits().empty() &&
+		m_fileReader.sourceBuffers().empty() &&
 		!m_standardJsonInput.has_value()
 	)
 		solThrow(CommandLineValidationError, "All specified input files either do not exist or are not regular files.");
@@ -295,7 +300,8 @@ std::map<std::string, Json::Value> CommandLineInterface::parseAstFromInput()
 	std::map<std::string, Json::Value> sourceJsons;
 	std::map<std::string, std::string> tmpSources;
 
-	for (SourceCode const& sourceCode: m_fileReader.sourceUnits() | ranges::views::values)
+	StringMap const sources = m_fileReader.sourceUnits();
+	for (SourceCode const& sourceCode: sources | ranges::views::values)
 	{
 		Json::Value ast;
 		astAssert(jsonParseStrict(sourceCode, ast), "Input file could not be parsed to JSON");
@@ -526,10 +532,10 @@ void CommandLineInterface::compile()
 		}
 		else
 		{
-			StringMap const& src = m_fileReader.sourceUnits();
+			StringMap src = m_fileReader.sourceUnits();
 			solAssert(src.size() == 1, "");
 			m_compiler->setInputFile(src.begin()->first);
-			m_compiler->setSources(m_fileReader.sourceUnits());
+			m_compiler->setSources(std::move(src));
 		}
 
 		if (m_options.tvmParams.mainContract.has_value())
@@ -607,12 +613,12 @@ void CommandLineInterface::handleAst()
 		return;
 
 	std::vector<ASTNode const*> asts;
-	for (auto const& sourceCode: m_fileReader.sourceUnits())
+	for (auto const& sourceCode: m_fileReader.sourceBuffers())
 		asts.push_back(&m_compiler->ast(sourceCode.first));
 
 	if (!m_options.output.dir.empty())
 	{
-		for (auto const& sourceCode: m_fileReader.sourceUnits())
+		for (auto const& sourceCode: m_fileReader.sourceBuffers())
 		{
 			std::stringstream data;
 			std::string postfix = "";
@@ -624,7 +630,7 @@ void CommandLineInterface::handleAst()
 	}
 	else
 	{
-		for (auto const& sourceCode: m_fileReader.sourceUnits())
+		for (auto const& sourceCode: m_fileReader.sourceBuffers())
 		{
 			ASTJsonExporter(m_compiler->state(), m_compiler->sourceIndices()).print(sout(), m_compiler->ast(sourceCode.first), m_options.formatting.json);
 			sout() << std::endl;
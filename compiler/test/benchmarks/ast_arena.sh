@@ -0,0 +1,78 @@
+#!/usr/bin/env bash
+
+#------------------------------------------------------------------------------
+# Bash script that compares the time and peak memory of parsing and analysis
+# with and without arena allocation of the AST.
+# ------------------------------------------------------------------------------
+# This file is part of solidity.
+#
+# solidity is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# solidity is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with solidity.  If not, see <http://www.gnu.org/licenses/>
+#------------------------------------------------------------------------------
+
+set -euo pipefail
+
+REPO_ROOT=$(cd "$(dirname "$0")/../../" && pwd)
+SOLD=${SOLD:-${REPO_ROOT}/../target/release/sold}
+
+output_dir=$(mktemp -d -t sold-ast-arena-XXXXXX)
+result_file="${output_dir}/result.txt"
+warnings_and_errors_file="${output_dir}/warn-err.txt"
+
+function cleanup() {
+    rm -r "${output_dir}"
+    exit
+}
+
+trap cleanup SIGINT SIGTERM
+
+time_bin_path=$(type -P time)
+
+# Only the ABI is requested, so that the time is spent in parsing and analysis.
+function measure() {
+    local input_dir="$1"
+    shift
+    if ! "${time_bin_path}" --output "${result_file}" --format "%e s, %M KiB" \
+        "${SOLD}" --abi-json --output-dir "${output_dir}" --base-path "${input_dir}" "$@" \
+        >/dev/null 2>>"${warnings_and_errors_file}"
+    then
+        # A failed compilation would be timed as if it were a result.
+        echo "Compilation failed: ${SOLD} $*" >&2
+        cat "${warnings_and_errors_file}" >&2
+        rm -r "${output_dir}"
+        exit 1
+    fi
+    cat "${result_file}"
+}
+
+while IFS= read -r -d '' input_path
+do
+    input_dir=$(dirname "${input_path}")
+    time_heap=$(measure "${input_dir}" "${input_path}")
+    time_arena=$(measure "${input_dir}" "${input_path}" --ast-arena)
+
+    echo "======================================================="
+    echo "            ${input_path#"${REPO_ROOT}/"}"
+    echo "-------------------------------------------------------"
+    echo "heap allocated AST:  ${time_heap}"
+    echo "arena allocated AST: ${time_arena}"
+    echo "======================================================="
+done < <(find "${REPO_ROOT}/test/benchmarks/tvm" -name "*.sol" -print0 | sort -z)
+
+echo
+echo "======================================================="
+echo "Warnings and errors generated during run:"
+echo "======================================================="
+echo "$(<"${warnings_and_errors_file}")"
+
+cleanup
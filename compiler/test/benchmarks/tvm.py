@@ -0,0 +1,206 @@
+#!/usr/bin/env python3
+
+# ------------------------------------------------------------------------------
+# Compiles the contracts in test/benchmarks/tvm/ and compares the compile time,
+# the peak memory, the code size and the estimated gas of their functions with
+# a baseline.
+#
+# Each file is compiled as the contract named like the file. The report and the
+# baseline are JSON files of the form
+#   {"contracts": {"<name>": {"compileTime": <s>, "peakMemory": <KiB>,
+#                             "tvcBytes": <n>, "bits": <n>, "cells": <n>,
+#                             "functions": {"<name>": {"bits": <n>, "cells": <n>,
+#                                                      "minGas": <n>}}}}}
+# Sizes and gas are estimated by `sold --code-metrics` from the code before it
+# is assembled, except for the size of the .tvc file.
+#
+# The script exits with 1 if a value exceeds its baseline by more than the
+# threshold or if a contract has no baseline values, and with 2 if there is no
+# baseline or a contract fails to compile. Use --update-baseline after an
+# intended change. The baseline, tvm/baseline.json, is not checked in until it
+# is recorded with a release build of sold.
+# ------------------------------------------------------------------------------
+# This file is part of solidity.
+#
+# solidity is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# solidity is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with solidity.  If not, see <http://www.gnu.org/licenses/>
+# ------------------------------------------------------------------------------
+
+from argparse import ArgumentParser, Namespace
+import json
+import os
+from pathlib import Path
+import subprocess
+import sys
+import tempfile
+import time
+
+REPO_ROOT = Path(__file__).parent.parent.parent
+CORPUS_DIR = Path(__file__).parent / "tvm"
+DEFAULT_SOLD = REPO_ROOT.parent / "target" / "release" / "sold"
+DEFAULT_BASELINE = CORPUS_DIR / "baseline.json"
+
+
+class CompilationFailed(Exception):
+    pass
+
+
+def run_measured(command: list) -> tuple:
+    """Runs the command and returns its wall clock time in seconds and its peak memory in KiB."""
+    with tempfile.TemporaryFile() as stderr:
+        start = time.perf_counter()
+        with subprocess.Popen(command, stdout=subprocess.DEVNULL, stderr=stderr) as process:
+            # os.wait4() returns the resource usage of this process alone.
+            _, status, usage = os.wait4(process.pid, 0)
+            process.returncode = status
+        elapsed = time.perf_counter() - start
+        if status != 0:
+            stderr.seek(0)
+            raise CompilationFailed(stderr.read().decode(errors="replace"))
+    peak_memory = usage.ru_maxrss
+    if sys.platform == "darwin":
+        peak_memory //= 1024
+    return elapsed, peak_memory
+
+
+def measure_contract(sold: Path, source: Path, output_dir: Path) -> dict:
+    command = [str(sold), str(source), "--contract", source.stem, "--base-path", str(source.parent)]
+    compile_time, peak_memory = run_measured(command + ["--output-dir", str(output_dir)])
+
+    result = subprocess.run(command + ["--code-metrics"], capture_output=True, check=False)
+    if result.returncode != 0:
+        raise CompilationFailed(result.stderr.decode(errors="replace"))
+    metrics = json.loads(result.stdout)
+
+    return {
+        "compileTime": round(compile_time, 3),
+        "peakMemory": peak_memory,
+        "tvcBytes": (output_dir / f"{source.stem}.tvc").stat().st_size,
+        "bits": metrics["bits"],
+        "cells": metrics["cells"],
+        "functions": {
+            function["name"]: {
+                "bits": function["bits"],
+                "cells": function["cells"],
+                "minGas": function["minGas"],
+            }
+            for function in metrics["functions"]
+        },
+    }
+
+
+def run_benchmarks(sold: Path, names: list) -> dict:
+    contracts = {}
+    with tempfile.TemporaryDirectory(prefix="sold-tvm-benchmark-") as output_dir:
+        for source in sorted(CORPUS_DIR.glob("*.sol")):
+            if names and source.stem not in names:
+                continue
+            print(f"Compiling {source.relative_to(REPO_ROOT)}", file=sys.stderr)
+            contracts[source.stem] = measure_contract(sold, source, Path(output_dir))
+    return {"contracts": contracts}
+
+
+def compare(report: dict, baseline: dict, options: Namespace) -> bool:
+    """Prints the differences to the baseline and returns False if any of them exceeds its threshold."""
+    thresholds = {
+        "compileTime": options.time_threshold,
+        "peakMemory": options.memory_threshold,
+        "tvcBytes": options.size_threshold,
+        "bits": options.size_threshold,
+        "cells": options.size_threshold,
+        "minGas": options.gas_threshold,
+    }
+    regressions = []
+    unrecorded = []
+
+    def check(label: str, key: str, old, new):
+        if old is None or new is None or old == new:
+            return
+        change = (new - old) / old * 100 if old else float("inf")
+        regression = change > thresholds[key]
+        print(f"{'REGRESSION' if regression else 'changed':>10}  {label} {key}: {old} -> {new} ({change:+.2f}%)")
+        if regression:
+            regressions.append(label)
+
+    for name, contract in report["contracts"].items():
+        old_contract = baseline["contracts"].get(name)
+        if old_contract is None:
+            print(f"{'NO BASELINE':>10}  {name}")
+            unrecorded.append(name)
+            continue
+        for key in ("compileTime", "peakMemory", "tvcBytes", "bits", "cells"):
+            check(name, key, old_contract.get(key), contract[key])
+        old_functions = old_contract.get("functions", {})
+        for function_name, function in contract["functions"].items():
+            old_function = old_functions.get(function_name)
+            if old_function is None:
+                print(f"{'new':>10}  {name}.{function_name}")
+                continue
+            for key in ("bits", "cells", "minGas"):
+                check(f"{name}.{function_name}", key, old_function.get(key), function[key])
+        for function_name in old_functions.keys() - contract["functions"].keys():
+            print(f"{'removed':>10}  {name}.{function_name}")
+
+    if regressions:
+        print(f"\n{len(regressions)} value(s) exceed the baseline by more than the threshold.")
+    if unrecorded:
+        print(f"\n{len(unrecorded)} contract(s) have no baseline values. Record them with --update-baseline.")
+    return not regressions and not unrecorded
+
+
+def parse_command_line() -> Namespace:
+    parser = ArgumentParser(description="Compares the TVM code of the benchmark contracts with a baseline.")
+    parser.add_argument("contracts", nargs="*", help="Names of the contracts to compile. All by default.")
+    parser.add_argument("--sold", type=Path, default=Path(os.environ.get("SOLD", DEFAULT_SOLD)))
+    parser.add_argument("--report", type=Path, help="Write the report to this file.")
+    parser.add_argument("--baseline", type=Path, default=DEFAULT_BASELINE)
+    parser.add_argument("--update-baseline", action="store_true", help="Replace the baseline with the report.")
+    parser.add_argument("--size-threshold", type=float, default=0.5, help="Allowed growth of sizes in percent.")
+    parser.add_argument("--gas-threshold", type=float, default=1.0, help="Allowed growth of gas in percent.")
+    parser.add_argument("--time-threshold", type=float, default=50.0, help="Allowed growth of compile time in percent.")
+    parser.add_argument("--memory-threshold", type=float, default=25.0, help="Allowed growth of peak memory in percent.")
+    return parser.parse_args()
+
+
+def main() -> int:
+    options = parse_command_line()
+    try:
+        report = run_benchmarks(options.sold, options.contracts)
+    except CompilationFailed as exception:
+        print(f"Compilation failed:\n{exception}", file=sys.stderr)
+        return 2
+
+    report_json = json.dumps(report, indent=2, sort_keys=True) + "\n"
+    if options.report:
+        options.report.write_text(report_json, encoding="utf-8")
+    else:
+        print(report_json)
+
+    if options.update_baseline:
+        if options.baseline.exists() and options.contracts:
+            baseline = json.loads(options.baseline.read_text(encoding="utf-8"))
+            baseline["contracts"].update(report["contracts"])
+            report_json = json.dumps(baseline, indent=2, sort_keys=True) + "\n"
+        options.baseline.write_text(report_json, encoding="utf-8")
+        print(f"Updated {options.baseline}", file=sys.stderr)
+        return 0
+
+    if not options.baseline.exists():
+        print(f"No baseline at {options.baseline}. Record it with --update-baseline.", file=sys.stderr)
+        return 2
+    baseline = json.loads(options.baseline.read_text(encoding="utf-8"))
+    return 0 if compare(report, baseline, options) else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
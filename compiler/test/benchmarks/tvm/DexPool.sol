@@ -0,0 +1,166 @@
+pragma tvm-solidity >=0.78.0;
+
+interface ITokenWallet {
+    function transfer(
+        uint128 amount,
+        address recipient,
+        varuint16 deployWalletValue,
+        address remainingGasTo,
+        bool notify,
+        TvmCell payload
+    ) external;
+}
+
+// Constant product pool of two tokens. Tokens are sent to the wallets of the pool with a payload
+// that selects the operation.
+contract DexPool {
+
+    uint8 constant OP_SWAP = 1;
+    uint8 constant OP_DEPOSIT = 2;
+
+    uint16 constant FEE_NUMERATOR = 3;
+    uint16 constant FEE_DENOMINATOR = 1000;
+
+    address static m_root0;
+    address static m_root1;
+
+    address m_wallet0;
+    address m_wallet1;
+    uint128 m_reserve0;
+    uint128 m_reserve1;
+    uint128 m_lpSupply;
+    mapping(address => uint128) m_lpBalances;
+    // Tokens deposited by an account, waiting for the other token of the pair.
+    mapping(address => uint128) m_pending0;
+    mapping(address => uint128) m_pending1;
+
+    constructor(address wallet0, address wallet1) {
+        require(msg.pubkey() == tvm.pubkey(), 100);
+        tvm.accept();
+        m_wallet0 = wallet0;
+        m_wallet1 = wallet1;
+    }
+
+    function onAcceptTokensTransfer(
+        address tokenRoot,
+        uint128 amount,
+        address sender,
+        address /*senderWallet*/,
+        address remainingGasTo,
+        TvmCell payload
+    ) external {
+        bool isToken0 = msg.sender == m_wallet0 && tokenRoot == m_root0;
+        bool isToken1 = msg.sender == m_wallet1 && tokenRoot == m_root1;
+        require(isToken0 || isToken1, 200);
+
+        TvmSlice s = payload.toSlice();
+        if (s.bits() < 8 + 128) {
+            refund(isToken0, amount, sender, remainingGasTo);
+            return;
+        }
+        (uint8 op, uint128 limit) = s.load(uint8, uint128);
+        if (op == OP_SWAP) {
+            swap(isToken0, amount, limit, sender, remainingGasTo);
+        } else if (op == OP_DEPOSIT) {
+            deposit(isToken0, amount, sender, remainingGasTo);
+        } else {
+            refund(isToken0, amount, sender, remainingGasTo);
+        }
+    }
+
+    function expectedExchange(uint128 amount, bool fromToken0) public view returns (uint128 expectedAmount, uint128 fee) {
+        (uint128 reserveIn, uint128 reserveOut) = fromToken0 ? (m_reserve0, m_reserve1) : (m_reserve1, m_reserve0);
+        if (reserveIn == 0 || reserveOut == 0) {
+            return (0, 0);
+        }
+        fee = math.muldivc(amount, FEE_NUMERATOR, FEE_DENOMINATOR);
+        uint128 amountIn = amount - fee;
+        expectedAmount = math.muldiv(amountIn, reserveOut, reserveIn + amountIn);
+    }
+
+    function swap(bool fromToken0, uint128 amount, uint128 minAmountOut, address sender, address remainingGasTo) private {
+        (uint128 amountOut, ) = expectedExchange(amount, fromToken0);
+        if (amountOut == 0 || amountOut < minAmountOut) {
+            refund(fromToken0, amount, sender, remainingGasTo);
+            return;
+        }
+        if (fromToken0) {
+            m_reserve0 += amount;
+            m_reserve1 -= amountOut;
+        } else {
+            m_reserve1 += amount;
+            m_reserve0 -= amountOut;
+        }
+        sendTokens(!fromToken0, amountOut, sender, remainingGasTo);
+    }
+
+    function deposit(bool isToken0, uint128 amount, address sender, address remainingGasTo) private {
+        uint128 amount0 = m_pending0[sender];
+        uint128 amount1 = m_pending1[sender];
+        if (isToken0) {
+            amount0 += amount;
+        } else {
+            amount1 += amount;
+        }
+        if (amount0 == 0 || amount1 == 0) {
+            m_pending0[sender] = amount0;
+            m_pending1[sender] = amount1;
+            remainingGasTo.transfer({value: 0, flag: 64, bounce: false});
+            return;
+        }
+        delete m_pending0[sender];
+        delete m_pending1[sender];
+
+        uint128 minted;
+        if (m_lpSupply == 0) {
+            minted = math.max(amount0, amount1);
+        } else {
+            minted = math.min(
+                math.muldiv(amount0, m_lpSupply, m_reserve0),
+                math.muldiv(amount1, m_lpSupply, m_reserve1)
+            );
+        }
+        require(minted > 0, 201);
+        m_reserve0 += amount0;
+        m_reserve1 += amount1;
+        m_lpSupply += minted;
+        m_lpBalances[sender] += minted;
+        remainingGasTo.transfer({value: 0, flag: 64, bounce: false});
+    }
+
+    function withdraw(uint128 lpAmount, address remainingGasTo) external {
+        optional(uint128) balance = m_lpBalances.fetch(msg.sender);
+        require(balance.hasValue() && balance.get() >= lpAmount && lpAmount > 0, 202);
+        tvm.rawReserve(address(this).balance - msg.value, 0);
+
+        uint128 amount0 = math.muldiv(lpAmount, m_reserve0, m_lpSupply);
+        uint128 amount1 = math.muldiv(lpAmount, m_reserve1, m_lpSupply);
+        m_reserve0 -= amount0;
+        m_reserve1 -= amount1;
+        m_lpSupply -= lpAmount;
+        if (balance.get() == lpAmount) {
+            delete m_lpBalances[msg.sender];
+        } else {
+            m_lpBalances[msg.sender] = balance.get() - lpAmount;
+        }
+
+        TvmCell empty;
+        ITokenWallet(m_wallet0).transfer{value: 0.2 ever, flag: 0, bounce: false}(amount0, msg.sender, 0.05 ever, remainingGasTo, false, empty);
+        ITokenWallet(m_wallet1).transfer{value: 0, flag: 128, bounce: false}(amount1, msg.sender, 0.05 ever, remainingGasTo, false, empty);
+    }
+
+    function refund(bool isToken0, uint128 amount, address sender, address remainingGasTo) private view {
+        sendTokens(isToken0, amount, sender, remainingGasTo);
+    }
+
+    function sendTokens(bool isToken0, uint128 amount, address recipient, address remainingGasTo) private view {
+        TvmCell empty;
+        ITokenWallet(isToken0 ? m_wallet0 : m_wallet1).transfer{value: 0, flag: 64, bounce: false}(
+            amount, recipient, 0.05 ever, remainingGasTo, false, empty
+        );
+    }
+
+    function getDetails() external view returns (uint128 reserve0, uint128 reserve1, uint128 lpSupply) {
+        return (m_reserve0, m_reserve1, m_lpSupply);
+    }
+}
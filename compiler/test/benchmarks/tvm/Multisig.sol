@@ -0,0 +1,137 @@
+pragma tvm-solidity >=0.78.0;
+pragma AbiHeader expire;
+pragma AbiHeader pubkey;
+
+// Wallet with several custodians. A transaction is sent once enough custodians confirmed it.
+contract Multisig {
+
+    struct Transaction {
+        uint64 id;
+        uint32 confirmationsMask;
+        uint8 signsRequired;
+        uint8 signsReceived;
+        uint256 creator;
+        uint8 index;
+        address dest;
+        varuint16 value;
+        bool bounce;
+        uint16 flags;
+        TvmCell payload;
+    }
+
+    uint8 constant MAX_CUSTODIANS = 32;
+    uint8 constant MAX_QUEUED_TRANSACTIONS = 5;
+    uint32 constant LIFETIME = 3600;
+
+    mapping(uint256 => uint8) m_custodians;
+    uint8 m_custodianCount;
+    uint8 m_requiredSigns;
+    mapping(uint64 => Transaction) m_transactions;
+    // Number of queued transactions by custodian index.
+    mapping(uint8 => uint8) m_queued;
+
+    constructor(uint256[] owners, uint8 requiredSigns) {
+        require(msg.pubkey() == tvm.pubkey(), 100);
+        require(owners.length > 0 && owners.length <= MAX_CUSTODIANS, 101);
+        require(requiredSigns > 0 && requiredSigns <= owners.length, 102);
+        tvm.accept();
+
+        uint8 index = 0;
+        for (uint256 owner : owners) {
+            if (!m_custodians.exists(owner)) {
+                m_custodians[owner] = index;
+                ++index;
+            }
+        }
+        m_custodianCount = index;
+        m_requiredSigns = requiredSigns <= index ? requiredSigns : index;
+    }
+
+    function findCustodian(uint256 key) private view returns (uint8) {
+        optional(uint8) index = m_custodians.fetch(key);
+        require(index.hasValue(), 103);
+        return index.get();
+    }
+
+    function submitTransaction(
+        address dest,
+        varuint16 value,
+        bool bounce,
+        bool allBalance,
+        TvmCell payload
+    ) external returns (uint64 transId) {
+        uint8 index = findCustodian(msg.pubkey());
+        require(m_queued[index] < MAX_QUEUED_TRANSACTIONS, 104);
+        tvm.accept();
+        removeExpiredTransactions();
+
+        uint16 flags = allBalance ? 128 : 3;
+        if (m_requiredSigns == 1) {
+            dest.transfer({value: value, bounce: bounce, flag: flags, body: payload});
+            return 0;
+        }
+
+        transId = (uint64(block.timestamp) << 32) | (tx.logicaltime & 0xFFFFFFFF);
+        m_transactions[transId] = Transaction(
+            transId, uint32(1) << index, m_requiredSigns, 1, msg.pubkey(), index,
+            dest, value, bounce, flags, payload
+        );
+        m_queued[index] += 1;
+    }
+
+    function confirmTransaction(uint64 transactionId) external {
+        uint8 index = findCustodian(msg.pubkey());
+        optional(Transaction) found = m_transactions.fetch(transactionId);
+        require(found.hasValue(), 105);
+        Transaction txn = found.get();
+        require((txn.confirmationsMask >> index) & 1 == 0, 106);
+        require(!isExpired(transactionId), 107);
+        tvm.accept();
+
+        txn.confirmationsMask |= uint32(1) << index;
+        txn.signsReceived += 1;
+        if (txn.signsReceived >= txn.signsRequired) {
+            txn.dest.transfer({value: txn.value, bounce: txn.bounce, flag: txn.flags, body: txn.payload});
+            m_queued[txn.index] -= 1;
+            delete m_transactions[transactionId];
+        } else {
+            m_transactions[transactionId] = txn;
+        }
+        removeExpiredTransactions();
+    }
+
+    function isExpired(uint64 transactionId) private pure returns (bool) {
+        return uint32(transactionId >> 32) + LIFETIME < block.timestamp;
+    }
+
+    function removeExpiredTransactions() private {
+        optional(uint64, Transaction) entry = m_transactions.min();
+        uint8 removed = 0;
+        while (entry.hasValue() && removed < 10) {
+            (uint64 id, Transaction txn) = entry.get();
+            if (!isExpired(id)) {
+                break;
+            }
+            m_queued[txn.index] -= 1;
+            delete m_transactions[id];
+            ++removed;
+            entry = m_transactions.next(id);
+        }
+    }
+
+    function getTransactions() external view returns (Transaction[] transactions) {
+        for ((, Transaction txn) : m_transactions) {
+            transactions.push(txn);
+        }
+    }
+
+    function getCustodians() external view returns (uint256[] keys, uint8 requiredSigns) {
+        for ((uint256 key, ) : m_custodians) {
+            keys.push(key);
+        }
+        requiredSigns = m_requiredSigns;
+    }
+
+    receive() external {
+    }
+}
@@ -0,0 +1,67 @@
+pragma tvm-solidity >=0.78.0;
+
+interface INftChangeOwner {
+    function onNftChangeOwner(uint256 id, address oldOwner, address newOwner, TvmCell payload) external;
+}
+
+// Item of an NFT collection. Its address is derived from the collection and its id.
+contract Nft {
+
+    address static m_collection;
+    uint256 static m_id;
+
+    address m_owner;
+    address m_manager;
+    string m_json;
+
+    modifier onlyManager {
+        require(msg.sender == m_manager, 3000);
+        _;
+    }
+
+    constructor(address owner, string json) {
+        require(msg.sender == m_collection, 3001);
+        m_owner = owner;
+        m_manager = owner;
+        m_json = json;
+    }
+
+    function getInfo() external view responsible returns (uint256 id, address collection, address owner, address manager) {
+        return {value: 0, bounce: false, flag: 64} (m_id, m_collection, m_owner, m_manager);
+    }
+
+    function getJson() external view responsible returns (string json) {
+        return {value: 0, bounce: false, flag: 64} m_json;
+    }
+
+    function name() external view returns (string) {
+        return format("Item #{}", m_id);
+    }
+
+    function changeManager(address newManager) external onlyManager {
+        require(newManager.value != 0, 3002);
+        m_manager = newManager;
+        msg.sender.transfer({value: 0, flag: 64, bounce: false});
+    }
+
+    function transfer(address to, address sendGasTo, bool notify, TvmCell payload) external onlyManager {
+        require(to.value != 0 && to != m_owner, 3003);
+        address oldOwner = m_owner;
+        m_owner = to;
+        m_manager = to;
+        if (notify) {
+            INftChangeOwner(to).onNftChangeOwner{value: 0, flag: 64, bounce: false}(m_id, oldOwner, to, payload);
+        } else {
+            sendGasTo.transfer({value: 0, flag: 64, bounce: false});
+        }
+    }
+
+    function burn(address sendGasTo) external onlyManager {
+        NftCollectionBurn(m_collection).acceptNftBurn{value: 0.01 ever, flag: 1, bounce: false}(m_id, m_owner);
+        selfdestruct(sendGasTo);
+    }
+}
+
+interface NftCollectionBurn {
+    function acceptNftBurn(uint256 id, address owner) external;
+}
@@ -0,0 +1,74 @@
+pragma tvm-solidity >=0.78.0;
+
+import "Nft.sol";
+
+// Collection that mints NFTs with consecutive ids.
+contract NftCollection {
+
+    TvmCell static m_nftCode;
+
+    address m_owner;
+    uint256 m_totalMinted;
+    uint256 m_totalSupply;
+    varuint16 m_mintPrice;
+    string m_baseUri;
+
+    modifier onlyOwner {
+        require(msg.sender == m_owner, 4000);
+        _;
+    }
+
+    constructor(address owner, varuint16 mintPrice, string baseUri) {
+        require(tvm.pubkey() != 0 && msg.pubkey() == tvm.pubkey(), 4001);
+        tvm.accept();
+        m_owner = owner;
+        m_mintPrice = mintPrice;
+        m_baseUri = baseUri;
+    }
+
+    function mint(string json) external returns (address nft) {
+        require(msg.value >= m_mintPrice + 0.2 ever, 4002);
+        tvm.rawReserve(m_mintPrice, 4);
+
+        uint256 id = m_totalMinted;
+        ++m_totalMinted;
+        ++m_totalSupply;
+        nft = new Nft{stateInit: buildNftStateInit(id), value: 0, flag: 128}(msg.sender, json);
+    }
+
+    function acceptNftBurn(uint256 id, address /*owner*/) external {
+        require(msg.sender == nftAddress(id), 4003);
+        --m_totalSupply;
+    }
+
+    function nftAddress(uint256 id) public view returns (address) {
+        return address.makeAddrStd(address(this).wid, tvm.hash(buildNftStateInit(id)));
+    }
+
+    function tokenUri(uint256 id) external view returns (string) {
+        require(id < m_totalMinted, 4004);
+        return format("{}/{}.json", m_baseUri, id);
+    }
+
+    function totalSupply() external view responsible returns (uint256 count) {
+        return {value: 0, bounce: false, flag: 64} m_totalSupply;
+    }
+
+    function setMintPrice(varuint16 mintPrice) external onlyOwner {
+        m_mintPrice = mintPrice;
+    }
+
+    function withdraw(address to, varuint16 value) external onlyOwner {
+        require(value <= address(this).balance - 1 ever, 4005);
+        to.transfer({value: value, flag: 1, bounce: false});
+    }
+
+    function buildNftStateInit(uint256 id) private view returns (TvmCell) {
+        return abi.encodeStateInit({
+            contr: Nft,
+            varInit: {m_collection: address(this), m_id: id},
+            pubkey: 0,
+            code: m_nftCode
+        });
+    }
+}
@@ -0,0 +1,31 @@
+pragma tvm-solidity >=0.78.0;
+
+// Gas benchmark for <string>.find() and <string>.findLast().
+// Call the getters with `size` = 1024 and 10240 on a local node (or with a TVM debugger)
+// and compare the gas consumed with the output of the previous compiler version.
+contract StringSearch {
+
+    function makeString(uint32 size) private pure returns (string) {
+        StringBuilder sb;
+        sb.append(bytes1("a"), size - 1);
+        sb.append(bytes1("z"));
+        return sb.toString();
+    }
+
+    function findChar(uint32 size) external pure returns (optional(uint32) first, optional(uint32) last) {
+        string s = makeString(size);
+        first = s.find(bytes1("z"));
+        last = s.findLast(bytes1("a"));
+    }
+
+    function findSubstring(uint32 size) external pure returns (optional(uint32) pos) {
+        string s = makeString(size);
+        pos = s.find("zzz");
+    }
+
+    function missingChar(uint32 size) external pure returns (optional(uint32) first, optional(uint32) last) {
+        string s = makeString(size);
+        first = s.find(bytes1("b"));
+        last = s.findLast(bytes1("b"));
+    }
+}
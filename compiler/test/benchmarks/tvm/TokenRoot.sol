@@ -0,0 +1,114 @@
+pragma tvm-solidity >=0.78.0;
+
+import "TokenWallet.sol";
+
+// Root of a fungible token. It deploys the wallets and mints and burns the tokens.
+contract TokenRoot {
+
+    string static m_name;
+    string static m_symbol;
+    uint8 static m_decimals;
+    TvmCell static m_walletCode;
+
+    address m_owner;
+    uint128 m_totalSupply;
+    bool m_mintDisabled;
+
+    modifier onlyOwner {
+        require(msg.sender == m_owner, 2000);
+        _;
+    }
+
+    constructor(address owner, uint128 initialSupply, address initialSupplyTo, varuint16 deployWalletValue) {
+        require(tvm.pubkey() != 0 && msg.pubkey() == tvm.pubkey(), 2001);
+        tvm.accept();
+        m_owner = owner;
+        if (initialSupply > 0) {
+            TvmCell empty;
+            mint(initialSupply, initialSupplyTo, deployWalletValue, owner, false, empty);
+        }
+    }
+
+    function name() external view responsible returns (string) {
+        return {value: 0, bounce: false, flag: 64} m_name;
+    }
+
+    function totalSupply() external view responsible returns (uint128) {
+        return {value: 0, bounce: false, flag: 64} m_totalSupply;
+    }
+
+    function walletOf(address walletOwner) external view responsible returns (address) {
+        return {value: 0, bounce: false, flag: 64} walletAddress(walletOwner);
+    }
+
+    function deployWallet(address walletOwner, varuint16 deployWalletValue) external responsible returns (address) {
+        require(msg.value >= deployWalletValue + 0.1 ever, 2002);
+        address wallet = new TokenWallet{
+            stateInit: buildWalletStateInit(walletOwner),
+            value: deployWalletValue,
+            flag: 1
+        }();
+        return {value: 0, bounce: false, flag: 64} wallet;
+    }
+
+    function mint(
+        uint128 amount,
+        address recipient,
+        varuint16 deployWalletValue,
+        address remainingGasTo,
+        bool notify,
+        TvmCell payload
+    ) public onlyOwner {
+        require(!m_mintDisabled, 2003);
+        require(amount > 0, 2004);
+        require(recipient.value != 0, 2005);
+
+        address wallet;
+        if (deployWalletValue > 0) {
+            wallet = new TokenWallet{stateInit: buildWalletStateInit(recipient), value: deployWalletValue, flag: 1}();
+        } else {
+            wallet = walletAddress(recipient);
+        }
+
+        m_totalSupply += amount;
+        TokenWallet(wallet).acceptMint{value: 0, flag: 64, bounce: true}(amount, remainingGasTo, notify, payload);
+    }
+
+    function acceptBurn(uint128 amount, address walletOwner, address remainingGasTo, TvmCell payload) external {
+        require(msg.sender == walletAddress(walletOwner), 2006);
+        m_totalSupply -= amount;
+        if (remainingGasTo.value != 0) {
+            remainingGasTo.transfer({value: 0, flag: 64, bounce: false, body: payload});
+        }
+    }
+
+    function disableMint() external onlyOwner {
+        m_mintDisabled = true;
+    }
+
+    function transferOwnership(address newOwner) external onlyOwner {
+        require(newOwner.value != 0, 2005);
+        m_owner = newOwner;
+    }
+
+    function buildWalletStateInit(address walletOwner) private view returns (TvmCell) {
+        return abi.encodeStateInit({
+            contr: TokenWallet,
+            varInit: {m_root: address(this), m_owner: walletOwner},
+            pubkey: 0,
+            code: m_walletCode
+        });
+    }
+
+    function walletAddress(address walletOwner) private view returns (address) {
+        return address.makeAddrStd(address(this).wid, tvm.hash(buildWalletStateInit(walletOwner)));
+    }
+
+    onBounce(TvmSlice body) external {
+        uint32 functionId = body.load(uint32);
+        if (functionId == tvm.functionId(TokenWallet.acceptMint)) {
+            uint128 amount = body.load(uint128);
+            m_totalSupply -= amount;
+        }
+    }
+}
@@ -0,0 +1,124 @@
+pragma tvm-solidity >=0.78.0;
+
+interface IAcceptTokensTransferCallback {
+    function onAcceptTokensTransfer(
+        address tokenRoot,
+        uint128 amount,
+        address sender,
+        address senderWallet,
+        address remainingGasTo,
+        TvmCell payload
+    ) external;
+}
+
+interface ITokenRoot {
+    function acceptBurn(uint128 amount, address walletOwner, address remainingGasTo, TvmCell payload) external;
+}
+
+// Wallet of a fungible token. Its address is derived from the root and the owner, so that wallets
+// can check each other without asking the root.
+contract TokenWallet {
+
+    address static m_root;
+    address static m_owner;
+
+    uint128 m_balance;
+
+    modifier onlyOwner {
+        require(msg.sender == m_owner, 1000);
+        _;
+    }
+
+    constructor() {
+        require(msg.sender == m_root, 1001);
+    }
+
+    function balance() external view responsible returns (uint128) {
+        return {value: 0, bounce: false, flag: 64} m_balance;
+    }
+
+    function owner() external view responsible returns (address) {
+        return {value: 0, bounce: false, flag: 64} m_owner;
+    }
+
+    function transfer(
+        uint128 amount,
+        address recipient,
+        varuint16 deployWalletValue,
+        address remainingGasTo,
+        bool notify,
+        TvmCell payload
+    ) external onlyOwner {
+        require(amount > 0, 1002);
+        require(amount <= m_balance, 1003);
+        require(recipient.value != 0 && recipient != m_owner, 1004);
+
+        TvmCell stateInit = buildWalletStateInit(recipient);
+        address recipientWallet;
+        if (deployWalletValue > 0) {
+            recipientWallet = new TokenWallet{stateInit: stateInit, value: deployWalletValue, wid: address(this).wid, flag: 1}();
+        } else {
+            recipientWallet = address.makeAddrStd(address(this).wid, tvm.hash(stateInit));
+        }
+
+        m_balance -= amount;
+        TokenWallet(recipientWallet).acceptTransfer{value: 0, flag: 64, bounce: true}(
+            amount, m_owner, remainingGasTo, notify, payload
+        );
+    }
+
+    function acceptTransfer(
+        uint128 amount,
+        address sender,
+        address remainingGasTo,
+        bool notify,
+        TvmCell payload
+    ) external {
+        require(msg.sender == address.makeAddrStd(address(this).wid, tvm.hash(buildWalletStateInit(sender))), 1005);
+        m_balance += amount;
+
+        if (notify) {
+            IAcceptTokensTransferCallback(m_owner).onAcceptTokensTransfer{value: 0, flag: 64, bounce: false}(
+                m_root, amount, sender, msg.sender, remainingGasTo, payload
+            );
+        } else if (remainingGasTo.value != 0 && remainingGasTo != address(this)) {
+            remainingGasTo.transfer({value: 0, flag: 64, bounce: false});
+        }
+    }
+
+    function acceptMint(uint128 amount, address remainingGasTo, bool notify, TvmCell payload) external {
+        require(msg.sender == m_root, 1001);
+        m_balance += amount;
+
+        if (notify) {
+            IAcceptTokensTransferCallback(m_owner).onAcceptTokensTransfer{value: 0, flag: 64, bounce: false}(
+                m_root, amount, m_root, msg.sender, remainingGasTo, payload
+            );
+        } else if (remainingGasTo.value != 0 && remainingGasTo != address(this)) {
+            remainingGasTo.transfer({value: 0, flag: 64, bounce: false});
+        }
+    }
+
+    function burn(uint128 amount, address remainingGasTo, TvmCell payload) external onlyOwner {
+        require(amount > 0 && amount <= m_balance, 1003);
+        m_balance -= amount;
+        ITokenRoot(m_root).acceptBurn{value: 0, flag: 64, bounce: true}(amount, m_owner, remainingGasTo, payload);
+    }
+
+    function buildWalletStateInit(address walletOwner) private view returns (TvmCell) {
+        return abi.encodeStateInit({
+            contr: TokenWallet,
+            varInit: {m_root: m_root, m_owner: walletOwner},
+            pubkey: 0,
+            code: tvm.code()
+        });
+    }
+
+    onBounce(TvmSlice body) external {
+        uint32 functionId = body.load(uint32);
+        if (functionId == tvm.functionId(TokenWallet.acceptTransfer) || functionId == tvm.functionId(ITokenRoot.acceptBurn)) {
+            uint128 amount = body.load(uint128);
+            m_balance += amount;
+        }
+    }
+}
@@ -0,0 +1,79 @@
+pragma tvm-solidity >=0.78.0;
+pragma AbiHeader expire;
+pragma AbiHeader pubkey;
+
+// Wallet controlled by an external key, which sends single and batched transfers.
+contract Wallet {
+
+    struct Transfer {
+        address dest;
+        varuint16 value;
+        bool bounce;
+        uint8 flags;
+        TvmCell payload;
+    }
+
+    uint256 m_owner;
+    uint64 m_transferCount;
+    mapping(address => varuint16) m_limits;
+
+    modifier onlyOwner {
+        require(msg.pubkey() == m_owner, 100);
+        _;
+    }
+
+    constructor() {
+        require(tvm.pubkey() != 0, 101);
+        require(msg.pubkey() == tvm.pubkey(), 100);
+        tvm.accept();
+        m_owner = tvm.pubkey();
+    }
+
+    function sendTransaction(address dest, varuint16 value, bool bounce, uint8 flags, TvmCell payload) external onlyOwner {
+        checkLimit(dest, value);
+        tvm.accept();
+        dest.transfer({value: value, bounce: bounce, flag: flags, body: payload});
+        ++m_transferCount;
+    }
+
+    function sendTransactions(Transfer[] transfers) external onlyOwner {
+        require(transfers.length <= 4, 102);
+        for (Transfer t : transfers) {
+            checkLimit(t.dest, t.value);
+        }
+        tvm.accept();
+        for (Transfer t : transfers) {
+            t.dest.transfer({value: t.value, bounce: t.bounce, flag: t.flags, body: t.payload});
+        }
+        m_transferCount += uint64(transfers.length);
+    }
+
+    function setLimit(address dest, varuint16 limit) external onlyOwner {
+        tvm.accept();
+        if (limit == 0) {
+            delete m_limits[dest];
+        } else {
+            m_limits[dest] = limit;
+        }
+    }
+
+    function changeOwner(uint256 newOwner) external onlyOwner {
+        require(newOwner != 0, 101);
+        tvm.accept();
+        m_owner = newOwner;
+    }
+
+    function checkLimit(address dest, varuint16 value) private view {
+        optional(varuint16) limit = m_limits.fetch(dest);
+        if (limit.hasValue()) {
+            require(value <= limit.get(), 103);
+        }
+    }
+
+    function getDetails() external view returns (uint256 owner, uint64 transferCount, varuint16 balance) {
+        return (m_owner, m_transferCount, address(this).balance);
+    }
+
+    receive() external {
+    }
+}
@@ -249,9 +249,21 @@ bool ASTJSONTest::runTest(
 
 	for (size_t i = 0; i < m_sources.size(); i++)
 	{
+		SourceUnit const& ast = _compiler.ast(m_sources[i].first);
 		std::ostringstream result;
-		ASTJsonExporter(_compiler.state(), _sourceIndices).print(result, _compiler.ast(m_sources[i].first), JsonFormat{ JsonFormat::Pretty });
+		ASTJsonExporter(_compiler.state(), _sourceIndices).print(result, ast, JsonFormat{ JsonFormat::Pretty });
 		_variant.result += result.str();
+
+		std::ostringstream streamed;
+		ASTJsonExporter(_compiler.state(), _sourceIndices).stream(streamed, ast);
+		if (streamed.str() != jsonCompactPrint(ASTJsonExporter(_compiler.state(), _sourceIndices).toJson(ast)))
+		{
+			AnsiColorized(_stream, _formatted, {BOLD, RED}) <<
+				_linePrefix <<
+				"Streamed AST differs from the compact AST of source \"" << m_sources[i].first << "\"." <<
+				std::endl;
+			return false;
+		}
 		if (i != m_sources.size() - 1)
 			_variant.result += ",";
 		_variant.result += "\n";
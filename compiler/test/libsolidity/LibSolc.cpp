@@ -20,6 +20,7 @@
  * Unit tests for libsolc/libsolc.cpp.
  */
 
+#include <map>
 #include <string>
 #include <boost/test/unit_test.hpp>
 #include <libsolutil/JSON.h>
@@ -178,6 +179,51 @@ BOOST_AUTO_TEST_CASE(with_callback)
 	BOOST_CHECK(containsError(result, "ParserError", "Source \"notfound.sol\" not found: Callback not supported."));
 }
 
+BOOST_AUTO_TEST_CASE(artifact_callback)
+{
+	Json::Value input;
+	input["language"] = "Solidity";
+	input["sources"]["fileA"]["content"] =
+		"// SPDX-License-Identifier: GPL-3.0\n"
+		"pragma tvm-solidity >= 0.72.0;\n"
+		"contract A {\n"
+		"	uint m_value;\n"
+		"	function set(uint value) public { tvm.accept(); m_value = value; }\n"
+		"}\n";
+	for (std::string artifact: {"abi", "assembly", "showFunctionIds"})
+		input["settings"]["outputSelection"]["*"]["*"].append(artifact);
+	input["settings"]["outputSelection"]["*"][""].append("ast");
+	std::string const inputString = util::jsonCompactPrint(input);
+
+	Json::Value expected = compile(inputString);
+	BOOST_REQUIRE(expected["contracts"]["fileA"]["A"]["assembly"].isString());
+
+	std::map<std::string, std::string> artifacts;
+	CStyleArtifactCallback callback{
+		[](void* _context, char const* _sourceName, char const* _contractName, char const* _artifact, char const* _data, size_t _size)
+		{
+			auto& artifacts = *static_cast<std::map<std::string, std::string>*>(_context);
+			artifacts[std::string(_sourceName) + ":" + _contractName + ":" + _artifact].append(_data, _size);
+		}
+	};
+	char* outputPtr = solidity_compile_with_artifact_callback(inputString.c_str(), nullptr, nullptr, callback, &artifacts);
+	std::string output(outputPtr);
+	solidity_free(outputPtr);
+	solidity_reset();
+	Json::Value result;
+	BOOST_REQUIRE(util::jsonParseStrict(output, result));
+
+	Json::Value const& contract = result["contracts"]["fileA"]["A"];
+	for (std::string artifact: {"abi", "assembly", "functionIds"})
+		BOOST_CHECK(!contract.isMember(artifact));
+	BOOST_CHECK(!result["sources"]["fileA"].isMember("ast"));
+
+	BOOST_CHECK_EQUAL(artifacts["fileA:A:assembly"], expected["contracts"]["fileA"]["A"]["assembly"].asString());
+	for (std::string artifact: {"abi", "functionIds"})
+		BOOST_CHECK_EQUAL(artifacts["fileA:A:" + artifact], util::jsonCompactPrint(expected["contracts"]["fileA"]["A"][artifact]));
+	BOOST_CHECK_EQUAL(artifacts["fileA::ast"], util::jsonCompactPrint(expected["sources"]["fileA"]["ast"]));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // end namespaces
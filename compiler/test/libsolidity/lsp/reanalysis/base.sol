@@ -0,0 +1,11 @@
+// SPDX-License-Identifier: UNLICENSED
+pragma tvm-solidity >=0.50.0;
+
+library Base
+{
+    function twice(uint a) internal pure returns (uint)
+    {
+        return 2 * a;
+//      ^^^^^^ @return
+    }
+}
@@ -0,0 +1,10 @@
+// SPDX-License-Identifier: UNLICENSED
+pragma tvm-solidity >=0.50.0;
+
+contract Other
+{
+    function one() public pure returns (uint)
+    {
+        return 1;
+    }
+}
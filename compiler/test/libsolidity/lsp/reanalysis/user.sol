@@ -0,0 +1,12 @@
+// SPDX-License-Identifier: UNLICENSED
+pragma tvm-solidity >=0.50.0;
+
+import "./base.sol";
+
+contract User
+{
+    function quadruple(uint a) public pure returns (uint)
+    {
+        return Base.twice(Base.twice(a));
+    }
+}
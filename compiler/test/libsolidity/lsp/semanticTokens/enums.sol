@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: UNLICENSED
-pragma solidity >=0.8.0;
+pragma tvm-solidity >=0.50.0;
 
 enum Weather {
     Sunny,
@@ -21,8 +21,9 @@ function getColorEnum() pure returns (Color result)
 // -> textDocument/semanticTokens/full {
 // }
 // <- {
+//     "resultId": "1",
 //     "data": [
-//         1, 0, 24, 8, 0,
+//         1, 0, 29, 8, 0,
 //         2, 5, 7, 2, 0,
 //         1, 4, 5, 3, 0,
 //         1, 4, 6, 3, 0,
@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: UNLICENSED
-pragma solidity >=0.8.0;
+pragma tvm-solidity >=0.50.0;
 
 library Lib
 {
@@ -27,8 +27,9 @@ contract Contract
 // -> textDocument/semanticTokens/full {
 // }
 // <- {
+//     "resultId": "1",
 //     "data": [
-//         1, 0, 24, 8, 0,
+//         1, 0, 29, 8, 0,
 //         2, 8, 3, 0, 0,
 //         2, 13, 3, 5, 0,
 //         0, 4, 4, 11, 0,
@@ -10,6 +10,7 @@ import os
 import re
 import subprocess
 import sys
+import time
 import traceback
 from collections import namedtuple
 from copy import deepcopy
@@ -911,11 +912,13 @@ class SolidityLSPTestSuite: # {{{
         expose_project_root=True,
         file_load_strategy: FileLoadStrategy=FileLoadStrategy.DirectlyOpenedAndOnImport,
         custom_include_paths: list[str] = None,
-        project_root_subdir=None
+        project_root_subdir=None,
+        settings: dict = None
     ):
         """
         Prepares the solc LSP server by calling `initialize`,
         and `initialized` methods.
+        `settings` are added to the initialization options, e.g. {'compile-delay': 0}.
         """
         project_root_uri_with_maybe_subdir = self.project_root_uri
         if project_root_subdir is not None:
@@ -949,6 +952,9 @@ class SolidityLSPTestSuite: # {{{
                 params['initializationOptions'] = {}
             params['initializationOptions']['include-paths'] = custom_include_paths
 
+        if settings is not None:
+            params.setdefault('initializationOptions', {}).update(settings)
+
         if not expose_project_root:
             params['rootUri'] = None
 
@@ -1012,6 +1018,19 @@ class SolidityLSPTestSuite: # {{{
 
         return sorted(reports, key=lambda x: x['uri'])
 
+    def wait_for_response(self, solc: JsonRpcProcess) -> Tuple[dict, List[dict]]:
+        """
+        Returns the next response and the messages of the server received before it.
+        A request that needs an up to date analysis publishes the diagnostics before its response.
+        """
+        messages = []
+        while True:
+            message = solc.receive_message()
+            assert message is not None # This can happen if the server aborts early.
+            if 'method' not in message:
+                return message, messages
+            messages.append(message)
+
     def normalizeUri(self, uri):
         return uri.replace(self.project_root_uri + "/", "")[:-len(".sol")]
 
@@ -2051,6 +2070,187 @@ class SolidityLSPTestSuite: # {{{
             "diagnostic: check range"
         )
 
+    def test_didChange_reanalyzes_importing_files_only(self, solc: JsonRpcProcess) -> None:
+        self.setup_lsp(solc)
+        SUB_DIR = 'reanalysis'
+        published_diagnostics = self.open_file_and_wait_for_diagnostics(solc, 'other', SUB_DIR)
+        self.expect_equal(len(published_diagnostics), 1, "Diagnostic reports for other.sol")
+        published_diagnostics = self.open_file_and_wait_for_diagnostics(solc, 'base', SUB_DIR)
+        self.expect_equal(len(published_diagnostics), 1, "Diagnostic reports for base.sol")
+        published_diagnostics = self.open_file_and_wait_for_diagnostics(solc, 'user', SUB_DIR)
+        self.expect_equal(
+            [report['uri'] for report in published_diagnostics],
+            [self.get_test_file_uri('base', SUB_DIR), self.get_test_file_uri('user', SUB_DIR)],
+            "user.sol is analyzed with its import"
+        )
+
+        marker = self.get_test_tags('base', SUB_DIR)["@return"]
+        solc.send_message(
+            'textDocument/didChange',
+            {
+                'textDocument': {
+                    'uri': self.get_test_file_uri('base', SUB_DIR)
+                },
+                'contentChanges': [
+                    {
+                        'range': {'start': marker['start'], 'end': marker['start']},
+                        'text': "uint unused; "
+                    }
+                ]
+            }
+        )
+        published_diagnostics = self.wait_for_diagnostics(solc)
+        self.expect_equal(
+            [report['uri'] for report in published_diagnostics],
+            [self.get_test_file_uri('base', SUB_DIR), self.get_test_file_uri('user', SUB_DIR)],
+            "base.sol and the file importing it are analyzed again, other.sol is not"
+        )
+        diagnostics = published_diagnostics[0]['diagnostics']
+        self.expect_equal(len(diagnostics), 1, "Warning about the new variable")
+        self.expect_diagnostic(diagnostics[0], code=2072, lineNo=7, startEndColumns=(8, 19))
+        self.expect_equal(len(published_diagnostics[1]['diagnostics']), 0, "No diagnostics in user.sol")
+
+    def test_didChange_newer_edit_supersedes_analysis(self, solc: JsonRpcProcess) -> None:
+        # Without a delay each edit starts an analysis on its own. The second edit cancels the
+        # analysis of the first one if it is still running.
+        self.setup_lsp(solc, settings={'compile-delay': 0})
+        SUB_DIR = 'reanalysis'
+        self.open_file_and_wait_for_diagnostics(solc, 'user', SUB_DIR)
+        uri = self.get_test_file_uri('user', SUB_DIR)
+        original = self.get_test_file_contents('user', SUB_DIR)
+
+        # The many functions keep the analysis of the first edit busy, the last one has an error.
+        functions = "".join(
+            f"    function f{i}(uint a) public pure returns (uint) {{ return a + {i}; }}\n"
+            for i in range(3000)
+        )
+        functions += "    function g() public pure returns (uint) { return missing; }\n"
+        broken = original.replace("contract User\n{\n", "contract User\n{\n" + functions)
+        # The second edit differs from the analyzed content, so that it is analyzed too.
+        fixed = original + "\n"
+        for text in (broken, fixed):
+            solc.send_message(
+                'textDocument/didChange',
+                {
+                    'textDocument': {'uri': uri},
+                    'contentChanges': [{'text': text}]
+                }
+            )
+
+        # The result of the first edit is published before the one of the second edit or never.
+        published_diagnostics = self.wait_for_diagnostics(solc)
+        report = next(report for report in published_diagnostics if report['uri'] == uri)
+        if len(report['diagnostics']) != 0:
+            self.expect_true(
+                any(diagnostic['code'] == 7576 for diagnostic in report['diagnostics']),
+                "Undeclared identifier of the first edit"
+            )
+            published_diagnostics = self.wait_for_diagnostics(solc)
+            report = next(report for report in published_diagnostics if report['uri'] == uri)
+        self.expect_equal(len(report['diagnostics']), 0, "The second edit is analyzed last")
+
+        # No outdated result arrives later.
+        solc.send_message('textDocument/semanticTokens/full', {'textDocument': {'uri': uri}})
+        response, messages = self.wait_for_response(solc)
+        self.expect_equal(messages, [], "Nothing is published once the latest edit is analyzed")
+        self.expect_true('data' in response['result'], "Semantic tokens of the latest edit")
+
+    def test_textDocument_semanticTokens_delta_after_change(self, solc: JsonRpcProcess) -> None:
+        self.setup_lsp(solc)
+        SUB_DIR = 'semanticTokens'
+        TEST_NAME = 'functions'
+        uri = self.get_test_file_uri(TEST_NAME, SUB_DIR)
+        self.open_file_and_wait_for_diagnostics(solc, TEST_NAME, SUB_DIR)
+        solc.send_message('textDocument/semanticTokens/full', {'textDocument': {'uri': uri}})
+        response, _ = self.wait_for_response(solc)
+        full = response['result']
+
+        # Rename `doNothing` to `doNothingAtAll`.
+        lines = self.get_test_file_contents(TEST_NAME, SUB_DIR).splitlines()
+        line = next(i for i, text in enumerate(lines) if "function doNothing" in text)
+        position = {'line': line, 'character': lines[line].index("doNothing") + len("doNothing")}
+        solc.send_message(
+            'textDocument/didChange',
+            {
+                'textDocument': {'uri': uri},
+                'contentChanges': [{'range': {'start': position, 'end': position}, 'text': "AtAll"}]
+            }
+        )
+
+        solc.send_message(
+            'textDocument/semanticTokens/full/delta',
+            {'textDocument': {'uri': uri}, 'previousResultId': full['resultId']}
+        )
+        response, _ = self.wait_for_response(solc)
+        delta = response['result']
+        self.expect_true(delta['resultId'] != full['resultId'], "New result id")
+        self.expect_true('data' not in delta, "Only the edits are sent")
+        self.expect_equal(len(delta['edits']), 1, "One edit")
+        edit = delta['edits'][0]
+        self.expect_true(len(edit['data']) < len(full['data']), "The edit covers the changed tokens only")
+        edited = full['data'][:edit['start']] + edit['data'] + full['data'][edit['start'] + edit['deleteCount']:]
+
+        # Applying the edit gives the tokens of a full request.
+        solc.send_message('textDocument/semanticTokens/full', {'textDocument': {'uri': uri}})
+        response, _ = self.wait_for_response(solc)
+        self.expect_equal(edited, response['result']['data'], "Edited tokens")
+
+        # The tokens of an unknown result id cannot be edited.
+        solc.send_message(
+            'textDocument/semanticTokens/full/delta',
+            {'textDocument': {'uri': uri}, 'previousResultId': full['resultId']}
+        )
+        response, _ = self.wait_for_response(solc)
+        self.expect_equal(response['result']['data'], edited, "All tokens for an outdated result id")
+
+    def wait_for_code_lenses(self, solc: JsonRpcProcess, uri: str) -> List[dict]:
+        """
+        Requests the code lenses of the file until the code metrics computed after the analysis
+        arrive or the timeout expires.
+        """
+        deadline = time.monotonic() + 10
+        while True:
+            solc.send_message('textDocument/codeLens', {'textDocument': {'uri': uri}})
+            response, _ = self.wait_for_response(solc)
+            if len(response['result']) != 0 or time.monotonic() > deadline:
+                return response['result']
+            time.sleep(0.1)
+
+    def test_textDocument_codeLens_tvm_metrics(self, solc: JsonRpcProcess) -> None:
+        self.setup_lsp(solc, settings={'compile-delay': 0, 'tvm-metrics': True})
+        SUB_DIR = 'reanalysis'
+        TEST_NAME = 'other'
+        uri = self.get_test_file_uri(TEST_NAME, SUB_DIR)
+        self.open_file_and_wait_for_diagnostics(solc, TEST_NAME, SUB_DIR)
+
+        code_lenses = self.wait_for_code_lenses(solc, uri)
+        self.expect_equal(len(code_lenses), 1, "One code lens for the function one")
+        lines = self.get_test_file_contents(TEST_NAME, SUB_DIR).splitlines()
+        line = next(i for i, text in enumerate(lines) if "function one" in text)
+        self.expect_equal(code_lenses[0]['range']['start']['line'], line, "Code lens at the declaration")
+        self.expect_true(
+            re.fullmatch(r"\d+ bits, \d+ cells, \d+–\d+ gas", code_lenses[0]['command']['title']) is not None,
+            "Size and gas in the title"
+        )
+
+    def test_textDocument_codeLens_tvm_metrics_budget(self, solc: JsonRpcProcess) -> None:
+        # The budget runs out before the code is generated.
+        self.setup_lsp(solc, settings={'compile-delay': 0, 'tvm-metrics': True, 'tvm-metrics-budget': 0})
+        SUB_DIR = 'reanalysis'
+        TEST_NAME = 'other'
+        uri = self.get_test_file_uri(TEST_NAME, SUB_DIR)
+        self.open_file_and_wait_for_diagnostics(solc, TEST_NAME, SUB_DIR)
+
+        while True:
+            message = solc.receive_message()
+            assert message is not None # This can happen if the server aborts early.
+            if message.get('method') == '$/logTrace' and "time budget ran out" in message['params']['message']:
+                break
+
+        solc.send_message('textDocument/codeLens', {'textDocument': {'uri': uri}})
+        response, _ = self.wait_for_response(solc)
+        self.expect_equal(response['result'], [], "No code lenses without the code")
+
     # }}}
     # }}}
 
@@ -0,0 +1,503 @@
+/*
+ * Copyright (C) 2025 EverX. All Rights Reserved.
+ *
+ * Licensed under the  terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the  GNU General Public License for more details at: https://www.gnu.org/licenses/gpl-3.0.html
+ */
+/**
+ * Differential fuzzer of the TvmAst optimizers: random code is run by the interpreter before and
+ * after TVMContractCompiler::optimizeCode and both runs must end the same way.
+ */
+
+#include <libsolidity/codegen/TVM.hpp>
+#include <libsolidity/codegen/TVMCodeMetrics.hpp>
+#include <libsolidity/codegen/TVMContractCompiler.hpp>
+#include <libsolidity/codegen/TVMInterpreter.hpp>
+#include <libsolidity/codegen/TvmAstVisitor.hpp>
+
+#include <liblangutil/Exceptions.h>
+
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace solidity;
+using namespace solidity::frontend;
+
+// Prototype as we can't use the FuzzerInterface.h header.
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const* _data, size_t _size);
+
+namespace
+{
+
+/// Kinds of the values on the stack of the generated code. Booleans are -1 or 0, the optimizers
+/// assume that conditions are booleans, e.g. they replace NOT; THROWIFNOT with THROWIF.
+enum class Kind { Int, Bool, Builder, Cell, Slice };
+
+/// Global variables that always hold integers.
+int constexpr firstGlobal = 10;
+int constexpr globalCount = 2;
+int constexpr maxNesting = 3;
+size_t constexpr maxStackSize = 12;
+int64_t constexpr gasLimit = 100'000;
+
+/// Reads the choices of the generator from the input of the fuzzer.
+class FuzzInput
+{
+public:
+	FuzzInput(uint8_t const* _data, size_t _size): m_data{_data}, m_size{_size} {}
+
+	bool empty() const { return m_pos >= m_size; }
+	/// @returns a number in [0, _bound), 0 once the input is exhausted.
+	int next(int _bound)
+	{
+		if (empty() || _bound <= 1)
+			return 0;
+		return m_data[m_pos++] % _bound;
+	}
+	bigint nextInt()
+	{
+		static vector<bigint> const values{
+			0, 1, -1, 2, 3, 7, 8, 31, 32, 100, 127, -128, 255, 256, -256, 1000000,
+			(bigint(1) << 64) - 1, bigint(1) << 128, (bigint(1) << 255) - 1, -(bigint(1) << 255),
+			(bigint(1) << 256) - 1, -(bigint(1) << 256)
+		};
+		return values.at(next(static_cast<int>(values.size())));
+	}
+
+private:
+	uint8_t const* m_data;
+	size_t m_size;
+	size_t m_pos = 0;
+};
+
+/// Generates code that never underflows the stack and only applies instructions to values of
+/// the kinds they expect. Continuations only assign to the values below their own ones and never
+/// reorder them, as the code of the compiler does, so that every branch and every iteration of a
+/// loop leaves the stack in the same shape.
+class CodeGenerator
+{
+public:
+	explicit CodeGenerator(FuzzInput& _input): m_input{_input} {}
+
+	/// @returns the contract with the function "f" that takes @a _take integers.
+	Pointer<Contract> generate(int _take)
+	{
+		m_stack.assign(_take, Kind::Int);
+		vector<Pointer<TvmAstNode>> code = instructions(0, 0);
+		auto f = createNode<Function>(
+			_take,
+			static_cast<int>(m_stack.size()),
+			"f",
+			nullopt,
+			Function::FunctionType::Fragment,
+			createNode<CodeBlock>(CodeBlock::Type::None, code)
+		);
+		return createNode<Contract>(false, false, false, false, "", vector<Pointer<Function>>{f}, map<uint32_t, string>{});
+	}
+
+private:
+	/// @returns instructions that leave the stack with its first @a _floor kinds unchanged.
+	vector<Pointer<TvmAstNode>> instructions(size_t _floor, int _nesting)
+	{
+		size_t const outerFloor = m_floor;
+		m_floor = _floor;
+		vector<Pointer<TvmAstNode>> code;
+		int const length = 1 + m_input.next(_nesting == 0 ? 40 : 8);
+		for (int i = 0; i < length && !m_input.empty(); ++i)
+		{
+			vector<Kind> const saved = m_stack;
+			Pointer<TvmAstNode> node = instruction(_nesting);
+			bool const valid = node &&
+				m_stack.size() >= _floor &&
+				m_stack.size() <= maxStackSize &&
+				equal(saved.begin(), saved.begin() + static_cast<long>(_floor), m_stack.begin());
+			if (valid)
+				code.push_back(node);
+			else
+				m_stack = saved;
+		}
+		m_floor = outerFloor;
+		return code;
+	}
+
+	/// @returns a block that ends with @a _ret integers above the first @a _floor values.
+	Pointer<CodeBlock> block(size_t _floor, int _ret, int _nesting)
+	{
+		vector<Pointer<TvmAstNode>> code = instructions(_floor, _nesting);
+		// Remove the values that are not integers, then drop or add integers.
+		for (size_t i = 0; m_stack.size() > _floor + i;)
+		{
+			if (isInt(at(static_cast<int>(i))))
+				++i;
+			else
+			{
+				code.push_back(makeBLKDROP2(1, static_cast<int>(i)));
+				m_stack.erase(m_stack.end() - 1 - static_cast<long>(i));
+			}
+		}
+		int const extra = static_cast<int>(m_stack.size() - _floor) - _ret;
+		if (extra > 0)
+			code.push_back(makeDROP(extra));
+		for (int i = extra; i < 0; ++i)
+			code.push_back(gen("PUSHINT " + m_input.nextInt().str()));
+		// Branches may leave booleans in one and integers in the other.
+		m_stack.resize(_floor + static_cast<size_t>(_ret));
+		fill(m_stack.begin() + static_cast<long>(_floor), m_stack.end(), Kind::Int);
+		auto const type = m_input.next(4) == 0 ? CodeBlock::Type::PUSHREFCONT : CodeBlock::Type::PUSHCONT;
+		return createNode<CodeBlock>(type, code);
+	}
+
+	/// @returns an instruction and applies it to the kinds on the stack, or null if it does not fit.
+	Pointer<TvmAstNode> instruction(int _nesting)
+	{
+		int const size = static_cast<int>(m_stack.size());
+		// Only the values above the floor may be reordered or removed.
+		int const movable = size - static_cast<int>(m_floor);
+		auto index = [&]() { return m_input.next(size); };
+		switch (m_input.next(17))
+		{
+		case 0:
+			if (m_input.next(4) == 0)
+			{
+				m_stack.push_back(Kind::Bool);
+				return gen(m_input.next(2) == 0 ? "TRUE" : "FALSE");
+			}
+			m_stack.push_back(Kind::Int);
+			return gen("PUSHINT " + m_input.nextInt().str());
+		case 1:
+		{
+			if (size == 0)
+				return nullptr;
+			int const i = index();
+			Kind const kind = at(i);
+			m_stack.push_back(kind);
+			return makePUSH(i);
+		}
+		case 2:
+		{
+			if (size < 2)
+				return nullptr;
+			int const i = 1 + m_input.next(size - 1);
+			at(i) = at(0);
+			m_stack.pop_back();
+			return makePOP(i);
+		}
+		case 3:
+		{
+			if (movable < 2)
+				return nullptr;
+			int i = m_input.next(movable);
+			int j = m_input.next(movable);
+			if (i == j)
+				return nullptr;
+			if (i > j)
+				swap(i, j);
+			swap(at(i), at(j));
+			return makeXCH_S_S(i, j);
+		}
+		case 4:
+		{
+			if (movable == 0)
+				return nullptr;
+			int const n = 1 + m_input.next(min(movable, 3));
+			m_stack.resize(m_stack.size() - static_cast<size_t>(n));
+			return makeDROP(n);
+		}
+		case 5:
+		{
+			if (movable < 2)
+				return nullptr;
+			int const down = 1 + m_input.next(movable - 1);
+			int const up = 1 + m_input.next(movable - down);
+			rotate(m_stack.end() - down - up, m_stack.end() - up, m_stack.end());
+			return makeBLKSWAP(down, up);
+		}
+		case 6:
+		{
+			if (movable < 2)
+				return nullptr;
+			int const qty = 2 + m_input.next(movable - 1);
+			int const idx = m_input.next(movable - qty + 1);
+			reverse(m_stack.end() - idx - qty, m_stack.end() - idx);
+			return makeREVERSE(qty, idx);
+		}
+		case 7:
+		{
+			if (movable < 2)
+				return nullptr;
+			int const left = m_input.next(movable);
+			int const dropped = 1 + m_input.next(movable - left);
+			m_stack.erase(m_stack.end() - left - dropped, m_stack.end() - left);
+			return makeBLKDROP2(dropped, left);
+		}
+		case 8:
+		{
+			if (size == 0)
+				return nullptr;
+			int const i = m_input.next(min(size, 16));
+			int const j = m_input.next(min(size, 16));
+			if (m_input.next(2) == 0)
+			{
+				int const qty = 1 + m_input.next(3);
+				for (int k = 0; k < qty; ++k)
+				{
+					Kind const kind = at(i);
+					m_stack.push_back(kind);
+				}
+				return makeBLKPUSH(qty, i);
+			}
+			Kind const first = at(i);
+			m_stack.push_back(first);
+			Kind const second = at(j + 1);
+			m_stack.push_back(second);
+			return makePUSH2(i, j);
+		}
+		case 9:
+		{
+			static vector<string> const unary{"INC", "DEC", "NEGATE", "NOT", "ABS", "ISNEG", "SGN", "UBITSIZE"};
+			if (!topInts(1))
+				return nullptr;
+			string const opcode = unary.at(m_input.next(static_cast<int>(unary.size())));
+			if (opcode == "ISNEG")
+				m_stack.back() = Kind::Bool;
+			else if (opcode != "NOT")
+				m_stack.back() = Kind::Int;
+			return gen(opcode);
+		}
+		case 10:
+		{
+			static vector<string> const binary{
+				"ADD", "SUB", "MUL", "DIV", "MOD", "AND", "OR", "XOR", "MIN", "MAX",
+				"LESS", "GREATER", "LEQ", "GEQ", "EQUAL", "NEQ"
+			};
+			if (!topInts(2))
+				return nullptr;
+			string const opcode = binary.at(m_input.next(static_cast<int>(binary.size())));
+			bool const bothBool = at(0) == Kind::Bool && at(1) == Kind::Bool;
+			m_stack.pop_back();
+			if (isIn(opcode, "LESS", "GREATER", "LEQ", "GEQ", "EQUAL", "NEQ"))
+				m_stack.back() = Kind::Bool;
+			else if (!isIn(opcode, "AND", "OR", "XOR") || !bothBool)
+				m_stack.back() = Kind::Int;
+			return gen(opcode);
+		}
+		case 11:
+			return cellInstruction();
+		case 12:
+		{
+			int const global = firstGlobal + m_input.next(globalCount);
+			if (m_input.next(2) == 0)
+			{
+				m_stack.push_back(Kind::Int);
+				return makeGetGlob(global);
+			}
+			if (!topInts(1))
+				return nullptr;
+			m_stack.pop_back();
+			return makeSetGlob(global);
+		}
+		case 13:
+			if (m_input.next(2) == 0)
+			{
+				m_stack.push_back(Kind::Cell);
+				return createNode<Glob>(Glob::Opcode::PUSHROOT);
+			}
+			if (!top({Kind::Cell}))
+				return nullptr;
+			m_stack.pop_back();
+			return createNode<Glob>(Glob::Opcode::POPROOT);
+		case 14:
+		{
+			if (!top({Kind::Bool}) || _nesting >= maxNesting)
+				return nullptr;
+			m_stack.pop_back();
+			size_t const floor = m_stack.size();
+			vector<Kind> const saved = m_stack;
+			bool const withElse = m_input.next(2) == 0;
+			int const ret = withElse ? m_input.next(3) : 0;
+			Pointer<CodeBlock> trueBody = block(floor, ret, _nesting + 1);
+			Pointer<CodeBlock> falseBody;
+			if (withElse)
+			{
+				m_stack = saved;
+				falseBody = block(floor, ret, _nesting + 1);
+			}
+			bool const withNot = !withElse && m_input.next(2) == 0;
+			return createNode<TvmIfElse>(withNot, false, trueBody, falseBody, ret);
+		}
+		case 15:
+		{
+			if (!topInts(1) || _nesting >= maxNesting)
+				return nullptr;
+			m_stack.pop_back();
+			Pointer<CodeBlock> body = block(m_stack.size(), 0, _nesting + 1);
+			return createNode<TvmRepeat>(false, body);
+		}
+		case 16:
+			if (!top({Kind::Bool}))
+				return nullptr;
+			m_stack.pop_back();
+			return makeTHROW(string{m_input.next(2) == 0 ? "THROWIF" : "THROWIFNOT"} + " " + to_string(100 + m_input.next(3)));
+		}
+		return nullptr;
+	}
+
+	Pointer<TvmAstNode> cellInstruction()
+	{
+		static vector<int> const widths{1, 8, 16, 32, 64, 256};
+		string const width = to_string(widths.at(m_input.next(static_cast<int>(widths.size()))));
+		switch (m_input.next(10))
+		{
+		case 0:
+			m_stack.push_back(Kind::Builder);
+			return gen("NEWC");
+		case 1:
+			if (m_stack.size() < 2 || !top({Kind::Builder}) || !isInt(at(1)))
+				return nullptr;
+			m_stack.erase(m_stack.end() - 2);
+			return gen("STU " + width);
+		case 2:
+			if (!top({Kind::Slice, Kind::Builder}))
+				return nullptr;
+			m_stack.erase(m_stack.end() - 2);
+			return gen("STSLICE");
+		case 3:
+			if (!top({Kind::Cell, Kind::Builder}))
+				return nullptr;
+			m_stack.erase(m_stack.end() - 2);
+			return gen("STREF");
+		case 4:
+			if (!top({Kind::Builder}))
+				return nullptr;
+			m_stack.back() = Kind::Cell;
+			return gen("ENDC");
+		case 5:
+			if (!top({Kind::Cell}))
+				return nullptr;
+			m_stack.back() = Kind::Slice;
+			return gen("CTOS");
+		case 6:
+			if (!top({Kind::Slice}))
+				return nullptr;
+			m_stack.back() = Kind::Int;
+			m_stack.push_back(Kind::Slice);
+			return gen("LDU " + width);
+		case 7:
+			if (!top({Kind::Slice}))
+				return nullptr;
+			m_stack.back() = Kind::Int;
+			return gen("PLDU " + width);
+		case 8:
+			if (!top({Kind::Slice}))
+				return nullptr;
+			m_stack.back() = Kind::Int;
+			return gen("SBITS");
+		case 9:
+			if (!top({Kind::Cell}))
+				return nullptr;
+			m_stack.back() = Kind::Int;
+			return gen("HASHCU");
+		}
+		return nullptr;
+	}
+
+	static bool isInt(Kind _kind) { return _kind == Kind::Int || _kind == Kind::Bool; }
+	bool topInts(size_t _count) const
+	{
+		return m_stack.size() >= _count && all_of(m_stack.end() - static_cast<long>(_count), m_stack.end(), isInt);
+	}
+	/// @returns the kind of s(i).
+	Kind& at(int _i) { return m_stack.at(m_stack.size() - 1 - static_cast<size_t>(_i)); }
+	/// @returns true if the kinds on the top of the stack are @a _kinds, the last one on the top.
+	bool top(initializer_list<Kind> _kinds) const
+	{
+		return m_stack.size() >= _kinds.size() && equal(_kinds.begin(), _kinds.end(), m_stack.end() - static_cast<long>(_kinds.size()));
+	}
+
+	FuzzInput& m_input;
+	vector<Kind> m_stack;
+	/// The number of values at the bottom of the stack that the current continuation may not reorder.
+	size_t m_floor = 0;
+};
+
+string printCode(Contract& _contract)
+{
+	ostringstream out;
+	Printer printer{out};
+	_contract.functions().at(0)->block()->accept(printer);
+	return out.str();
+}
+
+int codeBits(Contract const& _contract)
+{
+	return TVMCodeMetrics{_contract}.functions().at(0).bits;
+}
+
+}
+
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const* _data, size_t _size)
+{
+	if (_size > 600)
+		return 0;
+	GlobalParams::g_tvmVersion = langutil::TVMVersion{};
+
+	// The optimizers change the code in place, so the code is generated twice.
+	FuzzInput input{_data, _size};
+	int const take = input.next(5);
+	TVMRunState state;
+	for (int i = 0; i < take; ++i)
+		state.stack.emplace_back(input.nextInt());
+	vector<VmValue> c7 = *get<VmTuple>(TVMInterpreter::defaultC7().value);
+	c7.resize(firstGlobal);
+	for (int i = 0; i < globalCount; ++i)
+		c7.emplace_back(input.nextInt());
+	state.c7 = VmValue{make_shared<vector<VmValue> const>(move(c7))};
+
+	FuzzInput originalInput = input;
+	Pointer<Contract> original = CodeGenerator{originalInput}.generate(take);
+	Pointer<Contract> optimized = CodeGenerator{input}.generate(take);
+
+	TVMRunResult const expected = TVMInterpreter{original.get(), gasLimit}.run("f", state);
+	// The optimizers may remove instructions without side effects that fail, e.g. an overflowing
+	// ADD whose result is dropped, so only returns and explicit exceptions are compared.
+	if (expected.exitCode != 0 && expected.exitCode < 100)
+		return 0;
+
+	TVMContractCompiler::optimizeCode(optimized);
+	TVMRunResult const result = TVMInterpreter{optimized.get(), gasLimit}.run("f", state);
+	if (result.exitCode == -14)
+		return 0;
+
+	if (!expected.sameOutcome(result))
+	{
+		cerr << "Original code:" << endl << printCode(*original);
+		cerr << "Exit code " << expected.exitCode << ", stack:";
+		for (VmValue const& value: expected.state.stack)
+			cerr << " " << value.toString();
+		cerr << endl << "Optimized code:" << endl << printCode(*optimized);
+		cerr << "Exit code " << result.exitCode << ", stack:";
+		for (VmValue const& value: result.state.stack)
+			cerr << " " << value.toString();
+		cerr << endl;
+		solAssert(false, "Optimized code behaves differently.");
+	}
+
+	// Report optimizations that make the code bigger or more expensive and gain nothing.
+	int const bitsDelta = codeBits(*optimized) - codeBits(*original);
+	int64_t const gasDelta = result.gasUsed - expected.gasUsed;
+	bool const returned = expected.exitCode == 0;
+	if (returned && ((bitsDelta > 0 && gasDelta >= 0) || (gasDelta > 0 && bitsDelta >= 0)))
+		cerr << "Unprofitable optimization: " << showpos << bitsDelta << " bits, " << gasDelta << " gas"
+			<< noshowpos << endl << printCode(*original) << "=>" << endl << printCode(*optimized);
+	return 0;
+}
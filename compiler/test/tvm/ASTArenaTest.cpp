@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2025 EverX. All Rights Reserved.
+ *
+ * Licensed under the  terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the  GNU General Public License for more details at: https://www.gnu.org/licenses/gpl-3.0.html
+ */
+/**
+ * Unit tests of the arena allocation of the syntax tree.
+ */
+
+#include <libsolidity/ast/AST.h>
+#include <libsolidity/ast/ASTArena.h>
+#include <libsolidity/parsing/Parser.h>
+
+#include <liblangutil/CharStream.h>
+#include <liblangutil/ErrorReporter.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+#include <string>
+
+using namespace std;
+using namespace solidity::langutil;
+
+namespace solidity::frontend::test
+{
+
+namespace
+{
+
+ASTPointer<SourceUnit> parse(string const& _source, bool _arenaAllocation)
+{
+	ErrorList errors;
+	ErrorReporter errorReporter(errors);
+	CharStream charStream(_source, "");
+	ASTPointer<SourceUnit> sourceUnit = Parser(errorReporter, EVMVersion{}, _arenaAllocation).parse(charStream);
+	BOOST_REQUIRE(sourceUnit && !Error::containsErrors(errors));
+	return sourceUnit;
+}
+
+string const sourceCode = R"(
+	contract test {
+		uint256 stateVar;
+		/// This is a test function
+		function functionName(bytes32 input) public returns (bytes32 out) { out = input; }
+	}
+)";
+
+}
+
+BOOST_AUTO_TEST_SUITE(ASTArenaTest)
+
+BOOST_AUTO_TEST_CASE(allocation)
+{
+	ASTArena arena;
+	void* node = arena.allocateNode(24, 8);
+	void* annotation = arena.allocateAnnotation(40, 16);
+	BOOST_CHECK(node != annotation);
+	BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(node) % 8, 0);
+	BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(annotation) % 16, 0);
+	BOOST_CHECK_EQUAL(arena.allocatedBytes(), 24 + 40);
+}
+
+BOOST_AUTO_TEST_CASE(nodes_and_annotations)
+{
+	ASTPointer<SourceUnit> sourceUnit = parse(sourceCode, true);
+	auto contract = dynamic_pointer_cast<ContractDefinition>(sourceUnit->nodes().at(0));
+	BOOST_REQUIRE(contract);
+	contract->annotation().unimplementedDeclarations = vector<Declaration const*>{};
+
+	BOOST_CHECK_EQUAL(contract->name(), "test");
+	BOOST_REQUIRE(contract->annotation().unimplementedDeclarations);
+	BOOST_CHECK(contract->annotation().unimplementedDeclarations->empty());
+	FunctionDefinition const* function = contract->definedFunctions().at(0);
+	BOOST_REQUIRE(function->documentation());
+	BOOST_CHECK_EQUAL(*function->documentation()->text(), "This is a test function");
+	BOOST_CHECK_EQUAL(function->body().statements().size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(node_outlives_source_unit)
+{
+	// The nodes share the arena, so a node stays valid without its source unit.
+	ASTPointer<SourceUnit> sourceUnit = parse(sourceCode, true);
+	auto contract = dynamic_pointer_cast<ContractDefinition>(sourceUnit->nodes().at(0));
+	BOOST_REQUIRE(contract);
+	weak_ptr<SourceUnit> weakSourceUnit = sourceUnit;
+	sourceUnit.reset();
+	BOOST_CHECK(weakSourceUnit.expired());
+
+	contract->annotation().unimplementedDeclarations = vector<Declaration const*>{};
+	BOOST_CHECK_EQUAL(contract->name(), "test");
+	FunctionDefinition const* function = contract->definedFunctions().at(0);
+	BOOST_CHECK_EQUAL(function->name(), "functionName");
+	BOOST_CHECK_EQUAL(function->body().statements().size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(same_tree_as_heap)
+{
+	ASTPointer<SourceUnit> heap = parse(sourceCode, false);
+	ASTPointer<SourceUnit> arena = parse(sourceCode, true);
+	BOOST_REQUIRE_EQUAL(heap->nodes().size(), arena->nodes().size());
+	BOOST_CHECK_EQUAL(heap->id(), arena->id());
+	BOOST_CHECK(heap->location() == arena->location());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2025 EverX. All Rights Reserved.
+ *
+ * Licensed under the  terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the  GNU General Public License for more details at: https://www.gnu.org/licenses/gpl-3.0.html
+ */
+/**
+ * Unit tests of compilations that run on several threads at once.
+ */
+
+#include <libsolidity/codegen/TVM.hpp>
+#include <libsolidity/interface/CompilerStack.h>
+
+#include <libsolc/libsolc.h>
+
+#include <libsolutil/JSON.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace solidity::frontend::test
+{
+
+namespace
+{
+
+/// Compiles @a _input without solidity_reset(), so that it can be called from several threads.
+string compileConcurrently(string const& _input)
+{
+	char* output_ptr = solidity_compile(_input.c_str(), nullptr, nullptr);
+	string output(output_ptr);
+	solidity_free(output_ptr);
+	return output;
+}
+
+string contractSource(size_t _index)
+{
+	string const name = "C" + to_string(_index);
+	string const type = "uint" + to_string(8 * (_index + 1));
+	return
+		"// SPDX-License-Identifier: GPL-3.0\n"
+		"pragma tvm-solidity >= 0.72.0;\n"
+		"contract " + name + " {\n"
+		"	" + type + " m_value;\n"
+		"	mapping(" + type + " => string) m_names;\n"
+		"	/// @dev Stores the value.\n"
+		"	function set(" + type + " value, string name) public {\n"
+		"		tvm.accept();\n"
+		"		m_value = value * " + to_string(_index + 2) + ";\n"
+		"		m_names[value] = name + \"" + name + "\";\n"
+		"	}\n"
+		"	function get(" + type + " value) public view returns (" + type + ", string) {\n"
+		"		return (m_value, m_names[value]);\n"
+		"	}\n"
+		"}\n";
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(ConcurrencyTest)
+
+BOOST_AUTO_TEST_CASE(concurrent_compilation)
+{
+	size_t const contractQty = 8;
+	size_t const roundQty = 4;
+
+	vector<string> inputs;
+	for (size_t i = 0; i < contractQty; ++i)
+	{
+		Json::Value input;
+		input["language"] = "Solidity";
+		input["sources"]["C" + to_string(i) + ".sol"]["content"] = contractSource(i);
+		input["settings"]["outputSelection"]["*"]["*"].append("abi");
+		input["settings"]["outputSelection"]["*"]["*"].append("assembly");
+		inputs.emplace_back(util::jsonCompactPrint(input));
+	}
+
+	vector<string> expected;
+	for (string const& input: inputs)
+		expected.emplace_back(compileConcurrently(input));
+
+	for (string const& output: expected)
+	{
+		Json::Value result;
+		BOOST_REQUIRE(util::jsonParseStrict(output, result));
+		BOOST_REQUIRE(result.isMember("contracts"));
+	}
+
+	vector<vector<string>> outputs(contractQty);
+	vector<thread> threads;
+	for (size_t i = 0; i < contractQty; ++i)
+		threads.emplace_back([&, i]() {
+			for (size_t round = 0; round < roundQty; ++round)
+				outputs[i].emplace_back(compileConcurrently(inputs[(i + round) % contractQty]));
+		});
+	for (thread& thread: threads)
+		thread.join();
+
+	for (size_t i = 0; i < contractQty; ++i)
+		for (size_t round = 0; round < roundQty; ++round)
+			BOOST_CHECK_EQUAL(outputs[i][round], expected[(i + round) % contractQty]);
+}
+
+BOOST_AUTO_TEST_CASE(getters_activate_their_compilation)
+{
+	// The stack is analyzed on another thread and its artifacts are requested while
+	// a different compilation is current on this thread.
+	CompilerStack stack;
+	bool analyzed = false;
+	thread([&]() {
+		stack.setSources({{"C0.sol", contractSource(0)}});
+		analyzed = stack.parseAndAnalyze(CompilerStack::State::AnalysisSuccessful);
+	}).join();
+	BOOST_REQUIRE(analyzed);
+
+	CompilerStack other;
+	BOOST_REQUIRE(GlobalParams::g_charStreamProvider == &other);
+	Json::Value const symbols = stack.interfaceSymbols("C0.sol:C0");
+	BOOST_CHECK(GlobalParams::g_charStreamProvider == &stack);
+	BOOST_CHECK_EQUAL(symbols["methods"].size(), 2);
+
+	other.activate();
+	Json::Value const& dev = stack.natspecDev("C0.sol:C0");
+	BOOST_CHECK(GlobalParams::g_charStreamProvider == &stack);
+	BOOST_CHECK_EQUAL(dev["methods"].size(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
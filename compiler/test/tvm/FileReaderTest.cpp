@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2025 EverX. All Rights Reserved.
+ *
+ * Licensed under the  terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the  GNU General Public License for more details at: https://www.gnu.org/licenses/gpl-3.0.html
+ */
+/**
+ * Unit tests of the source files shared by FileReader and SourceStore.
+ */
+
+#include <libsolidity/interface/FileReader.h>
+#include <libsolidity/interface/SourceStore.h>
+
+#include <libsolutil/TemporaryDirectory.h>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <fstream>
+#include <string>
+
+using namespace std;
+using namespace solidity::util;
+
+#define TEST_CASE_NAME (boost::unit_test::framework::current_test_case().p_name)
+
+namespace solidity::frontend::test
+{
+
+BOOST_AUTO_TEST_SUITE(FileReaderTest)
+
+BOOST_AUTO_TEST_CASE(readFile_shares_contents)
+{
+	TemporaryDirectory tempDir(TEST_CASE_NAME);
+	// Large enough to be mapped into memory.
+	string const source = "contract C {}\n" + string(40000, ' ');
+	ofstream(tempDir.path() / "a.sol") << source;
+	ofstream(tempDir.path() / "b.sol") << source;
+
+	FileReader reader(tempDir.path());
+	ReadCallback::Result a = reader.readFile("source", "a.sol");
+	ReadCallback::Result b = reader.readFile("source", "file://b.sol");
+	BOOST_REQUIRE(a.success && a.contents);
+	BOOST_REQUIRE(b.success && b.contents);
+	BOOST_TEST(a.response() == source);
+	BOOST_TEST(a.contents == b.contents);
+	BOOST_TEST(a.contents->text().data()[source.size()] == '\0');
+	BOOST_TEST(reader.sourceBuffers().at("a.sol") == a.contents);
+	BOOST_TEST(reader.sourceUnits() == (FileReader::StringMap{{"a.sol", source}, {"file://b.sol", source}}));
+
+	FileReader otherReader(tempDir.path());
+	BOOST_TEST(otherReader.readFile("source", "a.sol").contents == a.contents);
+
+	boost::filesystem::remove(tempDir.path() / "a.sol");
+	FileReader removedReader(tempDir.path());
+	ReadCallback::Result removed = removedReader.readFile("source", "a.sol");
+	BOOST_TEST(!removed.success);
+	BOOST_TEST(boost::starts_with(removed.responseOrErrorMessage, "File not found."));
+}
+
+BOOST_AUTO_TEST_CASE(readFile_rewritten_with_same_size)
+{
+	// The modification time may not change, since it is stored with a coarse granularity.
+	TemporaryDirectory tempDir(TEST_CASE_NAME);
+	ofstream(tempDir.path() / "a.sol") << "contract A {}";
+	FileReader reader(tempDir.path());
+	ReadCallback::Result a = reader.readFile("source", "a.sol");
+	BOOST_TEST(a.response() == "contract A {}");
+
+	ofstream(tempDir.path() / "a.sol") << "contract B {}";
+	FileReader changedReader(tempDir.path());
+	BOOST_TEST(changedReader.readFile("source", "a.sol").response() == "contract B {}");
+}
+
+BOOST_AUTO_TEST_CASE(readFile_resolves_every_time)
+{
+	// A file that appears in an include path later makes the import ambiguous.
+	TemporaryDirectory tempDir({"base", "include"}, TEST_CASE_NAME);
+	ofstream(tempDir.path() / "base/a.sol") << "contract A {}";
+	FileReader reader(tempDir.path() / "base", {tempDir.path() / "include"});
+	BOOST_TEST(reader.readFile("source", "a.sol").success);
+
+	ofstream(tempDir.path() / "include/a.sol") << "contract A {}";
+	FileReader ambiguousReader(tempDir.path() / "base", {tempDir.path() / "include"});
+	ReadCallback::Result ambiguous = ambiguousReader.readFile("source", "a.sol");
+	BOOST_TEST(!ambiguous.success);
+	BOOST_TEST(boost::starts_with(ambiguous.responseOrErrorMessage, "Ambiguous import."));
+}
+
+BOOST_AUTO_TEST_CASE(readFile_outside_allowed_directories)
+{
+	// A symlink that is retargeted outside of the allowed directories is not followed anymore.
+	TemporaryDirectory tempDir({"base", "outside"}, TEST_CASE_NAME);
+	ofstream(tempDir.path() / "base/target.sol") << "contract A {}";
+	ofstream(tempDir.path() / "outside/target.sol") << "contract A {}";
+	boost::filesystem::create_symlink(tempDir.path() / "base/target.sol", tempDir.path() / "base/a.sol");
+	FileReader reader(tempDir.path() / "base");
+	BOOST_TEST(reader.readFile("source", "a.sol").success);
+
+	boost::filesystem::remove(tempDir.path() / "base/a.sol");
+	boost::filesystem::create_symlink(tempDir.path() / "outside/target.sol", tempDir.path() / "base/a.sol");
+	FileReader retargetedReader(tempDir.path() / "base");
+	ReadCallback::Result retargeted = retargetedReader.readFile("source", "a.sol");
+	BOOST_TEST(!retargeted.success);
+	BOOST_TEST(boost::starts_with(retargeted.responseOrErrorMessage, "File outside of allowed directories."));
+}
+
+BOOST_AUTO_TEST_CASE(store_keeps_no_buffers_alive)
+{
+	TemporaryDirectory tempDir(TEST_CASE_NAME);
+	ofstream(tempDir.path() / "a.sol") << "contract A {}";
+	weak_ptr<SourceBuffer const> buffer;
+	{
+		FileReader reader(tempDir.path());
+		buffer = reader.readFile("source", "a.sol").contents;
+		BOOST_TEST(!buffer.expired());
+		BOOST_TEST(SourceStore::instance().add("contract A {}") == buffer.lock());
+	}
+	BOOST_TEST(buffer.expired());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
@@ -0,0 +1,304 @@
+/*
+ * Copyright (C) 2025 EverX. All Rights Reserved.
+ *
+ * Licensed under the  terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the  GNU General Public License for more details at: https://www.gnu.org/licenses/gpl-3.0.html
+ */
+/**
+ * Unit tests of the peephole optimizer: the rewrites of its rule table at the start, in the middle
+ * and at the end of long blocks, the rewrites that enable rewrites of earlier instructions, and
+ * random blocks that must behave the same in the interpreter before and after the optimization.
+ */
+
+#include <libsolidity/codegen/PeepholeOptimizer.hpp>
+#include <libsolidity/codegen/TVM.hpp>
+#include <libsolidity/codegen/TVMInterpreter.hpp>
+#include <libsolidity/codegen/TvmAst.hpp>
+#include <libsolidity/codegen/TvmAstVisitor.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <functional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace solidity::frontend::test
+{
+
+namespace
+{
+
+using Code = vector<Pointer<TvmAstNode>>;
+
+/// Generates straight-line code on integers that never underflows the stack. The results of
+/// arithmetic are reduced modulo a constant, so that long blocks do not overflow.
+class LinearCodeGenerator
+{
+public:
+	LinearCodeGenerator(unsigned _seed, int _stackSize): m_random{_seed}, m_stackSize{_stackSize} {}
+
+	Code generate(size_t _size)
+	{
+		Code code;
+		while (code.size() < _size)
+			for (Pointer<TvmAstNode> const& node: snippet())
+				code.push_back(node);
+		return code;
+	}
+
+private:
+	/// @returns a few instructions, often ones that the rules rewrite.
+	Code snippet()
+	{
+		// Keep the stack small, so that PUSH and POP reach all of it.
+		if (m_stackSize > 12)
+		{
+			m_stackSize -= 2;
+			return {makeDROP(2)};
+		}
+		int const size = m_stackSize;
+		switch (number(16))
+		{
+		case 0:
+			++m_stackSize;
+			return {gen("PUSHINT " + to_string(number(300)))};
+		case 1:
+			if (size == 0)
+				break;
+			++m_stackSize;
+			return {makePUSH(number(size))};
+		case 2:
+			if (size < 2)
+				break;
+			--m_stackSize;
+			return {makePOP(1 + number(size - 1))};
+		case 3:
+			if (size < 2)
+				break;
+			return {makeXCH_S(1 + number(size - 1))};
+		case 4:
+			if (size == 0)
+				break;
+			return {makePUSH(number(size)), makeDROP()};
+		case 5:
+			if (size < 3)
+				break;
+			--m_stackSize;
+			return {makeBLKSWAP(1, 1 + number(size - 2)), gen(number(2) == 0 ? "SUB" : "ADD"), gen("PUSHINT 1000"), gen("MOD")};
+		case 6:
+			if (size == 0)
+				break;
+			return {gen("PUSHINT " + to_string(number(100))), gen("ADD"), gen("PUSHINT 1024"), gen("MOD")};
+		case 7:
+			if (size == 0)
+				break;
+			return {gen("PUSHINT 8"), gen("MUL"), gen("PUSHINT 997"), gen("MOD")};
+		case 8:
+			++m_stackSize;
+			return {gen(number(2) == 0 ? "TRUE" : "FALSE"), gen("NOT")};
+		case 9:
+			if (size < 2)
+				break;
+			--m_stackSize;
+			return {gen("EQUAL"), gen("NOT")};
+		case 10:
+			if (size < 2)
+				break;
+			--m_stackSize;
+			return {makePUSH(0), makeBLKDROP2(2, 1)};
+		case 11:
+			if (size < 3)
+				break;
+			return {makeREVERSE(2 + number(size - 2), 0)};
+		case 12:
+			if (size < 2)
+				break;
+			m_stackSize -= 1;
+			return {makeBLKDROP2(1, number(size - 1))};
+		case 13:
+			if (size < 2)
+				break;
+			m_stackSize += 2;
+			return {makePUSH2(number(size), number(size))};
+		case 14:
+			if (size < 2)
+				break;
+			--m_stackSize;
+			return {gen(number(2) == 0 ? "AND" : "XOR")};
+		case 15:
+			if (size == 0)
+				break;
+			return {gen(number(2) == 0 ? "INC" : "NEGATE"), gen("PUSHINT 512"), gen("MOD")};
+		}
+		++m_stackSize;
+		return {gen("PUSHINT " + to_string(number(50)))};
+	}
+
+	int number(int _bound) { return uniform_int_distribution<int>{0, _bound - 1}(m_random); }
+
+	mt19937 m_random;
+	int m_stackSize;
+};
+
+struct PeepholeFixture
+{
+	PeepholeFixture() { GlobalParams::g_tvmVersion = langutil::TVMVersion{}; }
+
+	static Pointer<CodeBlock> block(Code const& _code)
+	{
+		return createNode<CodeBlock>(CodeBlock::Type::None, _code);
+	}
+
+	static Pointer<CodeBlock> optimize(Code const& _code)
+	{
+		Pointer<CodeBlock> result = block(_code);
+		PeepholeOptimizer optimizer{{}};
+		result->accept(optimizer);
+		return result;
+	}
+
+	static string print(CodeBlock const& _block)
+	{
+		ostringstream out;
+		Printer printer{out};
+		for (Pointer<TvmAstNode> const& node: _block.instructions())
+			node->accept(printer);
+		return out.str();
+	}
+
+	static TVMRunResult run(CodeBlock const& _block, vector<VmValue> _stack)
+	{
+		return TVMInterpreter{nullptr, 10'000'000}.run(_block, {move(_stack), nullptr, TVMInterpreter::defaultC7()});
+	}
+
+	static vector<VmValue> ints(int _count)
+	{
+		vector<VmValue> stack;
+		for (int i = 0; i < _count; ++i)
+			stack.emplace_back(bigint(3 * i + 1));
+		return stack;
+	}
+
+	/// @returns @a _pairs times INC; SWAP, which no rule rewrites.
+	static Code filler(size_t _pairs)
+	{
+		Code code;
+		for (size_t i = 0; i < _pairs; ++i)
+		{
+			code.push_back(gen("INC"));
+			code.push_back(makeXCH_S(1));
+		}
+		return code;
+	}
+
+	static Code concat(initializer_list<Code> _parts)
+	{
+		Code code;
+		for (Code const& part: _parts)
+			code.insert(code.end(), part.begin(), part.end());
+		return code;
+	}
+};
+
+}
+
+BOOST_FIXTURE_TEST_SUITE(PeepholeOptimizerTest, PeepholeFixture)
+
+BOOST_AUTO_TEST_CASE(filler_is_kept)
+{
+	Code const code = filler(50);
+	BOOST_CHECK_EQUAL(print(*optimize(code)), print(*block(code)));
+}
+
+BOOST_AUTO_TEST_CASE(rewrites_across_long_blocks)
+{
+	// The same rewrite at the start, in the middle and at the end of a block, so that the
+	// rewrites happen far from each other in the instruction buffer.
+	Code const rewritten{makePUSH(1), makeDROP()};
+	Code const code = concat({rewritten, filler(1500), rewritten, filler(1500), rewritten});
+	Pointer<CodeBlock> const optimized = optimize(code);
+	BOOST_CHECK_EQUAL(print(*optimized), print(*block(concat({filler(1500), filler(1500)}))));
+	TVMRunResult const expected = run(*block(code), ints(2));
+	BOOST_REQUIRE_EQUAL(expected.exitCode, 0);
+	BOOST_CHECK(expected.sameOutcome(run(*optimized, ints(2))));
+}
+
+BOOST_AUTO_TEST_CASE(rewrites_enable_earlier_rewrites)
+{
+	// Removing the innermost PUSH; DROP makes the pair around it adjacent, so every rewrite
+	// enables one at an earlier instruction.
+	for (size_t depth: {1, 2, 16, 100})
+	{
+		Code pushes;
+		Code drops;
+		for (size_t i = 0; i < depth; ++i)
+		{
+			pushes.push_back(makePUSH(static_cast<int>(i % 2)));
+			drops.push_back(makeDROP());
+		}
+		Code const code = concat({filler(250), pushes, drops, filler(250)});
+		BOOST_CHECK_EQUAL(print(*optimize(code)), print(*block(concat({filler(250), filler(250)}))));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(constants)
+{
+	BOOST_CHECK_EQUAL(print(*optimize({gen("TRUE"), gen("NOT")})), print(*block({gen("FALSE")})));
+	BOOST_CHECK_EQUAL(print(*optimize(concat({filler(20), {gen("FALSE"), gen("NOT")}}))), print(*block(concat({filler(20), {gen("TRUE")}}))));
+}
+
+BOOST_AUTO_TEST_CASE(random_blocks)
+{
+	size_t rewritten = 0;
+	for (unsigned seed = 1; seed <= 40; ++seed)
+	{
+		int const stackSize = static_cast<int>(seed % 5);
+		size_t const size = seed % 10 == 0 ? 3000 : 20 + seed * 10;
+		Code const code = LinearCodeGenerator{seed, stackSize}.generate(size);
+		// The optimizer changes the blocks in place, so the original block is generated again.
+		Pointer<CodeBlock> const original = block(LinearCodeGenerator{seed, stackSize}.generate(size));
+		Pointer<CodeBlock> const optimized = optimize(code);
+
+		TVMRunResult const expected = run(*original, ints(stackSize));
+		BOOST_REQUIRE_EQUAL(expected.exitCode, 0);
+		TVMRunResult const result = run(*optimized, ints(stackSize));
+		BOOST_CHECK_MESSAGE(
+			expected.sameOutcome(result),
+			"seed " + to_string(seed) + "\n" + print(*original) + "=>\n" + print(*optimized)
+		);
+		BOOST_CHECK_LE(result.gasUsed, expected.gasUsed);
+		if (optimized->instructions().size() < original->instructions().size())
+			++rewritten;
+	}
+	BOOST_CHECK_EQUAL(rewritten, 40);
+}
+
+BOOST_AUTO_TEST_CASE(statistics)
+{
+	PeepholeStats stats;
+	PeepholeOptimizer optimizer{{}, &stats};
+	block(concat({{makePUSH(1), makeDROP()}, filler(10), {gen("TRUE"), gen("NOT")}}))->accept(optimizer);
+	Json::Value const json = stats.toJson();
+	int64_t hits = 0;
+	for (Json::Value const& rule: json["rules"])
+		hits += rule["hits"].asInt64();
+	BOOST_CHECK_EQUAL(hits, 2);
+	BOOST_CHECK_EQUAL(json["rules"]["ConstBoolNot"]["hits"].asInt64(), 1);
+	// No rule of one instruction starts with these instructions, so that window is never tried.
+	BOOST_CHECK(!json["matchers"].isMember("window1"));
+	BOOST_CHECK(json["matchers"].isMember("window2"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
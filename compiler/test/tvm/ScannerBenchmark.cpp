@@ -0,0 +1,124 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+// SPDX-License-Identifier: GPL-3.0
+/**
+ * Throughput benchmark for the scanner on large generated sources.
+ * Disabled by default, run it with --run_test=ScannerBenchmark.
+ */
+
+#include <liblangutil/Scanner.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <string>
+
+namespace solidity::langutil::test
+{
+
+namespace
+{
+
+size_t constexpr sourceSize = 4 * 1024 * 1024;
+
+/// A large table of constants, as emitted by code generators.
+std::string constantTable()
+{
+	std::string source = "contract Table {\n";
+	for (size_t i = 0; source.size() < sourceSize; ++i)
+		source +=
+			"\tuint256 constant public generatedTableEntryNumber" + std::to_string(i) +
+			"        = 0x" + std::string(64, "0123456789abcdef"[i % 16]) + ";\n";
+	return source + "}\n";
+}
+
+/// An interface whose functions are documented with long NatSpec comments.
+std::string natSpecInterface()
+{
+	std::string source = "interface Documented {\n";
+	for (size_t i = 0; source.size() < sourceSize; ++i)
+		source +=
+			"\t/// @notice Returns the balance of the account that is identified by the given address.\n"
+			"\t/// @dev The balance is read from the persistent storage of the contract.\n"
+			"\t/**\n"
+			"\t * @param owner The address of the account whose balance is requested.\n"
+			"\t * @return The current balance of the account, in nanotons.\n"
+			"\t */\n"
+			"\tfunction balanceOf" + std::to_string(i) + "(address owner) external view returns (uint128);\n"
+			"\t// Plain comments are skipped entirely: ----------------------------------------------\n";
+	return source + "}\n";
+}
+
+/// A contract that embeds large code cells as hex string literals.
+std::string hexBlobs()
+{
+	std::string source = "contract Blobs {\n";
+	for (size_t i = 0; source.size() < sourceSize; ++i)
+	{
+		source += "\tbytes constant blob" + std::to_string(i) + " = hex\"";
+		for (size_t j = 0; j < 4096; ++j)
+			source += "0123456789abcdefABCDEF"[(i + j) % 22];
+		source += "\";\n";
+	}
+	return source + "}\n";
+}
+
+void benchmark(std::string const& _name, std::string const& _source)
+{
+	size_t constexpr repetitions = 5;
+	size_t tokens = 0;
+	auto const start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < repetitions; ++i)
+	{
+		CharStream stream(_source, _name);
+		Scanner scanner(stream);
+		for (; scanner.currentToken() != Token::EOS; scanner.next())
+		{
+			BOOST_REQUIRE(scanner.currentToken() != Token::Illegal);
+			++tokens;
+		}
+	}
+	double const duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	double const megabytes = double(_source.size() * repetitions) / (1024 * 1024);
+	BOOST_TEST_MESSAGE(
+		_name + ": " + std::to_string(megabytes / duration) + " MB/s, " +
+		std::to_string(tokens / repetitions) + " tokens"
+	);
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(ScannerBenchmark, *boost::unit_test::disabled())
+
+BOOST_AUTO_TEST_CASE(constant_table)
+{
+	benchmark("constant table", constantTable());
+}
+
+BOOST_AUTO_TEST_CASE(natspec_interface)
+{
+	benchmark("NatSpec interface", natSpecInterface());
+}
+
+BOOST_AUTO_TEST_CASE(hex_blobs)
+{
+	benchmark("hex blobs", hexBlobs());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
@@ -0,0 +1,315 @@
+/*
+ * Copyright (C) 2025 EverX. All Rights Reserved.
+ *
+ * Licensed under the  terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the  GNU General Public License for more details at: https://www.gnu.org/licenses/gpl-3.0.html
+ */
+/**
+ * Unit tests of the runs of characters that the scanner skips and copies in blocks
+ * of 16 (SSE2) or 32 (AVX2) characters.
+ */
+
+#include <liblangutil/CharacterRuns.h>
+#include <liblangutil/Common.h>
+#include <liblangutil/Scanner.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <functional>
+#include <memory>
+#include <string>
+
+using namespace std;
+using namespace solidity::langutil;
+
+namespace solidity::frontend::test
+{
+
+namespace
+{
+
+/// A class of characters: the function under test, the character-wise definition of the class,
+/// characters of the class that fill the runs and characters that end them.
+struct RunClass
+{
+	function<size_t(string_view)> run;
+	function<bool(char)> contains;
+	string members;
+	string stoppers;
+};
+
+/// Checks @a _class on runs of every length up to three blocks of 32 characters, at every
+/// alignment within a block of 4 characters and with every stopper at every position.
+/// The text ends exactly where the allocation ends, so that reads past it are caught by
+/// the address sanitizer.
+void checkRuns(RunClass const& _class)
+{
+	for (char c: _class.members)
+		BOOST_REQUIRE(_class.contains(c));
+	for (char c: _class.stoppers)
+		BOOST_REQUIRE(!_class.contains(c));
+
+	for (size_t length = 0; length <= 3 * 32 + 1; ++length)
+		for (size_t offset = 0; offset < 4; ++offset)
+		{
+			unique_ptr<char[]> buffer = make_unique<char[]>(offset + length);
+			char* text = buffer.get() + offset;
+			for (size_t i = 0; i < length; ++i)
+				text[i] = _class.members[i % _class.members.size()];
+			BOOST_REQUIRE_EQUAL(_class.run(string_view(text, length)), length);
+
+			for (size_t stop = 0; stop < length; ++stop)
+				for (char stopper: _class.stoppers)
+				{
+					char const member = text[stop];
+					text[stop] = stopper;
+					size_t const result = _class.run(string_view(text, length));
+					text[stop] = member;
+					if (result != stop)
+						BOOST_FAIL(
+							"run of length " + to_string(length) + " at offset " + to_string(offset) +
+							" stopped by byte " + to_string(static_cast<unsigned char>(stopper)) +
+							" at " + to_string(stop) + ": " + to_string(result)
+						);
+				}
+		}
+}
+
+/// Bytes that are not ASCII, including ones that become ASCII letters or digits if their
+/// high bit or the lower case bit are ignored.
+string const nonAscii = "\x80\xa0\xb0\xc1\xc3\xc6\xe1\xe2\xfa\xff";
+
+struct TestScanner
+{
+	unique_ptr<CharStream> stream;
+	unique_ptr<Scanner> scanner;
+	explicit TestScanner(string _text) { reset(std::move(_text)); }
+
+	void reset(string _text)
+	{
+		stream = make_unique<CharStream>(std::move(_text), "");
+		scanner = make_unique<Scanner>(*stream);
+	}
+
+	decltype(auto) currentToken() { return scanner->currentToken(); }
+	decltype(auto) next() { return scanner->next(); }
+	decltype(auto) currentError() { return scanner->currentError(); }
+	decltype(auto) currentLiteral() { return scanner->currentLiteral(); }
+	decltype(auto) currentCommentLiteral() { return scanner->currentCommentLiteral(); }
+	decltype(auto) currentLocation() { return scanner->currentLocation(); }
+};
+
+}
+
+BOOST_AUTO_TEST_SUITE(ScannerTest)
+
+BOOST_AUTO_TEST_CASE(white_space_runs)
+{
+	checkRuns({whiteSpaceRun, isWhiteSpace, " \t\n\r", "x\v\f\x01/" + nonAscii});
+}
+
+BOOST_AUTO_TEST_CASE(identifier_part_runs)
+{
+	checkRuns({identifierPartRun, isIdentifierPart, "azAZ_$09", " ./:@[`{\x7f" + nonAscii});
+}
+
+BOOST_AUTO_TEST_CASE(hex_digit_runs)
+{
+	checkRuns({hexDigitRun, isHexDigit, "09afAF", "gG/:@`_" + nonAscii});
+}
+
+BOOST_AUTO_TEST_CASE(plain_string_runs)
+{
+	auto const plain = [](char _quote) {
+		return [=](char _c) {
+			auto const c = static_cast<unsigned char>(_c);
+			return 0x20 <= c && c <= 0x7e && _c != _quote && _c != '\\';
+		};
+	};
+	checkRuns({
+		[](string_view _text) { return plainStringRun(_text, '"'); },
+		plain('"'),
+		"a '~ ",
+		"\"\\\n\x1f\x7f" + nonAscii
+	});
+	checkRuns({
+		[](string_view _text) { return plainStringRun(_text, '\''); },
+		plain('\''),
+		"a \"~ ",
+		"'\\\t\x7f" + nonAscii
+	});
+}
+
+BOOST_AUTO_TEST_CASE(ascii_line_runs)
+{
+	checkRuns({
+		asciiLineRun,
+		[](char _c) {
+			auto const c = static_cast<unsigned char>(_c);
+			return c < 0x80 && !(0x0a <= c && c <= 0x0d);
+		},
+		string("a\t *\x7f\x01\x00 ", 8),
+		"\n\v\f\r" + nonAscii
+	});
+}
+
+BOOST_AUTO_TEST_CASE(comment_text_runs)
+{
+	checkRuns({
+		commentTextRun,
+		[](char _c) { return _c != '*' && _c != '\n' && _c != '\r'; },
+		"a/ \t\xc3\xa9\xe2\x80\xae\v",
+		"*\n\r"
+	});
+}
+
+// The scanner skips and copies long runs of characters in blocks, so the following
+// tests use runs whose lengths are around the block sizes.
+
+BOOST_AUTO_TEST_CASE(long_identifiers)
+{
+	for (size_t length: {15, 16, 17, 31, 32, 33, 64, 100})
+	{
+		string name = "a" + string(length - 1, '_');
+		name.back() = '9';
+		TestScanner scanner(string(length, ' ') + name + "$x+" + name);
+		BOOST_CHECK_EQUAL(scanner.currentToken(), Token::Identifier);
+		BOOST_CHECK_EQUAL(scanner.currentLiteral(), name + "$x");
+		BOOST_CHECK_EQUAL(scanner.currentLocation().start, static_cast<int>(length));
+		BOOST_CHECK_EQUAL(scanner.next(), Token::Add);
+		BOOST_CHECK_EQUAL(scanner.next(), Token::Identifier);
+		BOOST_CHECK_EQUAL(scanner.currentLiteral(), name);
+		BOOST_CHECK_EQUAL(scanner.next(), Token::EOS);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(long_yul_identifiers_with_dots)
+{
+	string const part(33, 'x');
+	TestScanner scanner(part + "." + part + ".slot");
+	scanner.scanner->setScannerMode(ScannerKind::Yul);
+	BOOST_CHECK_EQUAL(scanner.currentToken(), Token::Identifier);
+	BOOST_CHECK_EQUAL(scanner.currentLiteral(), part + "." + part + ".slot");
+	BOOST_CHECK_EQUAL(scanner.next(), Token::EOS);
+}
+
+BOOST_AUTO_TEST_CASE(long_strings)
+{
+	for (size_t length: {15, 16, 17, 31, 32, 33, 64})
+	{
+		string const text(length, 'a');
+		TestScanner scanner("\"" + text + "'\\n" + text + "\"");
+		BOOST_CHECK_EQUAL(scanner.currentToken(), Token::StringLiteral);
+		BOOST_CHECK_EQUAL(scanner.currentLiteral(), text + "'\n" + text);
+		BOOST_CHECK_EQUAL(scanner.next(), Token::EOS);
+		scanner.reset("'" + text + "\"\\x41" + text + "\n'");
+		BOOST_CHECK_EQUAL(scanner.currentToken(), Token::Illegal);
+		BOOST_CHECK_EQUAL(scanner.currentError(), ScannerError::IllegalStringEndQuote);
+		scanner.reset("\"" + text + "\xc3\xa9\"");
+		BOOST_CHECK_EQUAL(scanner.currentToken(), Token::Illegal);
+		BOOST_CHECK_EQUAL(scanner.currentError(), ScannerError::UnicodeCharacterInNonUnicodeString);
+		scanner.reset("unicode\"" + text + "\xc3\xa9" + text + "\"");
+		BOOST_CHECK_EQUAL(scanner.currentToken(), Token::UnicodeStringLiteral);
+		BOOST_CHECK_EQUAL(scanner.currentLiteral(), text + "\xc3\xa9" + text);
+		scanner.reset("\"" + text);
+		BOOST_CHECK_EQUAL(scanner.currentToken(), Token::Illegal);
+		BOOST_CHECK_EQUAL(scanner.currentError(), ScannerError::IllegalStringEndQuote);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(long_hex_literals)
+{
+	for (size_t length: {15, 16, 17, 31, 32, 33, 64})
+	{
+		string digits;
+		for (size_t i = 0; i < length; ++i)
+			digits += "0123456789abcdefABCDEF"[i % 22];
+		TestScanner scanner("hex\"" + digits + "\"");
+		if (length % 2 == 0)
+		{
+			BOOST_CHECK_EQUAL(scanner.currentToken(), Token::HexStringLiteral);
+			BOOST_CHECK_EQUAL(scanner.currentLiteral().size(), length / 2);
+		}
+		else
+		{
+			BOOST_CHECK_EQUAL(scanner.currentToken(), Token::Illegal);
+			BOOST_CHECK_EQUAL(scanner.currentError(), ScannerError::IllegalHexString);
+		}
+		scanner.reset("hex'" + digits + digits + "_00'");
+		BOOST_CHECK_EQUAL(scanner.currentToken(), Token::HexStringLiteral);
+		BOOST_CHECK_EQUAL(scanner.currentLiteral().size(), length + 1);
+		scanner.reset("hex'" + digits + digits + "0g'");
+		BOOST_CHECK_EQUAL(scanner.currentToken(), Token::Illegal);
+		BOOST_CHECK_EQUAL(scanner.currentError(), ScannerError::IllegalHexString);
+		scanner.reset("hex'" + digits + digits + "\xc6" + "0'");
+		BOOST_CHECK_EQUAL(scanner.currentToken(), Token::Illegal);
+		BOOST_CHECK_EQUAL(scanner.currentError(), ScannerError::IllegalHexString);
+		scanner.reset("hex'" + digits + digits);
+		BOOST_CHECK_EQUAL(scanner.currentToken(), Token::Illegal);
+		BOOST_CHECK_EQUAL(scanner.currentError(), ScannerError::IllegalStringEndQuote);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(long_comments)
+{
+	for (size_t length: {15, 16, 17, 31, 32, 33, 64})
+	{
+		string const text(length, 'c');
+		TestScanner scanner("/*" + text + "*" + text + "**/ a // " + text + "\n b");
+		BOOST_CHECK_EQUAL(scanner.currentToken(), Token::Identifier);
+		BOOST_CHECK_EQUAL(scanner.currentLiteral(), "a");
+		BOOST_CHECK_EQUAL(scanner.next(), Token::Identifier);
+		BOOST_CHECK_EQUAL(scanner.currentLiteral(), "b");
+		BOOST_CHECK_EQUAL(scanner.next(), Token::EOS);
+		scanner.reset("/** " + text + "*" + text + "\n * " + text + "*/ a");
+		BOOST_CHECK_EQUAL(scanner.currentToken(), Token::Identifier);
+		BOOST_CHECK_EQUAL(scanner.currentCommentLiteral(), text + "*" + text + "\n " + text);
+		scanner.reset("/// " + text + "\xc2\x85" + "/// " + text + "\n a");
+		BOOST_CHECK_EQUAL(scanner.currentToken(), Token::Illegal);
+		scanner.reset("/// " + text + "\n/// " + text + "\n a");
+		BOOST_CHECK_EQUAL(scanner.currentToken(), Token::Identifier);
+		BOOST_CHECK_EQUAL(scanner.currentCommentLiteral(), text + "\n " + text);
+		scanner.reset("a // " + text + "\xc3\xa9" + text);
+		BOOST_CHECK_EQUAL(scanner.currentToken(), Token::Identifier);
+		BOOST_CHECK_EQUAL(scanner.next(), Token::EOS);
+		scanner.reset("a /* " + text);
+		BOOST_CHECK_EQUAL(scanner.currentToken(), Token::Identifier);
+		BOOST_CHECK_EQUAL(scanner.next(), Token::Illegal);
+		BOOST_CHECK_EQUAL(scanner.currentError(), ScannerError::IllegalCommentTerminator);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(multiline_comments_ending_in_slashes)
+{
+	TestScanner scanner("/*/*/ a /***/ b");
+	BOOST_CHECK_EQUAL(scanner.currentToken(), Token::Identifier);
+	BOOST_CHECK_EQUAL(scanner.currentLiteral(), "a");
+	BOOST_CHECK_EQUAL(scanner.next(), Token::Identifier);
+	BOOST_CHECK_EQUAL(scanner.currentLiteral(), "b");
+	BOOST_CHECK_EQUAL(scanner.next(), Token::EOS);
+}
+
+BOOST_AUTO_TEST_CASE(directional_override_in_long_comments)
+{
+	string const text(40, 'c');
+	string const override = "\xe2\x80\xae";
+	string const pop = "\xe2\x80\xac";
+	TestScanner scanner("/*" + text + override + text + "*/ a");
+	BOOST_CHECK_EQUAL(scanner.currentToken(), Token::Illegal);
+	BOOST_CHECK_EQUAL(scanner.currentError(), ScannerError::DirectionalOverrideMismatch);
+	scanner.reset("/*" + text + override + text + pop + "*/ a");
+	BOOST_CHECK_EQUAL(scanner.currentToken(), Token::Identifier);
+	scanner.reset("// " + text + pop + text + "\n a");
+	BOOST_CHECK_EQUAL(scanner.currentToken(), Token::Illegal);
+	BOOST_CHECK_EQUAL(scanner.currentError(), ScannerError::DirectionalOverrideUnderflow);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2025 EverX. All Rights Reserved.
+ *
+ * Licensed under the  terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the  GNU General Public License for more details at: https://www.gnu.org/licenses/gpl-3.0.html
+ */
+/**
+ * Unit tests for the interpreter of TvmAst: exit codes, the resulting stack and the gas of simple
+ * code blocks.
+ */
+
+#include <libsolidity/codegen/TVM.hpp>
+#include <libsolidity/codegen/TVMInterpreter.hpp>
+#include <libsolidity/codegen/TvmAst.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace solidity::frontend::test
+{
+
+namespace
+{
+
+struct InterpreterFixture
+{
+	InterpreterFixture() { GlobalParams::g_tvmVersion = langutil::TVMVersion{}; }
+
+	static Pointer<CodeBlock> block(vector<Pointer<TvmAstNode>> const& _code, CodeBlock::Type _type = CodeBlock::Type::None)
+	{
+		return createNode<CodeBlock>(_type, _code);
+	}
+
+	static TVMRunResult run(Pointer<CodeBlock> const& _block, vector<VmValue> _stack = {}, int64_t _gasLimit = 1'000'000)
+	{
+		return TVMInterpreter{nullptr, _gasLimit}.run(*_block, {move(_stack), nullptr, TVMInterpreter::defaultC7()});
+	}
+
+	static vector<VmValue> ints(vector<int> const& _values)
+	{
+		vector<VmValue> stack;
+		for (int value: _values)
+			stack.emplace_back(bigint(value));
+		return stack;
+	}
+};
+
+}
+
+BOOST_FIXTURE_TEST_SUITE(TVMInterpreterTest, InterpreterFixture)
+
+BOOST_AUTO_TEST_CASE(arithmetic)
+{
+	TVMRunResult const result = run(block({gen("PUSHINT 2"), gen("PUSHINT 3"), gen("ADD"), gen("PUSHINT 4"), gen("MUL")}));
+	BOOST_CHECK_EQUAL(result.exitCode, 0);
+	BOOST_CHECK(result.state.stack == ints({20}));
+	// Five one-byte instructions of 18 gas and the implicit RET.
+	BOOST_CHECK_EQUAL(result.gasUsed, 5 * 18 + 5);
+}
+
+BOOST_AUTO_TEST_CASE(stack_manipulation)
+{
+	TVMRunResult const result = run(block({makeXCH_S(1), makeDROP(1), makePUSH(0)}), ints({1, 2, 3}));
+	BOOST_CHECK_EQUAL(result.exitCode, 0);
+	BOOST_CHECK(result.state.stack == ints({1, 3, 3}));
+	BOOST_CHECK_EQUAL(result.gasUsed, 3 * 18 + 5);
+}
+
+BOOST_AUTO_TEST_CASE(if_else)
+{
+	auto const code = block({createNode<TvmIfElse>(
+		false,
+		false,
+		block({gen("PUSHINT 10")}, CodeBlock::Type::PUSHCONT),
+		block({gen("PUSHINT 20")}, CodeBlock::Type::PUSHCONT),
+		1
+	)});
+	TVMRunResult const taken = run(code, ints({-1}));
+	BOOST_CHECK_EQUAL(taken.exitCode, 0);
+	BOOST_CHECK(taken.state.stack == ints({10}));
+	TVMRunResult const notTaken = run(code, ints({0}));
+	BOOST_CHECK_EQUAL(notTaken.exitCode, 0);
+	BOOST_CHECK(notTaken.state.stack == ints({20}));
+	// PUSHINT 20 does not fit into the one-byte form.
+	BOOST_CHECK_EQUAL(notTaken.gasUsed, taken.gasUsed + 8);
+}
+
+BOOST_AUTO_TEST_CASE(repeat)
+{
+	auto const code = [](string const& _count) {
+		return block({gen("PUSHINT " + _count), createNode<TvmRepeat>(false, block({gen("INC")}, CodeBlock::Type::PUSHCONT))});
+	};
+	TVMRunResult const once = run(code("1"), ints({0}));
+	BOOST_CHECK_EQUAL(once.exitCode, 0);
+	BOOST_CHECK(once.state.stack == ints({1}));
+	TVMRunResult const thrice = run(code("3"), ints({0}));
+	BOOST_CHECK_EQUAL(thrice.exitCode, 0);
+	BOOST_CHECK(thrice.state.stack == ints({3}));
+	// Each iteration runs INC and the implicit RET of the body.
+	BOOST_CHECK_EQUAL(thrice.gasUsed, once.gasUsed + 2 * (18 + 5));
+}
+
+BOOST_AUTO_TEST_CASE(retalt)
+{
+	TVMRunResult const result = run(block({gen("PUSHINT 1"), makeRETALT(), gen("PUSHINT 2")}));
+	BOOST_CHECK_EQUAL(result.exitCode, 1);
+	BOOST_CHECK(result.state.stack == ints({1}));
+}
+
+BOOST_AUTO_TEST_CASE(throw_exception)
+{
+	TVMRunResult const result = run(block({gen("PUSHINT 1"), makeTHROW("THROW 100"), gen("PUSHINT 2")}));
+	BOOST_CHECK_EQUAL(result.exitCode, 100);
+	// TVM leaves the argument and the exit code of the exception on the stack.
+	BOOST_CHECK(result.state.stack == ints({0, 100}));
+
+	TVMRunResult const notThrown = run(block({makeTHROW("THROWIF 101"), gen("PUSHINT 2")}), ints({0}));
+	BOOST_CHECK_EQUAL(notThrown.exitCode, 0);
+	BOOST_CHECK(notThrown.state.stack == ints({2}));
+}
+
+BOOST_AUTO_TEST_CASE(stack_underflow)
+{
+	TVMRunResult const result = run(block({gen("PUSHINT 1"), gen("ADD")}));
+	BOOST_CHECK_EQUAL(result.exitCode, 2);
+}
+
+BOOST_AUTO_TEST_CASE(integer_overflow)
+{
+	vector<VmValue> const stack{bigint((bigint(1) << 256) - 1)};
+	TVMRunResult const overflow = run(block({gen("INC")}), stack);
+	BOOST_CHECK_EQUAL(overflow.exitCode, 4);
+	TVMRunResult const fits = run(block({gen("DEC")}), stack);
+	BOOST_CHECK_EQUAL(fits.exitCode, 0);
+	BOOST_CHECK(fits.state.stack == vector<VmValue>{bigint((bigint(1) << 256) - 2)});
+}
+
+BOOST_AUTO_TEST_CASE(out_of_gas)
+{
+	auto const code = block({gen("PUSHINT 2"), gen("PUSHINT 3"), gen("ADD"), gen("PUSHINT 4"), gen("MUL")});
+	TVMRunResult const enough = run(code, {}, 5 * 18 + 5);
+	BOOST_CHECK_EQUAL(enough.exitCode, 0);
+	TVMRunResult const result = run(code, {}, 3 * 18);
+	BOOST_CHECK_EQUAL(result.exitCode, -14);
+	BOOST_CHECK_EQUAL(result.gasUsed, 3 * 18);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
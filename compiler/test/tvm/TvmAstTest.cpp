@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2025 EverX. All Rights Reserved.
+ *
+ * Licensed under the  terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the  GNU General Public License for more details at: https://www.gnu.org/licenses/gpl-3.0.html
+ */
+/**
+ * Unit tests of the structural comparison and the cached hashes of the nodes of the TVM code tree.
+ */
+
+#include <libsolidity/codegen/TvmAst.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace solidity::frontend::test
+{
+
+namespace
+{
+
+Pointer<CodeBlock> body(vector<string> const& _instructions)
+{
+	vector<Pointer<TvmAstNode>> instructions;
+	for (string const& instruction: _instructions)
+		instructions.push_back(gen(instruction));
+	return createNode<CodeBlock>(CodeBlock::Type::PUSHCONT, instructions);
+}
+
+/// @returns if (...) { INC } else { <_falseBody> }, nested in the true body of another if/else,
+/// so that the nodes differ only deep in their else branches.
+Pointer<TvmIfElse> ifElse(vector<string> const& _falseBody)
+{
+	auto const inner = createNode<TvmIfElse>(false, false, body({"INC"}), body(_falseBody), 0);
+	return createNode<TvmIfElse>(
+		false,
+		false,
+		createNode<CodeBlock>(CodeBlock::Type::PUSHCONT, vector<Pointer<TvmAstNode>>{inner}),
+		body({"DEC"}),
+		0
+	);
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(TvmAstTest)
+
+BOOST_AUTO_TEST_CASE(if_else_compares_false_bodies)
+{
+	Pointer<TvmIfElse> const node = ifElse({"NEGATE"});
+	BOOST_CHECK(*node == *ifElse({"NEGATE"}));
+	BOOST_CHECK_EQUAL(node->hash(), ifElse({"NEGATE"})->hash());
+	BOOST_CHECK(!(*node == *ifElse({"NOT"})));
+	BOOST_CHECK(!(*node == *ifElse({"NEGATE", "NEGATE"})));
+	BOOST_CHECK_NE(node->hash(), ifElse({"NOT"})->hash());
+
+	auto const withoutElse = createNode<TvmIfElse>(false, false, body({"INC"}), nullptr, 0);
+	auto const withElse = createNode<TvmIfElse>(false, false, body({"INC"}), body({}), 0);
+	BOOST_CHECK(!(*withoutElse == *withElse));
+	BOOST_CHECK(!(*withElse == *withoutElse));
+}
+
+BOOST_AUTO_TEST_CASE(cached_hashes_follow_changes)
+{
+	Pointer<TvmIfElse> const node = ifElse({"NEGATE"});
+	Pointer<TvmIfElse> const other = ifElse({"NEGATE"});
+	BOOST_REQUIRE_EQUAL(node->hash(), other->hash());
+
+	// The changed block is nested two levels below the node whose hash was cached.
+	TvmIfElse const& inner = cast<TvmIfElse>(*other->trueBody()->instructions().front());
+	inner.falseBody()->upd({gen("NOT")});
+	BOOST_CHECK(!(*node == *other));
+	BOOST_CHECK(*other == *ifElse({"NOT"}));
+	BOOST_CHECK_EQUAL(other->hash(), ifElse({"NOT"})->hash());
+}
+
+BOOST_AUTO_TEST_CASE(table_interns_equal_nodes)
+{
+	TvmAstNodeTable table;
+	Pointer<TvmAstNode> const node = ifElse({"NEGATE"});
+	BOOST_CHECK(table.intern(node) == node);
+	BOOST_CHECK(table.intern(ifElse({"NEGATE"})) == node);
+	BOOST_CHECK(table.intern(ifElse({"NOT"})) != node);
+	BOOST_CHECK_EQUAL(table.size(), 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2025 EverX. All Rights Reserved.
+ *
+ * Licensed under the  terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License.
+ *
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the  GNU General Public License for more details at: https://www.gnu.org/licenses/gpl-3.0.html
+ */
+/**
+ * Benchmark of the TVM peephole optimizer: runs it on synthetic blocks of instructions and reports
+ * the throughput of the driver and of the matchers of the rules.
+ */
+
+#include <libsolidity/codegen/PeepholeOptimizer.hpp>
+#include <libsolidity/codegen/TVM.hpp>
+#include <libsolidity/codegen/TvmAst.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace solidity;
+using namespace solidity::frontend;
+
+namespace po = boost::program_options;
+
+namespace
+{
+
+/// Generates blocks that mix the patterns the rules rewrite with instructions they leave alone.
+class BlockGenerator
+{
+public:
+	explicit BlockGenerator(unsigned _seed): m_random{_seed} {}
+
+	vector<Pointer<TvmAstNode>> generate(size_t _size)
+	{
+		vector<function<vector<Pointer<TvmAstNode>>()>> const snippets{
+			[&]{ return vector<Pointer<TvmAstNode>>{gen("PUSHINT " + to_string(number(100))), gen("ADD")}; },
+			[&]{ return vector<Pointer<TvmAstNode>>{makeBLKSWAP(1, 1), gen("SUB")}; },
+			[&]{ return vector<Pointer<TvmAstNode>>{makePUSH(number(4)), makeDROP()}; },
+			[&]{ return vector<Pointer<TvmAstNode>>{gen("TRUE"), gen("NOT")}; },
+			[&]{ return vector<Pointer<TvmAstNode>>{gen("EQUAL"), gen("NOT")}; },
+			[&]{ return vector<Pointer<TvmAstNode>>{gen("PUSHINT 8"), gen("MUL")}; },
+			[&]{ return vector<Pointer<TvmAstNode>>{makePUSH(0), makeBLKDROP2(2, 1)}; },
+			[&]{ return vector<Pointer<TvmAstNode>>{gen("NEWC"), gen("STU 32"), gen("ENDC")}; },
+			[&]{ return vector<Pointer<TvmAstNode>>{gen("LDU 64"), makeDROP()}; },
+			[&]{ return vector<Pointer<TvmAstNode>>{makePUSH(number(6))}; },
+			[&]{ return vector<Pointer<TvmAstNode>>{makeXCH_S(1 + number(5))}; },
+			[&]{ return vector<Pointer<TvmAstNode>>{makeGetGlob(10 + number(5))}; },
+			[&]{ return vector<Pointer<TvmAstNode>>{makeSetGlob(10 + number(5))}; },
+			[&]{ return vector<Pointer<TvmAstNode>>{gen("ADD")}; },
+			[&]{ return vector<Pointer<TvmAstNode>>{gen("CTOS")}; },
+			[&]{ return vector<Pointer<TvmAstNode>>{gen("HASHCU")}; },
+			[&]{ return vector<Pointer<TvmAstNode>>{gen("STU 256")}; },
+		};
+		vector<Pointer<TvmAstNode>> block;
+		while (block.size() < _size)
+			for (Pointer<TvmAstNode> const& node: snippets.at(number(snippets.size()))())
+				block.push_back(node);
+		block.resize(_size);
+		return block;
+	}
+
+private:
+	size_t number(size_t _bound) { return uniform_int_distribution<size_t>{0, _bound - 1}(m_random); }
+
+	mt19937 m_random;
+};
+
+}
+
+int main(int argc, char** argv)
+{
+	size_t instructions = 20000;
+	size_t blocks = 5;
+	unsigned seed = 1;
+	po::options_description options(
+		R"(tvm_peephole_bench, benchmark of the TVM peephole optimizer.
+	Usage: tvm_peephole_bench [Options]
+	Runs the peephole optimizer on synthetic blocks and prints the number of
+	instructions it processes per second and the time spent in each matcher.
+
+	Allowed options)",
+		po::options_description::m_default_line_length,
+		po::options_description::m_default_line_length - 23);
+	options.add_options()
+		("instructions", po::value<size_t>(&instructions)->default_value(instructions), "instructions in a block")
+		("blocks", po::value<size_t>(&blocks)->default_value(blocks), "number of blocks")
+		("seed", po::value<unsigned>(&seed)->default_value(seed), "seed of the generator")
+		("help,h", "Show this help screen.");
+
+	po::variables_map arguments;
+	po::store(po::parse_command_line(argc, argv, options), arguments);
+	po::notify(arguments);
+	if (arguments.count("help"))
+	{
+		cout << options;
+		return 0;
+	}
+
+	GlobalParams::g_tvmVersion = langutil::TVMVersion{};
+	BlockGenerator generator{seed};
+	vector<Pointer<CodeBlock>> codeBlocks;
+	for (size_t i = 0; i < blocks; ++i)
+		codeBlocks.push_back(createNode<CodeBlock>(CodeBlock::Type::None, generator.generate(instructions)));
+
+	// the first run builds the tables of StackOpcodeSquasher, keep it out of the measurement
+	{
+		PeepholeOptimizer optimizer{{}};
+		createNode<CodeBlock>(CodeBlock::Type::None, BlockGenerator{seed}.generate(1000))->accept(optimizer);
+	}
+
+	PeepholeStats stats;
+	auto const start = chrono::steady_clock::now();
+	for (Pointer<CodeBlock> const& block: codeBlocks)
+	{
+		PeepholeOptimizer optimizer{{}, &stats};
+		block->accept(optimizer);
+	}
+	double const seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	size_t left = 0;
+	for (Pointer<CodeBlock> const& block: codeBlocks)
+		left += block->instructions().size();
+	cout << "Instructions: " << instructions * blocks << " -> " << left << endl;
+	cout << "Time: " << seconds << " s, " << static_cast<int64_t>(instructions * blocks / seconds) << " instructions/s" << endl;
+
+	Json::Value const matchers = stats.toJson()["matchers"];
+	for (string const& name: matchers.getMemberNames())
+	{
+		Json::Value const& matcher = matchers[name];
+		int64_t const calls = matcher["calls"].asInt64();
+		int64_t const timeUs = matcher["timeUs"].asInt64();
+		cout << name << ": " << calls << " calls, " << matcher["matches"].asInt64() << " matches, " << timeUs << " us";
+		if (timeUs > 0)
+			cout << ", " << calls * 1'000'000 / timeUs << " calls/s";
+		cout << endl;
+	}
+	return 0;
+}
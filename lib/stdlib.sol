@@ -414,21 +414,51 @@ contract stdlib {
         return __makeString(st);
     }
 
+    // Returns a mask that has the highest bit set in every zero byte of `w`. `w` is a word of `256 - shift` bits.
+    // Bytes are tested all at once, so string search doesn't have to load data byte by byte.
+    function __zeroBytesMask(uint w, uint9 shift) private pure inline returns (uint) {
+        uint low7 = 0x7f7f7f7f7f7f7f7f7f7f7f7f7f7f7f7f7f7f7f7f7f7f7f7f7f7f7f7f7f7f7f7f >> shift;
+        uint high1 = 0x8080808080808080808080808080808080808080808080808080808080808080 >> shift;
+        return ((((w & low7) + low7) | w) & high1) ^ high1;
+    }
+
     function __strchr(bytes str, bytes1 char) private pure returns (optional(uint32) res) {
-        uint32 i = 0;
-        for (bytes1 b : str) {
-            if (b == char)
-                return i;
-            ++i;
+        uint pattern = uint8(char) * 0x0101010101010101010101010101010101010101010101010101010101010101;
+        uint32 offset = 0;
+        TvmSlice s = str.toSlice();
+        while (true) {
+            if (s.bitEmpty()) {
+                if (s.refEmpty())
+                    return null;
+                s = s.loadRefAsSlice();
+                continue;
+            }
+            uint9 n = uint9(math.min(s.bits(), 256));
+            uint9 shift = 256 - n;
+            uint mask = __zeroBytesMask(s.loadUint(n) ^ (pattern >> shift), shift);
+            if (mask != 0)
+                return offset + (n - uBitSize(mask)) / 8;
+            offset += n / 8;
         }
     }
 
     function __strrchr(bytes str, bytes1 char) private pure returns (optional(uint32) res) {
-        uint32 i = 0;
-        for (bytes1 b : str) {
-            if (b == char)
-                res.set(i);
-            ++i;
+        uint pattern = uint8(char) * 0x0101010101010101010101010101010101010101010101010101010101010101;
+        uint32 offset = 0;
+        TvmSlice s = str.toSlice();
+        while (true) {
+            if (s.bitEmpty()) {
+                if (s.refEmpty())
+                    return res;
+                s = s.loadRefAsSlice();
+                continue;
+            }
+            uint9 n = uint9(math.min(s.bits(), 256));
+            uint9 shift = 256 - n;
+            uint mask = __zeroBytesMask(s.loadUint(n) ^ (pattern >> shift), shift);
+            offset += n / 8;
+            if (mask != 0)
+                res = offset - uBitSize(mask & uint(-int(mask))) / 8;
         }
     }
 
@@ -461,17 +491,36 @@ contract stdlib {
     function __strstr(TvmCell _str, TvmCell _substr) private pure returns (optional(uint32)) {
         TvmSlice str = _str.toSlice();
         TvmSlice substr = _substr.toSlice();
-        for (uint32 pos = 0; ; ) {
+        if (substr.empty())
+            return 0;
+        if (substr.bitEmpty())
+            substr = substr.loadRefAsSlice();
+        // skip to the next occurrence of the first byte of `substr` and only there compare whole strings
+        uint pattern = substr.preload(uint8) * 0x0101010101010101010101010101010101010101010101010101010101010101;
+        uint32 pos = 0;
+        while (true) {
+            if (str.bitEmpty()) {
+                if (str.refEmpty())
+                    return null;
+                str = str.loadRefAsSlice();
+                continue;
+            }
+            uint9 n = uint9(math.min(str.bits(), 256));
+            uint9 shift = 256 - n;
+            uint mask = __zeroBytesMask(str.preloadUint(n) ^ (pattern >> shift), shift);
+            if (mask == 0) {
+                str.skip(n);
+                pos += n / 8;
+                continue;
+            }
+            uint16 skip = n - uBitSize(mask);
+            str.skip(skip);
+            pos += skip / 8;
             if (__isPrefix(str, substr))
                 return pos;
-            if (str.empty())
-                break;
-            if (str.bits() == 0)
-                str = str.loadRefAsSlice();
-            str.load(uint8);
+            str.skip(8);
             ++pos;
         }
-        return null;
     }
 
     // <string>.toLowerCase()
@@ -286,6 +286,44 @@ pub type CStyleReadFileCallback = ::std::option::Option<
         o_error: *mut *mut ::std::os::raw::c_char,
     ),
 >;
+#[doc = " Callback used to pass on the AST of a source file while it is being written."]
+#[doc = ""]
+#[doc = " @param _context The astContext passed to solidity_compile_with_ast_callback. Can be NULL."]
+#[doc = " @param _sourceName The name of the source unit the AST belongs to."]
+#[doc = " @param _data The next part of the AST of the source unit in the compact JSON format. It is not zero-terminated."]
+#[doc = " @param _size The size of @p _data in bytes."]
+#[doc = ""]
+#[doc = " All parts of the AST of a source unit are passed one after another. The memory of @p _data"]
+#[doc = " is owned by the compiler and is only valid during the call."]
+pub type CStyleASTCallback = ::std::option::Option<
+    unsafe extern "C" fn(
+        _context: *mut ::std::os::raw::c_void,
+        _sourceName: *const ::std::os::raw::c_char,
+        _data: *const ::std::os::raw::c_char,
+        _size: size_t,
+    ),
+>;
+#[doc = " Callback used to pass on an artifact of a contract or the AST of a source file."]
+#[doc = ""]
+#[doc = " @param _context The artifactContext passed to solidity_compile_with_artifact_callback. Can be NULL."]
+#[doc = " @param _sourceName The name of the source unit the artifact belongs to."]
+#[doc = " @param _contractName The name of the contract the artifact belongs to. Empty for the AST."]
+#[doc = " @param _artifact The kind of the artifact: \"assembly\" (text), \"abi\", \"functionIds\","]
+#[doc = "                  \"privateFunctionIds\" or \"ast\" (compact JSON)."]
+#[doc = " @param _data The artifact or, for the AST, the next part of it. It is not zero-terminated."]
+#[doc = " @param _size The size of @p _data in bytes."]
+#[doc = ""]
+#[doc = " The memory of @p _data is owned by the compiler and is only valid during the call."]
+pub type CStyleArtifactCallback = ::std::option::Option<
+    unsafe extern "C" fn(
+        _context: *mut ::std::os::raw::c_void,
+        _sourceName: *const ::std::os::raw::c_char,
+        _contractName: *const ::std::os::raw::c_char,
+        _artifact: *const ::std::os::raw::c_char,
+        _data: *const ::std::os::raw::c_char,
+        _size: size_t,
+    ),
+>;
 extern "C" {
     #[doc = " Returns the complete license document."]
     #[doc = ""]
@@ -333,6 +371,39 @@ extern "C" {
         _readContext: *mut ::std::os::raw::c_void,
     ) -> *mut ::std::os::raw::c_char;
 }
+extern "C" {
+    #[doc = " Same as solidity_compile(), but the ASTs requested in the output selection are passed to"]
+    #[doc = " @p _astCallback while the syntax tree is walked instead of being included in the output."]
+    #[doc = " This avoids building the JSON of large syntax trees in memory."]
+    #[doc = ""]
+    #[doc = " @param _astCallback The callback that receives the ASTs. Can be NULL, in which case the ASTs"]
+    #[doc = "                     are included in the output like by solidity_compile()."]
+    #[doc = " @param _astContext An optional context pointer passed to _astCallback. Can be NULL."]
+    pub fn solidity_compile_with_ast_callback(
+        _input: *const ::std::os::raw::c_char,
+        _readCallback: CStyleReadFileCallback,
+        _readContext: *mut ::std::os::raw::c_void,
+        _astCallback: CStyleASTCallback,
+        _astContext: *mut ::std::os::raw::c_void,
+    ) -> *mut ::std::os::raw::c_char;
+}
+extern "C" {
+    #[doc = " Same as solidity_compile(), but the assembly, the ABI and the function ids of the contracts and"]
+    #[doc = " the ASTs requested in the output selection are passed to @p _artifactCallback one by one instead"]
+    #[doc = " of being included in the output. They are neither escaped nor copied into the output JSON,"]
+    #[doc = " which still contains the errors and all other artifacts."]
+    #[doc = ""]
+    #[doc = " @param _artifactCallback The callback that receives the artifacts. Can be NULL, in which case"]
+    #[doc = "                          the result is the same as that of solidity_compile()."]
+    #[doc = " @param _artifactContext An optional context pointer passed to _artifactCallback. Can be NULL."]
+    pub fn solidity_compile_with_artifact_callback(
+        _input: *const ::std::os::raw::c_char,
+        _readCallback: CStyleReadFileCallback,
+        _readContext: *mut ::std::os::raw::c_void,
+        _artifactCallback: CStyleArtifactCallback,
+        _artifactContext: *mut ::std::os::raw::c_void,
+    ) -> *mut ::std::os::raw::c_char;
+}
 extern "C" {
     #[doc = " Frees up any allocated memory."]
     #[doc = ""]
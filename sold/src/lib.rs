@@ -1,3 +1,5 @@
+use std::collections::HashMap;
+use std::ffi::CStr;
 use std::fmt;
 use std::fs::File;
 use std::io::Write;
@@ -6,13 +8,13 @@ use std::path::Path;
 
 use clap::{Parser, ValueEnum};
 use failure::{bail, format_err};
-use serde::Deserialize;
 
 use tvm_assembler::{DbgInfo, Engine, Units};
 use tvm_types::{Result, Status};
 
 mod libsolc;
 mod printer;
+mod size_report;
 
 unsafe extern "C" fn read_callback(
     context: *mut c_void,
@@ -37,6 +39,61 @@ unsafe extern "C" fn read_callback(
     }
 }
 
+/// Artifacts passed on by the compiler instead of being embedded in its output
+#[derive(Default)]
+struct Artifacts {
+    ast: Vec<u8>,
+    /// Artifacts of each contract by source unit name and contract name
+    contracts: HashMap<(String, String), HashMap<String, Vec<u8>>>,
+}
+
+impl Artifacts {
+    fn get(&self, source_unit_name: &str, contract: &str, artifact: &str) -> Option<&[u8]> {
+        self.contracts
+            .get(&(source_unit_name.to_owned(), contract.to_owned()))
+            .and_then(|artifacts| artifacts.get(artifact))
+            .map(Vec::as_slice)
+    }
+
+    fn get_json(
+        &self,
+        source_unit_name: &str,
+        contract: &str,
+        artifact: &str,
+    ) -> Result<serde_json::Value> {
+        match self.get(source_unit_name, contract, artifact) {
+            Some(json) => Ok(serde_json::from_slice(json)?),
+            None => Ok(serde_json::Value::Null),
+        }
+    }
+}
+
+unsafe extern "C" fn artifact_callback(
+    context: *mut c_void,
+    source_name: *const c_char,
+    contract_name: *const c_char,
+    artifact: *const c_char,
+    data: *const c_char,
+    size: libsolc::size_t,
+) {
+    let artifacts = &mut *(context as *mut Artifacts);
+    let data = std::slice::from_raw_parts(data as *const u8, size as usize);
+    let artifact = CStr::from_ptr(artifact).to_string_lossy().into_owned();
+    if artifact == "ast" {
+        artifacts.ast.extend_from_slice(data);
+        return;
+    }
+    let source_name = CStr::from_ptr(source_name).to_string_lossy().into_owned();
+    let contract_name = CStr::from_ptr(contract_name).to_string_lossy().into_owned();
+    artifacts
+        .contracts
+        .entry((source_name, contract_name))
+        .or_default()
+        .entry(artifact)
+        .or_default()
+        .extend_from_slice(data);
+}
+
 unsafe fn make_error(msg: String) -> *mut c_char {
     let ptr = libsolc::solidity_alloc(msg.len() as u64);
     std::ptr::copy(msg.as_ptr(), ptr as *mut u8, msg.len());
@@ -59,7 +116,7 @@ fn compile(
     args: &Args,
     input: &str,
     remappings: Vec<String>,
-) -> Result<(String, serde_json::Value)> {
+) -> Result<(String, serde_json::Value, Artifacts)> {
     let file_reader = unsafe {
         let file_reader = libsolc::file_reader_new();
         if let Some(base_path) = args.base_path.clone() {
@@ -109,6 +166,21 @@ fn compile(
     } else {
         ", \"assembly\""
     };
+    let code_metrics = if args.code_metrics {
+        ", \"codeMetrics\""
+    } else {
+        ""
+    };
+    let gas_estimates = if args.gas_report {
+        ", \"gasEstimates\""
+    } else {
+        ""
+    };
+    let optimizer_stats = if args.optimizer_stats {
+        ", \"optimizerStats\""
+    } else {
+        ""
+    };
     let doc = if args.userdoc || args.devdoc {
         ", \"userdoc\", \"devdoc\""
     } else {
@@ -120,6 +192,27 @@ fn compile(
             format!(r#""tvmVersion": "{}","#, version)
         }
     };
+    let analysis_threads = match args.analysis_threads {
+        None => "".to_string(),
+        Some(threads) => {
+            format!(r#""analysisThreads": {},"#, threads)
+        }
+    };
+    let analyze_reachable_only = if args.analyze_reachable_only {
+        r#""analyzeReachableOnly": true,"#
+    } else {
+        ""
+    };
+    let ast_arena = if args.ast_arena {
+        r#""astArena": true,"#
+    } else {
+        ""
+    };
+    let ast = if args.ast_compact_json {
+        r#", "": [ "ast" ]"#
+    } else {
+        ""
+    };
     let main_contract = args.contract.clone().unwrap_or_default();
     let remappings = remappings_to_json_string(remappings);
     let input_json = format!(
@@ -128,12 +221,14 @@ fn compile(
             "language": "Solidity",
             "settings": {{
                 {tvm_version}
+                {analysis_threads}
+                {analyze_reachable_only}
+                {ast_arena}
                 "mainContract": "{main_contract}",
                 "remappings": {remappings},
                 "outputSelection": {{
                     "{source_unit_name}": {{
-                        "*": [ "abi"{assembly}{show_function_ids}{show_private_function_ids}{doc} ],
-                        "": [ "ast" ]
+                        "*": [ "abi"{assembly}{show_function_ids}{show_private_function_ids}{code_metrics}{gas_estimates}{optimizer_stats}{doc} ]{ast}
                     }}
                 }}
             }},
@@ -145,19 +240,22 @@ fn compile(
         }}
     "#
     );
+    // The AST, the assembly, the ABI and the function ids are passed on as they are instead
+    // of being embedded in the output
+    let mut artifacts = Artifacts::default();
     let output = unsafe {
-        std::ffi::CStr::from_ptr(libsolc::solidity_compile(
+        std::ffi::CStr::from_ptr(libsolc::solidity_compile_with_artifact_callback(
             to_cstr(&input_json)?.as_ptr(),
             Some(read_callback),
             file_reader,
+            Some(artifact_callback),
+            &mut artifacts as *mut Artifacts as *mut c_void,
         ))
         .to_string_lossy()
         .into_owned()
     };
-    let mut de = serde_json::Deserializer::from_str(&output);
-    de.disable_recursion_limit(); // ast json part might be considerably nested
-    let res = serde_json::Value::deserialize(&mut de)?;
-    Ok((source_unit_name.clone(), res))
+    let res = serde_json::from_str(&output)?;
+    Ok((source_unit_name.clone(), res, artifacts))
 }
 
 fn remappings_to_json_string(remappings: Vec<String>) -> String {
@@ -181,12 +279,14 @@ macro_rules! parse_error {
 
 pub static ERROR_MSG_NO_OUTPUT: &str = "Compiler run successful, no output requested.";
 
+/// Returns the name of the selected contract
 fn parse_comp_result(
     res: &serde_json::Value,
+    artifacts: &Artifacts,
     source_unit_name: &str,
     contract: Option<String>,
     compile: bool,
-) -> Result<serde_json::Value> {
+) -> Result<String> {
     let res = res.as_object().ok_or_else(|| parse_error!())?;
     // println!("{}", serde_json::to_string_pretty(&res)?);
 
@@ -238,30 +338,19 @@ fn parse_comp_result(
                 contract
             ))
         } else {
-            Ok(all.get(contract).unwrap().clone())
+            Ok(contract.clone())
         }
     } else {
-        let mut iter = all.iter().filter(|(_, v)| {
-            if !compile {
-                true
-            } else if let Some(v) = v.as_object() {
-                let assembly = v.get("assembly");
-                if let Some(assembly) = assembly {
-                    !assembly.is_null()
-                } else {
-                    false
-                }
-            } else {
-                false
-            }
-        });
+        let mut iter = all
+            .keys()
+            .filter(|name| !compile || artifacts.get(source_unit_name, name, "assembly").is_some());
         let qualification = if compile { "deployable " } else { "" };
         let entry = iter.next();
         if let Some(entry) = entry {
             if iter.next().is_some() {
                 Err(format_err!("Source file contains at least two {}contracts. Consider adding the option --contract in compiler command line to select the desired contract", qualification))
             } else {
-                Ok(entry.1.clone())
+                Ok(entry.clone())
             }
         } else {
             Err(format_err!("{}", ERROR_MSG_NO_OUTPUT))
@@ -313,24 +402,45 @@ pub fn build(args: Args) -> Status {
     let (input, remappings) = parse_positional_args(args.input.clone())?;
     let input_canonical = dunce::canonicalize(Path::new(&input))?;
 
-    let res = compile(&args, &input, remappings)?;
-    let out = parse_comp_result(
-        &res.1,
-        &res.0,
+    let (source_unit_name, res, artifacts) = compile(&args, &input, remappings)?;
+    let contract = parse_comp_result(
+        &res,
+        &artifacts,
+        &source_unit_name,
         args.contract,
         !(args.abi_json || args.ast_compact_json || args.userdoc || args.devdoc),
     )?;
+    let out = &res["contracts"][&source_unit_name][&contract];
 
     if args.function_ids {
-        println!("{}", serde_json::to_string_pretty(&out["functionIds"])?);
+        let function_ids = artifacts.get_json(&source_unit_name, &contract, "functionIds")?;
+        println!("{}", serde_json::to_string_pretty(&function_ids)?);
         return Ok(());
     }
 
     if args.private_function_ids {
-        println!(
-            "{}",
-            serde_json::to_string_pretty(&out["privateFunctionIds"])?
-        );
+        let function_ids =
+            artifacts.get_json(&source_unit_name, &contract, "privateFunctionIds")?;
+        println!("{}", serde_json::to_string_pretty(&function_ids)?);
+        return Ok(());
+    }
+
+    if args.code_metrics {
+        let code_metrics = artifacts.get_json(&source_unit_name, &contract, "codeMetrics")?;
+        println!("{}", serde_json::to_string_pretty(&code_metrics)?);
+        return Ok(());
+    }
+
+    if args.gas_report {
+        let gas_estimates = artifacts.get_json(&source_unit_name, &contract, "gasEstimates")?;
+        println!("{}", serde_json::to_string_pretty(&gas_estimates)?);
+        return Ok(());
+    }
+
+    if args.optimizer_stats {
+        let optimizer_stats =
+            artifacts.get_json(&source_unit_name, &contract, "optimizerStats")?;
+        println!("{}", serde_json::to_string_pretty(&optimizer_stats)?);
         return Ok(());
     }
 
@@ -356,41 +466,27 @@ pub fn build(args: Args) -> Status {
     }
 
     if args.ast_compact_json {
-        let all = res
-            .1
-            .as_object()
-            .ok_or_else(|| parse_error!())?
-            .get("sources")
-            .ok_or_else(|| parse_error!())?
-            .as_object()
-            .ok_or_else(|| parse_error!())?;
-
-        let mut array = vec![];
-        for (_, val) in all {
-            let ast = val
-                .as_object()
-                .ok_or_else(|| parse_error!())?
-                .get("ast")
-                .ok_or_else(|| parse_error!())?;
-            array.push(ast.clone());
+        if artifacts.ast.is_empty() {
+            return Err(parse_error!().into());
         }
-        assert_eq!(array.len(), 1);
-        println!("{}", serde_json::to_string(&array[0])?);
+        let mut stdout = std::io::stdout().lock();
+        stdout.write_all(&artifacts.ast)?;
+        writeln!(stdout)?;
         return Ok(());
     }
 
-    let abi = &out["abi"];
+    let abi = artifacts.get_json(&source_unit_name, &contract, "abi")?;
     let abi_file_name = format!("{}.abi.json", output_prefix);
     let mut abi_file = File::create(output_path.join(&abi_file_name))?;
-    printer::print_abi_json_canonically(&mut abi_file, abi)?;
+    printer::print_abi_json_canonically(&mut abi_file, &abi)?;
     if args.abi_json {
         return Ok(());
     }
 
-    let assembly = out["assembly"]
-        .as_str()
-        .ok_or_else(|| parse_error!())?
-        .to_owned();
+    let assembly = artifacts
+        .get(&source_unit_name, &contract, "assembly")
+        .ok_or_else(|| parse_error!())?;
+    let assembly = String::from_utf8(assembly.to_vec())?;
     let assembly_file_name = format!("{}.code", output_prefix);
     let mut assembly_file = File::create(output_path.join(&assembly_file_name))?;
     assembly_file.write_all(assembly.as_bytes())?;
@@ -406,14 +502,29 @@ pub fn build(args: Args) -> Status {
 
     let mut engine = Engine::new("");
     let mut units = Units::new();
-    for (input, filename) in inputs {
-        engine.reset(filename);
+    for (input, filename) in &inputs {
+        engine.reset(filename.clone());
         units = engine
-            .compile_toplevel(&input)
+            .compile_toplevel(input)
             .map_err(|e| format_err!("{}", e))?;
     }
     let (b, d) = units.finalize();
     let output = b.into_cell()?;
+
+    if args.size_report {
+        let (libs, contract) = inputs.split_at(inputs.len() - 1);
+        let (assembly, filename) = &contract[0];
+        let code = if assembly.contains(size_report::STATE_INIT_MARKER) {
+            output.reference(0)?
+        } else {
+            output.clone()
+        };
+        let limits = size_report::Limits::default();
+        let report = size_report::size_report(libs, assembly, filename, &code, limits)?;
+        println!("{}", serde_json::to_string_pretty(&report)?);
+        return Ok(());
+    }
+
     let dbgmap = DbgInfo::from(output.clone(), d);
 
     let output_filename = if output_dir == "." {
@@ -493,6 +604,15 @@ pub struct Args {
     /// Select desired TVM version.
     #[clap(long, value_enum)]
     pub tvm_version: Option<TvmVersion>,
+    /// Number of threads used to check source files that do not import each other
+    #[clap(long, value_parser, value_names = &["N"])]
+    pub analysis_threads: Option<u32>,
+    /// Type check only the source files the input file depends on
+    #[clap(long, value_parser)]
+    pub analyze_reachable_only: bool,
+    /// Allocate the syntax tree of each source file in one memory arena
+    #[clap(long, value_parser)]
+    pub ast_arena: bool,
 
     //Output Components:
     /// ABI specification of the contracts
@@ -504,6 +624,18 @@ pub struct Args {
     /// Print name and id for each private function
     #[clap(long, value_parser)]
     pub private_function_ids: bool,
+    /// Print the estimated code size and minimal gas of each function of the contract
+    #[clap(long, value_parser)]
+    pub code_metrics: bool,
+    /// Print the best case gas, the worst case gas without loops and the gas of a loop iteration of each function of the contract
+    #[clap(long, value_parser)]
+    pub gas_report: bool,
+    /// Print the size of the assembled code of each function of the contract and flag the functions that exceed the size limits
+    #[clap(long, value_parser)]
+    pub size_report: bool,
+    /// Print how often each rule of the peephole optimizer fired, the bits and gas it saved and the time spent matching
+    #[clap(long, value_parser)]
+    pub optimizer_stats: bool,
     /// AST of all source files in a compact JSON format
     #[clap(long, value_parser)]
     pub ast_compact_json: bool,
@@ -514,3 +646,58 @@ pub struct Args {
     #[clap(long, value_parser)]
     pub devdoc: bool,
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    unsafe fn read(file_reader: *mut c_void, name: &str) -> Result<(*mut c_char, String)> {
+        let mut success = 0i32;
+        let contents =
+            libsolc::file_reader_read(file_reader, to_cstr(name)?.as_ptr(), &mut success);
+        assert_ne!(success, 0);
+        Ok((
+            contents,
+            CStr::from_ptr(contents).to_string_lossy().into_owned(),
+        ))
+    }
+
+    #[test]
+    fn test_read_rewritten_file() -> Status {
+        // Large enough to be mapped into memory if mapping were enabled
+        let dir = std::env::temp_dir().join(format!("sold_rewritten_{}", std::process::id()));
+        std::fs::create_dir_all(&dir)?;
+        let path = dir.join("Large.sol");
+        let old = format!("// {}\n", "a".repeat(20000));
+        let new = format!("// {}\n", "b".repeat(17000));
+        std::fs::write(&path, &old)?;
+
+        let dir = to_cstr(&dir.to_string_lossy())?;
+        unsafe {
+            let file_reader = libsolc::file_reader_new();
+            libsolc::file_reader_set_base_path(file_reader, dir.as_ptr());
+            libsolc::file_reader_allow_directory(file_reader, dir.as_ptr());
+            let (old_ptr, old_contents) = read(file_reader, "Large.sol")?;
+            assert_eq!(old_contents, old);
+
+            // Truncate and rewrite the file in place while the old contents are still in use
+            std::fs::OpenOptions::new()
+                .write(true)
+                .truncate(true)
+                .open(&path)?
+                .write_all(new.as_bytes())?;
+
+            let file_reader = libsolc::file_reader_new();
+            libsolc::file_reader_set_base_path(file_reader, dir.as_ptr());
+            libsolc::file_reader_allow_directory(file_reader, dir.as_ptr());
+            let (new_ptr, new_contents) = read(file_reader, "Large.sol")?;
+            assert_eq!(new_contents, new);
+            assert_eq!(CStr::from_ptr(old_ptr).to_string_lossy(), old);
+
+            libsolc::solidity_free(old_ptr);
+            libsolc::solidity_free(new_ptr);
+        }
+        std::fs::remove_file(&path)?;
+        Ok(())
+    }
+}
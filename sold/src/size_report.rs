@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2019-2023 EverX. All Rights Reserved.
+ *
+ * Licensed under the SOFTWARE EVALUATION License (the "License"); you may not use
+ * this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the  GNU General Public License for more details at: https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+use std::collections::HashSet;
+
+use failure::format_err;
+use serde_json::json;
+
+use tvm_assembler::Engine;
+use tvm_types::{Cell, Result};
+
+/// Line that `Printer` emits between the fragments of a contract and its StateInit.
+pub const STATE_INIT_MARKER: &str = "; The code below forms a value of the StateInit type.";
+
+/// Functions that dispatch the messages. They contain the public functions and are never the culprit.
+const ENTRY_POINTS: [&str; 3] = ["main_internal", "main_external", "onTickTock"];
+
+/// Limits on the code of a contract, which is deployed in a message.
+pub struct Limits {
+    pub bits: usize,
+    pub cells: usize,
+    pub depth: usize,
+}
+
+impl Default for Limits {
+    /// Limits on messages in the default configuration of the network (config parameter 43),
+    /// which is the same for all supported TVM versions.
+    fn default() -> Self {
+        Limits {
+            bits: 1 << 21,
+            cells: 1 << 13,
+            depth: 512,
+        }
+    }
+}
+
+/// Size of a tree of cells. Cells that occur several times are counted once.
+#[derive(Default)]
+struct Tree {
+    bits: usize,
+    cells: usize,
+    /// Number of references, i.e. of the boundaries that CALLREF, PUSHREF, PUSHREFCONT, IFREF... and
+    /// the implicit jumps to the cells code continues in cross.
+    refs: usize,
+    depth: usize,
+}
+
+fn measure(root: &Cell) -> Result<Tree> {
+    let mut tree = Tree {
+        depth: root.repr_depth() as usize,
+        ..Default::default()
+    };
+    let mut visited = HashSet::new();
+    let mut stack = vec![root.clone()];
+    while let Some(cell) = stack.pop() {
+        if !visited.insert(cell.repr_hash()) {
+            continue;
+        }
+        tree.bits += cell.bit_length();
+        tree.cells += 1;
+        tree.refs += cell.references_count();
+        for i in 0..cell.references_count() {
+            stack.push(cell.reference(i)?);
+        }
+    }
+    Ok(tree)
+}
+
+/// Assembles the fragments of the contract once and then each of them alone, with the fragments
+/// it inlines. The libraries and the fragments stay defined in `engine` between the calls.
+fn assemble_fragments(
+    libs: &[(String, String)],
+    fragments: &str,
+    filename: &str,
+    names: &[String],
+) -> Result<Vec<Cell>> {
+    let mut engine = Engine::new("");
+    for (input, lib_filename) in libs {
+        engine.reset(lib_filename.clone());
+        engine
+            .compile_toplevel(input)
+            .map_err(|e| format_err!("{}", e))?;
+    }
+    engine.reset(filename.to_string());
+    engine
+        .compile_toplevel(fragments)
+        .map_err(|e| format_err!("{}", e))?;
+    let mut cells = Vec::with_capacity(names.len());
+    for name in names {
+        engine.reset(filename.to_string());
+        let units = engine
+            .compile_toplevel(&format!("\t.inline {}\n", name))
+            .map_err(|e| format_err!("{}", e))?;
+        let (builder, _) = units.finalize();
+        cells.push(builder.into_cell()?);
+    }
+    Ok(cells)
+}
+
+fn percent(part: usize, total: usize) -> f64 {
+    if total == 0 {
+        return 0.0;
+    }
+    (part as f64 * 10000.0 / total as f64).round() / 100.0
+}
+
+/// Reports the size of the code of the contract and of each of its fragments after assembly.
+///
+/// `assembly` is the code printed by the compiler and `code` the root cell of the assembled code.
+/// The size of a fragment includes the fragments it inlines but not the private functions it calls
+/// through the dictionary.
+pub fn size_report(
+    libs: &[(String, String)],
+    assembly: &str,
+    filename: &str,
+    code: &Cell,
+    limits: Limits,
+) -> Result<serde_json::Value> {
+    let contract = measure(code)?;
+    let fragments = assembly.split(STATE_INIT_MARKER).next().unwrap_or(assembly);
+
+    let names: Vec<String> = fragments
+        .lines()
+        .filter_map(|line| line.strip_prefix(".fragment "))
+        .map(|rest| rest.split(',').next().unwrap_or(rest).trim().to_string())
+        .collect();
+    let cells = assemble_fragments(libs, fragments, filename, &names)?;
+    let mut functions = Vec::new();
+    for (name, cell) in names.into_iter().zip(cells.iter()) {
+        functions.push((name, measure(cell)?));
+    }
+    functions.sort_by(|(a_name, a), (b_name, b)| b.cells.cmp(&a.cells).then(a_name.cmp(b_name)));
+
+    // The largest functions whose removal brings the code under the size limits are to blame.
+    let mut over_limit = HashSet::new();
+    let mut excess_bits = contract.bits.saturating_sub(limits.bits);
+    let mut excess_cells = contract.cells.saturating_sub(limits.cells);
+    for (name, tree) in &functions {
+        if excess_bits == 0 && excess_cells == 0 {
+            break;
+        }
+        if ENTRY_POINTS.contains(&name.as_str()) {
+            continue;
+        }
+        over_limit.insert(name.clone());
+        excess_bits = excess_bits.saturating_sub(tree.bits);
+        excess_cells = excess_cells.saturating_sub(tree.cells);
+    }
+    // The dispatcher nests the functions this many cells deep.
+    let nesting = contract.depth.saturating_sub(
+        functions
+            .iter()
+            .map(|(_, tree)| tree.depth)
+            .max()
+            .unwrap_or(0),
+    );
+    for (name, tree) in &functions {
+        if tree.depth + nesting > limits.depth {
+            over_limit.insert(name.clone());
+        }
+    }
+
+    let functions: Vec<serde_json::Value> = functions
+        .iter()
+        .map(|(name, tree)| {
+            json!({
+                "name": name,
+                "bits": tree.bits,
+                "cells": tree.cells,
+                "refs": tree.refs,
+                "depth": tree.depth,
+                "share": percent(tree.cells, contract.cells),
+                "overLimit": over_limit.contains(name),
+            })
+        })
+        .collect();
+
+    Ok(json!({
+        "bits": contract.bits,
+        "cells": contract.cells,
+        "depth": contract.depth,
+        "limits": {
+            "bits": limits.bits,
+            "cells": limits.cells,
+            "depth": limits.depth,
+        },
+        "exceedsLimits": contract.bits > limits.bits
+            || contract.cells > limits.cells
+            || contract.depth > limits.depth,
+        "functions": functions,
+    }))
+}
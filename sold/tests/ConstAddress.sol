@@ -0,0 +1,33 @@
+pragma tvm-solidity >=0.50.0;
+interface IReceiver {
+    function ping(uint x) external;
+}
+
+contract ConstAddress {
+    address constant RECEIVER = address(0x1234);
+    IReceiver constant PEER = IReceiver(address(0x1234));
+
+    function literal() public pure {
+        address(0x5678).transfer({value: 1 ever, bounce: false});
+    }
+
+    function named(varuint16 value) public pure {
+        RECEIVER.transfer({value: value, bounce: false});
+    }
+
+    function variable(address dest) public pure {
+        dest.transfer({value: 1 ever, bounce: false});
+    }
+
+    function call(uint x) public pure {
+        IReceiver(address(0x5678)).ping{value: 1 ever}(x);
+    }
+
+    function namedCall(uint x) public pure {
+        PEER.ping(x);
+    }
+
+    function variableCall(uint x, address dest) public pure {
+        IReceiver(dest).ping{value: 1 ever}(x);
+    }
+}
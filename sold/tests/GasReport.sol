@@ -0,0 +1,14 @@
+pragma tvm-solidity >=0.50.0;
+contract GasReport {
+    uint s;
+
+    function sum(uint n) public {
+        for (uint i = 0; i < n; ++i)
+            s += i;
+    }
+
+    function check(uint a) public {
+        require(a > 1, 101);
+        s = a;
+    }
+}
@@ -0,0 +1,10 @@
+pragma tvm-solidity >=0.50.0;
+contract IfElseBranches {
+    function f(uint a, uint b) public pure returns (uint r) {
+        if (a > 10) {
+            if (b > 1) r = 1111; else r = 2222;
+        } else {
+            if (b > 1) r = 1111; else r = 3333;
+        }
+    }
+}
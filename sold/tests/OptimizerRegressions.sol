@@ -0,0 +1,23 @@
+pragma tvm-solidity >=0.50.0;
+contract OptimizerRegressions {
+    function conditionTrue(uint a, uint b) public pure returns (uint) {
+        return true ? a + 1 : b + 2;
+    }
+
+    function ifTrue(uint a, uint b) public pure returns (uint, uint) {
+        if (true) {
+            return (a * 3, b);
+        } else {
+            return (b, a * 3);
+        }
+    }
+
+    function equalBranches(bool c, uint a) public pure returns (uint) {
+        return c ? a * 3 : a * 3;
+    }
+
+    function emptyCell() public pure returns (TvmCell) {
+        TvmBuilder b;
+        return b.toCell();
+    }
+}
@@ -0,0 +1,13 @@
+pragma tvm-solidity >=0.50.0;
+
+import "ParallelA.sol";
+import "ParallelB.sol";
+
+contract Parallel is Shapes {
+    mapping(uint32 => Point) m_byId;
+
+    function total(uint32 id) public view returns (uint32) {
+        string unused = "unused";
+        return Geometry.length(m_byId[id]) + uint32(m_points.length);
+    }
+}
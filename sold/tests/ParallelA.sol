@@ -0,0 +1,13 @@
+pragma tvm-solidity >=0.50.0;
+
+struct Point {
+    uint32 x;
+    uint32 y;
+}
+
+library Geometry {
+    function length(Point p) internal returns (uint32) {
+        uint32 unused = p.x;
+        return p.x + p.y;
+    }
+}
@@ -0,0 +1,13 @@
+pragma tvm-solidity >=0.50.0;
+
+import "ParallelA.sol";
+
+contract Shapes {
+    Point[] m_points;
+
+    function add(uint32 x, uint32 y) public {
+        tvm.accept();
+        m_points.push(Point(x, y));
+        uint unused = m_points.length;
+    }
+}
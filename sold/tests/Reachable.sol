@@ -0,0 +1,7 @@
+pragma tvm-solidity >=0.50.0;
+import "ReachableAll.sol";
+contract Reachable {
+  function f() public pure returns (uint) {
+    return Used.one();
+  }
+}
@@ -0,0 +1,3 @@
+pragma tvm-solidity >=0.50.0;
+import "ReachableUsed.sol";
+import "ReachableUnused.sol";
@@ -0,0 +1,6 @@
+pragma tvm-solidity >=0.50.0;
+library Unused {
+  function broken() internal pure returns (uint) {
+    return "not a number";
+  }
+}
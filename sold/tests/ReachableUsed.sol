@@ -0,0 +1,6 @@
+pragma tvm-solidity >=0.50.0;
+library Used {
+  function one() internal pure returns (uint) {
+    return 1;
+  }
+}
@@ -0,0 +1,67 @@
+pragma tvm-solidity >=0.50.0;
+
+struct Point {
+    uint x;
+    uint y;
+}
+
+struct Segment {
+    Point a;
+    uint length;
+}
+
+contract ScalarStructs {
+    // `p` is used only through its members, each member gets its own stack slot
+    function members(uint a, uint b) public pure returns (uint, uint) {
+        Point p;
+        p.x = a;
+        p.y = b;
+        p.x += 2;
+        p.y++;
+        uint old = p.x++;
+        (p.x, p.y) = (p.y, p.x);
+        return (p.x + old, p.y);
+    }
+
+    function deleteMember(uint a) public pure returns (uint) {
+        Point p = Point(a, a + 1);
+        delete p.x;
+        return p.x + p.y;
+    }
+
+    function nestedMember(uint a) public pure returns (uint, uint) {
+        Segment s;
+        s.a.x = a;
+        s.a.y = a * 2;
+        s.length = s.a.y - s.a.x;
+        return (s.a.x, s.length);
+    }
+
+    // `p` is copied as a whole, `q` is used only through its members
+    function copy(uint a) public pure returns (uint, uint) {
+        Point p = Point(a, a);
+        Point q = p;
+        q.x += 1;
+        return (p.x, q.x);
+    }
+
+    function assign(uint a) public pure returns (Point) {
+        Point p;
+        p.x = a;
+        Point q;
+        q = p;
+        q.y = a;
+        return q;
+    }
+
+    function pass(uint a) public pure returns (uint) {
+        Point p;
+        p.x = a;
+        p.y = a + 1;
+        return sum(p);
+    }
+
+    function sum(Point p) private pure returns (uint) {
+        return p.x + p.y;
+    }
+}
@@ -213,3 +213,331 @@ User Documentation
         ));
     Ok(())
 }
+
+#[test]
+fn test_analyze_reachable_only() -> Status {
+    Command::cargo_bin(BIN_NAME)?
+        .arg("tests/Reachable.sol")
+        .arg("--output-dir")
+        .arg("tests")
+        .arg("--base-path")
+        .arg("tests")
+        .assert()
+        .failure()
+        .stderr(predicate::str::contains("ReachableUnused.sol"));
+
+    Command::cargo_bin(BIN_NAME)?
+        .arg("tests/Reachable.sol")
+        .arg("--output-dir")
+        .arg("tests")
+        .arg("--base-path")
+        .arg("tests")
+        .arg("--analyze-reachable-only")
+        .assert()
+        .success();
+
+    remove_all_outputs("Reachable")?;
+    Ok(())
+}
+
+#[test]
+fn test_ast_arena() -> Status {
+    Command::cargo_bin(BIN_NAME)?
+        .arg("tests/Combined.sol")
+        .arg("--output-dir")
+        .arg("tests")
+        .arg("--ast-arena")
+        .assert()
+        .success();
+
+    remove_all_outputs("Combined")?;
+    Ok(())
+}
+
+#[test]
+fn test_ast_compact_json() -> Status {
+    Command::cargo_bin(BIN_NAME)?
+        .arg("tests/Trivial.sol")
+        .arg("--ast-compact-json")
+        .assert()
+        .success()
+        .stdout(predicate::str::starts_with(
+            r#"{"absolutePath":"tests/Trivial.sol","#,
+        ))
+        .stdout(predicate::str::contains(r#""nodeType":"SourceUnit""#));
+
+    Ok(())
+}
+
+#[test]
+fn test_code_metrics() -> Status {
+    Command::cargo_bin(BIN_NAME)?
+        .arg("tests/Trivial.sol")
+        .arg("--code-metrics")
+        .assert()
+        .success()
+        .stdout(predicate::str::contains(r#""functions": ["#))
+        .stdout(predicate::str::contains(r#""name": "main_internal""#))
+        .stdout(predicate::str::contains(r#""minGas": "#));
+
+    Ok(())
+}
+
+#[test]
+fn test_gas_report() -> Status {
+    Command::cargo_bin(BIN_NAME)?
+        .arg("tests/Trivial.sol")
+        .arg("--gas-report")
+        .assert()
+        .success()
+        .stdout(predicate::str::contains(r#""name": "main_internal""#))
+        .stdout(predicate::str::contains(r#""best": "#))
+        .stdout(predicate::str::contains(r#""worstWithoutLoops": "#))
+        .stdout(predicate::str::contains(r#""loopIteration": "#));
+
+    Ok(())
+}
+
+fn function_estimates(stdout: &[u8], name: &str) -> Result<serde_json::Value, Box<dyn std::error::Error>> {
+    let json: serde_json::Value = serde_json::from_slice(stdout)?;
+    json["functions"]
+        .as_array()
+        .and_then(|functions| functions.iter().find(|function| function["name"] == name))
+        .cloned()
+        .ok_or_else(|| format!("no function {}", name).into())
+}
+
+#[test]
+fn test_gas_report_numbers() -> Status {
+    let assert = Command::cargo_bin(BIN_NAME)?
+        .arg("tests/GasReport.sol")
+        .arg("--gas-report")
+        .assert()
+        .success();
+    let stdout = &assert.get_output().stdout;
+
+    // DUP, GTINT 1, THROWIFNOT 101 and SETGLOB 10 cost 18 + 26 + 34 + 26
+    let check = function_estimates(stdout, "check_5f72f450_internal")?;
+    assert_eq!(check["best"], 104);
+    assert_eq!(check["worstWithoutLoops"], 104);
+    assert_eq!(check["loopIteration"], serde_json::json!([]));
+
+    let sum = function_estimates(stdout, "sum_188b85b4_internal")?;
+    assert_eq!(sum["best"], 219);
+    assert_eq!(sum["worstWithoutLoops"], 219);
+    assert_eq!(sum["loopIteration"], serde_json::json!([160]));
+
+    // Only the worst case of the public function loads the state with c4_to_c7
+    let check = function_estimates(stdout, "check")?;
+    assert_eq!(check["best"], 1307);
+    assert_eq!(check["worstWithoutLoops"], 1730);
+
+    Ok(())
+}
+
+#[test]
+fn test_size_report() -> Status {
+    Command::cargo_bin(BIN_NAME)?
+        .arg("tests/Trivial.sol")
+        .arg("--size-report")
+        .arg("--output-dir")
+        .arg("tests")
+        .assert()
+        .success()
+        .stdout(predicate::str::contains(r#""exceedsLimits": false"#))
+        .stdout(predicate::str::contains(r#""name": "main_internal""#))
+        .stdout(predicate::str::contains(r#""share": "#));
+
+    Ok(())
+}
+
+#[test]
+fn test_optimizer_stats() -> Status {
+    Command::cargo_bin(BIN_NAME)?
+        .arg("tests/Trivial.sol")
+        .arg("--optimizer-stats")
+        .assert()
+        .success()
+        .stdout(predicate::str::contains(r#""rules": {"#))
+        .stdout(predicate::str::contains(r#""PushDrop": {"#))
+        .stdout(predicate::str::contains(r#""bitsSaved": "#))
+        .stdout(predicate::str::contains(r#""scan": {"#))
+        .stdout(predicate::str::contains(r#""timeUs": "#));
+
+    Ok(())
+}
+
+#[test]
+fn test_if_else_branches() -> Status {
+    Command::cargo_bin(BIN_NAME)?
+        .arg("tests/IfElseBranches.sol")
+        .arg("--output-dir")
+        .arg("tests")
+        .assert()
+        .success();
+
+    // the branches differ only in the nested else branches, neither may be dropped
+    let code = std::fs::read_to_string("tests/IfElseBranches.code")?;
+    assert!(code.contains("PUSHINT 2222"));
+    assert!(code.contains("PUSHINT 3333"));
+
+    remove_all_outputs("IfElseBranches")?;
+    Ok(())
+}
+
+fn fragment<'a>(code: &'a str, name: &str) -> &'a str {
+    let start = code
+        .find(&format!(".fragment {}, {{", name))
+        .unwrap_or_else(|| panic!("no fragment {}", name));
+    let end = code[start..].find("\n}\n").map_or(code.len(), |end| start + end);
+    &code[start..end]
+}
+
+#[test]
+fn test_decode_layout() -> Status {
+    Command::cargo_bin(BIN_NAME)?
+        .arg("tests/DecodeLayout.sol")
+        .arg("--output-dir")
+        .arg("tests")
+        .assert()
+        .success();
+
+    let code = std::fs::read_to_string("tests/DecodeLayout.code")?;
+    // the parameters take the same cells after both message headers
+    assert!(!fragment(&code, "sameLayout").contains("IFELSE"));
+    // only the longer header of external messages moves the second parameter to the next cell
+    let external_split = fragment(&code, "externalSplit");
+    assert!(external_split.contains("IFELSE"));
+    assert_eq!(external_split.matches("LDREF").count(), 1);
+    // the parameters move to the next cell at the second and at the fourth parameter
+    let different_splits = fragment(&code, "differentSplits");
+    assert!(different_splits.contains("IFELSE"));
+    assert_eq!(different_splits.matches("LDREF").count(), 2);
+    // all 256 values of 8 bits are members of the enum, one is not
+    assert!(!fragment(&code, "fullEnum").contains("THROWIF 73"));
+    assert!(fragment(&code, "partialEnum").contains("THROWIF 73"));
+
+    remove_all_outputs("DecodeLayout")?;
+    Ok(())
+}
+
+#[test]
+fn test_const_address() -> Status {
+    Command::cargo_bin(BIN_NAME)?
+        .arg("tests/ConstAddress.sol")
+        .arg("--output-dir")
+        .arg("tests")
+        .assert()
+        .success();
+
+    let code = std::fs::read_to_string("tests/ConstAddress.code")?;
+    // the whole message to 0:5678 is one constant cell
+    let literal = fragment(&code, "literal_1373185e_internal");
+    assert!(literal.contains(
+        ".blob x42000000000000000000000000000000000000000000000000000000000000002b3c21dcd65000000000000000000000000000004_"
+    ));
+    assert!(!literal.contains("NEWC"));
+    // the header up to the value is one constant slice with the destination 0:1234 given by a constant
+    let named = fragment(&code, "named_add033a3_internal");
+    assert!(named.contains(
+        "PUSHSLICE x4200000000000000000000000000000000000000000000000000000000000000091a4_"
+    ));
+    // the destination given by a parameter is stored at run time
+    let variable = fragment(&code, "variable_2777ceca_internal");
+    assert!(variable.contains("STSLICECONST x42_\n\tSTSLICE\n"));
+
+    // the header and the function id of calls to constant addresses are one constant slice,
+    // and the parameters fit into the same cell
+    let call = fragment(&code, "call_2b096926_internal");
+    assert!(call.contains(
+        "PUSHSLICE x62000000000000000000000000000000000000000000000000000000000000002b3c21dcd65000000000000000000000000000003897efc8c_"
+    ));
+    assert!(!call.contains("STBREFR"));
+    let named_call = fragment(&code, "namedCall_4e0351af_internal");
+    assert!(named_call.contains(
+        "PUSHSLICE x6200000000000000000000000000000000000000000000000000000000000000091a1cc4b400000000000000000000000000003897efc8c_"
+    ));
+    assert!(!named_call.contains("STBREFR"));
+    // the header with an unknown destination may be too long for the body
+    assert!(fragment(&code, "variableCall_83115eee_internal").contains("STBREFR"));
+
+    remove_all_outputs("ConstAddress")?;
+    Ok(())
+}
+
+#[test]
+fn test_analysis_threads() -> Status {
+    let mut outputs = vec![];
+    for threads in ["1", "4"] {
+        let assert = Command::cargo_bin(BIN_NAME)?
+            .arg("tests/Parallel.sol")
+            .arg("--output-dir")
+            .arg("tests")
+            .arg("--base-path")
+            .arg("tests")
+            .arg("--analysis-threads")
+            .arg(threads)
+            .assert()
+            .success()
+            .stderr(predicate::str::contains("Unused local variable"));
+        let stderr = String::from_utf8(assert.get_output().stderr.clone())?;
+        let code = std::fs::read_to_string("tests/Parallel.code")?;
+        remove_all_outputs("Parallel")?;
+        outputs.push((stderr, code));
+    }
+
+    // Several threads report the same warnings in the same order and generate the same code
+    assert_eq!(outputs[0], outputs[1]);
+    Ok(())
+}
+
+#[test]
+fn test_optimizer_regressions() -> Status {
+    // `if (true)` and equal branches that return values, and an empty cell constant
+    Command::cargo_bin(BIN_NAME)?
+        .arg("tests/OptimizerRegressions.sol")
+        .arg("--output-dir")
+        .arg("tests")
+        .assert()
+        .success();
+
+    Command::cargo_bin(BIN_NAME)?
+        .arg("tests/OptimizerRegressions.sol")
+        .arg("--code-metrics")
+        .assert()
+        .success()
+        .stdout(predicate::str::contains(r#""name": "emptyCell"#));
+
+    remove_all_outputs("OptimizerRegressions")?;
+    Ok(())
+}
+
+#[test]
+fn test_scalar_structs() -> Status {
+    // local structs that are assigned, copied and passed, and members used as lvalues
+    Command::cargo_bin(BIN_NAME)?
+        .arg("tests/ScalarStructs.sol")
+        .arg("--output-dir")
+        .arg("tests")
+        .assert()
+        .success();
+
+    // the members of `p` in `members` are separate stack slots, there is no tuple
+    let code = std::fs::read_to_string("tests/ScalarStructs.code")?;
+    let start = code
+        .lines()
+        .position(|line| line.starts_with(".fragment members_") && line.contains("_internal"))
+        .ok_or("no fragment of members")?;
+    let members: Vec<&str> = code
+        .lines()
+        .skip(start + 1)
+        .take_while(|line| *line != "}")
+        .collect();
+    assert!(!members.is_empty());
+    assert!(members
+        .iter()
+        .all(|line| !line.contains("TUPLE") && !line.contains("INDEX")));
+
+    remove_all_outputs("ScalarStructs")?;
+    Ok(())
+}